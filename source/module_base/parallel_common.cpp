@@ -4,6 +4,8 @@
 #include <mpi.h>
 #endif
 
+#include <algorithm>
+#include <cassert>
 #include <cstring>
 
 #ifdef __MPI
@@ -78,4 +80,79 @@ void Parallel_Common::bcast_char(char* object, const int n)
     MPI_Bcast(object, n, MPI_CHAR, 0, MPI_COMM_WORLD);
 }
 
+Parallel_Common::Bcast_Buffer::Bcast_Buffer()
+{
+    int my_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    this->mode = (my_rank == 0) ? Mode::pack : Mode::done;
+}
+
+void Parallel_Common::Bcast_Buffer::sync_bytes(void* object, const size_t bytes)
+{
+    if (bytes == 0)
+    {
+        return;
+    }
+    if (this->mode == Mode::pack)
+    {
+        const char* begin = static_cast<const char*>(object);
+        this->buffer.insert(this->buffer.end(), begin, begin + bytes);
+    }
+    else if (this->mode == Mode::unpack)
+    {
+        assert(this->position + bytes <= this->buffer.size());
+        std::memcpy(object, &this->buffer[this->position], bytes);
+        this->position += bytes;
+    }
+}
+
+void Parallel_Common::Bcast_Buffer::sync(bool& object)
+{
+    char value = object;
+    this->sync(value);
+    if (this->is_unpacking())
+    {
+        object = static_cast<bool>(value);
+    }
+}
+
+void Parallel_Common::Bcast_Buffer::sync(std::string& object)
+{
+    int size = object.size();
+    this->sync(size);
+    if (this->is_unpacking())
+    {
+        object.resize(size);
+    }
+    this->sync_bytes(&object[0], size);
+}
+
+void Parallel_Common::Bcast_Buffer::sync(std::string* object, const int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        this->sync(object[i]);
+    }
+}
+
+void Parallel_Common::Bcast_Buffer::bcast()
+{
+    long long size = this->buffer.size();
+    MPI_Bcast(&size, 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+    const bool is_root = (this->mode == Mode::pack);
+    if (!is_root)
+    {
+        this->buffer.resize(size);
+    }
+    // MPI_Bcast counts are int
+    const long long max_count = 1LL << 30;
+    for (long long offset = 0; offset < size; offset += max_count)
+    {
+        const int count = static_cast<int>(std::min(max_count, size - offset));
+        MPI_Bcast(&this->buffer[offset], count, MPI_CHAR, 0, MPI_COMM_WORLD);
+    }
+    this->mode = is_root ? Mode::done : Mode::unpack;
+    this->position = 0;
+}
+
 #endif
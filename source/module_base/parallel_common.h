@@ -6,6 +6,8 @@
 #endif
 #include <complex>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace Parallel_Common
 {
@@ -23,6 +25,92 @@ void bcast_double(double& object);
 void bcast_int(int& object);
 void bcast_bool(bool& object);
 
+#ifdef __MPI
+//(3) bcast many objects at once
+/**
+ * @brief the values of many objects broadcast from process 0 with one MPI_Bcast
+ * The objects are given to sync() twice in the same order, before and after bcast():
+ * process 0 packs their values in a contiguous buffer the first time, bcast() sends the buffer,
+ * the other processes unpack the values the second time, sync() does nothing otherwise.
+ * bcast_with(f) calls f(buffer), bcast(), f(buffer), e.g.
+ *     Parallel_Common::Bcast_Buffer buffer;
+ *     buffer.bcast_with([&](Parallel_Common::Bcast_Buffer& b) {
+ *         b.sync(n);
+ *         if (b.is_unpacking()) v.resize(n);
+ *         b.sync(v.data(), n);
+ *     });
+ */
+class Bcast_Buffer
+{
+  public:
+    Bcast_Buffer();
+
+    /// whether sync() gives the values of process 0, the containers must be resized before them
+    bool is_unpacking() const
+    {
+        return this->mode == Mode::unpack;
+    }
+
+    template <typename T>
+    void sync(T* object, const int n)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "use the overloads for the other types");
+        this->sync_bytes(object, n * sizeof(T));
+    }
+    template <typename T>
+    void sync(T& object)
+    {
+        this->sync(&object, 1);
+    }
+    void sync(bool& object);
+    void sync(std::string& object);
+    void sync(std::string* object, const int n);
+    /// the size is synchronized, then the elements
+    template <typename T>
+    void sync(std::vector<T>& object)
+    {
+        int n = object.size();
+        this->sync(n);
+        if (this->is_unpacking())
+        {
+            object.resize(n);
+        }
+        this->sync(object.data(), n);
+    }
+
+    /// broadcast the values packed by process 0
+    void bcast();
+
+    template <typename F>
+    void bcast_with(F f)
+    {
+        f(*this);
+        this->bcast();
+        f(*this);
+        this->mode = Mode::done;
+    }
+
+    /// the number of bytes broadcast
+    size_t size() const
+    {
+        return this->buffer.size();
+    }
+
+  private:
+    void sync_bytes(void* object, const size_t bytes);
+
+    enum class Mode
+    {
+        pack,   // process 0 before bcast()
+        unpack, // the other processes after bcast()
+        done    // the other processes before bcast(), process 0 after bcast()
+    };
+    Mode mode = Mode::done;
+    std::vector<char> buffer;
+    size_t position = 0;
+};
+#endif
+
 } // namespace Parallel_Common
 
 #endif
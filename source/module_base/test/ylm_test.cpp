@@ -1,5 +1,9 @@
 #include "../ylm.h"
 #include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
 /************************************************
  *  unit test of class ylm
  ***********************************************/
@@ -8,10 +12,33 @@
  * - Tested Functions:
  *   - ZEROS
  *     - set all elements of a double float array to zero
+ *   - sph_harm_batch
+ *     - the same Ylm as sph_harm for a batch of points, and the cost of both
+ *   - grad_rl_sph_harm_batch
+ *     - the same r^l Ylm and gradients as grad_rl_sph_harm for a batch of points, and the cost of both
  * */
 
 class ylmTest : public testing::Test
 {
+  protected:
+    // points of a big grid around an atom, including some points near the origin and on the axes
+    void set_points(const int n)
+    {
+        x.resize(n);
+        y.resize(n);
+        z.resize(n);
+        for (int i = 0; i < n; i++)
+        {
+            x[i] = std::sin(0.37 * i + 0.1) * (1.0 + 0.01 * i);
+            y[i] = std::cos(0.53 * i) * (0.5 + 0.02 * i);
+            z[i] = std::sin(0.71 * i + 1.0) - 0.3;
+        }
+        x[0] = y[0] = 0.0;
+        z[0] = 2.0;
+        x[1] = 1e-9;
+        y[1] = z[1] = 0.0;
+    }
+    std::vector<double> x, y, z;
 };
 
 TEST_F(ylmTest,Zeros)
@@ -23,3 +50,131 @@ TEST_F(ylmTest,Zeros)
         EXPECT_EQ(aaaa[i],0.0);
 	}
 }
+
+TEST_F(ylmTest, SphHarmBatch)
+{
+    const int n = 101;
+    set_points(n);
+    std::vector<double> xdr(n), ydr(n), zdr(n);
+    for (int i = 0; i < n; i++)
+    {
+        const double r = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+        xdr[i] = x[i] / r;
+        ydr[i] = y[i] / r;
+        zdr[i] = z[i] / r;
+    }
+    for (int lmax = 0; lmax <= 7; lmax++)
+    {
+        const int nlm = (lmax + 1) * (lmax + 1);
+        std::vector<double> ylm(nlm * n);
+        ModuleBase::Ylm::sph_harm_batch(lmax, n, xdr.data(), ydr.data(), zdr.data(), ylm.data());
+        std::vector<double> ylm_ref;
+        double max_diff = 0.0;
+        for (int i = 0; i < n; i++)
+        {
+            ModuleBase::Ylm::sph_harm(lmax, xdr[i], ydr[i], zdr[i], ylm_ref);
+            for (int lm = 0; lm < nlm; lm++)
+            {
+                max_diff = std::max(max_diff, std::abs(ylm[lm * n + i] - ylm_ref[lm]));
+            }
+        }
+        EXPECT_LT(max_diff, 1e-12) << "lmax = " << lmax;
+    }
+}
+
+TEST_F(ylmTest, GradRlSphHarmBatch)
+{
+    const int n = 101;
+    set_points(n);
+    for (int lmax = 0; lmax <= 7; lmax++)
+    {
+        const int nlm = (lmax + 1) * (lmax + 1);
+        std::vector<double> rly(nlm * n), grly_x(nlm * n), grly_y(nlm * n), grly_z(nlm * n);
+        ModuleBase::Ylm::grad_rl_sph_harm_batch(lmax, n, x.data(), y.data(), z.data(),
+                                                rly.data(), grly_x.data(), grly_y.data(), grly_z.data());
+        std::vector<double> rly_ref(nlm);
+        std::vector<double> grly_buf(nlm * 3);
+        std::vector<double*> grly_ref(nlm);
+        for (int lm = 0; lm < nlm; lm++)
+        {
+            grly_ref[lm] = &grly_buf[lm * 3];
+        }
+        double max_diff = 0.0;
+        double max_diff_grad = 0.0;
+        for (int i = 0; i < n; i++)
+        {
+            ModuleBase::Ylm::grad_rl_sph_harm(lmax, x[i], y[i], z[i], rly_ref.data(), grly_ref.data());
+            for (int lm = 0; lm < nlm; lm++)
+            {
+                max_diff = std::max(max_diff, std::abs(rly[lm * n + i] - rly_ref[lm]));
+                max_diff_grad = std::max(max_diff_grad, std::abs(grly_x[lm * n + i] - grly_ref[lm][0]));
+                max_diff_grad = std::max(max_diff_grad, std::abs(grly_y[lm * n + i] - grly_ref[lm][1]));
+                max_diff_grad = std::max(max_diff_grad, std::abs(grly_z[lm * n + i] - grly_ref[lm][2]));
+            }
+        }
+        EXPECT_LT(max_diff, 1e-11) << "lmax = " << lmax;
+        EXPECT_LT(max_diff_grad, 1e-11) << "lmax = " << lmax;
+    }
+}
+
+// the meshgrids of a big grid are evaluated at once in gint, compare the cost with the point-by-point calls
+TEST_F(ylmTest, BatchCost)
+{
+    const int n = 64;
+    const int nrepeat = 1600;
+    const int lmax = 3;
+    const int nlm = (lmax + 1) * (lmax + 1);
+    set_points(n);
+
+    std::vector<double> ylm(nlm * n), ylm_ref;
+    std::vector<double> rly(nlm * n), grly_x(nlm * n), grly_y(nlm * n), grly_z(nlm * n);
+    std::vector<double> rly_ref(nlm), grly_buf(nlm * 3);
+    std::vector<double*> grly_ref(nlm);
+    for (int lm = 0; lm < nlm; lm++)
+    {
+        grly_ref[lm] = &grly_buf[lm * 3];
+    }
+    double sum = 0.0;
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int irep = 0; irep < nrepeat; irep++)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            ModuleBase::Ylm::sph_harm(lmax, x[i], y[i], z[i], ylm_ref);
+            sum += ylm_ref[nlm - 1];
+        }
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int irep = 0; irep < nrepeat; irep++)
+    {
+        ModuleBase::Ylm::sph_harm_batch(lmax, n, x.data(), y.data(), z.data(), ylm.data());
+        sum += ylm[nlm * n - 1];
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    for (int irep = 0; irep < nrepeat; irep++)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            ModuleBase::Ylm::grad_rl_sph_harm(lmax, x[i], y[i], z[i], rly_ref.data(), grly_ref.data());
+            sum += grly_ref[nlm - 1][2];
+        }
+    }
+    auto t3 = std::chrono::high_resolution_clock::now();
+    for (int irep = 0; irep < nrepeat; irep++)
+    {
+        ModuleBase::Ylm::grad_rl_sph_harm_batch(lmax, n, x.data(), y.data(), z.data(),
+                                                rly.data(), grly_x.data(), grly_y.data(), grly_z.data());
+        sum += grly_z[nlm * n - 1];
+    }
+    auto t4 = std::chrono::high_resolution_clock::now();
+
+    auto seconds = [](const std::chrono::high_resolution_clock::duration& d) {
+        return std::chrono::duration_cast<std::chrono::duration<double>>(d).count();
+    };
+    std::cout << "lmax = " << lmax << ", " << n << " points, " << nrepeat << " times" << std::endl;
+    std::cout << "sph_harm: " << seconds(t1 - t0) << " s, sph_harm_batch: " << seconds(t2 - t1) << " s" << std::endl;
+    std::cout << "grad_rl_sph_harm: " << seconds(t3 - t2) << " s, grad_rl_sph_harm_batch: " << seconds(t4 - t3)
+              << " s" << std::endl;
+    EXPECT_TRUE(std::isfinite(sum));
+}
@@ -4,9 +4,12 @@
 #include "mpi.h"
 
 #include "gtest/gtest.h"
+#include <chrono>
 #include <complex>
 #include <cstring>
+#include <iostream>
 #include <string>
+#include <vector>
 
 /************************************************
  *  unit test of functions in parallel_common.cpp
@@ -17,6 +20,8 @@
  * in ABACUS, as defined in module_base/parallel_common.h.
  * The source is process 0 in all MPI_Bcast
  * wrappers.
+ * Bcast_Buffer packs many objects to broadcast them at once,
+ * its time is compared with one MPI_Bcast for each object.
  */
 
 class MPIContext
@@ -113,6 +118,106 @@ TEST_F(ParaCommon, Bcast)
     }
 }
 
+TEST_F(ParaCommon, BcastBuffer)
+{
+    int MY_RANK = mpiContext.GetRank();
+    std::vector<double> vd;
+    std::vector<std::string> vs(3);
+    int n = 0;
+    if (MY_RANK == 0)
+    {
+        boo = false;
+        is = 1;
+        fs = 1.0;
+        imgs = std::complex<double>(1.0, -1.0);
+        chs = "ABACUS";
+        vd = {1.0, 2.0, 3.0, 4.0};
+        vs = {"a", "", "abc"};
+        n = 5;
+        for (int i = 0; i < 10; i++)
+        {
+            iv[i] = i;
+        }
+    }
+    Parallel_Common::Bcast_Buffer buffer;
+    buffer.bcast_with([&](Parallel_Common::Bcast_Buffer& b) {
+        b.sync(boo);
+        b.sync(is);
+        b.sync(fs);
+        b.sync(imgs);
+        b.sync(chs);
+        b.sync(vd);
+        b.sync(vs.data(), 3);
+        b.sync(n);
+        // the size n is known on all the processes before the array
+        b.sync(iv, n);
+    });
+    EXPECT_FALSE(boo);
+    EXPECT_EQ(is, 1);
+    EXPECT_EQ(fs, 1.0);
+    EXPECT_EQ(imgs, std::complex<double>(1.0, -1.0));
+    EXPECT_EQ(chs, "ABACUS");
+    ASSERT_EQ(vd.size(), 4);
+    EXPECT_EQ(vd[3], 4.0);
+    EXPECT_EQ(vs[0], "a");
+    EXPECT_EQ(vs[1], "");
+    EXPECT_EQ(vs[2], "abc");
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(iv[i], (i < 5) ? i : ((MY_RANK == 0) ? i : 0));
+    }
+    // bool is packed as one byte
+    EXPECT_EQ(buffer.size(),
+              1 + sizeof(int) + sizeof(double) + sizeof(std::complex<double>) + sizeof(int) + 6 + sizeof(int)
+                  + 4 * sizeof(double) + 3 * sizeof(int) + 4 + sizeof(int) + 5 * sizeof(int));
+}
+
+TEST_F(ParaCommon, BcastBufferTiming)
+{
+    // about the number of input parameters of ReadInput
+    const int nvalues = 600;
+    std::vector<double> values(nvalues, 0.0);
+    if (mpiContext.GetRank() == 0)
+    {
+        for (int i = 0; i < nvalues; i++)
+        {
+            values[i] = i;
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < nvalues; i++)
+    {
+        Parallel_Common::bcast_double(values[i]);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    std::chrono::duration<double> time_single = std::chrono::high_resolution_clock::now() - start;
+
+    std::vector<double> packed(nvalues, 0.0);
+    if (mpiContext.GetRank() == 0)
+    {
+        packed = values;
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    start = std::chrono::high_resolution_clock::now();
+    Parallel_Common::Bcast_Buffer buffer;
+    buffer.bcast_with([&](Parallel_Common::Bcast_Buffer& b) {
+        for (int i = 0; i < nvalues; i++)
+        {
+            b.sync(packed[i]);
+        }
+    });
+    MPI_Barrier(MPI_COMM_WORLD);
+    std::chrono::duration<double> time_packed = std::chrono::high_resolution_clock::now() - start;
+
+    EXPECT_EQ(packed, values);
+    if (mpiContext.GetRank() == 0)
+    {
+        std::cout << "Bcast of " << nvalues << " values on " << mpiContext.GetSize() << " processes: one by one "
+                  << time_single.count() << " s, packed " << time_packed.count() << " s" << std::endl;
+    }
+}
+
 int main(int argc, char** argv)
 {
 
@@ -1095,6 +1095,333 @@ void Ylm::grad_rl_sph_harm
 	return;
 }
 
+namespace
+{
+// The kernels of the batched recurrences below, each of them computes one (l, m) row for all points.
+// The rows never overlap, so the pointers are declared __restrict to let the compiler vectorize the loops.
+
+// Y_lm = var1 * (z * Y_{l-1,m} - var2 * Y_{l-2,m}), for unit vectors
+inline void recur_row(const int n, const double var1, const double var2,
+					  const double* __restrict z,
+					  const double* __restrict y1, const double* __restrict y2, double* __restrict y)
+{
+	for (int i = 0; i < n; i++)
+	{
+		y[i] = var1 * (z[i] * y1[i] - var2 * y2[i]);
+	}
+}
+
+// Y_{l,+-l} = (bl3 * Y_{l,+-(l-2)} - bl2 * Y_{l-2,+-(l-2)} - 2 * x * Y_{l-1,+-(l-1)}) / bl1, for unit vectors
+inline void recur_row_mmax(const int n, const double bl1, const double bl2, const double bl3,
+						   const double* __restrict x,
+						   const double* __restrict y2, const double* __restrict y3,
+						   const double* __restrict y4, double* __restrict y)
+{
+	for (int i = 0; i < n; i++)
+	{
+		y[i] = (bl3 * y2[i] - bl2 * y3[i] - 2.0 * x[i] * y4[i]) / bl1;
+	}
+}
+
+// r^l Y_lm of recur_row and its gradient
+inline void recur_row_grad(const int n, const double var1, const double var2,
+						   const double* __restrict x, const double* __restrict y, const double* __restrict z,
+						   const double* __restrict rly1, const double* __restrict gx1,
+						   const double* __restrict gy1, const double* __restrict gz1,
+						   const double* __restrict rly2, const double* __restrict gx2,
+						   const double* __restrict gy2, const double* __restrict gz2,
+						   double* __restrict rly, double* __restrict gx, double* __restrict gy, double* __restrict gz)
+{
+	for (int i = 0; i < n; i++)
+	{
+		const double r2 = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+		rly[i] = var1 * (z[i] * rly1[i] - var2 * rly2[i] * r2);
+		gx[i] = var1 * (z[i] * gx1[i] - var2 * (rly2[i] * 2.0 * x[i] + gx2[i] * r2));
+		gy[i] = var1 * (z[i] * gy1[i] - var2 * (rly2[i] * 2.0 * y[i] + gy2[i] * r2));
+		gz[i] = var1 * (z[i] * gz1[i] + rly1[i] - var2 * (rly2[i] * 2.0 * z[i] + gz2[i] * r2));
+	}
+}
+
+// r^l Y_{l,+-l} of recur_row_mmax and its gradient
+inline void recur_row_mmax_grad(const int n, const double bl1, const double bl2, const double bl3,
+								const double* __restrict x, const double* __restrict y, const double* __restrict z,
+								const double* __restrict rly2, const double* __restrict gx2,
+								const double* __restrict gy2, const double* __restrict gz2,
+								const double* __restrict rly3, const double* __restrict gx3,
+								const double* __restrict gy3, const double* __restrict gz3,
+								const double* __restrict rly4, const double* __restrict gx4,
+								const double* __restrict gy4, const double* __restrict gz4,
+								double* __restrict rly, double* __restrict gx, double* __restrict gy, double* __restrict gz)
+{
+	for (int i = 0; i < n; i++)
+	{
+		const double r2 = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+		rly[i] = (bl3 * rly2[i] - bl2 * rly3[i] * r2 - 2.0 * x[i] * rly4[i]) / bl1;
+		gx[i] = (bl3 * gx2[i] - bl2 * (gx3[i] * r2 + rly3[i] * 2.0 * x[i]) - 2.0 * (rly4[i] + x[i] * gx4[i])) / bl1;
+		gy[i] = (bl3 * gy2[i] - bl2 * (gy3[i] * r2 + rly3[i] * 2.0 * y[i]) - 2.0 * x[i] * gy4[i]) / bl1;
+		gz[i] = (bl3 * gz2[i] - bl2 * (gz3[i] * r2 + rly3[i] * 2.0 * z[i]) - 2.0 * x[i] * gz4[i]) / bl1;
+	}
+}
+// L <= 2 rows of sph_harm_batch, written explicitly. Only x, y and z are read in the loops.
+inline void sph_harm_l012(const int Lmax, const int n,
+						  const double* __restrict x, const double* __restrict y, const double* __restrict z,
+						  double* __restrict ylm)
+{
+	// local copies, so that the compiler does not reload them in the loops
+	const double c0 = ModuleBase::Ylm::ylmcoef[0];
+	const double c1 = ModuleBase::Ylm::ylmcoef[1];
+	const double c2 = ModuleBase::Ylm::ylmcoef[2];
+	const double c3 = ModuleBase::Ylm::ylmcoef[3];
+	const double c4 = ModuleBase::Ylm::ylmcoef[4];
+	const double c5 = ModuleBase::Ylm::ylmcoef[5];
+	const double c6 = ModuleBase::Ylm::ylmcoef[6];
+
+	/***************************
+			 L = 0
+	***************************/
+	for (int i = 0; i < n; i++)
+	{
+		ylm[i] = c0;
+	}
+	if (Lmax == 0) return;
+
+	/***************************
+			 L = 1
+	***************************/
+	for (int i = 0; i < n; i++)
+	{
+		ylm[n + i] = c1 * z[i]; //l=1, m=0
+		ylm[2 * n + i] = -c1 * x[i]; //l=1, m=1
+		ylm[3 * n + i] = -c1 * y[i]; //l=1, m=-1
+	}
+	if (Lmax == 1) return;
+
+	/***************************
+			 L = 2
+	***************************/
+	for (int i = 0; i < n; i++)
+	{
+		const double tmp0 = c4 * z[i];
+		const double tmp2 = c4 * x[i];
+		const double r4 = c2 * c1 * z[i] * z[i] - c3 * c0;
+		ylm[4 * n + i] = r4; //l=2, m=0
+		ylm[5 * n + i] = -c1 * tmp0 * x[i]; //l=2, m=1
+		ylm[6 * n + i] = -c1 * tmp0 * y[i]; //l=2, m=-1
+		ylm[7 * n + i] = c5 * r4 - c6 * c0 + c1 * tmp2 * x[i]; //l=2, m=2
+		ylm[8 * n + i] = c1 * tmp2 * y[i]; //l=2, m=-2
+	}
+}
+
+// L <= 2 rows of grad_rl_sph_harm_batch, written explicitly. Only x, y and z are read in the loops.
+inline void grad_rl_sph_harm_l012(const int Lmax, const int n,
+								  const double* __restrict x, const double* __restrict y, const double* __restrict z,
+								  double* __restrict rly, double* __restrict grly_x,
+								  double* __restrict grly_y, double* __restrict grly_z)
+{
+	// local copies, so that the compiler does not reload them in the loops
+	const double c0 = ModuleBase::Ylm::ylmcoef[0];
+	const double c1 = ModuleBase::Ylm::ylmcoef[1];
+	const double c2 = ModuleBase::Ylm::ylmcoef[2];
+	const double c3 = ModuleBase::Ylm::ylmcoef[3];
+	const double c4 = ModuleBase::Ylm::ylmcoef[4];
+	const double c5 = ModuleBase::Ylm::ylmcoef[5];
+	const double c6 = ModuleBase::Ylm::ylmcoef[6];
+
+	/***************************
+			 L = 0
+	***************************/
+	for (int i = 0; i < n; i++)
+	{
+		rly[i] = c0;
+		grly_x[i] = 0.0;
+		grly_y[i] = 0.0;
+		grly_z[i] = 0.0;
+	}
+	if (Lmax == 0) return;
+
+	/***************************
+			 L = 1
+	***************************/
+	for (int i = 0; i < n; i++)
+	{
+		rly[n + i] = c1 * z[i]; //l=1, m=0
+		rly[2 * n + i] = -c1 * x[i]; //l=1, m=1
+		rly[3 * n + i] = -c1 * y[i]; //l=1, m=-1
+	}
+	for (int i = 0; i < n; i++)
+	{
+		grly_x[n + i] = 0.0;
+		grly_y[n + i] = 0.0;
+		grly_z[n + i] = c1;
+		grly_x[2 * n + i] = -c1;
+		grly_y[2 * n + i] = 0.0;
+		grly_z[2 * n + i] = 0.0;
+		grly_x[3 * n + i] = 0.0;
+		grly_y[3 * n + i] = -c1;
+		grly_z[3 * n + i] = 0.0;
+	}
+	if (Lmax == 1) return;
+
+	/***************************
+			 L = 2
+	***************************/
+	// the L = 0 and L = 1 terms and their (constant) derivatives are written explicitly
+	for (int i = 0; i < n; i++)
+	{
+		const double xi = x[i];
+		const double yi = y[i];
+		const double zi = z[i];
+		const double radius2 = xi * xi + yi * yi + zi * zi;
+		const double r1 = c1 * zi;
+		const double r2 = -c1 * xi;
+		const double r3 = -c1 * yi;
+
+		const double r4 = c2 * zi * r1 - c3 * c0 * radius2; //l=2, m=0
+		const double g4x = -c3 * c0 * 2.0 * xi;
+		const double g4y = -c3 * c0 * 2.0 * yi;
+		const double g4z = c2 * (zi * c1 + r1) - c3 * c0 * 2.0 * zi;
+		rly[4 * n + i] = r4;
+		grly_x[4 * n + i] = g4x;
+		grly_y[4 * n + i] = g4y;
+		grly_z[4 * n + i] = g4z;
+
+		const double tmp0 = c4 * zi;
+		rly[5 * n + i] = tmp0 * r2; //l=2, m=1
+		grly_x[5 * n + i] = -tmp0 * c1;
+		grly_y[5 * n + i] = 0.0;
+		grly_z[5 * n + i] = c4 * r2;
+
+		rly[6 * n + i] = tmp0 * r3; //l=2, m=-1
+		grly_x[6 * n + i] = 0.0;
+		grly_y[6 * n + i] = -tmp0 * c1;
+		grly_z[6 * n + i] = c4 * r3;
+
+		const double tmp2 = c4 * xi;
+		rly[7 * n + i] = c5 * r4 - c6 * c0 * radius2 - tmp2 * r2; //l=2, m=2
+		grly_x[7 * n + i] = c5 * g4x - c6 * c0 * 2.0 * xi - c4 * (-xi * c1 + r2);
+		grly_y[7 * n + i] = c5 * g4y - c6 * c0 * 2.0 * yi;
+		grly_z[7 * n + i] = c5 * g4z - c6 * c0 * 2.0 * zi;
+
+		rly[8 * n + i] = -tmp2 * r3; //l=2, m=-2
+		grly_x[8 * n + i] = -c4 * r3;
+		grly_y[8 * n + i] = tmp2 * c1;
+		grly_z[8 * n + i] = 0.0;
+	}
+}
+
+} // namespace
+
+void Ylm::sph_harm_batch
+(
+	const int Lmax,
+	const int n,
+	const double* xdr,
+	const double* ydr,
+	const double* zdr,
+	double* ylm
+)
+{
+	sph_harm_l012(Lmax, n, xdr, ydr, zdr, ylm);
+	if (Lmax <= 2) return;
+
+	// for L >= 3, the general recurrence of sph_harm gives the same values as the explicit ones
+	for (int il = 3; il <= Lmax; il++)
+	{
+		const int istart = il * il;
+		const int istart1 = (il - 1) * (il - 1);
+		const int istart2 = (il - 2) * (il - 2);
+
+		const double fac2 = sqrt(4.0 * istart - 1.0);
+		const double fac4 = sqrt(4.0 * istart1 - 1.0);
+
+		for (int im = 0; im < 2 * il - 1; im++)
+		{
+			const int imm = (im + 1) / 2;
+			const double var1 = fac2 / sqrt((double)istart - imm * imm);
+			const double var2 = sqrt((double)istart1 - imm * imm) / fac4;
+			recur_row(n, var1, var2, zdr,
+					  ylm + (istart1 + im) * n, ylm + (istart2 + im) * n, ylm + (istart + im) * n);
+		}
+
+		const double bl1 = sqrt(2.0 * il / (2.0 * il + 1.0));
+		const double bl2 = sqrt((2.0 * il - 2.0) / (2.0 * il - 1.0));
+		const double bl3 = sqrt(2.0) / fac2;
+
+		// m = l and m = -l
+		for (int k = 0; k < 2; k++)
+		{
+			recur_row_mmax(n, bl1, bl2, bl3, xdr,
+						   ylm + (istart + 2 * il - 5 + k) * n,
+						   ylm + (istart2 + 2 * il - 5 + k) * n,
+						   ylm + (istart1 + 2 * il - 3 + k) * n,
+						   ylm + (istart + 2 * il - 1 + k) * n);
+		}
+	}
+	return;
+}
+
+void Ylm::grad_rl_sph_harm_batch
+(
+	const int Lmax,
+	const int n,
+	const double* x,
+	const double* y,
+	const double* z,
+	double* rly,
+	double* grly_x,
+	double* grly_y,
+	double* grly_z
+)
+{
+	grad_rl_sph_harm_l012(Lmax, n, x, y, z, rly, grly_x, grly_y, grly_z);
+	if (Lmax <= 2) return;
+
+	// for L >= 3, the general recurrence of grad_rl_sph_harm
+	for (int il = 3; il <= Lmax; il++)
+	{
+		const int istart = il * il;
+		const int istart1 = (il - 1) * (il - 1);
+		const int istart2 = (il - 2) * (il - 2);
+
+		const double fac2 = sqrt(4.0 * istart - 1.0);
+		const double fac4 = sqrt(4.0 * istart1 - 1.0);
+
+		for (int im = 0; im < 2 * il - 1; im++)
+		{
+			const int imm = (im + 1) / 2;
+			const double var1 = fac2 / sqrt((double)istart - imm * imm);
+			const double var2 = sqrt((double)istart1 - imm * imm) / fac4;
+
+			const int id = (istart + im) * n;
+			const int id1 = (istart1 + im) * n;
+			const int id2 = (istart2 + im) * n;
+			recur_row_grad(n, var1, var2, x, y, z,
+						   rly + id1, grly_x + id1, grly_y + id1, grly_z + id1,
+						   rly + id2, grly_x + id2, grly_y + id2, grly_z + id2,
+						   rly + id, grly_x + id, grly_y + id, grly_z + id);
+		}
+
+		const double bl1 = sqrt(2.0 * il / (2.0 * il + 1.0));
+		const double bl2 = sqrt((2.0 * il - 2.0) / (2.0 * il - 1.0));
+		const double bl3 = sqrt(2.0) / fac2;
+
+		// m = l and m = -l
+		for (int k = 0; k < 2; k++)
+		{
+			const int id1 = (istart + 2 * il - 1 + k) * n;
+			const int id2 = (istart + 2 * il - 5 + k) * n;
+			const int id3 = (istart2 + 2 * il - 5 + k) * n;
+			const int id4 = (istart1 + 2 * il - 3 + k) * n;
+			recur_row_mmax_grad(n, bl1, bl2, bl3, x, y, z,
+								rly + id2, grly_x + id2, grly_y + id2, grly_z + id2,
+								rly + id3, grly_x + id3, grly_y + id3, grly_z + id3,
+								rly + id4, grly_x + id4, grly_y + id4, grly_z + id4,
+								rly + id1, grly_x + id1, grly_y + id1, grly_z + id1);
+		}
+	}
+	return;
+}
+
 void Ylm::hes_rl_sph_harm
 (
  	const int& Lmax, //max momentum of L
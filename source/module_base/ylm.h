@@ -130,6 +130,53 @@ class Ylm
 			double* rly,
 			double** grly);
 
+	/**
+	 * @brief Get the ylm real object of n points at once (used in grid integration)
+	 *
+	 * The same as sph_harm, but the results are stored in structure-of-arrays layout,
+	 * so that the inner loops over points can be vectorized by the compiler.
+	 *
+	 * @param Lmax [in] maximum angular quantum number
+	 * @param n [in] number of points
+	 * @param xdr [in] x/r of the points, [n]
+	 * @param ydr [in] y/r of the points, [n]
+	 * @param zdr [in] z/r of the points, [n]
+	 * @param ylm [out] ylm[lm*n+i] is the lm-th Ylm (same order as sph_harm) of the i-th point, [(Lmax+1)^2*n]
+	 */
+	static void sph_harm_batch(
+			const int Lmax,
+			const int n,
+			const double* xdr,
+			const double* ydr,
+			const double* zdr,
+			double* ylm);
+
+	/**
+	 * @brief Get r^l Ylm and its gradient of n points at once (used in grid integration)
+	 *
+	 * The same as grad_rl_sph_harm, but the results are stored in structure-of-arrays layout.
+	 *
+	 * @param Lmax [in] maximum angular quantum number
+	 * @param n [in] number of points
+	 * @param x [in] x of the points, [n]
+	 * @param y [in] y of the points, [n]
+	 * @param z [in] z of the points, [n]
+	 * @param rly [out] rly[lm*n+i] is r^l Ylm of the i-th point, [(Lmax+1)^2*n]
+	 * @param grly_x [out] grly_x[lm*n+i] is d(r^l Ylm)/dx of the i-th point, [(Lmax+1)^2*n]
+	 * @param grly_y [out] d(r^l Ylm)/dy
+	 * @param grly_z [out] d(r^l Ylm)/dz
+	 */
+	static void grad_rl_sph_harm_batch(
+			const int Lmax,
+			const int n,
+			const double* x,
+			const double* y,
+			const double* z,
+			double* rly,
+			double* grly_x,
+			double* grly_y,
+			double* grly_z);
+
 	/**
 	 * @brief Get the hessian of r^l Ylm (used in getting derivative of overlap)
 	 * 
@@ -6,7 +6,11 @@
 
 #include "gtest/gtest.h"
 #include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <cstdio>
 #include <cstring>
+#include <sys/stat.h>
 using iclock = std::chrono::high_resolution_clock;
 
 #ifdef __MPI
@@ -21,6 +25,9 @@ using iclock = std::chrono::high_resolution_clock;
  *
  *  - build
  *      - builds a two-center integral radial table from two RadialCollection objects
+ *
+ *  - build with cache_dir, key, save, load
+ *      - the table is saved to the cache at the first build and loaded by the next one
  *                                                                      */
 class TwoCenterTableTest : public ::testing::Test
 {
@@ -194,6 +201,84 @@ TEST_F(TwoCenterTableTest, BuildOverlapAndKinetic)
     EXPECT_EQ(T_tab.rmax(), rmax);
 }
 
+TEST_F(TwoCenterTableTest, Cache)
+{
+    orb.build(nfile, file, 'o');
+
+    ModuleBase::SphericalBesselTransformer sbt;
+    orb.set_transformer(sbt);
+
+    double rmax = orb.rcut_max() * 2.0;
+    double dr = 0.01;
+    int nr = static_cast<int>(rmax / dr) + 1;
+    orb.set_uniform_grid(true, nr, rmax, 'i', true);
+
+    const std::string cache_dir = "./two_center_table_cache";
+    mkdir(cache_dir.c_str(), 0755);
+
+    // the key changes with any of the tabulation parameters
+    const uint64_t key = TwoCenterTable::key(orb, orb, 'S', nr, rmax);
+    EXPECT_EQ(key, TwoCenterTable::key(orb, orb, 'S', nr, rmax));
+    EXPECT_NE(key, TwoCenterTable::key(orb, orb, 'T', nr, rmax));
+    EXPECT_NE(key, TwoCenterTable::key(orb, orb, 'S', nr + 1, rmax));
+    EXPECT_NE(key, TwoCenterTable::key(orb, orb, 'S', nr, rmax + dr));
+
+    iclock::time_point start = iclock::now();
+    S_tab.build(orb, orb, 'S', nr, rmax, cache_dir);
+    std::chrono::duration<double> dur_build = iclock::now() - start;
+
+    start = iclock::now();
+    TwoCenterTable S_cached;
+    S_cached.build(orb, orb, 'S', nr, rmax, cache_dir);
+    std::chrono::duration<double> dur_load = iclock::now() - start;
+    std::cout << "time elapsed: build = " << dur_build.count() << " s, load from cache = " << dur_load.count() << " s"
+              << std::endl;
+
+    EXPECT_EQ(S_cached.op(), 'S');
+    EXPECT_EQ(S_cached.nr(), nr);
+    EXPECT_EQ(S_cached.ntab(), S_tab.ntab());
+    EXPECT_EQ(S_cached.rmax(), rmax);
+    for (int l1 = 0; l1 <= orb.lmax(); ++l1)
+    {
+        for (const NumericalRadial** it1 = orb.cbegin(l1); it1 != orb.cend(l1); ++it1)
+        {
+            for (int l2 = 0; l2 <= orb.lmax(); ++l2)
+            {
+                for (const NumericalRadial** it2 = orb.cbegin(l2); it2 != orb.cend(l2); ++it2)
+                {
+                    for (int l = std::abs(l1 - l2); l <= l1 + l2; l += 2)
+                    {
+                        const int t1 = (*it1)->itype(), z1 = (*it1)->izeta();
+                        const int t2 = (*it2)->itype(), z2 = (*it2)->izeta();
+                        for (const bool deriv: {false, true})
+                        {
+                            const double* f = S_tab.table(t1, l1, z1, t2, l2, z2, l, deriv);
+                            const double* f_cached = S_cached.table(t1, l1, z1, t2, l2, z2, l, deriv);
+                            EXPECT_EQ(std::memcmp(f, f_cached, nr * sizeof(double)), 0);
+                        }
+                        double val = 0.0, val_cached = 0.0;
+                        S_tab.lookup(t1, l1, z1, t2, l2, z2, l, 1.234, &val);
+                        S_cached.lookup(t1, l1, z1, t2, l2, z2, l, 1.234, &val_cached);
+                        EXPECT_EQ(val, val_cached);
+                    }
+                }
+            }
+        }
+    }
+
+    // a file of another key is rejected
+    std::stringstream ss;
+    ss << cache_dir << "/two_center_S_" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    TwoCenterTable S_wrong;
+    EXPECT_TRUE(S_wrong.load(ss.str(), key));
+    EXPECT_FALSE(S_wrong.load(ss.str(), key + 1));
+    EXPECT_EQ(S_wrong.ntab(), 0);
+    EXPECT_FALSE(S_wrong.load(cache_dir + "/not_exist.bin", key));
+
+    std::remove(ss.str().c_str());
+    rmdir(cache_dir.c_str());
+}
+
 int main(int argc, char** argv)
 {
 
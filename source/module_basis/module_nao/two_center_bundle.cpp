@@ -89,31 +89,31 @@ void TwoCenterBundle::tabulate()
 
     // build TwoCenterIntegrator objects
     kinetic_orb = std::unique_ptr<TwoCenterIntegrator>(new TwoCenterIntegrator);
-    kinetic_orb->tabulate(*orb_, *orb_, 'T', nr, cutoff);
+    kinetic_orb->tabulate(*orb_, *orb_, 'T', nr, cutoff, table_cache_dir_);
     ModuleBase::Memory::record("TwoCenterTable: Kinetic", kinetic_orb->table_memory());
 
     overlap_orb = std::unique_ptr<TwoCenterIntegrator>(new TwoCenterIntegrator);
-    overlap_orb->tabulate(*orb_, *orb_, 'S', nr, cutoff);
+    overlap_orb->tabulate(*orb_, *orb_, 'S', nr, cutoff, table_cache_dir_);
     ModuleBase::Memory::record("TwoCenterTable: Overlap", overlap_orb->table_memory());
 
     if (beta_)
     {
         overlap_orb_beta = std::unique_ptr<TwoCenterIntegrator>(new TwoCenterIntegrator);
-        overlap_orb_beta->tabulate(*orb_, *beta_, 'S', nr, cutoff);
+        overlap_orb_beta->tabulate(*orb_, *beta_, 'S', nr, cutoff, table_cache_dir_);
         ModuleBase::Memory::record("TwoCenterTable: Nonlocal", overlap_orb_beta->table_memory());
     }
 
     if (alpha_)
     {
         overlap_orb_alpha = std::unique_ptr<TwoCenterIntegrator>(new TwoCenterIntegrator);
-        overlap_orb_alpha->tabulate(*orb_, *alpha_, 'S', nr, cutoff);
+        overlap_orb_alpha->tabulate(*orb_, *alpha_, 'S', nr, cutoff, table_cache_dir_);
         ModuleBase::Memory::record("TwoCenterTable: Descriptor", overlap_orb_alpha->table_memory());
     }
 
     if (orb_onsite_)
     {
         overlap_orb_onsite = std::unique_ptr<TwoCenterIntegrator>(new TwoCenterIntegrator);
-        overlap_orb_onsite->tabulate(*orb_, *orb_onsite_, 'S', nr, cutoff);
+        overlap_orb_onsite->tabulate(*orb_, *orb_onsite_, 'S', nr, cutoff, table_cache_dir_);
     }
 
     ModuleBase::Memory::record("RealGauntTable", RealGauntTable::instance().memory());
@@ -166,18 +166,18 @@ void TwoCenterBundle::tabulate(const double lcao_ecut,
     const int nr_st = static_cast<int>(cutoff_st / lcao_dr) + 5;
 
     kinetic_orb = std::unique_ptr<TwoCenterIntegrator>(new TwoCenterIntegrator);
-    kinetic_orb->tabulate(*orb_, *orb_, 'T', nr_st, cutoff_st);
+    kinetic_orb->tabulate(*orb_, *orb_, 'T', nr_st, cutoff_st, table_cache_dir_);
     ModuleBase::Memory::record("TwoCenterTable: Kinetic", kinetic_orb->table_memory());
 
     overlap_orb = std::unique_ptr<TwoCenterIntegrator>(new TwoCenterIntegrator);
-    overlap_orb->tabulate(*orb_, *orb_, 'S', nr_st, cutoff_st);
+    overlap_orb->tabulate(*orb_, *orb_, 'S', nr_st, cutoff_st, table_cache_dir_);
     ModuleBase::Memory::record("TwoCenterTable: Overlap", overlap_orb->table_memory());
 
     // overlap between orbital and beta (for nonlocal potential)
     const double cutoff_nl = std::min(lcao_rmax, orb_->rcut_max() + beta_->rcut_max());
     const int nr_nl = static_cast<int>(cutoff_nl / lcao_dr) + 5;
     overlap_orb_beta = std::unique_ptr<TwoCenterIntegrator>(new TwoCenterIntegrator);
-    overlap_orb_beta->tabulate(*orb_, *beta_, 'S', nr_nl, cutoff_nl);
+    overlap_orb_beta->tabulate(*orb_, *beta_, 'S', nr_nl, cutoff_nl, table_cache_dir_);
     ModuleBase::Memory::record("TwoCenterTable: Nonlocal", overlap_orb_beta->table_memory());
 
     // overlap between orbital and deepks projector
@@ -186,7 +186,7 @@ void TwoCenterBundle::tabulate(const double lcao_ecut,
         const double cutoff_alpha = std::min(lcao_rmax, orb_->rcut_max() + alpha_->rcut_max());
         const int nr_alpha = static_cast<int>(cutoff_alpha / lcao_dr) + 5;
         overlap_orb_alpha = std::unique_ptr<TwoCenterIntegrator>(new TwoCenterIntegrator);
-        overlap_orb_alpha->tabulate(*orb_, *alpha_, 'S', nr_alpha, cutoff_alpha);
+        overlap_orb_alpha->tabulate(*orb_, *alpha_, 'S', nr_alpha, cutoff_alpha, table_cache_dir_);
         ModuleBase::Memory::record("TwoCenterTable: Descriptor", overlap_orb_beta->table_memory());
     }
 
@@ -196,7 +196,7 @@ void TwoCenterBundle::tabulate(const double lcao_ecut,
         const double cutoff_onsite = std::min(lcao_rmax, orb_->rcut_max() + orb_onsite_->rcut_max());
         const int nr_onsite = static_cast<int>(cutoff_onsite / lcao_dr) + 5;
         overlap_orb_onsite = std::unique_ptr<TwoCenterIntegrator>(new TwoCenterIntegrator);
-        overlap_orb_onsite->tabulate(*orb_, *orb_onsite_, 'S', nr_onsite, cutoff_onsite);
+        overlap_orb_onsite->tabulate(*orb_, *orb_onsite_, 'S', nr_onsite, cutoff_onsite, table_cache_dir_);
     }
 
     ModuleBase::Memory::record("RealGauntTable", RealGauntTable::instance().memory());
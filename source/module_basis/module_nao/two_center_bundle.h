@@ -20,6 +20,9 @@ class TwoCenterBundle
     void build_alpha(int ndesc = 0, std::string* file_desc0 = nullptr);
     void build_orb_onsite(const double& radius);
 
+    /// sets the directory where the two-center tables are cached and reused by later runs, no cache if empty
+    void set_table_cache(const std::string& dir) { table_cache_dir_ = dir; }
+
     void tabulate();
 
     // Unlike the tabulate() above, this overload function computes
@@ -49,6 +52,9 @@ class TwoCenterBundle
     std::unique_ptr<RadialCollection> beta_;
     std::unique_ptr<RadialCollection> alpha_;
     std::unique_ptr<RadialCollection> orb_onsite_;
+
+  private:
+    std::string table_cache_dir_;
 };
 
 #endif
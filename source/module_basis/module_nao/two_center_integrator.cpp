@@ -14,10 +14,11 @@ void TwoCenterIntegrator::tabulate(const RadialCollection& bra,
                                    const RadialCollection& ket,
                                    const char op,
                                    const int nr,
-                                   const double cutoff)
+                                   const double cutoff,
+                                   const std::string& cache_dir)
 {
     op_ = op;
-    table_.build(bra, ket, op, nr, cutoff);
+    table_.build(bra, ket, op, nr, cutoff, cache_dir);
     RealGauntTable::instance().build(std::max(bra.lmax(), ket.lmax()));
     is_tabulated_ = true;
 }
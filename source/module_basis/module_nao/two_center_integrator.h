@@ -48,12 +48,14 @@ class TwoCenterIntegrator
      * @param[in] op           Operator, could be 'S' or 'T'.
      * @param[in] nr           Number of r-space grid points.
      * @param[in] cutoff       r-space cutoff radius.
+     * @param[in] cache_dir    Directory of the table cache, see TwoCenterTable::build.
      *                                                                                  */
     void tabulate(const RadialCollection& bra,
                   const RadialCollection& ket,
                   const char op,
                   const int nr,
-                  const double cutoff
+                  const double cutoff,
+                  const std::string& cache_dir = ""
     );
 
     /*!
@@ -2,19 +2,27 @@
 
 #include "module_base/constants.h"
 #include "module_base/cubic_spline.h"
+#include "module_base/global_variable.h"
 #include "module_base/math_integral.h"
 
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <limits>
 #include <numeric>
 
+constexpr int TwoCenterTable::cache_version;
+
 void TwoCenterTable::build(const RadialCollection& bra,
                            const RadialCollection& ket,
                            const char op,
                            const int nr,
-                           const double cutoff)
+                           const double cutoff,
+                           const std::string& cache_dir)
 {
 #ifdef __DEBUG
     assert(nr >= 3 && cutoff > 0.0);
@@ -22,6 +30,21 @@ void TwoCenterTable::build(const RadialCollection& bra,
 
     cleanup();
 
+    std::string file;
+    uint64_t cache_key = 0;
+    if (!cache_dir.empty())
+    {
+        cache_key = key(bra, ket, op, nr, cutoff);
+        std::stringstream ss;
+        ss << cache_dir << (cache_dir.back() == '/' ? "" : "/") << "two_center_" << op << "_" << std::hex
+           << std::setw(16) << std::setfill('0') << cache_key << ".bin";
+        file = ss.str();
+        if (load(file, cache_key))
+        {
+            return;
+        }
+    }
+
     op_ = op;
     nr_ = nr;
     rmax_ = cutoff;
@@ -32,9 +55,7 @@ void TwoCenterTable::build(const RadialCollection& bra,
         for (int l = 0; l <= ket.lmax(itype); ++l)
             nchi_ket_.get_value<int>(itype, l) = ket.nzeta(itype, l);
 
-    rgrid_ = new double[nr_];
-    double dr = rmax_ / (nr_ - 1);
-    std::for_each(rgrid_, rgrid_ + nr_, [this, dr](double& r) { r = (&r - rgrid_) * dr; });
+    set_rgrid();
 
     // index the table by generating a map from (itype1, l1, izeta1, itype2, l2, izeta2, l) to a row index
     index_map_.resize({bra.ntype(),
@@ -52,6 +73,148 @@ void TwoCenterTable::build(const RadialCollection& bra,
     table_.resize({ntab_, nr_});
     dtable_.resize({ntab_, nr_});
     two_center_loop(bra, ket, &TwoCenterTable::_tabulate);
+
+    if (!file.empty() && GlobalV::MY_RANK == 0)
+    {
+        save(file, cache_key);
+    }
+}
+
+uint64_t TwoCenterTable::key(const RadialCollection& bra,
+                             const RadialCollection& ket,
+                             const char op,
+                             const int nr,
+                             const double cutoff)
+{
+    // 64-bit FNV-1a
+    uint64_t h = 14695981039346656037ULL;
+    auto add = [&h](const void* data, const size_t size) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            h ^= p[i];
+            h *= 1099511628211ULL;
+        }
+    };
+    auto add_collection = [&add](const RadialCollection& col) {
+        const int ntype = col.ntype();
+        add(&ntype, sizeof(int));
+        for (const NumericalRadial** it = col.cbegin(); it != col.cend(); ++it)
+        {
+            const NumericalRadial& rad = **it;
+            const int info[5] = {rad.itype(), rad.l(), rad.izeta(), rad.nr(), rad.nk()};
+            const double power[2] = {rad.pr(), rad.pk()};
+            const bool fft = rad.is_fft_compliant();
+            add(info, sizeof(info));
+            add(power, sizeof(power));
+            add(&fft, sizeof(bool));
+            add(rad.rgrid(), rad.nr() * sizeof(double));
+            add(rad.rvalue(), rad.nr() * sizeof(double));
+            add(rad.kgrid(), rad.nk() * sizeof(double));
+            add(rad.kvalue(), rad.nk() * sizeof(double));
+        }
+    };
+    add(&cache_version, sizeof(int));
+    add(&op, sizeof(char));
+    add(&nr, sizeof(int));
+    add(&cutoff, sizeof(double));
+    add_collection(bra);
+    add_collection(ket);
+    return h;
+}
+
+bool TwoCenterTable::save(const std::string& file, const uint64_t key) const
+{
+    // write to a temporary file and rename, so that other processes never read a partial file
+    const std::string file_tmp = file + ".tmp" + std::to_string(GlobalV::MY_RANK);
+    {
+        std::ofstream ofs(file_tmp, std::ios::binary);
+        if (!ofs)
+        {
+            return false;
+        }
+        auto write = [&ofs](const void* data, const size_t size) {
+            ofs.write(static_cast<const char*>(data), size);
+        };
+        auto write_tensor = [&write](const container::Tensor& t, const size_t size_elem) {
+            const int ndim = t.shape().ndim();
+            write(&ndim, sizeof(int));
+            for (int i = 0; i < ndim; ++i)
+            {
+                const int64_t dim = t.shape().dim_size(i);
+                write(&dim, sizeof(int64_t));
+            }
+            write(t.data(), t.NumElements() * size_elem);
+        };
+        write(&cache_version, sizeof(int));
+        write(&key, sizeof(uint64_t));
+        write(&op_, sizeof(char));
+        write(&ntab_, sizeof(int));
+        write(&nr_, sizeof(int));
+        write(&rmax_, sizeof(double));
+        write_tensor(nchi_ket_, sizeof(int));
+        write_tensor(index_map_, sizeof(int));
+        write_tensor(table_, sizeof(double));
+        write_tensor(dtable_, sizeof(double));
+        if (!ofs)
+        {
+            std::remove(file_tmp.c_str());
+            return false;
+        }
+    }
+    return std::rename(file_tmp.c_str(), file.c_str()) == 0;
+}
+
+bool TwoCenterTable::load(const std::string& file, const uint64_t key)
+{
+    cleanup();
+    std::ifstream ifs(file, std::ios::binary);
+    if (!ifs)
+    {
+        return false;
+    }
+    auto read = [&ifs](void* data, const size_t size) {
+        ifs.read(static_cast<char*>(data), size);
+        return static_cast<bool>(ifs);
+    };
+    auto read_tensor = [&read](container::Tensor& t, const size_t size_elem) {
+        int ndim = 0;
+        if (!read(&ndim, sizeof(int)) || ndim <= 0 || ndim > 8)
+        {
+            return false;
+        }
+        std::vector<int64_t> dims(ndim);
+        if (!read(dims.data(), ndim * sizeof(int64_t)))
+        {
+            return false;
+        }
+        t.resize(container::TensorShape(dims));
+        return read(t.data(), t.NumElements() * size_elem);
+    };
+
+    int version = 0;
+    uint64_t key_file = 0;
+    bool ok = read(&version, sizeof(int)) && version == cache_version && read(&key_file, sizeof(uint64_t))
+              && key_file == key && read(&op_, sizeof(char)) && read(&ntab_, sizeof(int)) && read(&nr_, sizeof(int))
+              && read(&rmax_, sizeof(double)) && read_tensor(nchi_ket_, sizeof(int))
+              && read_tensor(index_map_, sizeof(int)) && read_tensor(table_, sizeof(double))
+              && read_tensor(dtable_, sizeof(double));
+    ok = ok && table_.NumElements() == static_cast<int64_t>(ntab_) * nr_ && dtable_.NumElements() == table_.NumElements();
+    if (!ok)
+    {
+        cleanup();
+        return false;
+    }
+    set_rgrid();
+    return true;
+}
+
+void TwoCenterTable::set_rgrid()
+{
+    delete[] rgrid_;
+    rgrid_ = new double[nr_];
+    double dr = rmax_ / (nr_ - 1);
+    std::for_each(rgrid_, rgrid_ + nr_, [this, dr](double& r) { r = (&r - rgrid_) * dr; });
 }
 
 const double* TwoCenterTable::table(const int itype1,
@@ -5,6 +5,9 @@
 #include "module_base/spherical_bessel_transformer.h"
 #include "module_basis/module_nao/radial_collection.h"
 
+#include <cstdint>
+#include <string>
+
 class TwoCenterTable
 {
   public:
@@ -18,9 +21,38 @@ class TwoCenterTable
                const RadialCollection& ket,  //!< [in] radial collection involved in <bra|op|ket>
                const char op,                //!< [in] operator of the two-center integral
                const int nr,                 //!< [in] number of table grid points
-               const double cutoff           //!< [in] cutoff radius of the table
+               const double cutoff,          //!< [in] cutoff radius of the table
+               const std::string& cache_dir = "" //!< [in] directory of the table cache, no cache if empty
     );
 
+    /*!
+     *  @name Table cache
+     *
+     *  Tabulation by spherical Bessel transforms is the major cost of build(). If a cache directory
+     *  is given to build(), the table is loaded from the file named by key() in that directory if present,
+     *  otherwise it is built and saved there (by RANK-0 only). The key is a hash of everything the table
+     *  depends on: the grids and values of all radial functions (which cover the orbital/pseudopotential
+     *  files and lcao_ecut, lcao_dk), the operator, nr and cutoff (which cover lcao_dr and lcao_rmax).
+     *                                                                                      */
+    //!@{
+    //! returns the cache key of the table to be built from the given arguments
+    static uint64_t key(const RadialCollection& bra,
+                        const RadialCollection& ket,
+                        const char op,
+                        const int nr,
+                        const double cutoff);
+
+    //! writes the table to a binary file, returns false on failure
+    bool save(const std::string& file, const uint64_t key) const;
+
+    //! reads the table from a binary file written by save(), returns false if the file is absent or
+    //! does not match the key and version, in which case the table is left empty
+    bool load(const std::string& file, const uint64_t key);
+
+    //! version of the cache file format, to be increased whenever the file format or the tabulation changes
+    static constexpr int cache_version = 1;
+    //!@}
+
     /*!
      *  @name Getters
      *                                                                                      */
@@ -107,6 +139,9 @@ class TwoCenterTable
     /// deallocates memory and reset variables to default.
     void cleanup();
 
+    /// sets rgrid_ according to nr_ and rmax_
+    void set_rgrid();
+
     /// returns whether the given indices map to an entry in the table
     bool is_present(const int itype1,
                     const int l1,
@@ -127,6 +127,83 @@ class FFT_BASE
     virtual __attribute__((weak)) void fftxyc2r(std::complex<FPTYPE>* in, 
                                                 FPTYPE* out) const;
 
+    /**
+     * @brief Get the number of bands transformed together in the batched fft
+     *
+     * The batched fft is only used when the returned value is larger than 1.
+     */
+    virtual int get_fft_batch() const
+    {
+        return 1;
+    }
+
+    /**
+     * @brief Get the auxiliary data of the batched fft
+     *
+     * The data of the ib-th band starts at ib * get_batch_stride().
+     */
+    virtual __attribute__((weak)) std::complex<FPTYPE>* get_auxr_batch_data() const;
+
+    virtual __attribute__((weak)) std::complex<FPTYPE>* get_auxg_batch_data() const;
+
+    virtual int get_batch_stride() const
+    {
+        return 0;
+    }
+
+    /**
+     * @brief Batched FFT of get_fft_batch() bands
+     * @param in  input data, get_fft_batch() bands with distance get_batch_stride()
+     * @param out  output data
+     *
+     * These functions do the same as fftzfor, fftzbac, fftxyfor and fftxybac,
+     * but for several bands in one fftw plan.
+     */
+    virtual __attribute__((weak)) void fftzfor_batch(std::complex<FPTYPE>* in,
+                                                     std::complex<FPTYPE>* out) const;
+
+    virtual __attribute__((weak)) void fftzbac_batch(std::complex<FPTYPE>* in,
+                                                     std::complex<FPTYPE>* out) const;
+
+    virtual __attribute__((weak)) void fftxyfor_batch(std::complex<FPTYPE>* in,
+                                                      std::complex<FPTYPE>* out) const;
+
+    virtual __attribute__((weak)) void fftxybac_batch(std::complex<FPTYPE>* in,
+                                                      std::complex<FPTYPE>* out) const;
+
+    /**
+     * @brief Get the number of stick chunks in the pipelined transform
+     *
+     * The sticks are split into chunks so that the z-FFT of one chunk
+     * overlaps with the transpose of another. 1 means no pipeline.
+     */
+    virtual int get_pipeline_nchunk() const
+    {
+        return 1;
+    }
+
+    /**
+     * @brief Get the buffer used by the pipelined transpose, [maxgrids]
+     */
+    virtual __attribute__((weak)) std::complex<FPTYPE>* get_auxt_data() const;
+
+    /**
+     * @brief FFT in z direction of one chunk of sticks
+     * @param in  input data of the first stick in the chunk
+     * @param out  output data
+     * @param nstick  number of sticks in the chunk
+     *
+     * nstick should be the one given by the chunk partition of the pipelined
+     * transform, i.e. ceil(ns/nchunk) or the remainder.
+     */
+    virtual __attribute__((weak)) void fftzfor_chunk(std::complex<FPTYPE>* in,
+                                                     std::complex<FPTYPE>* out,
+                                                     const int nstick) const;
+
+    virtual __attribute__((weak)) void fftzbac_chunk(std::complex<FPTYPE>* in,
+                                                     std::complex<FPTYPE>* out,
+                                                     const int nstick) const;
+
     /**
      * @brief Forward FFT in 3D
      * @param in  input data
@@ -82,7 +82,7 @@ void FFT_Bundle::initfft(int nx_in,
     if (device == "cpu")
     {
         fft_float = make_unique<FFT_CPU<float>>(this->fft_mode);
-        fft_double = make_unique<FFT_CPU<double>>(this->fft_mode);
+        fft_double = make_unique<FFT_CPU<double>>(this->fft_mode, this->fft_batch, this->pipeline_nchunk);
         if (float_flag)
         {
             fft_float
@@ -256,6 +256,140 @@ void FFT_Bundle::fft3D_backward(const base_device::DEVICE_GPU* ctx,
     fft_double->fft3D_backward(in, out);
 }
 
+// the batched fft is only implemented for double type
+template <>
+int FFT_Bundle::get_fft_batch<float>() const
+{
+    return 1;
+}
+template <>
+int FFT_Bundle::get_fft_batch<double>() const
+{
+    return (fft_double == nullptr) ? 1 : fft_double->get_fft_batch();
+}
+
+template <>
+int FFT_Bundle::get_batch_stride<float>() const
+{
+    return 0;
+}
+template <>
+int FFT_Bundle::get_batch_stride<double>() const
+{
+    return fft_double->get_batch_stride();
+}
+
+template <>
+std::complex<float>* FFT_Bundle::get_auxr_batch_data() const
+{
+    return nullptr;
+}
+template <>
+std::complex<double>* FFT_Bundle::get_auxr_batch_data() const
+{
+    return fft_double->get_auxr_batch_data();
+}
+
+template <>
+std::complex<float>* FFT_Bundle::get_auxg_batch_data() const
+{
+    return nullptr;
+}
+template <>
+std::complex<double>* FFT_Bundle::get_auxg_batch_data() const
+{
+    return fft_double->get_auxg_batch_data();
+}
+
+template <>
+void FFT_Bundle::fftzfor_batch(std::complex<float>* in, std::complex<float>* out) const
+{
+    ModuleBase::WARNING_QUIT("FFT_Bundle", "batched fft is not supported for the float type");
+}
+template <>
+void FFT_Bundle::fftzfor_batch(std::complex<double>* in, std::complex<double>* out) const
+{
+    fft_double->fftzfor_batch(in, out);
+}
+
+template <>
+void FFT_Bundle::fftzbac_batch(std::complex<float>* in, std::complex<float>* out) const
+{
+    ModuleBase::WARNING_QUIT("FFT_Bundle", "batched fft is not supported for the float type");
+}
+template <>
+void FFT_Bundle::fftzbac_batch(std::complex<double>* in, std::complex<double>* out) const
+{
+    fft_double->fftzbac_batch(in, out);
+}
+
+template <>
+void FFT_Bundle::fftxyfor_batch(std::complex<float>* in, std::complex<float>* out) const
+{
+    ModuleBase::WARNING_QUIT("FFT_Bundle", "batched fft is not supported for the float type");
+}
+template <>
+void FFT_Bundle::fftxyfor_batch(std::complex<double>* in, std::complex<double>* out) const
+{
+    fft_double->fftxyfor_batch(in, out);
+}
+
+template <>
+void FFT_Bundle::fftxybac_batch(std::complex<float>* in, std::complex<float>* out) const
+{
+    ModuleBase::WARNING_QUIT("FFT_Bundle", "batched fft is not supported for the float type");
+}
+template <>
+void FFT_Bundle::fftxybac_batch(std::complex<double>* in, std::complex<double>* out) const
+{
+    fft_double->fftxybac_batch(in, out);
+}
+
+// the pipelined transform is only implemented for double type
+template <>
+int FFT_Bundle::get_pipeline_nchunk<float>() const
+{
+    return 1;
+}
+template <>
+int FFT_Bundle::get_pipeline_nchunk<double>() const
+{
+    return (fft_double == nullptr) ? 1 : fft_double->get_pipeline_nchunk();
+}
+
+template <>
+std::complex<float>* FFT_Bundle::get_auxt_data() const
+{
+    return nullptr;
+}
+template <>
+std::complex<double>* FFT_Bundle::get_auxt_data() const
+{
+    return fft_double->get_auxt_data();
+}
+
+template <>
+void FFT_Bundle::fftzfor_chunk(std::complex<float>* in, std::complex<float>* out, const int nstick) const
+{
+    ModuleBase::WARNING_QUIT("FFT_Bundle", "pipelined fft is not supported for the float type");
+}
+template <>
+void FFT_Bundle::fftzfor_chunk(std::complex<double>* in, std::complex<double>* out, const int nstick) const
+{
+    fft_double->fftzfor_chunk(in, out, nstick);
+}
+
+template <>
+void FFT_Bundle::fftzbac_chunk(std::complex<float>* in, std::complex<float>* out, const int nstick) const
+{
+    ModuleBase::WARNING_QUIT("FFT_Bundle", "pipelined fft is not supported for the float type");
+}
+template <>
+void FFT_Bundle::fftzbac_chunk(std::complex<double>* in, std::complex<double>* out, const int nstick) const
+{
+    fft_double->fftzbac_chunk(in, out, nstick);
+}
+
 // access the real space data
 template <>
 float* FFT_Bundle::get_rspace_data() const
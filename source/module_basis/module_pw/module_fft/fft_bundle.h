@@ -68,13 +68,61 @@ class FFT_Bundle
      * @param fft_mode_in  fft mode.
      *
      * the function will initialize the fft mode.
+     * fft_mode_in % 4 is the fftw planner mode, and fft_mode_in >= 4
+     * turns on the pipelined transpose between the z-FFT and the xy-FFT.
      */
 
     void initfftmode(int fft_mode_in)
     {
-        this->fft_mode = fft_mode_in;
+        this->fft_mode = fft_mode_in % 4;
+        // the sticks are split into 4 chunks in the pipelined transform
+        this->pipeline_nchunk = (fft_mode_in >= 4) ? 4 : 1;
     }
 
+    /**
+     * @brief Initialize the number of bands in the batched fft.
+     * @param fft_batch_in  number of bands transformed together.
+     *
+     * the batched plans are created in setupFFT() if fft_batch_in > 1,
+     * it is only supported by the double precision cpu fft.
+     */
+    void initfftbatch(int fft_batch_in)
+    {
+        this->fft_batch = fft_batch_in;
+    }
+
+    /**
+     * @brief Get the number of bands in the batched fft.
+     * @return 1 if the batched fft is not available.
+     */
+    template <typename FPTYPE>
+    int get_fft_batch() const;
+    /**
+     * @brief Get the distance between two bands in the auxiliary data of the batched fft.
+     */
+    template <typename FPTYPE>
+    int get_batch_stride() const;
+    /**
+     * @brief Get the auxr and auxg data of the batched fft.
+     * @return std::complex<FPTYPE>*  data of get_fft_batch() bands.
+     */
+    template <typename FPTYPE>
+    std::complex<FPTYPE>* get_auxr_batch_data() const;
+    template <typename FPTYPE>
+    std::complex<FPTYPE>* get_auxg_batch_data() const;
+
+    /**
+     * @brief Get the number of stick chunks in the pipelined transform.
+     * @return 1 if the pipelined transform is not available.
+     */
+    template <typename FPTYPE>
+    int get_pipeline_nchunk() const;
+    /**
+     * @brief Get the buffer of the pipelined transpose.
+     */
+    template <typename FPTYPE>
+    std::complex<FPTYPE>* get_auxt_data() const;
+
     void setupFFT();
 
     void clearFFT();
@@ -188,6 +236,34 @@ class FFT_Bundle
     template <typename FPTYPE>
     void fftxyc2r(std::complex<FPTYPE>* in, FPTYPE* out) const;
 
+    /**
+     * @brief Batched fft of get_fft_batch() bands.
+     * @param in  input data.
+     * @param out  output data.
+     *
+     * the functions do the same as fftzfor, fftzbac, fftxyfor and fftxybac
+     * for all bands in the auxiliary data of the batched fft.
+     */
+    template <typename FPTYPE>
+    void fftzfor_batch(std::complex<FPTYPE>* in, std::complex<FPTYPE>* out) const;
+    template <typename FPTYPE>
+    void fftzbac_batch(std::complex<FPTYPE>* in, std::complex<FPTYPE>* out) const;
+    template <typename FPTYPE>
+    void fftxyfor_batch(std::complex<FPTYPE>* in, std::complex<FPTYPE>* out) const;
+    template <typename FPTYPE>
+    void fftxybac_batch(std::complex<FPTYPE>* in, std::complex<FPTYPE>* out) const;
+
+    /**
+     * @brief Fft in z direction of one chunk of sticks in the pipelined transform.
+     * @param in  input data of the first stick in the chunk.
+     * @param out  output data.
+     * @param nstick  number of sticks in the chunk.
+     */
+    template <typename FPTYPE>
+    void fftzfor_chunk(std::complex<FPTYPE>* in, std::complex<FPTYPE>* out, const int nstick) const;
+    template <typename FPTYPE>
+    void fftzbac_chunk(std::complex<FPTYPE>* in, std::complex<FPTYPE>* out, const int nstick) const;
+
     template <typename FPTYPE, typename Device>
     void fft3D_forward(const Device* ctx, std::complex<FPTYPE>* in, std::complex<FPTYPE>* out) const;
     template <typename FPTYPE, typename Device>
@@ -195,6 +271,8 @@ class FFT_Bundle
 
   private:
     int fft_mode = 0;
+    int fft_batch = 1;
+    int pipeline_nchunk = 1;
     bool float_flag = false;
     bool float_define = true;
     bool double_flag = false;
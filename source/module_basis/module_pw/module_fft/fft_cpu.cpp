@@ -39,6 +39,107 @@ void FFT_CPU<FPTYPE>::initfft(int nx_in,
     const int nsz = this->nz * this->ns;
     this->maxgrids = (nsz > nrxx) ? nsz : nrxx;
 }
+/**
+ * @brief create the plans of the batched fft
+ *
+ * The data of fft_batch bands are stored in z_auxg_batch and z_auxr_batch
+ * with distance maxgrids, the band index is added as an extra howmany
+ * dimension of the fftw guru interface, so that the 1D FFTs of all bands
+ * are done in one plan instead of one plan execution for each band.
+ */
+template <>
+void FFT_CPU<double>::setup_batch_plans(const unsigned int flag)
+{
+    const int nb = this->fft_batch;
+    z_auxg_batch = (std::complex<double>*)fftw_malloc(sizeof(fftw_complex) * this->maxgrids * nb);
+    z_auxr_batch = (std::complex<double>*)fftw_malloc(sizeof(fftw_complex) * this->maxgrids * nb);
+    fftw_complex* auxg = (fftw_complex*)z_auxg_batch;
+    fftw_complex* auxr = (fftw_complex*)z_auxr_batch;
+
+    const int npy = this->nplane * this->ny;
+    const fftw_iodim band = {nb, this->maxgrids, this->maxgrids};
+
+    //---------------------------------------------------------
+    //                              1 D - Z
+    //---------------------------------------------------------
+    const fftw_iodim dimz = {this->nz, 1, 1};
+    const fftw_iodim howmanyz[2] = {{this->ns, this->nz, this->nz}, band};
+    this->planzfor_batch = fftw_plan_guru_dft(1, &dimz, 2, howmanyz, auxg, auxg, FFTW_FORWARD, flag);
+    this->planzbac_batch = fftw_plan_guru_dft(1, &dimz, 2, howmanyz, auxg, auxg, FFTW_BACKWARD, flag);
+
+    //---------------------------------------------------------
+    //                              2 D - XY
+    //---------------------------------------------------------
+    const fftw_iodim dimx = {this->nx, npy, npy};
+    const fftw_iodim dimy = {this->ny, this->nplane, this->nplane};
+    if (this->xprime)
+    {
+        const fftw_iodim howmanyx[2] = {{npy, 1, 1}, band};
+        this->planxfor1_batch = fftw_plan_guru_dft(1, &dimx, 2, howmanyx, auxr, auxr, FFTW_FORWARD, flag);
+        this->planxbac1_batch = fftw_plan_guru_dft(1, &dimx, 2, howmanyx, auxr, auxr, FFTW_BACKWARD, flag);
+        // y-fft is only needed for x in [0, lixy] and [rixy, nx)
+        const fftw_iodim howmanyy1[3] = {{this->nplane, 1, 1}, {this->lixy + 1, npy, npy}, band};
+        this->planyfor1_batch = fftw_plan_guru_dft(1, &dimy, 3, howmanyy1, auxr, auxr, FFTW_FORWARD, flag);
+        this->planybac1_batch = fftw_plan_guru_dft(1, &dimy, 3, howmanyy1, auxr, auxr, FFTW_BACKWARD, flag);
+        if (this->nx > this->rixy)
+        {
+            const fftw_iodim howmanyy2[3] = {{this->nplane, 1, 1}, {this->nx - this->rixy, npy, npy}, band};
+            this->planyfor2_batch = fftw_plan_guru_dft(1, &dimy, 3, howmanyy2, auxr, auxr, FFTW_FORWARD, flag);
+            this->planybac2_batch = fftw_plan_guru_dft(1, &dimy, 3, howmanyy2, auxr, auxr, FFTW_BACKWARD, flag);
+        }
+    }
+    else
+    {
+        const fftw_iodim howmanyy[3] = {{this->nplane, 1, 1}, {this->nx, npy, npy}, band};
+        this->planyfor1_batch = fftw_plan_guru_dft(1, &dimy, 3, howmanyy, auxr, auxr, FFTW_FORWARD, flag);
+        this->planybac1_batch = fftw_plan_guru_dft(1, &dimy, 3, howmanyy, auxr, auxr, FFTW_BACKWARD, flag);
+        // x-fft is only needed for y in [0, lixy] and [rixy, ny)
+        const fftw_iodim howmanyx1[2] = {{this->nplane * (this->lixy + 1), 1, 1}, band};
+        this->planxfor1_batch = fftw_plan_guru_dft(1, &dimx, 2, howmanyx1, auxr, auxr, FFTW_FORWARD, flag);
+        this->planxbac1_batch = fftw_plan_guru_dft(1, &dimx, 2, howmanyx1, auxr, auxr, FFTW_BACKWARD, flag);
+        if (this->ny > this->rixy)
+        {
+            const fftw_iodim howmanyx2[2] = {{this->nplane * (this->ny - this->rixy), 1, 1}, band};
+            this->planxfor2_batch = fftw_plan_guru_dft(1, &dimx, 2, howmanyx2, auxr, auxr, FFTW_FORWARD, flag);
+            this->planxbac2_batch = fftw_plan_guru_dft(1, &dimx, 2, howmanyx2, auxr, auxr, FFTW_BACKWARD, flag);
+        }
+    }
+}
+
+/**
+ * @brief create the plans of the z-FFT on one chunk of sticks
+ *
+ * In the pipelined transform, the ns sticks are split into nchunk chunks of
+ * chunk_size = ceil(ns/nchunk) sticks, [k*chunk_size, (k+1)*chunk_size),
+ * and the last non-empty chunk may hold only last_size = ns % chunk_size sticks.
+ * The plans are executed with fftw_execute_dft on the first stick of each chunk.
+ */
+template <>
+void FFT_CPU<double>::setup_chunk_plans(const unsigned int flag)
+{
+    this->chunk_size = (this->ns + this->nchunk - 1) / this->nchunk;
+    this->last_size = (this->chunk_size > 0) ? this->ns % this->chunk_size : 0;
+    if (this->z_auxt == nullptr)
+    {
+        this->z_auxt = (std::complex<double>*)fftw_malloc(sizeof(fftw_complex) * this->maxgrids);
+    }
+    fftw_complex* auxg = (fftw_complex*)z_auxg;
+    if (this->chunk_size > 0)
+    {
+        this->planzfor_chunk = fftw_plan_many_dft(1, &this->nz, this->chunk_size, auxg, &this->nz, 1, this->nz,
+                                                  auxg, &this->nz, 1, this->nz, FFTW_FORWARD, flag);
+        this->planzbac_chunk = fftw_plan_many_dft(1, &this->nz, this->chunk_size, auxg, &this->nz, 1, this->nz,
+                                                  auxg, &this->nz, 1, this->nz, FFTW_BACKWARD, flag);
+    }
+    if (this->last_size > 0)
+    {
+        this->planzfor_last = fftw_plan_many_dft(1, &this->nz, this->last_size, auxg, &this->nz, 1, this->nz,
+                                                 auxg, &this->nz, 1, this->nz, FFTW_FORWARD, flag);
+        this->planzbac_last = fftw_plan_many_dft(1, &this->nz, this->last_size, auxg, &this->nz, 1, this->nz,
+                                                 auxg, &this->nz, 1, this->nz, FFTW_BACKWARD, flag);
+    }
+}
+
 template <>
 void FFT_CPU<double>::setupFFT()
 {
@@ -294,6 +395,14 @@ void FFT_CPU<double>::setupFFT()
                                                 flag);
         }
     }
+    if (this->fft_batch > 1 && !this->gamma_only)
+    {
+        this->setup_batch_plans(flag);
+    }
+    if (this->nchunk > 1 && this->nproc > 1)
+    {
+        this->setup_chunk_plans(flag);
+    }
     return;
 }
 
@@ -322,6 +431,20 @@ void FFT_CPU<double>::cleanFFT()
     clearfft(planxc2r);
     clearfft(planyr2c);
     clearfft(planyc2r);
+    clearfft(planzfor_batch);
+    clearfft(planzbac_batch);
+    clearfft(planxfor1_batch);
+    clearfft(planxbac1_batch);
+    clearfft(planxfor2_batch);
+    clearfft(planxbac2_batch);
+    clearfft(planyfor1_batch);
+    clearfft(planybac1_batch);
+    clearfft(planyfor2_batch);
+    clearfft(planybac2_batch);
+    clearfft(planzfor_chunk);
+    clearfft(planzbac_chunk);
+    clearfft(planzfor_last);
+    clearfft(planzbac_last);
 }
 
 template <>
@@ -338,6 +461,21 @@ void FFT_CPU<double>::clear()
         fftw_free(z_auxr);
         z_auxr = nullptr;
     }
+    if (z_auxg_batch != nullptr)
+    {
+        fftw_free(z_auxg_batch);
+        z_auxg_batch = nullptr;
+    }
+    if (z_auxr_batch != nullptr)
+    {
+        fftw_free(z_auxr_batch);
+        z_auxr_batch = nullptr;
+    }
+    if (z_auxt != nullptr)
+    {
+        fftw_free(z_auxt);
+        z_auxt = nullptr;
+    }
     d_rspace = nullptr;
 }
 
@@ -451,12 +589,100 @@ void FFT_CPU<double>::fftxyc2r(std::complex<double> *in,double *out) const
     }
 }
 
+template <>
+void FFT_CPU<double>::fftzfor_batch(std::complex<double>* in, std::complex<double>* out) const
+{
+    fftw_execute_dft(this->planzfor_batch, (fftw_complex*)in, (fftw_complex*)out);
+}
+
+template <>
+void FFT_CPU<double>::fftzbac_batch(std::complex<double>* in, std::complex<double>* out) const
+{
+    fftw_execute_dft(this->planzbac_batch, (fftw_complex*)in, (fftw_complex*)out);
+}
+
+template <>
+void FFT_CPU<double>::fftzfor_chunk(std::complex<double>* in, std::complex<double>* out, const int nstick) const
+{
+    if (nstick == 0)
+    {
+        return;
+    }
+    const fftw_plan plan = (nstick == this->chunk_size) ? this->planzfor_chunk : this->planzfor_last;
+    fftw_execute_dft(plan, (fftw_complex*)in, (fftw_complex*)out);
+}
+
+template <>
+void FFT_CPU<double>::fftzbac_chunk(std::complex<double>* in, std::complex<double>* out, const int nstick) const
+{
+    if (nstick == 0)
+    {
+        return;
+    }
+    const fftw_plan plan = (nstick == this->chunk_size) ? this->planzbac_chunk : this->planzbac_last;
+    fftw_execute_dft(plan, (fftw_complex*)in, (fftw_complex*)out);
+}
+
+template <>
+void FFT_CPU<double>::fftxyfor_batch(std::complex<double>* in, std::complex<double>* out) const
+{
+    int npy = this->nplane * this->ny;
+    if (this->xprime)
+    {
+        fftw_execute_dft(this->planxfor1_batch, (fftw_complex*)in, (fftw_complex*)out);
+        fftw_execute_dft(this->planyfor1_batch, (fftw_complex*)in, (fftw_complex*)out);
+        if (this->planyfor2_batch)
+        {
+            fftw_execute_dft(this->planyfor2_batch, (fftw_complex*)&in[rixy * npy], (fftw_complex*)&out[rixy * npy]);
+        }
+    }
+    else
+    {
+        fftw_execute_dft(this->planyfor1_batch, (fftw_complex*)in, (fftw_complex*)out);
+        fftw_execute_dft(this->planxfor1_batch, (fftw_complex*)in, (fftw_complex*)out);
+        if (this->planxfor2_batch)
+        {
+            fftw_execute_dft(this->planxfor2_batch, (fftw_complex*)&in[rixy * nplane], (fftw_complex*)&out[rixy * nplane]);
+        }
+    }
+}
+
+template <>
+void FFT_CPU<double>::fftxybac_batch(std::complex<double>* in, std::complex<double>* out) const
+{
+    int npy = this->nplane * this->ny;
+    if (this->xprime)
+    {
+        fftw_execute_dft(this->planybac1_batch, (fftw_complex*)in, (fftw_complex*)out);
+        if (this->planybac2_batch)
+        {
+            fftw_execute_dft(this->planybac2_batch, (fftw_complex*)&in[rixy * npy], (fftw_complex*)&out[rixy * npy]);
+        }
+        fftw_execute_dft(this->planxbac1_batch, (fftw_complex*)in, (fftw_complex*)out);
+    }
+    else
+    {
+        fftw_execute_dft(this->planxbac1_batch, (fftw_complex*)in, (fftw_complex*)out);
+        if (this->planxbac2_batch)
+        {
+            fftw_execute_dft(this->planxbac2_batch, (fftw_complex*)&in[rixy * nplane], (fftw_complex*)&out[rixy * nplane]);
+        }
+        fftw_execute_dft(this->planybac1_batch, (fftw_complex*)in, (fftw_complex*)out);
+    }
+}
+
 template <> double* 
 FFT_CPU<double>::get_rspace_data() const {return d_rspace;}
 template <> std::complex<double>* 
 FFT_CPU<double>::get_auxr_data()   const {return z_auxr;}
 template <> std::complex<double>* 
 FFT_CPU<double>::get_auxg_data()   const {return z_auxg;}
+template <> std::complex<double>* 
+FFT_CPU<double>::get_auxr_batch_data() const {return z_auxr_batch;}
+template <> std::complex<double>* 
+FFT_CPU<double>::get_auxg_batch_data() const {return z_auxg_batch;}
+template <> std::complex<double>* 
+FFT_CPU<double>::get_auxt_data() const {return z_auxt;}
 
 template FFT_CPU<float>::FFT_CPU();
 template FFT_CPU<float>::~FFT_CPU();
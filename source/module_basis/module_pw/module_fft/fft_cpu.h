@@ -11,6 +11,9 @@ class FFT_CPU : public FFT_BASE<FPTYPE>
     public:
     FFT_CPU(){};
     FFT_CPU(const int fft_mode_in):fft_mode(fft_mode_in){};
+    FFT_CPU(const int fft_mode_in, const int fft_batch_in):fft_mode(fft_mode_in),fft_batch(fft_batch_in){};
+    FFT_CPU(const int fft_mode_in, const int fft_batch_in, const int nchunk_in)
+        :fft_mode(fft_mode_in),fft_batch(fft_batch_in),nchunk(nchunk_in){};
     ~FFT_CPU(){}; 
 
     /**
@@ -98,6 +101,72 @@ class FFT_CPU : public FFT_BASE<FPTYPE>
     __attribute__((weak)) 
     void fftxyc2r(std::complex<FPTYPE>* in, 
                   FPTYPE* out) const override;
+
+    int get_fft_batch() const override
+    {
+        return this->gamma_only ? 1 : this->fft_batch;
+    }
+
+    int get_batch_stride() const override
+    {
+        return this->maxgrids;
+    }
+
+    __attribute__((weak)) 
+    std::complex<FPTYPE>* get_auxr_batch_data() const override;
+
+    __attribute__((weak)) 
+    std::complex<FPTYPE>* get_auxg_batch_data() const override;
+
+    /**
+     * @brief Batched FFT of fft_batch bands
+     * @param in  input data
+     * @param out  output data
+     *
+     * The function details can be found in FFT_BASE.
+     * The batched plans are only created for double type without gamma_only.
+     */
+    __attribute__((weak)) 
+    void fftzfor_batch(std::complex<FPTYPE>* in, 
+                       std::complex<FPTYPE>* out) const override;
+
+    __attribute__((weak)) 
+    void fftzbac_batch(std::complex<FPTYPE>* in, 
+                       std::complex<FPTYPE>* out) const override;
+
+    __attribute__((weak)) 
+    void fftxyfor_batch(std::complex<FPTYPE>* in, 
+                        std::complex<FPTYPE>* out) const override;
+
+    __attribute__((weak)) 
+    void fftxybac_batch(std::complex<FPTYPE>* in, 
+                        std::complex<FPTYPE>* out) const override;
+
+    int get_pipeline_nchunk() const override
+    {
+        return (this->nproc > 1) ? this->nchunk : 1;
+    }
+
+    __attribute__((weak)) 
+    std::complex<FPTYPE>* get_auxt_data() const override;
+
+    /**
+     * @brief FFT in z direction of one chunk of sticks in the pipelined transform
+     * @param in  input data
+     * @param out  output data
+     * @param nstick  number of sticks, ceil(ns/nchunk) or the remainder
+     *
+     * The chunk plans are only created for double type.
+     */
+    __attribute__((weak)) 
+    void fftzfor_chunk(std::complex<FPTYPE>* in, 
+                       std::complex<FPTYPE>* out,
+                       const int nstick) const override;
+
+    __attribute__((weak)) 
+    void fftzbac_chunk(std::complex<FPTYPE>* in, 
+                       std::complex<FPTYPE>* out,
+                       const int nstick) const override;
     private:
         void clearfft(fftw_plan& plan);
         void clearfft(fftwf_plan& plan);
@@ -115,6 +184,28 @@ class FFT_CPU : public FFT_BASE<FPTYPE>
         fftw_plan planyr2c  = NULL;
         fftw_plan planyc2r  = NULL;
 
+        // plans of the batched fft, see setup_batch_plans()
+        void setup_batch_plans(const unsigned int flag);
+        fftw_plan planzfor_batch  = NULL;
+        fftw_plan planzbac_batch  = NULL;
+        fftw_plan planxfor1_batch = NULL;
+        fftw_plan planxbac1_batch = NULL;
+        fftw_plan planxfor2_batch = NULL;
+        fftw_plan planxbac2_batch = NULL;
+        fftw_plan planyfor1_batch = NULL;
+        fftw_plan planybac1_batch = NULL;
+        fftw_plan planyfor2_batch = NULL;
+        fftw_plan planybac2_batch = NULL;
+
+        // plans of the z-FFT on one chunk of sticks, see setup_chunk_plans()
+        void setup_chunk_plans(const unsigned int flag);
+        fftw_plan planzfor_chunk = NULL; // chunk_size sticks
+        fftw_plan planzbac_chunk = NULL;
+        fftw_plan planzfor_last  = NULL; // the remaining sticks of the last non-empty chunk
+        fftw_plan planzbac_last  = NULL;
+        int chunk_size = 0;
+        int last_size = 0;
+
         fftwf_plan planfzfor = NULL;
         fftwf_plan planfzbac = NULL;
         fftwf_plan planfxfor1= NULL;
@@ -133,6 +224,10 @@ class FFT_CPU : public FFT_BASE<FPTYPE>
         std::complex<double>*z_auxg = nullptr;
         std::complex<double>*z_auxr = nullptr; // fft space
 
+        std::complex<double>*z_auxg_batch = nullptr; // [fft_batch * maxgrids]
+        std::complex<double>*z_auxr_batch = nullptr; // [fft_batch * maxgrids]
+        std::complex<double>*z_auxt = nullptr; // buffer of the pipelined transpose, [maxgrids]
+
         float* s_rspace = nullptr;  // real number space for r, [nplane * nx *ny]
         double* d_rspace = nullptr; // real number space for r, [nplane * nx *ny]
         int fftnx=0;
@@ -164,6 +259,16 @@ class FFT_CPU : public FFT_BASE<FPTYPE>
          * @brief fft_mode: fftw mode 0: estimate, 1: measure, 2: patient, 3: exhaustive
          */
         int fft_mode = 0; 
+        /**
+         * @brief fft_batch: number of bands transformed together by the batched fft,
+         * the batched plans are not created if it is not larger than 1
+         */
+        int fft_batch = 1;
+        /**
+         * @brief nchunk: number of stick chunks in the pipelined transform,
+         * the chunk plans are not created if it is not larger than 1
+         */
+        int nchunk = 1;
 };
 }
 #endif // FFT_CPU_H
\ No newline at end of file
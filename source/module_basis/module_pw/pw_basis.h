@@ -7,6 +7,7 @@
 #include "module_base/vector3.h"
 #include <complex>
 #include "module_fft/fft_bundle.h"
+#include <algorithm>
 #include <cstring>
 #ifdef __MPI
 #include "mpi.h"
@@ -276,7 +277,32 @@ public:
     template <typename T>
     void gathers_scatterp(std::complex<T>* in, std::complex<T>* out) const;
 
+    // batched gatherp_scatters for nbatch bands with distance stride, one MPI_Alltoallv for all bands
+    template <typename T>
+    void gatherp_scatters_batch(std::complex<T>* in, std::complex<T>* out, const int nbatch, const int stride) const;
+
+    // batched gathers_scatterp for nbatch bands with distance stride, one MPI_Alltoallv for all bands
+    template <typename T>
+    void gathers_scatterp_batch(std::complex<T>* in, std::complex<T>* out, const int nbatch, const int stride) const;
+
+    // gatherp_scatters followed by the forward z-FFT, pipelined by chunks of sticks if fft_mode >= 4
+    template <typename T>
+    void gatherp_scatters_fftzfor(std::complex<T>* in, std::complex<T>* out) const;
+
+    // backward z-FFT followed by gathers_scatterp, pipelined by chunks of sticks if fft_mode >= 4
+    template <typename T>
+    void fftzbac_gathers_scatterp(std::complex<T>* in, std::complex<T>* out) const;
+
   public:
+    // the range [is_beg, is_end) of the ichunk-th chunk when ns sticks are split into nchunk chunks,
+    // it is the same partition as the one of the chunk plans in FFT_CPU
+    static void get_stick_chunk(const int ns, const int nchunk, const int ichunk, int& is_beg, int& is_end)
+    {
+        const int chunk_size = (ns + nchunk - 1) / nchunk;
+        is_beg = std::min(ichunk * chunk_size, ns);
+        is_end = std::min(is_beg + chunk_size, ns);
+    }
+
     //get fftixy2is;
     void getfftixy2is(int * fftixy2is) const;
 
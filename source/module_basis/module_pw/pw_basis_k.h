@@ -176,6 +176,54 @@ public:
                        const bool add = false,
                        const FPTYPE factor = 1.0) const; // in:(nz, ns)  ; out(nplane,nx*ny)
 
+    // transform fft_bundle.get_fft_batch() bands with the batched fft, used by real_to_recip_batch and
+    // recip_to_real_batch
+    template <typename FPTYPE>
+    void real2recip_batch(const std::complex<FPTYPE>* in,
+                          std::complex<FPTYPE>* out,
+                          const int ldin,
+                          const int ldout,
+                          const int ik,
+                          const bool add = false,
+                          const FPTYPE factor = 1.0) const; // in:(nbatch,ldin) ; out(nbatch,ldout)
+    template <typename FPTYPE>
+    void recip2real_batch(const std::complex<FPTYPE>* in,
+                          std::complex<FPTYPE>* out,
+                          const int ldin,
+                          const int ldout,
+                          const int ik,
+                          const bool add = false,
+                          const FPTYPE factor = 1.0) const; // in:(nbatch,ldin) ; out(nbatch,ldout)
+
+    /**
+     * @brief transform nbatch bands between real and reciprocal spaces
+     * @param in: the ib-th band starts at in[ib * ldin]
+     * @param out: the ib-th band starts at out[ib * ldout]
+     * @details The bands are transformed in groups of fft_bundle.get_fft_batch() with batched fftw plans
+     *          and one MPI_Alltoallv for each group, the remaining bands are transformed one by one.
+     *          It gives the same results as calling real_to_recip/recip_to_real for each band.
+     */
+    template <typename FPTYPE, typename Device>
+    void real_to_recip_batch(const Device* ctx,
+                             const std::complex<FPTYPE>* in,
+                             std::complex<FPTYPE>* out,
+                             const int nbatch,
+                             const int ldin,
+                             const int ldout,
+                             const int ik,
+                             const bool add = false,
+                             const FPTYPE factor = 1.0) const;
+    template <typename FPTYPE, typename Device>
+    void recip_to_real_batch(const Device* ctx,
+                             const std::complex<FPTYPE>* in,
+                             std::complex<FPTYPE>* out,
+                             const int nbatch,
+                             const int ldin,
+                             const int ldout,
+                             const int ik,
+                             const bool add = false,
+                             const FPTYPE factor = 1.0) const;
+
   public:
     //operator:
     //get (G+K)^2:
@@ -2,6 +2,7 @@
 #include "module_base/global_function.h"
 #include "module_base/timer.h"
 #include "typeinfo"
+#include <vector>
 namespace ModulePW
 {
 /**
@@ -181,4 +182,414 @@ void PW_Basis::gathers_scatterp(std::complex<T>* in, std::complex<T>* out) const
 
 
 
+/**
+ * @brief gather planes and scatter sticks of nbatch bands
+ * @param in: (nbatch,stride), the first nplane*fftnxy elements of each band are (nplane,fftny,fftnx)
+ * @param out: (nbatch,stride), the first nz*nst elements of each band are (nz,nst)
+ * @note in and out should be in different places
+ * @note in[] will be changed
+ * @note the data of all bands sent to one processor are packed together,
+ *       so that only one MPI_Alltoallv is needed for all bands
+ */
+template <typename T>
+void PW_Basis::gatherp_scatters_batch(std::complex<T>* in, std::complex<T>* out, const int nbatch, const int stride) const
+{
+    if(this->poolnproc == 1)
+    {
+        for(int ib = 0 ; ib < nbatch ; ++ib)
+        {
+            this->gatherp_scatters(&in[ib * stride], &out[ib * stride]);
+        }
+        return;
+    }
+    ModuleBase::timer::tick(this->classname, "gatherp_scatters");
+#ifdef __MPI
+    std::vector<int> numr_b(this->poolnproc), startr_b(this->poolnproc);
+    std::vector<int> numg_b(this->poolnproc), startg_b(this->poolnproc);
+    // the first stick sent to each processor
+    std::vector<int> startst(this->poolnproc, 0);
+    for (int ip = 0; ip < this->poolnproc; ++ip)
+    {
+        numr_b[ip] = this->numr[ip] * nbatch;
+        startr_b[ip] = this->startr[ip] * nbatch;
+        numg_b[ip] = this->numg[ip] * nbatch;
+        startg_b[ip] = this->startg[ip] * nbatch;
+        if (ip > 0)
+        {
+            startst[ip] = startst[ip - 1] + this->nst_per[ip - 1];
+        }
+    }
+
+    //change (nplane fftnxy) of each band to (nbatch,nplane,nst_per[ip]) for each ip
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
+    for (int ip = 0; ip < this->poolnproc; ++ip)
+    {
+        for (int ib = 0; ib < nbatch; ++ib)
+        {
+            std::complex<T> *outp0 = &out[startr_b[ip] + ib * this->numr[ip]];
+            const std::complex<T> *inp0 = &in[ib * stride];
+            for (int is = 0; is < this->nst_per[ip]; ++is)
+            {
+                int ixy = this->istot2ixy[startst[ip] + is];
+                std::complex<T> *outp = &outp0[is * nplane];
+                const std::complex<T> *inp = &inp0[ixy * nplane];
+                for (int iz = 0; iz < nplane; ++iz)
+                {
+                    outp[iz] = inp[iz];
+                }
+            }
+        }
+    }
+
+    //exchange data
+    //(nbatch,nplane,nst_per[ip]) to (nbatch,numz[ip],nst) for each ip
+    if(typeid(T) == typeid(double))
+        MPI_Alltoallv(out, numr_b.data(), startr_b.data(), MPI_DOUBLE_COMPLEX, in, numg_b.data(), startg_b.data(), MPI_DOUBLE_COMPLEX, this->pool_world);
+    else if(typeid(T) == typeid(float))
+        MPI_Alltoallv(out, numr_b.data(), startr_b.data(), MPI_COMPLEX, in, numg_b.data(), startg_b.data(), MPI_COMPLEX, this->pool_world);
+
+    // change (nbatch,numz[ip],nst) to (nz,nst) of each band
+#ifdef _OPENMP
+#pragma omp parallel for collapse(3)
+#endif
+    for (int ib = 0; ib < nbatch; ++ib)
+    {
+        for (int ip = 0; ip < this->poolnproc; ++ip)
+        {
+            for (int is = 0; is < this->nst; ++is)
+            {
+                int nzip = this->numz[ip];
+                std::complex<T> *outp = &out[ib * stride + startz[ip] + is * nz];
+                const std::complex<T> *inp = &in[startg_b[ip] + ib * this->numg[ip] + is * nzip];
+                for (int izip = 0; izip < nzip; ++izip)
+                {
+                    outp[izip] = inp[izip];
+                }
+            }
+        }
+    }
+#endif
+    ModuleBase::timer::tick(this->classname, "gatherp_scatters");
+    return;
+}
+
+/**
+ * @brief gather sticks and scatter planes of nbatch bands
+ * @param in: (nbatch,stride), the first nz*nst elements of each band are (nz,nst)
+ * @param out: (nbatch,stride), the first nplane*fftnxy elements of each band are (nplane,fftny,fftnx)
+ * @note in and out should be in different places
+ * @note in[] will be changed
+ * @note the data of all bands sent to one processor are packed together,
+ *       so that only one MPI_Alltoallv is needed for all bands
+ */
+template <typename T>
+void PW_Basis::gathers_scatterp_batch(std::complex<T>* in, std::complex<T>* out, const int nbatch, const int stride) const
+{
+    if(this->poolnproc == 1)
+    {
+        for(int ib = 0 ; ib < nbatch ; ++ib)
+        {
+            this->gathers_scatterp(&in[ib * stride], &out[ib * stride]);
+        }
+        return;
+    }
+    ModuleBase::timer::tick(this->classname, "gathers_scatterp");
+#ifdef __MPI
+    std::vector<int> numr_b(this->poolnproc), startr_b(this->poolnproc);
+    std::vector<int> numg_b(this->poolnproc), startg_b(this->poolnproc);
+    // the first stick received from each processor
+    std::vector<int> startst(this->poolnproc, 0);
+    for (int ip = 0; ip < this->poolnproc; ++ip)
+    {
+        numr_b[ip] = this->numr[ip] * nbatch;
+        startr_b[ip] = this->startr[ip] * nbatch;
+        numg_b[ip] = this->numg[ip] * nbatch;
+        startg_b[ip] = this->startg[ip] * nbatch;
+        if (ip > 0)
+        {
+            startst[ip] = startst[ip - 1] + this->nst_per[ip - 1];
+        }
+    }
+
+    // change (nz,nst) of each band to (nbatch,numz[ip],nst) for each ip
+#ifdef _OPENMP
+#pragma omp parallel for collapse(3)
+#endif
+    for (int ip = 0; ip < this->poolnproc; ++ip)
+    {
+        for (int ib = 0; ib < nbatch; ++ib)
+        {
+            for (int is = 0; is < this->nst; ++is)
+            {
+                int nzip = this->numz[ip];
+                std::complex<T> *outp = &out[startg_b[ip] + ib * this->numg[ip] + is * nzip];
+                const std::complex<T> *inp = &in[ib * stride + startz[ip] + is * nz];
+                for (int izip = 0; izip < nzip; ++izip)
+                {
+                    outp[izip] = inp[izip];
+                }
+            }
+        }
+    }
+
+    //exchange data
+    //(nbatch,numz[ip],nst) to (nbatch,nplane,nst_per[ip]) for each ip
+    if(typeid(T) == typeid(double))
+        MPI_Alltoallv(out, numg_b.data(), startg_b.data(), MPI_DOUBLE_COMPLEX, in, numr_b.data(), startr_b.data(), MPI_DOUBLE_COMPLEX, this->pool_world);
+    else if(typeid(T) == typeid(float))
+        MPI_Alltoallv(out, numg_b.data(), startg_b.data(), MPI_COMPLEX, in, numr_b.data(), startr_b.data(), MPI_COMPLEX, this->pool_world);
+
+    //change (nbatch,nplane,nst_per[ip]) for each ip to (nplane fftnxy) of each band
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
+    for (int ib = 0; ib < nbatch; ++ib)
+    {
+        for (int ir = 0; ir < this->nrxx; ++ir)
+        {
+            out[ib * stride + ir] = std::complex<T>(0, 0);
+        }
+    }
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
+    for (int ip = 0; ip < this->poolnproc; ++ip)
+    {
+        for (int ib = 0; ib < nbatch; ++ib)
+        {
+            std::complex<T> *outp0 = &out[ib * stride];
+            const std::complex<T> *inp0 = &in[startr_b[ip] + ib * this->numr[ip]];
+            for (int is = 0; is < this->nst_per[ip]; ++is)
+            {
+                int ixy = this->istot2ixy[startst[ip] + is];
+                std::complex<T> *outp = &outp0[ixy * nplane];
+                const std::complex<T> *inp = &inp0[is * nplane];
+                for (int iz = 0; iz < nplane; ++iz)
+                {
+                    outp[iz] = inp[iz];
+                }
+            }
+        }
+    }
+#endif
+    ModuleBase::timer::tick(this->classname, "gathers_scatterp");
+    return;
+}
+
+/**
+ * @brief gather planes and scatter sticks, then do the forward z-FFT
+ * @param in: (nplane,fftny,fftnx), auxr of fft_bundle
+ * @param out: (nz,nst), auxg of fft_bundle
+ * @note in[] will be changed
+ * @note it is the same as gatherp_scatters(in, out) followed by fftzfor(out, out).
+ *       In the pipelined mode (fft_mode >= 4), the sticks of each processor are split into
+ *       nchunk chunks, the transposes of all chunks are posted with MPI_Ialltoallv,
+ *       and the z-FFT of chunk k is done while chunks k+1, k+2, ... are in flight.
+ */
+template <typename T>
+void PW_Basis::gatherp_scatters_fftzfor(std::complex<T>* in, std::complex<T>* out) const
+{
+    const int nchunk = this->fft_bundle.get_pipeline_nchunk<T>();
+    if (this->poolnproc == 1 || nchunk <= 1)
+    {
+        this->gatherp_scatters(in, out);
+        this->fft_bundle.fftzfor(out, out);
+        return;
+    }
+#ifdef __MPI
+    ModuleBase::timer::tick(this->classname, "gatherp_scatters_fftzfor");
+    const MPI_Datatype mpi_type = (typeid(T) == typeid(double)) ? MPI_DOUBLE_COMPLEX : MPI_COMPLEX;
+    std::complex<T>* sendbuf = this->fft_bundle.get_auxt_data<T>();
+
+    ModuleBase::timer::tick(this->classname, "pipeline_pack");
+    //change (nplane fftnxy) to (nplane,nstot)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int istot = 0; istot < nstot; ++istot)
+    {
+        int ixy = this->istot2ixy[istot];
+        std::complex<T>* outp = &sendbuf[istot * nplane];
+        std::complex<T>* inp = &in[ixy * nplane];
+        for (int iz = 0; iz < nplane; ++iz)
+        {
+            outp[iz] = inp[iz];
+        }
+    }
+    ModuleBase::timer::tick(this->classname, "pipeline_pack");
+
+    // the counts of one chunk must be kept until its transpose is completed
+    std::vector<int> sendcount(nchunk * this->poolnproc), senddispl(nchunk * this->poolnproc);
+    std::vector<int> recvcount(nchunk * this->poolnproc), recvdispl(nchunk * this->poolnproc);
+    std::vector<MPI_Request> requests(nchunk);
+    for (int ichunk = 0; ichunk < nchunk; ++ichunk)
+    {
+        int is_beg = 0, is_end = 0;
+        this->get_stick_chunk(this->nst, nchunk, ichunk, is_beg, is_end);
+        for (int ip = 0; ip < this->poolnproc; ++ip)
+        {
+            int ipst_beg = 0, ipst_end = 0;
+            this->get_stick_chunk(this->nst_per[ip], nchunk, ichunk, ipst_beg, ipst_end);
+            const int i = ichunk * this->poolnproc + ip;
+            sendcount[i] = (ipst_end - ipst_beg) * nplane;
+            senddispl[i] = this->startr[ip] + ipst_beg * nplane;
+            recvcount[i] = (is_end - is_beg) * this->numz[ip];
+            recvdispl[i] = this->startg[ip] + is_beg * this->numz[ip];
+        }
+        // in[] is free after packing, it receives the data in (numz[ip],nst, poolnproc)
+        MPI_Ialltoallv(sendbuf, &sendcount[ichunk * poolnproc], &senddispl[ichunk * poolnproc], mpi_type,
+                       in, &recvcount[ichunk * poolnproc], &recvdispl[ichunk * poolnproc], mpi_type,
+                       this->pool_world, &requests[ichunk]);
+    }
+
+    for (int ichunk = 0; ichunk < nchunk; ++ichunk)
+    {
+        int is_beg = 0, is_end = 0;
+        this->get_stick_chunk(this->nst, nchunk, ichunk, is_beg, is_end);
+        ModuleBase::timer::tick(this->classname, "pipeline_wait");
+        MPI_Wait(&requests[ichunk], MPI_STATUS_IGNORE);
+        ModuleBase::timer::tick(this->classname, "pipeline_wait");
+
+        ModuleBase::timer::tick(this->classname, "pipeline_pack");
+        // change (numz[ip],nst, poolnproc) to (nz,nst) for sticks in this chunk
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
+        for (int ip = 0; ip < this->poolnproc; ++ip)
+        {
+            for (int is = is_beg; is < is_end; ++is)
+            {
+                int nzip = this->numz[ip];
+                std::complex<T>* outp = &out[startz[ip] + is * nz];
+                std::complex<T>* inp = &in[startg[ip] + is * nzip];
+                for (int izip = 0; izip < nzip; ++izip)
+                {
+                    outp[izip] = inp[izip];
+                }
+            }
+        }
+        ModuleBase::timer::tick(this->classname, "pipeline_pack");
+
+        ModuleBase::timer::tick(this->classname, "pipeline_fftz");
+        this->fft_bundle.fftzfor_chunk(&out[is_beg * nz], &out[is_beg * nz], is_end - is_beg);
+        ModuleBase::timer::tick(this->classname, "pipeline_fftz");
+        if (ichunk + 1 < nchunk)
+        {
+            // let MPI progress the transposes of the remaining chunks
+            int flag = 0;
+            MPI_Testall(nchunk - ichunk - 1, &requests[ichunk + 1], &flag, MPI_STATUSES_IGNORE);
+        }
+    }
+    ModuleBase::timer::tick(this->classname, "gatherp_scatters_fftzfor");
+#endif
+    return;
+}
+
+/**
+ * @brief do the backward z-FFT, then gather sticks and scatter planes
+ * @param in: (nz,nst), auxg of fft_bundle
+ * @param out: (nplane,fftny,fftnx), auxr of fft_bundle
+ * @note in[] will be changed
+ * @note it is the same as fftzbac(in, in) followed by gathers_scatterp(in, out).
+ *       In the pipelined mode (fft_mode >= 4), the transpose of chunk k is posted with
+ *       MPI_Ialltoallv right after its z-FFT, so that it overlaps with the z-FFT of chunk k+1.
+ */
+template <typename T>
+void PW_Basis::fftzbac_gathers_scatterp(std::complex<T>* in, std::complex<T>* out) const
+{
+    const int nchunk = this->fft_bundle.get_pipeline_nchunk<T>();
+    if (this->poolnproc == 1 || nchunk <= 1)
+    {
+        this->fft_bundle.fftzbac(in, in);
+        this->gathers_scatterp(in, out);
+        return;
+    }
+#ifdef __MPI
+    ModuleBase::timer::tick(this->classname, "fftzbac_gathers_scatterp");
+    const MPI_Datatype mpi_type = (typeid(T) == typeid(double)) ? MPI_DOUBLE_COMPLEX : MPI_COMPLEX;
+    // out[] is the send buffer, and the data is received in (nplane,nstot) of recvbuf
+    std::complex<T>* recvbuf = this->fft_bundle.get_auxt_data<T>();
+    std::vector<int> sendcount(nchunk * this->poolnproc), senddispl(nchunk * this->poolnproc);
+    std::vector<int> recvcount(nchunk * this->poolnproc), recvdispl(nchunk * this->poolnproc);
+    std::vector<MPI_Request> requests(nchunk);
+    for (int ichunk = 0; ichunk < nchunk; ++ichunk)
+    {
+        int is_beg = 0, is_end = 0;
+        this->get_stick_chunk(this->nst, nchunk, ichunk, is_beg, is_end);
+        ModuleBase::timer::tick(this->classname, "pipeline_fftz");
+        this->fft_bundle.fftzbac_chunk(&in[is_beg * nz], &in[is_beg * nz], is_end - is_beg);
+        ModuleBase::timer::tick(this->classname, "pipeline_fftz");
+
+        ModuleBase::timer::tick(this->classname, "pipeline_pack");
+        // change (nz,nst) to (numz[ip],nst, poolnproc) for sticks in this chunk
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
+        for (int ip = 0; ip < this->poolnproc; ++ip)
+        {
+            for (int is = is_beg; is < is_end; ++is)
+            {
+                int nzip = this->numz[ip];
+                std::complex<T>* outp = &out[startg[ip] + is * nzip];
+                std::complex<T>* inp = &in[startz[ip] + is * nz];
+                for (int izip = 0; izip < nzip; ++izip)
+                {
+                    outp[izip] = inp[izip];
+                }
+            }
+        }
+        ModuleBase::timer::tick(this->classname, "pipeline_pack");
+
+        for (int ip = 0; ip < this->poolnproc; ++ip)
+        {
+            int ipst_beg = 0, ipst_end = 0;
+            this->get_stick_chunk(this->nst_per[ip], nchunk, ichunk, ipst_beg, ipst_end);
+            const int i = ichunk * this->poolnproc + ip;
+            sendcount[i] = (is_end - is_beg) * this->numz[ip];
+            senddispl[i] = this->startg[ip] + is_beg * this->numz[ip];
+            recvcount[i] = (ipst_end - ipst_beg) * nplane;
+            recvdispl[i] = this->startr[ip] + ipst_beg * nplane;
+        }
+        MPI_Ialltoallv(out, &sendcount[ichunk * poolnproc], &senddispl[ichunk * poolnproc], mpi_type,
+                       recvbuf, &recvcount[ichunk * poolnproc], &recvdispl[ichunk * poolnproc], mpi_type,
+                       this->pool_world, &requests[ichunk]);
+        // let MPI progress the posted transposes
+        int flag = 0;
+        MPI_Testall(ichunk + 1, requests.data(), &flag, MPI_STATUSES_IGNORE);
+    }
+
+    ModuleBase::timer::tick(this->classname, "pipeline_wait");
+    MPI_Waitall(nchunk, requests.data(), MPI_STATUSES_IGNORE);
+    ModuleBase::timer::tick(this->classname, "pipeline_wait");
+
+    ModuleBase::timer::tick(this->classname, "pipeline_pack");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 4096/sizeof(T))
+#endif
+    for (int i = 0; i < this->nrxx; ++i)
+    {
+        out[i] = std::complex<T>(0, 0);
+    }
+    //change (nplane,nstot) to (nplane fftnxy)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int istot = 0; istot < nstot; ++istot)
+    {
+        int ixy = this->istot2ixy[istot];
+        std::complex<T>* outp = &out[ixy * nplane];
+        std::complex<T>* inp = &recvbuf[istot * nplane];
+        for (int iz = 0; iz < nplane; ++iz)
+        {
+            outp[iz] = inp[iz];
+        }
+    }
+    ModuleBase::timer::tick(this->classname, "pipeline_pack");
+    ModuleBase::timer::tick(this->classname, "fftzbac_gathers_scatterp");
+#endif
+    return;
+}
+
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include <cassert>
 #include <complex>
+#include <type_traits>
 
 namespace ModulePW
 {
@@ -42,9 +43,7 @@ void PW_Basis_K::real2recip(const std::complex<FPTYPE>* in,
     }
     this->fft_bundle.fftxyfor(fft_bundle.get_auxr_data<FPTYPE>(), fft_bundle.get_auxr_data<FPTYPE>());
 
-    this->gatherp_scatters(this->fft_bundle.get_auxr_data<FPTYPE>(), this->fft_bundle.get_auxg_data<FPTYPE>());
-
-    this->fft_bundle.fftzfor(fft_bundle.get_auxg_data<FPTYPE>(), fft_bundle.get_auxg_data<FPTYPE>());
+    this->gatherp_scatters_fftzfor(this->fft_bundle.get_auxr_data<FPTYPE>(), this->fft_bundle.get_auxg_data<FPTYPE>());
 
     const int startig = ik * this->npwk_max;
     const int npwk = this->npwk[ik];
@@ -115,9 +114,7 @@ void PW_Basis_K::real2recip(const FPTYPE* in,
 
     this->fft_bundle.fftxyr2c(fft_bundle.get_rspace_data<FPTYPE>(), fft_bundle.get_auxr_data<FPTYPE>());
 
-    this->gatherp_scatters(this->fft_bundle.get_auxr_data<FPTYPE>(), this->fft_bundle.get_auxg_data<FPTYPE>());
-
-    this->fft_bundle.fftzfor(fft_bundle.get_auxg_data<FPTYPE>(), fft_bundle.get_auxg_data<FPTYPE>());
+    this->gatherp_scatters_fftzfor(this->fft_bundle.get_auxr_data<FPTYPE>(), this->fft_bundle.get_auxg_data<FPTYPE>());
 
     const int startig = ik * this->npwk_max;
     const int npwk = this->npwk[ik];
@@ -182,9 +179,7 @@ void PW_Basis_K::recip2real(const std::complex<FPTYPE>* in,
     {
         auxg[this->igl2isz_k[igl + startig]] = in[igl];
     }
-    this->fft_bundle.fftzbac(fft_bundle.get_auxg_data<FPTYPE>(), fft_bundle.get_auxg_data<FPTYPE>());
-
-    this->gathers_scatterp(this->fft_bundle.get_auxg_data<FPTYPE>(), this->fft_bundle.get_auxr_data<FPTYPE>());
+    this->fftzbac_gathers_scatterp(this->fft_bundle.get_auxg_data<FPTYPE>(), this->fft_bundle.get_auxr_data<FPTYPE>());
 
     this->fft_bundle.fftxybac(fft_bundle.get_auxr_data<FPTYPE>(), fft_bundle.get_auxr_data<FPTYPE>());
 
@@ -246,9 +241,7 @@ void PW_Basis_K::recip2real(const std::complex<FPTYPE>* in,
     {
         auxg[this->igl2isz_k[igl + startig]] = in[igl];
     }
-    this->fft_bundle.fftzbac(fft_bundle.get_auxg_data<FPTYPE>(), fft_bundle.get_auxg_data<FPTYPE>());
-
-    this->gathers_scatterp(this->fft_bundle.get_auxg_data<FPTYPE>(), this->fft_bundle.get_auxr_data<FPTYPE>());
+    this->fftzbac_gathers_scatterp(this->fft_bundle.get_auxg_data<FPTYPE>(), this->fft_bundle.get_auxr_data<FPTYPE>());
 
     this->fft_bundle.fftxyc2r(fft_bundle.get_auxr_data<FPTYPE>(), fft_bundle.get_rspace_data<FPTYPE>());
 
@@ -289,6 +282,190 @@ void PW_Basis_K::recip2real(const std::complex<FPTYPE>* in,
     ModuleBase::timer::tick(this->classname, "recip2real");
 }
 
+/**
+ * @brief batched version of real2recip for fft_bundle.get_fft_batch() bands
+ * @param in: (nbatch, ldin), f'(r) of each band
+ * @param out: (nbatch, ldout), c(k,g) of each band
+ */
+template <typename FPTYPE>
+void PW_Basis_K::real2recip_batch(const std::complex<FPTYPE>* in,
+                                  std::complex<FPTYPE>* out,
+                                  const int ldin,
+                                  const int ldout,
+                                  const int ik,
+                                  const bool add,
+                                  const FPTYPE factor) const
+{
+    ModuleBase::timer::tick(this->classname, "real2recip_batch");
+
+    assert(this->gamma_only == false);
+    const int nbatch = this->fft_bundle.get_fft_batch<FPTYPE>();
+    const int stride = this->fft_bundle.get_batch_stride<FPTYPE>();
+    auto* auxr = this->fft_bundle.get_auxr_batch_data<FPTYPE>();
+    auto* auxg = this->fft_bundle.get_auxg_batch_data<FPTYPE>();
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static, 4096 / sizeof(FPTYPE))
+#endif
+    for (int ib = 0; ib < nbatch; ++ib)
+    {
+        for (int ir = 0; ir < this->nrxx; ++ir)
+        {
+            auxr[ib * stride + ir] = in[ib * ldin + ir];
+        }
+    }
+    this->fft_bundle.fftxyfor_batch(auxr, auxr);
+
+    this->gatherp_scatters_batch(auxr, auxg, nbatch, stride);
+
+    this->fft_bundle.fftzfor_batch(auxg, auxg);
+
+    const int startig = ik * this->npwk_max;
+    const int npwk = this->npwk[ik];
+    const FPTYPE tmpfac = (add ? factor : FPTYPE(1.0)) / FPTYPE(this->nxyz);
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static, 4096 / sizeof(FPTYPE))
+#endif
+    for (int ib = 0; ib < nbatch; ++ib)
+    {
+        for (int igl = 0; igl < npwk; ++igl)
+        {
+            if (add)
+            {
+                out[ib * ldout + igl] += tmpfac * auxg[ib * stride + this->igl2isz_k[igl + startig]];
+            }
+            else
+            {
+                out[ib * ldout + igl] = tmpfac * auxg[ib * stride + this->igl2isz_k[igl + startig]];
+            }
+        }
+    }
+    ModuleBase::timer::tick(this->classname, "real2recip_batch");
+}
+
+/**
+ * @brief batched version of recip2real for fft_bundle.get_fft_batch() bands
+ * @param in: (nbatch, ldin), c(k,g) of each band
+ * @param out: (nbatch, ldout), f'(r) of each band
+ */
+template <typename FPTYPE>
+void PW_Basis_K::recip2real_batch(const std::complex<FPTYPE>* in,
+                                  std::complex<FPTYPE>* out,
+                                  const int ldin,
+                                  const int ldout,
+                                  const int ik,
+                                  const bool add,
+                                  const FPTYPE factor) const
+{
+    ModuleBase::timer::tick(this->classname, "recip2real_batch");
+
+    assert(this->gamma_only == false);
+    const int nbatch = this->fft_bundle.get_fft_batch<FPTYPE>();
+    const int stride = this->fft_bundle.get_batch_stride<FPTYPE>();
+    auto* auxr = this->fft_bundle.get_auxr_batch_data<FPTYPE>();
+    auto* auxg = this->fft_bundle.get_auxg_batch_data<FPTYPE>();
+
+    const int startig = ik * this->npwk_max;
+    const int npwk = this->npwk[ik];
+    for (int ib = 0; ib < nbatch; ++ib)
+    {
+        ModuleBase::GlobalFunc::ZEROS(&auxg[ib * stride], this->nst * this->nz);
+    }
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static, 4096 / sizeof(FPTYPE))
+#endif
+    for (int ib = 0; ib < nbatch; ++ib)
+    {
+        for (int igl = 0; igl < npwk; ++igl)
+        {
+            auxg[ib * stride + this->igl2isz_k[igl + startig]] = in[ib * ldin + igl];
+        }
+    }
+    this->fft_bundle.fftzbac_batch(auxg, auxg);
+
+    this->gathers_scatterp_batch(auxg, auxr, nbatch, stride);
+
+    this->fft_bundle.fftxybac_batch(auxr, auxr);
+
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static, 4096 / sizeof(FPTYPE))
+#endif
+    for (int ib = 0; ib < nbatch; ++ib)
+    {
+        for (int ir = 0; ir < this->nrxx; ++ir)
+        {
+            if (add)
+            {
+                out[ib * ldout + ir] += factor * auxr[ib * stride + ir];
+            }
+            else
+            {
+                out[ib * ldout + ir] = auxr[ib * stride + ir];
+            }
+        }
+    }
+    ModuleBase::timer::tick(this->classname, "recip2real_batch");
+}
+
+template <typename FPTYPE, typename Device>
+void PW_Basis_K::real_to_recip_batch(const Device* ctx,
+                                     const std::complex<FPTYPE>* in,
+                                     std::complex<FPTYPE>* out,
+                                     const int nbatch,
+                                     const int ldin,
+                                     const int ldout,
+                                     const int ik,
+                                     const bool add,
+                                     const FPTYPE factor) const
+{
+    int ib = 0;
+    // the batched fft is only available for the cpu fft
+    if (std::is_same<Device, base_device::DEVICE_CPU>::value)
+    {
+        const int nb_fft = this->fft_bundle.get_fft_batch<FPTYPE>();
+        if (nb_fft > 1)
+        {
+            for (; ib + nb_fft <= nbatch; ib += nb_fft)
+            {
+                this->real2recip_batch(in + ib * ldin, out + ib * ldout, ldin, ldout, ik, add, factor);
+            }
+        }
+    }
+    for (; ib < nbatch; ++ib)
+    {
+        this->real_to_recip(ctx, in + ib * ldin, out + ib * ldout, ik, add, factor);
+    }
+}
+
+template <typename FPTYPE, typename Device>
+void PW_Basis_K::recip_to_real_batch(const Device* ctx,
+                                     const std::complex<FPTYPE>* in,
+                                     std::complex<FPTYPE>* out,
+                                     const int nbatch,
+                                     const int ldin,
+                                     const int ldout,
+                                     const int ik,
+                                     const bool add,
+                                     const FPTYPE factor) const
+{
+    int ib = 0;
+    // the batched fft is only available for the cpu fft
+    if (std::is_same<Device, base_device::DEVICE_CPU>::value)
+    {
+        const int nb_fft = this->fft_bundle.get_fft_batch<FPTYPE>();
+        if (nb_fft > 1)
+        {
+            for (; ib + nb_fft <= nbatch; ib += nb_fft)
+            {
+                this->recip2real_batch(in + ib * ldin, out + ib * ldout, ldin, ldout, ik, add, factor);
+            }
+        }
+    }
+    for (; ib < nbatch; ++ib)
+    {
+        this->recip_to_real(ctx, in + ib * ldin, out + ib * ldout, ik, add, factor);
+    }
+}
+
 template <>
 void PW_Basis_K::real_to_recip(const base_device::DEVICE_CPU* /*dev*/,
                                const std::complex<float>* in,
@@ -519,4 +696,79 @@ template void PW_Basis_K::recip2real<double>(const std::complex<double>* in,
                                              const int ik,
                                              const bool add,
                                              const double factor) const; // in:(nz, ns)  ; out(nplane,nx*ny)
+
+template void PW_Basis_K::real_to_recip_batch<float, base_device::DEVICE_CPU>(const base_device::DEVICE_CPU* ctx,
+                                                                             const std::complex<float>* in,
+                                                                             std::complex<float>* out,
+                                                                             const int nbatch,
+                                                                             const int ldin,
+                                                                             const int ldout,
+                                                                             const int ik,
+                                                                             const bool add,
+                                                                             const float factor) const;
+template void PW_Basis_K::real_to_recip_batch<double, base_device::DEVICE_CPU>(const base_device::DEVICE_CPU* ctx,
+                                                                              const std::complex<double>* in,
+                                                                              std::complex<double>* out,
+                                                                              const int nbatch,
+                                                                              const int ldin,
+                                                                              const int ldout,
+                                                                              const int ik,
+                                                                              const bool add,
+                                                                              const double factor) const;
+template void PW_Basis_K::recip_to_real_batch<float, base_device::DEVICE_CPU>(const base_device::DEVICE_CPU* ctx,
+                                                                             const std::complex<float>* in,
+                                                                             std::complex<float>* out,
+                                                                             const int nbatch,
+                                                                             const int ldin,
+                                                                             const int ldout,
+                                                                             const int ik,
+                                                                             const bool add,
+                                                                             const float factor) const;
+template void PW_Basis_K::recip_to_real_batch<double, base_device::DEVICE_CPU>(const base_device::DEVICE_CPU* ctx,
+                                                                              const std::complex<double>* in,
+                                                                              std::complex<double>* out,
+                                                                              const int nbatch,
+                                                                              const int ldin,
+                                                                              const int ldout,
+                                                                              const int ik,
+                                                                              const bool add,
+                                                                              const double factor) const;
+#if (defined(__CUDA) || defined(__ROCM))
+template void PW_Basis_K::real_to_recip_batch<float, base_device::DEVICE_GPU>(const base_device::DEVICE_GPU* ctx,
+                                                                             const std::complex<float>* in,
+                                                                             std::complex<float>* out,
+                                                                             const int nbatch,
+                                                                             const int ldin,
+                                                                             const int ldout,
+                                                                             const int ik,
+                                                                             const bool add,
+                                                                             const float factor) const;
+template void PW_Basis_K::real_to_recip_batch<double, base_device::DEVICE_GPU>(const base_device::DEVICE_GPU* ctx,
+                                                                              const std::complex<double>* in,
+                                                                              std::complex<double>* out,
+                                                                              const int nbatch,
+                                                                              const int ldin,
+                                                                              const int ldout,
+                                                                              const int ik,
+                                                                              const bool add,
+                                                                              const double factor) const;
+template void PW_Basis_K::recip_to_real_batch<float, base_device::DEVICE_GPU>(const base_device::DEVICE_GPU* ctx,
+                                                                             const std::complex<float>* in,
+                                                                             std::complex<float>* out,
+                                                                             const int nbatch,
+                                                                             const int ldin,
+                                                                             const int ldout,
+                                                                             const int ik,
+                                                                             const bool add,
+                                                                             const float factor) const;
+template void PW_Basis_K::recip_to_real_batch<double, base_device::DEVICE_GPU>(const base_device::DEVICE_GPU* ctx,
+                                                                              const std::complex<double>* in,
+                                                                              std::complex<double>* out,
+                                                                              const int nbatch,
+                                                                              const int ldin,
+                                                                              const int ldout,
+                                                                              const int ik,
+                                                                              const bool add,
+                                                                              const double factor) const;
+#endif
 } // namespace ModulePW
@@ -0,0 +1,92 @@
+//---------------------------------------------
+// TEST for batched FFT of several bands
+//---------------------------------------------
+#include "../pw_basis_k.h"
+#ifdef __MPI
+#include "test_tool.h"
+#include "module_base/parallel_global.h"
+#include "mpi.h"
+#endif
+#include "module_base/constants.h"
+#include "module_base/global_function.h"
+#include "module_base/module_device/types.h"
+#include "pw_test.h"
+
+using namespace std;
+// recip_to_real_batch and real_to_recip_batch should give the same results as
+// recip_to_real and real_to_recip band by band, including the remaining bands
+// which do not fill a whole batch
+TEST_F(PWTEST, test_batch)
+{
+    cout << "dividemthd 1, gamma_only: off, batched fft of 7 bands with fft_batch 3" << endl;
+    ModuleBase::Matrix3 latvec(1, 1, 0, 0, 2, 0, 0, 0, 2);
+    const int nks = 2;
+    ModuleBase::Vector3<double>* kvec_d = new ModuleBase::Vector3<double>[nks];
+    kvec_d[0].set(0, 0, 0.5);
+    kvec_d[1].set(0.5, 0.25, 0.5);
+    const int nbands = 7;
+    const base_device::DEVICE_CPU* ctx = nullptr;
+
+    for (const bool xprime: {true, false})
+    {
+        ModulePW::PW_Basis_K pwktest("cpu", "double");
+#ifdef __MPI
+        pwktest.initmpi(nproc_in_pool, rank_in_pool, POOL_WORLD);
+#endif
+        pwktest.initgrids(5, latvec, 25);
+        pwktest.initparameters(false, 25, nks, kvec_d, 1, xprime);
+        pwktest.fft_bundle.initfftbatch(3);
+        pwktest.setuptransform();
+        pwktest.collect_local_pw();
+        EXPECT_EQ(pwktest.fft_bundle.get_fft_batch<double>(), 3);
+
+        const int nrxx = pwktest.nrxx;
+        const int ldg = pwktest.npwk_max + 1;
+        const int ldr = nrxx + 2;
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            const int npwk = pwktest.npwk[ik];
+            vector<complex<double>> psig(nbands * ldg), psir_ref(nbands * ldr), psir(nbands * ldr);
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                for (int ig = 0; ig < npwk; ++ig)
+                {
+                    psig[ib * ldg + ig] = (ib + 1.0) / (pwktest.getgk2(ik, ig) + 1)
+                                          + ModuleBase::IMAG_UNIT / (std::abs(pwktest.getgdirect(ik, ig).x + ib) + 1);
+                }
+            }
+
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                pwktest.recip_to_real(ctx, &psig[ib * ldg], &psir_ref[ib * ldr], ik);
+            }
+            pwktest.recip_to_real_batch(ctx, psig.data(), psir.data(), nbands, ldg, ldr, ik);
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                for (int ir = 0; ir < nrxx; ++ir)
+                {
+                    EXPECT_NEAR(psir[ib * ldr + ir].real(), psir_ref[ib * ldr + ir].real(), 1e-10);
+                    EXPECT_NEAR(psir[ib * ldr + ir].imag(), psir_ref[ib * ldr + ir].imag(), 1e-10);
+                }
+            }
+
+            vector<complex<double>> hpsi_ref(psig), hpsi(psig);
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                pwktest.real_to_recip(ctx, &psir_ref[ib * ldr], &hpsi_ref[ib * ldg], ik, true, 0.5);
+            }
+            pwktest.real_to_recip_batch(ctx, psir.data(), hpsi.data(), nbands, ldr, ldg, ik, true, 0.5);
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                for (int ig = 0; ig < npwk; ++ig)
+                {
+                    EXPECT_NEAR(hpsi[ib * ldg + ig].real(), hpsi_ref[ib * ldg + ig].real(), 1e-10);
+                    EXPECT_NEAR(hpsi[ib * ldg + ig].imag(), hpsi_ref[ib * ldg + ig].imag(), 1e-10);
+                    // real_to_recip(recip_to_real(psi)) = psi
+                    EXPECT_NEAR(hpsi[ib * ldg + ig].real(), 1.5 * psig[ib * ldg + ig].real(), 1e-10);
+                }
+            }
+        }
+    }
+    delete[] kvec_d;
+}
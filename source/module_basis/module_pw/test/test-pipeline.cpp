@@ -0,0 +1,121 @@
+//---------------------------------------------
+// TEST for the pipelined transform (fft_mode >= 4)
+//---------------------------------------------
+#include "../pw_basis_k.h"
+#ifdef __MPI
+#include "test_tool.h"
+#include "module_base/parallel_global.h"
+#include "mpi.h"
+#endif
+#include "module_base/constants.h"
+#include "module_base/global_function.h"
+#include "module_base/module_device/types.h"
+#include "pw_test.h"
+
+using namespace std;
+// the chunk partition of sticks should cover all sticks without overlap
+TEST_F(PWTEST, test_pipeline_chunk)
+{
+    for (const int ns: {0, 1, 3, 4, 10, 13})
+    {
+        int is_end_last = 0;
+        for (int ichunk = 0; ichunk < 4; ++ichunk)
+        {
+            int is_beg = -1, is_end = -1;
+            ModulePW::PW_Basis::get_stick_chunk(ns, 4, ichunk, is_beg, is_end);
+            EXPECT_EQ(is_beg, is_end_last);
+            EXPECT_GE(is_end, is_beg);
+            is_end_last = is_end;
+        }
+        EXPECT_EQ(is_end_last, ns);
+    }
+}
+
+// recip2real and real2recip with fft_mode 4 should give the same results as fft_mode 0
+TEST_F(PWTEST, test_pipeline)
+{
+    cout << "dividemthd 1, gamma_only: off, pipelined transpose with fft_mode 4" << endl;
+    ModuleBase::Matrix3 latvec(1, 1, 0, 0, 2, 0, 0, 0, 2);
+    const int nks = 2;
+    ModuleBase::Vector3<double>* kvec_d = new ModuleBase::Vector3<double>[nks];
+    kvec_d[0].set(0, 0, 0.5);
+    kvec_d[1].set(0.5, 0.25, 0.5);
+    const base_device::DEVICE_CPU* ctx = nullptr;
+
+    for (const bool xprime: {true, false})
+    {
+        ModulePW::PW_Basis_K pwref("cpu", "double");
+        ModulePW::PW_Basis_K pwpipe("cpu", "double");
+        for (ModulePW::PW_Basis_K* pw: {&pwref, &pwpipe})
+        {
+#ifdef __MPI
+            pw->initmpi(nproc_in_pool, rank_in_pool, POOL_WORLD);
+#endif
+            pw->initgrids(5, latvec, 25);
+            pw->initparameters(false, 25, nks, kvec_d, 1, xprime);
+        }
+        pwpipe.fft_bundle.initfftmode(4);
+        pwref.setuptransform();
+        pwref.collect_local_pw();
+        pwpipe.setuptransform();
+        pwpipe.collect_local_pw();
+        EXPECT_EQ(pwpipe.fft_bundle.get_pipeline_nchunk<double>(), (nproc_in_pool > 1) ? 4 : 1);
+
+        const int nrxx = pwref.nrxx;
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            const int npwk = pwref.npwk[ik];
+            vector<complex<double>> psig(npwk), psir_ref(nrxx), psir(nrxx);
+            for (int ig = 0; ig < npwk; ++ig)
+            {
+                psig[ig] = 1.0 / (pwref.getgk2(ik, ig) + 1)
+                           + ModuleBase::IMAG_UNIT / (std::abs(pwref.getgdirect(ik, ig).x) + 1);
+            }
+            pwref.recip_to_real(ctx, psig.data(), psir_ref.data(), ik);
+            pwpipe.recip_to_real(ctx, psig.data(), psir.data(), ik);
+            for (int ir = 0; ir < nrxx; ++ir)
+            {
+                EXPECT_NEAR(psir[ir].real(), psir_ref[ir].real(), 1e-10);
+                EXPECT_NEAR(psir[ir].imag(), psir_ref[ir].imag(), 1e-10);
+            }
+
+            vector<complex<double>> hpsi_ref(npwk), hpsi(npwk);
+            pwref.real_to_recip(ctx, psir_ref.data(), hpsi_ref.data(), ik);
+            pwpipe.real_to_recip(ctx, psir.data(), hpsi.data(), ik);
+            for (int ig = 0; ig < npwk; ++ig)
+            {
+                EXPECT_NEAR(hpsi[ig].real(), hpsi_ref[ig].real(), 1e-10);
+                EXPECT_NEAR(hpsi[ig].imag(), hpsi_ref[ig].imag(), 1e-10);
+                // real_to_recip(recip_to_real(psi)) = psi
+                EXPECT_NEAR(hpsi[ig].real(), psig[ig].real(), 1e-10);
+                EXPECT_NEAR(hpsi[ig].imag(), psig[ig].imag(), 1e-10);
+            }
+        }
+
+        // the density-like transforms of PW_Basis
+        const ModulePW::PW_Basis& rhoref = pwref;
+        const ModulePW::PW_Basis& rhopipe = pwpipe;
+        const int npw = rhoref.npw;
+        vector<complex<double>> rhog(npw), rhor_ref(nrxx), rhor(nrxx);
+        for (int ig = 0; ig < npw; ++ig)
+        {
+            rhog[ig] = 1.0 / (ig + 1.0) + ModuleBase::IMAG_UNIT / (ig % 7 + 1.0);
+        }
+        rhoref.recip2real(rhog.data(), rhor_ref.data());
+        rhopipe.recip2real(rhog.data(), rhor.data());
+        for (int ir = 0; ir < nrxx; ++ir)
+        {
+            EXPECT_NEAR(rhor[ir].real(), rhor_ref[ir].real(), 1e-10);
+            EXPECT_NEAR(rhor[ir].imag(), rhor_ref[ir].imag(), 1e-10);
+        }
+        vector<complex<double>> rhog_ref(npw), rhog2(npw);
+        rhoref.real2recip(rhor_ref.data(), rhog_ref.data());
+        rhopipe.real2recip(rhor.data(), rhog2.data());
+        for (int ig = 0; ig < npw; ++ig)
+        {
+            EXPECT_NEAR(rhog2[ig].real(), rhog_ref[ig].real(), 1e-10);
+            EXPECT_NEAR(rhog2[ig].imag(), rhog_ref[ig].imag(), 1e-10);
+        }
+    }
+    delete[] kvec_d;
+}
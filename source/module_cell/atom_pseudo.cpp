@@ -148,31 +148,38 @@ void Atom_pseudo::set_d_so(ModuleBase::ComplexMatrix& d_so_in,
 void Atom_pseudo::bcast_atom_pseudo()
 {
     ModuleBase::TITLE("Atom_pseudo", "bcast_atom_pseudo");
+    Parallel_Common::Bcast_Buffer buffer;
+    buffer.bcast_with([this](Parallel_Common::Bcast_Buffer& b) { this->sync_atom_pseudo(b); });
+    return;
+}
+
+void Atom_pseudo::sync_atom_pseudo(Parallel_Common::Bcast_Buffer& buffer)
+{
     // == pseudo_h ==
     // int
-    Parallel_Common::bcast_int(lmax);
-    Parallel_Common::bcast_int(mesh);
-    Parallel_Common::bcast_int(nchi);
-    Parallel_Common::bcast_int(nbeta);
-    Parallel_Common::bcast_int(nv);
-    Parallel_Common::bcast_double(zv);
+    buffer.sync(lmax);
+    buffer.sync(mesh);
+    buffer.sync(nchi);
+    buffer.sync(nbeta);
+    buffer.sync(nv);
+    buffer.sync(zv);
 
     // double
-    Parallel_Common::bcast_double(etotps);
-    Parallel_Common::bcast_double(ecutwfc);
-    Parallel_Common::bcast_double(ecutrho);
+    buffer.sync(etotps);
+    buffer.sync(ecutwfc);
+    buffer.sync(ecutrho);
 
     // bool
-    Parallel_Common::bcast_bool(tvanp);
-    Parallel_Common::bcast_bool(nlcc);
-    Parallel_Common::bcast_bool(has_so);
+    buffer.sync(tvanp);
+    buffer.sync(nlcc);
+    buffer.sync(has_so);
 
     // std::string
-    Parallel_Common::bcast_string(psd);
-    Parallel_Common::bcast_string(pp_type);
-    Parallel_Common::bcast_string(xc_func);
+    buffer.sync(psd);
+    buffer.sync(pp_type);
+    buffer.sync(xc_func);
 
-    if (GlobalV::MY_RANK != 0)
+    if (buffer.is_unpacking())
     {
         jjj = std::vector<double>(nbeta, 0.0);
         els = std::vector<std::string>(nchi, "");
@@ -182,18 +189,18 @@ void Atom_pseudo::bcast_atom_pseudo()
         nn = std::vector<int>(nchi, 0);
     }
 
-    Parallel_Common::bcast_double(jjj.data(), nbeta);
-    Parallel_Common::bcast_string(els.data(), nchi);
-    Parallel_Common::bcast_int(lchi.data(), nchi);
-    Parallel_Common::bcast_double(oc.data(), nchi);
-    Parallel_Common::bcast_double(jchi.data(), nchi);
-    Parallel_Common::bcast_int(nn.data(), nchi);
+    buffer.sync(jjj.data(), nbeta);
+    buffer.sync(els.data(), nchi);
+    buffer.sync(lchi.data(), nchi);
+    buffer.sync(oc.data(), nchi);
+    buffer.sync(jchi.data(), nchi);
+    buffer.sync(nn.data(), nchi);
     // == end of pseudo_h
 
     // == pseudo_atom ==
-    Parallel_Common::bcast_int(msh);
-    Parallel_Common::bcast_double(rcut);
-    if (GlobalV::MY_RANK != 0)
+    buffer.sync(msh);
+    buffer.sync(rcut);
+    if (buffer.is_unpacking())
     {
         assert(mesh != 0);
         r = std::vector<double>(mesh, 0.0);
@@ -203,19 +210,19 @@ void Atom_pseudo::bcast_atom_pseudo()
         chi.create(nchi, mesh);
     }
 
-    Parallel_Common::bcast_double(r.data(), mesh);
-    Parallel_Common::bcast_double(rab.data(), mesh);
-    Parallel_Common::bcast_double(rho_atc.data(), mesh);
-    Parallel_Common::bcast_double(rho_at.data(), mesh);
-    Parallel_Common::bcast_double(chi.c, nchi * mesh);
+    buffer.sync(r.data(), mesh);
+    buffer.sync(rab.data(), mesh);
+    buffer.sync(rho_atc.data(), mesh);
+    buffer.sync(rho_at.data(), mesh);
+    buffer.sync(chi.c, nchi * mesh);
     // == end of pseudo_atom ==
 
     // == pseudo_vl ==
-    if (GlobalV::MY_RANK != 0)
+    if (buffer.is_unpacking())
     {
         vloc_at = std::vector<double>(mesh, 0.0);
     }
-    Parallel_Common::bcast_double(vloc_at.data(), mesh);
+    buffer.sync(vloc_at.data(), mesh);
     // == end of pseudo_vl ==
 
     // == pseudo ==
@@ -223,52 +230,45 @@ void Atom_pseudo::bcast_atom_pseudo()
         return;
 }
 
-    if (GlobalV::MY_RANK != 0)
+    if (buffer.is_unpacking())
     {
         lll = std::vector<int>(nbeta, 0);
     }
-    Parallel_Common::bcast_int(lll.data(), nbeta);
-    Parallel_Common::bcast_int(kkbeta);
-    Parallel_Common::bcast_int(nh);
+    buffer.sync(lll.data(), nbeta);
+    buffer.sync(kkbeta);
+    buffer.sync(nh);
 
-    int nr, nc;
-    if (GlobalV::MY_RANK == 0)
-    {
-        nr = betar.nr;
-        nc = betar.nc;
-    }
-    Parallel_Common::bcast_int(nr);
-    Parallel_Common::bcast_int(nc);
+    int nr = betar.nr;
+    int nc = betar.nc;
+    buffer.sync(nr);
+    buffer.sync(nc);
 
-    if (GlobalV::MY_RANK != 0)
+    if (buffer.is_unpacking())
     {
         betar.create(nr, nc);
         dion.create(nbeta, nbeta);
     }
 
-    // below two 'bcast_double' lines of codes seem to have bugs,
-    // on some computers, the code will stuck here for ever.
-    // mohan note 2021-04-28
-    Parallel_Common::bcast_double(dion.c, nbeta * nbeta);
-    Parallel_Common::bcast_double(betar.c, nr * nc);
+    buffer.sync(dion.c, nbeta * nbeta);
+    buffer.sync(betar.c, nr * nc);
     // == end of psesudo_nc ==
 
     // uspp   liuyu 2023-10-03
     if (tvanp)
     {
-        Parallel_Common::bcast_int(nqlc);
-        if (GlobalV::MY_RANK != 0)
+        buffer.sync(nqlc);
+        if (buffer.is_unpacking())
         {
             qfuncl.create(nqlc, nbeta * (nbeta + 1) / 2, mesh);
         }
         const int dim = nqlc * nbeta * (nbeta + 1) / 2 * mesh;
-        Parallel_Common::bcast_double(qfuncl.ptr, dim);
+        buffer.sync(qfuncl.ptr, dim);
 
-        if (GlobalV::MY_RANK != 0)
+        if (buffer.is_unpacking())
         {
             qqq.create(nbeta, nbeta);
         }
-        Parallel_Common::bcast_double(qqq.c, nbeta * nbeta);
+        buffer.sync(qqq.c, nbeta * nbeta);
     }
 
     return;
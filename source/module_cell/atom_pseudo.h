@@ -6,6 +6,7 @@
 #include "module_io/output.h"
 #include "module_base/complexarray.h"
 #include "module_base/complexmatrix.h"
+#include "module_base/parallel_common.h"
 #include "pseudo.h"
 
 
@@ -46,6 +47,8 @@ public:
 
 #ifdef __MPI
 	void bcast_atom_pseudo(void); // for upf201
+	// pack (rank 0) or unpack (the other ranks) the pseudopotential, to broadcast it with other data
+	void sync_atom_pseudo(Parallel_Common::Bcast_Buffer& buffer);
 #endif
 
 };
@@ -75,72 +75,68 @@ void Atom::print_Atom(std::ofstream& ofs)
 
 #include "module_base/parallel_common.h"
 #ifdef __MPI
+namespace
+{
+// the arrays of the na atoms, they are resized to na if they are shorter
+template <typename T>
+void sync_array(Parallel_Common::Bcast_Buffer& buffer, std::vector<T>& v, const int na)
+{
+    if (static_cast<int>(v.size()) < na)
+    {
+        v.resize(na);
+    }
+    buffer.sync(v.data(), na);
+}
+// the components x, y, z of the vectors are one after another
+template <typename T>
+void sync_array(Parallel_Common::Bcast_Buffer& buffer, std::vector<ModuleBase::Vector3<T>>& v, const int na)
+{
+    if (static_cast<int>(v.size()) < na)
+    {
+        v.resize(na, ModuleBase::Vector3<T>(0, 0, 0));
+    }
+    buffer.sync(&v[0].x, 3 * na);
+}
+} // namespace
+
 void Atom::bcast_atom()
 {
-    Parallel_Common::bcast_int(type);
-    Parallel_Common::bcast_int(na);
-    Parallel_Common::bcast_int(nwl);
-    Parallel_Common::bcast_double(Rcut); // pengfei Li 16-2-29
-    Parallel_Common::bcast_int(nw);
-    Parallel_Common::bcast_int(stapos_wf);
-    Parallel_Common::bcast_string(label);
-    Parallel_Common::bcast_bool(coulomb_potential);
-    if (GlobalV::MY_RANK != 0)
+    Parallel_Common::Bcast_Buffer buffer;
+    buffer.bcast_with([this](Parallel_Common::Bcast_Buffer& b) { this->sync_atom(b); });
+    return;
+}
+
+void Atom::sync_atom(Parallel_Common::Bcast_Buffer& buffer)
+{
+    buffer.sync(type);
+    buffer.sync(na);
+    buffer.sync(nwl);
+    buffer.sync(Rcut); // pengfei Li 16-2-29
+    buffer.sync(nw);
+    buffer.sync(stapos_wf);
+    buffer.sync(label);
+    buffer.sync(coulomb_potential);
+    if (buffer.is_unpacking())
     {
         this->l_nchi.resize(nwl + 1, 0);
     }
-    Parallel_Common::bcast_int(l_nchi.data(), nwl + 1);
-    Parallel_Common::bcast_bool(this->flag_empty_element);
-    Parallel_Common::bcast_double(mass);
+    buffer.sync(l_nchi.data(), nwl + 1);
+    buffer.sync(this->flag_empty_element);
+    buffer.sync(mass);
 
     if (na > 0)
     {
-        if (GlobalV::MY_RANK != 0)
-        {
-            assert(na != 0);
-            this->tau.resize(na, ModuleBase::Vector3<double>(0, 0, 0));
-            this->dis.resize(na, ModuleBase::Vector3<double>(0, 0, 0));
-            this->taud.resize(na, ModuleBase::Vector3<double>(0, 0, 0));
-            this->vel.resize(na, ModuleBase::Vector3<double>(0, 0, 0));
-            this->mag.resize(na, 0);
-            this->angle1.resize(na, 0);
-            this->angle2.resize(na, 0);
-            this->m_loc_.resize(na, ModuleBase::Vector3<double>(0, 0, 0));
-            this->mbl.resize(na, ModuleBase::Vector3<int>(0, 0, 0));
-            this->lambda.resize(na, ModuleBase::Vector3<double>(0, 0, 0));
-            this->constrain.resize(na, ModuleBase::Vector3<int>(0, 0, 0));
-        }
-
-        for (int i = 0; i < na; i++)
-        {
-            Parallel_Common::bcast_double(tau[i].x);
-            Parallel_Common::bcast_double(tau[i].y);
-            Parallel_Common::bcast_double(tau[i].z);
-            Parallel_Common::bcast_double(taud[i].x);
-            Parallel_Common::bcast_double(taud[i].y);
-            Parallel_Common::bcast_double(taud[i].z);
-            Parallel_Common::bcast_double(dis[i].x);
-            Parallel_Common::bcast_double(dis[i].y);
-            Parallel_Common::bcast_double(dis[i].z);
-            Parallel_Common::bcast_double(vel[i].x);
-            Parallel_Common::bcast_double(vel[i].y);
-            Parallel_Common::bcast_double(vel[i].z);
-            Parallel_Common::bcast_double(mag[i]);
-            Parallel_Common::bcast_double(angle1[i]);
-            Parallel_Common::bcast_double(angle2[i]);
-            Parallel_Common::bcast_double(m_loc_[i].x);
-            Parallel_Common::bcast_double(m_loc_[i].y);
-            Parallel_Common::bcast_double(m_loc_[i].z);
-            Parallel_Common::bcast_int(mbl[i].x);
-            Parallel_Common::bcast_int(mbl[i].y);
-            Parallel_Common::bcast_int(mbl[i].z);
-            Parallel_Common::bcast_double(lambda[i].x);
-            Parallel_Common::bcast_double(lambda[i].y);
-            Parallel_Common::bcast_double(lambda[i].z);
-            Parallel_Common::bcast_int(constrain[i].x);
-            Parallel_Common::bcast_int(constrain[i].y);
-            Parallel_Common::bcast_int(constrain[i].z);
-        }
+        sync_array(buffer, tau, na);
+        sync_array(buffer, taud, na);
+        sync_array(buffer, dis, na);
+        sync_array(buffer, vel, na);
+        sync_array(buffer, mag, na);
+        sync_array(buffer, angle1, na);
+        sync_array(buffer, angle2, na);
+        sync_array(buffer, m_loc_, na);
+        sync_array(buffer, mbl, na);
+        sync_array(buffer, lambda, na);
+        sync_array(buffer, constrain, na);
     }
 
     return;
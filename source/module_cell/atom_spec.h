@@ -55,6 +55,8 @@ class Atom
 #ifdef __MPI
     void bcast_atom();
     void bcast_atom2();
+    // pack (rank 0) or unpack (the other ranks) what bcast_atom() broadcasts, to broadcast it with other data
+    void sync_atom(Parallel_Common::Bcast_Buffer& buffer);
 #endif
 };
 
@@ -7,14 +7,76 @@
 #endif
 namespace unitcell
 {
+#ifdef __MPI
+    namespace
+    {
+    void sync_matrix3(ModuleBase::Matrix3& m, Parallel_Common::Bcast_Buffer& buffer)
+    {
+        buffer.sync(m.e11);
+        buffer.sync(m.e12);
+        buffer.sync(m.e13);
+        buffer.sync(m.e21);
+        buffer.sync(m.e22);
+        buffer.sync(m.e23);
+        buffer.sync(m.e31);
+        buffer.sync(m.e32);
+        buffer.sync(m.e33);
+    }
+
+    void sync_Lattice(Lattice& lat, Parallel_Common::Bcast_Buffer& buffer)
+    {
+        // distribute lattice parameters.
+        buffer.sync(lat.Coordinate);
+        buffer.sync(lat.lat0);
+        buffer.sync(lat.lat0_angstrom);
+        buffer.sync(lat.tpiba);
+        buffer.sync(lat.tpiba2);
+        buffer.sync(lat.omega);
+        buffer.sync(lat.latName);
+
+        // distribute lattice vectors.
+        sync_matrix3(lat.latvec, buffer);
+
+        // distribute lattice vectors.
+        for (int i = 0; i < 3; i++)
+        {
+            buffer.sync(lat.a1[i]);
+            buffer.sync(lat.a2[i]);
+            buffer.sync(lat.a3[i]);
+            buffer.sync(lat.latcenter[i]);
+            buffer.sync(lat.lc[i]);
+        }
+
+        // distribute superlattice vectors.
+        sync_matrix3(lat.latvec_supercell, buffer);
+    }
+
+    void sync_magnetism(Magnetism& magnet, const int ntype, Parallel_Common::Bcast_Buffer& buffer)
+    {
+        buffer.sync(magnet.start_magnetization, ntype);
+        if (PARAM.inp.nspin == 4)
+        {
+            buffer.sync(magnet.ux_, 3);
+        }
+    }
+
+    void sync_atoms_tau(Atom* atoms, const int ntype, Parallel_Common::Bcast_Buffer& buffer)
+    {
+        for (int i = 0; i < ntype; i++)
+        {
+            atoms[i].sync_atom(buffer); // bcast tau array
+        }
+    }
+    } // namespace
+#endif
+
+    // the data are packed in one buffer on rank 0, which is broadcast at once
     void bcast_atoms_tau(Atom* atoms,
                          const int ntype)
     {
     #ifdef __MPI
-        MPI_Barrier(MPI_COMM_WORLD);
-        for (int i = 0; i < ntype; i++) {
-            atoms[i].bcast_atom(); // bcast tau array
-        }
+        Parallel_Common::Bcast_Buffer buffer;
+        buffer.bcast_with([&](Parallel_Common::Bcast_Buffer& b) { sync_atoms_tau(atoms, ntype, b); });
     #endif
     }
     
@@ -22,76 +84,29 @@ namespace unitcell
                                  const int ntype)
     {
     #ifdef __MPI
-        MPI_Barrier(MPI_COMM_WORLD);
-        for (int i = 0; i < ntype; i++) 
-        {
-            atoms[i].bcast_atom2();
-        }
+        Parallel_Common::Bcast_Buffer buffer;
+        buffer.bcast_with([&](Parallel_Common::Bcast_Buffer& b) {
+            for (int i = 0; i < ntype; i++)
+            {
+                atoms[i].ncpp.sync_atom_pseudo(b);
+            }
+        });
     #endif
     }
 
     void bcast_Lattice(Lattice& lat)
     {
     #ifdef __MPI
-        MPI_Barrier(MPI_COMM_WORLD);
-        // distribute lattice parameters.
-        ModuleBase::Matrix3& latvec = lat.latvec;
-        ModuleBase::Matrix3& latvec_supercell = lat.latvec_supercell;
-        Parallel_Common::bcast_string(lat.Coordinate);
-        Parallel_Common::bcast_double(lat.lat0);
-        Parallel_Common::bcast_double(lat.lat0_angstrom);
-        Parallel_Common::bcast_double(lat.tpiba);
-        Parallel_Common::bcast_double(lat.tpiba2);
-        Parallel_Common::bcast_double(lat.omega);
-        Parallel_Common::bcast_string(lat.latName);
-
-        // distribute lattice vectors.
-        Parallel_Common::bcast_double(latvec.e11);
-        Parallel_Common::bcast_double(latvec.e12);
-        Parallel_Common::bcast_double(latvec.e13);
-        Parallel_Common::bcast_double(latvec.e21);
-        Parallel_Common::bcast_double(latvec.e22);
-        Parallel_Common::bcast_double(latvec.e23);
-        Parallel_Common::bcast_double(latvec.e31);
-        Parallel_Common::bcast_double(latvec.e32);
-        Parallel_Common::bcast_double(latvec.e33);
-
-         // distribute lattice vectors.
-        for (int i = 0; i < 3; i++)
-        {
-            Parallel_Common::bcast_double(lat.a1[i]);
-            Parallel_Common::bcast_double(lat.a2[i]);
-            Parallel_Common::bcast_double(lat.a3[i]);
-            Parallel_Common::bcast_double(lat.latcenter[i]);
-            Parallel_Common::bcast_int(lat.lc[i]);
-        }
-
-        // distribute superlattice vectors.
-        Parallel_Common::bcast_double(latvec_supercell.e11);
-        Parallel_Common::bcast_double(latvec_supercell.e12);
-        Parallel_Common::bcast_double(latvec_supercell.e13);
-        Parallel_Common::bcast_double(latvec_supercell.e21);
-        Parallel_Common::bcast_double(latvec_supercell.e22);
-        Parallel_Common::bcast_double(latvec_supercell.e23);
-        Parallel_Common::bcast_double(latvec_supercell.e31);
-        Parallel_Common::bcast_double(latvec_supercell.e32);
-        Parallel_Common::bcast_double(latvec_supercell.e33);
-
-        // distribute Change the lattice vectors or not
+        Parallel_Common::Bcast_Buffer buffer;
+        buffer.bcast_with([&](Parallel_Common::Bcast_Buffer& b) { sync_Lattice(lat, b); });
     #endif
     }
     
     void bcast_magnetism(Magnetism& magnet, const int ntype)
     {
     #ifdef __MPI
-        MPI_Barrier(MPI_COMM_WORLD);
-        Parallel_Common::bcast_double(magnet.start_magnetization, ntype);
-        if (PARAM.inp.nspin == 4) 
-        {
-            Parallel_Common::bcast_double(magnet.ux_[0]);
-            Parallel_Common::bcast_double(magnet.ux_[1]);
-            Parallel_Common::bcast_double(magnet.ux_[2]);
-        }
+        Parallel_Common::Bcast_Buffer buffer;
+        buffer.bcast_with([&](Parallel_Common::Bcast_Buffer& b) { sync_magnetism(magnet, ntype, b); });
     #endif
     }
 
@@ -99,16 +114,14 @@ namespace unitcell
     {
     #ifdef __MPI
         const int ntype = ucell.ntype;
-        Parallel_Common::bcast_int(ucell.nat);
-
-        bcast_Lattice(ucell.lat);
-        bcast_magnetism(ucell.magnet,ntype);
-        bcast_atoms_tau(ucell.atoms,ntype);
-
-        for (int i = 0; i < ntype; i++)
-        {
-            Parallel_Common::bcast_string(ucell.orbital_fn[i]);
-        }
+        Parallel_Common::Bcast_Buffer buffer;
+        buffer.bcast_with([&](Parallel_Common::Bcast_Buffer& b) {
+            b.sync(ucell.nat);
+            sync_Lattice(ucell.lat, b);
+            sync_magnetism(ucell.magnet, ntype, b);
+            sync_atoms_tau(ucell.atoms, ntype, b);
+            b.sync(ucell.orbital_fn.data(), ntype);
+        });
 
         #ifdef __EXX
         ModuleBase::bcast_data_cereal(GlobalC::exx_info.info_ri.files_abfs,
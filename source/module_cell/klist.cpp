@@ -13,6 +13,56 @@
 #include "module_cell/module_paw/paw_cell.h"
 #endif
 
+#include <cmath>
+#include <unordered_map>
+
+std::vector<double> K_Vectors::count_planewaves(const std::vector<ModuleBase::Vector3<double>>& kvec_c,
+                                                const int nkstot,
+                                                const ModuleBase::Matrix3& reciprocal_vec,
+                                                const ModuleBase::Matrix3& latvec,
+                                                const double gcut)
+{
+    const ModuleBase::Vector3<double> b1(reciprocal_vec.e11, reciprocal_vec.e12, reciprocal_vec.e13);
+    const ModuleBase::Vector3<double> b2(reciprocal_vec.e21, reciprocal_vec.e22, reciprocal_vec.e23);
+    const ModuleBase::Vector3<double> b3(reciprocal_vec.e31, reciprocal_vec.e32, reciprocal_vec.e33);
+    const double a1 = ModuleBase::Vector3<double>(latvec.e11, latvec.e12, latvec.e13).norm();
+    const double a2 = ModuleBase::Vector3<double>(latvec.e21, latvec.e22, latvec.e23).norm();
+    const double b3b3 = b3 * b3;
+    std::vector<double> ngk(nkstot, 0.0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int ik = 0; ik < nkstot; ik++)
+    {
+        // n_i = (G + k - k) * a_i, and |G + k| <= sqrt(gcut)
+        const double gmax = std::sqrt(gcut) + kvec_c[ik].norm();
+        const int n1max = static_cast<int>(std::ceil(gmax * a1));
+        const int n2max = static_cast<int>(std::ceil(gmax * a2));
+        long long count = 0;
+        for (int n1 = -n1max; n1 <= n1max; n1++)
+        {
+            for (int n2 = -n2max; n2 <= n2max; n2++)
+            {
+                // the n3 with |p + n3 b3|^2 <= gcut
+                const ModuleBase::Vector3<double> p = kvec_c[ik] + static_cast<double>(n1) * b1
+                                                      + static_cast<double>(n2) * b2;
+                const double pb3 = p * b3;
+                const double disc = pb3 * pb3 - b3b3 * (p * p - gcut);
+                if (disc < 0.0)
+                {
+                    continue;
+                }
+                const double root = std::sqrt(disc);
+                const long long n3_low = static_cast<long long>(std::ceil((-pb3 - root) / b3b3));
+                const long long n3_high = static_cast<long long>(std::floor((-pb3 + root) / b3b3));
+                count += std::max(n3_high - n3_low + 1, 0LL);
+            }
+        }
+        ngk[ik] = static_cast<double>(count);
+    }
+    return ngk;
+}
+
 void K_Vectors::cal_ik_global()
 {
     const int my_pool = this->para_k.my_pool;
@@ -144,6 +194,23 @@ void K_Vectors::set(const UnitCell& ucell,
     // normalize k points weights according to nspin
     this->normalize_wk(deg);
 
+    // the cost of the Davidson iterations of a k point grows with its number of plane waves,
+    // the pools are given the blocks of k points balancing the sum of the costs.
+    // the costs are calculated on rank 0 where the k points are, and broadcast in kinfo.
+    std::vector<double> kpoint_cost;
+    if (PARAM.inp.basis_type == "pw" && GlobalV::KPAR > 1 && PARAM.inp.ecutwfc > 0.0 && ucell.tpiba2 > 0.0)
+    {
+        kpoint_cost.resize(1, 1.0);
+        if (GlobalV::MY_RANK == 0)
+        {
+            kpoint_cost = K_Vectors::count_planewaves(this->kvec_c,
+                                                      this->nkstot,
+                                                      reciprocal_vec,
+                                                      latvec,
+                                                      PARAM.inp.ecutwfc / ucell.tpiba2);
+        }
+    }
+
     // It's very important in parallel case,
     // firstly do the mpi_k() and then
     // do set_kup_and_kdw()
@@ -152,7 +219,8 @@ void K_Vectors::set(const UnitCell& ucell,
                        GlobalV::MY_POOL,
                        GlobalV::RANK_IN_POOL,
                        GlobalV::NPROC,
-                       nspin_in); // assign k points to several process pools
+                       nspin_in,
+                       kpoint_cost); // assign k points to several process pools
 #ifdef __MPI
     // distribute K point data to the corresponding process
     this->mpi_k(); // 2008-4-29
@@ -559,6 +627,103 @@ void K_Vectors::update_use_ibz(const int& nkstot_ibz,
     return;
 }
 
+namespace
+{
+// the k points in direct coordinates, hashed by the cells of size 16 * epsilon around the multiples of the size.
+// the points equal to a k point within epsilon (Symmetry_Basic::equal) are in the cell of the k point,
+// or in the neighbouring cells when the k point is closer than epsilon to their border.
+class KpointTable
+{
+  public:
+    KpointTable(const double epsilon, const int npoints) : epsilon(epsilon), cell(16.0 * epsilon), next(npoints, -1)
+    {
+        this->head.reserve(npoints);
+    }
+
+    // the index of the point, in [0, npoints)
+    void insert(const ModuleBase::Vector3<double>& kvec, const int index)
+    {
+        const Key key{this->cell_index(kvec.x), this->cell_index(kvec.y), this->cell_index(kvec.z)};
+        auto it = this->head.insert(std::make_pair(key, index));
+        if (!it.second)
+        {
+            this->next[index] = it.first->second;
+            it.first->second = index;
+        }
+    }
+
+    // call f with the index of each k point of the table equal to kvec
+    template <typename F>
+    void for_each_equal(const ModuleBase::Vector3<double>& kvec,
+                        const std::vector<ModuleBase::Vector3<double>>& points,
+                        F f) const
+    {
+        long long lower[3], upper[3];
+        const double x[3] = {kvec.x, kvec.y, kvec.z};
+        for (int d = 0; d < 3; ++d)
+        {
+            const long long ix = this->cell_index(x[d]);
+            const double center = ix * this->cell;
+            lower[d] = (x[d] - (center - 0.5 * this->cell) < this->epsilon) ? ix - 1 : ix;
+            upper[d] = ((center + 0.5 * this->cell) - x[d] < this->epsilon) ? ix + 1 : ix;
+        }
+        for (long long ix = lower[0]; ix <= upper[0]; ++ix)
+        {
+            for (long long iy = lower[1]; iy <= upper[1]; ++iy)
+            {
+                for (long long iz = lower[2]; iz <= upper[2]; ++iz)
+                {
+                    const auto it = this->head.find(Key{ix, iy, iz});
+                    if (it == this->head.end())
+                    {
+                        continue;
+                    }
+                    for (int index = it->second; index != -1; index = this->next[index])
+                    {
+                        const ModuleBase::Vector3<double>& point = points[index];
+                        if (std::abs(kvec.x - point.x) < this->epsilon && std::abs(kvec.y - point.y) < this->epsilon
+                            && std::abs(kvec.z - point.z) < this->epsilon)
+                        {
+                            f(index);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+  private:
+    struct Key
+    {
+        long long x, y, z;
+        bool operator==(const Key& other) const
+        {
+            return x == other.x && y == other.y && z == other.z;
+        }
+    };
+    struct KeyHash
+    {
+        size_t operator()(const Key& k) const
+        {
+            size_t h = std::hash<long long>()(k.x);
+            h = h * 1000003 ^ std::hash<long long>()(k.y);
+            h = h * 1000003 ^ std::hash<long long>()(k.z);
+            return h;
+        }
+    };
+    long long cell_index(const double x) const
+    {
+        return static_cast<long long>(std::floor(x / this->cell + 0.5));
+    }
+
+    double epsilon;
+    double cell;
+    // the last point inserted in each cell, and the point inserted before each point in the same cell
+    std::unordered_map<Key, int, KeyHash> head;
+    std::vector<int> next;
+};
+} // namespace
+
 void K_Vectors::ibz_kpoint(const ModuleSymmetry::Symmetry& symm,
                            bool use_symm,
                            std::string& skpt,
@@ -792,13 +957,6 @@ void K_Vectors::ibz_kpoint(const ModuleSymmetry::Symmetry& symm,
     // nkstot is the total input k-points number.
     const double weight = 1.0 / static_cast<double>(nkstot);
 
-    ModuleBase::Vector3<double> kvec_rot;
-    ModuleBase::Vector3<double> kvec_rot_k;
-
-    //	for(int i=0; i<nrotkm; i++)
-    //	{
-    //		out.printM3("rot matrix",kgmatrix[i]);
-    //	}
     auto restrict_kpt = [&symm](ModuleBase::Vector3<double>& kvec) {
         // in (-0.5, 0.5]
         kvec.x = fmod(kvec.x + 100.5 - 0.5 * symm.epsilon, 1) - 0.5 + 0.5 * symm.epsilon;
@@ -819,95 +977,33 @@ void K_Vectors::ibz_kpoint(const ModuleSymmetry::Symmetry& symm,
         }
         return;
     };
-    // for output in kpoints file
-    int ibz_index[nkstot];
-    // search in all k-poins.
+    // restrict all the k points to (-0.5, 0.5], and hash them
+    KpointTable kpoint_table(symm.epsilon, nkstot);
     for (int i = 0; i < nkstot; ++i)
     {
-        // restrict to [0, 1)
         restrict_kpt(kvec_d[i]);
+        kpoint_table.insert(kvec_d[i], i);
+    }
 
-        // std::cout << "\n kpoint = " << i << std::endl;
-        // std::cout << "\n kvec_d = " << kvec_d[i].x << " " << kvec_d[i].y << " " << kvec_d[i].z;
-        bool already_exist = false;
-        int exist_number = -1;
-        // search over all symmetry operations
-        for (int j = 0; j < nrotkm; ++j)
-        {
-            if (!already_exist)
-            {
-                // rotate the kvec_d within all operations.
-                // here use direct coordinates.
-                //                kvec_rot = kgmatrix[j] * kvec_d[i];
-                // mohan modify 2010-01-30.
-                // mohan modify again 2010-01-31
-                // fix the bug like kvec_d * G; is wrong
-                kvec_rot = kvec_d[i] * kgmatrix[j]; // wrong for total energy, but correct for nonlocal force.
-                // kvec_rot = kgmatrix[j] * kvec_d[i]; //correct for total energy, but wrong for nonlocal force.
-                restrict_kpt(kvec_rot);
-                if (this->is_mp)
-                {
-                    kvec_rot_k = kvec_d_k[i] * kkmatrix[j];              // k-lattice rotation
-                    kvec_rot_k = kvec_rot_k * k_vec * ucell.G.Inverse(); // convert to recip lattice
-                    restrict_kpt(kvec_rot_k);
-
-                    assert(symm.equal(kvec_rot.x, kvec_rot_k.x));
-                    assert(symm.equal(kvec_rot.y, kvec_rot_k.y));
-                    assert(symm.equal(kvec_rot.z, kvec_rot_k.z));
-                    // std::cout << "\n kvec_rot (in recip) = " << kvec_rot.x << " " << kvec_rot.y << " " << kvec_rot.z;
-                    // std::cout << "\n kvec_rot(k to recip)= " << kvec_rot_k.x << " " << kvec_rot_k.y << " " <<
-                    // kvec_rot_k.z;
-                    kvec_rot_k = kvec_rot_k * ucell.G * k_vec.Inverse(); // convert back to k-latice
-                }
-                for (int k = 0; k < nkstot_ibz; ++k)
-                {
-                    if (symm.equal(kvec_rot.x, kvec_d_ibz[k].x) && symm.equal(kvec_rot.y, kvec_d_ibz[k].y)
-                        && symm.equal(kvec_rot.z, kvec_d_ibz[k].z))
-                    {
-                        already_exist = true;
-                        // find another ibz k point,
-                        // but is already in the ibz_kpoint list.
-                        // so the weight need to +1;
-                        wk_ibz[k] += weight;
-                        exist_number = k;
-                        break;
-                    }
-                }
-            } // end !already_exist
-        }
-        // if really there is no equivalent k point in the list, then add it.
-        if (!already_exist)
-        {
-			//if it's a new ibz kpoint.
-			//nkstot_ibz indicate the index of ibz kpoint.
-            kvec_d_ibz[nkstot_ibz] = kvec_d[i];
-            // output in kpoints file
-            ibz_index[i] = nkstot_ibz;
-
-            // the weight should be averged k-point weight.
-            wk_ibz[nkstot_ibz] = weight;
-
-            // ibz2bz records the index of origin k points.
-            ibz2bz[nkstot_ibz] = i;
-            ++nkstot_ibz;
-        }
-        else // mohan fix bug 2010-1-30
+    // the operations form a group, so the k points equal to the rotations of a k point are its star.
+    // each k point not in the star of a previous one is a new ibz k point, and its star is found
+    // with nrotkm searches in the table, so that each k point is rotated only if it is an ibz k point.
+    const int not_found = -1;
+    const ModuleBase::Matrix3 k_to_recip = this->is_mp ? k_vec * ucell.G.Inverse() : ModuleBase::Matrix3();
+    std::vector<int> ibz_index(nkstot, not_found);
+    for (int i = 0; i < nkstot; ++i)
+    {
+        if (ibz_index[i] != not_found)
         {
-            //			std::cout << "\n\n already exist ! ";
-
-            //			std::cout << "\n kvec_rot = " << kvec_rot.x << " " << kvec_rot.y << " " << kvec_rot.z;
-            //			std::cout << "\n kvec_d_ibz = " << kvec_d_ibz[exist_number].x
-            //			<< " " << kvec_d_ibz[exist_number].y
-            //			<< " " << kvec_d_ibz[exist_number].z;
+            // find another ibz k point,
+            // but is already in the ibz_kpoint list.
+            // so the weight need to +1;
+            const int exist_number = ibz_index[i];
+            wk_ibz[exist_number] += weight;
 
             double kmol_new = kvec_d[i].norm2();
             double kmol_old = kvec_d_ibz[exist_number].norm2();
 
-            ibz_index[i] = exist_number;
-
-            //			std::cout << "\n kmol_new = " << kmol_new;
-            //			std::cout << "\n kmol_old = " << kmol_old;
-
             // why we need this step?
             // because in pw_basis.cpp, while calculate ggwfc2,
             // if we want to keep the result of symmetry operation is right.
@@ -919,8 +1015,53 @@ void K_Vectors::ibz_kpoint(const ModuleSymmetry::Symmetry& symm,
             {
                 kvec_d_ibz[exist_number] = kvec_d[i];
             }
+            continue;
+        }
+
+        //if it's a new ibz kpoint.
+        //nkstot_ibz indicate the index of ibz kpoint.
+        kvec_d_ibz[nkstot_ibz] = kvec_d[i];
+        // output in kpoints file
+        ibz_index[i] = nkstot_ibz;
+
+        // the weight should be averged k-point weight.
+        wk_ibz[nkstot_ibz] = weight;
+
+        // ibz2bz records the index of origin k points.
+        ibz2bz[nkstot_ibz] = i;
+
+        // search over all symmetry operations
+        for (int j = 0; j < nrotkm; ++j)
+        {
+            // rotate the kvec_d within all operations.
+            // here use direct coordinates.
+            //                kvec_rot = kgmatrix[j] * kvec_d[i];
+            // mohan modify 2010-01-30.
+            // mohan modify again 2010-01-31
+            // fix the bug like kvec_d * G; is wrong
+            ModuleBase::Vector3<double> kvec_rot
+                = kvec_d[i] * kgmatrix[j]; // wrong for total energy, but correct for nonlocal force.
+            // kvec_rot = kgmatrix[j] * kvec_d[i]; //correct for total energy, but wrong for nonlocal force.
+            restrict_kpt(kvec_rot);
+            if (this->is_mp)
+            {
+                ModuleBase::Vector3<double> kvec_rot_k = kvec_d_k[i] * kkmatrix[j]; // k-lattice rotation
+                kvec_rot_k = kvec_rot_k * k_to_recip;                               // convert to recip lattice
+                restrict_kpt(kvec_rot_k);
+
+                assert(symm.equal(kvec_rot.x, kvec_rot_k.x));
+                assert(symm.equal(kvec_rot.y, kvec_rot_k.y));
+                assert(symm.equal(kvec_rot.z, kvec_rot_k.z));
+            }
+            // the k points of the star after i
+            kpoint_table.for_each_equal(kvec_rot, kvec_d, [&](const int m) {
+                if (ibz_index[m] == not_found)
+                {
+                    ibz_index[m] = nkstot_ibz;
+                }
+            });
         }
-        //		BLOCK_HERE("check k point");
+        ++nkstot_ibz;
     }
 
     delete[] kkmatrix;
@@ -930,29 +1071,32 @@ void K_Vectors::ibz_kpoint(const ModuleSymmetry::Symmetry& symm,
     this->kstars.resize(nkstot_ibz);
     if (ModuleSymmetry::Symmetry::symm_flag == 1)
     {
-        for (int i = 0; i < nkstot; ++i)
+        // the first operation rotating each k point to its ibz k point:
+        // kvec_d[i] * kgmatrix[j] = kvec_d_ibz[k] is kvec_d[i] = kvec_d_ibz[k] * kgmatrix[j]^-1,
+        // so the operations of each k point are found from the rotations of the ibz k points.
+        std::vector<int> star_isym(nkstot, not_found);
+        for (int j = 0; j < nrotkm; ++j)
         {
-            int exist_number = -1;
-            int isym = 0;
-            for (int j = 0; j < nrotkm; ++j)
+            const ModuleBase::Matrix3 kgmatrix_inv = kgmatrix[j].Inverse();
+            // each k point is in the star of one ibz k point, so the stars are filled independently
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (int k = 0; k < nkstot_ibz; ++k)
             {
-                kvec_rot = kvec_d[i] * kgmatrix[j];
+                ModuleBase::Vector3<double> kvec_rot = kvec_d_ibz[k] * kgmatrix_inv;
                 restrict_kpt(kvec_rot);
-                for (int k = 0; k < nkstot_ibz; ++k)
-                {
-                    if (symm.equal(kvec_rot.x, kvec_d_ibz[k].x) &&
-                        symm.equal(kvec_rot.y, kvec_d_ibz[k].y) &&
-                        symm.equal(kvec_rot.z, kvec_d_ibz[k].z))
+                kpoint_table.for_each_equal(kvec_rot, kvec_d, [&](const int m) {
+                    if (star_isym[m] == not_found && ibz_index[m] == k)
                     {
-                        isym = j;
-                        exist_number = k;
-                        break;
+                        star_isym[m] = j;
                     }
-                }
-                if (exist_number != -1) { break;
-}
+                });
             }
-            this->kstars[exist_number].insert(std::make_pair(isym, kvec_d[i]));
+        }
+        for (int i = 0; i < nkstot; ++i)
+        {
+            this->kstars[ibz_index[i]].insert(std::make_pair(star_isym[i] == not_found ? 0 : star_isym[i], kvec_d[i]));
         }
     }
 #endif
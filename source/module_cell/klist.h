@@ -335,6 +335,23 @@ public:
      */
     void mpi_k();
 
+    /**
+     * @brief Counts the plane waves |k+G|^2 <= gcut of each k point, the cost of the k point in the pw basis.
+     *
+     * @param kvec_c The Cartesian coordinates of the k points, in 2pi/lat0.
+     * @param nkstot The number of k points.
+     * @param reciprocal_vec The reciprocal lattice vectors (rows), in 2pi/lat0.
+     * @param latvec The lattice vectors (rows), in lat0.
+     * @param gcut The cutoff of |k+G|^2, in (2pi/lat0)^2.
+     *
+     * @return std::vector<double> The number of plane waves of each k point, the same as the npwk of PW_Basis_K.
+     */
+    static std::vector<double> count_planewaves(const std::vector<ModuleBase::Vector3<double>>& kvec_c,
+                                                const int nkstot,
+                                                const ModuleBase::Matrix3& reciprocal_vec,
+                                                const ModuleBase::Matrix3& latvec,
+                                                const double gcut);
+
     // step 4 : *2 kpoints.
 
     /**
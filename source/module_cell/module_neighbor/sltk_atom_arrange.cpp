@@ -64,7 +64,8 @@ void atom_arrange::search(const bool pbc_flag,
                           const UnitCell& ucell,
                           const double& search_radius_bohr,
                           const int& test_atom_in,
-                          const bool test_only)
+                          const bool test_only,
+                          const double& search_skin_bohr)
 {
     ModuleBase::TITLE("atom_arrange", "search");
     ModuleBase::timer::tick("atom_arrange", "search");
@@ -73,6 +74,10 @@ void atom_arrange::search(const bool pbc_flag,
     {
         ModuleBase::WARNING_QUIT("atom_arrange::search", " search_radius_bohr < 0,forbidden");
     }
+    if (search_skin_bohr < 0.0)
+    {
+        ModuleBase::WARNING_QUIT("atom_arrange::search", " search_skin_bohr < 0,forbidden");
+    }
 
     ModuleBase::GlobalFunc::OUT(ofs_in, "searching radius is (Bohr))", search_radius_bohr);
     ModuleBase::GlobalFunc::OUT(ofs_in, "searching radius unit is (Bohr))", ucell.lat0);
@@ -91,7 +96,13 @@ void atom_arrange::search(const bool pbc_flag,
 
     // Atom_input at(ofs_in, ucell, pbc_flag, radius_lat0unit, test_atom_in);
 
-    grid_d.init(ofs_in, ucell, radius_lat0unit, pbc_flag);
+    // With search_skin_bohr > 0, the atoms within search_radius_bohr + search_skin_bohr found in the last search
+    // are reused as the candidates of adjacent atoms, until one of the atoms moves more than search_skin_bohr / 2.
+    grid_d.init(ofs_in, ucell, radius_lat0unit, pbc_flag, search_skin_bohr / ucell.lat0);
+    if (search_skin_bohr > 0.0)
+    {
+        ModuleBase::GlobalFunc::OUT(ofs_in, "adjacent atoms built, reused", grid_d.nbuild, grid_d.nreuse);
+    }
 
 	// The screen output is very time-consuming. To avoid interfering with the timing, we will insert logging here earlier.
     ModuleBase::timer::tick("atom_arrange", "search");
@@ -19,7 +19,8 @@ public:
 		const UnitCell &ucell, 
 		const double& search_radius_bohr, 
 		const int &test_atom_in,
-		const bool test_only = false);
+		const bool test_only = false,
+		const double& search_skin_bohr = 0.0);
 
 	//caoyu modify 2021-05-24
 	static double set_sr_NL(
@@ -5,6 +5,11 @@
 #include "module_base/memory.h"
 #include "module_base/timer.h"
 
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 Grid::Grid(const int& test_grid_in) : test_grid(test_grid_in)
 {
 }
@@ -14,16 +19,38 @@ Grid::~Grid()
     this->clear_atoms();
 }
 
-void Grid::init(std::ofstream& ofs_in, const UnitCell& ucell, const double radius_in, const bool boundary)
+void Grid::init(std::ofstream& ofs_in,
+                const UnitCell& ucell,
+                const double radius_in,
+                const bool boundary,
+                const double skin_in)
 {
     ModuleBase::TITLE("SLTK_Grid", "init");
     ModuleBase::timer::tick("atom_arrange", "grid_d.init");
+
+    double max_move = 0.0;
+    if (skin_in > 0.0 && this->Check_Reuse_Condition(ucell, radius_in, boundary, skin_in, max_move))
+    {
+        ModuleBase::GlobalFunc::OUT(ofs_in, "Reuse adjacent atoms, max move(unit:lat0)", max_move);
+        this->Refresh_Atoms(ucell);
+        this->Select_Adjacent(ucell);
+        this->nreuse++;
+        ModuleBase::timer::tick("atom_arrange", "grid_d.init");
+        return;
+    }
+
     this->pbc = boundary;
-    this->sradius2 = radius_in * radius_in;
-    this->sradius = radius_in;
+    this->skin = skin_in;
+    // the candidates are searched with sradius + skin
+    this->sradius = radius_in + skin_in;
+    this->sradius2 = this->sradius * this->sradius;
 
     ModuleBase::GlobalFunc::OUT(ofs_in, "PeriodicBoundary", this->pbc);
-    ModuleBase::GlobalFunc::OUT(ofs_in, "Radius(unit:lat0)", sradius);
+    ModuleBase::GlobalFunc::OUT(ofs_in, "Radius(unit:lat0)", radius_in);
+    if (skin_in > 0.0)
+    {
+        ModuleBase::GlobalFunc::OUT(ofs_in, "Skin(unit:lat0)", skin_in);
+    }
 
     this->Check_Expand_Condition(ucell);
     ModuleBase::GlobalFunc::OUT(ofs_in, "glayer", glayerX, glayerY, glayerZ);
@@ -31,9 +58,139 @@ void Grid::init(std::ofstream& ofs_in, const UnitCell& ucell, const double radiu
 
     this->setMemberVariables(ofs_in, ucell);
     this->Construct_Adjacent(ucell);
+
+    this->sradius = radius_in;
+    this->sradius2 = radius_in * radius_in;
+    if (skin_in > 0.0)
+    {
+        this->skin_adj_start.swap(this->adj_start);
+        this->skin_adj_atoms.swap(this->adj_atoms);
+        this->tau_build.resize(this->type_start[ucell.ntype]);
+        for (int it = 0; it < ucell.ntype; it++)
+        {
+            std::copy(ucell.atoms[it].tau.begin(),
+                      ucell.atoms[it].tau.begin() + ucell.atoms[it].na,
+                      this->tau_build.begin() + this->type_start[it]);
+        }
+        this->latvec_build = ucell.latvec;
+        this->Select_Adjacent(ucell);
+    }
+    this->nbuild++;
     ModuleBase::timer::tick("atom_arrange", "grid_d.init");
 }
 
+bool Grid::Check_Reuse_Condition(const UnitCell& ucell,
+                                 const double radius_in,
+                                 const bool boundary,
+                                 const double skin_in,
+                                 double& max_move) const
+{
+    if (this->skin_adj_start.empty() || boundary != this->pbc || radius_in != this->sradius || skin_in != this->skin
+        || static_cast<int>(this->type_start.size()) != ucell.ntype + 1)
+    {
+        return false;
+    }
+    const ModuleBase::Matrix3& latvec = ucell.latvec;
+    const ModuleBase::Matrix3& latvec0 = this->latvec_build;
+    if (latvec.e11 != latvec0.e11 || latvec.e12 != latvec0.e12 || latvec.e13 != latvec0.e13
+        || latvec.e21 != latvec0.e21 || latvec.e22 != latvec0.e22 || latvec.e23 != latvec0.e23
+        || latvec.e31 != latvec0.e31 || latvec.e32 != latvec0.e32 || latvec.e33 != latvec0.e33)
+    {
+        return false;
+    }
+    for (int it = 0; it < ucell.ntype; it++)
+    {
+        if (this->type_start[it + 1] - this->type_start[it] != ucell.atoms[it].na)
+        {
+            return false;
+        }
+    }
+
+    // The distance of two atoms changes by no more than twice of the largest displacement,
+    // so the candidates within sradius + skin contain all the atoms within sradius
+    // as long as no atom moves more than skin / 2.
+    double max_move2 = 0.0;
+    for (int it = 0; it < ucell.ntype; it++)
+    {
+        for (int ia = 0; ia < ucell.atoms[it].na; ia++)
+        {
+            const double move2 = (ucell.atoms[it].tau[ia] - this->tau_build[this->type_start[it] + ia]).norm2();
+            max_move2 = std::max(max_move2, move2);
+        }
+    }
+    max_move = std::sqrt(max_move2);
+    return 2.0 * max_move <= skin_in;
+}
+
+void Grid::Refresh_Atoms(const UnitCell& ucell)
+{
+    ModuleBase::timer::tick("Grid", "refresh_atoms");
+    ModuleBase::Vector3<double> vec1(ucell.latvec.e11, ucell.latvec.e12, ucell.latvec.e13);
+    ModuleBase::Vector3<double> vec2(ucell.latvec.e21, ucell.latvec.e22, ucell.latvec.e23);
+    ModuleBase::Vector3<double> vec3(ucell.latvec.e31, ucell.latvec.e32, ucell.latvec.e33);
+    const int natom_search = this->atoms_in_search.size();
+#pragma omp parallel for schedule(static)
+    for (int ia = 0; ia < natom_search; ia++)
+    {
+        FAtom& atom = this->atoms_in_search[ia];
+        const ModuleBase::Vector3<double>& tau = ucell.atoms[atom.type].tau[atom.natom];
+        const int ix = atom.cell_x;
+        const int iy = atom.cell_y;
+        const int iz = atom.cell_z;
+        // the same as setMemberVariables
+        atom.x = tau.x + vec1[0] * ix + vec2[0] * iy + vec3[0] * iz;
+        atom.y = tau.y + vec1[1] * ix + vec2[1] * iy + vec3[1] * iz;
+        atom.z = tau.z + vec1[2] * ix + vec2[2] * iy + vec3[2] * iz;
+    }
+    ModuleBase::timer::tick("Grid", "refresh_atoms");
+}
+
+void Grid::Select_Adjacent(const UnitCell& ucell)
+{
+    ModuleBase::timer::tick("Grid", "select_adj");
+    const int nat = this->type_start[ucell.ntype];
+    this->adj_start.assign(nat + 1, 0);
+
+    // the adjacent atoms are selected in the place of their candidates, then packed
+    std::vector<int> selected(this->skin_adj_atoms.size());
+#pragma omp parallel for schedule(static)
+    for (int iat = 0; iat < nat; iat++)
+    {
+        const int i_type = std::upper_bound(this->type_start.begin(), this->type_start.end(), iat)
+                           - this->type_start.begin() - 1;
+        const ModuleBase::Vector3<double>& tau = ucell.atoms[i_type].tau[iat - this->type_start[i_type]];
+        int adj_num = 0;
+        for (int i = this->skin_adj_start[iat]; i < this->skin_adj_start[iat + 1]; i++)
+        {
+            const FAtom& fatom2 = this->atoms_in_search[this->skin_adj_atoms[i]];
+            const double delta_x = tau.x - fatom2.x;
+            const double delta_y = tau.y - fatom2.y;
+            const double delta_z = tau.z - fatom2.z;
+            const double dr = delta_x * delta_x + delta_y * delta_y + delta_z * delta_z;
+            // the same condition as Construct_Adjacent_final
+            if (dr != 0.0 && dr <= this->sradius2)
+            {
+                selected[this->skin_adj_start[iat] + adj_num] = this->skin_adj_atoms[i];
+                adj_num++;
+            }
+        }
+        this->adj_start[iat + 1] = adj_num;
+    }
+    for (int iat = 0; iat < nat; iat++)
+    {
+        this->adj_start[iat + 1] += this->adj_start[iat];
+    }
+    this->adj_atoms.resize(this->adj_start[nat]);
+#pragma omp parallel for schedule(static)
+    for (int iat = 0; iat < nat; iat++)
+    {
+        std::copy(selected.begin() + this->skin_adj_start[iat],
+                  selected.begin() + this->skin_adj_start[iat] + (this->adj_start[iat + 1] - this->adj_start[iat]),
+                  this->adj_atoms.begin() + this->adj_start[iat]);
+    }
+    ModuleBase::timer::tick("Grid", "select_adj");
+}
+
 void Grid::Check_Expand_Condition(const UnitCell& ucell)
 {
     //	ModuleBase::TITLE(GlobalV::ofs_running, "Atom_input", "Check_Expand_Condition");
@@ -170,7 +327,27 @@ void Grid::setMemberVariables(std::ofstream& ofs_in, //  output data to ofs
     ModuleBase::Vector3<double> vec2(ucell.latvec.e21, ucell.latvec.e22, ucell.latvec.e23);
     ModuleBase::Vector3<double> vec3(ucell.latvec.e31, ucell.latvec.e32, ucell.latvec.e33);
 
-    // calculate min & max value
+    // The adjacent atoms are searched for the atoms in the unitcell only,
+    // so the images farther than sradius from the range of the unitcell atoms are not needed.
+    ModuleBase::Vector3<double> cell_min(x_min, y_min, z_min);
+    ModuleBase::Vector3<double> cell_max(x_max, y_max, z_max);
+    this->type_start.resize(ucell.ntype + 1, 0);
+    for (int i = 0; i < ucell.ntype; i++)
+    {
+        this->type_start[i + 1] = this->type_start[i] + ucell.atoms[i].na;
+        for (int j = 0; j < ucell.atoms[i].na; j++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                cell_min[k] = std::min(cell_min[k], ucell.atoms[i].tau[j][k]);
+                cell_max[k] = std::max(cell_max[k], ucell.atoms[i].tau[j][k]);
+            }
+        }
+    }
+    cell_min -= ModuleBase::Vector3<double>(sradius, sradius, sradius);
+    cell_max += ModuleBase::Vector3<double>(sradius, sradius, sradius);
+
+    // calculate min & max value, and keep the atoms in search
     for (int ix = -glayerX_minus; ix < glayerX; ix++)
     {
         for (int iy = -glayerY_minus; iy < glayerY; iy++)
@@ -190,6 +367,11 @@ void Grid::setMemberVariables(std::ofstream& ofs_in, //  output data to ofs
                         y_max = std::max(y_max, y);
                         z_min = std::min(z_min, z);
                         z_max = std::max(z_max, z);
+                        if (x >= cell_min.x && x <= cell_max.x && y >= cell_min.y && y <= cell_max.y
+                            && z >= cell_min.z && z <= cell_max.z)
+                        {
+                            this->atoms_in_search.push_back(FAtom(x, y, z, i, j, ix, iy, iz));
+                        }
                     }
                 }
             }
@@ -199,123 +381,145 @@ void Grid::setMemberVariables(std::ofstream& ofs_in, //  output data to ofs
     ModuleBase::GlobalFunc::OUT(ofs_in, "min_tau", x_min, y_min, z_min);
     ModuleBase::GlobalFunc::OUT(ofs_in, "max_tau", x_max, y_max, z_max);
 
-    this->box_edge_length = sradius + 0.1; // To avoid edge cases, the size of the box is slightly increased.
-
-/*  warning box algorithm   
-    this->box_nx = std::ceil((this->x_max - this->x_min) / box_edge_length) + 1;
-    this->box_ny = std::ceil((this->y_max - this->y_min) / box_edge_length) + 1;
-    this->box_nz = std::ceil((this->z_max - this->z_min) / box_edge_length) + 1;
-    ModuleBase::GlobalFunc::OUT(ofs_in, "BoxNumber", box_nx, box_ny, box_nz);
+    // the boxes only cover the atoms in search
+    x_min = std::max(x_min, cell_min.x);
+    y_min = std::max(y_min, cell_min.y);
+    z_min = std::max(z_min, cell_min.z);
+    x_max = std::min(x_max, cell_max.x);
+    y_max = std::min(y_max, cell_max.y);
+    z_max = std::min(z_max, cell_max.z);
 
-    atoms_in_box.resize(this->box_nx);
-    for (int i = 0; i < this->box_nx; i++)
+    this->box_edge_length = sradius + 0.1; // To avoid edge cases, the size of the box is slightly increased.
+    const int natom_search = this->atoms_in_search.size();
+    auto set_box_number = [&]() {
+        this->box_nx = std::floor((this->x_max - this->x_min) / box_edge_length) + 1;
+        this->box_ny = std::floor((this->y_max - this->y_min) / box_edge_length) + 1;
+        this->box_nz = std::floor((this->z_max - this->z_min) / box_edge_length) + 1;
+    };
+    set_box_number();
+    // For a small searching radius, there are much more boxes than atoms, most of which are empty.
+    // Larger boxes are used then, which keeps the memory of box_start in O(N).
+    const double nbox = static_cast<double>(box_nx) * box_ny * box_nz;
+    if (nbox > std::max(natom_search, 1))
     {
-        atoms_in_box[i].resize(this->box_ny);
-        for (int j = 0; j < this->box_ny; j++)
-        {
-            atoms_in_box[i][j].resize(this->box_nz);
-        }
+        this->box_edge_length *= std::cbrt(nbox / std::max(natom_search, 1));
+        set_box_number();
     }
- */
-    this->box_nx = glayerX + glayerX_minus;
-    this->box_ny = glayerY + glayerY_minus;
-    this->box_nz = glayerZ + glayerZ_minus;
     ModuleBase::GlobalFunc::OUT(ofs_in, "BoxNumber", box_nx, box_ny, box_nz);
 
-    atoms_in_box.resize(this->box_nx);
-    for (int i = 0; i < this->box_nx; i++)
+    // counting sort of the atoms into boxes, the atoms in each box keep the order of atoms_in_search
+    std::vector<int> ibox_of_atom(natom_search);
+    this->box_start.assign(box_nx * box_ny * box_nz + 1, 0);
+    for (int ia = 0; ia < natom_search; ia++)
     {
-        atoms_in_box[i].resize(this->box_ny);
-        for (int j = 0; j < this->box_ny; j++)
-        {
-            atoms_in_box[i][j].resize(this->box_nz);
-        }
+        const FAtom& atom = this->atoms_in_search[ia];
+        int box_i_x, box_i_y, box_i_z;
+        this->getBox(box_i_x, box_i_y, box_i_z, atom.x, atom.y, atom.z);
+        box_i_x = std::min(std::max(box_i_x, 0), box_nx - 1);
+        box_i_y = std::min(std::max(box_i_y, 0), box_ny - 1);
+        box_i_z = std::min(std::max(box_i_z, 0), box_nz - 1);
+        ibox_of_atom[ia] = (box_i_x * box_ny + box_i_y) * box_nz + box_i_z;
+        ++this->box_start[ibox_of_atom[ia] + 1];
     }
-    for (int ix = -glayerX_minus; ix < glayerX; ix++)
+    for (std::size_t ib = 1; ib < this->box_start.size(); ib++)
     {
-        for (int iy = -glayerY_minus; iy < glayerY; iy++)
-        {
-            for (int iz = -glayerZ_minus; iz < glayerZ; iz++)
-            {
-                for (int i = 0; i < ucell.ntype; i++)
-                {
-                    for (int j = 0; j < ucell.atoms[i].na; j++)
-                    {
-                        double x = ucell.atoms[i].tau[j].x + vec1[0] * ix + vec2[0] * iy + vec3[0] * iz;
-                        double y = ucell.atoms[i].tau[j].y + vec1[1] * ix + vec2[1] * iy + vec3[1] * iz;
-                        double z = ucell.atoms[i].tau[j].z + vec1[2] * ix + vec2[2] * iy + vec3[2] * iz;
-                        FAtom atom(x, y, z, i, j, ix, iy, iz);
-                        int box_i_x, box_i_y, box_i_z;
-                        //this->getBox(box_i_x, box_i_y, box_i_z, x, y, z);
-                        box_i_x = ix + glayerX_minus;
-                        box_i_y = iy + glayerY_minus;
-                        box_i_z = iz + glayerZ_minus;
-                        this->atoms_in_box[box_i_x][box_i_y][box_i_z].push_back(atom);
-                    }
-                }
-            }
-        }
+        this->box_start[ib] += this->box_start[ib - 1];
     }
-    
-    this->all_adj_info.resize(ucell.ntype);
-    for (int i = 0; i < ucell.ntype; i++)
+    this->box_atoms.resize(natom_search);
+    std::vector<int> box_fill(this->box_start.begin(), this->box_start.end() - 1);
+    for (int ia = 0; ia < natom_search; ia++)
     {
-        this->all_adj_info[i].resize(ucell.atoms[i].na);
+        this->box_atoms[box_fill[ibox_of_atom[ia]]++] = ia;
     }
+    ModuleBase::Memory::record("Grid::atoms_in_search",
+                               sizeof(FAtom) * this->atoms_in_search.size()
+                                   + sizeof(int) * (this->box_start.size() + this->box_atoms.size()));
 }
 
 void Grid::Construct_Adjacent(const UnitCell& ucell)
 {
     ModuleBase::timer::tick("Grid", "constru_adj");
 
-    for  (int i_type = 0; i_type < ucell.ntype; i_type++)
+    const int nat = this->type_start[ucell.ntype];
+    this->adj_start.assign(nat + 1, 0);
+    this->adj_atoms.clear();
+
+    // Each thread searches the adjacent atoms of a continuous range of atoms, then the lists of all the
+    // threads are joined in the order of atoms.
+#pragma omp parallel
     {
-        for (int j_atom = 0; j_atom < ucell.atoms[i_type].na; j_atom++)
+        int ithread = 0;
+        int nthread = 1;
+#ifdef _OPENMP
+        ithread = omp_get_thread_num();
+        nthread = omp_get_num_threads();
+#endif
+        const int iat_begin = static_cast<long long>(nat) * ithread / nthread;
+        const int iat_end = static_cast<long long>(nat) * (ithread + 1) / nthread;
+        std::vector<int> adj_local;
+        int i_type = std::upper_bound(this->type_start.begin(), this->type_start.end(), iat_begin)
+                     - this->type_start.begin() - 1;
+        for (int iat = iat_begin; iat < iat_end; iat++)
         {
-
-            FAtom atom(ucell.atoms[i_type].tau[j_atom].x,
-                     ucell.atoms[i_type].tau[j_atom].y,
-                     ucell.atoms[i_type].tau[j_atom].z,
-                     i_type,
-                     j_atom,
-                     0, 0 ,0);
-
-            this->Construct_Adjacent_near_box(atom);
+            while (iat >= this->type_start[i_type + 1])
+            {
+                ++i_type;
+            }
+            const int j_atom = iat - this->type_start[i_type];
+            const std::size_t adj_num_before = adj_local.size();
+            this->Construct_Adjacent_near_box(ucell.atoms[i_type].tau[j_atom], adj_local);
+            this->adj_start[iat + 1] = adj_local.size() - adj_num_before;
+        }
+#pragma omp barrier
+#pragma omp single
+        {
+            for (int iat = 0; iat < nat; iat++)
+            {
+                this->adj_start[iat + 1] += this->adj_start[iat];
+            }
+            this->adj_atoms.resize(this->adj_start[nat]);
         }
+        std::copy(adj_local.begin(), adj_local.end(), this->adj_atoms.begin() + this->adj_start[iat_begin]);
     }
+    ModuleBase::Memory::record("Grid::adj_atoms", sizeof(int) * (this->adj_start.size() + this->adj_atoms.size()));
     ModuleBase::timer::tick("Grid", "constru_adj");
 }
 
-void Grid::Construct_Adjacent_near_box(const FAtom& fatom)
+void Grid::Construct_Adjacent_near_box(const ModuleBase::Vector3<double>& tau, std::vector<int>& adj) const
 {
-    ModuleBase::timer::tick("Grid", "adj_near_box");
     int box_i_x=0;
     int box_i_y=0;
     int box_i_z=0;
-    this->getBox(box_i_x, box_i_y, box_i_z, fatom.x, fatom.y, fatom.z);
+    this->getBox(box_i_x, box_i_y, box_i_z, tau.x, tau.y, tau.z);
 
-    for (int box_i_x_adj = 0; box_i_x_adj < glayerX + glayerX_minus; box_i_x_adj++)
+    const std::size_t adj_num_before = adj.size();
+    // the edge of boxes is not shorter than sradius, so only the nearest boxes are visited
+    for (int box_i_x_adj = std::max(box_i_x - 1, 0); box_i_x_adj <= std::min(box_i_x + 1, box_nx - 1); box_i_x_adj++)
     {
-        for (int box_i_y_adj = 0; box_i_y_adj < glayerY + glayerY_minus; box_i_y_adj++)
+        for (int box_i_y_adj = std::max(box_i_y - 1, 0); box_i_y_adj <= std::min(box_i_y + 1, box_ny - 1); box_i_y_adj++)
         {
-            for (int box_i_z_adj = 0; box_i_z_adj < glayerZ + glayerZ_minus; box_i_z_adj++)
+            for (int box_i_z_adj = std::max(box_i_z - 1, 0); box_i_z_adj <= std::min(box_i_z + 1, box_nz - 1); box_i_z_adj++)
             {
-                for (auto &fatom2 : this->atoms_in_box[box_i_x_adj][box_i_y_adj][box_i_z_adj])
+                const int ib = (box_i_x_adj * box_ny + box_i_y_adj) * box_nz + box_i_z_adj;
+                for (int i = this->box_start[ib]; i < this->box_start[ib + 1]; i++)
                 {
-                    this->Construct_Adjacent_final(fatom, &fatom2);
+                    this->Construct_Adjacent_final(tau, this->box_atoms[i], adj);
                 }
             }
         }
     }
-    ModuleBase::timer::tick("Grid", "adj_near_box");
+    // keep the order of atoms_in_search, which the former search over all the atoms gave
+    std::sort(adj.begin() + adj_num_before, adj.end());
 }
 
-void Grid::Construct_Adjacent_final(const FAtom& fatom1,
-                                    FAtom* fatom2)
+void Grid::Construct_Adjacent_final(const ModuleBase::Vector3<double>& tau,
+                                    const int iatom2,
+                                    std::vector<int>& adj) const
 {
-    double delta_x = fatom1.x - fatom2->x;
-    double delta_y = fatom1.y - fatom2->y;
-    double delta_z = fatom1.z - fatom2->z;
+    const FAtom& fatom2 = this->atoms_in_search[iatom2];
+    double delta_x = tau.x - fatom2.x;
+    double delta_y = tau.y - fatom2.y;
+    double delta_z = tau.z - fatom2.z;
 
     double dr = delta_x * delta_x + delta_y * delta_y + delta_z * delta_z;
 
@@ -327,6 +531,6 @@ void Grid::Construct_Adjacent_final(const FAtom& fatom1,
     // I dont know why, but if we add self here, test 701_LJ_MD_Anderson will assert
     if (dr != 0.0 && dr <= this->sradius2)
     {
-        all_adj_info[fatom1.type][fatom1.natom].push_back(fatom2);
+        adj.push_back(iatom2);
     }
 }
@@ -10,8 +10,6 @@
 #include <tuple>
 #include <unordered_map>
 
-typedef std::vector<FAtom> AtomMap;
-
 class Grid
 {
   public:
@@ -23,12 +21,24 @@ class Grid
 
     Grid& operator=(Grid&&) = default;
 
-    void init(std::ofstream& ofs, const UnitCell& ucell, const double radius_in, const bool boundary = true);
+    // With skin_in > 0, the adjacent atoms within radius_in + skin_in are kept as candidates (Verlet list).
+    // The next init() only refreshes the positions and selects the adjacent atoms from the candidates,
+    // until one of the atoms moves more than skin_in / 2 since the last build.
+    void init(std::ofstream& ofs,
+              const UnitCell& ucell,
+              const double radius_in,
+              const bool boundary = true,
+              const double skin_in = 0.0);
 
     // Data
     bool pbc=false; // When pbc is set to false, periodic boundary conditions are explicitly ignored.
     double sradius2=0.0; // searching radius squared (unit:lat0)
     double sradius=0.0;  // searching radius (unit:lat0)
+    double skin=0.0;     // Verlet skin of the candidates of adjacent atoms (unit:lat0)
+
+    // number of times the adjacent atoms are built from scratch and reused from the candidates
+    int nbuild=0;
+    int nreuse=0;
     
     // coordinate range of the input atom (unit:lat0)
     double x_min=0.0;
@@ -38,37 +48,50 @@ class Grid
     double y_max=0.0;
     double z_max=0.0;
 
-    // The algorithm for searching neighboring atoms uses a "box" partitioning method. 
-    // Each box has an edge length of sradius, and the number of boxes in each direction is recorded here.
+    // The algorithm for searching neighboring atoms uses a "box" partitioning method.
+    // Each box has an edge length of at least sradius, so the adjacent atoms are in the 27 boxes around the atom,
+    // and the number of boxes in each direction is recorded here.
     double box_edge_length=0.0;
     int box_nx=0;
     int box_ny=0;
     int box_nz=0;
 
-    void getBox(int& bx, int& by, int& bz, const double& x, const double& y, const double& z)
+    void getBox(int& bx, int& by, int& bz, const double& x, const double& y, const double& z) const
     {
         bx = std::floor((x - x_min) / box_edge_length);
         by = std::floor((y - y_min) / box_edge_length);
         bz = std::floor((z - z_min) / box_edge_length);
     }
-    // Stores the atoms after box partitioning.
-    std::vector<std::vector<std::vector<AtomMap>>> atoms_in_box;
+    // Stores the atoms in the unitcell and their periodic images within sradius of the unitcell atoms,
+    // in the order of (image x, image y, image z, type, atom).
+    std::vector<FAtom> atoms_in_search;
+    // Stores the atoms after box partitioning in CSR format, the atoms in box ib = (bx * box_ny + by) * box_nz + bz
+    // are atoms_in_search[box_atoms[i]] for box_start[ib] <= i < box_start[ib + 1].
+    std::vector<int> box_start;
+    std::vector<int> box_atoms;
 
-    // Stores the adjacent information of atoms. [ntype][natom][adj list]
-    std::vector<std::vector< std::vector<FAtom *> >> all_adj_info;
+    // Stores the adjacent information of atoms in CSR format, the adjacent atoms of atom ia of type it
+    // are atoms_in_search[adj_atoms[i]] for adj_start[iat] <= i < adj_start[iat + 1], iat = type_start[it] + ia.
+    std::vector<int> type_start;
+    std::vector<int> adj_start;
+    std::vector<int> adj_atoms;
     void clear_atoms()
     {
-        // we have to clear the all_adj_info
-        // because the pointers point to the memory in vector atoms_in_box
-        all_adj_info.clear();
+        // we have to clear the adjacent information
+        // because the indexes point to the atoms in atoms_in_search
+        this->clear_adj_info();
 
-        atoms_in_box.clear();
+        atoms_in_search.clear();
+        box_start.clear();
+        box_atoms.clear();
     }
     void clear_adj_info()
     {
-        // here dont need to free the memory, 
-        // because the pointers point to the memory in vector atoms_in_box
-        all_adj_info.clear();
+        type_start.clear();
+        adj_start.clear();
+        adj_atoms.clear();
+        skin_adj_start.clear();
+        skin_adj_atoms.clear();
     }
     int getGlayerX() const
     {
@@ -100,8 +123,28 @@ class Grid
     void setMemberVariables(std::ofstream& ofs_in, const UnitCell& ucell);
 
     void Construct_Adjacent(const UnitCell& ucell);
-    void Construct_Adjacent_near_box(const FAtom& fatom);
-    void Construct_Adjacent_final(const FAtom& fatom1, FAtom* fatom2);
+    // append the adjacent atoms of the atom at tau to adj, in the order of atoms_in_search
+    void Construct_Adjacent_near_box(const ModuleBase::Vector3<double>& tau, std::vector<int>& adj) const;
+    void Construct_Adjacent_final(const ModuleBase::Vector3<double>& tau, const int iatom2, std::vector<int>& adj) const;
+
+    // The candidates of adjacent atoms within sradius + skin at the last build, in the same format as adj_start/adj_atoms,
+    // and the positions of the unitcell atoms and the lattice at the last build.
+    std::vector<int> skin_adj_start;
+    std::vector<int> skin_adj_atoms;
+    std::vector<ModuleBase::Vector3<double>> tau_build;
+    ModuleBase::Matrix3 latvec_build;
+
+    // whether the candidates of the last build contain all the adjacent atoms,
+    // max_move is the largest displacement of the atoms since the last build (unit:lat0)
+    bool Check_Reuse_Condition(const UnitCell& ucell,
+                               const double radius_in,
+                               const bool boundary,
+                               const double skin_in,
+                               double& max_move) const;
+    // update the positions of atoms_in_search to the atoms in ucell
+    void Refresh_Atoms(const UnitCell& ucell);
+    // select the atoms within sradius from the candidates into adj_start/adj_atoms
+    void Select_Adjacent(const UnitCell& ucell);
 
     void Check_Expand_Condition(const UnitCell& ucell);
     int glayerX=0;
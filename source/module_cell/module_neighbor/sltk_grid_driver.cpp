@@ -33,14 +33,15 @@ void Grid_Driver::Find_atom(const UnitCell& ucell,
     // store result in member adj_info when parameter adjs is NULL
     AdjacentAtomInfo* local_adjs = adjs == nullptr ? &this->adj_info : adjs;
     local_adjs->clear();
-    const std::vector<FAtom*>& all_atom = all_adj_info[ntype][nnumber];
+    const int iat = type_start[ntype] + nnumber;
 
-    for (const FAtom* atom: all_atom)
+    for (int i = adj_start[iat]; i < adj_start[iat + 1]; i++)
     {
-        local_adjs->ntype.push_back(atom->type);
-        local_adjs->natom.push_back(atom->natom);
-        local_adjs->box.push_back(ModuleBase::Vector3<int>(atom->cell_x, atom->cell_y, atom->cell_z));
-        local_adjs->adjacent_tau.push_back(ModuleBase::Vector3<double>(atom->x, atom->y, atom->z));
+        const FAtom& atom = atoms_in_search[adj_atoms[i]];
+        local_adjs->ntype.push_back(atom.type);
+        local_adjs->natom.push_back(atom.natom);
+        local_adjs->box.push_back(ModuleBase::Vector3<int>(atom.cell_x, atom.cell_y, atom.cell_z));
+        local_adjs->adjacent_tau.push_back(ModuleBase::Vector3<double>(atom.x, atom.y, atom.z));
         local_adjs->adj_num++;
     }
     // 20241204 zhanghaochong
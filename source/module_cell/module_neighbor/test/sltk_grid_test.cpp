@@ -7,6 +7,9 @@
 #include "module_parameter/parameter.h"
 #undef private
 #include "module_cell/read_stru.h"
+
+#include <chrono>
+#include <random>
 #ifdef __LCAO
 InfoNonlocal::InfoNonlocal()
 {
@@ -43,6 +46,11 @@ Magnetism::~Magnetism()
  *       (like dx, dy, dz and d_minX, d_minY, d_minZ) by
  *       reading from getters of Atom_input, and construct the
  *       member Cell as a 3D array of CellSet
+ *   - Construct_Adjacent: the adjacent atoms found in the boxes are the same as
+ *     those of the search over all the atoms, in the same order
+ *   - the cost of Grid::init() scales linearly with the number of atoms, 1k to 100k atoms
+ *   - Verlet skin: the adjacent atoms selected from the candidates of the last build in an MD-like run
+ *     are the same as those searched every step, and the lists are rebuilt once an atom moves more than skin / 2
  */
 
 void SetGlobalV()
@@ -70,6 +78,22 @@ class SltkGridTest : public testing::Test
     {
         delete ucell;
     }
+    // a cubic cell of natom random atoms of the first type, one atom per lat0^3
+    void set_random_cell(const int natom)
+    {
+        const double a = std::cbrt(static_cast<double>(natom));
+        ucell->latvec = ModuleBase::Matrix3(a, 0, 0, 0, a, 0, 0, 0, a);
+        ucell->omega = a * a * a * ucell->lat0 * ucell->lat0 * ucell->lat0;
+        ucell->nat = natom;
+        ucell->atoms[0].na = natom;
+        ucell->atoms[0].tau.resize(natom);
+        std::mt19937 gen(1);
+        std::uniform_real_distribution<double> dis(0.0, a);
+        for (auto& tau: ucell->atoms[0].tau)
+        {
+            tau = ModuleBase::Vector3<double>(dis(gen), dis(gen), dis(gen));
+        }
+    }
 };
 
 using SltkGridDeathTest = SltkGridTest;
@@ -122,6 +146,161 @@ TEST_F(SltkGridTest, InitSmall)
     remove("test.out");
 }
 
+TEST_F(SltkGridTest, AdjacentSameAsAllAtoms)
+{
+    ofs.open("test.out");
+    set_random_cell(1000);
+    radius = 2.5;
+    Grid LatGrid(0);
+    LatGrid.init(ofs, *ucell, radius, pbc);
+
+    const ModuleBase::Matrix3& latvec = ucell->latvec;
+    long long adj_num_total = 0;
+    for (int ia = 0; ia < ucell->atoms[0].na; ia++)
+    {
+        // all the atoms in all the periodic images
+        std::vector<std::vector<int>> adj_ref;
+        for (int ix = -LatGrid.getGlayerX_minus(); ix < LatGrid.getGlayerX(); ix++)
+        {
+            for (int iy = -LatGrid.getGlayerY_minus(); iy < LatGrid.getGlayerY(); iy++)
+            {
+                for (int iz = -LatGrid.getGlayerZ_minus(); iz < LatGrid.getGlayerZ(); iz++)
+                {
+                    const ModuleBase::Vector3<double> R = ModuleBase::Vector3<double>(ix, iy, iz) * latvec;
+                    for (int ja = 0; ja < ucell->atoms[0].na; ja++)
+                    {
+                        const double dr2 = (ucell->atoms[0].tau[ja] + R - ucell->atoms[0].tau[ia]).norm2();
+                        if (dr2 != 0.0 && dr2 <= radius * radius)
+                        {
+                            adj_ref.push_back({0, ja, ix, iy, iz});
+                        }
+                    }
+                }
+            }
+        }
+        const int iat = LatGrid.type_start[0] + ia;
+        std::vector<std::vector<int>> adj;
+        for (int i = LatGrid.adj_start[iat]; i < LatGrid.adj_start[iat + 1]; i++)
+        {
+            const FAtom& atom = LatGrid.atoms_in_search[LatGrid.adj_atoms[i]];
+            adj.push_back({atom.type, atom.natom, atom.cell_x, atom.cell_y, atom.cell_z});
+        }
+        EXPECT_EQ(adj, adj_ref);
+        adj_num_total += adj.size();
+    }
+    // about 4/3 pi r^3 adjacent atoms
+    EXPECT_NEAR(static_cast<double>(adj_num_total) / ucell->atoms[0].na, 4.0 / 3.0 * ModuleBase::PI * 15.625, 5.0);
+    ofs.close();
+    remove("test.out");
+}
+
+TEST_F(SltkGridTest, CostScaling)
+{
+    ofs.open("test.out");
+    radius = 2.5;
+    for (const int natom: {1000, 10000, 100000})
+    {
+        set_random_cell(natom);
+        Grid LatGrid(0);
+        auto t0 = std::chrono::high_resolution_clock::now();
+        LatGrid.init(ofs, *ucell, radius, pbc);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        const double time = std::chrono::duration_cast<std::chrono::duration<double>>(t1 - t0).count();
+        const double adj_num = static_cast<double>(LatGrid.adj_atoms.size()) / natom;
+        EXPECT_NEAR(adj_num, 4.0 / 3.0 * ModuleBase::PI * 15.625, 5.0);
+        std::cout << "atoms: " << natom << ", atoms in search: " << LatGrid.atoms_in_search.size()
+                  << ", adjacent atoms per atom: " << adj_num << ", Grid::init " << time << " s, "
+                  << time / natom * 1e6 << " us per atom" << std::endl;
+    }
+    ofs.close();
+    remove("test.out");
+}
+
+TEST_F(SltkGridTest, VerletSkin)
+{
+    ofs.open("test.out");
+    const int natom = 4000;
+    set_random_cell(natom);
+    radius = 2.5;
+    const double skin = 0.5;
+    const int nstep = 20;
+    // the atoms move along random directions, by 0.06 each step at most
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<double> dis(-0.035, 0.035);
+    std::vector<ModuleBase::Vector3<double>> vel(natom);
+    for (auto& v: vel)
+    {
+        v = ModuleBase::Vector3<double>(dis(gen), dis(gen), dis(gen));
+    }
+    auto get_adj = [](const Grid& grid, const int iat) {
+        std::vector<std::vector<double>> adj;
+        for (int i = grid.adj_start[iat]; i < grid.adj_start[iat + 1]; i++)
+        {
+            const FAtom& atom = grid.atoms_in_search[grid.adj_atoms[i]];
+            adj.push_back({static_cast<double>(atom.type),
+                           static_cast<double>(atom.natom),
+                           static_cast<double>(atom.cell_x),
+                           static_cast<double>(atom.cell_y),
+                           static_cast<double>(atom.cell_z),
+                           atom.x,
+                           atom.y,
+                           atom.z});
+        }
+        return adj;
+    };
+
+    Grid grid_skin(0);
+    double time_skin = 0.0;
+    double time_reuse = 0.0;
+    double time_search = 0.0;
+    std::vector<ModuleBase::Vector3<double>> tau_build = ucell->atoms[0].tau;
+    for (int istep = 0; istep < nstep; istep++)
+    {
+        double max_move = 0.0;
+        for (int ia = 0; ia < natom; ia++)
+        {
+            max_move = std::max(max_move, (ucell->atoms[0].tau[ia] - tau_build[ia]).norm());
+        }
+        auto t0 = std::chrono::high_resolution_clock::now();
+        const int nbuild_last = grid_skin.nbuild;
+        grid_skin.init(ofs, *ucell, radius, pbc, skin);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        Grid grid_search(0);
+        grid_search.init(ofs, *ucell, radius, pbc);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        time_skin += std::chrono::duration_cast<std::chrono::duration<double>>(t1 - t0).count();
+        time_search += std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+
+        // rebuilt if and only if an atom moved more than skin / 2
+        EXPECT_EQ(grid_skin.nbuild > nbuild_last, istep == 0 || max_move > skin / 2);
+        if (grid_skin.nbuild > nbuild_last)
+        {
+            tau_build = ucell->atoms[0].tau;
+        }
+        else
+        {
+            time_reuse += std::chrono::duration_cast<std::chrono::duration<double>>(t1 - t0).count();
+        }
+        for (int iat = 0; iat < natom; iat++)
+        {
+            EXPECT_EQ(get_adj(grid_skin, iat), get_adj(grid_search, iat));
+        }
+
+        for (int ia = 0; ia < natom; ia++)
+        {
+            ucell->atoms[0].tau[ia] += vel[ia];
+        }
+    }
+    EXPECT_EQ(grid_skin.nbuild + grid_skin.nreuse, nstep);
+    EXPECT_GT(grid_skin.nreuse, 0);
+    std::cout << "atoms: " << natom << ", steps: " << nstep << ", builds: " << grid_skin.nbuild
+              << ", reuses: " << grid_skin.nreuse << ", search every step " << time_search / nstep
+              << " s per step, with skin " << time_skin / nstep << " s per step, "
+              << time_reuse / grid_skin.nreuse << " s per reuse" << std::endl;
+    ofs.close();
+    remove("test.out");
+}
+
 /*
 // This test cannot pass because setAtomLinkArray() is unsuccessful
 // if expand_flag is false
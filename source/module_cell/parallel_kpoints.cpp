@@ -9,7 +9,8 @@ void Parallel_Kpoints::kinfo(int& nkstot_in,
                              const int& my_pool_in,
                              const int& rank_in_pool_in,
                              const int& nproc_in,
-                             const int& nspin_in)
+                             const int& nspin_in,
+                             const std::vector<double>& cost)
 {
 #ifdef __MPI
 
@@ -20,12 +21,19 @@ void Parallel_Kpoints::kinfo(int& nkstot_in,
     this->nspin = nspin_in;
 
     Parallel_Common::bcast_int(nkstot_in);
+    this->set_startpro_pool(); // get the start processor index for each pool
+
     this->get_nks_pool(nkstot_in);    // assign k-points to each pool
+    if (!cost.empty())
+    {
+        std::vector<double> cost_k(cost);
+        cost_k.resize(nkstot_in, 0.0);
+        Parallel_Common::bcast_double(cost_k.data(), nkstot_in);
+        this->balance_nks_pool(cost_k);
+    }
     this->get_startk_pool(nkstot_in); // get the start k-point index for each pool
     this->get_whichpool(nkstot_in);   // get the pool index for each k-point
 
-    this->set_startpro_pool(); // get the start processor index for each pool
-
     this->nkstot_np = nkstot_in;
 
     this->nks_np = this->nks_pool[this->my_pool]; // number of k-points in this pool
@@ -89,6 +97,82 @@ void Parallel_Kpoints::get_nks_pool(const int& nkstot)
     return;
 }
 
+void Parallel_Kpoints::balance_nks_pool(const std::vector<double>& cost)
+{
+    const int nkstot = cost.size();
+    if (this->kpar <= 1 || nkstot < this->kpar)
+    {
+        return;
+    }
+    std::vector<double> nproc_pool(this->kpar);
+    for (int i = 0; i < this->kpar; i++)
+    {
+        const int end = (i + 1 < this->kpar) ? startpro_pool[i + 1] : this->nproc;
+        nproc_pool[i] = end - startpro_pool[i];
+    }
+
+    // the pools in their order take contiguous blocks of k-points, each one as many k-points as it can
+    // within the time t, leaving one k-point at least for each of the next pools.
+    // it returns false if some k-points are left after the last pool.
+    std::vector<int> nks_try(this->kpar);
+    auto fill_pools = [&](const double t) {
+        int ik = 0;
+        for (int i = 0; i < this->kpar; i++)
+        {
+            const int ik_max = nkstot - (this->kpar - 1 - i);
+            const double cost_max = t * nproc_pool[i];
+            double sum = cost[ik];
+            int nk = 1;
+            while (ik + nk < ik_max && sum + cost[ik + nk] <= cost_max)
+            {
+                sum += cost[ik + nk];
+                nk++;
+            }
+            nks_try[i] = nk;
+            ik += nk;
+        }
+        return ik == nkstot;
+    };
+
+    // bisection of the time of the slowest pool
+    double total = 0.0;
+    for (const double& c: cost)
+    {
+        total += c;
+    }
+    double t_low = 0.0;
+    double t_high = total;
+    for (int iter = 0; iter < 100 && t_high - t_low > 1e-8 * t_high; iter++)
+    {
+        const double t = 0.5 * (t_low + t_high);
+        if (fill_pools(t))
+        {
+            t_high = t;
+        }
+        else
+        {
+            t_low = t;
+        }
+    }
+    fill_pools(t_high);
+
+    std::vector<int> nks_even = this->nks_pool;
+    const double imbalance_even = this->get_imbalance(cost);
+    this->nks_pool = nks_try;
+    const double imbalance = this->get_imbalance(cost);
+    // keep the even distribution if the gain is marginal, e.g. for the k-points of the same cost
+    if (imbalance > 0.99 * imbalance_even)
+    {
+        this->nks_pool = nks_even;
+    }
+
+    ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "k-point imbalance of the even distribution", imbalance_even);
+    ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running,
+                                "k-point imbalance of the pools",
+                                this->get_imbalance(cost));
+    return;
+}
+
 void Parallel_Kpoints::get_startk_pool(const int& nkstot)
 {
     startk_pool.resize(this->kpar, 0);
@@ -147,6 +231,29 @@ void Parallel_Kpoints::gatherkvec(const std::vector<ModuleBase::Vector3<double>>
 }
 #endif
 
+double Parallel_Kpoints::get_imbalance(const std::vector<double>& cost) const
+{
+    if (this->kpar <= 1 || static_cast<int>(this->nks_pool.size()) != this->kpar)
+    {
+        return 1.0;
+    }
+    double total = 0.0;
+    double t_max = 0.0;
+    int ik = 0;
+    for (int i = 0; i < this->kpar; i++)
+    {
+        const int end = (i + 1 < this->kpar) ? startpro_pool[i + 1] : this->nproc;
+        double sum = 0.0;
+        for (int k = 0; k < this->nks_pool[i]; k++)
+        {
+            sum += cost[ik++];
+        }
+        total += sum;
+        t_max = std::max(t_max, sum / (end - startpro_pool[i]));
+    }
+    return (total > 0.0) ? t_max * this->nproc / total : 1.0;
+}
+
 void Parallel_Kpoints::pool_collection(double& value, const double* wk, const int& ik)
 {
 #ifdef __MPI
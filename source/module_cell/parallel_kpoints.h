@@ -12,12 +12,20 @@ class Parallel_Kpoints
     Parallel_Kpoints(){};
     ~Parallel_Kpoints(){};
 
+    /**
+     * @brief assign the k-points to the pools, each pool has a contiguous block of k-points
+     *
+     * @param cost the estimated cost of each k-point, only the values of rank 0 are used,
+     *        it is empty or not on all the processes. If it is empty, each pool has nkstot / kpar k-points (the remainder to the first pools);
+     *        otherwise the blocks minimize the time of the slowest pool, cost / (processes of the pool).
+     */
     void kinfo(int& nkstot_in,
                const int& kpar_in,
                const int& my_pool_in,
                const int& rank_in_pool_in,
                const int& nproc_in,
-               const int& nspin_in);
+               const int& nspin_in,
+               const std::vector<double>& cost = {});
 
     // collect value from each pool to wk.
     void pool_collection(double& value, const double* wk, const int& ik);
@@ -62,6 +70,13 @@ class Parallel_Kpoints
         return startpro_pool[pool];
     }
 
+    /**
+     * @brief the load imbalance of the pools for a cost of each k-point:
+     * the time of the slowest pool, sum of cost / (processes of the pool), divided by the time of
+     * a perfect balance, sum of cost / nproc. It is 1 if the pools are balanced.
+     */
+    double get_imbalance(const std::vector<double>& cost) const;
+
     // get the maximum number of k-points in all pools
     int get_max_nks_pool() const
     {
@@ -80,6 +95,8 @@ class Parallel_Kpoints
     void get_nks_pool(const int& nkstot);
     void get_startk_pool(const int& nkstot);
     void get_whichpool(const int& nkstot);
+    // replace nks_pool by the blocks minimizing the time of the slowest pool, if it is better
+    void balance_nks_pool(const std::vector<double>& cost);
 
     void set_startpro_pool();
 #endif
@@ -130,6 +130,7 @@ Parallel_Kpoints Pkpoints;
  *     - IbzKpoint: generate IBZ kpoints
  *     - IbzKpointIsMP: generate IBZ kpoints for non-symmetry
  *       and Monkhorst-Pack case
+ *     - IbzKpointDenseMesh: generate IBZ kpoints of a 40x40x40 mesh
  */
 
 // abbriviated from module_symmetry/test/symmetry_test.cpp
@@ -779,3 +780,36 @@ TEST_F(KlistTest, IbzKpointIsMP)
     ClearUcell();
     remove("tmp_klist_4");
 }
+
+TEST_F(KlistTest, IbzKpointDenseMesh)
+{
+    // construct cell and symmetry
+    ModuleSymmetry::Symmetry symm;
+    construct_ucell(stru_lib[0]);
+    GlobalV::ofs_running.open("tmp_klist_5");
+    symm.analy_sys(ucell.lat, ucell.st, ucell.atoms, GlobalV::ofs_running);
+    // a dense Gamma-centered mesh, as for DOS and Fermi surfaces
+    std::ofstream kpt("tmp_KPT_dense");
+    kpt << "K_POINTS\n0\nGamma\n40 40 40 0 0 0\n";
+    kpt.close();
+    kv->nspin = 1;
+    kv->read_kpoints(ucell, "tmp_KPT_dense");
+    EXPECT_EQ(kv->get_nkstot(), 64000);
+    // calculate ibz_kpoint
+    std::string skpt;
+    ModuleSymmetry::Symmetry::symm_flag = 1;
+    bool match = true;
+    kv->ibz_kpoint(symm, ModuleSymmetry::Symmetry::symm_flag, skpt, ucell, match);
+    // the irreducible wedge of O_h of an even Gamma-centered mesh n: (n/2+1)(n/2+2)(n/2+3)/6 points
+    EXPECT_EQ(kv->get_nkstot(), 1771);
+    double sum = 0.0;
+    for (int ik = 0; ik < kv->get_nkstot(); ++ik)
+    {
+        sum += kv->wk[ik];
+    }
+    EXPECT_NEAR(sum, 1.0, 1e-10);
+    GlobalV::ofs_running.close();
+    ClearUcell();
+    remove("tmp_klist_5");
+    remove("tmp_KPT_dense");
+}
@@ -24,6 +24,7 @@
 #include "module_hamilt_pw/hamilt_pwdft/parallel_grid.h"
 #include "module_io/berryphase.h"
 #undef private
+#include "module_basis/module_pw/pw_basis_k.h"
 bool berryphase::berry_phase_flag = false;
 
 pseudo::pseudo()
@@ -109,6 +110,8 @@ UnitCell ucell;
  *       KPAR > 1 is not support yet in vc-relax calculation
  *       due to the size of kvec_d, kvec_c being nks, rather
  *       than nkstot in set_both_kvec_after_vc
+ *   - CountPlanewaves
+ *     - count_planewaves() gives the npwk of PW_Basis_K on a small mesh
  */
 
 // abbriviated from module_symmetry/test/symmetry_test.cpp
@@ -326,6 +329,42 @@ TEST_F(KlistParaTest, SetAfterVC)
     }
 }
 
+TEST_F(KlistParaTest, CountPlanewaves)
+{
+    // a triclinic cell and k points in general positions, no |k+G|^2 on the cutoff sphere
+    const double lat0 = 5.0;
+    const double ecutwfc = 20.0;
+    const ModuleBase::Matrix3 latvec(1.0, 0.1, 0.0, 0.2, 1.1, 0.0, 0.1, 0.3, 1.3);
+    const ModuleBase::Matrix3 G = latvec.Inverse().Transpose();
+    const double tpiba2 = ModuleBase::TWO_PI * ModuleBase::TWO_PI / lat0 / lat0;
+    std::vector<ModuleBase::Vector3<double>> kvec_d = {ModuleBase::Vector3<double>(0.0, 0.0, 0.0),
+                                                       ModuleBase::Vector3<double>(0.25, 0.1, -0.3),
+                                                       ModuleBase::Vector3<double>(0.5, 0.5, 0.5),
+                                                       ModuleBase::Vector3<double>(-0.37, 0.41, 0.13)};
+    const int nks = kvec_d.size();
+    std::vector<ModuleBase::Vector3<double>> kvec_c(nks);
+    for (int ik = 0; ik < nks; ++ik)
+    {
+        kvec_c[ik] = kvec_d[ik] * G;
+    }
+
+    // the npwk of a pool with one process
+    ModulePW::PW_Basis_K pwk("cpu", "double");
+    pwk.initmpi(1, 0, MPI_COMM_SELF);
+    pwk.initgrids(lat0, latvec, 4 * ecutwfc);
+    pwk.initparameters(false, ecutwfc, nks, kvec_d.data());
+    pwk.setuptransform();
+    pwk.collect_local_pw();
+
+    const std::vector<double> ngk = K_Vectors::count_planewaves(kvec_c, nks, G, latvec, ecutwfc / tpiba2);
+    ASSERT_EQ(ngk.size(), nks);
+    for (int ik = 0; ik < nks; ++ik)
+    {
+        EXPECT_GT(pwk.npwk[ik], 0);
+        EXPECT_EQ(ngk[ik], static_cast<double>(pwk.npwk[ik]));
+    }
+}
+
 int main(int argc, char** argv)
 {
     MPI_Init(&argc, &argv);
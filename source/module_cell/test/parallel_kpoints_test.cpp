@@ -21,6 +21,9 @@
  *      into KPAR groups.
  *   iii.Parallel_Kpoints::gatherkvec() is an interface to gather kpoints
  *      vectors from all processors.
+ *   iv.Parallel_Kpoints::kinfo() with a cost of each kpoint, which gives
+ *      the pools contiguous blocks of kpoints balancing the cost, and
+ *      Parallel_Kpoints::get_imbalance().
  * The default number of processes is set to 4 in parallel_kpoints_test.sh.
  * One may modify it to do more tests, or adapt this unittest to local
  * environment.
@@ -259,6 +262,63 @@ TEST_P(ParaKpoints, DividePools)
     delete Pkpoints;
 }
 
+TEST_P(ParaKpoints, BalancedPools)
+{
+    ParaPrepare pp = GetParam();
+    mpi.KPAR = pp.KPAR_;
+    if (mpi.KPAR > NPROC)
+    {
+        return;
+    }
+    Parallel_Global::divide_mpi_groups(this->NPROC,
+                                       mpi.KPAR,
+                                       this->MY_RANK,
+                                       mpi.NPROC_IN_POOL,
+                                       mpi.MY_POOL,
+                                       mpi.RANK_IN_POOL);
+
+    // the same cost for all the kpoints and the same number of processes in all the pools
+    // give the even distribution
+    std::vector<double> cost(pp.nkstot_, 1000.0);
+    if (this->NPROC % mpi.KPAR == 0)
+    {
+        Parallel_Kpoints uniform;
+        uniform.kinfo(pp.nkstot_, mpi.KPAR, mpi.MY_POOL, mpi.RANK_IN_POOL, this->NPROC, 1, cost);
+        pp.test_kinfo(&uniform);
+    }
+
+    // the first third of the kpoints are 4 times more expensive, as the kpoints with more plane waves.
+    // only the cost of rank 0 is used.
+    Parallel_Kpoints even, balanced;
+    for (int ik = 0; ik < pp.nkstot_; ik++)
+    {
+        cost[ik] = (ik < pp.nkstot_ / 3) ? 4.0 : 1.0;
+    }
+    std::vector<double> cost_local = (this->MY_RANK == 0) ? cost : std::vector<double>(1, 0.0);
+    even.kinfo(pp.nkstot_, mpi.KPAR, mpi.MY_POOL, mpi.RANK_IN_POOL, this->NPROC, 1);
+    balanced.kinfo(pp.nkstot_, mpi.KPAR, mpi.MY_POOL, mpi.RANK_IN_POOL, this->NPROC, 1, cost_local);
+
+    int nk = 0;
+    for (int i = 0; i < mpi.KPAR; i++)
+    {
+        EXPECT_GE(balanced.nks_pool[i], 1);
+        EXPECT_EQ(balanced.startk_pool[i], nk);
+        for (int ik = 0; ik < balanced.nks_pool[i]; ik++)
+        {
+            EXPECT_EQ(balanced.whichpool[nk + ik], i);
+        }
+        nk += balanced.nks_pool[i];
+    }
+    EXPECT_EQ(nk, pp.nkstot_);
+    EXPECT_EQ(balanced.nks_np, balanced.nks_pool[mpi.MY_POOL]);
+    EXPECT_LE(balanced.get_imbalance(cost), even.get_imbalance(cost));
+    EXPECT_GE(balanced.get_imbalance(cost), 1.0 - 1e-12);
+    if (mpi.KPAR < pp.nkstot_)
+    {
+        EXPECT_LT(balanced.get_imbalance(cost), even.get_imbalance(cost));
+    }
+}
+
 INSTANTIATE_TEST_SUITE_P(TESTPK,
                          ParaKpoints,
                          ::testing::Values(
@@ -55,6 +55,7 @@ void print_scf_iterinfo(const std::string& ks_solver,
            {"elpa", "EL"},
            {"dav", "DA"},
            {"dav_subspace", "DS"},
+           {"chefsi", "CF"},
            {"scalapack_gvx", "GV"},
            {"cusolver", "CU"},
            {"bpcg", "BP"},
@@ -5,6 +5,10 @@
 #include "module_elecstate/module_charge/charge.h"
 #include "module_hamilt_pw/hamilt_pwdft/parallel_grid.h"
 
+#include <complex>
+#include <map>
+#include <vector>
+
 class Symmetry_rho
 {
   public:
@@ -24,6 +28,10 @@ class Symmetry_rho
                const ModulePW::PW_Basis* pw,
                ModuleSymmetry::Symmetry& symm) const;
 
+    /// drop the tables of stars of G vectors of all the PW_Basis,
+    /// called when the G vectors of a PW_Basis are set up again or the PW_Basis is deleted
+    static void clear_star_tables();
+
   private:
     // in real space:
     void psymm(double* rho_part,
@@ -49,6 +57,55 @@ class Symmetry_rho
                       const int* ig2isztot,
                       const int* fftixy2is,
                       int* ixyz2ipw) const; //(ix, iy, iz) -> (ip, ig)
+
+    /**
+     * @brief The stars of G vectors of one PW_Basis, distributed over the processes of the pool.
+     *
+     * Each star is symmetrized by the process owning its G vector with the smallest FFT-grid index.
+     * It receives the other members of the star from their owners and sends the results back,
+     * so only the members of the stars are exchanged, by one MPI_Alltoallv in each direction.
+     * The table only depends on the symmetry operations and the distribution of the G vectors,
+     * so it is built once for each geometry and reused in the following SCF iterations.
+     */
+    struct Star_Table
+    {
+        /// the symmetry operations and the FFT-grid indices of the local G vectors the table is built with
+        std::vector<double> symm_key;
+        std::vector<int> ixyz;
+
+        /// the local G vectors sent to each process, in the order asked by the process
+        std::vector<int> send_ig;
+        std::vector<int> send_count;
+        std::vector<int> send_displ;
+        /// the members of the stars received from each process
+        std::vector<int> recv_count;
+        std::vector<int> recv_displ;
+
+        /// entries of star istar are star_start[istar] to star_start[istar + 1],
+        /// one for each symmetry operation, with the received member and the phase factor
+        std::vector<int> star_start;
+        std::vector<int> entry_member;
+        std::vector<std::complex<double>> entry_phase;
+
+        /// the star of each received member and the phase factor to get it from the average of the star
+        std::vector<int> member_star;
+        std::vector<std::complex<double>> member_phase;
+    };
+
+    /// the tables of the PW_Basis used, kept for the next calls until clear_star_tables()
+    static std::map<const ModulePW::PW_Basis*, Star_Table> star_tables;
+
+    /// symmetrize rho(G) by the distributed stars of G vectors, not for gamma_only
+    void psymmg_star(std::complex<double>* rhog_part,
+                     const ModulePW::PW_Basis* rho_basis,
+                     const ModuleSymmetry::Symmetry& symm) const;
+
+    /// get the table of rho_basis, which is built again if the symmetry or the G vectors have changed
+    const Star_Table& get_star_table(const ModulePW::PW_Basis* rho_basis, const ModuleSymmetry::Symmetry& symm) const;
+
+    void build_star_table(const ModulePW::PW_Basis* rho_basis,
+                          const ModuleSymmetry::Symmetry& symm,
+                          Star_Table& table) const;
 };
 
 #endif
@@ -2,10 +2,22 @@
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 #include "module_base/parallel_global.h"
 #include "module_hamilt_general/module_xc/xc_functional.h"
+#include "module_base/libm/libm.h"
+#include "module_base/timer.h"
+
+#include <algorithm>
 
 
 void Symmetry_rho::psymmg(std::complex<double>* rhog_part, const ModulePW::PW_Basis *rho_basis, ModuleSymmetry::Symmetry &symm) const
-{		
+{
+	// the whole sphere of G vectors is closed under the rotations,
+	// so the stars can be symmetrized in parallel without gathering rho(G)
+	if (!rho_basis->gamma_only)
+	{
+		this->psymmg_star(rhog_part, rho_basis, symm);
+		return;
+	}
+
 	//(1) get fftixy2is and do Allreduce
 	int * fftixy2is = new int [rho_basis->fftnxy];
 	rho_basis->getfftixy2is(fftixy2is);		//current proc
@@ -234,4 +246,424 @@ void Symmetry_rho::get_ixyz2ipw(const ModulePW::PW_Basis *rho_basis,
 	delete[] nstnz_start;
 	delete[] ipsz2ipw;
 	return;
-}
\ No newline at end of file
+}
+
+std::map<const ModulePW::PW_Basis*, Symmetry_rho::Star_Table> Symmetry_rho::star_tables;
+
+void Symmetry_rho::clear_star_tables()
+{
+    star_tables.clear();
+}
+
+namespace
+{
+#ifdef __MPI
+MPI_Datatype mpi_type(const int*)
+{
+    return MPI_INT;
+}
+MPI_Datatype mpi_type(const std::complex<double>*)
+{
+    return MPI_DOUBLE_COMPLEX;
+}
+#endif
+
+// MPI_Alltoallv in the pool of rho_basis
+template <typename T>
+void alltoallv(const ModulePW::PW_Basis* rho_basis,
+               const T* send,
+               const std::vector<int>& send_count,
+               const std::vector<int>& send_displ,
+               T* recv,
+               const std::vector<int>& recv_count,
+               const std::vector<int>& recv_displ)
+{
+#ifdef __MPI
+    MPI_Alltoallv(send,
+                  send_count.data(),
+                  send_displ.data(),
+                  mpi_type(send),
+                  recv,
+                  recv_count.data(),
+                  recv_displ.data(),
+                  mpi_type(send),
+                  rho_basis->pool_world);
+#else
+    std::copy(send, send + send_count[0], recv);
+#endif
+}
+
+// exchange the counts of the data sent to each process and get the displacements
+void exchange_count(const ModulePW::PW_Basis* rho_basis,
+                    const std::vector<int>& send_count,
+                    std::vector<int>& send_displ,
+                    std::vector<int>& recv_count,
+                    std::vector<int>& recv_displ)
+{
+    const int nproc = rho_basis->poolnproc;
+    recv_count.resize(nproc);
+#ifdef __MPI
+    MPI_Alltoall(send_count.data(), 1, MPI_INT, recv_count.data(), 1, MPI_INT, rho_basis->pool_world);
+#else
+    recv_count = send_count;
+#endif
+    send_displ.assign(nproc, 0);
+    recv_displ.assign(nproc, 0);
+    for (int ip = 1; ip < nproc; ++ip)
+    {
+        send_displ[ip] = send_displ[ip - 1] + send_count[ip - 1];
+        recv_displ[ip] = recv_displ[ip - 1] + recv_count[ip - 1];
+    }
+}
+
+// the integer coordinates of the G vector on the FFT grid
+ModuleBase::Vector3<int> get_gdirect(const ModulePW::PW_Basis* rho_basis, const int ixyz)
+{
+    const int k = ixyz % rho_basis->fftnz;
+    const int j = ixyz / rho_basis->fftnz % rho_basis->fftny;
+    const int i = ixyz / rho_basis->fftnz / rho_basis->fftny;
+    const int nx = rho_basis->nx;
+    const int ny = rho_basis->ny;
+    const int nz = rho_basis->nz;
+    return ModuleBase::Vector3<int>((i > int(nx / 2) + 1) ? (i - nx) : i,
+                                    (j > int(ny / 2) + 1) ? (j - ny) : j,
+                                    (k > int(nz / 2) + 1) ? (k - nz) : k);
+}
+
+// the FFT-grid index of the G vector rotated by g, the same as Symmetry::rhog_symmetry
+int rotate_recip(const ModulePW::PW_Basis* rho_basis, const ModuleBase::Matrix3& g, const ModuleBase::Vector3<int>& g0)
+{
+    const int nx = rho_basis->nx;
+    const int ny = rho_basis->ny;
+    const int nz = rho_basis->nz;
+    int ii = int(g.e11 * g0.x + g.e21 * g0.y + g.e31 * g0.z);
+    if (ii < 0)
+    {
+        ii += 10 * nx;
+    }
+    int jj = int(g.e12 * g0.x + g.e22 * g0.y + g.e32 * g0.z);
+    if (jj < 0)
+    {
+        jj += 10 * ny;
+    }
+    int kk = int(g.e13 * g0.x + g.e23 * g0.y + g.e33 * g0.z);
+    if (kk < 0)
+    {
+        kk += 10 * nz;
+    }
+    return ((ii % nx) * rho_basis->fftny + jj % ny) * rho_basis->fftnz + kk % nz;
+}
+
+// the phase factor of the G vector for symmetry operation isym, the same as Symmetry::rhog_symmetry,
+// return false if the G vector is not allowed by the translations of the primitive cell
+bool get_gphase(const ModulePW::PW_Basis* rho_basis,
+                const ModuleSymmetry::Symmetry& symm,
+                const int ixyz,
+                const int isym,
+                std::complex<double>& gphase)
+{
+    const ModuleBase::Vector3<int> g = get_gdirect(rho_basis, ixyz);
+    const ModuleBase::Vector3<double> gdirect
+        = ModuleBase::Vector3<double>(static_cast<double>(g.x), static_cast<double>(g.y), static_cast<double>(g.z))
+          * ModuleBase::TWO_PI;
+    const double arg_gtrans = gdirect * symm.gtrans[isym];
+    const std::complex<double> phase_gtrans(ModuleBase::libm::cos(arg_gtrans), ModuleBase::libm::sin(arg_gtrans));
+    double cos_arg = 0.0;
+    double sin_arg = 0.0;
+    for (int ipt = 0; ipt < ((ModuleSymmetry::Symmetry::pricell_loop) ? symm.ncell : 1); ++ipt)
+    {
+        const double arg = gdirect * symm.ptrans[ipt];
+        double tmp_cos = 0.0;
+        double tmp_sin = 0.0;
+        ModuleBase::libm::sincos(arg, &tmp_sin, &tmp_cos);
+        cos_arg += tmp_cos;
+        sin_arg += tmp_sin;
+    }
+    cos_arg /= static_cast<double>(symm.ncell);
+    sin_arg /= static_cast<double>(symm.ncell);
+    if (symm.equal(cos_arg, 0.0) && symm.equal(sin_arg, 0.0))
+    {
+        return false;
+    }
+    gphase = phase_gtrans * std::complex<double>(cos_arg, sin_arg);
+    if (symm.equal(gphase.real(), 1.0) && symm.equal(gphase.imag(), 0))
+    {
+        gphase = std::complex<double>(1.0, 0.0);
+    }
+    return true;
+}
+} // namespace
+
+void Symmetry_rho::psymmg_star(std::complex<double>* rhog_part,
+                               const ModulePW::PW_Basis* rho_basis,
+                               const ModuleSymmetry::Symmetry& symm) const
+{
+    ModuleBase::timer::tick("Symmetry_rho", "psymmg_star");
+    const Star_Table& table = this->get_star_table(rho_basis, symm);
+
+    // (1) get the members of the stars of this process from their owners
+    std::vector<std::complex<double>> rhog_send(table.send_ig.size());
+    for (int i = 0; i < rhog_send.size(); ++i)
+    {
+        rhog_send[i] = rhog_part[table.send_ig[i]];
+    }
+    std::vector<std::complex<double>> rhog_member(table.member_star.size());
+    alltoallv(rho_basis,
+              rhog_send.data(),
+              table.send_count,
+              table.send_displ,
+              rhog_member.data(),
+              table.recv_count,
+              table.recv_displ);
+
+    // (2) average over the symmetry operations in each star
+    const int nstar = table.star_start.size() - 1;
+    std::vector<std::complex<double>> rhog_star(nstar);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int istar = 0; istar < nstar; ++istar)
+    {
+        std::complex<double> sum(0, 0);
+        for (int ie = table.star_start[istar]; ie < table.star_start[istar + 1]; ++ie)
+        {
+            sum += rhog_member[table.entry_member[ie]] * table.entry_phase[ie];
+        }
+        sum /= table.star_start[istar + 1] - table.star_start[istar];
+        rhog_star[istar] = sum;
+    }
+    for (int im = 0; im < rhog_member.size(); ++im)
+    {
+        rhog_member[im] = rhog_star[table.member_star[im]] / table.member_phase[im];
+    }
+
+    // (3) send the symmetrized members back to their owners
+    alltoallv(rho_basis,
+              rhog_member.data(),
+              table.recv_count,
+              table.recv_displ,
+              rhog_send.data(),
+              table.send_count,
+              table.send_displ);
+    for (int i = 0; i < rhog_send.size(); ++i)
+    {
+        rhog_part[table.send_ig[i]] = rhog_send[i];
+    }
+    ModuleBase::timer::tick("Symmetry_rho", "psymmg_star");
+}
+
+const Symmetry_rho::Star_Table& Symmetry_rho::get_star_table(const ModulePW::PW_Basis* rho_basis,
+                                                             const ModuleSymmetry::Symmetry& symm) const
+{
+    std::vector<double> symm_key = {static_cast<double>(symm.nrotk),
+                                    static_cast<double>(symm.ncell),
+                                    static_cast<double>(ModuleSymmetry::Symmetry::pricell_loop),
+                                    symm.epsilon,
+                                    static_cast<double>(rho_basis->nx),
+                                    static_cast<double>(rho_basis->ny),
+                                    static_cast<double>(rho_basis->nz)};
+    for (int isym = 0; isym < symm.nrotk; ++isym)
+    {
+        const ModuleBase::Matrix3& g = symm.kgmatrix[isym];
+        symm_key.insert(symm_key.end(), {g.e11, g.e12, g.e13, g.e21, g.e22, g.e23, g.e31, g.e32, g.e33});
+        symm_key.insert(symm_key.end(), {symm.gtrans[isym].x, symm.gtrans[isym].y, symm.gtrans[isym].z});
+    }
+    for (const ModuleBase::Vector3<double>& t: symm.ptrans)
+    {
+        symm_key.insert(symm_key.end(), {t.x, t.y, t.z});
+    }
+
+    std::vector<int> ixyz(rho_basis->npw);
+    for (int ig = 0; ig < rho_basis->npw; ++ig)
+    {
+        const int isz = rho_basis->ig2isz[ig];
+        ixyz[ig] = rho_basis->is2fftixy[isz / rho_basis->nz] * rho_basis->fftnz + isz % rho_basis->nz;
+    }
+
+    const auto it = star_tables.find(rho_basis);
+    int changed = (it == star_tables.end() || it->second.symm_key != symm_key || it->second.ixyz != ixyz) ? 1 : 0;
+#ifdef __MPI
+    MPI_Allreduce(MPI_IN_PLACE, &changed, 1, MPI_INT, MPI_MAX, rho_basis->pool_world);
+#endif
+    Star_Table& table = star_tables[rho_basis];
+    if (changed)
+    {
+        table = Star_Table();
+        table.symm_key = std::move(symm_key);
+        table.ixyz = std::move(ixyz);
+        this->build_star_table(rho_basis, symm, table);
+    }
+    return table;
+}
+
+void Symmetry_rho::build_star_table(const ModulePW::PW_Basis* rho_basis,
+                                    const ModuleSymmetry::Symmetry& symm,
+                                    Star_Table& table) const
+{
+    ModuleBase::TITLE("Symmetry_rho", "build_star_table");
+    ModuleBase::timer::tick("Symmetry_rho", "build_star_table");
+    assert(symm.nrotk > 0);
+    assert(symm.nrotk <= 48);
+    const int nproc = rho_basis->poolnproc;
+    const int npw = rho_basis->npw;
+    const int nz = rho_basis->nz;
+    const int fftnz = rho_basis->fftnz;
+
+    // the symmetry operations in the order of Symmetry::rhog_symmetry
+    std::vector<int> invmap(symm.nrotk, -1);
+    symm.gmatrix_invmap(symm.kgmatrix, symm.nrotk, invmap.data());
+    std::vector<int> isym_list;
+    for (int isym = 0; isym < symm.nrotk; ++isym)
+    {
+        if (invmap[isym] >= 0 && invmap[isym] <= symm.nrotk)
+        {
+            isym_list.push_back(invmap[isym]);
+        }
+    }
+    const int nsym = isym_list.size();
+
+    // (1) rotate the local G vectors, and ask the owners of the sticks of the rotated ones for their local index
+    std::vector<int> rot_ixyz(static_cast<size_t>(npw) * nsym);
+    std::vector<std::vector<int>> query(nproc);
+    for (int ig = 0; ig < npw; ++ig)
+    {
+        const ModuleBase::Vector3<int> g0 = get_gdirect(rho_basis, table.ixyz[ig]);
+        for (int is = 0; is < nsym; ++is)
+        {
+            const int ixyz = rotate_recip(rho_basis, symm.kgmatrix[isym_list[is]], g0);
+            rot_ixyz[ig * nsym + is] = ixyz;
+            const int ip = rho_basis->fftixy2ip[ixyz / fftnz];
+            if (ip >= 0)
+            {
+                query[ip].push_back(ixyz);
+            }
+        }
+    }
+    std::vector<int> query_count(nproc);
+    std::vector<int> query_flat;
+    for (int ip = 0; ip < nproc; ++ip)
+    {
+        std::sort(query[ip].begin(), query[ip].end());
+        query[ip].erase(std::unique(query[ip].begin(), query[ip].end()), query[ip].end());
+        query_count[ip] = query[ip].size();
+        query_flat.insert(query_flat.end(), query[ip].begin(), query[ip].end());
+    }
+    std::vector<int> query_displ, answer_count, answer_displ;
+    exchange_count(rho_basis, query_count, query_displ, answer_count, answer_displ);
+    std::vector<int> question(answer_displ[nproc - 1] + answer_count[nproc - 1]);
+    alltoallv(rho_basis, query_flat.data(), query_count, query_displ, question.data(), answer_count, answer_displ);
+
+    std::vector<int> fftixy2is(rho_basis->fftnxy);
+    rho_basis->getfftixy2is(fftixy2is.data());
+    std::vector<int> isz2ig(rho_basis->nst * nz, -1);
+    for (int ig = 0; ig < npw; ++ig)
+    {
+        isz2ig[rho_basis->ig2isz[ig]] = ig;
+    }
+    for (int& ixyz: question)
+    {
+        const int is = fftixy2is[ixyz / fftnz];
+        ixyz = (is >= 0) ? isz2ig[is * nz + ixyz % fftnz] : -1;
+    }
+    std::vector<int> answer(query_flat.size());
+    alltoallv(rho_basis, question.data(), answer_count, answer_displ, answer.data(), query_count, query_displ);
+
+    // the owner and its local index of the G vector, false if it is not in the sphere of G vectors
+    auto find_g = [&](const int ixyz, int& ip, int& ig_ip) -> bool {
+        ip = rho_basis->fftixy2ip[ixyz / fftnz];
+        if (ip < 0)
+        {
+            return false;
+        }
+        const int i = std::lower_bound(query[ip].begin(), query[ip].end(), ixyz) - query[ip].begin();
+        ig_ip = answer[query_displ[ip] + i];
+        return ig_ip >= 0;
+    };
+
+    // (2) the stars whose first G vector is on this process, the members are asked from their owners
+    std::vector<std::vector<int>> member_ig(nproc);
+    std::vector<std::vector<int>> member_star(nproc);
+    std::vector<std::vector<std::complex<double>>> member_phase(nproc);
+    std::vector<int> entry_ip;
+    table.star_start.push_back(0);
+    for (int ig = 0; ig < npw; ++ig)
+    {
+        int ip = 0;
+        int ig_ip = 0;
+        bool is_first = true;
+        for (int is = 0; is < nsym && is_first; ++is)
+        {
+            is_first = rot_ixyz[ig * nsym + is] >= table.ixyz[ig] || !find_g(rot_ixyz[ig * nsym + is], ip, ig_ip);
+        }
+        if (!is_first)
+        {
+            continue;
+        }
+        const int istar = table.star_start.size() - 1;
+        // (ip, index in member_ig[ip]) of the members of this star
+        std::vector<std::pair<int, int>> members;
+        for (int is = 0; is < nsym; ++is)
+        {
+            const int ixyz = rot_ixyz[ig * nsym + is];
+            std::complex<double> gphase;
+            if (!find_g(ixyz, ip, ig_ip) || !get_gphase(rho_basis, symm, ixyz, isym_list[is], gphase))
+            {
+                continue;
+            }
+            int im = 0;
+            for (; im < members.size(); ++im)
+            {
+                if (members[im].first == ip && member_ig[ip][members[im].second] == ig_ip)
+                {
+                    break;
+                }
+            }
+            if (im == members.size())
+            {
+                members.push_back(std::make_pair(ip, static_cast<int>(member_ig[ip].size())));
+                member_ig[ip].push_back(ig_ip);
+                member_star[ip].push_back(istar);
+                member_phase[ip].push_back(gphase);
+            }
+            else
+            {
+                // the last operation to the member is used, as in Symmetry::rhog_symmetry
+                member_phase[ip][members[im].second] = gphase;
+            }
+            entry_ip.push_back(ip);
+            table.entry_member.push_back(members[im].second);
+            table.entry_phase.push_back(gphase);
+        }
+        if (table.entry_member.size() > table.star_start.back())
+        {
+            table.star_start.push_back(table.entry_member.size());
+        }
+    }
+
+    // (3) tell the owners which G vectors to send
+    std::vector<int> member_count(nproc);
+    std::vector<int> member_flat;
+    for (int ip = 0; ip < nproc; ++ip)
+    {
+        member_count[ip] = member_ig[ip].size();
+        member_flat.insert(member_flat.end(), member_ig[ip].begin(), member_ig[ip].end());
+        table.member_star.insert(table.member_star.end(), member_star[ip].begin(), member_star[ip].end());
+        table.member_phase.insert(table.member_phase.end(), member_phase[ip].begin(), member_phase[ip].end());
+    }
+    exchange_count(rho_basis, member_count, table.recv_displ, table.send_count, table.send_displ);
+    table.recv_count = member_count;
+    table.send_ig.resize(table.send_displ[nproc - 1] + table.send_count[nproc - 1]);
+    alltoallv(rho_basis,
+              member_flat.data(),
+              table.recv_count,
+              table.recv_displ,
+              table.send_ig.data(),
+              table.send_count,
+              table.send_displ);
+    for (int ie = 0; ie < table.entry_member.size(); ++ie)
+    {
+        table.entry_member[ie] += table.recv_displ[entry_ip[ie]];
+    }
+
+    ModuleBase::timer::tick("Symmetry_rho", "build_star_table");
+}
@@ -23,6 +23,7 @@ DensityMatrix<TK, TR>::~DensityMatrix()
         delete it;
     }
     delete[] this->dmr_tmp_;
+    delete this->kr_phase_;
 }
 
 template <typename TK, typename TR>
@@ -65,12 +66,22 @@ void DensityMatrix<std::complex<double>, double>::cal_DMR(const int ik_in)
     ModuleBase::timer::tick("DensityMatrix", "cal_DMR");
     int ld_hk = this->_paraV->nrow;
     int ld_hk2 = 2 * ld_hk;
+    // with all the k points, DMR of each atom pair is calculated with one GEMM over k and R,
+    // the phases e^{ikR} are calculated once for the geometry
+    const bool all_k = (ik_in < 0);
+    const std::vector<ModuleBase::Vector3<double>> kvec_d(this->_kvec_d.begin(), this->_kvec_d.begin() + this->_nk);
     for (int is = 1; is <= this->_nspin; ++is)
     {
         int ik_begin = this->_nk * (is - 1); // jump this->_nk for spin_down if nspin==2
         hamilt::HContainer<double>* tmp_DMR = this->_DMR[is - 1];
         // set zero since this function is called in every scf step
         tmp_DMR->set_zero();
+        if (all_k && (this->kr_phase_ == nullptr || !this->kr_phase_->match(kvec_d, *tmp_DMR)))
+        {
+            delete this->kr_phase_;
+            this->kr_phase_ = new hamilt::KRPhase(kvec_d, *tmp_DMR);
+            ModuleBase::Memory::record("DensityMatrix::kr_phase", this->kr_phase_->get_memory_size());
+        }
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
@@ -91,6 +102,27 @@ void DensityMatrix<std::complex<double>, double>::cal_DMR(const int ik_in)
             {
                 tmp_DMR.resize(tmp_ap.get_size());
             }
+            // DMR of all the R of this atom pair from all the k points
+            std::vector<double> dmr_all;
+            std::vector<std::complex<double>> dmr_all_nc;
+            if (all_k)
+            {
+                std::vector<const std::complex<double>*> dmk(this->_nk);
+                for (int ik = 0; ik < this->_nk; ++ik)
+                {
+                    dmk[ik] = this->_DMK[ik + ik_begin].data();
+                }
+                if (PARAM.inp.nspin != 4)
+                {
+                    dmr_all.resize(tmp_ap.get_R_size() * tmp_ap.get_size());
+                    hamilt::unfolding_HK(tmp_ap, dmk, ld_hk, *this->kr_phase_, dmr_all.data());
+                }
+                else
+                {
+                    dmr_all_nc.resize(tmp_ap.get_R_size() * tmp_ap.get_size());
+                    hamilt::unfolding_HK(tmp_ap, dmk, ld_hk, *this->kr_phase_, dmr_all_nc.data());
+                }
+            }
             for (int ir = 0; ir < tmp_ap.get_R_size(); ++ir)
             {
                 const ModuleBase::Vector3<int> r_index = tmp_ap.get_R_index(ir);
@@ -102,8 +134,13 @@ void DensityMatrix<std::complex<double>, double>::cal_DMR(const int ik_in)
                     continue;
                 }
 #endif
+                if (all_k && PARAM.inp.nspin != 4)
+                {
+                    const double* dmr_ir = dmr_all.data() + ir * tmp_ap.get_size();
+                    std::copy(dmr_ir, dmr_ir + tmp_ap.get_size(), tmp_matrix->get_pointer());
+                }
                 // loop over k-points
-                if (PARAM.inp.nspin != 4)
+                else if (PARAM.inp.nspin != 4)
                 {
                     for (int ik = 0; ik < this->_nk; ++ik)
                     {
@@ -150,36 +187,39 @@ void DensityMatrix<std::complex<double>, double>::cal_DMR(const int ik_in)
                 // treat DMR as pauli matrix when NSPIN=4
                 if (PARAM.inp.nspin == 4)
                 {
-                    tmp_DMR.assign(tmp_ap.get_size(), std::complex<double>(0.0, 0.0));
-                    for (int ik = 0; ik < this->_nk; ++ik)
+                    if (!all_k)
                     {
-                        if(ik_in >= 0 && ik_in != ik) { continue;
-}
-                        // cal k_phase
-                        // if TK==std::complex<double>, kphase is e^{ikR}
-                        const ModuleBase::Vector3<double> dR(r_index[0], r_index[1], r_index[2]);
-                        const double arg = (this->_kvec_d[ik] * dR) * ModuleBase::TWO_PI;
-                        double sinp, cosp;
-                        ModuleBase::libm::sincos(arg, &sinp, &cosp);
-                        std::complex<double> kphase = std::complex<double>(cosp, sinp);
-                        // set DMR element
-                        std::complex<double>* tmp_DMR_pointer = tmp_DMR.data();
-                        std::complex<double>* tmp_DMK_pointer = this->_DMK[ik + ik_begin].data();
-                        double* DMK_real_pointer = nullptr;
-                        double* DMK_imag_pointer = nullptr;
-                        // jump DMK to fill DMR
-                        // DMR is row-major, DMK is column-major
-                        tmp_DMK_pointer += col_ap * this->_paraV->nrow + row_ap;
-                        for (int mu = 0; mu < tmp_ap.get_row_size(); ++mu)
+                        tmp_DMR.assign(tmp_ap.get_size(), std::complex<double>(0.0, 0.0));
+                        for (int ik = 0; ik < this->_nk; ++ik)
                         {
-                            BlasConnector::axpy(tmp_ap.get_col_size(),
-                                                kphase,
-                                                tmp_DMK_pointer,
-                                                ld_hk,
-                                                tmp_DMR_pointer,
-                                                1);
-                            tmp_DMK_pointer += 1;
-                            tmp_DMR_pointer += tmp_ap.get_col_size();
+                            if(ik_in >= 0 && ik_in != ik) { continue;
+}
+                            // cal k_phase
+                            // if TK==std::complex<double>, kphase is e^{ikR}
+                            const ModuleBase::Vector3<double> dR(r_index[0], r_index[1], r_index[2]);
+                            const double arg = (this->_kvec_d[ik] * dR) * ModuleBase::TWO_PI;
+                            double sinp, cosp;
+                            ModuleBase::libm::sincos(arg, &sinp, &cosp);
+                            std::complex<double> kphase = std::complex<double>(cosp, sinp);
+                            // set DMR element
+                            std::complex<double>* tmp_DMR_pointer = tmp_DMR.data();
+                            std::complex<double>* tmp_DMK_pointer = this->_DMK[ik + ik_begin].data();
+                            double* DMK_real_pointer = nullptr;
+                            double* DMK_imag_pointer = nullptr;
+                            // jump DMK to fill DMR
+                            // DMR is row-major, DMK is column-major
+                            tmp_DMK_pointer += col_ap * this->_paraV->nrow + row_ap;
+                            for (int mu = 0; mu < tmp_ap.get_row_size(); ++mu)
+                            {
+                                BlasConnector::axpy(tmp_ap.get_col_size(),
+                                                    kphase,
+                                                    tmp_DMK_pointer,
+                                                    ld_hk,
+                                                    tmp_DMR_pointer,
+                                                    1);
+                                tmp_DMK_pointer += 1;
+                                tmp_DMR_pointer += tmp_ap.get_col_size();
+                            }
                         }
                     }
                     int npol = 2;
@@ -194,7 +234,8 @@ void DensityMatrix<std::complex<double>, double>::cal_DMR(const int ik_in)
                     }
                     std::complex<double> tmp[4];
                     double* target_DMR = tmp_matrix->get_pointer();
-                    std::complex<double>* tmp_DMR_pointer = tmp_DMR.data();
+                    std::complex<double>* tmp_DMR_pointer
+                        = all_k ? dmr_all_nc.data() + ir * tmp_ap.get_size() : tmp_DMR.data();
                     for (int irow = 0; irow < tmp_ap.get_row_size(); irow += 2)
                     {
                         for (int icol = 0; icol < tmp_ap.get_col_size(); icol += 2)
@@ -6,6 +6,7 @@
 #include "module_cell/module_neighbor/sltk_grid_driver.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/record_adj.h"
 #include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
+#include "module_hamilt_lcao/module_hcontainer/hcontainer_funcs.h"
 
 namespace elecstate
 {
@@ -277,6 +278,9 @@ class DensityMatrix
     std::vector<TR> dmr_origin_;
     TR* dmr_tmp_ = nullptr;
 
+    /// phases e^{ikR} of the k points and the R vectors of DMR, for cal_DMR of all the k points
+    hamilt::KRPhase* kr_phase_ = nullptr;
+
 };
 
 } // namespace elecstate
@@ -0,0 +1,199 @@
+#include "gtest/gtest.h"
+
+#define private public
+#include "module_elecstate/module_charge/symmetry_rho.h"
+#undef private
+
+#ifdef __MPI
+#include "mpi.h"
+#endif
+
+#include <cmath>
+
+/************************************************
+ *  unit test of symmetry_rhog.cpp
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - Symmetry_rho::psymmg()
+ *     - the stars of G vectors distributed over the processes give the same rho(G)
+ *       as Symmetry::rhog_symmetry() on all the G vectors
+ *     - the table of stars is kept for the next call, and built again if the symmetry changes
+ *   - Symmetry_rho::clear_star_tables()
+ *     - the tables are dropped, and built again for a PW_Basis set up again
+ * - it is run in serial by elecstate_symmetry_rho, and on 2, 3 and 4 processes
+ *   by symmetry_rho_mpi_test.sh in module_elecstate/test_mpi
+ */
+
+// mock the useless functions
+void output::printM3(std::ofstream& ofs, const std::string& description, const ModuleBase::Matrix3& m)
+{
+}
+Symmetry_rho::Symmetry_rho()
+{
+}
+Symmetry_rho::~Symmetry_rho()
+{
+}
+
+namespace
+{
+// rho(G) for the G vector on the FFT grid
+std::complex<double> rhog_model(const int ixyz)
+{
+    return std::complex<double>(std::sin(0.1 * ixyz), std::cos(0.37 * ixyz));
+}
+
+int get_ixyz(const ModulePW::PW_Basis& pw, const int ig)
+{
+    const int isz = pw.ig2isz[ig];
+    return pw.is2fftixy[isz / pw.nz] * pw.fftnz + isz % pw.nz;
+}
+} // namespace
+
+class SymmetryRhoTest : public testing::Test
+{
+  protected:
+    ModulePW::PW_Basis pw;
+    ModulePW::PW_Basis pw_full;
+    ModuleSymmetry::Symmetry symm;
+
+    void SetUp() override
+    {
+        const ModuleBase::Matrix3 latvec(1, 0, 0, 0, 1, 0, 0, 0, 1);
+#ifdef __MPI
+        int nproc = 1;
+        int rank = 0;
+        MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        pw.initmpi(nproc, rank, MPI_COMM_WORLD);
+        pw_full.initmpi(1, 0, MPI_COMM_SELF);
+#endif
+        for (ModulePW::PW_Basis* p: {&pw, &pw_full})
+        {
+            p->initgrids(10.0, latvec, 24, 24, 24);
+            p->initparameters(false, 20.0);
+            p->setuptransform();
+        }
+
+        // the point group of the cube: permutations of the axes with signs, and some translations
+        symm.epsilon = 1e-6;
+        symm.nrotk = 0;
+        const int perm[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+        for (int ip = 0; ip < 6; ++ip)
+        {
+            for (int is = 0; is < 8; ++is)
+            {
+                double m[3][3] = {{0}};
+                for (int i = 0; i < 3; ++i)
+                {
+                    m[i][perm[ip][i]] = ((is >> i) & 1) ? -1.0 : 1.0;
+                }
+                symm.kgmatrix[symm.nrotk] = ModuleBase::Matrix3(m[0][0], m[0][1], m[0][2],
+                                                                m[1][0], m[1][1], m[1][2],
+                                                                m[2][0], m[2][1], m[2][2]);
+                symm.gtrans[symm.nrotk] = ModuleBase::Vector3<double>(0.5 * (is & 1), 0.25 * (ip % 2), 0.0);
+                ++symm.nrotk;
+            }
+        }
+        // two primitive cells in the cell, so half of the G vectors are not allowed
+        symm.ncell = 2;
+        symm.ptrans = {ModuleBase::Vector3<double>(0, 0, 0), ModuleBase::Vector3<double>(0.5, 0.5, 0.5)};
+        ModuleSymmetry::Symmetry::pricell_loop = true;
+    }
+
+    // compare psymmg() on pw with Symmetry::rhog_symmetry() on pw_full
+    void check_psymmg()
+    {
+        std::vector<std::complex<double>> rhog_full(pw_full.npw);
+        std::vector<int> ixyz2ipw(pw_full.fftnxyz, -1);
+        for (int ig = 0; ig < pw_full.npw; ++ig)
+        {
+            const int ixyz = get_ixyz(pw_full, ig);
+            rhog_full[ig] = rhog_model(ixyz);
+            ixyz2ipw[ixyz] = ig;
+        }
+        symm.rhog_symmetry(rhog_full.data(), ixyz2ipw.data(), pw_full.nx, pw_full.ny, pw_full.nz,
+                           pw_full.fftnx, pw_full.fftny, pw_full.fftnz);
+
+        std::vector<std::complex<double>> rhog(pw.npw);
+        for (int ig = 0; ig < pw.npw; ++ig)
+        {
+            rhog[ig] = rhog_model(get_ixyz(pw, ig));
+        }
+        Symmetry_rho srho;
+        srho.psymmg(rhog.data(), &pw, symm);
+
+        for (int ig = 0; ig < pw.npw; ++ig)
+        {
+            const std::complex<double> ref = rhog_full[ixyz2ipw[get_ixyz(pw, ig)]];
+            EXPECT_NEAR(rhog[ig].real(), ref.real(), 1e-12);
+            EXPECT_NEAR(rhog[ig].imag(), ref.imag(), 1e-12);
+        }
+    }
+};
+
+TEST_F(SymmetryRhoTest, Psymmg)
+{
+    this->check_psymmg();
+    ASSERT_EQ(Symmetry_rho::star_tables.count(&pw), 1);
+    const Symmetry_rho::Star_Table& table = Symmetry_rho::star_tables[&pw];
+    EXPECT_EQ(table.ixyz.size(), pw.npw);
+    EXPECT_GT(table.star_start.size(), 1);
+    // on more than one process, some members of the stars are received from the other processes
+    int nrecv_other = 0;
+    for (int ip = 0; ip < pw.poolnproc; ++ip)
+    {
+        nrecv_other += (ip == pw.poolrank) ? 0 : table.recv_count[ip];
+    }
+#ifdef __MPI
+    MPI_Allreduce(MPI_IN_PLACE, &nrecv_other, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#endif
+    EXPECT_EQ(nrecv_other > 0, pw.poolnproc > 1);
+
+    // the same table is used for the same symmetry
+    const std::vector<int> send_ig = table.send_ig;
+    this->check_psymmg();
+    EXPECT_EQ(Symmetry_rho::star_tables[&pw].send_ig, send_ig);
+
+    // the table is built again for other translations
+    for (int isym = 0; isym < symm.nrotk; ++isym)
+    {
+        symm.gtrans[isym] = ModuleBase::Vector3<double>(0.0, 0.0, 0.5 * (isym % 2));
+    }
+    ModuleSymmetry::Symmetry::pricell_loop = false;
+    this->check_psymmg();
+    EXPECT_EQ(Symmetry_rho::star_tables[&pw].symm_key[2], 0.0);
+    Symmetry_rho::clear_star_tables();
+}
+
+TEST_F(SymmetryRhoTest, ClearStarTables)
+{
+    this->check_psymmg();
+    ASSERT_EQ(Symmetry_rho::star_tables.count(&pw), 1);
+    Symmetry_rho::clear_star_tables();
+    EXPECT_TRUE(Symmetry_rho::star_tables.empty());
+
+    // set up the G vectors again with another cutoff, as the ESolver does for a new cell
+    pw.initparameters(false, 12.0);
+    pw.setuptransform();
+    Symmetry_rho::clear_star_tables();
+    this->check_psymmg();
+    ASSERT_EQ(Symmetry_rho::star_tables.count(&pw), 1);
+    EXPECT_EQ(Symmetry_rho::star_tables[&pw].ixyz.size(), pw.npw);
+    Symmetry_rho::clear_star_tables();
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
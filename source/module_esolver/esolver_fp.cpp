@@ -50,6 +50,7 @@ ESolver_FP::ESolver_FP()
 
 ESolver_FP::~ESolver_FP()
 {
+    Symmetry_rho::clear_star_tables();
     delete pw_rho;
     if ( PARAM.globalv.double_grid)
     {
@@ -117,6 +118,9 @@ void ESolver_FP::before_all_runners(UnitCell& ucell, const Input_para& inp)
         this->pw_rhod->collect_local_pw();
         this->pw_rhod->collect_uniqgg();
     }
+    // the stars of G vectors of the former pw_rho and pw_rhod are not valid any more
+    Symmetry_rho::clear_star_tables();
+
     ModuleIO::CifParser::write(PARAM.globalv.global_out_dir + "STRU.cif",
                                ucell,
                                "# Generated by ABACUS ModuleIO::CifParser",
@@ -274,6 +278,7 @@ void ESolver_FP::before_scf(UnitCell& ucell, const int istep)
             this->pw_rhod->collect_local_pw();
             this->pw_rhod->collect_uniqgg();
         }
+        Symmetry_rho::clear_star_tables();
 
         // reset local pseudopotentials
         this->locpp.init_vloc(ucell, this->pw_rhod);
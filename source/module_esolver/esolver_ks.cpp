@@ -244,6 +244,7 @@ void ESolver_KS<T, Device>::before_all_runners(UnitCell& ucell, const Input_para
 #endif
 
     this->pw_wfc->fft_bundle.initfftmode(inp.fft_mode);
+    this->pw_wfc->fft_bundle.initfftbatch(inp.fft_batch);
     this->pw_wfc->setuptransform();
 
     //! 9) initialize the number of plane waves for each k point
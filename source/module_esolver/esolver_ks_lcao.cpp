@@ -502,6 +502,21 @@ void ESolver_KS_LCAO<TK, TR>::after_all_runners(UnitCell& ucell)
         );
     }
 
+#ifdef __EXX
+    // 8) write the Cs, Vs of the last ionic step to be reused after restart
+    if (GlobalC::exx_info.info_global.cal_exx && PARAM.inp.calculation != "nscf")
+    {
+        if (GlobalC::exx_info.info_ri.real_number)
+        {
+            this->exd->write_CVs_restart();
+        }
+        else
+        {
+            this->exc->write_CVs_restart();
+        }
+    }
+#endif
+
     ModuleBase::timer::tick("ESolver_KS_LCAO", "after_all_runners");
 }
 
@@ -82,6 +82,9 @@ ESolver_KS_PW<T, Device>::~ESolver_KS_PW()
     // delete Hamilt
     this->deallocate_hamilt();
 
+    // the workspace of the eigensolvers is kept until the end
+    hsolver::HSolverPW<T, Device>::release_arena(GlobalV::ofs_running);
+
     if (this->pelec != nullptr)
     {
         delete reinterpret_cast<elecstate::ElecStatePW<T, Device>*>(this->pelec);
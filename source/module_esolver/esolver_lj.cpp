@@ -31,13 +31,15 @@ void ESolver_LJ::before_all_runners(UnitCell& ucell, const Input_para& inp)
 
 void ESolver_LJ::runner(UnitCell& ucell, const int istep)
 {
-    Grid_Driver grid_neigh(PARAM.inp.test_deconstructor, PARAM.inp.test_grid);
+    // grid_neigh is kept between ionic steps to reuse the adjacent atoms with search_skin
     atom_arrange::search(PARAM.inp.search_pbc,
                          GlobalV::ofs_running,
                          grid_neigh,
                          ucell,
                          search_radius,
-                         PARAM.inp.test_atom_input);
+                         PARAM.inp.test_atom_input,
+                         false,
+                         PARAM.inp.search_skin);
 
     double distance = 0.0;
     int index = 0;
@@ -2,6 +2,8 @@
 #define ESOLVER_LJ_H
 
 #include "esolver.h"
+#include "module_cell/module_neighbor/sltk_grid_driver.h"
+#include "module_parameter/parameter.h"
 
 namespace ModuleESolver
 {
@@ -9,7 +11,7 @@ namespace ModuleESolver
     class ESolver_LJ : public ESolver
     {
     public:
-        ESolver_LJ()
+        ESolver_LJ() : grid_neigh(PARAM.inp.test_deconstructor, PARAM.inp.test_grid)
         {
             classname = "ESolver_LJ";
         }
@@ -49,6 +51,8 @@ namespace ModuleESolver
         ModuleBase::matrix lj_c6;
         ModuleBase::matrix en_shift;
 
+        Grid_Driver grid_neigh;
+
         double lj_potential=0.0;
         ModuleBase::matrix lj_force;
         ModuleBase::matrix lj_virial;
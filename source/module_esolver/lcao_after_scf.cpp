@@ -141,6 +141,18 @@ void ESolver_KS_LCAO<TK, TR>::after_scf(UnitCell& ucell, const int istep, const
                 ModuleIO::write_Hexxs_csr(file_name_exx, ucell, this->exc->get_Hexxs());
             }
         }
+        // the Cs, Vs to be reused after restart, also written at the last step in after_all_runners()
+        if (GlobalC::exx_info.info_global.cal_exx && istep % PARAM.inp.out_interval == 0)
+        {
+            if (GlobalC::exx_info.info_ri.real_number)
+            {
+                this->exd->write_CVs_restart();
+            }
+            else
+            {
+                this->exc->write_CVs_restart();
+            }
+        }
     }
 #endif
 
@@ -59,7 +59,9 @@ void ESolver_KS_LCAO<TK, TR>::before_scf(UnitCell& ucell, const int istep)
                          this->gd,
                          ucell,
                          search_radius,
-                         PARAM.inp.test_atom_input);
+                         PARAM.inp.test_atom_input,
+                         false,
+                         PARAM.inp.search_skin);
 
     //! 4) initialize NAO basis set 
     double dr_uniform = 0.001;
@@ -68,7 +70,19 @@ void ESolver_KS_LCAO<TK, TR>::before_scf(UnitCell& ucell, const int istep)
     std::vector<std::vector<double>> dpsi_u;
     std::vector<std::vector<double>> d2psi_u;
 
-    Gint_Tools::init_orb(dr_uniform, rcuts, ucell, orb_, psi_u, dpsi_u, d2psi_u);
+    // the radial tables do not depend on the atomic positions,
+    // so they are tabulated in the first ionic step and taken back from GridT later
+    if (this->GridT.psi_u.empty())
+    {
+        Gint_Tools::init_orb(dr_uniform, rcuts, ucell, orb_, psi_u, dpsi_u, d2psi_u);
+    }
+    else
+    {
+        rcuts.swap(this->GridT.rcuts);
+        psi_u.swap(this->GridT.psi_u);
+        dpsi_u.swap(this->GridT.dpsi_u);
+        d2psi_u.swap(this->GridT.d2psi_u);
+    }
 
     //! 5) set periodic boundary conditions
     this->GridT.set_pbc_grid(this->pw_rho->nx,
@@ -174,11 +188,16 @@ void ESolver_KS_LCAO<TK, TR>::before_scf(UnitCell& ucell, const int istep)
 
 
     // 11) initialize the Hamiltonian operators
-    // if atom moves, then delete old pointer and add a new one
+    // if atom moves, update the atom-pairs of the operators,
+    // or delete old pointer and add a new one if any operator does not support the update
     if (this->p_hamilt != nullptr)
     {
-        delete this->p_hamilt;
-        this->p_hamilt = nullptr;
+        auto* hamilt_lcao = dynamic_cast<hamilt::HamiltLCAO<TK, TR>*>(this->p_hamilt);
+        if (hamilt_lcao == nullptr || !hamilt_lcao->update_atoms(this->gd))
+        {
+            delete this->p_hamilt;
+            this->p_hamilt = nullptr;
+        }
     }
     if (this->p_hamilt == nullptr)
     {
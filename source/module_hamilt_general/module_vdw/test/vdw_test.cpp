@@ -5,6 +5,10 @@
 #include"gtest/gtest.h"
 #include"gmock/gmock.h"
 #include "mpi.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <chrono>
 #define private public
 #include "module_hamilt_general/module_vdw/vdwd2_parameters.h"
 #include "module_hamilt_general/module_vdw/vdwd3_parameters.h"
@@ -26,6 +30,9 @@
 *       Calculate the VDW (d2, d3_0 and d3_bj types) enerygy, force, stress.    
 *   - Vdwd2Parameters::initial_parameters()
 *   - Vdwd3Parameters::initial_parameters()
+*   - Vdwd3 on supercells:
+*       The energy per cell, forces and stress are the same as the unit cell,
+*       and the time of the neighbor search and the three-body term grows linearly with the atoms.
 */
 
 pseudo::pseudo()
@@ -593,6 +600,84 @@ TEST_F(vdwd3abcTest, D3bjGetStress)
     EXPECT_NEAR(stress.e33, -3.4278442125590892e-05,1e-12);
 }
 
+// the n*n*n supercell of ucell, the atoms of each type are in the order of the cells
+stru_ make_supercell(const UnitCell &ucell, const int n)
+{
+    const ModuleBase::Vector3<double> a[3] = {ucell.a1, ucell.a2, ucell.a3};
+    stru_ stru;
+    for (int i = 0; i < 3; i++)
+    {
+        stru.cell.insert(stru.cell.end(), {n * a[i].x, n * a[i].y, n * a[i].z});
+    }
+    for (int it = 0; it < ucell.ntype; it++)
+    {
+        atomtype_ type{ucell.atoms[it].label, {}};
+        for (int ia = 0; ia < ucell.atoms[it].na; ia++)
+        {
+            for (int ix = 0; ix < n; ix++)
+            {
+                for (int iy = 0; iy < n; iy++)
+                {
+                    for (int iz = 0; iz < n; iz++)
+                    {
+                        const ModuleBase::Vector3<double> tau
+                            = ucell.atoms[it].tau[ia] + static_cast<double>(ix) * a[0] + static_cast<double>(iy) * a[1]
+                              + static_cast<double>(iz) * a[2];
+                        type.coordinate.push_back({tau.x, tau.y, tau.z});
+                    }
+                }
+            }
+        }
+        stru.all_type.push_back(type);
+    }
+    return stru;
+}
+
+TEST_F(vdwd3abcTest, D3bjSupercell)
+{
+    input.vdw_method = "d3_bj";
+    auto vdw_solver = vdw::make_vdw(ucell, input);
+    const double ene = vdw_solver->get_energy();
+    const std::vector<ModuleBase::Vector3<double>> force = vdw_solver->get_force();
+    const ModuleBase::Matrix3 stress = vdw_solver->get_stress();
+
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    for (const int n: {2, 3})
+    {
+        UnitCell ucell_super;
+        stru_ supercell = make_supercell(ucell, n);
+        construct_ucell(supercell, ucell_super);
+        const int ncell = n * n * n;
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        auto vdw_super = vdw::make_vdw(ucell_super, input);
+        const double ene_super = vdw_super->get_energy();
+        const std::vector<ModuleBase::Vector3<double>> force_super = vdw_super->get_force();
+        const ModuleBase::Matrix3 stress_super = vdw_super->get_stress();
+        auto t1 = std::chrono::high_resolution_clock::now();
+
+        EXPECT_NEAR(ene_super, ene * ncell, 1e-10 * ncell);
+        for (int iat = 0; iat < ucell_super.nat; iat++)
+        {
+            EXPECT_NEAR(force_super[iat].x, force[iat / ncell].x, 1e-12);
+            EXPECT_NEAR(force_super[iat].y, force[iat / ncell].y, 1e-12);
+            EXPECT_NEAR(force_super[iat].z, force[iat / ncell].z, 1e-12);
+        }
+        EXPECT_NEAR(stress_super.e11, stress.e11, 1e-12);
+        EXPECT_NEAR(stress_super.e12, stress.e12, 1e-12);
+        EXPECT_NEAR(stress_super.e13, stress.e13, 1e-12);
+        EXPECT_NEAR(stress_super.e22, stress.e22, 1e-12);
+        EXPECT_NEAR(stress_super.e23, stress.e23, 1e-12);
+        EXPECT_NEAR(stress_super.e33, stress.e33, 1e-12);
+        std::cout << "nat: " << ucell_super.nat << ", threads: " << nthreads << ", energy + force + stress: "
+                  << std::chrono::duration_cast<std::chrono::duration<double>>(t1 - t0).count() << " s" << std::endl;
+        ClearUcell(ucell_super);
+    }
+}
+
 int main(int argc, char **argv)
 {
     MPI_Init(&argc, &argv);
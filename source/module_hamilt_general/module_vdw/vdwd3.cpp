@@ -11,9 +11,104 @@
 #include "module_base/global_function.h"
 #include "module_base/timer.h"
 
+#include <algorithm>
+
 namespace vdw
 {
 
+namespace
+{
+// whether all the components of the lattice translation t are in [-rep, rep]
+inline bool in_rep(const ModuleBase::Vector3<int> &t, const std::vector<int> &rep)
+{
+    return std::abs(t.x) <= rep[0] && std::abs(t.y) <= rep[1] && std::abs(t.z) <= rep[2];
+}
+
+// add the gradient dedr of the pair energy to the atoms iat, jat and to the virial,
+// rij is the vector from iat to jat
+inline void add_pair_gradient(const double dedr,
+                              const ModuleBase::Vector3<double> &rij,
+                              const double r,
+                              const int iat,
+                              const int jat,
+                              std::vector<ModuleBase::Vector3<double>> &g,
+                              ModuleBase::matrix &sigma)
+{
+    const ModuleBase::Vector3<double> vec = dedr * rij / r;
+    g[iat] += vec;
+    g[jat] -= vec;
+    for (int i = 0; i != 3; i++)
+    {
+        for (int j = 0; j != 3; j++)
+        {
+            sigma(i, j) += vec[j] * rij[i];
+        }
+    }
+}
+
+// the derivative of the angular term of the three-body energy with respect to the side r = sqrt(r2),
+// r2_b and r2_c are the squares of the other two sides, geomean3 * geomean2 = (rij*rik*rjk)^5
+inline double dang_dr(const double r2, const double r2_b, const double r2_c, const double r, const double geomean5)
+{
+    return -0.375
+           * (r2 * r2 * r2 + r2 * r2 * (r2_b + r2_c) + r2 * (3.0 * r2_b * r2_b + 2.0 * r2_b * r2_c + 3.0 * r2_c * r2_c)
+              - 5.0 * (r2_b - r2_c) * (r2_b - r2_c) * (r2_b + r2_c))
+           / (r * geomean5);
+}
+
+// the pair p of the atoms iat >= p.jat seen from p.jat, the derivatives are swapped
+template <typename Pair>
+inline Pair reverse_pair(const Pair &p, const int iat)
+{
+    return Pair{iat, p.c6, p.dc6j, p.dc6i};
+}
+
+// the images of each atom put together, in the order of the atoms, so that the pairs of an atom
+// are scattered once for all its images
+template <typename Neighbor>
+inline void sort_by_atom(std::vector<Neighbor> &neighbors)
+{
+    std::sort(neighbors.begin(), neighbors.end(), [](const Neighbor &a, const Neighbor &b) { return a.jat < b.jat; });
+}
+
+// row[p.jat] = p for the pairs p of one atom with the atoms p.jat <= max_jat, pairs are in the order of p.jat
+template <typename Pair>
+inline void scatter_pairs(const std::vector<Pair> &pairs, const int max_jat, std::vector<Pair> &row)
+{
+    for (const Pair &p: pairs)
+    {
+        if (p.jat > max_jat)
+        {
+            break;
+        }
+        row[p.jat] = p;
+    }
+}
+
+// row[p.jat] = C6 of the pairs p as above
+template <typename Pair>
+inline void scatter_pairs(const std::vector<Pair> &pairs, const int max_jat, std::vector<double> &row)
+{
+    for (const Pair &p: pairs)
+    {
+        if (p.jat > max_jat)
+        {
+            break;
+        }
+        row[p.jat] = p.c6;
+    }
+}
+
+// x^alp9 of the damping function of the three-body term, alp9 = -16
+inline double pow_alp9(const double x)
+{
+    const double x2 = x * x;
+    const double x4 = x2 * x2;
+    const double x8 = x4 * x4;
+    return 1.0 / (x8 * x8);
+}
+} // namespace
+
 void Vdwd3::init()
 {
     lat_.resize(3);
@@ -22,13 +117,18 @@ void Vdwd3::init()
     lat_[2] = ucell_.a3 * ucell_.lat0;
 
     std::vector<double> at_kind = atom_kind();
+    iz_.clear();
+    xyz_.clear();
     iz_.reserve(ucell_.nat);
     xyz_.reserve(ucell_.nat);
+    std::vector<ModuleBase::Vector3<double>> taud;
+    taud.reserve(ucell_.nat);
     for (size_t it = 0; it != ucell_.ntype; it++) {
         for (size_t ia = 0; ia != ucell_.atoms[it].na; ia++)
         {
             iz_.emplace_back(at_kind[it]);
             xyz_.emplace_back(ucell_.atoms[it].tau[ia] * ucell_.lat0);
+            taud.emplace_back(ucell_.atoms[it].taud[ia]);
         }
 }
 
@@ -50,6 +150,132 @@ void Vdwd3::init()
     for (size_t i = 0; i < 3; i++) {
         rep_cn_[i] = ceil(tau_max[i]);
 }
+
+    build_bins(taud);
+}
+
+void Vdwd3::build_bins(const std::vector<ModuleBase::Vector3<double>> &taud)
+{
+    const double volume = std::abs(lat_[0] * (lat_[1] ^ lat_[2]));
+    plane_dist_.resize(3);
+    plane_dist_[0] = volume / (lat_[1] ^ lat_[2]).norm();
+    plane_dist_[1] = volume / (lat_[2] ^ lat_[0]).norm();
+    plane_dist_[2] = volume / (lat_[0] ^ lat_[1]).norm();
+
+    // the bins are about half of the smaller cutoff thick, a small cell is one bin
+    const double r_bin = 0.5 * std::sqrt(std::min(para_.rthr2(), para_.cn_thr2()));
+    nbin_.resize(3);
+    for (int i = 0; i < 3; i++)
+    {
+        nbin_[i] = std::max(1, static_cast<int>(plane_dist_[i] / r_bin));
+    }
+
+    // half of the longest diagonal of a bin
+    const ModuleBase::Vector3<double> e0 = lat_[0] / static_cast<double>(nbin_[0]);
+    const ModuleBase::Vector3<double> e1 = lat_[1] / static_cast<double>(nbin_[1]);
+    const ModuleBase::Vector3<double> e2 = lat_[2] / static_cast<double>(nbin_[2]);
+    bin_radius_ = 0.5
+                  * std::sqrt(std::max(std::max((e0 + e1 + e2).norm2(), (e0 + e1 - e2).norm2()),
+                                       std::max((e0 - e1 + e2).norm2(), (e1 + e2 - e0).norm2())));
+
+    // the atoms are put back into the cell, xyz_ = xyz_cell_ + shift_ * lat_
+    const int nat = ucell_.nat;
+    shift_.resize(nat);
+    xyz_cell_.resize(nat);
+    atom_bin_.resize(nat);
+    std::vector<int> ibin(nat);
+    bin_start_.assign(nbin_[0] * nbin_[1] * nbin_[2] + 1, 0);
+    for (int iat = 0; iat < nat; iat++)
+    {
+        int b[3];
+        for (int i = 0; i < 3; i++)
+        {
+            shift_[iat][i] = static_cast<int>(std::floor(taud[iat][i]));
+            b[i] = std::min(nbin_[i] - 1, static_cast<int>((taud[iat][i] - shift_[iat][i]) * nbin_[i]));
+        }
+        xyz_cell_[iat] = xyz_[iat] - static_cast<double>(shift_[iat].x) * lat_[0]
+                         - static_cast<double>(shift_[iat].y) * lat_[1] - static_cast<double>(shift_[iat].z) * lat_[2];
+        atom_bin_[iat].set(b[0], b[1], b[2]);
+        ibin[iat] = (b[0] * nbin_[1] + b[1]) * nbin_[2] + b[2];
+        ++bin_start_[ibin[iat] + 1];
+    }
+    for (size_t ib = 1; ib < bin_start_.size(); ib++)
+    {
+        bin_start_[ib] += bin_start_[ib - 1];
+    }
+    bin_atom_.resize(nat);
+    std::vector<int> pos(bin_start_.begin(), bin_start_.end() - 1);
+    for (int iat = 0; iat < nat; iat++)
+    {
+        bin_atom_[pos[ibin[iat]]++] = iat;
+    }
+}
+
+void Vdwd3::search_neighbors(const int iat,
+                             const double rthr2,
+                             const std::vector<int> &rep,
+                             const bool half,
+                             std::vector<Neighbor> &neighbors) const
+{
+    neighbors.clear();
+    const double rcut = std::sqrt(rthr2);
+    int nsearch[3];
+    for (int i = 0; i < 3; i++)
+    {
+        nsearch[i] = static_cast<int>(std::ceil(rcut * nbin_[i] / plane_dist_[i]));
+    }
+
+    // the bins bx, by, bz out of the cell are the bins wx, wy, wz in the cell shifted by nx, ny, nz,
+    // only the bins overlapping with the sphere of rcut are searched
+    const double rbin2 = (rcut + bin_radius_) * (rcut + bin_radius_);
+    Neighbor nb;
+    for (int bx = atom_bin_[iat].x - nsearch[0]; bx <= atom_bin_[iat].x + nsearch[0]; bx++)
+    {
+        const int nx = static_cast<int>(std::floor(static_cast<double>(bx) / nbin_[0]));
+        const int wx = bx - nx * nbin_[0];
+        for (int by = atom_bin_[iat].y - nsearch[1]; by <= atom_bin_[iat].y + nsearch[1]; by++)
+        {
+            const int ny = static_cast<int>(std::floor(static_cast<double>(by) / nbin_[1]));
+            const int wy = by - ny * nbin_[1];
+            for (int bz = atom_bin_[iat].z - nsearch[2]; bz <= atom_bin_[iat].z + nsearch[2]; bz++)
+            {
+                const ModuleBase::Vector3<double> center = (bx + 0.5) / nbin_[0] * lat_[0]
+                                                           + (by + 0.5) / nbin_[1] * lat_[1]
+                                                           + (bz + 0.5) / nbin_[2] * lat_[2];
+                if ((center - xyz_cell_[iat]).norm2() > rbin2)
+                {
+                    continue;
+                }
+                const int nz = static_cast<int>(std::floor(static_cast<double>(bz) / nbin_[2]));
+                const int wz = bz - nz * nbin_[2];
+                const int ib = (wx * nbin_[1] + wy) * nbin_[2] + wz;
+                const ModuleBase::Vector3<double> tau_bin = static_cast<double>(nx) * lat_[0]
+                                                            + static_cast<double>(ny) * lat_[1]
+                                                            + static_cast<double>(nz) * lat_[2] - xyz_cell_[iat];
+                for (int ia = bin_start_[ib]; ia < bin_start_[ib + 1]; ia++)
+                {
+                    const int jat = bin_atom_[ia];
+                    if (half && jat > iat)
+                    {
+                        continue;
+                    }
+                    nb.rij = xyz_cell_[jat] + tau_bin;
+                    nb.r2 = nb.rij.norm2();
+                    if (nb.r2 > rthr2)
+                    {
+                        continue;
+                    }
+                    nb.t = ModuleBase::Vector3<int>(nx, ny, nz) - shift_[jat] + shift_[iat];
+                    if (!in_rep(nb.t, rep) || (jat == iat && nb.t.x == 0 && nb.t.y == 0 && nb.t.z == 0))
+                    {
+                        continue;
+                    }
+                    nb.jat = jat;
+                    neighbors.push_back(nb);
+                }
+            }
+        }
+    }
 }
 
 void Vdwd3::set_criteria(double rthr, const std::vector<ModuleBase::Vector3<double>> &lat, std::vector<double> &tau_max)
@@ -88,174 +314,66 @@ void Vdwd3::cal_energy()
     ModuleBase::timer::tick("Vdwd3", "cal_energy");
     init();
 
-    int ij;
-    double c6 = 0.0, c8 = 0.0, r2 = 0.0, r6 = 0.0, r8 = 0.0, rr = 0.0, damp6 = 0.0, damp8 = 0.0;
-    double e6 = 0.0, e8 = 0.0, eabc = 0.0;
-    std::vector<double> cc6ab(ucell_.nat * ucell_.nat), cn(ucell_.nat);
+    const int nat = ucell_.nat;
+    std::vector<double> cn(nat);
     pbc_ncoord(cn);
-    ModuleBase::Vector3<double> tau;
-    if (para_.version() == "d3_0") // DFT-D3(zero-damping)
-    {
-        double tmp;
-        for (int iat = 0; iat != ucell_.nat - 1; iat++) {
-            for (int jat = iat + 1; jat != ucell_.nat; jat++)
-            {
-                get_c6(iz_[iat], iz_[jat], cn[iat], cn[jat], c6);
-                if (para_.abc()) // three-body term
-                {
-                    ij = lin(iat, jat);
-                    cc6ab[ij] = std::sqrt(c6);
-                }
-                for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++) {
-                    for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++) {
-                        for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                        {
-                            tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                                  + static_cast<double>(tauz) * lat_[2];
-                            r2 = (xyz_[iat] - xyz_[jat] + tau).norm2(); // |r+T|^2
-                            if (r2 > para_.rthr2()) { // neglect the distance larger than rthr2
-                                continue;
-}
-                            rr = para_.r0ab()[iz_[iat]][iz_[jat]] / std::sqrt(r2);
-                            // zero-damping function
-                            tmp = para_.rs6() * rr;
-                            damp6 = 1.0 / (1.0 + 6.0 * std::pow(tmp, para_.alp6()));
-                            tmp = para_.rs18() * rr;
-                            damp8 = 1.0 / (1.0 + 6.0 * std::pow(tmp, para_.alp8()));
-
-                            r6 = std::pow(r2, 3);
-                            e6 += damp6 / r6 * c6;
-
-                            c8 = 3.0 * para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]] * c6;
-                            r8 = r6 * r2;
-                            e8 += c8 * damp8 / r8;
-                        } // end tau
-}
-}
-            } // end jat
-}
-
-        for (int iat = 0; iat != ucell_.nat; iat++)
-        {
-            int jat = iat;
-            get_c6(iz_[iat], iz_[jat], cn[iat], cn[jat], c6);
-            if (para_.abc())
-            {
-                ij = lin(iat, jat);
-                cc6ab[ij] = std::sqrt(c6);
-            }
-            for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++) {
-                for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++) {
-                    for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                    {
-                        if (taux == 0 && tauy == 0 && tauz == 0) {
-                            continue;
-}
-                        tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                              + static_cast<double>(tauz) * lat_[2];
-                        r2 = tau.norm2();
-                        if (r2 > para_.rthr2()) {
-                            continue;
-}
-                        rr = para_.r0ab()[iz_[iat]][iz_[jat]] / std::sqrt(r2);
 
-                        // zero-damping function
-                        tmp = para_.rs6() * rr;
-                        damp6 = 1.0 / (1.0 + 6.0 * std::pow(tmp, para_.alp6()));
-                        tmp = para_.rs18() * rr;
-                        damp8 = 1.0 / (1.0 + 6.0 * std::pow(tmp, para_.alp8()));
-
-                        r6 = std::pow(r2, 3);
-                        e6 += damp6 / r6 * c6 * 0.5;
-
-                        c8 = 3.0 * para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]] * c6;
-                        r8 = r6 * r2;
-                        e8 += c8 * damp8 / r8 * 0.5;
-                    } // end tau
-}
-}
-        } // end iat
-    } // end d3_0
-    else if (para_.version() == "d3_bj") // DFT-D3(BJ-damping)
+    const bool zero_damping = para_.version() == "d3_0";
+    const bool bj_damping = para_.version() == "d3_bj";
+    double e6 = 0.0, e8 = 0.0, eabc = 0.0;
+#pragma omp parallel reduction(+ : e6, e8)
     {
-        double r42;
-        for (int iat = 0; iat != ucell_.nat; iat++)
+        std::vector<Neighbor> neighbors;
+        // C6 of iat with jat is computed the first time jat is met in the neighbors of iat,
+        // and shared by all the images of jat, row_iat[jat] is the iat of row[jat]
+        std::vector<PairC6> row(nat);
+        std::vector<int> row_iat(nat, -1);
+#pragma omp for schedule(dynamic)
+        for (int iat = 0; iat < nat; iat++)
         {
-            for (int jat = iat + 1; jat != ucell_.nat; jat++)
+            search_neighbors(iat, para_.rthr2(), rep_vdw_, true, neighbors);
+            for (const Neighbor &nb: neighbors)
             {
-                get_c6(iz_[iat], iz_[jat], cn[iat], cn[jat], c6);
-                if (para_.abc())
+                const int jat = nb.jat;
+                if (row_iat[jat] != iat)
                 {
-                    ij = lin(iat, jat);
-                    cc6ab[ij] = std::sqrt(c6);
+                    row_iat[jat] = iat;
+                    cal_pair_c6(iat, jat, cn, false, row[jat]);
                 }
-                for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++) {
-                    for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++) {
-                        for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                        {
-                            tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                                  + static_cast<double>(tauz) * lat_[2];
-                            r2 = (xyz_[iat] - xyz_[jat] + tau).norm2();
-                            if (r2 > para_.rthr2()) {
-                                continue;
-}
-                            rr = para_.r0ab()[iz_[iat]][iz_[jat]] / std::sqrt(r2);
-
-                            // BJ-damping function
-                            r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]];
-                            damp6 = std::pow((para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18()), 6);
-                            damp8 = std::pow((para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18()), 8);
+                // the atom and its own image are counted from both sides
+                const double fac = (jat == iat) ? 0.5 : 1.0;
+                const double c6 = row[jat].c6;
+                const double r6 = std::pow(nb.r2, 3);
+                const double r8 = r6 * nb.r2;
+                if (zero_damping) // DFT-D3(zero-damping)
+                {
+                    const double rr = para_.r0ab()[iz_[jat]][iz_[iat]] / std::sqrt(nb.r2);
+                    const double damp6 = 1.0 / (1.0 + 6.0 * std::pow(para_.rs6() * rr, para_.alp6()));
+                    const double damp8 = 1.0 / (1.0 + 6.0 * std::pow(para_.rs18() * rr, para_.alp8()));
+                    e6 += damp6 / r6 * c6 * fac;
 
-                            r6 = std::pow(r2, 3);
-                            e6 += c6 / (r6 + damp6);
+                    const double c8 = 3.0 * para_.r2r4()[iz_[jat]] * para_.r2r4()[iz_[iat]] * c6;
+                    e8 += c8 * damp8 / r8 * fac;
+                }
+                else if (bj_damping) // DFT-D3(BJ-damping)
+                {
+                    const double r42 = para_.r2r4()[iz_[jat]] * para_.r2r4()[iz_[iat]];
+                    const double damp6 = std::pow((para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18()), 6);
+                    const double damp8 = std::pow((para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18()), 8);
+                    e6 += c6 / (r6 + damp6) * fac;
 
-                            c8 = 3.0 * c6 * r42;
-                            r8 = r6 * r2;
-                            e8 += c8 / (r8 + damp8);
-                        } // end tau
-}
-}
-            } // end jat
-            int jat = iat;
-            get_c6(iz_[iat], iz_[jat], cn[iat], cn[jat], c6);
-            r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]];
-            damp6 = std::pow((para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18()), 6);
-            damp8 = std::pow((para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18()), 8);
-            if (para_.abc())
-            {
-                ij = lin(iat, jat);
-                cc6ab[ij] = std::sqrt(c6);
+                    const double c8 = 3.0 * c6 * r42;
+                    e8 += c8 / (r8 + damp8) * fac;
+                }
             }
-            for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++) {
-                for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++) {
-                    for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                    {
-                        if (taux == 0 && tauy == 0 && tauz == 0) {
-                            continue;
-}
-                        tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                              + static_cast<double>(tauz) * lat_[2];
-                        r2 = tau.norm2();
-                        if (r2 > para_.rthr2()) {
-                            continue;
-}
-                        rr = para_.r0ab()[iz_[iat]][iz_[jat]] / std::sqrt(r2);
-
-                        r6 = std::pow(r2, 3);
-                        e6 += c6 / (r6 + damp6) * 0.5;
-
-                        c8 = 3.0 * c6 * r42;
-                        r8 = r6 * r2;
-                        e8 += c8 / (r8 + damp8) * 0.5;
-                    } // end tau
-}
-}
-        } // end iat
-    } // end d3_bj
+        }
+    }
 
-    if (para_.abc())
+    if (para_.abc()) // three-body term
     {
-        pbc_three_body(iz_, lat_, xyz_, rep_cn_, cc6ab, eabc);
+        std::vector<std::vector<PairC6>> pair_c6;
+        const bool dense = set_pair_c6(cn, false, pair_c6);
+        pbc_three_body(pair_c6, dense, eabc);
     }
     energy_ = (-para_.s6() * e6 - para_.s18() * e8 - eabc) * 2;
     ModuleBase::timer::tick("Vdwd3", "cal_energy");
@@ -333,357 +451,204 @@ void Vdwd3::get_c6(int iat, int jat, double nci, double ncj, double &c6)
 
 void Vdwd3::pbc_ncoord(std::vector<double> &cn)
 {
-    for (size_t i = 0; i != ucell_.nat; i++)
+#pragma omp parallel
     {
-        double xn = 0.0;
-        ModuleBase::Vector3<double> tau;
-        double r2, rr;
-        for (size_t iat = 0; iat != ucell_.nat; iat++) {
-            for (int taux = -rep_cn_[0]; taux <= rep_cn_[0]; taux++) {
-                for (int tauy = -rep_cn_[1]; tauy <= rep_cn_[1]; tauy++) {
-                    for (int tauz = -rep_cn_[2]; tauz <= rep_cn_[2]; tauz++)
-                    {
-                        if (iat == i && taux == 0 && tauy == 0 && tauz == 0) {
-                            continue;
-}
-                        tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                              + static_cast<double>(tauz) * lat_[2];
-                        r2 = (xyz_[iat] - xyz_[i] + tau).norm2();
-                        if (r2 > para_.cn_thr2()) {
-                            continue;
-}
-                        rr = (para_.rcov()[iz_[i]] + para_.rcov()[iz_[iat]]) / std::sqrt(r2);
-                        xn += 1.0 / (1.0 + exp(-para_.k1() * (rr - 1.0)));
-                    }
-}
-}
+        std::vector<Neighbor> neighbors;
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < ucell_.nat; i++)
+        {
+            search_neighbors(i, para_.cn_thr2(), rep_cn_, false, neighbors);
+            double xn = 0.0;
+            for (const Neighbor &nb: neighbors)
+            {
+                const double rr = (para_.rcov()[iz_[i]] + para_.rcov()[iz_[nb.jat]]) / std::sqrt(nb.r2);
+                xn += 1.0 / (1.0 + exp(-para_.k1() * (rr - 1.0)));
+            }
+            cn[i] = xn;
+        }
+    }
 }
-        cn[i] = xn;
+
+void Vdwd3::cal_pair_c6(const int iat,
+                        const int jat,
+                        const std::vector<double> &cn,
+                        const bool derivative,
+                        PairC6 &pair)
+{
+    pair.jat = jat;
+    pair.dc6i = 0.0;
+    pair.dc6j = 0.0;
+    if (derivative)
+    {
+        get_dc6_dcnij(para_.mxc()[iz_[iat]], para_.mxc()[iz_[jat]], cn[iat], cn[jat],
+                      iz_[iat], iz_[jat], iat, jat, pair.c6, pair.dc6i, pair.dc6j);
+    }
+    else
+    {
+        get_c6(iz_[jat], iz_[iat], cn[jat], cn[iat], pair.c6);
     }
 }
 
-void Vdwd3::pbc_three_body(const std::vector<int> &iz,
-                           const std::vector<ModuleBase::Vector3<double>> &lat,
-                           const std::vector<ModuleBase::Vector3<double>> &xyz,
-                           const std::vector<int> &rep_cn,
-                           const std::vector<double> &cc6ab,
-                           double &eabc)
+bool Vdwd3::set_pair_c6(const std::vector<double> &cn,
+                        const bool derivative,
+                        std::vector<std::vector<PairC6>> &pair_c6)
 {
-    double sr9 = 0.75, alp9 = -16.0;
-    int ij, ik, jk;
-    double r0ij, r0ik, r0jk, c9, rij2, rik2, rjk2, rr0ij, rr0ik, rr0jk, geomean, fdamp, tmp1, tmp2, tmp3, tmp4, ang;
-    ModuleBase::Vector3<double> ijvec, ikvec, jkvec, jtau, ktau;
-    std::vector<double> repmin(3), repmax(3);
-    for (int iat = 2; iat != ucell_.nat; iat++) {
-        for (int jat = 1; jat != iat; jat++)
+    const int nat = ucell_.nat;
+    pair_c6.clear();
+    pair_c6.resize(nat);
+#pragma omp parallel
+    {
+        std::vector<Neighbor> neighbors;
+        std::vector<int> jats;
+#pragma omp for schedule(dynamic)
+        for (int iat = 0; iat < nat; iat++)
         {
-            ijvec = xyz_[jat] - xyz_[iat];
-            ij = lin(iat, jat);
-            r0ij = para_.r0ab()[iz_[jat]][iz_[iat]];
-            for (int kat = 0; kat != jat; kat++)
+            // each atom jat <= iat within cn_thr once, for all its images
+            search_neighbors(iat, para_.cn_thr2(), rep_cn_, true, neighbors);
+            jats.clear();
+            for (const Neighbor &nb: neighbors)
             {
-                ik = lin(iat, kat);
-                jk = lin(jat, kat);
-                ikvec = xyz_[kat] - xyz_[iat];
-                jkvec = xyz_[kat] - xyz_[jat];
-                c9 = -cc6ab[ij] * cc6ab[ik] * cc6ab[jk];
-
-                r0ik = para_.r0ab()[iz_[kat]][iz_[iat]];
-                r0jk = para_.r0ab()[iz_[kat]][iz_[jat]];
-
-                for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
-                {
-                    repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                    repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                    for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
-                    {
-                        repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                        repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                        for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
-                        {
-                            repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                            repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                            jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                                   + static_cast<double>(jtauz) * lat_[2];
-                            rij2 = (ijvec + jtau).norm2();
-                            if (rij2 > para_.cn_thr2()) {
-                                continue;
-}
-                            rr0ij = std::sqrt(rij2) / r0ij;
-
-                            for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++) {
-                                for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++) {
-                                    for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                    {
-                                        ktau = static_cast<double>(ktaux) * lat_[0]
-                                               + static_cast<double>(ktauy) * lat_[1]
-                                               + static_cast<double>(ktauz) * lat_[2];
-                                        rik2 = (ikvec + ktau).norm2();
-                                        if (rik2 > para_.cn_thr2()) {
-                                            continue;
-}
-                                        rr0ik = std::sqrt(rik2) / r0ik;
-
-                                        rjk2 = (jkvec + ktau - jtau).norm2();
-                                        if (rjk2 > para_.cn_thr2()) {
-                                            continue;
-}
-                                        rr0jk = std::sqrt(rjk2) / r0jk;
-
-                                        geomean = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                        fdamp = 1.0 / (1.0 + 6.0 * std::pow(sr9 * geomean, alp9));
-                                        tmp1 = (rij2 + rjk2 - rik2);
-                                        tmp2 = (rij2 + rik2 - rjk2);
-                                        tmp3 = (rik2 + rjk2 - rij2);
-                                        tmp4 = rij2 * rjk2 * rik2;
-
-                                        ang = (0.375 * tmp1 * tmp2 * tmp3 / tmp4 + 1.0) / std::pow(tmp4, 1.5);
+                jats.push_back(nb.jat);
+            }
+            std::sort(jats.begin(), jats.end());
+            jats.erase(std::unique(jats.begin(), jats.end()), jats.end());
 
-                                        eabc += ang * c9 * fdamp;
-                                    } // end ktau
-}
-}
-                        } // end jtauz
-                    } // end jtauy
-                } // end jtaux
-            } // end kat
-        } // end jat
-}
-    // end iat
+            std::vector<PairC6> &pairs = pair_c6[iat];
+            pairs.resize(jats.size());
+            for (size_t a = 0; a < jats.size(); a++)
+            {
+                cal_pair_c6(iat, jats[a], cn, derivative, pairs[a]);
+            }
+        }
+    }
 
-    for (int iat = 1; iat != ucell_.nat; iat++)
+    // if most of the pairs of atoms are within cn_thr, the full lists would not be smaller than a dense
+    // table of the pairs iat >= jat, which is used instead with the pairs out of cn_thr left zero
+    size_t nfull = 0;
+    for (int iat = 0; iat < nat; iat++)
     {
-        int jat = iat;
-        ij = lin(iat, jat);
-        ijvec.set(0, 0, 0);
-        r0ij = para_.r0ab()[iz_[jat]][iz_[iat]];
-        for (int kat = 0; kat != iat; kat++)
+        nfull += 2 * pair_c6[iat].size() - (!pair_c6[iat].empty() && pair_c6[iat].back().jat == iat);
+    }
+    if (nfull >= static_cast<size_t>(nat) * (nat + 1) / 2)
+    {
+        std::vector<PairC6> pairs;
+#pragma omp parallel for schedule(dynamic) private(pairs)
+        for (int iat = 0; iat < nat; iat++)
         {
-            jk = lin(jat, kat);
-            ik = jk;
-            ikvec = xyz_[kat] - xyz_[iat];
-            jkvec = ikvec;
-            c9 = -cc6ab[ij] * cc6ab[ik] * cc6ab[jk];
-
-            r0ik = para_.r0ab()[iz_[kat]][iz_[iat]];
-            r0jk = para_.r0ab()[iz_[kat]][iz_[jat]];
-            for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
+            pairs.assign(iat + 1, PairC6{0, 0.0, 0.0, 0.0});
+            for (int jat = 0; jat <= iat; jat++)
             {
-                repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
-                {
-                    repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                    repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                    for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
-                    {
-                        repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                        repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                        if (jtaux == 0 && jtauy == 0 && jtauz == 0) {
-                            continue;
-}
-                        jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                               + static_cast<double>(jtauz) * lat_[2];
-                        rij2 = (ijvec + jtau).norm2();
-                        if (rij2 > para_.cn_thr2()) {
-                            continue;
-}
-                        rr0ij = std::sqrt(rij2) / r0ij;
-
-                        for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++) {
-                            for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++) {
-                                for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                {
-                                    ktau = static_cast<double>(ktaux) * lat_[0] + static_cast<double>(ktauy) * lat_[1]
-                                           + static_cast<double>(ktauz) * lat_[2];
-                                    rik2 = (ikvec + ktau).norm2();
-                                    if (rik2 > para_.cn_thr2()) {
-                                        continue;
-}
-                                    rr0ik = std::sqrt(rik2) / r0ik;
-
-                                    rjk2 = (jkvec + ktau - jtau).norm2();
-                                    if (rjk2 > para_.cn_thr2()) {
-                                        continue;
-}
-                                    rr0jk = std::sqrt(rjk2) / r0jk;
-
-                                    geomean = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                    fdamp = 1.0 / (1.0 + 6.0 * std::pow(sr9 * geomean, alp9));
-                                    tmp1 = (rij2 + rjk2 - rik2);
-                                    tmp2 = (rij2 + rik2 - rjk2);
-                                    tmp3 = (rik2 + rjk2 - rij2);
-                                    tmp4 = rij2 * rjk2 * rik2;
-
-                                    ang = (0.375 * tmp1 * tmp2 * tmp3 / tmp4 + 1.0) / std::pow(tmp4, 1.5);
+                pairs[jat].jat = jat;
+            }
+            for (const PairC6 &p: pair_c6[iat])
+            {
+                pairs[p.jat] = p;
+            }
+            pair_c6[iat].swap(pairs);
+        }
+        return true;
+    }
 
-                                    eabc += ang * c9 * fdamp / 2.0;
-                                } // end ktau
-}
-}
-                    } // end jtauz
-                } // end jtauy
-            } // end jtaux
-        } // end kat
-    } // end iat
-
-    for (int iat = 1; iat != ucell_.nat; iat++) {
-        for (int jat = 0; jat != iat; jat++)
+    // or else the pairs jat < iat are copied to the list of jat, with the derivatives swapped,
+    // which keeps the lists in the order of jat
+    std::vector<size_t> nhalf(nat), npair(nat);
+    for (int iat = 0; iat < nat; iat++)
+    {
+        nhalf[iat] = pair_c6[iat].size();
+        npair[iat] += nhalf[iat];
+        for (const PairC6 &p: pair_c6[iat])
+        {
+            npair[p.jat] += (p.jat != iat);
+        }
+    }
+    for (int iat = 0; iat < nat; iat++)
+    {
+        pair_c6[iat].reserve(npair[iat]);
+    }
+    for (int iat = 0; iat < nat; iat++)
+    {
+        for (size_t a = 0; a < nhalf[iat]; a++)
         {
-            int kat = jat;
-            ij = lin(iat, jat);
-            jk = lin(jat, kat);
-            ik = ij;
-            ikvec = xyz_[kat] - xyz_[iat];
-            ijvec = ikvec;
-            jkvec.set(0, 0, 0);
-            c9 = -cc6ab[ij] * cc6ab[ik] * cc6ab[jk];
-
-            r0ij = para_.r0ab()[iz_[jat]][iz_[iat]];
-            r0ik = r0ij;
-            r0jk = para_.r0ab()[iz_[kat]][iz_[jat]];
-
-            for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
+            const PairC6 &p = pair_c6[iat][a];
+            if (p.jat != iat)
             {
-                repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
-                {
-                    repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                    repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                    for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
-                    {
-                        repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                        repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                        jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                               + static_cast<double>(jtauz) * lat_[2];
-                        rij2 = (ijvec + jtau).norm2();
-                        if (rij2 > para_.cn_thr2()) {
-                            continue;
-}
-                        rr0ij = std::sqrt(rij2) / r0ij;
-
-                        for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++) {
-                            for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++) {
-                                for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                {
-                                    if (jtaux == ktaux && jtauy == ktauy && jtauz == ktauz) {
-                                        continue;
-}
-                                    ktau = static_cast<double>(ktaux) * lat_[0] + static_cast<double>(ktauy) * lat_[1]
-                                           + static_cast<double>(ktauz) * lat_[2];
-                                    rik2 = (ikvec + ktau).norm2();
-                                    if (rik2 > para_.cn_thr2()) {
-                                        continue;
-}
-                                    rr0ik = std::sqrt(rik2) / r0ik;
-
-                                    rjk2 = (jkvec + ktau - jtau).norm2();
-                                    if (rjk2 > para_.cn_thr2()) {
-                                        continue;
-}
-                                    rr0jk = std::sqrt(rjk2) / r0jk;
-
-                                    geomean = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                    fdamp = 1.0 / (1.0 + 6.0 * std::pow(sr9 * geomean, alp9));
-                                    tmp1 = (rij2 + rjk2 - rik2);
-                                    tmp2 = (rij2 + rik2 - rjk2);
-                                    tmp3 = (rik2 + rjk2 - rij2);
-                                    tmp4 = rij2 * rjk2 * rik2;
-
-                                    ang = (0.375 * tmp1 * tmp2 * tmp3 / tmp4 + 1.0) / std::pow(tmp4, 1.5);
-
-                                    eabc += ang * c9 * fdamp / 2.0;
-                                } // end ktau
-}
-}
-                    } // end jtauz
-                } // end jtauy
-            } // end jtaux
-        } // end jat
+                pair_c6[p.jat].push_back(reverse_pair(p, iat));
+            }
+        }
+    }
+    return false;
 }
-    // end iat
 
-    for (int iat = 0; iat != ucell_.nat; iat++)
+void Vdwd3::pbc_three_body(const std::vector<std::vector<PairC6>> &pair_c6, const bool dense, double &eabc)
+{
+    const double sr9 = 0.75;
+    double e = 0.0;
+#pragma omp parallel reduction(+ : e)
     {
-        int jat = iat;
-        int kat = iat;
-        ijvec.set(0, 0, 0);
-        ij = lin(iat, iat);
-        ik = ij;
-        jk = ij;
-        ikvec = ijvec;
-        jkvec = ikvec;
-        c9 = -cc6ab[ij] * cc6ab[ik] * cc6ab[jk];
-
-        r0ij = para_.r0ab()[iz_[iat]][iz_[iat]];
-        r0ik = r0ij;
-        r0jk = r0ij;
-
-        for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
+        std::vector<Neighbor> neighbors;
+        std::vector<double> rr0;
+        // c6_i[jat] = C6(iat, jat) and c6_j[kat] = C6(jat, kat), from pair_c6[iat] and pair_c6[jat],
+        // c6_j is only used if pair_c6 is not dense
+        std::vector<double> c6_i(ucell_.nat), c6_j(ucell_.nat);
+#pragma omp for schedule(dynamic)
+        for (int iat = 0; iat < ucell_.nat; iat++)
         {
-            repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-            repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-            for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
+            // the triangle is found from the atom iat with the largest index in it, and the other two
+            // atoms in the half list of neighbors of iat. A triangle with n images of iat is found n times.
+            search_neighbors(iat, para_.cn_thr2(), rep_cn_, true, neighbors);
+            if (!dense)
+            {
+                sort_by_atom(neighbors);
+            }
+            rr0.resize(neighbors.size());
+            for (size_t a = 0; a < neighbors.size(); a++)
             {
-                repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
+                rr0[a] = std::sqrt(neighbors[a].r2) / para_.r0ab()[iz_[neighbors[a].jat]][iz_[iat]];
+            }
+            scatter_pairs(pair_c6[iat], iat, c6_i);
+            for (size_t a = 0; a < neighbors.size(); a++)
+            {
+                const Neighbor &nj = neighbors[a];
+                const int jat = nj.jat;
+                if (!dense && (a == 0 || jat != neighbors[a - 1].jat))
+                {
+                    scatter_pairs(pair_c6[jat], iat, c6_j);
+                }
+                for (size_t b = a + 1; b < neighbors.size(); b++)
                 {
-                    repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                    repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                    jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                           + static_cast<double>(jtauz) * lat_[2];
-                    if (jtaux == 0 && jtauy == 0 && jtauz == 0) {
+                    const Neighbor &nk = neighbors[b];
+                    const int kat = nk.jat;
+                    if (!in_rep(nk.t - nj.t, rep_cn_))
+                    {
                         continue;
-}
-                    rij2 = jtau.norm2();
-                    if (rij2 > para_.cn_thr2()) {
+                    }
+                    const double rjk2 = (nk.rij - nj.rij).norm2();
+                    if (rjk2 > para_.cn_thr2())
+                    {
                         continue;
-}
-                    rr0ij = std::sqrt(rij2) / r0ij;
-
-                    for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++) {
-                        for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++) {
-                            for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                            {
-                                if (ktaux == 0 && ktauy == 0 && ktauz == 0) {
-                                    continue;
-}
-                                if (jtaux == ktaux && jtauy == ktauy && jtauz == ktauz) {
-                                    continue;
-}
-                                ktau = static_cast<double>(ktaux) * lat_[0] + static_cast<double>(ktauy) * lat_[1]
-                                       + static_cast<double>(ktauz) * lat_[2];
-                                rik2 = ktau.norm2();
-                                if (rik2 > para_.cn_thr2()) {
-                                    continue;
-}
-                                rr0ik = std::sqrt(rik2) / r0ik;
-
-                                rjk2 = (jkvec + ktau - jtau).norm2();
-                                if (rjk2 > para_.cn_thr2()) {
-                                    continue;
-}
-                                rr0jk = std::sqrt(rjk2) / r0jk;
-
-                                geomean = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                fdamp = 1.0 / (1.0 + 6.0 * std::pow(sr9 * geomean, alp9));
-                                tmp1 = (rij2 + rjk2 - rik2);
-                                tmp2 = (rij2 + rik2 - rjk2);
-                                tmp3 = (rik2 + rjk2 - rij2);
-                                tmp4 = rij2 * rjk2 * rik2;
-
-                                ang = (0.375 * tmp1 * tmp2 * tmp3 / tmp4 + 1.0) / std::pow(tmp4, 1.5);
-
-                                eabc += ang * c9 * fdamp / 6.0;
-                            } // end ktau
-}
-}
-                } // end jtauz
-            } // end jtauy
-        } // end jtaux
-    } // end iat
+                    }
+                    const double rij2 = nj.r2;
+                    const double rik2 = nk.r2;
+                    const double rr0jk = std::sqrt(rjk2) / para_.r0ab()[iz_[kat]][iz_[jat]];
+                    const double c6jk = dense ? pair_c6[std::max(jat, kat)][std::min(jat, kat)].c6 : c6_j[kat];
+                    const double c9 = -std::sqrt(c6_i[jat] * c6_i[kat] * c6jk);
+                    const double weight = 1.0 / (1 + (jat == iat) + (kat == iat));
+
+                    const double geomean = std::cbrt(rr0[a] * rr0[b] * rr0jk);
+                    const double fdamp = 1.0 / (1.0 + 6.0 * pow_alp9(sr9 * geomean));
+                    const double tmp1 = (rij2 + rjk2 - rik2);
+                    const double tmp2 = (rij2 + rik2 - rjk2);
+                    const double tmp3 = (rik2 + rjk2 - rij2);
+                    const double tmp4 = rij2 * rjk2 * rik2;
+
+                    const double ang = (0.375 * tmp1 * tmp2 * tmp3 / tmp4 + 1.0) / (tmp4 * std::sqrt(tmp4));
+
+                    e += ang * c9 * fdamp * weight;
+                }
+            }
+        }
+    }
+    eabc = e;
 }
 
 void Vdwd3::get_dc6_dcnij(int mxci, int mxcj, double cni, double cnj, int izi, int izj,
@@ -737,802 +702,254 @@ void Vdwd3::get_dc6_dcnij(int mxci, int mxcj, double cni, double cnj, int izi, i
 
 void Vdwd3::pbc_gdisp(std::vector<ModuleBase::Vector3<double>> &g, ModuleBase::matrix &smearing_sigma)
 {
-    std::vector<double> c6save(ucell_.nat * (ucell_.nat + 1)), dc6_rest_sum(ucell_.nat * (ucell_.nat + 1) / 2),
-        dc6i(ucell_.nat), cn(ucell_.nat);
+    const int nat = ucell_.nat;
+    std::vector<double> dc6i(nat), cn(nat);
     pbc_ncoord(cn);
-    std::vector<std::vector<double>> dc6ij(ucell_.nat, std::vector<double>(ucell_.nat));
-    double c6 = 0.0, dc6iji = 0.0, dc6ijj = 0.0;
-    double r = 0.0, r0 = 0.0, r2 = 0.0, r6 = 0.0, r7 = 0.0, r8 = 0.0, r9 = 0.0;
-    double r42 = 0.0, rcovij = 0.0, t6 = 0.0, t8 = 0.0, dc6_rest = 0.0;
-    int linii = 0, linij = 0;
-    ModuleBase::Vector3<double> tau;
-    std::vector<std::vector<std::vector<std::vector<double>>>> drij(
-        ucell_.nat * (ucell_.nat + 1) / 2,
-        std::vector<std::vector<std::vector<double>>>(
-            2 * rep_vdw_[0] + 1,
-            std::vector<std::vector<double>>(2 * rep_vdw_[1] + 1, std::vector<double>(2 * rep_vdw_[2] + 1))));
-    if (para_.version() == "d3_0")
-    {
-        double damp6 = 0.0, damp8 = 0.0;
-        for (int iat = 0; iat != ucell_.nat; iat++)
-        {
-            get_dc6_dcnij(para_.mxc()[iz_[iat]], para_.mxc()[iz_[iat]], cn[iat], cn[iat],
-                          iz_[iat], iz_[iat], iat, iat, c6, dc6iji, dc6ijj);
-
-            linii = lin(iat, iat);
-            c6save[linii] = c6;
-            dc6ij[iat][iat] = dc6iji;
-            r0 = para_.r0ab()[iz_[iat]][iz_[iat]];
-            r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[iat]];
-            rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[iat]];
-
-            for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++) {
-                for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++) {
-                    for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                    {
-                        tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                              + static_cast<double>(tauz) * lat_[2];
-
-                        // first dE/d(tau)
-                        r2 = tau.norm2();
-                        if (r2 > 0.1 && r2 < para_.rthr2())
-                        {
-                            r = std::sqrt(r2);
-                            r6 = std::pow(r2, 3);
-                            r7 = r6 * r;
-                            r8 = r6 * r2;
-                            r9 = r8 * r;
-
-                            t6 = std::pow(r / (para_.rs6() * r0), -para_.alp6());
-                            damp6 = 1.0 / (1.0 + 6.0 * t6);
-                            t8 = std::pow(r / (para_.rs18() * r0), -para_.alp8());
-                            damp8 = 1.0 / (1.0 + 6.0 * t8);
-
-                            // d(r^(-6))/d(tau)
-                            drij[linii][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                                += (-para_.s6() * (6.0 / (r7)*c6 * damp6)
-                                    - para_.s18() * (24.0 / (r9)*c6 * r42 * damp8))
-                                   * 0.5;
-                            // d(f_dmp)/d(tau)
-                            drij[linii][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                                += (para_.s6() * c6 / r7 * 6.0 * para_.alp6() * t6 * damp6 * damp6
-                                    + para_.s18() * c6 * r42 / r9 * 18.0 * para_.alp8() * t8 * damp8 * damp8)
-                                   * 0.5;
-
-                            dc6_rest = (para_.s6() / r6 * damp6 + 3.0 * para_.s18() * r42 / r8 * damp8) * 0.5;
-                            dc6i[iat] += dc6_rest * (dc6iji + dc6ijj);
-                            dc6_rest_sum[linii] += dc6_rest;
-                        }
-                    } // end tau
-}
-}
-            for (int jat = 0; jat != iat; jat++)
-            {
-                get_dc6_dcnij(para_.mxc()[iz_[iat]], para_.mxc()[iz_[jat]], cn[iat], cn[jat],
-                              iz_[iat], iz_[jat], iat, jat, c6, dc6iji, dc6ijj);
-
-                linij = lin(iat, jat);
-                c6save[linij] = c6;
-                r0 = para_.r0ab()[iz_[iat]][iz_[jat]];
-                r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]];
-                rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[jat]];
-                dc6ij[jat][iat] = dc6iji;
-                dc6ij[iat][jat] = dc6ijj;
-                for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++) {
-                    for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++) {
-                        for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                        {
-                            tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                                  + static_cast<double>(tauz) * lat_[2];
-                            r2 = (xyz_[jat] - xyz_[iat] + tau).norm2();
-                            if (r2 > para_.rthr2()) {
-                                continue;
-}
 
-                            r = std::sqrt(r2);
-                            r6 = std::pow(r2, 3);
-                            r7 = r6 * r;
-                            r8 = r6 * r2;
-                            r9 = r8 * r;
-
-                            t6 = std::pow(r / (para_.rs6() * r0), -para_.alp6());
-                            damp6 = 1.0 / (1.0 + 6.0 * t6);
-                            t8 = std::pow(r / (para_.rs18() * r0), -para_.alp8());
-                            damp8 = 1.0 / (1.0 + 6.0 * t8);
-
-                            // d(r^(-6))/d(r_ij)
-                            drij[linij][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                                += -para_.s6() * (6.0 / (r7)*c6 * damp6) - para_.s18() * (24.0 / (r9)*c6 * r42 * damp8);
-                            // d(f_dmp)/d(r_ij)
-                            drij[linij][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                                += para_.s6() * c6 / r7 * 6.0 * para_.alp6() * t6 * damp6 * damp6
-                                   + para_.s18() * c6 * r42 / r9 * 18.0 * para_.alp8() * t8 * damp8 * damp8;
-
-                            dc6_rest = para_.s6() / r6 * damp6 + 3.0 * para_.s18() * r42 / r8 * damp8;
-                            dc6i[iat] += dc6_rest * dc6iji;
-                            dc6i[jat] += dc6_rest * dc6ijj;
-                            dc6_rest_sum[linij] += dc6_rest;
-                        } // end tau
-}
-}
-            } // end jat
-        } // end iat
-    } // end d3_0
-    else if (para_.version() == "d3_bj")
+    // C6 of the sides of the triangles, and their derivatives with respect to the coordination numbers
+    std::vector<std::vector<PairC6>> pair_c6;
+    bool dense = false;
+    if (para_.abc())
     {
-        double r4;
-        for (int iat = 0; iat != ucell_.nat; iat++)
-        {
-            get_dc6_dcnij(para_.mxc()[iz_[iat]], para_.mxc()[iz_[iat]], cn[iat], cn[iat],
-                          iz_[iat], iz_[iat], iat, iat, c6, dc6iji, dc6ijj);
-
-            linii = lin(iat, iat);
-            c6save[linii] = c6;
-            dc6ij[iat][iat] = dc6iji;
-            r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[iat]];
-            r0 = para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18();
-            rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[iat]];
-
-            for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++) {
-                for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++) {
-                    for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                    {
-                        tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                              + static_cast<double>(tauz) * lat_[2];
-
-                        // first dE/d(tau)
-                        r2 = tau.norm2();
-                        if (r2 > 0.1 && r2 < para_.rthr2())
-                        {
-                            r = std::sqrt(r2);
-                            r4 = r2 * r2;
-                            r6 = std::pow(r2, 3);
-                            r7 = r6 * r;
-                            r8 = r6 * r2;
-                            r9 = r8 * r;
-
-                            t6 = r6 + std::pow(r0, 6);
-                            t8 = r8 + std::pow(r0, 8);
-
-                            // d(1/r^(-6)+r0^6)/d(r)
-                            drij[linii][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                                += -para_.s6() * c6 * 6.0 * r4 * r / (t6 * t6) * 0.5
-                                   - para_.s18() * c6 * 24.0 * r42 * r7 / (t8 * t8) * 0.5;
-
-                            dc6_rest = (para_.s6() / t6 + 3.0 * para_.s18() * r42 / t8) * 0.5;
-                            dc6i[iat] += dc6_rest * (dc6iji + dc6ijj);
-                            dc6_rest_sum[linii] += dc6_rest;
-                        }
-                    } // end tau
-}
-}
-            for (int jat = 0; jat != iat; jat++)
-            {
-                get_dc6_dcnij(para_.mxc()[iz_[iat]], para_.mxc()[iz_[jat]], cn[iat], cn[jat],
-                              iz_[iat], iz_[jat], iat, jat, c6, dc6iji, dc6ijj);
-
-                linij = lin(iat, jat);
-                c6save[linij] = c6;
-                r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]];
-                r0 = para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18();
-                rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[jat]];
-                dc6ij[jat][iat] = dc6iji;
-                dc6ij[iat][jat] = dc6ijj;
-                for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++) {
-                    for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++) {
-                        for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                        {
-                            tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                                  + static_cast<double>(tauz) * lat_[2];
-                            r2 = (xyz_[jat] - xyz_[iat] + tau).norm2();
-                            if (r2 > para_.rthr2()) {
-                                continue;
-}
-
-                            r = std::sqrt(r2);
-                            r4 = r2 * r2;
-                            r6 = std::pow(r2, 3);
-                            r7 = r6 * r;
-                            r8 = r6 * r2;
-                            r9 = r8 * r;
-
-                            t6 = r6 + std::pow(r0, 6);
-                            t8 = r8 + std::pow(r0, 8);
-
-                            drij[linij][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                                += -para_.s6() * c6 * 6.0 * r4 * r / (t6 * t6)
-                                   - para_.s18() * c6 * 24.0 * r42 * r7 / (t8 * t8);
-
-                            dc6_rest = para_.s6() / t6 + 3.0 * para_.s18() * r42 / t8;
-                            dc6i[iat] += dc6_rest * dc6iji;
-                            dc6i[jat] += dc6_rest * dc6ijj;
-                            dc6_rest_sum[linij] += dc6_rest;
-                        } // end tau
-}
-}
-            } // end jat
-        } // end iat
-    } // end d3_bj
+        dense = set_pair_c6(cn, true, pair_c6);
+    }
 
-    if (para_.abc())
+    const bool zero_damping = para_.version() == "d3_0";
+    const bool bj_damping = para_.version() == "d3_bj";
+#pragma omp parallel
     {
-        ModuleBase::Vector3<double> ijvec, ikvec, jkvec, jtau, ktau;
-        std::vector<int> repmin(3), repmax(3);
-        double sr9 = 0.75, alp9 = -16.0;
-        double linik, linjk, rij2, rik2, rjk2, rr0ij, rr0ik, rr0jk, geomean2, geomean, geomean3, r0av, r;
-        double c6ij, c6ik, c6jk, c9, damp9, ang, dfdmp, dang, tmp1, dc9;
-        for (int iat = 2; iat < ucell_.nat; iat++)
+        std::vector<Neighbor> neighbors;
+        std::vector<ModuleBase::Vector3<double>> g_local(nat);
+        ModuleBase::matrix sigma_local(3, 3);
+        std::vector<double> dc6i_local(nat);
+        // C6 of iat with jat is computed once for all the images of jat, as in cal_energy()
+        std::vector<PairC6> row(nat);
+        std::vector<int> row_iat(nat, -1);
+
+        // dE/dr_ij of the two-body term, with the other part dE/dC6 * dC6/dCN
+#pragma omp for schedule(dynamic) nowait
+        for (int iat = 0; iat < nat; iat++)
         {
-            for (int jat = 1; jat != iat; jat++)
+            search_neighbors(iat, para_.rthr2(), rep_vdw_, true, neighbors);
+            for (const Neighbor &nb: neighbors)
             {
-                linij = lin(iat, jat);
-                ijvec = xyz_[jat] - xyz_[iat];
-
-                c6ij = c6save[linij];
-                for (int kat = 0; kat != jat; kat++)
+                const int jat = nb.jat;
+                const double r2 = nb.r2;
+                // the atom and its own image are counted from both sides
+                const bool self = (jat == iat);
+                if (self && (r2 <= 0.1 || r2 >= para_.rthr2()))
                 {
-                    linik = lin(iat, kat);
-                    linjk = lin(jat, kat);
-                    ikvec = xyz_[kat] - xyz_[iat];
-                    jkvec = xyz_[kat] - xyz_[jat];
-
-                    c6ik = c6save[linik];
-                    c6jk = c6save[linjk];
-                    c9 = -1.0 * std::sqrt(c6ij * c6ik * c6jk);
-
-                    for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
-                    {
-                        repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                        repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                        for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
-                        {
-                            repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                            repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                            for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
-                            {
-                                repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                                repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                                jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                                       + static_cast<double>(jtauz) * lat_[2];
-                                rij2 = (ijvec + jtau).norm2();
-                                if (rij2 > para_.cn_thr2()) {
-                                    continue;
-}
-                                rr0ij = std::sqrt(rij2) / para_.r0ab()[iz_[jat]][iz_[iat]];
-
-                                for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++) {
-                                    for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++) {
-                                        for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                        {
-                                            ktau = static_cast<double>(ktaux) * lat_[0]
-                                                   + static_cast<double>(ktauy) * lat_[1]
-                                                   + static_cast<double>(ktauz) * lat_[2];
-                                            rik2 = (ikvec + ktau).norm2();
-                                            if (rik2 > para_.cn_thr2()) {
-                                                continue;
-}
-
-                                            rjk2 = (jkvec + ktau - jtau).norm2();
-                                            if (rjk2 > para_.cn_thr2()) {
-                                                continue;
-}
-                                            rr0ik = std::sqrt(rik2) / para_.r0ab()[iz_[kat]][iz_[iat]];
-                                            rr0jk = std::sqrt(rjk2) / para_.r0ab()[iz_[kat]][iz_[jat]];
-
-                                            geomean2 = rij2 * rjk2 * rik2;
-                                            r0av = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                            damp9 = 1.0 / (1.0 + 6.0 * std::pow(sr9 * r0av, alp9));
-                                            geomean = std::sqrt(geomean2);
-                                            geomean3 = geomean * geomean2;
-                                            ang = 0.375 * (rij2 + rjk2 - rik2) * (rij2 - rjk2 + rik2)
-                                                      * (-rij2 + rjk2 + rik2) / (geomean3 * geomean2)
-                                                  + 1.0 / geomean3;
-                                            dc6_rest = ang * damp9;
-                                            dfdmp = 2.0 * alp9 * std::pow(0.75 * r0av, alp9) * damp9 * damp9;
-
-                                            r = std::sqrt(rij2);
-                                            dang = -0.375
-                                                   * (std::pow(rij2, 3) + std::pow(rij2, 2) * (rjk2 + rik2)
-                                                      + rij2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rik2
-                                                                + 3.0 * std::pow(rik2, 2))
-                                                      - 5.0 * std::pow(rjk2 - rik2, 2) * (rjk2 + rik2))
-                                                   / (r * geomean3 * geomean2);
-                                            tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                            drij[linij][jtaux + rep_vdw_[0]][jtauy + rep_vdw_[1]][jtauz + rep_vdw_[2]]
-                                                -= tmp1;
-
-                                            r = std::sqrt(rik2);
-                                            dang = -0.375
-                                                   * (std::pow(rik2, 3) + std::pow(rik2, 2) * (rjk2 + rij2)
-                                                      + rik2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rij2
-                                                                + 3.0 * std::pow(rij2, 2))
-                                                      - 5.0 * std::pow(rjk2 - rij2, 2) * (rjk2 + rij2))
-                                                   / (r * geomean3 * geomean2);
-                                            tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                            drij[linik][ktaux + rep_vdw_[0]][ktauy + rep_vdw_[1]][ktauz + rep_vdw_[2]]
-                                                -= tmp1;
-
-                                            r = std::sqrt(rjk2);
-                                            dang = -0.375
-                                                   * (std::pow(rjk2, 3) + std::pow(rjk2, 2) * (rik2 + rij2)
-                                                      + rjk2 * (3.0 * std::pow(rik2, 2) + 2.0 * rik2 * rij2
-                                                                + 3.0 * std::pow(rij2, 2))
-                                                      - 5.0 * std::pow(rik2 - rij2, 2) * (rik2 + rij2))
-                                                   / (r * geomean3 * geomean2);
-                                            tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                            drij[linjk][ktaux - jtaux + rep_vdw_[0]][ktauy - jtauy + rep_vdw_[1]]
-                                                [ktauz - jtauz + rep_vdw_[2]]
-                                                -= tmp1;
-
-                                            dc9 = (dc6ij[jat][iat] / c6ij + dc6ij[kat][iat] / c6ik) * c9 * 0.5;
-                                            dc6i[iat] += dc6_rest * dc9;
-
-                                            dc9 = (dc6ij[iat][jat] / c6ij + dc6ij[kat][jat] / c6jk) * c9 * 0.5;
-                                            dc6i[jat] += dc6_rest * dc9;
-
-                                            dc9 = (dc6ij[iat][kat] / c6ik + dc6ij[jat][kat] / c6jk) * c9 * 0.5;
-                                            dc6i[kat] += dc6_rest * dc9;
-                                        } // end ktau
-}
-}
-                            } // end jtauz
-                        } // end jtauy
-                    } // end jtaux
-                } // end kat
-            } // end jat
-        }
-        for (int iat = 1; iat != ucell_.nat; iat++)
-        {
-            int jat = iat;
-            linij = lin(iat, jat);
-            ijvec.set(0, 0, 0);
-
-            c6ij = c6save[linij];
-            for (int kat = 0; kat != iat; kat++)
-            {
-                linjk = lin(jat, kat);
-                linik = linjk;
-                ikvec = xyz_[kat] - xyz_[iat];
-                jkvec = ikvec;
-
-                c6ik = c6save[linik];
-                c6jk = c6ik;
-                c9 = -1.0 * std::sqrt(c6ij * c6ik * c6jk);
-
-                for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
+                    continue;
+                }
+                const double fac = self ? 0.5 : 1.0;
+                if (row_iat[jat] != iat)
                 {
-                    repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                    repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                    for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
-                    {
-                        repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                        repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                        for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
-                        {
-                            repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                            repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                            if (jtaux == 0 && jtauy == 0 && jtauz == 0) {
-                                continue;
-}
-                            jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                                   + static_cast<double>(jtauz) * lat_[2];
-                            rij2 = jtau.norm2();
-                            if (rij2 > para_.cn_thr2()) {
-                                continue;
-}
-                            rr0ij = std::sqrt(rij2) / para_.r0ab()[iz_[jat]][iz_[iat]];
-
-                            for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++) {
-                                for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++) {
-                                    for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                    {
-                                        ktau = static_cast<double>(ktaux) * lat_[0]
-                                               + static_cast<double>(ktauy) * lat_[1]
-                                               + static_cast<double>(ktauz) * lat_[2];
-                                        rik2 = (ikvec + ktau).norm2();
-                                        if (rik2 > para_.cn_thr2()) {
-                                            continue;
-}
-
-                                        rjk2 = (jkvec + ktau - jtau).norm2();
-                                        if (rjk2 > para_.cn_thr2()) {
-                                            continue;
-}
-                                        rr0ik = std::sqrt(rik2) / para_.r0ab()[iz_[kat]][iz_[iat]];
-                                        rr0jk = std::sqrt(rjk2) / para_.r0ab()[iz_[kat]][iz_[jat]];
-
-                                        geomean2 = rij2 * rjk2 * rik2;
-                                        r0av = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                        damp9 = 1.0 / (1.0 + 6.0 * std::pow(sr9 * r0av, alp9));
-                                        geomean = std::sqrt(geomean2);
-                                        geomean3 = geomean * geomean2;
-                                        ang = 0.375 * (rij2 + rjk2 - rik2) * (rij2 - rjk2 + rik2)
-                                                  * (-rij2 + rjk2 + rik2) / (geomean3 * geomean2)
-                                              + 1.0 / geomean3;
-                                        dc6_rest = ang * damp9 / 2.0;
-                                        dfdmp = 2.0 * alp9 * std::pow(0.75 * r0av, alp9) * damp9 * damp9;
-
-                                        r = std::sqrt(rij2);
-                                        dang = -0.375
-                                               * (std::pow(rij2, 3) + std::pow(rij2, 2) * (rjk2 + rik2)
-                                                  + rij2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rik2
-                                                            + 3.0 * std::pow(rik2, 2))
-                                                  - 5.0 * std::pow(rjk2 - rik2, 2) * (rjk2 + rik2))
-                                               / (r * geomean3 * geomean2);
-                                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                        drij[linij][jtaux + rep_vdw_[0]][jtauy + rep_vdw_[1]][jtauz + rep_vdw_[2]]
-                                            -= tmp1 / 2.0;
-
-                                        r = std::sqrt(rik2);
-                                        dang = -0.375
-                                               * (std::pow(rik2, 3) + std::pow(rik2, 2) * (rjk2 + rij2)
-                                                  + rik2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rij2
-                                                            + 3.0 * std::pow(rij2, 2))
-                                                  - 5.0 * std::pow(rjk2 - rij2, 2) * (rjk2 + rij2))
-                                               / (r * geomean3 * geomean2);
-                                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                        drij[linik][ktaux + rep_vdw_[0]][ktauy + rep_vdw_[1]][ktauz + rep_vdw_[2]]
-                                            -= tmp1 / 2.0;
-
-                                        r = std::sqrt(rjk2);
-                                        dang = -0.375
-                                               * (std::pow(rjk2, 3) + std::pow(rjk2, 2) * (rik2 + rij2)
-                                                  + rjk2 * (3.0 * std::pow(rik2, 2) + 2.0 * rik2 * rij2
-                                                            + 3.0 * std::pow(rij2, 2))
-                                                  - 5.0 * std::pow(rik2 - rij2, 2) * (rik2 + rij2))
-                                               / (r * geomean3 * geomean2);
-                                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                        drij[linjk][ktaux - jtaux + rep_vdw_[0]][ktauy - jtauy + rep_vdw_[1]]
-                                            [ktauz - jtauz + rep_vdw_[2]]
-                                            -= tmp1 / 2.0;
-
-                                        dc9 = (dc6ij[jat][iat] / c6ij + dc6ij[kat][iat] / c6ik) * c9 * 0.5;
-                                        dc6i[iat] += dc6_rest * dc9;
-
-                                        dc9 = (dc6ij[iat][jat] / c6ij + dc6ij[kat][jat] / c6jk) * c9 * 0.5;
-                                        dc6i[jat] += dc6_rest * dc9;
-
-                                        dc9 = (dc6ij[iat][kat] / c6ik + dc6ij[jat][kat] / c6jk) * c9 * 0.5;
-                                        dc6i[kat] += dc6_rest * dc9;
-                                    } // end ktau
-}
-}
-                        } // end jtauz
-                    } // end jtauy
-                } // end jtaux
-            } // end kat
-        } // end iat
-
-        for (int iat = 1; iat != ucell_.nat; iat++) {
-            for (int jat = 0; jat != iat; jat++)
-            {
-                int kat = jat;
-                linij = lin(iat, jat);
-                linjk = lin(jat, kat);
-                linik = linij;
-                ikvec = xyz_[kat] - xyz_[iat];
-                ijvec = ikvec;
-                jkvec.set(0, 0, 0);
-
-                c6ij = c6save[linij];
-                c6ik = c6ij;
-                c6jk = c6save[linjk];
-                c9 = -1.0 * std::sqrt(c6ij * c6ik * c6jk);
-
-                for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
+                    row_iat[jat] = iat;
+                    cal_pair_c6(iat, jat, cn, true, row[jat]);
+                }
+                const PairC6 &pair = row[jat];
+                const double c6 = pair.c6;
+                const double r42 = para_.r2r4()[iz_[iat]] * para_.r2r4()[iz_[jat]];
+                const double r = std::sqrt(r2);
+                const double r6 = std::pow(r2, 3);
+                const double r7 = r6 * r;
+                const double r8 = r6 * r2;
+                const double r9 = r8 * r;
+                double drij = 0.0, dc6_rest = 0.0;
+                if (zero_damping)
+                {
+                    const double r0 = para_.r0ab()[iz_[iat]][iz_[jat]];
+                    const double t6 = std::pow(r / (para_.rs6() * r0), -para_.alp6());
+                    const double damp6 = 1.0 / (1.0 + 6.0 * t6);
+                    const double t8 = std::pow(r / (para_.rs18() * r0), -para_.alp8());
+                    const double damp8 = 1.0 / (1.0 + 6.0 * t8);
+
+                    // d(r^(-6))/d(r_ij) + d(f_dmp)/d(r_ij)
+                    drij = -para_.s6() * (6.0 / (r7)*c6 * damp6) - para_.s18() * (24.0 / (r9)*c6 * r42 * damp8)
+                           + para_.s6() * c6 / r7 * 6.0 * para_.alp6() * t6 * damp6 * damp6
+                           + para_.s18() * c6 * r42 / r9 * 18.0 * para_.alp8() * t8 * damp8 * damp8;
+                    dc6_rest = para_.s6() / r6 * damp6 + 3.0 * para_.s18() * r42 / r8 * damp8;
+                }
+                else if (bj_damping)
                 {
-                    repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                    repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                    for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
+                    const double r0 = para_.rs6() * std::sqrt(3.0 * r42) + para_.rs18();
+                    const double r4 = r2 * r2;
+                    const double t6 = r6 + std::pow(r0, 6);
+                    const double t8 = r8 + std::pow(r0, 8);
+
+                    // d(1/r^(-6)+r0^6)/d(r)
+                    drij = -para_.s6() * c6 * 6.0 * r4 * r / (t6 * t6)
+                           - para_.s18() * c6 * 24.0 * r42 * r7 / (t8 * t8);
+                    dc6_rest = para_.s6() / t6 + 3.0 * para_.s18() * r42 / t8;
+                }
+                if (self)
+                {
+                    // both of the derivatives of C6(iat, iat) are for iat
+                    dc6i_local[iat] += dc6_rest * fac * (pair.dc6i + pair.dc6j);
+                    add_pair_gradient(drij * fac, nb.rij, r, iat, jat, g_local, sigma_local);
+                }
+                else
+                {
+                    dc6i_local[iat] += dc6_rest * pair.dc6i;
+                    dc6i_local[jat] += dc6_rest * pair.dc6j;
+                    if (r2 >= 0.5)
                     {
-                        repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                        repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                        for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
-                        {
-                            repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                            repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                            jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                                   + static_cast<double>(jtauz) * lat_[2];
-                            rij2 = (ijvec + jtau).norm2();
-                            if (rij2 > para_.cn_thr2()) {
-                                continue;
-}
-                            rr0ij = std::sqrt(rij2) / para_.r0ab()[iz_[jat]][iz_[iat]];
-
-                            for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++) {
-                                for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++) {
-                                    for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                    {
-                                        if (jtaux == ktaux && jtauy == ktauy && jtauz == ktauz) {
-                                            continue;
-}
-                                        ktau = static_cast<double>(ktaux) * lat_[0]
-                                               + static_cast<double>(ktauy) * lat_[1]
-                                               + static_cast<double>(ktauz) * lat_[2];
-                                        rik2 = (ikvec + ktau).norm2();
-                                        if (rik2 > para_.cn_thr2()) {
-                                            continue;
-}
-                                        rr0ik = std::sqrt(rik2) / para_.r0ab()[iz_[kat]][iz_[iat]];
-
-                                        rjk2 = (jkvec + ktau - jtau).norm2();
-                                        if (rjk2 > para_.cn_thr2()) {
-                                            continue;
-}
-                                        rr0jk = std::sqrt(rjk2) / para_.r0ab()[iz_[kat]][iz_[jat]];
-
-                                        geomean2 = rij2 * rjk2 * rik2;
-                                        r0av = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                        damp9 = 1.0 / (1.0 + 6.0 * std::pow(sr9 * r0av, alp9));
-                                        geomean = std::sqrt(geomean2);
-                                        geomean3 = geomean * geomean2;
-                                        ang = 0.375 * (rij2 + rjk2 - rik2) * (rij2 - rjk2 + rik2)
-                                                  * (-rij2 + rjk2 + rik2) / (geomean3 * geomean2)
-                                              + 1.0 / geomean3;
-                                        dc6_rest = ang * damp9 / 2.0;
-                                        dfdmp = 2.0 * alp9 * std::pow(0.75 * r0av, alp9) * damp9 * damp9;
-
-                                        r = std::sqrt(rij2);
-                                        dang = -0.375
-                                               * (std::pow(rij2, 3) + std::pow(rij2, 2) * (rjk2 + rik2)
-                                                  + rij2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rik2
-                                                            + 3.0 * std::pow(rik2, 2))
-                                                  - 5.0 * std::pow(rjk2 - rik2, 2) * (rjk2 + rik2))
-                                               / (r * geomean3 * geomean2);
-                                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                        drij[linij][jtaux + rep_vdw_[0]][jtauy + rep_vdw_[1]][jtauz + rep_vdw_[2]]
-                                            -= tmp1 / 2.0;
-
-                                        r = std::sqrt(rik2);
-                                        dang = -0.375
-                                               * (std::pow(rik2, 3) + std::pow(rik2, 2) * (rjk2 + rij2)
-                                                  + rik2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rij2
-                                                            + 3.0 * std::pow(rij2, 2))
-                                                  - 5.0 * std::pow(rjk2 - rij2, 2) * (rjk2 + rij2))
-                                               / (r * geomean3 * geomean2);
-                                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                        drij[linik][ktaux + rep_vdw_[0]][ktauy + rep_vdw_[1]][ktauz + rep_vdw_[2]]
-                                            -= tmp1 / 2.0;
-
-                                        r = std::sqrt(rjk2);
-                                        dang = -0.375
-                                               * (std::pow(rjk2, 3) + std::pow(rjk2, 2) * (rik2 + rij2)
-                                                  + rjk2 * (3.0 * std::pow(rik2, 2) + 2.0 * rik2 * rij2
-                                                            + 3.0 * std::pow(rij2, 2))
-                                                  - 5.0 * std::pow(rik2 - rij2, 2) * (rik2 + rij2))
-                                               / (r * geomean3 * geomean2);
-                                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                        drij[linjk][ktaux - jtaux + rep_vdw_[0]][ktauy - jtauy + rep_vdw_[1]]
-                                            [ktauz - jtauz + rep_vdw_[2]]
-                                            -= tmp1 / 2.0;
-
-                                        dc9 = (dc6ij[jat][iat] / c6ij + dc6ij[kat][iat] / c6ik) * c9 * 0.5;
-                                        dc6i[iat] += dc6_rest * dc9;
-
-                                        dc9 = (dc6ij[iat][jat] / c6ij + dc6ij[kat][jat] / c6jk) * c9 * 0.5;
-                                        dc6i[jat] += dc6_rest * dc9;
-
-                                        dc9 = (dc6ij[iat][kat] / c6ik + dc6ij[jat][kat] / c6jk) * c9 * 0.5;
-                                        dc6i[kat] += dc6_rest * dc9;
-                                    } // end ktau
-}
-}
-                        } // end jtauz
-                    } // end jtauy
-                } // end jtaux
-            } // end jat
-}
-        // end iat
+                        add_pair_gradient(drij, nb.rij, r, iat, jat, g_local, sigma_local);
+                    }
+                }
+            }
+        }
 
-        for (int iat = 0; iat != ucell_.nat; iat++)
+        // dE/dr of the three sides of the triangles, found as in pbc_three_body()
+        if (para_.abc())
         {
-            int jat = iat;
-            int kat = iat;
-            ijvec.set(0, 0, 0);
-            linij = lin(iat, jat);
-            linik = lin(iat, kat);
-            linjk = lin(jat, kat);
-            ikvec = ijvec;
-            jkvec = ikvec;
-            c6ij = c6save[linij];
-            c6ik = c6ij;
-            c6jk = c6ij;
-            c9 = -1.0 * std::sqrt(c6ij * c6ik * c6jk);
-
-            for (int jtaux = -rep_cn_[0]; jtaux <= rep_cn_[0]; jtaux++)
+            const double sr9 = 0.75, alp9 = -16.0;
+            // r, r/r0 and dE/dr of the sides from iat to its neighbors
+            std::vector<double> r_nb, rr0, dedr;
+            // pair_i[jat] is the pair iat, jat and pair_j[kat] is the pair jat, kat as in pbc_three_body()
+            std::vector<PairC6> pair_i(nat), pair_j(nat);
+#pragma omp for schedule(dynamic) nowait
+            for (int iat = 0; iat < nat; iat++)
             {
-                repmin[0] = std::max(-rep_cn_[0], jtaux - rep_cn_[0]);
-                repmax[0] = std::min(rep_cn_[0], jtaux + rep_cn_[0]);
-                for (int jtauy = -rep_cn_[1]; jtauy <= rep_cn_[1]; jtauy++)
+                search_neighbors(iat, para_.cn_thr2(), rep_cn_, true, neighbors);
+                if (!dense)
                 {
-                    repmin[1] = std::max(-rep_cn_[1], jtauy - rep_cn_[1]);
-                    repmax[1] = std::min(rep_cn_[1], jtauy + rep_cn_[1]);
-                    for (int jtauz = -rep_cn_[2]; jtauz <= rep_cn_[2]; jtauz++)
+                    sort_by_atom(neighbors);
+                }
+                r_nb.resize(neighbors.size());
+                rr0.resize(neighbors.size());
+                dedr.assign(neighbors.size(), 0.0);
+                for (size_t a = 0; a < neighbors.size(); a++)
+                {
+                    r_nb[a] = std::sqrt(neighbors[a].r2);
+                    rr0[a] = r_nb[a] / para_.r0ab()[iz_[neighbors[a].jat]][iz_[iat]];
+                }
+                scatter_pairs(pair_c6[iat], iat, pair_i);
+                for (size_t a = 0; a < neighbors.size(); a++)
+                {
+                    const Neighbor &nj = neighbors[a];
+                    const int jat = nj.jat;
+                    if (!dense && (a == 0 || jat != neighbors[a - 1].jat))
+                    {
+                        scatter_pairs(pair_c6[jat], iat, pair_j);
+                    }
+                    // dc6ij_i = dC6(iat, jat)/dCN(iat), dc6ij_j = dC6(iat, jat)/dCN(jat), and so on
+                    const double c6ij = pair_i[jat].c6, dc6ij_i = pair_i[jat].dc6i, dc6ij_j = pair_i[jat].dc6j;
+                    for (size_t b = a + 1; b < neighbors.size(); b++)
                     {
-                        repmin[2] = std::max(-rep_cn_[2], jtauz - rep_cn_[2]);
-                        repmax[2] = std::min(rep_cn_[2], jtauz + rep_cn_[2]);
-                        if (jtaux == 0 && jtauy == 0 && jtauz == 0) {
+                        const Neighbor &nk = neighbors[b];
+                        const int kat = nk.jat;
+                        if (!in_rep(nk.t - nj.t, rep_cn_))
+                        {
                             continue;
-}
-                        jtau = static_cast<double>(jtaux) * lat_[0] + static_cast<double>(jtauy) * lat_[1]
-                               + static_cast<double>(jtauz) * lat_[2];
-                        rij2 = jtau.norm2();
-                        if (rij2 > para_.cn_thr2()) {
+                        }
+                        const ModuleBase::Vector3<double> rjk_vec = nk.rij - nj.rij;
+                        const double rjk2 = rjk_vec.norm2();
+                        if (rjk2 > para_.cn_thr2())
+                        {
                             continue;
-}
-                        rr0ij = std::sqrt(rij2) / para_.r0ab()[iz_[jat]][iz_[iat]];
-
-                        for (int ktaux = repmin[0]; ktaux <= repmax[0]; ktaux++) {
-                            for (int ktauy = repmin[1]; ktauy <= repmax[1]; ktauy++) {
-                                for (int ktauz = repmin[2]; ktauz <= repmax[2]; ktauz++)
-                                {
-                                    if (ktaux == 0 && ktauy == 0 && ktauz == 0) {
-                                        continue;
-}
-                                    if (jtaux == ktaux && jtauy == ktauy && jtauz == ktauz) {
-                                        continue;
-}
-                                    ktau = static_cast<double>(ktaux) * lat_[0] + static_cast<double>(ktauy) * lat_[1]
-                                           + static_cast<double>(ktauz) * lat_[2];
-                                    rik2 = ktau.norm2();
-                                    if (rik2 > para_.cn_thr2()) {
-                                        continue;
-}
-                                    rr0ik = std::sqrt(rik2) / para_.r0ab()[iz_[kat]][iz_[iat]];
+                        }
+                        const double rij2 = nj.r2;
+                        const double rik2 = nk.r2;
+                        const double rjk = std::sqrt(rjk2);
+                        const double rr0jk = rjk / para_.r0ab()[iz_[kat]][iz_[jat]];
+                        const double c6ik = pair_i[kat].c6, dc6ik_i = pair_i[kat].dc6i, dc6ik_k = pair_i[kat].dc6j;
+                        const PairC6 pjk = !dense       ? pair_j[kat]
+                                           : jat >= kat ? pair_c6[jat][kat]
+                                                        : reverse_pair(pair_c6[kat][jat], jat);
+                        const double c6jk = pjk.c6, dc6jk_j = pjk.dc6i, dc6jk_k = pjk.dc6j;
+                        const double c9 = -1.0 * std::sqrt(c6ij * c6ik * c6jk);
+                        const double weight = 1.0 / (1 + (jat == iat) + (kat == iat));
+
+                        const double geomean2 = rij2 * rjk2 * rik2;
+                        const double r0av = std::cbrt(rr0[a] * rr0[b] * rr0jk);
+                        const double t9 = pow_alp9(sr9 * r0av);
+                        const double damp9 = 1.0 / (1.0 + 6.0 * t9);
+                        const double geomean = std::sqrt(geomean2);
+                        const double geomean3 = geomean * geomean2;
+                        const double ang = 0.375 * (rij2 + rjk2 - rik2) * (rij2 - rjk2 + rik2) * (-rij2 + rjk2 + rik2)
+                                               / (geomean3 * geomean2)
+                                           + 1.0 / geomean3;
+                        const double dc6_rest = ang * damp9 * weight;
+                        const double dfdmp = 2.0 * alp9 * t9 * damp9 * damp9;
+
+                        double r = r_nb[a];
+                        double dang = dang_dr(rij2, rjk2, rik2, r, geomean3 * geomean2);
+                        double tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
+                        dedr[a] -= tmp1 * weight;
+
+                        r = r_nb[b];
+                        dang = dang_dr(rik2, rjk2, rij2, r, geomean3 * geomean2);
+                        tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
+                        dedr[b] -= tmp1 * weight;
+
+                        dang = dang_dr(rjk2, rik2, rij2, rjk, geomean3 * geomean2);
+                        tmp1 = -dang * c9 * damp9 + dfdmp / rjk * c9 * ang;
+                        add_pair_gradient(-tmp1 * weight, rjk_vec, rjk, jat, kat, g_local, sigma_local);
+
+                        double dc9 = (dc6ij_i / c6ij + dc6ik_i / c6ik) * c9 * 0.5;
+                        dc6i_local[iat] += dc6_rest * dc9;
+
+                        dc9 = (dc6ij_j / c6ij + dc6jk_j / c6jk) * c9 * 0.5;
+                        dc6i_local[jat] += dc6_rest * dc9;
+
+                        dc9 = (dc6ik_k / c6ik + dc6jk_k / c6jk) * c9 * 0.5;
+                        dc6i_local[kat] += dc6_rest * dc9;
+                    }
+                }
+                for (size_t a = 0; a < neighbors.size(); a++)
+                {
+                    add_pair_gradient(dedr[a], neighbors[a].rij, r_nb[a], iat, neighbors[a].jat, g_local, sigma_local);
+                }
+            }
+        }
 
-                                    rjk2 = (jkvec + ktau - jtau).norm2();
-                                    if (rjk2 > para_.cn_thr2()) {
-                                        continue;
-}
-                                    rr0jk = std::sqrt(rjk2) / para_.r0ab()[iz_[kat]][iz_[jat]];
-
-                                    geomean2 = rij2 * rjk2 * rik2;
-                                    r0av = std::pow(rr0ij * rr0ik * rr0jk, 1.0 / 3.0);
-                                    damp9 = 1.0 / (1.0 + 6.0 * std::pow(sr9 * r0av, alp9));
-                                    geomean = std::sqrt(geomean2);
-                                    geomean3 = geomean * geomean2;
-                                    ang = 0.375 * (rij2 + rjk2 - rik2) * (rij2 - rjk2 + rik2) * (-rij2 + rjk2 + rik2)
-                                              / (geomean3 * geomean2)
-                                          + 1.0 / geomean3;
-                                    dc6_rest = ang * damp9 / 6.0;
-                                    dfdmp = 2.0 * alp9 * std::pow(0.75 * r0av, alp9) * damp9 * damp9;
-
-                                    r = std::sqrt(rij2);
-                                    dang = -0.375
-                                           * (std::pow(rij2, 3) + std::pow(rij2, 2) * (rjk2 + rik2)
-                                              + rij2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rik2
-                                                        + 3.0 * std::pow(rik2, 2))
-                                              - 5.0 * std::pow(rjk2 - rik2, 2) * (rjk2 + rik2))
-                                           / (r * geomean3 * geomean2);
-                                    tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                    drij[linij][jtaux + rep_vdw_[0]][jtauy + rep_vdw_[1]][jtauz + rep_vdw_[2]]
-                                        -= tmp1 / 6.0;
-
-                                    r = std::sqrt(rik2);
-                                    dang = -0.375
-                                           * (std::pow(rik2, 3) + std::pow(rik2, 2) * (rjk2 + rij2)
-                                              + rik2 * (3.0 * std::pow(rjk2, 2) + 2.0 * rjk2 * rij2
-                                                        + 3.0 * std::pow(rij2, 2))
-                                              - 5.0 * std::pow(rjk2 - rij2, 2) * (rjk2 + rij2))
-                                           / (r * geomean3 * geomean2);
-                                    tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                    drij[linik][ktaux + rep_vdw_[0]][ktauy + rep_vdw_[1]][ktauz + rep_vdw_[2]]
-                                        -= tmp1 / 6.0;
-
-                                    r = std::sqrt(rjk2);
-                                    dang = -0.375
-                                           * (std::pow(rjk2, 3) + std::pow(rjk2, 2) * (rik2 + rij2)
-                                              + rjk2 * (3.0 * std::pow(rik2, 2) + 2.0 * rik2 * rij2
-                                                        + 3.0 * std::pow(rij2, 2))
-                                              - 5.0 * std::pow(rik2 - rij2, 2) * (rik2 + rij2))
-                                           / (r * geomean3 * geomean2);
-                                    tmp1 = -dang * c9 * damp9 + dfdmp / r * c9 * ang;
-                                    drij[linjk][ktaux - jtaux + rep_vdw_[0]][ktauy - jtauy + rep_vdw_[1]]
-                                        [ktauz - jtauz + rep_vdw_[2]]
-                                        -= tmp1 / 6.0;
-
-                                    dc9 = (dc6ij[jat][iat] / c6ij + dc6ij[kat][iat] / c6ik) * c9 * 0.5;
-                                    dc6i[iat] += dc6_rest * dc9;
-
-                                    dc9 = (dc6ij[iat][jat] / c6ij + dc6ij[kat][jat] / c6jk) * c9 * 0.5;
-                                    dc6i[jat] += dc6_rest * dc9;
-
-                                    dc9 = (dc6ij[iat][kat] / c6ik + dc6ij[jat][kat] / c6jk) * c9 * 0.5;
-                                    dc6i[kat] += dc6_rest * dc9;
-                                } // end ktau
-}
-}
-                    } // end jtauz
-                } // end jtauy
-            } // jtaux
-        } // end iat
+#pragma omp critical(vdwd3_gdisp_reduce)
+        {
+            for (int iat = 0; iat < nat; iat++)
+            {
+                g[iat] += g_local[iat];
+                dc6i[iat] += dc6i_local[iat];
+            }
+            smearing_sigma += sigma_local;
+        }
     }
 
-    // dE/dr_ij * dr_ij/dxyz_i
-    double expterm, dcnn, x1;
-    ModuleBase::Vector3<double> rij, vec3;
-    for (int iat = 1; iat != ucell_.nat; iat++) {
-        for (int jat = 0; jat != iat; jat++)
-        {
-            linij = lin(iat, jat);
-            rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[jat]];
-            for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++) {
-                for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++) {
-                    for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
-                    {
-                        tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                              + static_cast<double>(tauz) * lat_[2];
-                        rij = xyz_[jat] - xyz_[iat] + tau;
-                        r2 = rij.norm2();
-                        if (r2 > para_.rthr2() || r2 < 0.5) {
-                            continue;
-}
-                        r = std::sqrt(r2);
-                        if (r2 < para_.cn_thr2())
-                        {
-                            expterm = exp(-para_.k1() * (rcovij / r - 1.0));
-                            dcnn = -para_.k1() * rcovij * expterm / (r2 * (expterm + 1.0) * (expterm + 1.0));
-                        }
-                        else {
-                            dcnn = 0.0;
-}
-                        x1 = drij[linij][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]]
-                             + dcnn * (dc6i[iat] + dc6i[jat]);
-                        vec3 = x1 * rij / r;
-                        g[iat] += vec3;
-                        g[jat] -= vec3;
-
-                        std::vector<double> vec = {vec3.x, vec3.y, vec3.z};
-                        std::vector<double> rij_vec = {rij.x, rij.y, rij.z};
-                        for (size_t i = 0; i != 3; i++) {
-                            for (size_t j = 0; j != 3; j++)
-                            {
-                                smearing_sigma(i, j) += vec[j] * rij_vec[i];
-                            }
-}
-                    } // end tau
-}
-}
-        } // end iat, jat
-}
-    for (int iat = 0; iat != ucell_.nat; iat++)
+    // dE/dC6 * dC6/dCN * dCN/dr_ij, after dc6i of all the atoms are summed up
+#pragma omp parallel
     {
-        linii = lin(iat, iat);
-        rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[iat]];
-        for (int taux = -rep_vdw_[0]; taux <= rep_vdw_[0]; taux++) {
-            for (int tauy = -rep_vdw_[1]; tauy <= rep_vdw_[1]; tauy++) {
-                for (int tauz = -rep_vdw_[2]; tauz <= rep_vdw_[2]; tauz++)
+        std::vector<Neighbor> neighbors;
+        std::vector<ModuleBase::Vector3<double>> g_local(nat);
+        ModuleBase::matrix sigma_local(3, 3);
+#pragma omp for schedule(dynamic) nowait
+        for (int iat = 0; iat < nat; iat++)
+        {
+            search_neighbors(iat, para_.cn_thr2(), rep_vdw_, true, neighbors);
+            for (const Neighbor &nb: neighbors)
+            {
+                const int jat = nb.jat;
+                const double r2 = nb.r2;
+                if (r2 >= para_.cn_thr2() || (jat != iat && (r2 > para_.rthr2() || r2 < 0.5)))
                 {
-                    if (taux == 0 && tauy == 0 && tauz == 0) {
-                        continue;
-}
-                    tau = static_cast<double>(taux) * lat_[0] + static_cast<double>(tauy) * lat_[1]
-                          + static_cast<double>(tauz) * lat_[2];
-                    r2 = tau.norm2();
-                    r = std::sqrt(r2);
-                    if (r2 < para_.cn_thr2())
-                    {
-                        expterm = exp(-para_.k1() * (rcovij / r - 1.0));
-                        dcnn = -para_.k1() * rcovij * expterm / (r2 * (expterm + 1.0) * (expterm + 1.0));
-                    }
-                    else {
-                        dcnn = 0.0;
-}
-                    x1 = drij[linii][taux + rep_vdw_[0]][tauy + rep_vdw_[1]][tauz + rep_vdw_[2]] + dcnn * dc6i[iat];
-
-                    vec3 = x1 * tau / r;
-                    std::vector<double> vec = {vec3.x, vec3.y, vec3.z};
-                    std::vector<double> tau_vec = {tau.x, tau.y, tau.z};
-                    for (size_t i = 0; i != 3; i++) {
-                        for (size_t j = 0; j != 3; j++)
-                        {
-                            smearing_sigma(i, j) += vec[j] * tau_vec[i];
-                        }
-}
-                } // end tau
-}
-}
-    } // end iat
+                    continue;
+                }
+                const double r = std::sqrt(r2);
+                const double rcovij = para_.rcov()[iz_[iat]] + para_.rcov()[iz_[jat]];
+                const double expterm = exp(-para_.k1() * (rcovij / r - 1.0));
+                const double dcnn = -para_.k1() * rcovij * expterm / (r2 * (expterm + 1.0) * (expterm + 1.0));
+                const double x1 = (jat == iat) ? dcnn * dc6i[iat] : dcnn * (dc6i[iat] + dc6i[jat]);
+                add_pair_gradient(x1, nb.rij, r, iat, jat, g_local, sigma_local);
+            }
+        }
+#pragma omp critical(vdwd3_gdisp_reduce)
+        {
+            for (int iat = 0; iat < nat; iat++)
+            {
+                g[iat] += g_local[iat];
+            }
+            smearing_sigma += sigma_local;
+        }
+    }
 }
 
 } // namespace vdw
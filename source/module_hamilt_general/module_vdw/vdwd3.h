@@ -32,12 +32,50 @@ class Vdwd3 : public Vdw
     std::vector<int> rep_vdw_;
     std::vector<int> rep_cn_;
 
+    /// atom jat in the cell shifted by tau = t.x * lat_[0] + t.y * lat_[1] + t.z * lat_[2]
+    struct Neighbor
+    {
+        int jat;
+        ModuleBase::Vector3<int> t;
+        ModuleBase::Vector3<double> rij; // xyz_[jat] + tau - xyz_[iat]
+        double r2;
+    };
+
+    /// the atoms put into a grid of bins in the cell, to search the neighbors only in the nearby bins
+    std::vector<int> nbin_;                             // number of bins along each lattice vector
+    std::vector<double> plane_dist_;                    // distance between the lattice planes
+    double bin_radius_ = 0.0;                           // half of the longest diagonal of a bin
+    std::vector<int> bin_start_;                        // the atoms in bin ib are bin_atom_[bin_start_[ib]:bin_start_[ib+1]]
+    std::vector<int> bin_atom_;
+    std::vector<ModuleBase::Vector3<int>> atom_bin_;    // the bin of each atom
+    std::vector<ModuleBase::Vector3<double>> xyz_cell_; // the atoms put back into the cell
+    std::vector<ModuleBase::Vector3<int>> shift_;       // xyz_ = xyz_cell_ + shift_ * lat_
+
+    /// C6 of the atoms iat and jat, and its derivatives dc6i, dc6j with respect to the coordination numbers
+    /// of iat and jat, for one pair of atoms within the cutoff in any of the images
+    struct PairC6
+    {
+        int jat;
+        double c6;
+        double dc6i;
+        double dc6j;
+    };
+
     void cal_energy() override;
     void cal_force() override;
     void cal_stress() override;
 
     void init();
 
+    void build_bins(const std::vector<ModuleBase::Vector3<double>> &taud);
+
+    /// the neighbors of atom iat within sqrt(rthr2), with |t| <= rep, and jat <= iat only if half
+    void search_neighbors(const int iat,
+                          const double rthr2,
+                          const std::vector<int> &rep,
+                          const bool half,
+                          std::vector<Neighbor> &neighbors) const;
+
     void set_criteria(double rthr, const std::vector<ModuleBase::Vector3<double>> &lat, std::vector<double> &tau_max);
 
     std::vector<double> atom_kind();
@@ -46,25 +84,20 @@ class Vdwd3 : public Vdw
 
     void pbc_ncoord(std::vector<double> &cn);
 
-    void pbc_three_body(const std::vector<int> &iz,
-                        const std::vector<ModuleBase::Vector3<double>> &lat,
-                        const std::vector<ModuleBase::Vector3<double>> &xyz,
-                        const std::vector<int> &rep_cn,
-                        const std::vector<double> &cc6ab,
-                        double &eabc);
+    /// C6 of the atoms iat and jat, and dc6i, dc6j only if derivative
+    void cal_pair_c6(const int iat, const int jat, const std::vector<double> &cn, const bool derivative, PairC6 &pair);
+
+    /// pair_c6[iat] are the pairs of iat with all the atoms within cn_thr in the order of jat, which have
+    /// all the sides of the triangles of the three-body term. Returns true if the lists are replaced by a dense
+    /// table, which takes no more memory, then pair_c6[iat][jat] is the pair iat >= jat.
+    bool set_pair_c6(const std::vector<double> &cn, const bool derivative, std::vector<std::vector<PairC6>> &pair_c6);
+
+    void pbc_three_body(const std::vector<std::vector<PairC6>> &pair_c6, const bool dense, double &eabc);
 
     void pbc_gdisp(std::vector<ModuleBase::Vector3<double>> &g, ModuleBase::matrix &smearing_sigma);
 
     void get_dc6_dcnij(int mxci, int mxcj, double cni, double cnj, int izi, int izj, int iat, int jat,
                        double &c6check, double &dc6i, double &dc6j);
-
-    int lin(int i1, int i2)
-    {
-        int idum1 = std::max(i1 + 1, i2 + 1);
-        int idum2 = std::min(i1 + 1, i2 + 1);
-        int res = idum2 + idum1 * (idum1 - 1) / 2 - 1;
-        return res;
-    }
 };
 
 } // namespace vdw
@@ -54,6 +54,8 @@ struct Exx_Info
         double cauchy_stress_threshold = 0;
         double ccp_rmesh_times = 10;
         double kmesh_times = 4;
+        double cv_cache_memory = 0; // MB, 0 for no limit
+        double cv_reuse_tol = 0; // Bohr, 0 for no reuse
 
         int abfs_Lmax = 0; // tmp
 
@@ -4,6 +4,9 @@
 #include "../exx_info.h"
 #include "xctest.h"
 
+#include <chrono>
+#include <cmath>
+
 /************************************************
 *  unit test of functionals
 ***********************************************/
@@ -912,6 +915,164 @@ TEST_F(XCTest_PBE_LibXC, set_xc_type)
     }
 }
 
+// the functionals on arrays of points give the same results as on one point at a time
+class XCTest_Array : public XCTest
+{
+    protected:
+        const int n = 20000;
+        std::vector<double> rho, grho;
+
+        void SetUp()
+        {
+            rho.resize(n);
+            grho.resize(n);
+            for(int i=0;i<n;i++)
+            {
+                // from 1e-8 to 1e4, with some gradients below the threshold of gcxc
+                rho[i] = std::pow(10.0, -8.0 + 12.0 * i / n);
+                grho[i] = (i % 7 == 0) ? 1.0e-12 : rho[i] * rho[i] * (0.01 + 5.0 * (i % 13) / 13.0);
+            }
+        }
+
+        void check(const std::string& xc_func)
+        {
+            XC_Functional::set_xc_type(xc_func);
+            std::vector<double> e(n), v(n), s(n), v1(n), v2(n), work(5 * n);
+            std::vector<int> index(n);
+
+            auto start = std::chrono::steady_clock::now();
+            XC_Functional::xc(n, rho.data(), e.data(), v.data());
+            if(XC_Functional::get_func_type() != 1)
+            {
+                XC_Functional::gcxc(n, rho.data(), grho.data(), s.data(), v1.data(), v2.data(), index.data(), work.data());
+            }
+            const double time_array = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::vector<double> e0(n), v0(n), s0(n), v10(n), v20(n);
+            start = std::chrono::steady_clock::now();
+            for(int i=0;i<n;i++)
+            {
+                XC_Functional::xc(rho[i], e0[i], v0[i]);
+                if(XC_Functional::get_func_type() != 1)
+                {
+                    XC_Functional::gcxc(rho[i], grho[i], s0[i], v10[i], v20[i]);
+                }
+            }
+            const double time_point = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << xc_func << " : " << time_point << " s by point, " << time_array << " s by array" << std::endl;
+
+            for(int i=0;i<n;i++)
+            {
+                EXPECT_NEAR(e[i], e0[i], 1.0e-12 * (1.0 + std::abs(e0[i])));
+                EXPECT_NEAR(v[i], v0[i], 1.0e-12 * (1.0 + std::abs(v0[i])));
+                if(XC_Functional::get_func_type() != 1)
+                {
+                    EXPECT_NEAR(s[i], s0[i], 1.0e-12 * (1.0 + std::abs(s0[i])));
+                    EXPECT_NEAR(v1[i], v10[i], 1.0e-12 * (1.0 + std::abs(v10[i])));
+                    EXPECT_NEAR(v2[i], v20[i], 1.0e-12 * (1.0 + std::abs(v20[i])));
+                }
+            }
+        }
+};
+
+TEST_F(XCTest_Array, LDA)
+{
+    check("PZ");
+    check("PWLDA");
+}
+
+TEST_F(XCTest_Array, GGA)
+{
+    check("PBE");
+    check("PBEsol");
+    check("REVPBE");
+    check("BP");
+    check("WC");
+    check("BLYP");
+    check("PW91");
+    check("OLYP");
+    check("HCTH");
+    check("PBE0");
+}
+
+TEST_F(XCTest_Array, Kernels)
+{
+    // rs from 0.01 to 100, across rs = 1 where pw and pz change their form
+    std::vector<double> rs(n);
+    for(int i=0;i<n;i++)
+    {
+        rs[i] = std::pow(10.0, -2.0 + 4.0 * i / n);
+    }
+    // the points above the thresholds of gcxc, which are given to the GGA kernels
+    std::vector<double> r, g;
+    for(int i=0;i<n;i++)
+    {
+        if(rho[i] > 1.0e-6 && grho[i] >= 1.0e-10)
+        {
+            r.push_back(rho[i]);
+            g.push_back(grho[i]);
+        }
+    }
+    const int m = r.size();
+    std::vector<double> e(n), v(n), s(m), v1(m), v2(m);
+
+    auto check_lda = [&](const std::string& name, const std::vector<double>& e0, const std::vector<double>& v0)
+    {
+        for(int i=0;i<n;i++)
+        {
+            EXPECT_DOUBLE_EQ(e[i], e0[i]) << name << " rs = " << rs[i];
+            EXPECT_DOUBLE_EQ(v[i], v0[i]) << name << " rs = " << rs[i];
+        }
+    };
+    auto check_gga = [&](const std::string& name, const std::vector<double>& s0,
+        const std::vector<double>& v10, const std::vector<double>& v20)
+    {
+        for(int i=0;i<m;i++)
+        {
+            EXPECT_DOUBLE_EQ(s[i], s0[i]) << name << " rho = " << r[i];
+            EXPECT_DOUBLE_EQ(v1[i], v10[i]) << name << " rho = " << r[i];
+            EXPECT_DOUBLE_EQ(v2[i], v20[i]) << name << " rho = " << r[i];
+        }
+    };
+
+    std::vector<double> e0(n), v0(n);
+    XC_Functional::slater(n, rs.data(), e.data(), v.data());
+    for(int i=0;i<n;i++) { XC_Functional::slater(rs[i], e0[i], v0[i]); }
+    check_lda("slater", e0, v0);
+    for(int iflag=0;iflag<2;iflag++)
+    {
+        XC_Functional::pw(n, rs.data(), iflag, e.data(), v.data());
+        for(int i=0;i<n;i++) { XC_Functional::pw(rs[i], iflag, e0[i], v0[i]); }
+        check_lda("pw", e0, v0);
+        XC_Functional::pz(n, rs.data(), iflag, e.data(), v.data());
+        for(int i=0;i<n;i++) { XC_Functional::pz(rs[i], iflag, e0[i], v0[i]); }
+        check_lda("pz", e0, v0);
+    }
+
+    std::vector<double> s0(m), v10(m), v20(m);
+    XC_Functional::becke88(m, r.data(), g.data(), s.data(), v1.data(), v2.data());
+    for(int i=0;i<m;i++) { XC_Functional::becke88(r[i], g[i], s0[i], v10[i], v20[i]); }
+    check_gga("becke88", s0, v10, v20);
+    for(int iflag=0;iflag<3;iflag++)
+    {
+        XC_Functional::pbex(m, r.data(), g.data(), iflag, s.data(), v1.data(), v2.data());
+        for(int i=0;i<m;i++) { XC_Functional::pbex(r[i], g[i], iflag, s0[i], v10[i], v20[i]); }
+        check_gga("pbex", s0, v10, v20);
+    }
+    XC_Functional::perdew86(m, r.data(), g.data(), s.data(), v1.data(), v2.data());
+    for(int i=0;i<m;i++) { XC_Functional::perdew86(r[i], g[i], s0[i], v10[i], v20[i]); }
+    check_gga("perdew86", s0, v10, v20);
+    for(int iflag=0;iflag<2;iflag++)
+    {
+        XC_Functional::pbec(m, r.data(), g.data(), iflag, s.data(), v1.data(), v2.data());
+        for(int i=0;i<m;i++) { XC_Functional::pbec(r[i], g[i], iflag, s0[i], v10[i], v20[i]); }
+        check_gga("pbec", s0, v10, v20);
+    }
+    XC_Functional::hcth(m, r.data(), g.data(), s.data(), v1.data(), v2.data());
+    for(int i=0;i<m;i++) { XC_Functional::hcth(r[i], g[i], s0[i], v10[i], v20[i]); }
+    check_gga("hcth", s0, v10, v20);
+}
+
 /*
 //for printing results
             std::cout << std::setprecision(10);
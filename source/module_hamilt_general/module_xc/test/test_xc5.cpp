@@ -9,6 +9,10 @@
 #include "xc3_mock.h"
 #include "module_base/matrix.h"
 #include "../../../module_base/parallel_reduce.h"
+#include <chrono>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /************************************************
 *  unit test of functionals
@@ -19,6 +23,8 @@
 // v_xc, the unified interface of LDA and GGA functionals
 // v_xc_libxc, called by v_xc, when we use functionals from LIBXC
 // v_xc_meta, unified interface of mGGA functionals
+// v_xc_libxc and v_xc_meta on a grid of several blocks give the same results for any number of threads,
+// the time for each number of threads is printed
 
 class XCTest_VXC : public XCTest
 {
@@ -339,6 +345,121 @@ TEST_F(XCTest_VXC_meta, set_xc_type)
     EXPECT_NEAR(vtau2(1,4),0.0311787189,1.0e-8);    
 }
 
+class XCTest_VXC_Threads : public XCTest
+{
+    protected:
+
+        ModulePW::PW_Basis rhopw;
+        UnitCell ucell;
+        Charge chr;
+
+        void SetUp()
+        {
+            // several blocks of libxc, and a partial one
+            const int nrxx = 5 * XC_Functional_Libxc::block_size + 17;
+            rhopw.nrxx = nrxx;
+            rhopw.npw = nrxx;
+            rhopw.nmaxgr = nrxx;
+            rhopw.gcar = new ModuleBase::Vector3<double> [nrxx];
+            rhopw.nxyz = nrxx;
+
+            ucell.tpiba = 1;
+            ucell.omega = 1;
+
+            chr.rhopw = &(rhopw);
+            chr.rho = new double*[2];
+            chr.kin_r = new double*[2];
+            for(int is=0;is<2;is++)
+            {
+                chr.rho[is] = new double[nrxx];
+                chr.kin_r[is] = new double[nrxx];
+            }
+            chr.rho_core = new double[nrxx];
+
+            for(int i=0;i<nrxx;i++)
+            {
+                chr.rho[0][i] = std::abs(std::sin(0.01*i));
+                chr.rho[1][i] = 0.1*std::abs(std::cos(0.013*i));
+                chr.kin_r[0][i] = 0.02+0.01*std::abs(std::sin(0.007*i));
+                chr.kin_r[1][i] = 0.5+0.01*std::abs(std::cos(0.005*i));
+                chr.rho_core[i] = 0;
+                rhopw.gcar[i] = 1;
+            }
+        }
+
+        // the results with one thread and the time for each number of threads
+        template <typename F>
+        void check_threads(const std::string& name, F cal)
+        {
+#ifdef _OPENMP
+            const int max_threads = omp_get_max_threads();
+#else
+            const int max_threads = 1;
+#endif
+            std::vector<double> ref;
+            for(int nthreads=1; nthreads<=max_threads; nthreads*=2)
+            {
+#ifdef _OPENMP
+                omp_set_num_threads(nthreads);
+#endif
+                const auto start = std::chrono::steady_clock::now();
+                const std::vector<double> result = cal();
+                const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                std::cout << " " << name << ", threads: " << nthreads << ", time: " << time << " s" << std::endl;
+                if(ref.empty())
+                {
+                    ref = result;
+                    continue;
+                }
+                ASSERT_EQ(result.size(), ref.size());
+                for(int i=0;i<ref.size();i++)
+                {
+                    EXPECT_NEAR(result[i], ref[i], 1.0e-10 * std::max(1.0, std::abs(ref[i])));
+                }
+            }
+#ifdef _OPENMP
+            omp_set_num_threads(max_threads);
+#endif
+        }
+};
+
+TEST_F(XCTest_VXC_Threads, v_xc_libxc)
+{
+    XC_Functional::set_xc_type("GGA_X_PBE+GGA_C_PBE");
+    for(int nspin : {1, 2})
+    {
+        PARAM.input.nspin = nspin;
+        this->check_threads("v_xc_libxc, nspin " + std::to_string(nspin), [this]()
+        {
+            const std::tuple<double, double, ModuleBase::matrix> etxc_vtxc_v
+                = XC_Functional_Libxc::v_xc_libxc(XC_Functional::get_func_id(), rhopw.nrxx, ucell.omega, ucell.tpiba, &chr);
+            const ModuleBase::matrix& v = std::get<2>(etxc_vtxc_v);
+            std::vector<double> result = {std::get<0>(etxc_vtxc_v), std::get<1>(etxc_vtxc_v)};
+            result.insert(result.end(), v.c, v.c + v.nr * v.nc);
+            return result;
+        });
+    }
+}
+
+TEST_F(XCTest_VXC_Threads, v_xc_meta)
+{
+    XC_Functional::set_xc_type("SCAN");
+    for(int nspin : {1, 2})
+    {
+        PARAM.input.nspin = nspin;
+        this->check_threads("v_xc_meta, nspin " + std::to_string(nspin), [this]()
+        {
+            const std::tuple<double, double, ModuleBase::matrix, ModuleBase::matrix> etxc_vtxc_v
+                = XC_Functional_Libxc::v_xc_meta(XC_Functional::get_func_id(), rhopw.nrxx, ucell.omega, ucell.tpiba, &chr);
+            const ModuleBase::matrix& v = std::get<2>(etxc_vtxc_v);
+            const ModuleBase::matrix& vofk = std::get<3>(etxc_vtxc_v);
+            std::vector<double> result = {std::get<0>(etxc_vtxc_v), std::get<1>(etxc_vtxc_v)};
+            result.insert(result.end(), v.c, v.c + v.nr * v.nc);
+            result.insert(result.end(), vofk.c, vofk.c + vofk.nr * vofk.nc);
+            return result;
+        });
+    }
+}
 
 int main(int argc, char **argv)
 {
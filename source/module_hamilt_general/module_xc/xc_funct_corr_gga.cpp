@@ -11,6 +11,8 @@
 
 #include "xc_functional.h"
 
+#include <algorithm>
+
 void XC_Functional::perdew86(const double rho, const double grho, double &sc, double &v1c, double &v2c)
 {
     // Perdew gradient correction on correlation: PRB 33, 8822 (1986)
@@ -58,6 +60,14 @@ void XC_Functional::perdew86(const double rho, const double grho, double &sc, do
     return;
 } //end subroutine perdew86
 
+void XC_Functional::perdew86(const int n, const double* rho, const double* grho, double* sc, double* v1c, double* v2c)
+{
+    for(int i = 0; i < n; ++i)
+    {
+        XC_Functional::perdew86(rho[i], grho[i], sc[i], v1c[i], v2c[i]);
+    }
+}
+
 void XC_Functional::ggac(const double &rho,const double &grho, double &sc, double &v1c, double &v2c)
 {
     // Perdew-Wang GGA (PW91) correlation part
@@ -132,26 +142,18 @@ void XC_Functional::ggac(const double &rho,const double &grho, double &sc, doubl
     return;
 } //end subroutine ggac
 
-void XC_Functional::pbec(const double &rho, const double &grho, const int &iflag, double &sc, double &v1c, double &v2c)
+namespace
+{
+// the gradient correction of PBE correlation, from the LDA energy and potential ec, vc at rs
+inline void pbec_h(const double rho, const double grho, const int iflag, const double rs,
+	const double ec, const double vc, double &sc, double &v1c, double &v2c)
 {
-	// PBE correlation (without LDA part)
-	// iflag=0: J.P.Perdew, K.Burke, M.Ernzerhof, PRL 77, 3865 (1996).
-	// iflag=1: J.P.Perdew et al., PRL 100, 136406 (2008).
 	const double ga = 0.0310906908696548950;
 	const double be[2] = {0.06672455060314922, 0.046};
 
-	const double third = 1.0 / 3.0;
-	const double pi34 = 0.62035049089940;
 	const double xkf = 1.9191582926775130;
 	const double xks = 1.1283791670955130;
 
-	// pi34=(3/4pi)^(1/3), xkf=(9 pi/4)^(1/3), xks= sqrt(4/pi)
-	double ec, vc;
-
-	const double rs = pi34 / pow(rho, third);
-
-	XC_Functional::pw(rs, 0, ec, vc);
-
 	const double kf = xkf / rs;
 	const double ks = xks * sqrt(kf);
 	const double t = sqrt(grho) / (2.0 * ks * rho);
@@ -170,11 +172,54 @@ void XC_Functional::pbec(const double &rho, const double &grho, const int &iflag
 
 	sc = rho * h0;
 	v1c = h0 + dh0;
-    v2c = ddh0;
+	v2c = ddh0;
+}
+} // namespace
+
+void XC_Functional::pbec(const double &rho, const double &grho, const int &iflag, double &sc, double &v1c, double &v2c)
+{
+	// PBE correlation (without LDA part)
+	// iflag=0: J.P.Perdew, K.Burke, M.Ernzerhof, PRL 77, 3865 (1996).
+	// iflag=1: J.P.Perdew et al., PRL 100, 136406 (2008).
+	const double third = 1.0 / 3.0;
+	const double pi34 = 0.62035049089940;
+
+	// pi34=(3/4pi)^(1/3), xkf=(9 pi/4)^(1/3), xks= sqrt(4/pi)
+	double ec, vc;
+
+	const double rs = pi34 / pow(rho, third);
+
+	XC_Functional::pw(rs, 0, ec, vc);
+
+	pbec_h(rho, grho, iflag, rs, ec, vc, sc, v1c, v2c);
 
 	return;
 }
 
+void XC_Functional::pbec(const int n, const double* rho, const double* grho, const int iflag,
+	double* sc, double* v1c, double* v2c)
+{
+	const double third = 1.0 / 3.0;
+	const double pi34 = 0.62035049089940;
+
+	// the LDA part of a chunk of points is done first, since pw is in another file
+	constexpr int nchunk = 256;
+	double rs[nchunk], ec[nchunk], vc[nchunk];
+	for(int i0 = 0; i0 < n; i0 += nchunk)
+	{
+		const int m = std::min(nchunk, n - i0);
+		for(int i = 0; i < m; ++i)
+		{
+			rs[i] = pi34 / pow(rho[i0 + i], third);
+		}
+		XC_Functional::pw(m, rs, 0, ec, vc);
+		for(int i = 0; i < m; ++i)
+		{
+			pbec_h(rho[i0 + i], grho[i0 + i], iflag, rs[i], ec[i], vc[i], sc[i0 + i], v1c[i0 + i], v2c[i0 + i]);
+		}
+	}
+}
+
 void XC_Functional::glyp(const double &rho, const double &grho, double &sc, double &v1c, double &v2c)
 {
     //-----------------------------------------------------------------------
@@ -65,6 +65,14 @@ void XC_Functional::pw(const double &rs, const int &iflag, double &ec, double &v
 	return;
 }
 
+void XC_Functional::pw(const int n, const double* rs, const int iflag, double* ec, double* vc)
+{
+    for(int i = 0; i < n; ++i)
+    {
+        XC_Functional::pw(rs[i], iflag, ec[i], vc[i]);
+    }
+}
+
 //LDA parameterization form Monte Carlo data
 //iflag=0: J.P. Perdew and A. Zunger, PRB 23, 5048 (1981)
 //iflag=1: G. Ortiz and P. Ballone, PRB 50, 1391 (1994)
@@ -101,6 +109,14 @@ void XC_Functional::pz(const double &rs, const int &iflag, double &ec, double &v
     return;
 }
 
+void XC_Functional::pz(const int n, const double* rs, const int iflag, double* ec, double* vc)
+{
+    for(int i = 0; i < n; ++i)
+    {
+        XC_Functional::pz(rs[i], iflag, ec[i], vc[i]);
+    }
+}
+
 // C. Lee, W. Yang, and R.G. Parr, PRB 37, 785 (1988)
 // LDA part only
 void XC_Functional::lyp(const double &rs, double &ec, double &vc)
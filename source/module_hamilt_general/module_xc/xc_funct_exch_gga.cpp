@@ -38,6 +38,14 @@ void XC_Functional::becke88(const double &rho, const double &grho, double &sx, d
     return;
 } // end subroutine becke88
 
+void XC_Functional::becke88(const int n, const double* rho, const double* grho, double* sx, double* v1x, double* v2x)
+{
+    for(int i = 0; i < n; ++i)
+    {
+        XC_Functional::becke88(rho[i], grho[i], sx[i], v1x[i], v2x[i]);
+    }
+}
+
 void XC_Functional::ggax(const double &rho, const double &grho, double &sx, double &v1x, double &v2x)
 {
     //-----------------------------------------------------------------------
@@ -131,6 +139,15 @@ double &sx, double &v1x, double &v2x)
 	return;
 }
 
+void XC_Functional::pbex(const int n, const double* rho, const double* grho, const int iflag,
+    double* sx, double* v1x, double* v2x)
+{
+    for(int i = 0; i < n; ++i)
+    {
+        XC_Functional::pbex(rho[i], grho[i], iflag, sx[i], v1x[i], v2x[i]);
+    }
+}
+
 void XC_Functional::optx(const double rho, const double grho, double &sx, double &v1x, double &v2x)
 {
     //     OPTX, Handy et al. JCP 116, p. 5411 (2002) and refs. therein
@@ -21,6 +21,17 @@ void XC_Functional::slater(const double &rs, double &ex, double &vx)
 	return;
 }
 
+void XC_Functional::slater(const int n, const double* rs, double* ex, double* vx)
+{
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+	for(int i = 0; i < n; ++i)
+	{
+		XC_Functional::slater(rs[i], ex[i], vx[i]);
+	}
+}
+
 //Slater exchange with alpha=1, corresponding to -1.374/r_s Ry
 //used to recover old results
 void XC_Functional::slater1(const double &rs, double &ex, double &vx)
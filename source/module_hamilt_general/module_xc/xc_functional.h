@@ -129,6 +129,9 @@ class XC_Functional
 	// LDA
 	static void xc(const double &rho, double &exc, double &vxc);
 
+	// LDA on n points, all with rho > 0
+	static void xc(const int n, const double* rho, double* exc, double* vxc);
+
 	// LSDA
 	static void xc_spin(const double &rho, const double &zeta,
 			double &exc, double &vxcup, double &vxcdw);
@@ -151,6 +154,11 @@ class XC_Functional
 	static void gcxc(const double &rho, const double &grho,
 			double &sxc, double &v1xc, double &v2xc);
 
+	// GGA on n points, zeros are given for small rho or grho as in the one-point version;
+	// index (n ints) and work (5 * n doubles) are workspaces given by the caller
+	static void gcxc(const int n, const double* rho, const double* grho,
+			double* sxc, double* v1xc, double* v2xc, int* index, double* work);
+
 	// spin polarized GGA
 	static void gcx_spin(double rhoup, double rhodw, double grhoup2, double grhodw2,
             double &sx, double &v1xup, double &v1xdw, double &v2xup,
@@ -223,6 +231,9 @@ class XC_Functional
 	static void slater1(const double &rs, double &ex, double &vx);
 	static void slater_rxc(const double &rs, double &ex, double &vx);
 
+	// the same as above on arrays of n points, vectorized by the compiler
+	static void slater(const int n, const double* rs, double* ex, double* vx);
+
 	// For LSDA exchange energy
 	static void slater_spin( const double &rho, const double &zeta,
 		double &ex, double &vxup, double &vxdw);
@@ -257,6 +268,10 @@ class XC_Functional
 	static void hl(const double &rs, double &ec, double &vc);
 	static void gl(const double &rs, double &ec, double &vc);
 
+	// the same as above on arrays of n points
+	static void pw(const int n, const double* rs, const int iflag, double* ec, double* vc);
+	static void pz(const int n, const double* rs, const int iflag, double* ec, double* vc);
+
 	// For LSDA correlation energy
 	static void pw_spin( const double &rs, const double &zeta,
         double &ec, double &vcup, double &vcdw);
@@ -285,6 +300,11 @@ class XC_Functional
 	static void optx(const double rho, const double grho, double &sx, double &v1x, double &v2x);
 	static void wcx(const double &rho,const double &grho, double &sx, double &v1x, double &v2x);
 
+	// the same as above on arrays of n points
+	static void becke88(const int n, const double* rho, const double* grho, double* sx, double* v1x, double* v2x);
+	static void pbex(const int n, const double* rho, const double* grho, const int iflag,
+		double* sx, double* v1x, double* v2x);
+
 	static void becke88_spin(double rho, double grho, double &sx, double &v1x,
 		double &v2x);
 
@@ -309,6 +329,11 @@ class XC_Functional
 		double &sc, double &v1c, double &v2c);
 	static void glyp(const double &rho, const double &grho, double &sc, double &v1c, double &v2c);
 
+	// the same as above on arrays of n points
+	static void perdew86(const int n, const double* rho, const double* grho, double* sc, double* v1c, double* v2c);
+	static void pbec(const int n, const double* rho, const double* grho, const int iflag,
+		double* sc, double* v1c, double* v2c);
+
 	static void perdew86_spin(double rho, double zeta, double grho, double &sc,
 		double &v1cup, double &v1cdw, double &v2c);
 	//static void ggac_spin(double rho, double zeta, double grho, double &sc,
@@ -323,6 +348,7 @@ class XC_Functional
 // hcth calls pwcorr
 
 	static void hcth(const double rho, const double grho, double &sx, double &v1x, double &v2x);
+	static void hcth(const int n, const double* rho, const double* grho, double* sx, double* v1x, double* v2x);
 	static void pwcorr(const double r, const double c[], double &g, double &dg);
 
 };
@@ -12,6 +12,8 @@
 #include "module_base/timer.h"
 #include "module_basis/module_pw/pw_basis_k.h"
 #include "module_parameter/parameter.h"
+#include <algorithm>
+#include <vector>
 #include <ATen/core/tensor.h>
 #include <ATen/core/tensor_map.h>
 #include <ATen/core/tensor_types.h>
@@ -20,6 +22,9 @@
 #ifdef USE_LIBXC
 #include "xc_functional_libxc.h"
 #endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // from gradcorr.f90
 void XC_Functional::gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
@@ -197,6 +202,15 @@ void XC_Functional::gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
 	double vtxcgc = 0.0;
 	double etxcgc = 0.0;
 
+#ifdef USE_LIBXC
+	// the functionals are initialized once for each thread, rather than at each grid point
+	std::vector<std::vector<xc_func_type>> funcs_threads;
+	if(use_libxc && (nspin0 != 1 || is_stress))
+	{
+		funcs_threads = XC_Functional_Libxc::init_func_threads(func_id, (nspin0 == 1) ? XC_UNPOLARIZED : XC_POLARIZED);
+	}
+#endif
+
 #ifdef _OPENMP
 #pragma omp parallel
 {
@@ -218,6 +232,14 @@ void XC_Functional::gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
 	double &local_etxcgc = etxcgc;
 #endif
 
+#ifdef USE_LIBXC
+#ifdef _OPENMP
+	const std::vector<xc_func_type>* funcs = funcs_threads.empty() ? nullptr : &funcs_threads[omp_get_thread_num()];
+#else
+	const std::vector<xc_func_type>* funcs = funcs_threads.empty() ? nullptr : &funcs_threads[0];
+#endif
+#endif
+
 	double grho2a = 0.0;
 	double grho2b = 0.0;
 	double sxc = 0.0;
@@ -227,72 +249,103 @@ void XC_Functional::gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
 	if(nspin0==1)
 	{
 		double segno;
+		// the built-in functionals are evaluated on a block of points at a time
+		constexpr int block_size = 1024;
+		const bool use_block = !(use_libxc && is_stress);
+		std::vector<double> arho_b, grho2a_b, sxc_b, v1xc_b, v2xc_b, work_b;
+		std::vector<int> index_b;
+		if(use_block)
+		{
+			arho_b.resize(block_size);
+			grho2a_b.resize(block_size);
+			sxc_b.resize(block_size);
+			v1xc_b.resize(block_size);
+			v2xc_b.resize(block_size);
+			index_b.resize(block_size);
+			work_b.resize(5 * block_size);
+		}
 #ifdef _OPENMP
 #pragma omp for
 #endif
-		for(int ir=0; ir<rhopw->nrxx; ir++)
+		for(int ir0=0; ir0<rhopw->nrxx; ir0+=block_size)
 		{
-			const double arho = std::abs( rhotmp1[ir] );
-			if(!is_stress) { h1[ir].x = h1[ir].y = h1[ir].z = 0.0;
-}
-
-			if(arho > epsr)
+			const int nb = std::min(block_size, rhopw->nrxx - ir0);
+			if(use_block)
 			{
-				grho2a = gdr1[ir].norm2();
-				
-				//normally values in rhotmp can either be >= 0 or < 0.
-				if( rhotmp1[ir] >= 0.0 ) { segno = 1.0;
-				} else { segno = -1.0;
-}
-				if (use_libxc && is_stress)
+				for(int i=0; i<nb; i++)
 				{
-#ifdef USE_LIBXC
-					if(func_type == 3 || func_type == 5) //the gradcorr part to stress of mGGA
+					arho_b[i] = std::abs( rhotmp1[ir0 + i] );
+					grho2a_b[i] = gdr1[ir0 + i].norm2();
+				}
+				XC_Functional::gcxc( nb, arho_b.data(), grho2a_b.data(), sxc_b.data(), v1xc_b.data(), v2xc_b.data(),
+					index_b.data(), work_b.data());
+			}
+			for(int ir=ir0; ir<ir0+nb; ir++)
+			{
+				const double arho = std::abs( rhotmp1[ir] );
+				if(!is_stress) { h1[ir].x = h1[ir].y = h1[ir].z = 0.0;
+	}
+
+				if(arho > epsr)
+				{
+					grho2a = gdr1[ir].norm2();
+				
+					//normally values in rhotmp can either be >= 0 or < 0.
+					if( rhotmp1[ir] >= 0.0 ) { segno = 1.0;
+					} else { segno = -1.0;
+	}
+					if (use_libxc && is_stress)
 					{
-						double v3xc;
-						double atau = chr->kin_r[0][ir]/2.0;
-						XC_Functional_Libxc::tau_xc( func_id, arho, grho2a, atau, sxc, v1xc, v2xc, v3xc);
-					}
+	#ifdef USE_LIBXC
+						if(func_type == 3 || func_type == 5) //the gradcorr part to stress of mGGA
+						{
+							double v3xc;
+							double atau = chr->kin_r[0][ir]/2.0;
+							XC_Functional_Libxc::tau_xc( *funcs, arho, grho2a, atau, sxc, v1xc, v2xc, v3xc);
+						}
+						else
+						{
+							XC_Functional_Libxc::gcxc_libxc( *funcs, arho, grho2a, sxc, v1xc, v2xc);
+						}
+	#endif 
+					} // end use_libxc
 					else
 					{
-						XC_Functional_Libxc::gcxc_libxc( func_id, arho, grho2a, sxc, v1xc, v2xc);
+						sxc = sxc_b[ir - ir0];
+						v1xc = v1xc_b[ir - ir0];
+						v2xc = v2xc_b[ir - ir0];
 					}
-#endif 
-				} // end use_libxc
-				else
-				{
-					XC_Functional::gcxc( arho, grho2a, sxc, v1xc, v2xc);
-				}
-				if(is_stress)
-				{
-					double tt[3];
-					tt[0] = gdr1[ir].x;
-					tt[1] = gdr1[ir].y;
-					tt[2] = gdr1[ir].z;
-					for(int l = 0;l< 3;l++)
+					if(is_stress)
 					{
-						for(int m = 0;m< l+1;m++)
+						double tt[3];
+						tt[0] = gdr1[ir].x;
+						tt[1] = gdr1[ir].y;
+						tt[2] = gdr1[ir].z;
+						for(int l = 0;l< 3;l++)
 						{
-							int ind = l*3 + m;
-							local_stress_gga[ind] += tt[l] * tt[m] * ModuleBase::e2 * v2xc;
+							for(int m = 0;m< l+1;m++)
+							{
+								int ind = l*3 + m;
+								local_stress_gga[ind] += tt[l] * tt[m] * ModuleBase::e2 * v2xc;
+							}
 						}
 					}
-				}
-				else
-				{
-					// first term of the gradient correction:
-					// D(rho*Exc)/D(rho)
-					v(0, ir) += ModuleBase::e2 * v1xc;
-					// cout << "v    " << v(0, ir) << endl;
+					else
+					{
+						// first term of the gradient correction:
+						// D(rho*Exc)/D(rho)
+						v(0, ir) += ModuleBase::e2 * v1xc;
+						// cout << "v    " << v(0, ir) << endl;
 					
-					// h contains
-					// D(rho*Exc) / D(|grad rho|) * (grad rho) / |grad rho|
-					h1[ir] = ModuleBase::e2 * v2xc * gdr1[ir];
+						// h contains
+						// D(rho*Exc) / D(|grad rho|) * (grad rho) / |grad rho|
+						h1[ir] = ModuleBase::e2 * v2xc * gdr1[ir];
 					
-					local_vtxcgc += ModuleBase::e2* v1xc * ( rhotmp1[ir] - chr->rho_core[ir] );
-					local_etxcgc += ModuleBase::e2* sxc  * segno;
-				}
-			} // end arho > epsr
+						local_vtxcgc += ModuleBase::e2* v1xc * ( rhotmp1[ir] - chr->rho_core[ir] );
+						local_etxcgc += ModuleBase::e2* sxc  * segno;
+					}
+				} // end arho > epsr
+			}
 		}
 	}// end nspin0 == 1
 	else // spin polarized case
@@ -312,14 +365,14 @@ void XC_Functional::gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
 					double atau1 = chr->kin_r[0][ir]/2.0;
 					double atau2 = chr->kin_r[1][ir]/2.0;
 					XC_Functional_Libxc::tau_xc_spin(
-						func_id,
+						*funcs,
 						rhotmp1[ir], rhotmp2[ir], gdr1[ir], gdr2[ir], 
 						atau1, atau2, sxc, v1xcup, v1xcdw, v2xcup, v2xcdw, v2xcud, v3xcup, v3xcdw);
 				}
 				else
 				{
 					XC_Functional_Libxc::gcxc_spin_libxc(
-						func_id,
+						*funcs,
 						rhotmp1[ir], rhotmp2[ir], gdr1[ir], gdr2[ir], 
 						sxc, v1xcup, v1xcdw, v2xcup, v2xcdw, v2xcud);
 				}
@@ -477,6 +530,9 @@ void XC_Functional::gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
 		}
 	}
 }
+#endif
+#ifdef USE_LIBXC
+	XC_Functional_Libxc::finish_func_threads(funcs_threads);
 #endif
 
 	//std::cout << "\n vtxcgc=" << vtxcgc;
@@ -11,6 +11,9 @@
 
 #include <xc.h>
 #include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 bool not_supported_xc_with_laplacian(const std::string& xc_func_in)
 {
 	// see Pyscf: https://github.com/pyscf/pyscf/blob/master/pyscf/dft/libxc.py#L1062
@@ -166,4 +169,28 @@ void XC_Functional_Libxc::finish_func(std::vector<xc_func_type> &funcs)
     }
 }
 
+std::vector<std::vector<xc_func_type>> XC_Functional_Libxc::init_func_threads(const std::vector<int> &func_id, const int xc_polarized)
+{
+#ifdef _OPENMP
+	const int nthreads = omp_get_max_threads();
+#else
+	const int nthreads = 1;
+#endif
+	// initialized one by one here, the threads only evaluate the functionals
+	std::vector<std::vector<xc_func_type>> funcs(nthreads);
+	for(int ithread = 0; ithread < nthreads; ++ithread)
+	{
+		funcs[ithread] = XC_Functional_Libxc::init_func(func_id, xc_polarized);
+	}
+	return funcs;
+}
+
+void XC_Functional_Libxc::finish_func_threads(std::vector<std::vector<xc_func_type>> &funcs)
+{
+	for(std::vector<xc_func_type> &funcs_thread : funcs)
+	{
+		XC_Functional_Libxc::finish_func(funcs_thread);
+	}
+}
+
 #endif
\ No newline at end of file
@@ -32,11 +32,19 @@ namespace XC_Functional_Libxc
 
     extern void finish_func(std::vector<xc_func_type> &funcs);
 
+    // one copy of the functionals for each OpenMP thread, since libxc runs on the calling thread only
+    extern std::vector<std::vector<xc_func_type>> init_func_threads(const std::vector<int> &func_id, const int xc_polarized);
+
+    extern void finish_func_threads(std::vector<std::vector<xc_func_type>> &funcs);
+
 
 //-------------------
 //  xc_functional_libxc_vxc.cpp
 //-------------------
 
+    // number of grid points given to libxc at a time by a thread, the arrays of a block stay in the cache
+    constexpr int block_size = 1024;
+
 	extern std::tuple<double,double,ModuleBase::matrix> v_xc_libxc(
 		const std::vector<int> &func_id,
 		const int &nrxx, // number of real-space grid
@@ -158,6 +166,18 @@ namespace XC_Functional_Libxc
         const ModuleBase::Vector3<double> gdr1, const ModuleBase::Vector3<double> gdr2,
         double &sxc, double &v1xcup, double &v1xcdw, double &v2xcup, double &v2xcdw, double &v2xcud);
 
+    // the same as above, with the functionals initialized by the caller
+    extern void gcxc_libxc(
+        const std::vector<xc_func_type> &funcs,
+        const double &rho, const double &grho,
+        double &sxc, double &v1xc, double &v2xc);
+
+    extern void gcxc_spin_libxc(
+        const std::vector<xc_func_type> &funcs,
+        const double rhoup, const double rhodw,
+        const ModuleBase::Vector3<double> gdr1, const ModuleBase::Vector3<double> gdr2,
+        double &sxc, double &v1xcup, double &v1xcdw, double &v2xcup, double &v2xcdw, double &v2xcud);
+
 
 //-------------------
 //  xc_functional_libxc_wrapper_tauxc.cpp
@@ -176,6 +196,20 @@ namespace XC_Functional_Libxc
         double tauup, double taudw,
         double &sxc, double &v1xcup, double &v1xcdw, double &v2xcup, double &v2xcdw, double &v2xcud,
         double &v3xcup, double &v3xcdw);
+
+    // the same as above, with the functionals initialized by the caller
+    extern void tau_xc(
+        const std::vector<xc_func_type> &funcs,
+        const double &rho, const double &grho, const double &atau, double &sxc,
+        double &v1xc, double &v2xc, double &v3xc);
+
+    extern void tau_xc_spin(
+        const std::vector<xc_func_type> &funcs,
+        double rhoup, double rhodw,
+        ModuleBase::Vector3<double> gdr1, ModuleBase::Vector3<double> gdr2,
+        double tauup, double taudw,
+        double &sxc, double &v1xcup, double &v1xcdw, double &v2xcup, double &v2xcdw, double &v2xcud,
+        double &v3xcup, double &v3xcdw);
 } // namespace XC_Functional_Libxc
 
 #endif // USE_LIBXC
@@ -11,7 +11,11 @@
 
 #include <xc.h>
 
+#include <algorithm>
 #include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 std::tuple<double,double,ModuleBase::matrix> XC_Functional_Libxc::v_xc_libxc(		// Peize Lin update for nspin==4 at 2023.01.14
         const std::vector<int> &func_id,
@@ -35,11 +39,15 @@ std::tuple<double,double,ModuleBase::matrix> XC_Functional_Libxc::v_xc_libxc(		/
     // https://www.tddft.org/programs/libxc/manual/libxc-5.1.x/
     //----------------------------------------------------------
 
-    std::vector<xc_func_type> funcs = XC_Functional_Libxc::init_func( func_id, (1==nspin) ? XC_UNPOLARIZED:XC_POLARIZED );
+    // libxc runs on the calling thread only, so each thread calls libxc on its blocks of the grid
+    // with its own copy of the functionals
+    std::vector<std::vector<xc_func_type>> funcs_threads
+        = XC_Functional_Libxc::init_func_threads( func_id, (1==nspin) ? XC_UNPOLARIZED:XC_POLARIZED );
+    const std::vector<xc_func_type> &funcs = funcs_threads[0];
 
     const bool is_gga = [&funcs]()
     {
-        for( xc_func_type &func : funcs )
+        for( const xc_func_type &func : funcs )
         {
             switch( func.info->family )
             {
@@ -51,6 +59,41 @@ std::tuple<double,double,ModuleBase::matrix> XC_Functional_Libxc::v_xc_libxc(		/
         return false;
     }();
 
+    // jiyy add for threshold
+    constexpr double rho_threshold = 1E-6;
+    constexpr double grho_threshold = 1E-10;
+
+    std::vector<double> factors(funcs.size(), 1.0);
+    for( std::size_t ifunc=0; ifunc<funcs.size(); ++ifunc )
+    {
+        const xc_func_type &func = funcs[ifunc];
+        switch( func.info->family )
+        {
+            case XC_FAMILY_LDA:
+            case XC_FAMILY_GGA:
+            case XC_FAMILY_HYB_GGA:
+                break;
+            default:
+                throw std::domain_error("func.info->family ="+std::to_string(func.info->family)
+                    +" unfinished in "+std::string(__FILE__)+" line "+std::to_string(__LINE__));
+                break;
+        }
+
+        // added by jghan, 2024-10-10
+        if( scaling_factor != nullptr )
+        {
+            auto pair_factor = scaling_factor->find(func.info->number);
+            if( pair_factor != scaling_factor->end() ) { factors[ifunc] = pair_factor->second; }
+        }
+    }
+    for( std::vector<xc_func_type> &funcs_thread : funcs_threads )
+    {
+        for( xc_func_type &func : funcs_thread )
+        {
+            xc_func_set_dens_threshold(&func, rho_threshold);
+        }
+    }
+
     // converting rho
     std::vector<double> rho;
     std::vector<double> amag;
@@ -65,71 +108,151 @@ std::tuple<double,double,ModuleBase::matrix> XC_Functional_Libxc::v_xc_libxc(		/
         amag = std::get<1>(std::move(rho_amag));
     }
 
+    // the gradient needs the FFT of the whole grid, the rest is done block by block
     std::vector<std::vector<ModuleBase::Vector3<double>>> gdr;
-    std::vector<double> sigma;
+    std::vector<std::vector<ModuleBase::Vector3<double>>> h;
     if(is_gga)
     {
         gdr = XC_Functional_Libxc::cal_gdr(nspin, nrxx, rho, tpiba, chr);
-        sigma = XC_Functional_Libxc::convert_sigma(gdr);
+        h.assign(nspin, std::vector<ModuleBase::Vector3<double>>(nrxx));
     }
 
     double etxc = 0.0;
     double vtxc = 0.0;
     ModuleBase::matrix v(nspin,nrxx);
 
-    for( xc_func_type &func : funcs )
+    const int nsigma = (1==nspin) ? 1 : 3;
+    const int nblock = (nrxx + block_size - 1) / block_size;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:etxc,vtxc)
+#endif
     {
-        // jiyy add for threshold
-        constexpr double rho_threshold = 1E-6;
-        constexpr double grho_threshold = 1E-10;
+#ifdef _OPENMP
+        const std::vector<xc_func_type> &funcs_thread = funcs_threads[omp_get_thread_num()];
+#else
+        const std::vector<xc_func_type> &funcs_thread = funcs_threads[0];
+#endif
+        std::vector<double> sigma ( block_size * nsigma );
+        std::vector<double> sgn   ( block_size * nspin  );
+        std::vector<double> exc   ( block_size          );
+        std::vector<double> vrho  ( block_size * nspin  );
+        std::vector<double> vsigma( block_size * nsigma );
 
-        xc_func_set_dens_threshold(&func, rho_threshold);
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for( int ib=0; ib<nblock; ++ib )
+        {
+            const int ir0 = ib * block_size;
+            const int nr = std::min(block_size, nrxx - ir0);
+            const double* const rho_block = rho.data() + ir0 * nspin;
 
-        // sgn for threshold mask
-        const std::vector<double> sgn = XC_Functional_Libxc::cal_sgn(rho_threshold, grho_threshold, func, nspin, nrxx, rho, sigma);
+            if(is_gga)
+            {
+                for( int i=0; i<nr; ++i )
+                {
+                    const int ir = ir0 + i;
+                    if( 1==nspin )
+                    {
+                        sigma[i] = gdr[0][ir]*gdr[0][ir];
+                    }
+                    else
+                    {
+                        sigma[i*3]   = gdr[0][ir]*gdr[0][ir];
+                        sigma[i*3+1] = gdr[0][ir]*gdr[1][ir];
+                        sigma[i*3+2] = gdr[1][ir]*gdr[1][ir];
+                    }
+                }
+            }
 
-        std::vector<double> exc   ( nrxx                    );
-        std::vector<double> vrho  ( nrxx * nspin            );
-        std::vector<double> vsigma( nrxx * ((1==nspin)?1:3) );
-        switch( func.info->family )
-        {
-            case XC_FAMILY_LDA:
-                // call Libxc function: xc_lda_exc_vxc
-                xc_lda_exc_vxc( &func, nrxx, rho.data(),
-                    exc.data(), vrho.data() );
-                break;
-            case XC_FAMILY_GGA:
-            case XC_FAMILY_HYB_GGA:
-                // call Libxc function: xc_gga_exc_vxc
-                xc_gga_exc_vxc( &func, nrxx, rho.data(), sigma.data(),
-                    exc.data(), vrho.data(), vsigma.data() );
-                break;
-            default:
-                throw std::domain_error("func.info->family ="+std::to_string(func.info->family)
-                    +" unfinished in "+std::string(__FILE__)+" line "+std::to_string(__LINE__));
-                break;
-        }
+            for( std::size_t ifunc=0; ifunc<funcs_thread.size(); ++ifunc )
+            {
+                const xc_func_type &func = funcs_thread[ifunc];
+                const double factor = factors[ifunc];
+                const bool func_is_gga = (func.info->family != XC_FAMILY_LDA);
 
-        // added by jghan, 2024-10-10
-        double factor = 1.0;
-        if( scaling_factor == nullptr ) { ;
-        } else
+                // sgn for threshold mask, the same as cal_sgn()
+                std::fill(sgn.begin(), sgn.begin() + nr * nspin, 1.0);
+                if(nspin==2 && func_is_gga && func.info->kind==XC_CORRELATION)
+                {
+                    for( int i=0; i<nr; ++i )
+                    {
+                        if ( rho_block[i*2]<rho_threshold || std::sqrt(std::abs(sigma[i*3]))<grho_threshold )
+                            sgn[i*2] = 0.0;
+                        if ( rho_block[i*2+1]<rho_threshold || std::sqrt(std::abs(sigma[i*3+2]))<grho_threshold )
+                            sgn[i*2+1] = 0.0;
+                    }
+                }
+
+                if(func_is_gga)
+                {
+                    // call Libxc function: xc_gga_exc_vxc
+                    xc_gga_exc_vxc( &func, nr, rho_block, sigma.data(),
+                        exc.data(), vrho.data(), vsigma.data() );
+                }
+                else
+                {
+                    // call Libxc function: xc_lda_exc_vxc
+                    xc_lda_exc_vxc( &func, nr, rho_block,
+                        exc.data(), vrho.data() );
+                }
+
+                // the same as convert_etxc() and convert_vtxc_v(), time factor is added by jghan, 2024-10-10
+                for( int i=0; i<nr; ++i )
+                {
+                    for( int is=0; is<nspin; ++is )
+                    {
+                        etxc += ModuleBase::e2 * exc[i] * rho_block[i*nspin+is] * sgn[i*nspin+is] * factor;
+                        const double v_tmp = ModuleBase::e2 * vrho[i*nspin+is] * sgn[i*nspin+is] * factor;
+                        v(is,ir0+i) += v_tmp;
+                        vtxc += v_tmp * rho_block[i*nspin+is];
+                    }
+                }
+
+                // h of cal_dh(), summed up over the functionals
+                if(func_is_gga)
+                {
+                    for( int i=0; i<nr; ++i )
+                    {
+                        const int ir = ir0 + i;
+                        if( 1==nspin )
+                        {
+                            h[0][ir] += 2.0 * gdr[0][ir] * vsigma[i] * 2.0 * sgn[i] * factor;
+                        }
+                        else
+                        {
+                            h[0][ir] += 2.0 * (gdr[0][ir] * vsigma[i*3  ] * sgn[i*2  ] * 2.0
+                                             + gdr[1][ir] * vsigma[i*3+1] * sgn[i*2]   * sgn[i*2+1]) * factor;
+                            h[1][ir] += 2.0 * (gdr[1][ir] * vsigma[i*3+2] * sgn[i*2+1] * 2.0
+                                             + gdr[0][ir] * vsigma[i*3+1] * sgn[i*2]   * sgn[i*2+1]) * factor;
+                        }
+                    }
+                }
+            } // end for( funcs_thread )
+        } // end for( ib )
+    }
+
+    XC_Functional_Libxc::finish_func_threads(funcs_threads);
+
+    // the divergence is linear in h, so it is taken once for all the functionals
+    if(is_gga)
+    {
+        std::vector<double> dh(nrxx);
+        double rvtxc = 0.0;
+        for( int is=0; is<nspin; ++is )
         {
-            auto pair_factor = scaling_factor->find(func.info->number);
-            if( pair_factor != scaling_factor->end() ) { factor = pair_factor->second;
-}
+            XC_Functional::grad_dot( h[is].data(), dh.data(), chr->rhopw, tpiba);
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:rvtxc) schedule(static, 1024)
+#endif
+            for( int ir=0; ir<nrxx; ++ir )
+            {
+                rvtxc += dh[ir] * rho[ir*nspin+is];
+                v(is,ir) -= dh[ir];
+            }
         }
-
-        // time factor is added by jghan, 2024-10-10
-        etxc += XC_Functional_Libxc::convert_etxc(nspin, nrxx, sgn, rho, exc) * factor;
-        const std::pair<double,ModuleBase::matrix> vtxc_v = XC_Functional_Libxc::convert_vtxc_v(
-            func, nspin, nrxx,
-            sgn, rho, gdr,
-            vrho, vsigma,
-            tpiba, chr);
-        vtxc += std::get<0>(vtxc_v) * factor;
-        v += std::get<1>(vtxc_v) * factor;
-    } // end for( xc_func_type &func : funcs )
+        vtxc -= rvtxc;
+    }
 
     if(4==PARAM.inp.nspin)
     {
@@ -147,8 +270,6 @@ std::tuple<double,double,ModuleBase::matrix> XC_Functional_Libxc::v_xc_libxc(		/
     etxc *= omega / chr->rhopw->nxyz;
     vtxc *= omega / chr->rhopw->nxyz;
 
-    XC_Functional_Libxc::finish_func(funcs);
-
     ModuleBase::timer::tick("XC_Functional_Libxc","v_xc_libxc");
     return std::make_tuple( etxc, vtxc, std::move(v) );
 }
@@ -176,8 +297,6 @@ std::tuple<double,double,ModuleBase::matrix,ModuleBase::matrix> XC_Functional_Li
     ModuleBase::TITLE("XC_Functional_Libxc","v_xc_meta");
     ModuleBase::timer::tick("XC_Functional_Libxc","v_xc_meta");
 
-    double e2 = 2.0;
-
     //output of the subroutine
     double etxc = 0.0;
     double vtxc = 0.0;
@@ -191,203 +310,152 @@ std::tuple<double,double,ModuleBase::matrix,ModuleBase::matrix> XC_Functional_Li
     // https://www.tddft.org/programs/libxc/manual/libxc-5.1.x/
     //----------------------------------------------------------
 
+    // one copy of the functionals for each thread, as in v_xc_libxc()
     const int nspin = PARAM.inp.nspin;
-    std::vector<xc_func_type> funcs = XC_Functional_Libxc::init_func( func_id, ( (1==nspin) ? XC_UNPOLARIZED:XC_POLARIZED ) );
+    std::vector<std::vector<xc_func_type>> funcs_threads
+        = XC_Functional_Libxc::init_func_threads( func_id, ( (1==nspin) ? XC_UNPOLARIZED:XC_POLARIZED ) );
 
-    const std::vector<double> rho = XC_Functional_Libxc::convert_rho(nspin, nrxx, chr);
-    const std::vector<std::vector<ModuleBase::Vector3<double>>> gdr
-        = XC_Functional_Libxc::cal_gdr(nspin, nrxx, rho, tpiba, chr);
-    const std::vector<double> sigma = XC_Functional_Libxc::convert_sigma(gdr);
-
-    //converting kin_r
-    std::vector<double> kin_r;
-    kin_r.resize(nrxx*nspin);
-#ifdef _OPENMP
-#pragma omp parallel for collapse(2) schedule(static, 1024)
-#endif
-    for( int is=0; is<nspin; ++is )
+    // the scaling of SCAN exchange in SCAN0, applied once to exc, vrho, vsigma and vtau
+    std::vector<double> factors(funcs_threads[0].size(), 1.0);
+    for( std::size_t ifunc=0; ifunc<factors.size(); ++ifunc )
     {
-        for( int ir=0; ir<nrxx; ++ir )
+        assert(funcs_threads[0][ifunc].info->family == XC_FAMILY_MGGA);
+#ifdef __EXX
+        if (funcs_threads[0][ifunc].info->number == XC_MGGA_X_SCAN && XC_Functional::get_func_type() == 5)
         {
-            kin_r[ir*nspin+is] = chr->kin_r[is][ir] / 2.0;
+            factors[ifunc] = 1.0 - XC_Functional::get_hybrid_alpha();
         }
+#endif
     }
 
-    std::vector<double> exc    ( nrxx                    );
-    std::vector<double> vrho   ( nrxx * nspin            );
-    std::vector<double> vsigma ( nrxx * ((1==nspin)?1:3) );
-    std::vector<double> vtau   ( nrxx * nspin            );
-    std::vector<double> vlapl  ( nrxx * nspin            );
+    // the gradient needs the FFT of the whole grid, the rest is done block by block
+    const std::vector<double> rho = XC_Functional_Libxc::convert_rho(nspin, nrxx, chr);
+    const std::vector<std::vector<ModuleBase::Vector3<double>>> gdr
+        = XC_Functional_Libxc::cal_gdr(nspin, nrxx, rho, tpiba, chr);
 
     constexpr double rho_th  = 1e-8;
     constexpr double grho_th = 1e-12;
     constexpr double tau_th  = 1e-8;
-    // sgn for threshold mask
-    std::vector<double> sgn( nrxx * nspin);
-#ifdef _OPENMP
-#pragma omp parallel for schedule(static, 1024)
-#endif
-    for(int i = 0; i < nrxx * nspin; ++i)
-    {
-        sgn[i] = 1.0;
-    }
 
-    if(nspin == 1)
-    {
+    // h summed up over the functionals
+    std::vector<std::vector<ModuleBase::Vector3<double>>> h(
+        nspin,
+        std::vector<ModuleBase::Vector3<double>>(nrxx) );
+
+    const int nsigma = (1==nspin) ? 1 : 3;
+    const int nblock = (nrxx + block_size - 1) / block_size;
 #ifdef _OPENMP
-#pragma omp parallel for schedule(static, 1024)
+#pragma omp parallel reduction(+:etxc,vtxc)
 #endif
-        for( int ir=0; ir<nrxx; ++ir )
-        {
-            if ( rho[ir]<rho_th || sqrt(std::abs(sigma[ir]))<grho_th || std::abs(kin_r[ir])<tau_th)
-            {
-                sgn[ir] = 0.0;
-            }
-        }
-    }
-    else
     {
 #ifdef _OPENMP
-#pragma omp parallel for schedule(static, 512)
+        const std::vector<xc_func_type> &funcs_thread = funcs_threads[omp_get_thread_num()];
+#else
+        const std::vector<xc_func_type> &funcs_thread = funcs_threads[0];
 #endif
-        for( int ir=0; ir<nrxx; ++ir )
-        {
-            if ( rho[ir*2]<rho_th || sqrt(std::abs(sigma[ir*3]))<grho_th || std::abs(kin_r[ir*2])<tau_th) {
-                sgn[ir*2] = 0.0;
-}
-            if ( rho[ir*2+1]<rho_th || sqrt(std::abs(sigma[ir*3+2]))<grho_th || std::abs(kin_r[ir*2+1])<tau_th) {
-                sgn[ir*2+1] = 0.0;
-}
-        }
-    }
+        std::vector<double> sigma  ( block_size * nsigma );
+        std::vector<double> kin_r  ( block_size * nspin  );
+        std::vector<double> sgn    ( block_size * nspin  );
+        std::vector<double> exc    ( block_size          );
+        std::vector<double> vrho   ( block_size * nspin  );
+        std::vector<double> vsigma ( block_size * nsigma );
+        std::vector<double> vtau   ( block_size * nspin  );
+        std::vector<double> vlapl  ( block_size * nspin  );
 
-    for ( xc_func_type &func : funcs )
-    {
-        assert(func.info->family == XC_FAMILY_MGGA);
-        xc_mgga_exc_vxc(&func, nrxx, rho.data(), sigma.data(), sigma.data(),
-            kin_r.data(), exc.data(), vrho.data(), vsigma.data(), vlapl.data(), vtau.data());
-
-        //process etxc
-        for( int is=0; is!=nspin; ++is )
-        {
 #ifdef _OPENMP
-#pragma omp parallel for reduction(+:etxc) schedule(static, 256)
+#pragma omp for schedule(static)
 #endif
-            for( int ir=0; ir< nrxx; ++ir )
+        for( int ib=0; ib<nblock; ++ib )
+        {
+            const int ir0 = ib * block_size;
+            const int nr = std::min(block_size, nrxx - ir0);
+            const double* const rho_block = rho.data() + ir0 * nspin;
+
+            //converting sigma and kin_r, and sgn for threshold mask
+            for( int i=0; i<nr; ++i )
             {
-#ifdef __EXX
-                if (func.info->number == XC_MGGA_X_SCAN && XC_Functional::get_func_type() == 5)
+                const int ir = ir0 + i;
+                for( int is=0; is<nspin; ++is )
                 {
-                    exc[ir] *= (1.0 - XC_Functional::get_hybrid_alpha());
+                    kin_r[i*nspin+is] = chr->kin_r[is][ir] / 2.0;
                 }
-#endif
-                etxc += ModuleBase::e2 * exc[ir] * rho[ir*nspin+is]  * sgn[ir*nspin+is];
-            }
-        }
-
-        //process vtxc
-#ifdef _OPENMP
-#pragma omp parallel for collapse(2) reduction(+:vtxc) schedule(static, 256)
-#endif
-        for( int is=0; is<nspin; ++is )
-        {
-            for( int ir=0; ir< nrxx; ++ir )
-            {
-#ifdef __EXX
-                if (func.info->number == XC_MGGA_X_SCAN && XC_Functional::get_func_type() == 5)
+                if( 1==nspin )
                 {
-                    vrho[ir*nspin+is] *= (1.0 - XC_Functional::get_hybrid_alpha());
+                    sigma[i] = gdr[0][ir]*gdr[0][ir];
+                    sgn[i] = ( rho_block[i]<rho_th || sqrt(std::abs(sigma[i]))<grho_th || std::abs(kin_r[i])<tau_th )
+                             ? 0.0 : 1.0;
                 }
-#endif
-                const double v_tmp = ModuleBase::e2 * vrho[ir*nspin+is]  * sgn[ir*nspin+is];
-                v(is,ir) += v_tmp;
-                vtxc += v_tmp * chr->rho[is][ir];
-            }
-        }
-
-        //process vsigma
-        std::vector<std::vector<ModuleBase::Vector3<double>>> h(
-            nspin,
-            std::vector<ModuleBase::Vector3<double>>(nrxx) );
-        if( 1==nspin )
-        {
-#ifdef _OPENMP
-#pragma omp parallel for schedule(static, 1024)
-#endif
-            for( int ir=0; ir< nrxx; ++ir )
-            {
-#ifdef __EXX
-                if (func.info->number == XC_MGGA_X_SCAN && XC_Functional::get_func_type() == 5)
+                else
                 {
-                    vsigma[ir] *= (1.0 - XC_Functional::get_hybrid_alpha());
+                    sigma[i*3]   = gdr[0][ir]*gdr[0][ir];
+                    sigma[i*3+1] = gdr[0][ir]*gdr[1][ir];
+                    sigma[i*3+2] = gdr[1][ir]*gdr[1][ir];
+                    sgn[i*2] = ( rho_block[i*2]<rho_th || sqrt(std::abs(sigma[i*3]))<grho_th || std::abs(kin_r[i*2])<tau_th )
+                               ? 0.0 : 1.0;
+                    sgn[i*2+1] = ( rho_block[i*2+1]<rho_th || sqrt(std::abs(sigma[i*3+2]))<grho_th || std::abs(kin_r[i*2+1])<tau_th )
+                                 ? 0.0 : 1.0;
                 }
-#endif
-                h[0][ir] = 2.0 * gdr[0][ir] * vsigma[ir] * 2.0 * sgn[ir];
             }
-        }
-        else
-        {
-#ifdef _OPENMP
-#pragma omp parallel for schedule(static, 64)
-#endif
-            for( int ir=0; ir< nrxx; ++ir )
+
+            for( std::size_t ifunc=0; ifunc<funcs_thread.size(); ++ifunc )
             {
-#ifdef __EXX
-                if (func.info->number == XC_MGGA_X_SCAN && XC_Functional::get_func_type() == 5)
+                const xc_func_type &func = funcs_thread[ifunc];
+                const double factor = factors[ifunc];
+                xc_mgga_exc_vxc(&func, nr, rho_block, sigma.data(), sigma.data(),
+                    kin_r.data(), exc.data(), vrho.data(), vsigma.data(), vlapl.data(), vtau.data());
+
+                for( int i=0; i<nr; ++i )
                 {
-                    vsigma[ir*3]   *= (1.0 - XC_Functional::get_hybrid_alpha());
-                    vsigma[ir*3+1] *= (1.0 - XC_Functional::get_hybrid_alpha());
-                    vsigma[ir*3+2] *= (1.0 - XC_Functional::get_hybrid_alpha());
+                    const int ir = ir0 + i;
+                    for( int is=0; is<nspin; ++is )
+                    {
+                        //process etxc
+                        etxc += ModuleBase::e2 * exc[i] * rho_block[i*nspin+is] * sgn[i*nspin+is] * factor;
+
+                        //process vtxc
+                        const double v_tmp = ModuleBase::e2 * vrho[i*nspin+is] * sgn[i*nspin+is] * factor;
+                        v(is,ir) += v_tmp;
+                        vtxc += v_tmp * chr->rho[is][ir];
+
+                        //process vtau
+                        vofk(is,ir) += vtau[i*nspin+is] * sgn[i*nspin+is] * factor;
+                    }
+
+                    //process vsigma
+                    if( 1==nspin )
+                    {
+                        h[0][ir] += 2.0 * gdr[0][ir] * vsigma[i] * 2.0 * sgn[i] * factor;
+                    }
+                    else
+                    {
+                        h[0][ir] += 2.0 * (gdr[0][ir] * vsigma[i*3  ] * sgn[i*2  ] * 2.0
+                                         + gdr[1][ir] * vsigma[i*3+1] * sgn[i*2]   * sgn[i*2+1]) * factor;
+                        h[1][ir] += 2.0 * (gdr[1][ir] * vsigma[i*3+2] * sgn[i*2+1] * 2.0
+                                         + gdr[0][ir] * vsigma[i*3+1] * sgn[i*2]   * sgn[i*2+1]) * factor;
+                    }
                 }
-#endif
-                h[0][ir] = 2.0 * (gdr[0][ir] * vsigma[ir*3  ] * sgn[ir*2  ] * 2.0
-                                + gdr[1][ir] * vsigma[ir*3+1] * sgn[ir*2]   * sgn[ir*2+1]);
-                h[1][ir] = 2.0 * (gdr[1][ir] * vsigma[ir*3+2] * sgn[ir*2+1] * 2.0
-                                + gdr[0][ir] * vsigma[ir*3+1] * sgn[ir*2]   * sgn[ir*2+1]);
-            }
-        }
-
-        // define two dimensional array dh [ nspin, nrxx ]
-        std::vector<std::vector<double>> dh(nspin, std::vector<double>( nrxx));
-        for( int is=0; is!=nspin; ++is )
-        {
-            XC_Functional::grad_dot( h[is].data(),
-                dh[is].data(), chr->rhopw,
-                tpiba);
-        }
+            } // end for( funcs_thread )
+        } // end for( ib )
+    }
 
-        double rvtxc = 0.0;
-#ifdef _OPENMP
-#pragma omp parallel for collapse(2) reduction(+:rvtxc) schedule(static, 256)
-#endif
-        for( int is=0; is<nspin; ++is )
-        {
-            for( int ir=0; ir< nrxx; ++ir )
-            {
-                rvtxc += dh[is][ir] * rho[ir*nspin+is];
-                v(is,ir) -= dh[is][ir];
-            }
-        }
-        vtxc -= rvtxc;
+    XC_Functional_Libxc::finish_func_threads(funcs_threads);
 
-        //process vtau
+    // the divergence is linear in h, so it is taken once for all the functionals
+    std::vector<double> dh(nrxx);
+    double rvtxc = 0.0;
+    for( int is=0; is<nspin; ++is )
+    {
+        XC_Functional::grad_dot( h[is].data(), dh.data(), chr->rhopw, tpiba);
 #ifdef _OPENMP
-#pragma omp parallel for collapse(2) schedule(static, 1024)
+#pragma omp parallel for reduction(+:rvtxc) schedule(static, 1024)
 #endif
-        for( int is=0; is<nspin; ++is )
+        for( int ir=0; ir<nrxx; ++ir )
         {
-            for( int ir=0; ir< nrxx; ++ir )
-            {
-#ifdef __EXX
-                if (func.info->number == XC_MGGA_X_SCAN && XC_Functional::get_func_type() == 5)
-                {
-                    vtau[ir*nspin+is] *= (1.0 - XC_Functional::get_hybrid_alpha());
-                }
-#endif
-                vofk(is,ir) += vtau[ir*nspin+is]  * sgn[ir*nspin+is];
-            }
+            rvtxc += dh[ir] * rho[ir*nspin+is];
+            v(is,ir) -= dh[ir];
         }
     }
+    vtxc -= rvtxc;
 
     //-------------------------------------------------
     // for MPI, reduce the exchange-correlation energy
@@ -400,8 +468,6 @@ std::tuple<double,double,ModuleBase::matrix,ModuleBase::matrix> XC_Functional_Li
     etxc *= omega / chr->rhopw->nxyz;
     vtxc *= omega / chr->rhopw->nxyz;
 
-    XC_Functional_Libxc::finish_func(funcs);
-
     ModuleBase::timer::tick("XC_Functional_Libxc","v_xc_meta");
     return std::make_tuple( etxc, vtxc, std::move(v), std::move(vofk) );
 }
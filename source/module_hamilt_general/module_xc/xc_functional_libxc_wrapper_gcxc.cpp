@@ -20,7 +20,25 @@ void XC_Functional_Libxc::gcxc_libxc(
     }
 
     std::vector<xc_func_type> funcs = XC_Functional_Libxc::init_func(func_id, XC_UNPOLARIZED);
-    for(xc_func_type &func : funcs)
+    XC_Functional_Libxc::gcxc_libxc(funcs, rho, grho, sxc, v1xc, v2xc);
+    XC_Functional_Libxc::finish_func(funcs);
+} // end subroutine gcxc_libxc
+
+void XC_Functional_Libxc::gcxc_libxc(
+    const std::vector<xc_func_type> &funcs,
+    const double &rho, const double &grho,
+    double &sxc, double &v1xc, double &v2xc)
+{
+    sxc = v1xc = v2xc = 0.0;
+
+    constexpr double small = 1.e-6;
+    constexpr double smallg = 1.e-10;
+    if (rho <= small || grho < smallg)
+    {
+        return;
+    }
+
+    for(const xc_func_type &func : funcs)
     {
         double s,v1,v2;
         xc_gga_exc_vxc(&func, 1, &rho, &grho, &s, &v1, &v2);
@@ -28,8 +46,7 @@ void XC_Functional_Libxc::gcxc_libxc(
         v1xc += v1;
         v2xc += v2 * 2.0;
     }
-    XC_Functional_Libxc::finish_func(funcs);
-} // end subroutine gcxc_libxc
+}
 
 
 
@@ -38,14 +55,24 @@ void XC_Functional_Libxc::gcxc_spin_libxc(
         const double rhoup, const double rhodw,
         const ModuleBase::Vector3<double> gdr1, const ModuleBase::Vector3<double> gdr2,
         double &sxc, double &v1xcup, double &v1xcdw, double &v2xcup, double &v2xcdw, double &v2xcud)
+{
+    std::vector<xc_func_type> funcs = XC_Functional_Libxc::init_func(func_id, XC_POLARIZED);
+    XC_Functional_Libxc::gcxc_spin_libxc(funcs, rhoup, rhodw, gdr1, gdr2, sxc, v1xcup, v1xcdw, v2xcup, v2xcdw, v2xcud);
+    XC_Functional_Libxc::finish_func(funcs);
+}
+
+void XC_Functional_Libxc::gcxc_spin_libxc(
+        const std::vector<xc_func_type> &funcs,
+        const double rhoup, const double rhodw,
+        const ModuleBase::Vector3<double> gdr1, const ModuleBase::Vector3<double> gdr2,
+        double &sxc, double &v1xcup, double &v1xcdw, double &v2xcup, double &v2xcdw, double &v2xcud)
 {
     sxc = v1xcup = v1xcdw = 0.0;
     v2xcup = v2xcdw = v2xcud = 0.0;
     const std::array<double,2> rho = {rhoup, rhodw};
     const std::array<double,3> grho = {gdr1.norm2(), gdr1*gdr2, gdr2.norm2()};
 
-    std::vector<xc_func_type> funcs = XC_Functional_Libxc::init_func(func_id, XC_POLARIZED);
-    for(xc_func_type &func : funcs)
+    for(const xc_func_type &func : funcs)
     {
         if( func.info->family == XC_FAMILY_GGA || func.info->family == XC_FAMILY_HYB_GGA)
         {
@@ -73,7 +100,6 @@ void XC_Functional_Libxc::gcxc_spin_libxc(
             v2xcdw += 2.0 * v2xc[2] * sgn[1];
         }
     }
-    XC_Functional_Libxc::finish_func(funcs);
 }
 
 #endif
\ No newline at end of file
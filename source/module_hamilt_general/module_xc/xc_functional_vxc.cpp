@@ -9,6 +9,9 @@
 #include "module_base/timer.h"
 #include "module_parameter/parameter.h"
 
+#include <algorithm>
+#include <vector>
+
 #ifdef USE_LIBXC
 #include "xc_functional_libxc.h"
 #endif
@@ -44,29 +47,43 @@ std::tuple<double,double,ModuleBase::matrix> XC_Functional::v_xc(
 
     if (PARAM.inp.nspin == 1 || ( PARAM.inp.nspin ==4 && !PARAM.globalv.domag && !PARAM.globalv.domag_z))
     {
-        // spin-unpolarized case
+        // spin-unpolarized case, the functional is evaluated on blocks of points
+        constexpr int block_size = 1024;
 #ifdef _OPENMP
-#pragma omp parallel for reduction(+:etxc) reduction(+:vtxc)
+#pragma omp parallel reduction(+:etxc) reduction(+:vtxc)
 #endif
-        for (int ir = 0;ir < nrxx;ir++)
         {
-            // total electron charge density
-            double rhox = chr->rho[0][ir] + chr->rho_core[ir];
-            if(PARAM.inp.use_paw && rhox < 1e-14) { rhox = 1e-14;
-}
-            double arhox = std::abs(rhox);
-            if (arhox > vanishing_charge)
+            std::vector<double> rhox(block_size), arhox(block_size), exc(block_size), vxc(block_size);
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (int ir0 = 0; ir0 < nrxx; ir0 += block_size)
             {
-                double exc = 0.0;
-                double vxc = 0.0;
-                XC_Functional::xc(arhox, exc, vxc);
-                v(0,ir) = e2 * vxc;
-                // consider the total charge density
-                etxc += e2 * exc * rhox;
-                // only consider chr->rho
-                vtxc += v(0, ir) * chr->rho[0][ir];
-            } // endif
-        } //enddo
+                const int nb = std::min(block_size, nrxx - ir0);
+                for (int i = 0; i < nb; i++)
+                {
+                    // total electron charge density
+                    rhox[i] = chr->rho[0][ir0 + i] + chr->rho_core[ir0 + i];
+                    if(PARAM.inp.use_paw && rhox[i] < 1e-14) { rhox[i] = 1e-14;
+}
+                    // the vanishing points are given a harmless density and skipped below
+                    arhox[i] = std::abs(rhox[i]) > vanishing_charge ? std::abs(rhox[i]) : 1.0;
+                }
+                XC_Functional::xc(nb, arhox.data(), exc.data(), vxc.data());
+                for (int i = 0; i < nb; i++)
+                {
+                    const int ir = ir0 + i;
+                    if (std::abs(rhox[i]) > vanishing_charge)
+                    {
+                        v(0,ir) = e2 * vxc[i];
+                        // consider the total charge density
+                        etxc += e2 * exc[i] * rhox[i];
+                        // only consider chr->rho
+                        vtxc += v(0, ir) * chr->rho[0][ir];
+                    } // endif
+                }
+            } //enddo
+        }
     }
     else if(PARAM.inp.nspin ==2)
     {
@@ -104,6 +104,93 @@ void XC_Functional::gcxc(const double &rho, const double &grho, double &sxc,
     return;
 }
 
+void XC_Functional::gcxc(const int n, const double* rho, const double* grho,
+          double* sxc, double* v1xc, double* v2xc, int* index, double* work)
+{
+    // the same as above on n points, the functional is chosen once for all the points
+    // and the array kernels run on the m points with large enough rho and grho,
+    // which are packed together first
+    const double small = 1.e-6;
+    const double smallg = 1.e-10;
+    double* r = work;
+    double* g = work + n;
+    double* s = work + 2 * n;
+    double* v1 = work + 3 * n;
+    double* v2 = work + 4 * n;
+    int m = 0;
+    for(int i = 0; i < n; ++i)
+    {
+        sxc[i] = v1xc[i] = v2xc[i] = 0.0;
+        if (rho[i] > small && grho[i] >= smallg)
+        {
+            index[m] = i;
+            r[m] = rho[i];
+            g[m] = grho[i];
+            ++m;
+        }
+    }
+
+    // add the results of the packed points, times factor
+    auto add = [&](const double factor)
+    {
+        for(int i = 0; i < m; ++i)
+        {
+            sxc[index[i]] += factor * s[i];
+            v1xc[index[i]] += factor * v1[i];
+            v2xc[index[i]] += factor * v2[i];
+        }
+    };
+
+    for(int id : func_id)
+    {
+        switch( id )
+        {
+            case XC_GGA_X_B88: //B88
+                XC_Functional::becke88(m, r, g, s, v1, v2);break;
+            case XC_GGA_X_PW91: //PW91_X
+                for(int i = 0; i < m; ++i) { XC_Functional::ggax(r[i], g[i], s[i], v1[i], v2[i]); }
+                break;
+            case XC_GGA_X_PBE: //PBX
+                XC_Functional::pbex(m, r, g, 0, s, v1, v2);break;
+            case XC_GGA_X_PBE_R: //revised PBX
+                XC_Functional::pbex(m, r, g, 1, s, v1, v2);break;
+            case XC_GGA_X_HCTH_A: //HCTH_X
+                XC_Functional::hcth(m, r, g, s, v1, v2);break;
+            case XC_GGA_C_HCTH_A: //HCTH_C
+                continue;
+            case XC_GGA_X_OPTX: //OPTX
+                for(int i = 0; i < m; ++i) { XC_Functional::optx(r[i], g[i], s[i], v1[i], v2[i]); }
+                break;
+            case XC_GGA_X_PBE_SOL: //PBXsol
+                XC_Functional::pbex(m, r, g, 2, s, v1, v2);break;
+            case XC_GGA_X_WC: //Wu-Cohen
+                for(int i = 0; i < m; ++i) { XC_Functional::wcx(r[i], g[i], s[i], v1[i], v2[i]); }
+                break;
+            case XC_GGA_C_P86: //P86
+                XC_Functional::perdew86(m, r, g, s, v1, v2);break;
+            case XC_GGA_C_PW91: //PW91_C
+                for(int i = 0; i < m; ++i) { XC_Functional::ggac(r[i], g[i], s[i], v1[i], v2[i]); }
+                break;
+            case XC_GGA_C_PBE: //PBC
+                XC_Functional::pbec(m, r, g, 0, s, v1, v2);break;
+            case XC_GGA_C_PBE_SOL: //PBCsol
+                XC_Functional::pbec(m, r, g, 1, s, v1, v2);break;
+            case XC_GGA_C_LYP: //BLYP
+                for(int i = 0; i < m; ++i) { XC_Functional::glyp(r[i], g[i], s[i], v1[i], v2[i]); }
+                break;
+            case XC_HYB_GGA_XC_PBEH: //PBE0
+                XC_Functional::pbex(m, r, g, 0, s, v1, v2);
+                add(1.0 - XC_Functional::hybrid_alpha);
+                XC_Functional::pbec(m, r, g, 0, s, v1, v2);
+                break;
+            default: //SCAN_X,SCAN_C,HSE, and so on
+                throw std::domain_error("functional unfinished in "+ModuleBase::GlobalFunc::TO_STRING(__FILE__)+" line "+ModuleBase::GlobalFunc::TO_STRING(__LINE__));
+        }
+        add(1.0);
+    }
+    return;
+}
+
 //-----------------------------------------------------------------------
 void XC_Functional::gcx_spin(double rhoup, double rhodw, double grhoup2, double grhodw2,
               double &sx, double &v1xup, double &v1xdw, double &v2xup, double &v2xdw)
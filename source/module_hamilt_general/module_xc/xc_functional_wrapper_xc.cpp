@@ -10,7 +10,9 @@
 #endif	// ifdef USE_LIBXC
 
 #include "xc_functional.h"
+#include <algorithm>
 #include <stdexcept>
+#include <vector>
 
 void XC_Functional::xc(const double &rho, double &exc, double &vxc)
 {
@@ -70,6 +72,66 @@ void XC_Functional::xc(const double &rho, double &exc, double &vxc)
 	return;
 }
 
+void XC_Functional::xc(const int n, const double* rho, double* exc, double* vxc)
+{
+	const double third = 1.0 / 3.0;
+	const double pi34 = 0.6203504908994e0 ; // pi34=(3/4pi)^(1/3)
+	std::vector<double> rs(n), e(n), v(n);
+
+	for(int i = 0; i < n; ++i)
+	{
+		rs[i] = pi34 / std::pow(rho[i], third);
+		exc[i] = vxc[i] = 0.0;
+	}
+
+    // the functional is chosen once for all the points, and the kernels run on the arrays
+    for(int id : func_id)
+    {
+        switch( id )
+        {
+            case XC_LDA_X: case XC_GGA_X_PBE: case XC_GGA_X_PBE_R: case XC_GGA_X_PBE_SOL:
+            case XC_GGA_X_WC: case XC_GGA_X_B88: case XC_GGA_X_PW91:
+                XC_Functional::slater(n, rs.data(), e.data(), v.data());break;
+
+            case XC_HYB_GGA_XC_PBEH:
+            {
+                std::vector<double> ec(n), vc(n);
+                XC_Functional::slater(n, rs.data(), e.data(), v.data());
+                XC_Functional::pw(n, rs.data(), 0, ec.data(), vc.data());
+                for(int i = 0; i < n; ++i)
+                {
+                    e[i] = e[i] * (1 - XC_Functional::hybrid_alpha) + ec[i];
+                    v[i] = v[i] * (1 - XC_Functional::hybrid_alpha) + vc[i];
+                }
+                break;
+            }
+
+            case XC_GGA_C_PBE: case XC_GGA_C_PW91: case XC_LDA_C_PW: case XC_GGA_C_PBE_SOL:
+                XC_Functional::pw(n, rs.data(), 0, e.data(), v.data());break;
+
+            case XC_LDA_C_PZ: case XC_GGA_C_P86:
+                XC_Functional::pz(n, rs.data(), 0, e.data(), v.data());break;
+
+            case XC_GGA_C_LYP:
+                for(int i = 0; i < n; ++i)
+                {
+                    XC_Functional::lyp(rs[i], e[i], v[i]);
+                }
+                break;
+
+            default:
+                std::fill(e.begin(), e.end(), 0.0);
+                std::fill(v.begin(), v.end(), 0.0);
+        }
+        for(int i = 0; i < n; ++i)
+        {
+            exc[i] += e[i];
+            vxc[i] += v[i];
+        }
+    }
+	return;
+}
+
 void XC_Functional::xc_spin(const double &rho, const double &zeta,
 		double &exc, double &vxcup, double &vxcdw)
 {
@@ -2,8 +2,10 @@
 #define LCAO_HS_ARRAYS_H
 
 #include "module_base/abfs-vector3_order.h"
+#include "module_hamilt_lcao/module_hcontainer/sparse_csr.h"
 
 #include <complex>
+#include <set>
 #include <vector>
 
 class LCAO_HS_Arrays {
@@ -22,45 +24,25 @@ class LCAO_HS_Arrays {
     //------------------------------
     std::vector<double> Hloc_fixedR;
 
+    // sparse matrices O(R) in global orbital indexes, stored as one CSR block
+    // for each R, see hamilt::SparseCSR.
     // For HR_sparse[2], when nspin=1, only 0 is valid, when nspin=2, 0 means
     // spin up, 1 means spin down
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, double>>>
-        HR_sparse[2];
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, double>>>
-        SR_sparse;
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, double>>>
-        TR_sparse;
+    hamilt::SparseCSR_R<double> HR_sparse[2];
+    hamilt::SparseCSR_R<double> SR_sparse;
+    hamilt::SparseCSR_R<double> TR_sparse;
 
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, double>>>
-        dHRx_sparse[2];
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, double>>>
-        dHRy_sparse[2];
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, double>>>
-        dHRz_sparse[2];
+    hamilt::SparseCSR_R<double> dHRx_sparse[2];
+    hamilt::SparseCSR_R<double> dHRy_sparse[2];
+    hamilt::SparseCSR_R<double> dHRz_sparse[2];
 
     // For nspin = 4
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, std::complex<double>>>>
-        HR_soc_sparse;
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, std::complex<double>>>>
-        SR_soc_sparse;
+    hamilt::SparseCSR_R<std::complex<double>> HR_soc_sparse;
+    hamilt::SparseCSR_R<std::complex<double>> SR_soc_sparse;
 
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, std::complex<double>>>>
-        dHRx_soc_sparse;
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, std::complex<double>>>>
-        dHRy_soc_sparse;
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, std::complex<double>>>>
-        dHRz_soc_sparse;
+    hamilt::SparseCSR_R<std::complex<double>> dHRx_soc_sparse;
+    hamilt::SparseCSR_R<std::complex<double>> dHRy_soc_sparse;
+    hamilt::SparseCSR_R<std::complex<double>> dHRz_soc_sparse;
 
     // Records the R direct coordinates of HR and SR output, This variable will
     // be filled with data when HR and SR files are output.
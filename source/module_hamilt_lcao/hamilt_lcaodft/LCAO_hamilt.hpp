@@ -106,32 +106,19 @@ void sparse_format::cal_HR_exx(const UnitCell& ucell,
                         {
                             if (PARAM.inp.nspin == 1 || PARAM.inp.nspin == 2) 
                             {
-                                auto& HR_sparse_ptr
-                                    = HS_Arrays
-                                          .HR_sparse[current_spin][R][iwt0];
-                                double& HR_sparse = HR_sparse_ptr[iwt1];
-                                HR_sparse += RI::Global_Func::convert<double>(
-                                    frac * Hexx(iw0, iw1));
-                                if (std::abs(HR_sparse) <= sparse_threshold) 
-                                {
-                                    HR_sparse_ptr.erase(iwt1);
-                                }
+                                HS_Arrays.HR_sparse[current_spin][R].add(
+                                    iwt0,
+                                    iwt1,
+                                    RI::Global_Func::convert<double>(
+                                        frac * Hexx(iw0, iw1)));
                             } 
                             else if (PARAM.inp.nspin == 4) 
                             {
-                                auto& HR_sparse_ptr
-                                    = HS_Arrays.HR_soc_sparse[R][iwt0];
-                                
-                                std::complex<double>& HR_sparse
-                                    = HR_sparse_ptr[iwt1];
-                                
-                                HR_sparse += RI::Global_Func::convert<
-                                    std::complex<double>>(frac * Hexx(iw0, iw1));
-                                
-                                if (std::abs(HR_sparse) <= sparse_threshold) 
-                                {
-                                    HR_sparse_ptr.erase(iwt1);
-                                }
+                                HS_Arrays.HR_soc_sparse[R].add(
+                                    iwt0,
+                                    iwt1,
+                                    RI::Global_Func::convert<
+                                        std::complex<double>>(frac * Hexx(iw0, iw1)));
                             } 
                             else 
                             {
@@ -145,6 +132,15 @@ void sparse_format::cal_HR_exx(const UnitCell& ucell,
         }
     }
 
+    if (PARAM.inp.nspin == 1 || PARAM.inp.nspin == 2)
+    {
+        hamilt::finalize_sparse_R(HS_Arrays.HR_sparse[current_spin], sparse_threshold);
+    }
+    else
+    {
+        hamilt::finalize_sparse_R(HS_Arrays.HR_soc_sparse, sparse_threshold);
+    }
+
     ModuleBase::timer::tick("sparse_format", "cal_HR_exx");
 }
 #endif
@@ -61,6 +61,15 @@ void init_basis_lcao(Parallel_Orbitals& pv,
         two_center_bundle.build_beta(ucell.ntype, ucell.infoNL.Beta);
     }
 
+    if (PARAM.inp.lcao_table_cache_dir != "none")
+    {
+        ModuleBase::GlobalFunc::MAKE_DIR(PARAM.inp.lcao_table_cache_dir);
+#ifdef __MPI
+        MPI_Barrier(MPI_COMM_WORLD);
+#endif
+        two_center_bundle.set_table_cache(PARAM.inp.lcao_table_cache_dir);
+    }
+
     int Lmax = 0;
 #ifdef __EXX
     Lmax = GlobalC::exx_info.info_ri.abfs_Lmax;
@@ -489,6 +489,46 @@ void HamiltLCAO<TK, TR>::refresh()
     }
 }
 
+template <typename TK, typename TR>
+bool HamiltLCAO<TK, TR>::update_atoms(const Grid_Driver& grid_d)
+{
+    ModuleBase::TITLE("HamiltLCAO", "update_atoms");
+    auto op = dynamic_cast<hamilt::OperatorLCAO<TK, TR>*>(this->ops);
+    if (op == nullptr)
+    {
+        return false;
+    }
+    ModuleBase::timer::tick("HamiltLCAO", "update_atoms");
+
+    // collect the atom-pairs of all Operators, HR is fixed to gamma case as in the constructor
+    HContainer<TR> hR_new(this->hR->get_paraV());
+    if (std::is_same<TK, double>::value)
+    {
+        hR_new.fix_gamma();
+    }
+    if (!op->update_atoms(&grid_d, &hR_new))
+    {
+        ModuleBase::timer::tick("HamiltLCAO", "update_atoms");
+        return false;
+    }
+    const int nchange = this->hR->shape_update(hR_new);
+    // if NSPIN==2, HR is allocated in this->hRS2 by refresh()
+    if (nchange > 0 && PARAM.inp.nspin != 2)
+    {
+        this->hR->allocate(nullptr, true);
+    }
+    this->refresh();
+
+    GlobalV::ofs_running << " Atom pairs of H(R) updated: " << nchange << " of " << this->hR->size_atom_pairs()
+                         << " changed" << std::endl;
+    const int memory_fold = (PARAM.inp.nspin == 2) ? 2 : 1;
+    ModuleBase::Memory::record("HamiltLCAO::hR", this->hR->get_memory_size() * memory_fold);
+    ModuleBase::Memory::record("HamiltLCAO::sR", this->sR->get_memory_size());
+
+    ModuleBase::timer::tick("HamiltLCAO", "update_atoms");
+    return true;
+}
+
 // get Operator base class pointer
 template <typename TK, typename TR>
 Operator<TK>*& HamiltLCAO<TK, TR>::getOperator()
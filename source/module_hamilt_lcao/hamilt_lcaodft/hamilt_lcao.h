@@ -114,6 +114,14 @@ class HamiltLCAO : public Hamilt<TK>
     /// refresh the status of HR
     void refresh() override;
 
+    /**
+     * @brief update the Operators, HR and SR for the moved atoms instead of constructing HamiltLCAO again,
+     * the atom-pairs entering the cutoff are inserted and those leaving are removed.
+     * the neighbor list and the grid integration should be prepared for the new positions before.
+     * @return false if any Operator does not support the update, then HamiltLCAO should be constructed again
+     */
+    bool update_atoms(const Grid_Driver& grid_d);
+
     // for target K point, update consequence of hPsi() and matrix()
     virtual void updateHk(const int ik) override;
 
@@ -236,7 +236,7 @@ void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::contributeHR()
 template <typename TK, typename TR>
 void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::pre_calculate_nlm(
     const int iat0,
-    std::vector<std::unordered_map<int, std::vector<double>>>& nlm_in)
+    std::vector<ProjectorMatrix>& nlm_in)
 {
     const Parallel_Orbitals* paraV = this->hR->get_paraV();
     const int npol = this->ucell->get_npol();
@@ -246,6 +246,12 @@ void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::pre_calculate_nlm(
     ucell->iat2iait(iat0, &I0, &T0);
     AdjacentAtomInfo& adjs = this->adjs_all[iat0];
     nlm_in.resize(adjs.adj_num + 1);
+    // the number of the projectors alpha of all L, N and m
+    int nproj = 0;
+    for (int L0 = 0; L0 <= ptr_orb_->Alpha[0].getLmax(); ++L0)
+    {
+        nproj += (2 * L0 + 1) * ptr_orb_->Alpha[0].getNchi(L0);
+    }
 
     for (int ad = 0; ad < adjs.adj_num + 1; ++ad)
     {
@@ -255,15 +261,11 @@ void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::pre_calculate_nlm(
         const ModuleBase::Vector3<double>& tau1 = adjs.adjacent_tau[ad];
         const Atom* atom1 = &ucell->atoms[T1];
 
-        auto all_indexes = paraV->get_indexes_row(iat1);
-        auto col_indexes = paraV->get_indexes_col(iat1);
-        // insert col_indexes into all_indexes to get universal set with no repeat elements
-        all_indexes.insert(all_indexes.end(), col_indexes.begin(), col_indexes.end());
-        std::sort(all_indexes.begin(), all_indexes.end());
-        all_indexes.erase(std::unique(all_indexes.begin(), all_indexes.end()), all_indexes.end());
-        for (int iw1l = 0; iw1l < all_indexes.size(); iw1l += npol)
+        nlm_in[ad] = ProjectorMatrix(paraV->get_indexes_row(iat1), paraV->get_indexes_col(iat1), npol, nproj);
+        const std::vector<int>& orbitals = nlm_in[ad].get_orbitals();
+        for (int io = 0; io < orbitals.size(); io++)
         {
-            const int iw1 = all_indexes[iw1l] / npol;
+            const int iw1 = orbitals[io] / npol;
             std::vector<std::vector<double>> nlm;
             // nlm is a vector of vectors, but size of outer vector is only 1 here
             // If we are calculating force, we need also to store the gradient
@@ -279,11 +281,7 @@ void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::pre_calculate_nlm(
 
             ModuleBase::Vector3<double> dtau = tau0 - tau1;
             intor_orb_alpha_->snap(T1, L1, N1, M1, 0, dtau * ucell->lat0, false /*calc_deri*/, nlm);
-            nlm_in[ad].insert({all_indexes[iw1l], nlm[0]});
-            if (npol == 2)
-            {
-                nlm_in[ad].insert({all_indexes[iw1l + 1], nlm[0]});
-            }
+            nlm_in[ad].set(io, nlm[0]);
         }
     }
 }
@@ -311,10 +309,13 @@ void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
         ucell->iat2iait(iat0, &I0, &T0);
         AdjacentAtomInfo& adjs = this->adjs_all[iat0];
 
-        // trace alpha orbital
-        std::vector<int> trace_alpha_row;
-        std::vector<int> trace_alpha_col;
-        std::vector<double> gedms;
+        // the dense matrix of gedm of all the projectors, block-diagonal in (L, N) if not deepks_equiv
+        int nproj = 0;
+        for (int L0 = 0; L0 <= ptr_orb_->Alpha[0].getLmax(); ++L0)
+        {
+            nproj += (2 * L0 + 1) * ptr_orb_->Alpha[0].getNchi(L0);
+        }
+        std::vector<TR> gedm_dense(nproj * nproj, TR(0));
         if (!PARAM.inp.deepks_equiv)
         {
             int ib = 0;
@@ -330,9 +331,7 @@ void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
                     {
                         for (int m2 = 0; m2 < nm; ++m2) // m1 = 1 for s, 3 for p, 5 for d
                         {
-                            trace_alpha_row.push_back(ib + m1);
-                            trace_alpha_col.push_back(ib + m2);
-                            gedms.push_back(pgedm[m1 * nm + m2]);
+                            gedm_dense[(ib + m1) * nproj + ib + m2] = pgedm[m1 * nm + m2];
                         }
                     }
                     ib += nm;
@@ -342,26 +341,20 @@ void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
         else
         {
             const double* pgedm = this->ld->gedm[iat0];
-            int nproj = 0;
-            for (int il = 0; il < this->ld->lmaxd + 1; il++)
-            {
-                nproj += (2 * il + 1) * ptr_orb_->Alpha[0].getNchi(il);
-            }
-            for (int iproj = 0; iproj < nproj; iproj++)
+            for (int i = 0; i < nproj * nproj; i++)
             {
-                for (int jproj = 0; jproj < nproj; jproj++)
-                {
-                    trace_alpha_row.push_back(iproj);
-                    trace_alpha_col.push_back(jproj);
-                    gedms.push_back(pgedm[iproj * nproj + jproj]);
-                }
+                gedm_dense[i] = pgedm[i];
             }
         }
-        const int trace_alpha_size = trace_alpha_row.size();
-        //--------------------------------------------------
+        // the same D for spin-up and spin-down, none for the off-diagonal spin components
+        std::vector<const TR*> d(npol * npol, nullptr);
+        for (int is = 0; is < npol; is++)
+        {
+            d[is * npol + is] = gedm_dense.data();
+        }
 
         // if nlm_tot is not calculated already, calculate it on the fly now
-        std::vector<std::unordered_map<int, std::vector<double>>> nlm_on_the_fly;
+        std::vector<ProjectorMatrix> nlm_on_the_fly;
         const bool is_on_the_fly = (nlm_tot.size() != this->ucell->nat);
 
         if (is_on_the_fly)
@@ -369,7 +362,7 @@ void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
             this->pre_calculate_nlm(iat0, nlm_on_the_fly);
         }
 
-        std::vector<std::unordered_map<int, std::vector<double>>>& nlm_iat = 
+        std::vector<ProjectorMatrix>& nlm_iat = 
           is_on_the_fly ? nlm_on_the_fly : nlm_tot[iat0];
 
         // 2. calculate <phi_I|beta>D<beta|phi_{J,R}> for each pair of <IJR> atoms
@@ -379,23 +372,11 @@ void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
             const int I1 = adjs.natom[ad1];
             const int iat1 = ucell->itia2iat(T1, I1);
             ModuleBase::Vector3<int>& R_index1 = adjs.box[ad1];
-            auto row_indexes = paraV->get_indexes_row(iat1);
-            const int row_size = row_indexes.size();
+            const int row_size = paraV->get_row_size(iat1);
             if (row_size == 0)
             {
                 continue;
             }
-
-            std::vector<double> s_1t(trace_alpha_size * row_size);
-            for (int irow = 0; irow < row_size; irow++)
-            {
-                const double* row_ptr = nlm_iat[ad1][row_indexes[irow]].data();
-                double* ps1t = &s_1t[irow * trace_alpha_size];
-                for (int i = 0; i < trace_alpha_size; i++)
-                {
-                    ps1t[i] = row_ptr[trace_alpha_row[i]] * gedms[i];
-                }
-            }
             for (int ad2 = 0; ad2 < adjs.adj_num + 1; ++ad2)
             {
                 const int T2 = adjs.ntype[ad2];
@@ -412,94 +393,26 @@ void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
                 {
                     continue;
                 }
-                auto col_indexes = paraV->get_indexes_col(iat2);
-                const int col_size = col_indexes.size();
-                std::vector<double> hr_current(row_size * col_size, 0);
-                std::vector<double> s_2t(trace_alpha_size * col_size);
-                for (int icol = 0; icol < col_size; icol++)
+                const int col_size = paraV->get_col_size(iat2);
+                // <phi_I|alpha>gedm<alpha|phi_{J,R}> with two GEMMs
+                std::vector<TR> hr_current(row_size * col_size, TR(0));
+                contract_projectors(nlm_iat[ad1], nlm_iat[ad2], d, npol, hr_current.data());
+
+                // add data of HR to target BaseMatrix
+                #pragma omp critical
                 {
-                    const double* col_ptr = nlm_iat[ad2][col_indexes[icol]].data();
-                    double* ps2t = &s_2t[icol * trace_alpha_size];
-                    for (int i = 0; i < trace_alpha_size; i++)
+                    TR* data_pointer = tmp->get_pointer();
+                    for (int i = 0; i < row_size * col_size; i++)
                     {
-                        ps2t[i] = col_ptr[trace_alpha_col[i]];
+                        data_pointer[i] += hr_current[i];
                     }
                 }
-                /*for(int irow = 0;irow<row_size;irow++)
-                {
-                    for(int icol=0;icol<col_size;icol++)
-                    {
-                        for(int ialpha=0;ialpha<trace_alpha_size;ialpha++)
-                        {
-                            tmp->get_pointer()[irow*col_size+icol] +=
-                                s_1t[irow*trace_alpha_size+ialpha] * s_2t[icol*trace_alpha_size+ialpha];
-                        }
-                    }
-                }*/
-                // dgemm for s_2t and s_1t to get HR_12
-                constexpr char transa = 'T', transb = 'N';
-                const double gemm_alpha = 1.0, gemm_beta = 1.0;
-
-                dgemm_(&transa,
-                       &transb,
-                       &col_size,
-                       &row_size,
-                       &trace_alpha_size,
-                       &gemm_alpha,
-                       s_2t.data(),
-                       &trace_alpha_size,
-                       s_1t.data(),
-                       &trace_alpha_size,
-                       &gemm_beta,
-                       hr_current.data(),
-                       &col_size);
-
-            // add data of HR to target BaseMatrix
-            #pragma omp critical
-            {
-                this->cal_HR_IJR(hr_current.data(), row_size, col_size, tmp->get_pointer());
-            }
             }
         }
     }
     ModuleBase::timer::tick("DeePKS", "calculate_HR");
 }
 
-// cal_HR_IJR()
-template <typename TK, typename TR>
-void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::cal_HR_IJR(const double* hr_in,
-                                                              const int& row_size,
-                                                              const int& col_size,
-                                                              TR* data_pointer)
-{
-
-    //! npol is the number of polarizations,
-    //! 1 for non-magnetic (one Hamiltonian matrix only has spin-up or spin-down),
-    //! 2 for magnetic (one Hamiltonian matrix has both spin-up and spin-down)
-    const int npol = this->ucell->get_npol();
-
-    // step_trace = 0 for NSPIN=1,2; ={0, 1, local_col, local_col+1} for NSPIN=4
-    vector<int> step_trace(2, 0);
-    step_trace[1] = col_size + 1;
-
-    //! calculate the local matrix
-    for (int iw1l = 0; iw1l < row_size; iw1l += npol)
-    {
-        for (int iw2l = 0; iw2l < col_size; iw2l += npol)
-        {
-            for (int is = 0; is < npol; ++is)
-            {
-                data_pointer[step_trace[is]] += TR(*hr_in);
-            }
-            data_pointer += npol;
-            hr_in += npol;
-        }
-        data_pointer += (npol - 1) * col_size;
-        hr_in += (npol - 1) * col_size;
-    }
-}
-
-
 // contributeHk()
 template <typename TK, typename TR>
 void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::contributeHk(int ik)
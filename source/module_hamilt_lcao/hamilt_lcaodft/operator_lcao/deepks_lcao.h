@@ -7,6 +7,7 @@
 #include "module_hamilt_lcao/module_deepks/LCAO_deepks.h"
 #include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
 #include "operator_lcao.h"
+#include "projector_contraction.h"
 
 namespace hamilt
 {
@@ -96,13 +97,8 @@ class DeePKS<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
      */
     void calculate_HR();
 
-    /**
-     * @brief calculate the HR local matrix of <I,J,R> atom pair
-     */
-    void cal_HR_IJR(const double* hr_in, const int& row_size, const int& col_size, TR* data_pointer);
-
-    void pre_calculate_nlm(const int iat0, std::vector<std::unordered_map<int, std::vector<double>>>& nlm_in);
-    std::vector<std::vector<std::unordered_map<int, std::vector<double>>>> nlm_tot;
+    void pre_calculate_nlm(const int iat0, std::vector<ProjectorMatrix>& nlm_in);
+    std::vector<std::vector<ProjectorMatrix>> nlm_tot;
     /**
      * @brief initialize V_delta_R, search the nearest neighbor atoms
      * used for calculate the DeePKS real space Hamiltonian correction with specific <I,J,R> atom-pairs
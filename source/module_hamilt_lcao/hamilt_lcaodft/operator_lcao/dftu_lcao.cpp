@@ -126,15 +126,11 @@ void hamilt::DFTU<hamilt::OperatorLCAO<TK, TR>>::cal_nlm_all(const Parallel_Orbi
             const ModuleBase::Vector3<double>& tau1 = adjs.adjacent_tau[ad];
             const Atom* atom1 = &ucell->atoms[T1];
 
-            auto all_indexes = paraV->get_indexes_row(iat1);
-            auto col_indexes = paraV->get_indexes_col(iat1);
-            // insert col_indexes into all_indexes to get universal set with no repeat elements
-            all_indexes.insert(all_indexes.end(), col_indexes.begin(), col_indexes.end());
-            std::sort(all_indexes.begin(), all_indexes.end());
-            all_indexes.erase(std::unique(all_indexes.begin(), all_indexes.end()), all_indexes.end());
-            for (int iw1l = 0; iw1l < all_indexes.size(); iw1l += npol)
+            nlm_tot[iat0][ad] = ProjectorMatrix(paraV->get_indexes_row(iat1), paraV->get_indexes_col(iat1), npol, tlp1);
+            const std::vector<int>& orbitals = nlm_tot[iat0][ad].get_orbitals();
+            for (int io = 0; io < orbitals.size(); io++)
             {
-                const int iw1 = all_indexes[iw1l] / npol;
+                const int iw1 = orbitals[io] / npol;
                 // only first zeta orbitals in target L of atom iat0 are needed
                 std::vector<double> nlm_target(tlp1);
                 const int L1 = atom1->iw2l[iw1];
@@ -164,7 +160,7 @@ void hamilt::DFTU<hamilt::OperatorLCAO<TK, TR>>::cal_nlm_all(const Parallel_Orbi
                         break;
                     }
                 }
-                nlm_tot[iat0][ad].insert({all_indexes[iw1l], nlm_target});
+                nlm_tot[iat0][ad].set(io, nlm_target);
             }
         }
     }
@@ -224,13 +220,13 @@ void hamilt::DFTU<hamilt::OperatorLCAO<TK, TR>>::contributeHR()
                 const int I1 = adjs.natom[ad1];
                 const int iat1 = ucell->itia2iat(T1, I1);
                 ModuleBase::Vector3<int>& R_index1 = adjs.box[ad1];
-                const std::unordered_map<int, std::vector<double>>& nlm1 = nlm_tot[iat0][ad1];
+                const ProjectorMatrix& nlm1 = nlm_tot[iat0][ad1];
                 for (int ad2 = 0; ad2 < adjs.adj_num + 1; ++ad2)
                 {
                     const int T2 = adjs.ntype[ad2];
                     const int I2 = adjs.natom[ad2];
                     const int iat2 = ucell->itia2iat(T2, I2);
-                    const std::unordered_map<int, std::vector<double>>& nlm2 = nlm_tot[iat0][ad2];
+                    const ProjectorMatrix& nlm2 = nlm_tot[iat0][ad2];
                     ModuleBase::Vector3<int>& R_index2 = adjs.box[ad2];
                     ModuleBase::Vector3<int> R_vector(R_index2[0] - R_index1[0],
                                                       R_index2[1] - R_index1[1],
@@ -240,7 +236,8 @@ void hamilt::DFTU<hamilt::OperatorLCAO<TK, TR>>::contributeHR()
                     // if not found , skip this pair of atoms
                     if (tmp != nullptr)
                     {
-                        this->cal_occ(iat1, iat2, paraV, nlm1, nlm2, tmp->get_pointer(), occ);
+                        // occ_mm' = \sum_R DMR*<phi_0|alpha^I_m><alpha^I_m'|phi_R>
+                        contract_density(nlm1, nlm2, npol, tmp->get_pointer(), occ.data());
                     }
                 }
             }
@@ -276,6 +273,12 @@ void hamilt::DFTU<hamilt::OperatorLCAO<TK, TR>>::contributeHR()
         // transfer occ from pauli matrix format to normal format
         std::vector<TR> VU(occ.size());
         this->transfer_vu(VU_tmp, VU);
+        // the VU matrices of the npol*npol spin components
+        std::vector<const TR*> vu_spin(npol * npol);
+        for (int is = 0; is < npol * npol; is++)
+        {
+            vu_spin[is] = &VU[is * tlp1 * tlp1];
+        }
 
         // second iteration to calculate Hamiltonian matrix
         // calculate <psi_I|beta_m> U*(1/2*delta(m, m')-occ(m, m')) <beta_m'|psi_{J,R}> for each pair of <IJR> atoms
@@ -286,13 +289,13 @@ void hamilt::DFTU<hamilt::OperatorLCAO<TK, TR>>::contributeHR()
             const int I1 = adjs.natom[ad1];
             const int iat1 = ucell->itia2iat(T1, I1);
             ModuleBase::Vector3<int>& R_index1 = adjs.box[ad1];
-            const std::unordered_map<int, std::vector<double>>& nlm1 = nlm_tot[iat0][ad1];
+            const ProjectorMatrix& nlm1 = nlm_tot[iat0][ad1];
             for (int ad2 = 0; ad2 < adjs.adj_num + 1; ++ad2)
             {
                 const int T2 = adjs.ntype[ad2];
                 const int I2 = adjs.natom[ad2];
                 const int iat2 = ucell->itia2iat(T2, I2);
-                const std::unordered_map<int, std::vector<double>>& nlm2 = nlm_tot[iat0][ad2];
+                const ProjectorMatrix& nlm2 = nlm_tot[iat0][ad2];
                 ModuleBase::Vector3<int>& R_index2 = adjs.box[ad2];
                 ModuleBase::Vector3<int> R_vector(R_index2[0] - R_index1[0],
                                                   R_index2[1] - R_index1[1],
@@ -301,7 +304,7 @@ void hamilt::DFTU<hamilt::OperatorLCAO<TK, TR>>::contributeHR()
                 // if not found , skip this pair of atoms
                 if (tmp != nullptr)
                 {
-                    this->cal_HR_IJR(iat1, iat2, paraV, nlm1, nlm2, VU, tmp->get_pointer());
+                    contract_projectors(nlm1, nlm2, vu_spin, npol, tmp->get_pointer());
                 }
             }
         }
@@ -330,130 +333,6 @@ void hamilt::DFTU<hamilt::OperatorLCAO<TK, TR>>::contributeHR()
     ModuleBase::timer::tick("DFTU", "contributeHR");
 }
 
-// cal_HR_IJR()
-template <typename TK, typename TR>
-void hamilt::DFTU<hamilt::OperatorLCAO<TK, TR>>::cal_HR_IJR(
-    const int& iat1,
-    const int& iat2,
-    const Parallel_Orbitals* paraV,
-    const std::unordered_map<int, std::vector<double>>& nlm1_all,
-    const std::unordered_map<int, std::vector<double>>& nlm2_all,
-    const std::vector<TR>& VU,
-    TR* data_pointer)
-{
-
-    // npol is the number of polarizations,
-    // 1 for non-magnetic (one Hamiltonian matrix only has spin-up or spin-down),
-    // 2 for magnetic (one Hamiltonian matrix has both spin-up and spin-down)
-    const int npol = this->ucell->get_npol();
-    // ---------------------------------------------
-    // calculate the Nonlocal matrix for each pair of orbitals
-    // ---------------------------------------------
-    auto row_indexes = paraV->get_indexes_row(iat1);
-    auto col_indexes = paraV->get_indexes_col(iat2);
-    const int m_size = int(sqrt(VU.size()) / npol);
-    // step_trace = 0 for NSPIN=1,2; ={0, 1, local_col, local_col+1} for NSPIN=4
-    std::vector<int> step_trace(npol * npol, 0);
-    for (int is = 0; is < npol; is++)
-    {
-        for (int is2 = 0; is2 < npol; is2++)
-        {
-            step_trace[is * npol + is2] = paraV->get_col_size(iat2) * is + is2;
-        }
-    }
-    // calculate the local matrix
-    const TR* tmp_d = nullptr;
-    for (int iw1l = 0; iw1l < row_indexes.size(); iw1l += npol)
-    {
-        const std::vector<double>& nlm1 = nlm1_all.find(row_indexes[iw1l])->second;
-        for (int iw2l = 0; iw2l < col_indexes.size(); iw2l += npol)
-        {
-            const std::vector<double>& nlm2 = nlm2_all.find(col_indexes[iw2l])->second;
-#ifdef __DEBUG
-            assert(nlm1.size() == nlm2.size());
-#endif
-            for (int is = 0; is < npol * npol; ++is)
-            {
-                int start = is * m_size * m_size;
-                TR nlm_tmp = TR(0);
-                for (int m1 = 0; m1 < m_size; m1++)
-                {
-                    for (int m2 = 0; m2 < m_size; m2++)
-                    {
-                        nlm_tmp += nlm1[m1] * nlm2[m2] * VU[m1 * m_size + m2 + start];
-                    }
-                }
-                data_pointer[step_trace[is]] += nlm_tmp;
-            }
-            data_pointer += npol;
-        }
-        data_pointer += (npol - 1) * col_indexes.size();
-    }
-}
-
-template <typename TK, typename TR>
-void hamilt::DFTU<hamilt::OperatorLCAO<TK, TR>>::cal_occ(const int& iat1,
-                                                         const int& iat2,
-                                                         const Parallel_Orbitals* paraV,
-                                                         const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                                                         const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                                                         const double* dm_pointer,
-                                                         std::vector<double>& occ)
-{
-
-    // npol is the number of polarizations,
-    // 1 for non-magnetic (one Hamiltonian matrix only has spin-up or spin-down),
-    // 2 for magnetic (one Hamiltonian matrix has both spin-up and spin-down)
-    const int npol = this->ucell->get_npol();
-    // ---------------------------------------------
-    // calculate the Nonlocal matrix for each pair of orbitals
-    // ---------------------------------------------
-    auto row_indexes = paraV->get_indexes_row(iat1);
-    auto col_indexes = paraV->get_indexes_col(iat2);
-    const int m_size = int(sqrt(occ.size()) / npol);
-    const int m_size2 = m_size * m_size;
-#ifdef __DEBUG
-    assert(m_size * m_size == occ.size());
-#endif
-    // step_trace = 0 for NSPIN=1,2; ={0, 1, local_col, local_col+1} for NSPIN=4
-    std::vector<int> step_trace(npol * npol, 0);
-    for (int is = 0; is < npol; is++)
-    {
-        for (int is2 = 0; is2 < npol; is2++)
-        {
-            step_trace[is * npol + is2] = paraV->get_col_size(iat2) * is + is2;
-        }
-    }
-    // calculate the local matrix
-    for (int iw1l = 0; iw1l < row_indexes.size(); iw1l += npol)
-    {
-        const std::vector<double>& nlm1 = nlm1_all.find(row_indexes[iw1l])->second;
-        for (int iw2l = 0; iw2l < col_indexes.size(); iw2l += npol)
-        {
-            const std::vector<double>& nlm2 = nlm2_all.find(col_indexes[iw2l])->second;
-#ifdef __DEBUG
-            assert(nlm1.size() == nlm2.size());
-#endif
-            for (int is1 = 0; is1 < npol; ++is1)
-            {
-                for (int is2 = 0; is2 < npol; ++is2)
-                {
-                    for (int m1 = 0; m1 < m_size; ++m1)
-                    {
-                        for (int m2 = 0; m2 < m_size; ++m2)
-                        {
-                            occ[m1 * m_size + m2 + (is1 * npol + is2) * m_size2]
-                                += nlm1[m1] * nlm2[m2] * dm_pointer[step_trace[is1 * npol + is2]];
-                        }
-                    }
-                }
-            }
-            dm_pointer += npol;
-        }
-        dm_pointer += (npol - 1) * col_indexes.size();
-    }
-}
-
 template <typename TK, typename TR>
 void hamilt::DFTU<hamilt::OperatorLCAO<TK, TR>>::transfer_vu(std::vector<double>& vu_tmp, std::vector<TR>& vu)
 {
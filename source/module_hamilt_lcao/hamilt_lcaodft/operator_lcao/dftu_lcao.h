@@ -7,6 +7,7 @@
 #include "module_cell/unitcell.h"
 #include "module_elecstate/module_dm/density_matrix.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/operator_lcao/operator_lcao.h"
+#include "module_hamilt_lcao/hamilt_lcaodft/operator_lcao/projector_contraction.h"
 #include "module_hamilt_lcao/module_dftu/dftu.h"
 #include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
 
@@ -75,34 +76,12 @@ class DFTU<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
      */
     void cal_nlm_all(const Parallel_Orbitals* paraV);
 
-    /**
-     * @brief calculate the occ_mm' = \sum_R DMR*<phi_0|alpha^I_m'><alpha^I_m'|phi_R> matrix for each atom to add U
-     */
-    void cal_occ(const int& iat1,
-                 const int& iat2,
-                 const Parallel_Orbitals* paraV,
-                 const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                 const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                 const double* data_pointer,
-                 std::vector<double>& occupations);
-
     /// transfer VU format from pauli matrix to normal for non-collinear spin case
     void transfer_vu(std::vector<double>& vu_tmp, std::vector<TR>& vu);
     /// VU_{m, m'} = sum_{m,m'} (1/2*delta_{m, m'} - occ_{m, m'}) * U
     /// EU = sum_{m,m'} 1/2 * U * occ_{m, m'} * occ_{m', m}
     void cal_v_of_u(const std::vector<double>& occ, const int m_size, const double u_value, double* vu, double& eu);
 
-    /**
-     * @brief calculate the HR local matrix of <I,J,R> atom pair
-     */
-    void cal_HR_IJR(const int& iat1,
-                    const int& iat2,
-                    const Parallel_Orbitals* paraV,
-                    const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                    const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                    const std::vector<TR>& vu_in,
-                    TR* data_pointer);
-
     /**
      * @brief calculate the atomic Force of <I,J,R> atom pair
      */
@@ -134,8 +113,9 @@ class DFTU<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
     std::vector<AdjacentAtomInfo> adjs_all;
     /// @brief if the nlm_tot is calculated
     bool precal_nlm_done = false;
-    /// @brief the overlap values for all [atoms][nerghbors][orb_index(iw) in NAOs][m of target_l in Projectors]
-    std::vector<std::vector<std::unordered_map<int, std::vector<double>>>> nlm_tot;
+    /// @brief the overlap values for all [atoms][nerghbors], the occupation matrix and HR are contracted from them
+    /// as occ_mm' = \sum_R DMR*<phi_0|alpha^I_m><alpha^I_m'|phi_R> and HR = <phi_0|alpha^I_m>VU_mm'<alpha^I_m'|phi_R>
+    std::vector<std::vector<ProjectorMatrix>> nlm_tot;
 };
 
 } // namespace hamilt
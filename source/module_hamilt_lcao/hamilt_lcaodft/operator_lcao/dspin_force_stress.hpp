@@ -73,7 +73,7 @@ void DeltaSpin<OperatorLCAO<TK, TR>>::cal_force_stress(const bool cal_force,
         filter_adjs(is_adj, adjs);
         const int max_l_plus_1 = this->ucell->atoms[T0].nwl + 1;
         const int length = max_l_plus_1 * max_l_plus_1;
-        std::vector<std::unordered_map<int, std::vector<double>>> nlm_iat0(adjs.adj_num + 1);
+        std::vector<ProjectorMatrix> nlm_iat0(adjs.adj_num + 1);
 
         for (int ad = 0; ad < adjs.adj_num + 1; ++ad)
         {
@@ -83,15 +83,12 @@ void DeltaSpin<OperatorLCAO<TK, TR>>::cal_force_stress(const bool cal_force,
             const ModuleBase::Vector3<double>& tau1 = adjs.adjacent_tau[ad];
             const Atom* atom1 = &ucell->atoms[T1];
 
-            auto all_indexes = paraV->get_indexes_row(iat1);
-            auto col_indexes = paraV->get_indexes_col(iat1);
-            // insert col_indexes into all_indexes to get universal set with no repeat elements
-            all_indexes.insert(all_indexes.end(), col_indexes.begin(), col_indexes.end());
-            std::sort(all_indexes.begin(), all_indexes.end());
-            all_indexes.erase(std::unique(all_indexes.begin(), all_indexes.end()), all_indexes.end());
-            for (int iw1l = 0; iw1l < all_indexes.size(); iw1l += npol)
+            // the projections and their gradients
+            nlm_iat0[ad] = ProjectorMatrix(paraV->get_indexes_row(iat1), paraV->get_indexes_col(iat1), npol, length, 4);
+            const std::vector<int>& orbitals = nlm_iat0[ad].get_orbitals();
+            for (int io = 0; io < orbitals.size(); io++)
             {
-                const int iw1 = all_indexes[iw1l] / npol;
+                const int iw1 = orbitals[io] / npol;
                 std::vector<std::vector<double>> nlm;
                 // nlm is a vector of vectors, but size of outer vector is only 1 here
                 // If we are calculating force, we need also to store the gradient
@@ -127,9 +124,24 @@ void DeltaSpin<OperatorLCAO<TK, TR>>::cal_force_stress(const bool cal_force,
                         target_L++;
                     }
                 }
-                nlm_iat0[ad].insert({all_indexes[iw1l], nlm_target});
+                nlm_iat0[ad].set(io, nlm_target);
             }
-        }      
+        }
+
+        // D = lambda * identity for the magnetic components is = 1, 2, 3 of dmR,
+        // only lambda_z for NSPIN=2, where dmR has one component
+        std::vector<double> d_data(npol * npol * length * length, 0.0);
+        std::vector<const double*> d(npol * npol, nullptr);
+        for (int is = 1; is < this->nspin; is++)
+        {
+            const double lambda_tmp = this->nspin == 2 ? lambda[iat0][2] : lambda[iat0][is - 1];
+            const int id = this->nspin == 2 ? 0 : is;
+            for (int p = 0; p < length; p++)
+            {
+                d_data[(id * length + p) * length + p] = lambda_tmp;
+            }
+            d[id] = &d_data[id * length * length];
+        }
 
         // second iteration to calculate force and stress
         for (int ad1 = 0; ad1 < adjs.adj_num + 1; ++ad1)
@@ -161,33 +173,37 @@ void DeltaSpin<OperatorLCAO<TK, TR>>::cal_force_stress(const bool cal_force,
                 // if not found , skip this pair of atoms
                 if (tmp != nullptr)
                 {
+                    // the gradients with respect to the positions of iat1 and iat2
+                    double g1[3] = {0.0, 0.0, 0.0};
+                    double g2[3] = {0.0, 0.0, 0.0};
+                    contract_gradients(nlm_iat0[ad1],
+                                       nlm_iat0[ad2],
+                                       d,
+                                       npol,
+                                       tmp->get_pointer(),
+                                       g1,
+                                       cal_stress ? g2 : nullptr);
                     // calculate force
-                    if (cal_force) {
-                        this->cal_force_IJR(iat1,
-                                            iat2,
-                                            paraV,
-                                            nlm_iat0[ad1],
-                                            nlm_iat0[ad2],
-                                            tmp,
-                                            lambda[iat0],
-                                            this->nspin,
-                                            force_tmp1,
-                                            force_tmp2);
+                    // force1 = - VU * <d phi_{I,R1}/d R1|chi_m> * <chi_m'|phi_{J,R2}>
+                    // force2 = - VU * <phi_{I,R1}|d chi_m/d R0> * <chi_m'|phi_{J,R2>}
+                    if (cal_force)
+                    {
+                        for (int i = 0; i < 3; i++)
+                        {
+                            force_tmp1[i] += g1[i];
+                            force_tmp2[i] -= g1[i];
+                        }
                     }
 
                     // calculate stress
-                    if (cal_stress) {
-                        this->cal_stress_IJR(iat1,
-                                             iat2,
-                                             paraV,
-                                             nlm_iat0[ad1],
-                                             nlm_iat0[ad2],
-                                             tmp,
-                                             lambda[iat0],
-                                             this->nspin,
-                                             dis1,
-                                             dis2,
-                                             stress_local.data());
+                    if (cal_stress)
+                    {
+                        stress_local[0] += g1[0] * dis1.x + g2[0] * dis2.x;
+                        stress_local[1] += g1[0] * dis1.y + g2[0] * dis2.y;
+                        stress_local[2] += g1[0] * dis1.z + g2[0] * dis2.z;
+                        stress_local[3] += g1[1] * dis1.y + g2[1] * dis2.y;
+                        stress_local[4] += g1[1] * dis1.z + g2[1] * dis2.z;
+                        stress_local[5] += g1[2] * dis1.z + g2[2] * dis2.z;
                     }
                 }
             }
@@ -244,151 +260,4 @@ void DeltaSpin<OperatorLCAO<TK, TR>>::cal_force_stress(const bool cal_force,
     ModuleBase::timer::tick("DeltaSpin", "cal_force_stress");
 }
 
-template <typename TK, typename TR>
-void DeltaSpin<OperatorLCAO<TK, TR>>::cal_force_IJR(const int& iat1,
-                                               const int& iat2,
-                                               const Parallel_Orbitals* paraV,
-                                               const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                                               const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                                               const hamilt::BaseMatrix<double>* dmR_pointer,
-                                               const ModuleBase::Vector3<double>& lambda,
-                                               const int nspin,
-                                               double* force1,
-                                               double* force2)
-{
-    // npol is the number of polarizations,
-    // 1 for non-magnetic (one Hamiltonian matrix only has spin-up or spin-down),
-    // 2 for magnetic (one Hamiltonian matrix has both spin-up and spin-down)
-    const int npol = this->ucell->get_npol();
-    // ---------------------------------------------
-    // calculate the Nonlocal matrix for each pair of orbitals
-    // ---------------------------------------------
-    auto row_indexes = paraV->get_indexes_row(iat1);
-    auto col_indexes = paraV->get_indexes_col(iat2);
-    // step_trace = 0 for NSPIN=2; ={0, 1, local_col, local_col+1} for NSPIN=4
-    std::vector<int> step_trace(nspin, 0);
-    if (nspin == 4) {
-        step_trace[1] = 1;
-        step_trace[2] = col_indexes.size();
-        step_trace[3] = col_indexes.size() + 1;
-    }
-    double tmp[3];
-    // calculate the local matrix
-    for (int is = 1; is < nspin; is++)
-    {
-        const double lambda_tmp = nspin==2?lambda[2]:lambda[is-1];
-        const double* dm_pointer = dmR_pointer->get_pointer();
-        for (int iw1l = 0; iw1l < row_indexes.size(); iw1l += npol)
-        {
-            const std::vector<double>& nlm1 = nlm1_all.find(row_indexes[iw1l])->second;
-            for (int iw2l = 0; iw2l < col_indexes.size(); iw2l += npol)
-            {
-                const std::vector<double>& nlm2 = nlm2_all.find(col_indexes[iw2l])->second;
-#ifdef __DEBUG
-                assert(nlm1.size() == nlm2.size());
-#endif
-                const int length = nlm1.size() / 4;
-                const int lmax = sqrt(length);
-                int index = 0;
-                for(int l = 0; l<lmax; l++)
-                {
-                    for (int m = 0; m < 2*l+1; m++)
-                    {
-                        index = l*l + m;
-                        tmp[0] = lambda_tmp * nlm1[index + length] * nlm2[index] * dm_pointer[step_trace[is]];
-                        tmp[1] = lambda_tmp * nlm1[index + length * 2] * nlm2[index] * dm_pointer[step_trace[is]];
-                        tmp[2] = lambda_tmp * nlm1[index + length * 3] * nlm2[index] * dm_pointer[step_trace[is]];
-                        // force1 = - VU * <d phi_{I,R1}/d R1|chi_m> * <chi_m'|phi_{J,R2}>
-                        // force2 = - VU * <phi_{I,R1}|d chi_m/d R0> * <chi_m'|phi_{J,R2>}
-                        force1[0] += tmp[0];
-                        force1[1] += tmp[1];
-                        force1[2] += tmp[2];
-                        force2[0] -= tmp[0];
-                        force2[1] -= tmp[1];
-                        force2[2] -= tmp[2];
-                    }
-                }
-                dm_pointer += npol;
-            }
-            dm_pointer += (npol - 1) * col_indexes.size();
-        }
-    }
-}
-
-template <typename TK, typename TR>
-void DeltaSpin<OperatorLCAO<TK, TR>>::cal_stress_IJR(const int& iat1,
-                                                const int& iat2,
-                                                const Parallel_Orbitals* paraV,
-                                                const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                                                const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                                                const hamilt::BaseMatrix<double>* dmR_pointer,
-                                                const ModuleBase::Vector3<double>& lambda,
-                                                const int nspin,
-                                                const ModuleBase::Vector3<double>& dis1,
-                                                const ModuleBase::Vector3<double>& dis2,
-                                                double* stress)
-{
-    // npol is the number of polarizations,
-    // 1 for non-magnetic (one Hamiltonian matrix only has spin-up or spin-down),
-    // 2 for magnetic (one Hamiltonian matrix has both spin-up and spin-down)
-    const int npol = this->ucell->get_npol();
-    // ---------------------------------------------
-    // calculate the Nonlocal matrix for each pair of orbitals
-    // ---------------------------------------------
-    auto row_indexes = paraV->get_indexes_row(iat1);
-    auto col_indexes = paraV->get_indexes_col(iat2);
-    // step_trace = 0 for NSPIN=2; ={0, 1, local_col, local_col+1} for NSPIN=4
-    std::vector<int> step_trace(nspin, 0);
-    if (nspin == 4) {
-        step_trace[1] = 1;
-        step_trace[2] = col_indexes.size();
-        step_trace[3] = col_indexes.size() + 1;
-    }
-    // calculate the local matrix
-    for (int is = 1; is < nspin; is++)
-    {
-        const double lambda_tmp = nspin==2?lambda[2]:lambda[is-1];
-        const double* dm_pointer = dmR_pointer->get_pointer();
-        for (int iw1l = 0; iw1l < row_indexes.size(); iw1l += npol)
-        {
-            const std::vector<double>& nlm1 = nlm1_all.find(row_indexes[iw1l])->second;
-            for (int iw2l = 0; iw2l < col_indexes.size(); iw2l += npol)
-            {
-                const std::vector<double>& nlm2 = nlm2_all.find(col_indexes[iw2l])->second;
-#ifdef __DEBUG
-                assert(nlm1.size() == nlm2.size());
-#endif
-                const int length = nlm1.size() / 4;
-                const int lmax = sqrt(length);
-                double tmp = lambda_tmp * dm_pointer[step_trace[is]];
-                int index = 0;
-                for(int l = 0; l<lmax; l++)
-                {
-                    for (int m = 0; m < 2*l+1; m++)
-                    {
-                        index = l*l + m;
-                        stress[0]
-                            += tmp * (nlm1[index + length] * dis1.x * nlm2[index] + nlm1[index] * nlm2[index + length] * dis2.x);
-                        stress[1]
-                            += tmp * (nlm1[index + length] * dis1.y * nlm2[index] + nlm1[index] * nlm2[index + length] * dis2.y);
-                        stress[2]
-                            += tmp * (nlm1[index + length] * dis1.z * nlm2[index] + nlm1[index] * nlm2[index + length] * dis2.z);
-                        stress[3] += tmp
-                                     * (nlm1[index + length * 2] * dis1.y * nlm2[index]
-                                        + nlm1[index] * nlm2[index + length * 2] * dis2.y);
-                        stress[4] += tmp
-                                     * (nlm1[index + length * 2] * dis1.z * nlm2[index]
-                                        + nlm1[index] * nlm2[index + length * 2] * dis2.z);
-                        stress[5] += tmp
-                                     * (nlm1[index + length * 3] * dis1.z * nlm2[index]
-                                        + nlm1[index] * nlm2[index + length * 3] * dis2.z);
-                    }
-                }
-                dm_pointer += npol;
-            }
-            dm_pointer += (npol - 1) * col_indexes.size();
-        }
-    }
-}
-
 } // namespace hamilt
@@ -293,7 +293,8 @@ void hamilt::DeltaSpin<hamilt::OperatorLCAO<TK, TR>>::cal_pre_HR()
 
         // third step: calculate the <phi|alpha> overlap integrals
         const int max_l_plus_1 = this->ucell->atoms[T0].nwl + 1;
-        std::vector<std::unordered_map<int, std::vector<double>>> nlm_iat0(adjs.adj_num + 1);
+        const int length = max_l_plus_1 * max_l_plus_1;
+        std::vector<ProjectorMatrix> nlm_iat0(adjs.adj_num + 1);
         for(int ad = 0; ad < adjs.adj_num + 1; ++ad)
         {
             const int T1 = adjs.ntype[ad];
@@ -302,17 +303,13 @@ void hamilt::DeltaSpin<hamilt::OperatorLCAO<TK, TR>>::cal_pre_HR()
             const Atom* atom1 = &ucell->atoms[T1];
             const ModuleBase::Vector3<double>& tau1 = adjs.adjacent_tau[ad];
 
-            auto all_indexes = paraV->get_indexes_row(iat1);
-            auto col_indexes = paraV->get_indexes_col(iat1);
-            // insert col_indexes into all_indexes to get universal set with no repeat elements
-            all_indexes.insert(all_indexes.end(), col_indexes.begin(), col_indexes.end());
-            std::sort(all_indexes.begin(), all_indexes.end());
-            all_indexes.erase(std::unique(all_indexes.begin(), all_indexes.end()), all_indexes.end());
-            for (int iw1l = 0; iw1l < all_indexes.size(); iw1l += npol)
+            nlm_iat0[ad] = ProjectorMatrix(paraV->get_indexes_row(iat1), paraV->get_indexes_col(iat1), npol, length);
+            const std::vector<int>& orbitals = nlm_iat0[ad].get_orbitals();
+            for (int io = 0; io < orbitals.size(); io++)
             {
-                const int iw1 = all_indexes[iw1l] / npol;
+                const int iw1 = orbitals[io] / npol;
                 // only first zeta orbitals in target L of atom iat0 are needed
-                std::vector<double> nlm_target(max_l_plus_1 * max_l_plus_1);
+                std::vector<double> nlm_target(length);
                 const int L1 = atom1->iw2l[ iw1 ];
                 const int N1 = atom1->iw2n[ iw1 ];
                 const int m1 = atom1->iw2m[ iw1 ];
@@ -343,7 +340,7 @@ void hamilt::DeltaSpin<hamilt::OperatorLCAO<TK, TR>>::cal_pre_HR()
                         target_L++;
                     }
                 }
-                nlm_iat0[ad].insert({all_indexes[iw1l], nlm_target});
+                nlm_iat0[ad].set(io, nlm_target);
             }
         }
 
@@ -354,13 +351,13 @@ void hamilt::DeltaSpin<hamilt::OperatorLCAO<TK, TR>>::cal_pre_HR()
             const int I1 = adjs.natom[ad1];
             const int iat1 = ucell->itia2iat(T1, I1);
             ModuleBase::Vector3<int>& R_index1 = adjs.box[ad1];
-            const std::unordered_map<int,std::vector<double>>& nlm1 = nlm_iat0[ad1];
+            const ProjectorMatrix& nlm1 = nlm_iat0[ad1];
             for (int ad2 = 0; ad2 < adjs.adj_num + 1; ++ad2)
             {
                 const int T2 = adjs.ntype[ad2];
                 const int I2 = adjs.natom[ad2];
                 const int iat2 = ucell->itia2iat(T2, I2);
-                const std::unordered_map<int,std::vector<double>>& nlm2 = nlm_iat0[ad2];
+                const ProjectorMatrix& nlm2 = nlm_iat0[ad2];
                 ModuleBase::Vector3<int>& R_index2 = adjs.box[ad2];
                 ModuleBase::Vector3<int> R_vector(R_index2[0] - R_index1[0],
                                                   R_index2[1] - R_index1[1],
@@ -369,7 +366,7 @@ void hamilt::DeltaSpin<hamilt::OperatorLCAO<TK, TR>>::cal_pre_HR()
                 // if not found , skip this pair of atoms
                 if (tmp != nullptr)
                 {
-                    this->cal_HR_IJR(iat1, iat2, nlm1, nlm2, tmp->get_pointer());
+                    contract_projectors(nlm1, nlm2, npol, tmp->get_pointer());
                 }
             }
         }
@@ -379,58 +376,6 @@ void hamilt::DeltaSpin<hamilt::OperatorLCAO<TK, TR>>::cal_pre_HR()
     ModuleBase::timer::tick("DeltaSpin", "cal_pre_HR");
 }
 
-// cal_HR_IJR()
-template <typename TK, typename TR>
-void hamilt::DeltaSpin<hamilt::OperatorLCAO<TK, TR>>::cal_HR_IJR(const int& iat1,
-                    const int& iat2,
-                    const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                    const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                    TR* data_pointer)
-{
-    // npol is the number of polarizations,
-    // 1 for non-magnetic (one Hamiltonian matrix only has spin-up or spin-down),
-    // 2 for magnetic (one Hamiltonian matrix has both spin-up and spin-down)
-    const int npol = this->ucell->get_npol();
-    // ---------------------------------------------
-    // calculate the Nonlocal matrix for each pair of orbitals
-    // ---------------------------------------------
-    auto row_indexes = this->paraV->get_indexes_row(iat1);
-    auto col_indexes = this->paraV->get_indexes_col(iat2);
-    // step_trace = 0 for NSPIN=1,2; ={0, 1, local_col, local_col+1} for NSPIN=4
-    std::vector<int> step_trace(npol*npol, 0);
-    for (int is = 0; is < npol; is++)
-    {
-        for (int is2 = 0; is2 < npol; is2++)
-        {
-            step_trace[is * npol + is2] = this->paraV->get_col_size(iat2) * is + is2;
-        }
-    }
-    // calculate the local matrix
-    const TR* tmp_d = nullptr;
-    for (int iw1l = 0; iw1l < row_indexes.size(); iw1l += npol)
-    {
-        const std::vector<double>& nlm1 = nlm1_all.find(row_indexes[iw1l])->second;
-        for (int iw2l = 0; iw2l < col_indexes.size(); iw2l += npol)
-        {
-            const std::vector<double>& nlm2 = nlm2_all.find(col_indexes[iw2l])->second;
-#ifdef __DEBUG
-            assert(nlm1.size() == nlm2.size());
-#endif
-            TR nlm_tmp = TR(0);
-            for (int m1 = 0; m1 < nlm1.size(); m1++)
-            {
-                nlm_tmp += nlm1[m1] * nlm2[m1];
-            }
-            for (int is = 0; is < npol*npol; ++is)
-            {
-                data_pointer[step_trace[is]] += nlm_tmp;
-            }
-            data_pointer += npol;
-        }
-        data_pointer += (npol - 1) * col_indexes.size();
-    }
-}
-
 // cal_moment
 template <typename TK, typename TR>
 std::vector<double> hamilt::DeltaSpin<hamilt::OperatorLCAO<TK, TR>>::cal_moment(const HContainer<double>* dmR, const std::vector<ModuleBase::Vector3<int>>& constrain)
@@ -6,6 +6,7 @@
 #include "module_cell/module_neighbor/sltk_grid_driver.h"
 #include "module_cell/unitcell.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/operator_lcao/operator_lcao.h"
+#include "module_hamilt_lcao/hamilt_lcaodft/operator_lcao/projector_contraction.h"
 #include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
 #include <unordered_map>
 
@@ -82,15 +83,6 @@ class DeltaSpin<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
     /// @brief the number of spin components, 1 for no-spin, 2 for collinear spin case and 4 for non-collinear spin case
     int nspin = 0;
 
-    /**
-     * @brief calculate the HR local matrix of <I,J,R> atom pair
-     */
-    void cal_HR_IJR(const int& iat1,
-                    const int& iat2,
-                    const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                    const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                    TR* data_pointer);
-
     /**
      * @brief calculate the prepare HR for each atom
      * pre_hr^I = \sum_{lm}<phi_mu|alpha^I_{lm}><alpha^I_{lm}|phi_{nu,R}>
@@ -111,34 +103,6 @@ class DeltaSpin<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
                         const int col_size,
                         double* moment);
 
-    /**
-     * @brief calculate the atomic Force of <I,J,R> atom pair
-     */
-    void cal_force_IJR(const int& iat1,
-                       const int& iat2,
-                       const Parallel_Orbitals* paraV,
-                       const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                       const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                       const hamilt::BaseMatrix<double>* dmR_pointer,
-                       const ModuleBase::Vector3<double>& lambda,
-                       const int nspin,
-                       double* force1,
-                       double* force2);
-    /**
-     * @brief calculate the Stress of <I,J,R> atom pair
-     */
-    void cal_stress_IJR(const int& iat1,
-                        const int& iat2,
-                        const Parallel_Orbitals* paraV,
-                        const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                        const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                        const hamilt::BaseMatrix<double>* dmR_pointer,
-                        const ModuleBase::Vector3<double>& lambda,
-                        const int nspin,
-                        const ModuleBase::Vector3<double>& dis1,
-                        const ModuleBase::Vector3<double>& dis2,
-                        double* stress);
-
     /**
      * @brief calculate the array of coefficient of lambda * d\rho^p/drho^{\sigma\sigma'}
     */
@@ -25,7 +25,9 @@ hamilt::EkineticNew<hamilt::OperatorLCAO<TK, TR>>::EkineticNew(
     assert(this->hsk != nullptr);
 #endif
     // initialize HR to allocate sparse Ekinetic matrix memory
-    this->initialize_HR(GridD_in);
+    this->initialize_HR(GridD_in, this->hR);
+    // allocate the memory of BaseMatrix in HR, and set the new values to zero
+    this->hR->allocate(nullptr, true);
 }
 
 // destructor
@@ -40,14 +42,17 @@ hamilt::EkineticNew<hamilt::OperatorLCAO<TK, TR>>::~EkineticNew()
 
 // initialize_HR()
 template <typename TK, typename TR>
-void hamilt::EkineticNew<hamilt::OperatorLCAO<TK, TR>>::initialize_HR(const Grid_Driver* GridD)
+void hamilt::EkineticNew<hamilt::OperatorLCAO<TK, TR>>::initialize_HR(const Grid_Driver* GridD,
+                                                                     hamilt::HContainer<TR>* hR_in)
 {
     ModuleBase::TITLE("EkineticNew", "initialize_HR");
     ModuleBase::timer::tick("EkineticNew", "initialize_HR");
 
-    auto* paraV = this->hR->get_paraV();// get parallel orbitals from HR
+    auto* paraV = hR_in->get_paraV();// get parallel orbitals from HR
     // TODO: if paraV is nullptr, AtomPair can not use paraV for constructor, I will repair it in the future.
 
+    this->adjs_all.clear();
+    this->adjs_all.reserve(this->ucell->nat);
     for (int iat1 = 0; iat1 < ucell->nat; iat1++)
     {
         auto tau1 = ucell->get_tau(iat1);
@@ -86,15 +91,30 @@ void hamilt::EkineticNew<hamilt::OperatorLCAO<TK, TR>>::initialize_HR(const Grid
             int iat2 = ucell->itia2iat(T2, I2);
             ModuleBase::Vector3<int>& R_index = adjs.box[ad];
             hamilt::AtomPair<TR> tmp(iat1, iat2, R_index, paraV);
-            this->hR->insert_pair(tmp);
+            hR_in->insert_pair(tmp);
         }
     }
-    // allocate the memory of BaseMatrix in HR, and set the new values to zero
-    this->hR->allocate(nullptr, true);
 
     ModuleBase::timer::tick("EkineticNew", "initialize_HR");
 }
 
+// update_neighbors()
+template <typename TK, typename TR>
+bool hamilt::EkineticNew<hamilt::OperatorLCAO<TK, TR>>::update_neighbors(const Grid_Driver* GridD_in,
+                                                                         hamilt::HContainer<TR>* hR_new)
+{
+    this->initialize_HR(GridD_in, hR_new);
+    // HR_fixed will be constructed with the new shape of HR in contributeHR()
+    if (this->allocated)
+    {
+        delete this->HR_fixed;
+        this->allocated = false;
+    }
+    this->HR_fixed = nullptr;
+    this->HR_fixed_done = false;
+    return true;
+}
+
 template <typename TK, typename TR>
 void hamilt::EkineticNew<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
 {
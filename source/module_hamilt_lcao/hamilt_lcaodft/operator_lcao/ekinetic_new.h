@@ -61,6 +61,11 @@ class EkineticNew<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
 
     virtual void set_HR_fixed(void*) override;
 
+    /**
+     * @brief search the new atom-pairs for the moved atoms, HR_fixed will be calculated again
+     */
+    virtual bool update_neighbors(const Grid_Driver* GridD_in, HContainer<TR>* hR_new) override;
+
   private:
     const UnitCell* ucell = nullptr;
     std::vector<double> orb_cutoff_;
@@ -76,9 +81,9 @@ class EkineticNew<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
     /**
      * @brief initialize HR, search the nearest neighbor atoms
      * HContainer is used to store the electronic kinetic matrix with specific <I,J,R> atom-pairs
-     * the size of HR will be fixed after initialization
+     * the atom-pairs are inserted into hR_in, which should be allocated after initialization
      */
-    void initialize_HR(const Grid_Driver* GridD_in);
+    void initialize_HR(const Grid_Driver* GridD_in, hamilt::HContainer<TR>* hR_in);
 
     /**
      * @brief calculate the electronic kinetic matrix with specific <I,J,R> atom-pairs
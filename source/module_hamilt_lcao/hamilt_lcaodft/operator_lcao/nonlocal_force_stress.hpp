@@ -63,7 +63,12 @@ void NonlocalNew<OperatorLCAO<TK, TR>>::cal_force_stress(const bool cal_force,
         }
         filter_adjs(is_adj, adjs);
 
-        std::vector<std::unordered_map<int, std::vector<double>>> nlm_iat0(adjs.adj_num + 1);
+        const int nproj = this->ucell->atoms[T0].ncpp.nh;
+        std::vector<TR> d_data;
+        std::vector<const TR*> d;
+        this->get_d_matrices(T0, d_data, d);
+
+        std::vector<ProjectorMatrix> nlm_iat0(adjs.adj_num + 1);
         for (int ad = 0; ad < adjs.adj_num + 1; ++ad)
         {
             const int T1 = adjs.ntype[ad];
@@ -72,15 +77,13 @@ void NonlocalNew<OperatorLCAO<TK, TR>>::cal_force_stress(const bool cal_force,
             const ModuleBase::Vector3<double>& tau1 = adjs.adjacent_tau[ad];
             const Atom* atom1 = &ucell->atoms[T1];
 
-            auto all_indexes = paraV->get_indexes_row(iat1);
-            auto col_indexes = paraV->get_indexes_col(iat1);
-            // insert col_indexes into all_indexes to get universal set with no repeat elements
-            all_indexes.insert(all_indexes.end(), col_indexes.begin(), col_indexes.end());
-            std::sort(all_indexes.begin(), all_indexes.end());
-            all_indexes.erase(std::unique(all_indexes.begin(), all_indexes.end()), all_indexes.end());
-            for (int iw1l = 0; iw1l < all_indexes.size(); iw1l += npol)
+            // the projections and their gradients
+            nlm_iat0[ad] = ProjectorMatrix(paraV->get_indexes_row(iat1), paraV->get_indexes_col(iat1), npol, nproj, 4);
+            const std::vector<int>& orbitals = nlm_iat0[ad].get_orbitals();
+            std::vector<double> nlm_target(nproj * 4);
+            for (int io = 0; io < orbitals.size(); io++)
             {
-                const int iw1 = all_indexes[iw1l] / npol;
+                const int iw1 = orbitals[io] / npol;
                 std::vector<std::vector<double>> nlm;
                 // nlm is a vector of vectors, but size of outer vector is only 1 here
                 // If we are calculating force, we need also to store the gradient
@@ -95,20 +98,17 @@ void NonlocalNew<OperatorLCAO<TK, TR>>::cal_force_stress(const bool cal_force,
 
                 ModuleBase::Vector3<double> dtau = tau0 - tau1;
                 intor_->snap(T1, L1, N1, M1, T0, dtau * this->ucell->lat0, true /*cal_deri*/, nlm);
-                // select the elements of nlm with target_L
-                const int length = nlm[0].size();
-                std::vector<double> nlm_target(length * 4);
                 // rearrange the nlm_target to store the gradient
-                for(int index =0;index < length; index++)
+                for (int index = 0; index < nproj; index++)
                 {
                     for (int n = 0; n < 4; n++) // value, deri_x, deri_y, deri_z
                     {
-                        nlm_target[index + n * length] = nlm[n][index];
+                        nlm_target[index + n * nproj] = nlm[n][index];
                     }
                 }
-                nlm_iat0[ad].insert({all_indexes[iw1l], nlm_target});
+                nlm_iat0[ad].set(io, nlm_target);
             }
-        }      
+        }
 
         // second iteration to calculate force and stress
         for (int ad1 = 0; ad1 < adjs.adj_num + 1; ++ad1)
@@ -140,31 +140,35 @@ void NonlocalNew<OperatorLCAO<TK, TR>>::cal_force_stress(const bool cal_force,
                 // if not found , skip this pair of atoms
                 if (tmp != nullptr)
                 {
+                    // the gradients with respect to the positions of iat1 and iat2
+                    double g1[3] = {0.0, 0.0, 0.0};
+                    double g2[3] = {0.0, 0.0, 0.0};
+                    contract_gradients(nlm_iat0[ad1],
+                                       nlm_iat0[ad2],
+                                       d,
+                                       npol,
+                                       tmp->get_pointer(),
+                                       g1,
+                                       cal_stress ? g2 : nullptr);
                     // calculate force
-                    if (cal_force) {
-                        this->cal_force_IJR(iat1,
-                                            iat2,
-                                            T0,
-                                            paraV,
-                                            nlm_iat0[ad1],
-                                            nlm_iat0[ad2],
-                                            tmp,
-                                            force_tmp1,
-                                            force_tmp2);
+                    if (cal_force)
+                    {
+                        for (int i = 0; i < 3; i++)
+                        {
+                            force_tmp1[i] += g1[i];
+                            force_tmp2[i] -= g1[i];
+                        }
                     }
 
                     // calculate stress
-                    if (cal_stress) {
-                        this->cal_stress_IJR(iat1,
-                                             iat2,
-                                             T0,
-                                             paraV,
-                                             nlm_iat0[ad1],
-                                             nlm_iat0[ad2],
-                                             tmp,
-                                             dis1,
-                                             dis2,
-                                             stress_local.data());
+                    if (cal_stress)
+                    {
+                        stress_local[0] += g1[0] * dis1.x + g2[0] * dis2.x;
+                        stress_local[1] += g1[0] * dis1.y + g2[0] * dis2.y;
+                        stress_local[2] += g1[0] * dis1.z + g2[0] * dis2.z;
+                        stress_local[3] += g1[1] * dis1.y + g2[1] * dis2.y;
+                        stress_local[4] += g1[1] * dis1.z + g2[1] * dis2.z;
+                        stress_local[5] += g1[2] * dis1.z + g2[2] * dis2.z;
                     }
                 }
             }
@@ -222,248 +226,4 @@ void NonlocalNew<OperatorLCAO<TK, TR>>::cal_force_stress(const bool cal_force,
     ModuleBase::timer::tick("NonlocalNew", "cal_force_stress");
 }
 
-template <>
-void NonlocalNew<OperatorLCAO<std::complex<double>, std::complex<double>>>::cal_force_IJR(const int& iat1,
-                                               const int& iat2,
-                                               const int& T0,
-                                               const Parallel_Orbitals* paraV,
-                                               const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                                               const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                                               const hamilt::BaseMatrix<std::complex<double>>* dmR_pointer,
-                                               double* force1,
-                                               double* force2)
-{
-    // npol is the number of polarizations,
-    // 1 for non-magnetic (one Hamiltonian matrix only has spin-up or spin-down),
-    // 2 for magnetic (one Hamiltonian matrix has both spin-up and spin-down)
-    const int npol = this->ucell->get_npol();
-    // ---------------------------------------------
-    // calculate the Nonlocal matrix for each pair of orbitals
-    // ---------------------------------------------
-    auto row_indexes = paraV->get_indexes_row(iat1);
-    auto col_indexes = paraV->get_indexes_col(iat2);
-    // step_trace = 0 for NSPIN=2; ={0, 1, local_col, local_col+1} for NSPIN=4
-    std::vector<int> step_trace(npol * npol, 0);
-    if (npol == 2) {
-        step_trace[1] = 1;
-        step_trace[2] = col_indexes.size();
-        step_trace[3] = col_indexes.size() + 1;
-    }
-    // calculate the local matrix
-    const std::complex<double>* tmp_d = nullptr;
-    const std::complex<double>* dm_pointer = dmR_pointer->get_pointer();
-    for (int iw1l = 0; iw1l < row_indexes.size(); iw1l += npol)
-    {
-        const std::vector<double>& nlm1 = nlm1_all.find(row_indexes[iw1l])->second;
-        const int length = nlm1.size() / 4;
-        for (int iw2l = 0; iw2l < col_indexes.size(); iw2l += npol)
-        {
-            const std::vector<double>& nlm2 = nlm2_all.find(col_indexes[iw2l])->second;
-#ifdef __DEBUG
-            assert(nlm1.size() == nlm2.size());
-#endif
-            std::vector<std::complex<double>> nlm_tmp(12, ModuleBase::ZERO);
-            for (int is = 0; is < 4; ++is)
-            {
-                for (int no = 0; no < this->ucell->atoms[T0].ncpp.non_zero_count_soc[is]; no++)
-                {
-                    const int p1 = this->ucell->atoms[T0].ncpp.index1_soc[is][no];
-                    const int p2 = this->ucell->atoms[T0].ncpp.index2_soc[is][no];
-                    this->ucell->atoms[T0].ncpp.get_d(is, p1, p2, tmp_d);
-                    nlm_tmp[is*3] +=  nlm1[p1 + length] * nlm2[p2] * (*tmp_d);
-                    nlm_tmp[is*3+1] += nlm1[p1 + length * 2] * nlm2[p2] * (*tmp_d);
-                    nlm_tmp[is*3+2] += nlm1[p1 + length * 3] * nlm2[p2] * (*tmp_d);
-                }
-            }
-            // calculate the force, transfer nlm_tmp to pauli matrix
-            for(int i = 0; i < 3; i++)
-            {
-                double tmp = (dm_pointer[step_trace[0]] * nlm_tmp[i] 
-                        + dm_pointer[step_trace[1]] * nlm_tmp[i+3]
-                        + dm_pointer[step_trace[2]] * nlm_tmp[i+6]
-                        + dm_pointer[step_trace[3]] * nlm_tmp[i+9]).real();
-                force1[i] += tmp;
-                force2[i] -= tmp;
-            }
-            dm_pointer += npol;
-        }
-        dm_pointer += (npol - 1) * col_indexes.size();
-    }
-}
-
-template <>
-void NonlocalNew<OperatorLCAO<std::complex<double>, std::complex<double>>>::cal_stress_IJR(const int& iat1,
-                                                const int& iat2,
-                                                const int& T0,
-                                                const Parallel_Orbitals* paraV,
-                                                const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                                                const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                                                const hamilt::BaseMatrix<std::complex<double>>* dmR_pointer,
-                                                const ModuleBase::Vector3<double>& dis1,
-                                                const ModuleBase::Vector3<double>& dis2,
-                                                double* stress)
-{
-    // npol is the number of polarizations,
-    // 1 for non-magnetic (one Hamiltonian matrix only has spin-up or spin-down),
-    // 2 for magnetic (one Hamiltonian matrix has both spin-up and spin-down)
-    const int npol = this->ucell->get_npol();
-    const int npol2 = npol * npol;
-    // ---------------------------------------------
-    // calculate the Nonlocal matrix for each pair of orbitals
-    // ---------------------------------------------
-    auto row_indexes = paraV->get_indexes_row(iat1);
-    auto col_indexes = paraV->get_indexes_col(iat2);
-    // step_trace = 0 for NSPIN=2; ={0, 1, local_col, local_col+1} for NSPIN=4
-    std::vector<int> step_trace(npol2, 0);
-    if (npol == 2) {
-        step_trace[1] = 1;
-        step_trace[2] = col_indexes.size();
-        step_trace[3] = col_indexes.size() + 1;
-    }
-    // calculate the local matrix
-    const std::complex<double>* tmp_d = nullptr;
-    const std::complex<double>* dm_pointer = dmR_pointer->get_pointer();
-    for (int iw1l = 0; iw1l < row_indexes.size(); iw1l += npol)
-    {
-        const std::vector<double>& nlm1 = nlm1_all.find(row_indexes[iw1l])->second;
-        const int length = nlm1.size() / npol2;
-        for (int iw2l = 0; iw2l < col_indexes.size(); iw2l += npol)
-        {
-            const std::vector<double>& nlm2 = nlm2_all.find(col_indexes[iw2l])->second;
-#ifdef __DEBUG
-            assert(nlm1.size() == nlm2.size());
-#endif
-            std::vector<std::complex<double>> nlm_tmp(npol2 * 6, ModuleBase::ZERO);
-            for (int is = 0; is < 4; ++is)
-            {
-                for (int no = 0; no < this->ucell->atoms[T0].ncpp.non_zero_count_soc[is]; no++)
-                {
-                    const int p1 = this->ucell->atoms[T0].ncpp.index1_soc[is][no];
-                    const int p2 = this->ucell->atoms[T0].ncpp.index2_soc[is][no];
-                    this->ucell->atoms[T0].ncpp.get_d(is, p1, p2, tmp_d);
-                    nlm_tmp[is*6] += (nlm1[p1 + length] * dis1.x * nlm2[p2] + nlm1[p1] * nlm2[p2 + length] * dis2.x) * (*tmp_d);
-                    nlm_tmp[is*6+1] += (nlm1[p1 + length] * dis1.y * nlm2[p2] + nlm1[p1] * nlm2[p2 + length] * dis2.y) * (*tmp_d);
-                    nlm_tmp[is*6+2] += (nlm1[p1 + length] * dis1.z * nlm2[p2] + nlm1[p1] * nlm2[p2 + length] * dis2.z) * (*tmp_d);
-                    nlm_tmp[is*6+3] += (nlm1[p1 + length * 2] * dis1.y * nlm2[p2] + nlm1[p1] * nlm2[p2 + length * 2] * dis2.y) * (*tmp_d);
-                    nlm_tmp[is*6+4] += (nlm1[p1 + length * 2] * dis1.z * nlm2[p2] + nlm1[p1] * nlm2[p2 + length * 2] * dis2.z) * (*tmp_d);
-                    nlm_tmp[is*6+5] += (nlm1[p1 + length * 3] * dis1.z * nlm2[p2] + nlm1[p1] * nlm2[p2 + length * 3] * dis2.z) * (*tmp_d);
-                }
-            }
-            // calculate the force, transfer nlm_tmp to pauli matrix
-            for(int i = 0; i < 6; i++)
-            {
-                stress[i] += (dm_pointer[step_trace[0]] * nlm_tmp[i] 
-                        + dm_pointer[step_trace[1]] * nlm_tmp[i+6]
-                        + dm_pointer[step_trace[2]] * nlm_tmp[i+12]
-                        + dm_pointer[step_trace[3]] * nlm_tmp[i+18]).real();
-            }
-            dm_pointer += npol;
-        }
-        dm_pointer += (npol - 1) * col_indexes.size();
-    }
-}
-
-template <typename TK, typename TR>
-void NonlocalNew<OperatorLCAO<TK, TR>>::cal_force_IJR(const int& iat1,
-                                               const int& iat2,
-                                               const int& T0,
-                                               const Parallel_Orbitals* paraV,
-                                               const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                                               const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                                               const hamilt::BaseMatrix<TR>* dmR_pointer,
-                                               double* force1,
-                                               double* force2)
-{
-    // ---------------------------------------------
-    // calculate the Nonlocal matrix for each pair of orbitals
-    // ---------------------------------------------
-    auto row_indexes = paraV->get_indexes_row(iat1);
-    auto col_indexes = paraV->get_indexes_col(iat2);
-    // calculate the local matrix
-    const double* tmp_d = nullptr;
-    const double* dm_pointer = dmR_pointer->get_pointer();
-    for (int iw1l = 0; iw1l < row_indexes.size(); iw1l++)
-    {
-        const std::vector<double>& nlm1 = nlm1_all.find(row_indexes[iw1l])->second;
-        const int length = nlm1.size() / 4;
-        for (int iw2l = 0; iw2l < col_indexes.size(); iw2l++)
-        {
-            const std::vector<double>& nlm2 = nlm2_all.find(col_indexes[iw2l])->second;
-#ifdef __DEBUG
-            assert(nlm1.size() == nlm2.size());
-#endif
-            std::vector<double> nlm_tmp(3, 0.0);
-            for (int no = 0; no < this->ucell->atoms[T0].ncpp.non_zero_count_soc[0]; no++)
-            {
-                const int p1 = this->ucell->atoms[T0].ncpp.index1_soc[0][no];
-                const int p2 = this->ucell->atoms[T0].ncpp.index2_soc[0][no];
-                this->ucell->atoms[T0].ncpp.get_d(0, p1, p2, tmp_d);
-                nlm_tmp[0] += nlm1[p1 + length] * nlm2[p2] * (*tmp_d);
-                nlm_tmp[1] += nlm1[p1 + length * 2] * nlm2[p2] * (*tmp_d);
-                nlm_tmp[2] += nlm1[p1 + length * 3] * nlm2[p2] * (*tmp_d);
-            }
-            // calculate the force, transfer nlm_tmp to pauli matrix
-            for(int i = 0; i < 3; i++)
-            {
-                force1[i] += dm_pointer[0] * nlm_tmp[i];
-                force2[i] -= dm_pointer[0] * nlm_tmp[i];
-            }
-            dm_pointer++;
-        }
-    }
-}
-
-template <typename TK, typename TR>
-void NonlocalNew<OperatorLCAO<TK, TR>>::cal_stress_IJR(const int& iat1,
-                                                const int& iat2,
-                                                const int& T0,
-                                                const Parallel_Orbitals* paraV,
-                                                const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                                                const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                                                const hamilt::BaseMatrix<TR>* dmR_pointer,
-                                                const ModuleBase::Vector3<double>& dis1,
-                                                const ModuleBase::Vector3<double>& dis2,
-                                                double* stress)
-{
-    // ---------------------------------------------
-    // calculate the Nonlocal matrix for each pair of orbitals
-    // ---------------------------------------------
-    auto row_indexes = paraV->get_indexes_row(iat1);
-    auto col_indexes = paraV->get_indexes_col(iat2);
-    // calculate the local matrix
-    const double* tmp_d = nullptr;
-    const double* dm_pointer = dmR_pointer->get_pointer();
-    for (int iw1l = 0; iw1l < row_indexes.size(); iw1l++)
-    {
-        const std::vector<double>& nlm1 = nlm1_all.find(row_indexes[iw1l])->second;
-        const int length = nlm1.size() / 4;
-        for (int iw2l = 0; iw2l < col_indexes.size(); iw2l++)
-        {
-            const std::vector<double>& nlm2 = nlm2_all.find(col_indexes[iw2l])->second;
-#ifdef __DEBUG
-            assert(nlm1.size() == nlm2.size());
-#endif
-            std::vector<double> nlm_tmp(6, 0.0);
-            for (int no = 0; no < this->ucell->atoms[T0].ncpp.non_zero_count_soc[0]; no++)
-            {
-                const int p1 = this->ucell->atoms[T0].ncpp.index1_soc[0][no];
-                const int p2 = this->ucell->atoms[T0].ncpp.index2_soc[0][no];
-                this->ucell->atoms[T0].ncpp.get_d(0, p1, p2, tmp_d);
-                nlm_tmp[0] += (nlm1[p1 + length] * dis1.x * nlm2[p2] + nlm1[p1] * nlm2[p2 + length] * dis2.x) * (*tmp_d);
-                nlm_tmp[1] += (nlm1[p1 + length] * dis1.y * nlm2[p2] + nlm1[p1] * nlm2[p2 + length] * dis2.y) * (*tmp_d);
-                nlm_tmp[2] += (nlm1[p1 + length] * dis1.z * nlm2[p2] + nlm1[p1] * nlm2[p2 + length] * dis2.z) * (*tmp_d);
-                nlm_tmp[3] += (nlm1[p1 + length * 2] * dis1.y * nlm2[p2] + nlm1[p1] * nlm2[p2 + length * 2] * dis2.y) * (*tmp_d);
-                nlm_tmp[4] += (nlm1[p1 + length * 2] * dis1.z * nlm2[p2] + nlm1[p1] * nlm2[p2 + length * 2] * dis2.z) * (*tmp_d);
-                nlm_tmp[5] += (nlm1[p1 + length * 3] * dis1.z * nlm2[p2] + nlm1[p1] * nlm2[p2 + length * 3] * dis2.z) * (*tmp_d);
-            }
-            // calculate the force, transfer nlm_tmp to pauli matrix
-            for(int i = 0; i < 6; i++)
-            {
-                stress[i] += dm_pointer[0] * nlm_tmp[i];
-            }
-            dm_pointer++;
-        }
-    }
-}
-
 } // namespace hamilt
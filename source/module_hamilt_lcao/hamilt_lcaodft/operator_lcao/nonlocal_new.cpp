@@ -29,7 +29,9 @@ hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::NonlocalNew(
     // initialize HR to allocate sparse Nonlocal matrix memory
     if(hR_in != nullptr) 
     {
-        this->initialize_HR(GridD_in);
+        this->initialize_HR(GridD_in, this->hR);
+        // allocate the memory of BaseMatrix in HR, and set the new values to zero
+        this->hR->allocate(nullptr, true);
     }
 }
 
@@ -45,12 +47,13 @@ hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::~NonlocalNew()
 
 // initialize_HR()
 template <typename TK, typename TR>
-void hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::initialize_HR(const Grid_Driver* GridD)
+void hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::initialize_HR(const Grid_Driver* GridD,
+                                                                     hamilt::HContainer<TR>* hR_in)
 {
     ModuleBase::TITLE("NonlocalNew", "initialize_HR");
     ModuleBase::timer::tick("NonlocalNew", "initialize_HR");
 
-    auto* paraV = this->hR->get_paraV();// get parallel orbitals from HR
+    auto* paraV = hR_in->get_paraV();// get parallel orbitals from HR
     // TODO: if paraV is nullptr, AtomPair can not use paraV for constructor, I will repair it in the future.
 
     this->adjs_all.clear();
@@ -104,16 +107,31 @@ void hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::initialize_HR(const Grid
                                          R_index2.y - R_index1.y,
                                          R_index2.z - R_index1.z,
                                          paraV);
-                this->hR->insert_pair(tmp);
+                hR_in->insert_pair(tmp);
             }
         }
     }
-    // allocate the memory of BaseMatrix in HR, and set the new values to zero
-    this->hR->allocate(nullptr, true);
 
     ModuleBase::timer::tick("NonlocalNew", "initialize_HR");
 }
 
+// update_neighbors()
+template <typename TK, typename TR>
+bool hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::update_neighbors(const Grid_Driver* GridD_in,
+                                                                         hamilt::HContainer<TR>* hR_new)
+{
+    this->initialize_HR(GridD_in, hR_new);
+    // HR_fixed will be constructed with the new shape of HR in contributeHR()
+    if (this->allocated)
+    {
+        delete this->HR_fixed;
+        this->allocated = false;
+    }
+    this->HR_fixed = nullptr;
+    this->HR_fixed_done = false;
+    return true;
+}
+
 template <typename TK, typename TR>
 void hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
 {
@@ -140,8 +158,12 @@ void hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
             ucell->iat2iait(iat0, &I0, &T0);
             AdjacentAtomInfo& adjs = this->adjs_all[iat0];
 
-            std::vector<std::unordered_map<int, std::vector<double>>> nlm_tot;
-            nlm_tot.resize(adjs.adj_num + 1);
+            const int nproj = this->ucell->atoms[T0].ncpp.nh;
+            std::vector<TR> d_data;
+            std::vector<const TR*> d;
+            this->get_d_matrices(T0, d_data, d);
+
+            std::vector<ProjectorMatrix> nlm_tot(adjs.adj_num + 1);
 
             for (int ad = 0; ad < adjs.adj_num + 1; ++ad)
             {
@@ -151,21 +173,18 @@ void hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
                 const ModuleBase::Vector3<double>& tau1 = adjs.adjacent_tau[ad];
                 const Atom* atom1 = &ucell->atoms[T1];
 
-                auto all_indexes = paraV->get_indexes_row(iat1);
+                auto row_indexes = paraV->get_indexes_row(iat1);
 #ifdef _OPENMP
                 if (atom_row_list.find(iat1) == atom_row_list.end())
                 {
-                    all_indexes.clear();
+                    row_indexes.clear();
                 }
 #endif
-                auto col_indexes = paraV->get_indexes_col(iat1);
-                // insert col_indexes into all_indexes to get universal set with no repeat elements
-                all_indexes.insert(all_indexes.end(), col_indexes.begin(), col_indexes.end());
-                std::sort(all_indexes.begin(), all_indexes.end());
-                all_indexes.erase(std::unique(all_indexes.begin(), all_indexes.end()), all_indexes.end());
-                for (int iw1l = 0; iw1l < all_indexes.size(); iw1l += npol)
+                nlm_tot[ad] = ProjectorMatrix(row_indexes, paraV->get_indexes_col(iat1), npol, nproj);
+                const std::vector<int>& orbitals = nlm_tot[ad].get_orbitals();
+                for (int io = 0; io < orbitals.size(); io++)
                 {
-                    const int iw1 = all_indexes[iw1l] / npol;
+                    const int iw1 = orbitals[io] / npol;
                     std::vector<std::vector<double>> nlm;
                     // nlm is a vector of vectors, but size of outer vector is only 1 here
                     // If we are calculating force, we need also to store the gradient
@@ -180,7 +199,7 @@ void hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
 
                     ModuleBase::Vector3<double> dtau = tau0 - tau1;
                     intor_->snap(T1, L1, N1, M1, T0, dtau * this->ucell->lat0, false /*cal_deri*/, nlm);
-                    nlm_tot[ad].insert({all_indexes[iw1l], nlm[0]});
+                    nlm_tot[ad].set(io, nlm[0]);
                 }
             }
             // 2. calculate <psi_I|beta>D<beta|psi_{J,R}> for each pair of <IJR> atoms
@@ -210,7 +229,7 @@ void hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
                     // if not found , skip this pair of atoms
                     if (tmp != nullptr)
                     {
-                        this->cal_HR_IJR(iat1, iat2, T0, paraV, nlm_tot[ad1], nlm_tot[ad2], tmp->get_pointer());
+                        contract_projectors(nlm_tot[ad1], nlm_tot[ad2], d, npol, tmp->get_pointer());
                     }
                 }
             }
@@ -222,63 +241,30 @@ void hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
     ModuleBase::timer::tick("NonlocalNew", "calculate_HR");
 }
 
-// cal_HR_IJR()
+// get_d_matrices()
 template <typename TK, typename TR>
-void hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::cal_HR_IJR(
-    const int& iat1,
-    const int& iat2,
-    const int& T0,
-    const Parallel_Orbitals* paraV,
-    const std::unordered_map<int, std::vector<double>>& nlm1_all,
-    const std::unordered_map<int, std::vector<double>>& nlm2_all,
-    TR* data_pointer)
+void hamilt::NonlocalNew<hamilt::OperatorLCAO<TK, TR>>::get_d_matrices(const int T0,
+                                                                        std::vector<TR>& d_data,
+                                                                        std::vector<const TR*>& d) const
 {
-
     // npol is the number of polarizations,
     // 1 for non-magnetic (one Hamiltonian matrix only has spin-up or spin-down),
     // 2 for magnetic (one Hamiltonian matrix has both spin-up and spin-down)
     const int npol = this->ucell->get_npol();
-    // ---------------------------------------------
-    // calculate the Nonlocal matrix for each pair of orbitals
-    // ---------------------------------------------
-    double olm[3] = {0, 0, 0};
-    auto row_indexes = paraV->get_indexes_row(iat1);
-    auto col_indexes = paraV->get_indexes_col(iat2);
-    // step_trace = 0 for NSPIN=1,2; ={0, 1, local_col, local_col+1} for NSPIN=4
-    std::vector<int> step_trace(npol * npol, 0);
-    for (int is = 0; is < npol; is++)
-    {
-        for (int is2 = 0; is2 < npol; is2++)
-        {
-            step_trace[is * npol + is2] = col_indexes.size() * is + is2;
-        }
-    }
-    // calculate the local matrix
+    const int nproj = this->ucell->atoms[T0].ncpp.nh;
+    d_data.assign(npol * npol * nproj * nproj, TR(0));
+    d.assign(npol * npol, nullptr);
     const TR* tmp_d = nullptr;
-    for (int iw1l = 0; iw1l < row_indexes.size(); iw1l += npol)
+    for (int is = 0; is < npol * npol; ++is)
     {
-        const std::vector<double>& nlm1 = nlm1_all.find(row_indexes[iw1l])->second;
-        for (int iw2l = 0; iw2l < col_indexes.size(); iw2l += npol)
+        for (int no = 0; no < this->ucell->atoms[T0].ncpp.non_zero_count_soc[is]; no++)
         {
-            const std::vector<double>& nlm2 = nlm2_all.find(col_indexes[iw2l])->second;
-#ifdef __DEBUG
-            assert(nlm1.size() == nlm2.size());
-#endif
-            for (int is = 0; is < npol * npol; ++is)
-            {
-                TR nlm_tmp = TR(0);
-                for (int no = 0; no < this->ucell->atoms[T0].ncpp.non_zero_count_soc[is]; no++)
-                {
-                    const int p1 = this->ucell->atoms[T0].ncpp.index1_soc[is][no];
-                    const int p2 = this->ucell->atoms[T0].ncpp.index2_soc[is][no];
-                    this->ucell->atoms[T0].ncpp.get_d(is, p1, p2, tmp_d);
-                    nlm_tmp += nlm1[p1] * nlm2[p2] * (*tmp_d);
-                }
-                data_pointer[step_trace[is]] += nlm_tmp;
-            }
-            data_pointer += npol;
+            const int p1 = this->ucell->atoms[T0].ncpp.index1_soc[is][no];
+            const int p2 = this->ucell->atoms[T0].ncpp.index2_soc[is][no];
+            this->ucell->atoms[T0].ncpp.get_d(is, p1, p2, tmp_d);
+            d_data[(is * nproj + p1) * nproj + p2] = *tmp_d;
+            d[is] = &d_data[is * nproj * nproj];
         }
-        data_pointer += (npol - 1) * col_indexes.size();
     }
 }
 
@@ -5,6 +5,7 @@
 #include "module_cell/module_neighbor/sltk_grid_driver.h"
 #include "module_cell/unitcell.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/operator_lcao/operator_lcao.h"
+#include "module_hamilt_lcao/hamilt_lcaodft/operator_lcao/projector_contraction.h"
 #include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
 
 #include <unordered_map>
@@ -62,6 +63,11 @@ class NonlocalNew<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
 
     virtual void set_HR_fixed(void*) override;
 
+    /**
+     * @brief search the new atom-pairs for the moved atoms, HR_fixed will be calculated again
+     */
+    virtual bool update_neighbors(const Grid_Driver* GridD_in, HContainer<TR>* hR_new) override;
+
   private:
     const UnitCell* ucell = nullptr;
 
@@ -79,9 +85,9 @@ class NonlocalNew<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
     /**
      * @brief initialize HR, search the nearest neighbor atoms
      * HContainer is used to store the non-local pseudopotential matrix with specific <I,J,R> atom-pairs
-     * the size of HR will be fixed after initialization
+     * the atom-pairs are inserted into hR_in, which should be allocated after initialization
      */
-    void initialize_HR(const Grid_Driver* GridD_in);
+    void initialize_HR(const Grid_Driver* GridD_in, hamilt::HContainer<TR>* hR_in);
 
     /**
      * @brief calculate the non-local pseudopotential matrix with specific <I,J,R> atom-pairs
@@ -91,44 +97,13 @@ class NonlocalNew<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
     void calculate_HR();
 
     /**
-     * @brief calculate the HR local matrix of <I,J,R> atom pair
+     * @brief the D matrices of the projectors of atom type T0 as dense nh x nh matrices for contract_projectors
+     * d[is] points into d_data for the npol*npol spin components, nullptr for the components without D
      */
-    void cal_HR_IJR(const int& iat1,
-                    const int& iat2,
-                    const int& T0,
-                    const Parallel_Orbitals* paraV,
-                    const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                    const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                    TR* data_pointer);
+    void get_d_matrices(const int T0, std::vector<TR>& d_data, std::vector<const TR*>& d) const;
 
     const Grid_Driver* gridD = nullptr;
 
-    /**
-     * @brief calculate the atomic Force of <I,J,R> atom pair
-     */
-    void cal_force_IJR(const int& iat1,
-                       const int& iat2,
-                       const int& T0,
-                       const Parallel_Orbitals* paraV,
-                       const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                       const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                       const hamilt::BaseMatrix<TR>* dmR_pointer,
-                       double* force1,
-                       double* force2);
-    /**
-     * @brief calculate the Stress of <I,J,R> atom pair
-     */
-    void cal_stress_IJR(const int& iat1,
-                        const int& iat2,
-                        const int& T0,
-                        const Parallel_Orbitals* paraV,
-                        const std::unordered_map<int, std::vector<double>>& nlm1_all,
-                        const std::unordered_map<int, std::vector<double>>& nlm2_all,
-                        const hamilt::BaseMatrix<TR>* dmR_pointer,
-                        const ModuleBase::Vector3<double>& dis1,
-                        const ModuleBase::Vector3<double>& dis2,
-                        double* stress);
-
     std::vector<AdjacentAtomInfo> adjs_all;
 };
 
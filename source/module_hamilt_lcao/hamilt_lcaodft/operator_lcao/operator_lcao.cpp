@@ -76,6 +76,28 @@ void OperatorLCAO<TK, TR>::set_current_spin(const int current_spin_in)
     }
 }
 
+template <typename TK, typename TR>
+bool OperatorLCAO<TK, TR>::update_atoms(const Grid_Driver* GridD_in, HContainer<TR>* hR_new)
+{
+    if (!this->update_neighbors(GridD_in, hR_new))
+    {
+        return false;
+    }
+    this->new_e_iteration = true;
+    this->hr_done = false;
+    if (this->next_sub_op != nullptr
+        && !dynamic_cast<OperatorLCAO<TK, TR>*>(this->next_sub_op)->update_atoms(GridD_in, hR_new))
+    {
+        return false;
+    }
+    if (this->next_op != nullptr
+        && !dynamic_cast<OperatorLCAO<TK, TR>*>(this->next_op)->update_atoms(GridD_in, hR_new))
+    {
+        return false;
+    }
+    return true;
+}
+
 template <typename TK, typename TR>
 void OperatorLCAO<TK, TR>::init(const int ik_in) {
     ModuleBase::TITLE("OperatorLCAO", "init");
@@ -244,15 +266,20 @@ template <typename TK, typename TR>
 void OperatorLCAO<TK, TR>::contributeHk(int ik) {
     ModuleBase::TITLE("OperatorLCAO", "contributeHk");
     ModuleBase::timer::tick("OperatorLCAO", "contributeHk");
+    if (this->kr_phase == nullptr || !this->kr_phase->match(this->kvec_d, *this->hR))
+    {
+        this->kr_phase.reset(new KRPhase(this->kvec_d, *this->hR));
+    }
+    const std::vector<TK*> hk = {this->hsk->get_hk()};
     if(ModuleBase::GlobalFunc::IS_COLUMN_MAJOR_KS_SOLVER(PARAM.inp.ks_solver))
     {
         const int nrow = this->hsk->get_pv()->get_row_size();
-        hamilt::folding_HR(*this->hR, this->hsk->get_hk(), this->kvec_d[ik], nrow, 1);
+        hamilt::folding_HR(*this->hR, hk, *this->kr_phase, ik, nrow, 1);
     }
     else
     {
         const int ncol = this->hsk->get_pv()->get_col_size();
-        hamilt::folding_HR(*this->hR, this->hsk->get_hk(), this->kvec_d[ik], ncol, 0);
+        hamilt::folding_HR(*this->hR, hk, *this->kr_phase, ik, ncol, 0);
     }
     ModuleBase::timer::tick("OperatorLCAO", "contributeHk");
 }
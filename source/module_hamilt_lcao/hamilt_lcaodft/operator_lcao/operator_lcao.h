@@ -4,8 +4,13 @@
 #include "module_hamilt_general/matrixblock.h"
 #include "module_hamilt_general/operator.h"
 #include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
+#include "module_hamilt_lcao/module_hcontainer/hcontainer_funcs.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/hs_matrix_k.hpp"
 
+#include <memory>
+
+class Grid_Driver;
+
 namespace hamilt {
 
 template <typename TK, typename TR>
@@ -97,6 +102,20 @@ class OperatorLCAO : public Operator<TK> {
      */
     void set_current_spin(const int current_spin_in);
 
+    /**
+     * @brief update this node and the next nodes in chain table for the moved atoms,
+     * the atom-pairs of H(R) are inserted into hR_new, the shape of this->hR is updated by HamiltLCAO.
+     * @return false if any node does not support the update, then the Hamiltonian should be rebuilt
+     */
+    bool update_atoms(const Grid_Driver* GridD_in, HContainer<TR>* hR_new);
+
+    /**
+     * @brief update_neighbors() is used to follow the moved atoms without constructing the Operator again,
+     * the new atom-pairs are inserted into hR_new and the data depending on the atomic positions is reset.
+     * not supported in base class, override in the derived class if supported
+     */
+    virtual bool update_neighbors(const Grid_Driver* GridD_in, HContainer<TR>* hR_new) { return false; }
+
     // protected:
     // Hamiltonian matrices which are calculated in OperatorLCAO
     HS_Matrix_K<TK>* hsk = nullptr;
@@ -114,6 +133,9 @@ class OperatorLCAO : public Operator<TK> {
     //! if H(R) is calculated
     bool hr_done = false;
 
+    //! phases e^{ikR} of kvec_d and the R vectors of hR for contributeHk(), calculated again if hR is changed
+    std::unique_ptr<KRPhase> kr_phase;
+
   private:
 
     void get_hs_pointers();
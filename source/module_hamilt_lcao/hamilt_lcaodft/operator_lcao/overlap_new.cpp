@@ -27,16 +27,19 @@ hamilt::OverlapNew<hamilt::OperatorLCAO<TK, TR>>::OverlapNew(HS_Matrix_K<TK>* hs
     assert(this->SR != nullptr);
 #endif
     // initialize SR to allocate sparse overlap matrix memory
-    this->initialize_SR(GridD_in);
+    this->initialize_SR(GridD_in, this->SR);
+    // allocate the memory of BaseMatrix in SR, and set the new values to zero
+    this->SR->allocate(nullptr, true);
 }
 
 // initialize_SR()
 template <typename TK, typename TR>
-void hamilt::OverlapNew<hamilt::OperatorLCAO<TK, TR>>::initialize_SR(const Grid_Driver* GridD)
+void hamilt::OverlapNew<hamilt::OperatorLCAO<TK, TR>>::initialize_SR(const Grid_Driver* GridD,
+                                                                    hamilt::HContainer<TR>* SR_in)
 {
     ModuleBase::TITLE("OverlapNew", "initialize_SR");
     ModuleBase::timer::tick("OverlapNew", "initialize_SR");
-    auto* paraV = this->SR->get_paraV(); // get parallel orbitals from HR
+    auto* paraV = SR_in->get_paraV(); // get parallel orbitals from HR
     // TODO: if paraV is nullptr, AtomPair can not use paraV for constructor, I will repair it in the future.
     for (int iat1 = 0; iat1 < ucell->nat; iat1++)
     {
@@ -66,14 +69,31 @@ void hamilt::OverlapNew<hamilt::OperatorLCAO<TK, TR>>::initialize_SR(const Grid_
                 continue;
             }
             hamilt::AtomPair<TR> tmp(iat1, iat2, R_index, paraV);
-            SR->insert_pair(tmp);
+            SR_in->insert_pair(tmp);
         }
     }
-    // allocate the memory of BaseMatrix in SR, and set the new values to zero
-    SR->allocate(nullptr, true);
     ModuleBase::timer::tick("OverlapNew", "initialize_SR");
 }
 
+// update_neighbors()
+template <typename TK, typename TR>
+bool hamilt::OverlapNew<hamilt::OperatorLCAO<TK, TR>>::update_neighbors(const Grid_Driver* GridD_in,
+                                                                        hamilt::HContainer<TR>* hR_new)
+{
+    // SR is updated in place, the shape of SR is not fixed to gamma case until it is calculated again
+    hamilt::HContainer<TR> SR_new(this->SR->get_paraV());
+    this->initialize_SR(GridD_in, &SR_new);
+    if (this->SR->shape_update(SR_new) > 0)
+    {
+        this->SR->allocate(nullptr, true);
+    }
+    // calculate_SR() accumulates into SR, the kept atom pairs still hold the old values
+    this->SR->set_zero();
+    this->SR_fixed_done = false;
+    this->kvec_d_old = ModuleBase::Vector3<double>(-10, -10, -10);
+    return true;
+}
+
 template <typename TK, typename TR>
 void hamilt::OverlapNew<hamilt::OperatorLCAO<TK, TR>>::calculate_SR()
 {
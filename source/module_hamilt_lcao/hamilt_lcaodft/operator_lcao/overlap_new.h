@@ -52,6 +52,11 @@ class OverlapNew<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
 
     TK* getSk();
 
+    /**
+     * @brief search the new atom-pairs of SR for the moved atoms, SR will be calculated again
+     */
+    virtual bool update_neighbors(const Grid_Driver* GridD_in, HContainer<TR>* hR_new) override;
+
   private:
     const UnitCell* ucell = nullptr;
 
@@ -66,9 +71,9 @@ class OverlapNew<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
     /**
      * @brief initialize SR, search the nearest neighbor atoms
      * HContainer is used to store the overlap matrix with specific <I,J,R> atom-pairs
-     * the size of SR will be fixed after initialization
+     * the atom-pairs are inserted into SR_in, which should be allocated after initialization
      */
-    void initialize_SR(const Grid_Driver* GridD_in);
+    void initialize_SR(const Grid_Driver* GridD_in, hamilt::HContainer<TR>* SR_in);
 
     /**
      * @brief calculate the overlap matrix with specific <I,J,R> atom-pairs
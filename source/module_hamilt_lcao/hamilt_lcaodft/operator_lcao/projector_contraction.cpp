@@ -0,0 +1,371 @@
+#include "projector_contraction.h"
+
+#include "module_base/blas_connector.h"
+#include "module_base/tool_quit.h"
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+namespace hamilt
+{
+
+ProjectorMatrix::ProjectorMatrix(const std::vector<int>& row_indexes,
+                                 const std::vector<int>& col_indexes,
+                                 const int npol,
+                                 const int nproj,
+                                 const int ncomp)
+    : nproj(nproj), ncomp(ncomp)
+{
+    // the union of the row and column orbitals, with no repeat elements
+    std::vector<int> all_indexes = row_indexes;
+    all_indexes.insert(all_indexes.end(), col_indexes.begin(), col_indexes.end());
+    std::sort(all_indexes.begin(), all_indexes.end());
+    all_indexes.erase(std::unique(all_indexes.begin(), all_indexes.end()), all_indexes.end());
+    for (int iw = 0; iw < all_indexes.size(); iw += npol)
+    {
+        this->orbitals.push_back(all_indexes[iw]);
+    }
+
+    auto position = [this](const std::vector<int>& indexes, const int npol, std::vector<int>& pos) {
+        pos.assign(this->orbitals.size(), -1);
+        int n = 0;
+        for (int iw = 0; iw < indexes.size(); iw += npol)
+        {
+            const auto it = std::lower_bound(this->orbitals.begin(), this->orbitals.end(), indexes[iw]);
+            pos[it - this->orbitals.begin()] = n++;
+        }
+        return n;
+    };
+    this->nrow = position(row_indexes, npol, this->row_of);
+    this->ncol = position(col_indexes, npol, this->col_of);
+    this->rows.assign(this->nrow * this->get_ld(), 0.0);
+    this->cols.assign(this->ncol * this->get_ld(), 0.0);
+}
+
+void ProjectorMatrix::set(const int io, const std::vector<double>& nlm)
+{
+    const int ld = this->get_ld();
+    if (static_cast<int>(nlm.size()) != ld)
+    {
+        ModuleBase::WARNING_QUIT("ProjectorMatrix::set",
+                                 "the number of projections " + std::to_string(nlm.size())
+                                     + " does not match the projectors of the center atom "
+                                     + std::to_string(ld));
+    }
+    if (this->row_of[io] >= 0)
+    {
+        std::copy(nlm.begin(), nlm.end(), &this->rows[this->row_of[io] * ld]);
+    }
+    if (this->col_of[io] >= 0)
+    {
+        std::copy(nlm.begin(), nlm.end(), &this->cols[this->col_of[io] * ld]);
+    }
+}
+
+namespace
+{
+
+// the projections (the first nproj values of each row) of n orbitals as a matrix of T, with its leading dimension
+const double* value_matrix(const double* nlm,
+                           const int n,
+                           const int ld,
+                           const int nproj,
+                           std::vector<double>& buffer,
+                           int& ld_out)
+{
+    ld_out = ld;
+    return nlm;
+}
+
+const std::complex<double>* value_matrix(const double* nlm,
+                                         const int n,
+                                         const int ld,
+                                         const int nproj,
+                                         std::vector<std::complex<double>>& buffer,
+                                         int& ld_out)
+{
+    buffer.resize(n * nproj);
+    for (int i = 0; i < n; i++)
+    {
+        for (int p = 0; p < nproj; p++)
+        {
+            buffer[i * nproj + p] = nlm[i * ld + p];
+        }
+    }
+    ld_out = nproj;
+    return buffer.data();
+}
+
+inline double real_part(const double& x)
+{
+    return x;
+}
+
+inline double real_part(const std::complex<double>& x)
+{
+    return x.real();
+}
+
+// the spin component is of a block with the layout of HContainer, the block itself if npol is 1
+template <typename T>
+const T* spin_block(const T* m, const int nrow, const int ncol, const int npol, const int is, std::vector<T>& buffer)
+{
+    if (npol == 1)
+    {
+        return m;
+    }
+    buffer.resize(nrow * ncol);
+    const int is1 = is / npol;
+    const int is2 = is % npol;
+    for (int i = 0; i < nrow; i++)
+    {
+        const T* row = m + (i * npol + is1) * ncol * npol + is2;
+        for (int j = 0; j < ncol; j++)
+        {
+            buffer[i * ncol + j] = row[j * npol];
+        }
+    }
+    return buffer.data();
+}
+
+// m += c for the spin component is of a block with the layout of HContainer
+template <typename TC, typename T>
+void add_spin_block(const TC* c, const int nrow, const int ncol, const int npol, const int is, T* m)
+{
+    const int is1 = is / npol;
+    const int is2 = is % npol;
+    for (int i = 0; i < nrow; i++)
+    {
+        T* row = m + (i * npol + is1) * ncol * npol + is2;
+        for (int j = 0; j < ncol; j++)
+        {
+            row[j * npol] += c[i * ncol + j];
+        }
+    }
+}
+
+// sum_{i,p} Re(w_{ip}) <d_c phi_i|beta_p> for the 3 gradient components c of the projections
+template <typename T>
+void add_gradients(const double* nlm, const int n, const int ld, const int nproj, const T* w, double* g)
+{
+    for (int i = 0; i < n; i++)
+    {
+        const double* row = nlm + i * ld;
+        const T* wi = w + i * nproj;
+        for (int c = 0; c < 3; c++)
+        {
+            const double* grad = row + (c + 1) * nproj;
+            double sum = 0.0;
+            for (int p = 0; p < nproj; p++)
+            {
+                sum += grad[p] * real_part(wi[p]);
+            }
+            g[c] += sum;
+        }
+    }
+}
+
+} // namespace
+
+template <typename T>
+void contract_projectors(const ProjectorMatrix& nlm1,
+                         const ProjectorMatrix& nlm2,
+                         const std::vector<const T*>& d,
+                         const int npol,
+                         T* hr)
+{
+    const int n1 = nlm1.get_nrow();
+    const int n2 = nlm2.get_ncol();
+    const int nproj = nlm1.get_nproj();
+#ifdef __DEBUG
+    assert(nlm2.get_nproj() == nproj);
+    assert(d.size() == npol * npol);
+#endif
+    if (n1 == 0 || n2 == 0 || nproj == 0)
+    {
+        return;
+    }
+    const T one = 1.0;
+    const T zero = 0.0;
+    std::vector<T> buffer1, buffer2;
+    int ld1 = 0, ld2 = 0;
+    const T* a1 = value_matrix(nlm1.get_rows(), n1, nlm1.get_ld(), nproj, buffer1, ld1);
+    const T* a2 = value_matrix(nlm2.get_cols(), n2, nlm2.get_ld(), nproj, buffer2, ld2);
+
+    std::vector<T> da2(nproj * n2);
+    std::vector<T> c(npol == 1 ? 0 : n1 * n2);
+    for (int is = 0; is < npol * npol; is++)
+    {
+        if (d[is] == nullptr)
+        {
+            continue;
+        }
+        // D A2^T, nproj x n2
+        BlasConnector::gemm('N', 'T', nproj, n2, nproj, one, d[is], nproj, a2, ld2, zero, da2.data(), n2);
+        // A1 (D A2^T), n1 x n2, directly into hr without the spin
+        if (npol == 1)
+        {
+            BlasConnector::gemm('N', 'N', n1, n2, nproj, one, a1, ld1, da2.data(), n2, one, hr, n2);
+        }
+        else
+        {
+            BlasConnector::gemm('N', 'N', n1, n2, nproj, one, a1, ld1, da2.data(), n2, zero, c.data(), n2);
+            add_spin_block(c.data(), n1, n2, npol, is, hr);
+        }
+    }
+}
+
+template <typename T>
+void contract_projectors(const ProjectorMatrix& nlm1, const ProjectorMatrix& nlm2, const int npol, T* hr)
+{
+    const int n1 = nlm1.get_nrow();
+    const int n2 = nlm2.get_ncol();
+    const int nproj = nlm1.get_nproj();
+#ifdef __DEBUG
+    assert(nlm2.get_nproj() == nproj);
+#endif
+    if (n1 == 0 || n2 == 0 || nproj == 0)
+    {
+        return;
+    }
+    // A1 A2^T, n1 x n2
+    std::vector<double> c(n1 * n2);
+    BlasConnector::gemm('N',
+                        'T',
+                        n1,
+                        n2,
+                        nproj,
+                        1.0,
+                        nlm1.get_rows(),
+                        nlm1.get_ld(),
+                        nlm2.get_cols(),
+                        nlm2.get_ld(),
+                        0.0,
+                        c.data(),
+                        n2);
+    for (int is = 0; is < npol * npol; is++)
+    {
+        add_spin_block(c.data(), n1, n2, npol, is, hr);
+    }
+}
+
+template <typename T>
+void contract_density(const ProjectorMatrix& nlm1, const ProjectorMatrix& nlm2, const int npol, const T* dm, T* occ)
+{
+    const int n1 = nlm1.get_nrow();
+    const int n2 = nlm2.get_ncol();
+    const int nproj = nlm1.get_nproj();
+#ifdef __DEBUG
+    assert(nlm2.get_nproj() == nproj);
+#endif
+    if (n1 == 0 || n2 == 0 || nproj == 0)
+    {
+        return;
+    }
+    const T one = 1.0;
+    const T zero = 0.0;
+    std::vector<T> buffer1, buffer2, buffer_dm;
+    int ld1 = 0, ld2 = 0;
+    const T* a1 = value_matrix(nlm1.get_rows(), n1, nlm1.get_ld(), nproj, buffer1, ld1);
+    const T* a2 = value_matrix(nlm2.get_cols(), n2, nlm2.get_ld(), nproj, buffer2, ld2);
+
+    std::vector<T> x(n1 * nproj);
+    for (int is = 0; is < npol * npol; is++)
+    {
+        const T* dm_is = spin_block(dm, n1, n2, npol, is, buffer_dm);
+        // dm A2, n1 x nproj
+        BlasConnector::gemm('N', 'N', n1, nproj, n2, one, dm_is, n2, a2, ld2, zero, x.data(), nproj);
+        // A1^T (dm A2), nproj x nproj
+        BlasConnector::gemm('T', 'N', nproj, nproj, n1, one, a1, ld1, x.data(), nproj, one, occ + is * nproj * nproj, nproj);
+    }
+}
+
+template <typename T>
+void contract_gradients(const ProjectorMatrix& nlm1,
+                        const ProjectorMatrix& nlm2,
+                        const std::vector<const T*>& d,
+                        const int npol,
+                        const T* dm,
+                        double* g1,
+                        double* g2)
+{
+    const int n1 = nlm1.get_nrow();
+    const int n2 = nlm2.get_ncol();
+    const int nproj = nlm1.get_nproj();
+#ifdef __DEBUG
+    assert(nlm2.get_nproj() == nproj);
+    assert(nlm1.get_ncomp() == 4 && nlm2.get_ncomp() == 4);
+    assert(d.size() == npol * npol);
+#endif
+    if (n1 == 0 || n2 == 0 || nproj == 0)
+    {
+        return;
+    }
+    const T one = 1.0;
+    const T zero = 0.0;
+    std::vector<T> buffer1, buffer2, buffer_dm;
+    int ld1 = 0, ld2 = 0;
+    const T* a1 = value_matrix(nlm1.get_rows(), n1, nlm1.get_ld(), nproj, buffer1, ld1);
+    const T* a2 = value_matrix(nlm2.get_cols(), n2, nlm2.get_ld(), nproj, buffer2, ld2);
+
+    // w1 = sum_is dm A2 D^T, contracted with the gradients of A1
+    // w2 = sum_is dm^T A1 D, contracted with the gradients of A2
+    std::vector<T> w1(n1 * nproj, zero);
+    std::vector<T> w2(g2 == nullptr ? 0 : n2 * nproj, zero);
+    std::vector<T> x(n1 * nproj);
+    std::vector<T> y(g2 == nullptr ? 0 : n2 * nproj);
+    for (int is = 0; is < npol * npol; is++)
+    {
+        if (d[is] == nullptr)
+        {
+            continue;
+        }
+        const T* dm_is = spin_block(dm, n1, n2, npol, is, buffer_dm);
+        BlasConnector::gemm('N', 'N', n1, nproj, n2, one, dm_is, n2, a2, ld2, zero, x.data(), nproj);
+        BlasConnector::gemm('N', 'T', n1, nproj, nproj, one, x.data(), nproj, d[is], nproj, one, w1.data(), nproj);
+        if (g2 != nullptr)
+        {
+            BlasConnector::gemm('T', 'N', n2, nproj, n1, one, dm_is, n2, a1, ld1, zero, y.data(), nproj);
+            BlasConnector::gemm('N', 'N', n2, nproj, nproj, one, y.data(), nproj, d[is], nproj, one, w2.data(), nproj);
+        }
+    }
+    add_gradients(nlm1.get_rows(), n1, nlm1.get_ld(), nproj, w1.data(), g1);
+    if (g2 != nullptr)
+    {
+        add_gradients(nlm2.get_cols(), n2, nlm2.get_ld(), nproj, w2.data(), g2);
+    }
+}
+
+template void contract_projectors<double>(const ProjectorMatrix&,
+                                          const ProjectorMatrix&,
+                                          const std::vector<const double*>&,
+                                          const int,
+                                          double*);
+template void contract_projectors<std::complex<double>>(const ProjectorMatrix&,
+                                                        const ProjectorMatrix&,
+                                                        const std::vector<const std::complex<double>*>&,
+                                                        const int,
+                                                        std::complex<double>*);
+template void contract_projectors<double>(const ProjectorMatrix&, const ProjectorMatrix&, const int, double*);
+template void contract_projectors<std::complex<double>>(const ProjectorMatrix&,
+                                                        const ProjectorMatrix&,
+                                                        const int,
+                                                        std::complex<double>*);
+template void contract_density<double>(const ProjectorMatrix&, const ProjectorMatrix&, const int, const double*, double*);
+template void contract_gradients<double>(const ProjectorMatrix&,
+                                         const ProjectorMatrix&,
+                                         const std::vector<const double*>&,
+                                         const int,
+                                         const double*,
+                                         double*,
+                                         double*);
+template void contract_gradients<std::complex<double>>(const ProjectorMatrix&,
+                                                       const ProjectorMatrix&,
+                                                       const std::vector<const std::complex<double>*>&,
+                                                       const int,
+                                                       const std::complex<double>*,
+                                                       double*,
+                                                       double*);
+
+} // namespace hamilt
@@ -0,0 +1,147 @@
+#ifndef PROJECTOR_CONTRACTION_H
+#define PROJECTOR_CONTRACTION_H
+
+#include <complex>
+#include <vector>
+
+namespace hamilt
+{
+
+/**
+ * @brief the projections <phi|beta> of the orbitals of one atom on the projectors of a center atom
+ * they are stored as two dense matrices, one row for each local row orbital and one row for each local
+ * column orbital of the 2D-block distribution, with ncomp * nproj values in each row: the projections,
+ * then their 3 gradients as given by TwoCenterIntegrator::snap if ncomp is 4.
+ * the operators with the form <phi_I|beta>D<beta|phi_J> of a center atom (NonlocalNew, DeePKS, DFTU, DeltaSpin)
+ * build one ProjectorMatrix for each adjacent atom, and calculate each <I,J,R> block with the
+ * contract_* functions below, which are small GEMMs.
+ */
+class ProjectorMatrix
+{
+  public:
+    ProjectorMatrix() = default;
+    /**
+     * @param row_indexes the local row indexes of the orbitals of the atom, paraV->get_indexes_row(iat)
+     * @param col_indexes the local column indexes of the orbitals of the atom, paraV->get_indexes_col(iat)
+     * @param npol the number of spin components of each orbital, only the first one is stored
+     * @param nproj the number of projectors of the center atom
+     * @param ncomp 1 for the projections, 4 for the projections and their gradients
+     */
+    ProjectorMatrix(const std::vector<int>& row_indexes,
+                    const std::vector<int>& col_indexes,
+                    const int npol,
+                    const int nproj,
+                    const int ncomp = 1);
+
+    /// the orbitals of the atom in the rows or the columns, the index of get_indexes_row/col of their first spin
+    const std::vector<int>& get_orbitals() const
+    {
+        return this->orbitals;
+    }
+
+    /// set the ncomp * nproj projections of the orbital get_orbitals()[io], the size of nlm is checked
+    void set(const int io, const std::vector<double>& nlm);
+
+    int get_nproj() const
+    {
+        return this->nproj;
+    }
+    int get_ncomp() const
+    {
+        return this->ncomp;
+    }
+    /// the leading dimension of the matrices, ncomp * nproj
+    int get_ld() const
+    {
+        return this->nproj * this->ncomp;
+    }
+    /// the number of local row orbitals, without the spin
+    int get_nrow() const
+    {
+        return this->nrow;
+    }
+    /// the number of local column orbitals, without the spin
+    int get_ncol() const
+    {
+        return this->ncol;
+    }
+    /// the projections of the row orbitals, get_nrow() x get_ld() row-major
+    const double* get_rows() const
+    {
+        return this->rows.data();
+    }
+    /// the projections of the column orbitals, get_ncol() x get_ld() row-major
+    const double* get_cols() const
+    {
+        return this->cols.data();
+    }
+
+    size_t get_memory_size() const
+    {
+        return (this->rows.size() + this->cols.size()) * sizeof(double)
+               + (this->orbitals.size() + this->row_of.size() + this->col_of.size()) * sizeof(int);
+    }
+
+  private:
+    int nproj = 0;
+    int ncomp = 1;
+    int nrow = 0;
+    int ncol = 0;
+    std::vector<int> orbitals;
+    // the row of each orbital in rows and cols, -1 if it is not a local row or column
+    std::vector<int> row_of;
+    std::vector<int> col_of;
+    std::vector<double> rows;
+    std::vector<double> cols;
+};
+
+/**
+ * @brief hr += <phi_I|beta> D^{is} <beta|phi_J> for the rows of nlm1 and the columns of nlm2
+ * D^{is} A2^T is one GEMM, A1 (D^{is} A2^T) is the other one.
+ * @param d the D matrices of the npol * npol spin components, nproj x nproj row-major,
+ *        nullptr for the components without D
+ * @param npol the number of spin components of each orbital
+ * @param hr the row-major block of the atom pair, (nrow * npol) x (ncol * npol),
+ *        the spin components of a pair of orbitals next to each other as in HContainer
+ */
+template <typename T>
+void contract_projectors(const ProjectorMatrix& nlm1,
+                         const ProjectorMatrix& nlm2,
+                         const std::vector<const T*>& d,
+                         const int npol,
+                         T* hr);
+
+/// hr += <phi_I|beta><beta|phi_J>, D is the identity, the same for all the npol * npol spin components
+template <typename T>
+void contract_projectors(const ProjectorMatrix& nlm1, const ProjectorMatrix& nlm2, const int npol, T* hr);
+
+/**
+ * @brief occ^{is} += <beta|phi_I> dm^{is} <phi_J|beta>, the dual of contract_projectors
+ * @param dm the row-major block of the density matrix of the atom pair, with the layout of hr above
+ * @param occ the npol * npol matrices nproj x nproj row-major
+ */
+template <typename T>
+void contract_density(const ProjectorMatrix& nlm1, const ProjectorMatrix& nlm2, const int npol, const T* dm, T* occ);
+
+/**
+ * @brief the gradients of sum_{IJ} dm_{IJ} <phi_I|beta>D<beta|phi_J> from the gradients of the projections,
+ * for the force and the stress, nlm1 and nlm2 must have the gradients (ncomp = 4)
+ * g1[i] += Re sum_{IJ,is} dm^{is}_{IJ} <d_i phi_I|beta> D^{is} <beta|phi_J>
+ * g2[i] += Re sum_{IJ,is} dm^{is}_{IJ} <phi_I|beta> D^{is} <beta|d_i phi_J>
+ * @param d the D matrices as in contract_projectors
+ * @param dm the row-major block of the density matrix of the atom pair, with the layout of hr above
+ * @param g1 the 3 gradients with respect to the position of the row atom
+ * @param g2 the 3 gradients with respect to the position of the column atom, nullptr if not needed
+ */
+template <typename T>
+void contract_gradients(const ProjectorMatrix& nlm1,
+                        const ProjectorMatrix& nlm2,
+                        const std::vector<const T*>& d,
+                        const int npol,
+                        const T* dm,
+                        double* g1,
+                        double* g2);
+
+} // namespace hamilt
+
+#endif
@@ -13,4 +13,5 @@ for i in 2 3 4; do
     mpirun -np $i ./operator_ekinetic_test
     mpirun -np $i ./operator_nonlocal_test
     mpirun -np $i ./operator_T_NL_cd_test
+    mpirun -np $i ./operator_spar_hsr_test
 done
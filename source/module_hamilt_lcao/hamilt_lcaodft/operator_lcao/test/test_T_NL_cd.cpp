@@ -59,6 +59,7 @@ class TNLTest : public ::testing::Test
         ucell.set_iat2iwt(2);
         // for NonlocalNew
         ucell.infoNL.Beta = new Numerical_Nonlocal[ucell.ntype];
+        ucell.atoms[0].ncpp.nh = 5;
         ucell.atoms[0].ncpp.d_real.create(5, 5);
         ucell.atoms[0].ncpp.d_real.zero_out();
         ucell.atoms[0].ncpp.d_so.create(4, 5, 5);
@@ -57,6 +57,7 @@ class NonlocalNewTest : public ::testing::Test
             ucell.atoms[0].iw2m[iw] = 0;
             ucell.atoms[0].iw2n[iw] = 0;
         }
+        ucell.atoms[0].ncpp.nh = 5;
         ucell.atoms[0].ncpp.d_real.create(5, 5);
         ucell.atoms[0].ncpp.d_real.zero_out();
         ucell.atoms[0].ncpp.d_so.create(4, 5, 5);
@@ -12,6 +12,7 @@
 // - contributeHk()
 // - SR(double) and SK(complex<double>) are tested in constructHRd2cd
 // - SR(double) and SK(double) are tested in constructHRd2d
+// - update_neighbors() for the moved atoms is tested in updateNeighbors
 //---------------------------------------
 
 // test_size is the number of atoms in the unitcell
@@ -172,6 +173,86 @@ TEST_F(OverlapNewTest, constructHRd2cd)
     }
 }
 
+TEST_F(OverlapNewTest, updateNeighbors)
+{
+    std::vector<ModuleBase::Vector3<double>> kvec_d_in(1, ModuleBase::Vector3<double>(0.0, 0.0, 0.0));
+    hamilt::HS_Matrix_K<double> hsk(paraV);
+    hsk.set_zero_sk();
+    Grid_Driver gd(0, 0);
+    hamilt::OverlapNew<hamilt::OperatorLCAO<double, double>>
+        op(&hsk, kvec_d_in, nullptr, SR, &ucell, {1.0}, &gd, &intor_);
+    op.contributeHR();
+    const int npairs = SR->size_atom_pairs();
+    EXPECT_TRUE(SR->is_gamma_only());
+
+    // move the first atom out of the cutoff of the others
+    ucell.lat0 = 1.0;
+    ucell.atoms[0].tau[0] = ModuleBase::Vector3<double>(10.0, 0.0, 0.0);
+    EXPECT_TRUE(op.update_neighbors(&gd, nullptr));
+    EXPECT_FALSE(SR->is_gamma_only());
+    op.contributeHR();
+    EXPECT_TRUE(SR->is_gamma_only());
+    EXPECT_LE(SR->size_atom_pairs(), npairs);
+    for (int iap = 0; iap < SR->size_atom_pairs(); ++iap)
+    {
+        hamilt::AtomPair<double>& tmp = SR->get_atom_pair(iap);
+        int iat1 = tmp.get_atom_i();
+        int iat2 = tmp.get_atom_j();
+        EXPECT_EQ(iat1 == 0, iat2 == 0);
+        auto indexes1 = paraV->get_indexes_row(iat1);
+        auto indexes2 = paraV->get_indexes_col(iat2);
+        int nwt = indexes1.size() * indexes2.size();
+        for (int i = 0; i < nwt; ++i)
+        {
+            EXPECT_EQ(tmp.get_pointer(0)[i], 1.0);
+        }
+    }
+
+    // move it back, all the atom pairs are found again
+    ucell.atoms[0].tau[0] = ModuleBase::Vector3<double>(0.0, 0.0, 0.0);
+    EXPECT_TRUE(op.update_neighbors(&gd, nullptr));
+    op.contributeHR();
+    EXPECT_EQ(SR->size_atom_pairs(), npairs);
+    op.contributeHk(0);
+    double* sk = hsk.get_sk();
+    for (int i = 0; i < hsk.get_size(); ++i)
+    {
+        EXPECT_EQ(sk[i], 1.0);
+    }
+
+    // a small displacement keeps the atom pairs and their R-indexes, which are not merged to gamma
+    // for complex TK, then SR is the same as a fresh build
+    hamilt::HS_Matrix_K<std::complex<double>> hsk_k(paraV);
+    hamilt::HContainer<double> SR_k(paraV);
+    hamilt::OverlapNew<hamilt::OperatorLCAO<std::complex<double>, double>>
+        op_k(&hsk_k, kvec_d_in, nullptr, &SR_k, &ucell, {1.0}, &gd, &intor_);
+    op_k.contributeHR();
+    ucell.atoms[0].tau[0] = ModuleBase::Vector3<double>(0.1, 0.0, 0.0);
+    EXPECT_TRUE(op_k.update_neighbors(&gd, nullptr));
+    op_k.contributeHR();
+    EXPECT_EQ(SR_k.size_atom_pairs(), npairs);
+    hamilt::HS_Matrix_K<std::complex<double>> hsk_fresh(paraV);
+    hamilt::HContainer<double> SR_fresh(paraV);
+    hamilt::OverlapNew<hamilt::OperatorLCAO<std::complex<double>, double>>
+        op_fresh(&hsk_fresh, kvec_d_in, nullptr, &SR_fresh, &ucell, {1.0}, &gd, &intor_);
+    op_fresh.contributeHR();
+    EXPECT_EQ(SR_fresh.size_atom_pairs(), npairs);
+    for (int iap = 0; iap < SR_fresh.size_atom_pairs(); ++iap)
+    {
+        hamilt::AtomPair<double>& tmp_fresh = SR_fresh.get_atom_pair(iap);
+        const hamilt::AtomPair<double>* tmp = SR_k.find_pair(tmp_fresh.get_atom_i(), tmp_fresh.get_atom_j());
+        ASSERT_NE(tmp, nullptr);
+        ASSERT_EQ(tmp->get_R_size(), tmp_fresh.get_R_size());
+        for (int iR = 0; iR < tmp_fresh.get_R_size(); ++iR)
+        {
+            for (int i = 0; i < tmp_fresh.get_size(); ++i)
+            {
+                EXPECT_EQ(tmp->get_pointer(iR)[i], tmp_fresh.get_pointer(iR)[i]);
+            }
+        }
+    }
+}
+
 int main(int argc, char** argv)
 {
 #ifdef __MPI
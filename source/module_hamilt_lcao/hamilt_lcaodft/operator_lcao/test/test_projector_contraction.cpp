@@ -0,0 +1,336 @@
+#include "../projector_contraction.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <complex>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+//---------------------------------------
+// Unit test of the contractions <phi_I|beta>D<beta|phi_J> of projector_contraction.h
+// they are compared with the loops over the orbitals and the projectors done before by each operator
+// - contract_projectors() with D for each spin component, double with npol = 1, complex with npol = 2
+// - contract_projectors() with D = identity
+// - contract_density()
+// - contract_gradients(), double with npol = 1, complex with npol = 2
+// - ProjectorMatrix::set() quits if the number of projections is not ncomp * nproj
+// the time of the loops and of the GEMMs is printed for a pair of atoms of bench_nw orbitals
+//---------------------------------------
+
+namespace
+{
+
+int test_nw = 7;
+int test_nproj = 5;
+int bench_nw = 50;
+int bench_nproj = 30;
+
+double random_value()
+{
+    return static_cast<double>(std::rand()) / RAND_MAX - 0.5;
+}
+
+// the projections of the nw orbitals of one atom, with their 3 gradients
+std::vector<std::vector<double>> random_projections(const int nw, const int nproj)
+{
+    std::vector<std::vector<double>> nlm(nw, std::vector<double>(4 * nproj));
+    for (auto& v: nlm)
+    {
+        for (auto& x: v)
+        {
+            x = random_value();
+        }
+    }
+    return nlm;
+}
+
+// all the nw orbitals in the rows, every other orbital in the columns
+hamilt::ProjectorMatrix make_matrix(const std::vector<std::vector<double>>& nlm,
+                                    const int npol,
+                                    const int nproj,
+                                    const int ncomp)
+{
+    std::vector<int> rows, cols;
+    for (int iw = 0; iw < nlm.size(); iw++)
+    {
+        for (int ip = 0; ip < npol; ip++)
+        {
+            rows.push_back(iw * npol + ip);
+            if (iw % 2 == 0)
+            {
+                cols.push_back(iw * npol + ip);
+            }
+        }
+    }
+    hamilt::ProjectorMatrix m(rows, cols, npol, nproj, ncomp);
+    EXPECT_EQ(m.get_nrow(), nlm.size());
+    EXPECT_EQ(m.get_ncol(), (nlm.size() + 1) / 2);
+    for (int io = 0; io < m.get_orbitals().size(); io++)
+    {
+        const std::vector<double>& nlm_io = nlm[m.get_orbitals()[io] / npol];
+        m.set(io, std::vector<double>(nlm_io.begin(), nlm_io.begin() + ncomp * nproj));
+    }
+    return m;
+}
+
+template <typename T>
+void random_fill(std::vector<T>& v);
+template <>
+void random_fill(std::vector<double>& v)
+{
+    for (auto& x: v)
+    {
+        x = random_value();
+    }
+}
+template <>
+void random_fill(std::vector<std::complex<double>>& v)
+{
+    for (auto& x: v)
+    {
+        x = std::complex<double>(random_value(), random_value());
+    }
+}
+
+double distance(const double a, const double b)
+{
+    return std::abs(a - b);
+}
+double distance(const std::complex<double>& a, const std::complex<double>& b)
+{
+    return std::abs(a - b);
+}
+
+// the loops over the orbitals and the projectors, hr and dm with the layout of HContainer
+// the column orbitals are the even orbitals of make_matrix()
+template <typename T>
+void reference_hr(const std::vector<std::vector<double>>& nlm,
+                  const std::vector<const T*>& d,
+                  const int npol,
+                  const int nproj,
+                  T* hr)
+{
+    const int nw = nlm.size();
+    const int ncol = (nw + 1) / 2 * npol;
+    for (int iw1 = 0; iw1 < nw; iw1++)
+    {
+        for (int iw2 = 0; iw2 < nw; iw2 += 2)
+        {
+            for (int is = 0; is < npol * npol; is++)
+            {
+                if (d[is] == nullptr)
+                {
+                    continue;
+                }
+                T sum = 0.0;
+                for (int p1 = 0; p1 < nproj; p1++)
+                {
+                    for (int p2 = 0; p2 < nproj; p2++)
+                    {
+                        sum += nlm[iw1][p1] * d[is][p1 * nproj + p2] * nlm[iw2][p2];
+                    }
+                }
+                hr[(iw1 * npol + is / npol) * ncol + iw2 / 2 * npol + is % npol] += sum;
+            }
+        }
+    }
+}
+
+template <typename T>
+void reference_gradients(const std::vector<std::vector<double>>& nlm,
+                         const std::vector<const T*>& d,
+                         const int npol,
+                         const int nproj,
+                         const T* dm,
+                         double* g1,
+                         double* g2)
+{
+    const int nw = nlm.size();
+    const int ncol = (nw + 1) / 2 * npol;
+    for (int iw1 = 0; iw1 < nw; iw1++)
+    {
+        for (int iw2 = 0; iw2 < nw; iw2 += 2)
+        {
+            for (int is = 0; is < npol * npol; is++)
+            {
+                if (d[is] == nullptr)
+                {
+                    continue;
+                }
+                const T dm_value = dm[(iw1 * npol + is / npol) * ncol + iw2 / 2 * npol + is % npol];
+                for (int c = 0; c < 3; c++)
+                {
+                    T sum1 = 0.0, sum2 = 0.0;
+                    for (int p1 = 0; p1 < nproj; p1++)
+                    {
+                        for (int p2 = 0; p2 < nproj; p2++)
+                        {
+                            const T dp = d[is][p1 * nproj + p2];
+                            sum1 += nlm[iw1][(c + 1) * nproj + p1] * dp * nlm[iw2][p2];
+                            sum2 += nlm[iw1][p1] * dp * nlm[iw2][(c + 1) * nproj + p2];
+                        }
+                    }
+                    g1[c] += std::real(dm_value * sum1);
+                    g2[c] += std::real(dm_value * sum2);
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void check_contract(const int npol, const std::vector<bool>& with_d)
+{
+    const auto nlm = random_projections(test_nw, test_nproj);
+    const auto m = make_matrix(nlm, npol, test_nproj, 4);
+    std::vector<T> d_data(npol * npol * test_nproj * test_nproj);
+    random_fill(d_data);
+    std::vector<const T*> d(npol * npol, nullptr);
+    for (int is = 0; is < npol * npol; is++)
+    {
+        if (with_d[is])
+        {
+            d[is] = &d_data[is * test_nproj * test_nproj];
+        }
+    }
+
+    const int size = m.get_nrow() * m.get_ncol() * npol * npol;
+    std::vector<T> hr(size), hr_ref(size);
+    random_fill(hr);
+    hr_ref = hr;
+    hamilt::contract_projectors(m, m, d, npol, hr.data());
+    reference_hr(nlm, d, npol, test_nproj, hr_ref.data());
+    for (int i = 0; i < size; i++)
+    {
+        EXPECT_NEAR(distance(hr[i], hr_ref[i]), 0.0, 1e-12);
+    }
+
+    std::vector<T> dm(size);
+    random_fill(dm);
+    double g1[3] = {0.0, 0.0, 0.0}, g2[3] = {0.0, 0.0, 0.0};
+    double g1_ref[3] = {0.0, 0.0, 0.0}, g2_ref[3] = {0.0, 0.0, 0.0};
+    hamilt::contract_gradients(m, m, d, npol, dm.data(), g1, g2);
+    reference_gradients(nlm, d, npol, test_nproj, dm.data(), g1_ref, g2_ref);
+    for (int c = 0; c < 3; c++)
+    {
+        EXPECT_NEAR(g1[c], g1_ref[c], 1e-12);
+        EXPECT_NEAR(g2[c], g2_ref[c], 1e-12);
+    }
+    // g2 is optional
+    double g1_only[3] = {0.0, 0.0, 0.0};
+    hamilt::contract_gradients(m, m, d, npol, dm.data(), g1_only, nullptr);
+    for (int c = 0; c < 3; c++)
+    {
+        EXPECT_NEAR(g1_only[c], g1_ref[c], 1e-12);
+    }
+}
+
+} // namespace
+
+TEST(ProjectorContractionTest, ContractDouble)
+{
+    check_contract<double>(1, {true});
+}
+
+TEST(ProjectorContractionTest, ContractComplexNspin4)
+{
+    // the spin components of the spin-orbit coupling, the component 1 has no D
+    check_contract<std::complex<double>>(2, {true, false, true, true});
+}
+
+TEST(ProjectorContractionTest, ContractIdentity)
+{
+    const int npol = 2;
+    const auto nlm = random_projections(test_nw, test_nproj);
+    const auto m = make_matrix(nlm, npol, test_nproj, 1);
+    std::vector<std::complex<double>> identity(test_nproj * test_nproj, 0.0);
+    for (int p = 0; p < test_nproj; p++)
+    {
+        identity[p * test_nproj + p] = 1.0;
+    }
+    const std::vector<const std::complex<double>*> d(npol * npol, identity.data());
+
+    const int size = m.get_nrow() * m.get_ncol() * npol * npol;
+    std::vector<std::complex<double>> hr(size, 0.0), hr_ref(size, 0.0);
+    hamilt::contract_projectors(m, m, npol, hr.data());
+    reference_hr(nlm, d, npol, test_nproj, hr_ref.data());
+    for (int i = 0; i < size; i++)
+    {
+        EXPECT_NEAR(distance(hr[i], hr_ref[i]), 0.0, 1e-12);
+    }
+}
+
+TEST(ProjectorContractionTest, ContractDensity)
+{
+    const auto nlm = random_projections(test_nw, test_nproj);
+    const auto m = make_matrix(nlm, 1, test_nproj, 1);
+    std::vector<double> dm(m.get_nrow() * m.get_ncol());
+    random_fill(dm);
+    std::vector<double> occ(test_nproj * test_nproj, 1.0);
+    hamilt::contract_density(m, m, 1, dm.data(), occ.data());
+    // occ_{p1,p2} is tr(dm^T hr) with D = e_{p1,p2}
+    for (int p1 = 0; p1 < test_nproj; p1++)
+    {
+        for (int p2 = 0; p2 < test_nproj; p2++)
+        {
+            std::vector<double> e(test_nproj * test_nproj, 0.0);
+            e[p1 * test_nproj + p2] = 1.0;
+            std::vector<double> hr(dm.size(), 0.0);
+            reference_hr<double>(nlm, {e.data()}, 1, test_nproj, hr.data());
+            double sum = 1.0;
+            for (int i = 0; i < dm.size(); i++)
+            {
+                sum += dm[i] * hr[i];
+            }
+            EXPECT_NEAR(occ[p1 * test_nproj + p2], sum, 1e-12);
+        }
+    }
+}
+
+TEST(ProjectorContractionTest, SetWrongWidth)
+{
+    const auto nlm = random_projections(test_nw, test_nproj);
+    hamilt::ProjectorMatrix m({0, 1}, {0}, 1, test_nproj, 1);
+    // the projections and their gradients, but the matrix only stores the projections
+    testing::internal::CaptureStdout();
+    EXPECT_EXIT(m.set(0, nlm[0]), ::testing::ExitedWithCode(1), "");
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_THAT(output, testing::HasSubstr("does not match the projectors"));
+}
+
+TEST(ProjectorContractionTest, Timing)
+{
+    const auto nlm = random_projections(bench_nw, bench_nproj);
+    const auto m = make_matrix(nlm, 1, bench_nproj, 1);
+    std::vector<double> d(bench_nproj * bench_nproj);
+    random_fill(d);
+    std::vector<double> hr(m.get_nrow() * m.get_ncol(), 0.0), hr_ref(hr.size(), 0.0);
+
+    const int repeat = 20;
+    std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < repeat; i++)
+    {
+        reference_hr<double>(nlm, {d.data()}, 1, bench_nproj, hr_ref.data());
+    }
+    std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> time_loops
+        = std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time);
+    start_time = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < repeat; i++)
+    {
+        hamilt::contract_projectors<double>(m, m, {d.data()}, 1, hr.data());
+    }
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> time_gemm
+        = std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time);
+    for (int i = 0; i < hr.size(); i++)
+    {
+        EXPECT_NEAR(hr[i], hr_ref[i], 1e-10);
+    }
+    std::cout << "Test terms:   " << std::setw(15) << "loops" << std::setw(15) << "GEMM" << std::endl;
+    std::cout << "Elapsed time: " << std::setw(15) << time_loops.count() << std::setw(15) << time_gemm.count()
+              << " seconds." << std::endl;
+}
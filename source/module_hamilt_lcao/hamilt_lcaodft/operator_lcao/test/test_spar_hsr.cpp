@@ -0,0 +1,232 @@
+#include "gtest/gtest.h"
+
+#define private public
+#include "module_parameter/parameter.h"
+#undef private
+#include "../../spar_dh.h"
+#include "../../spar_hsr.h"
+#include "../../spar_u.h"
+#include "module_hamilt_lcao/module_tddft/td_velocity.h"
+#include "module_io/single_R_io.h"
+
+#include <fstream>
+#include <sstream>
+
+// mock of HamiltLCAO, H(R) and S(R) are set by the test through getHR() and getSR()
+template <>
+hamilt::HamiltLCAO<std::complex<double>, double>::HamiltLCAO(const UnitCell& ucell,
+                                                             const Grid_Driver& grid_d,
+                                                             const Parallel_Orbitals* paraV,
+                                                             const K_Vectors& kv_in,
+                                                             const TwoCenterIntegrator& intor_overlap_orb,
+                                                             const std::vector<double>& orb_cutoff)
+{
+}
+template <>
+void hamilt::HamiltLCAO<std::complex<double>, double>::refresh()
+{
+}
+template <>
+void hamilt::HamiltLCAO<std::complex<double>, double>::updateHk(const int ik)
+{
+}
+template <>
+void hamilt::HamiltLCAO<std::complex<double>, double>::matrix(MatrixBlock<std::complex<double>>& hk_in,
+                                                              MatrixBlock<std::complex<double>>& sk_in)
+{
+}
+
+// mock of the R range, only the center cell and its +x neighbor are used
+void sparse_format::set_R_range(std::set<Abfs::Vector3_Order<int>>& all_R_coor, const Grid_Driver& grid)
+{
+    all_R_coor.insert(Abfs::Vector3_Order<int>(0, 0, 0));
+    all_R_coor.insert(Abfs::Vector3_Order<int>(1, 0, 0));
+}
+void sparse_format::cal_HR_dftu(const Parallel_Orbitals& pv,
+                                std::set<Abfs::Vector3_Order<int>>& all_R_coor,
+                                hamilt::SparseCSR_R<double>& SR_sparse,
+                                hamilt::SparseCSR_R<double>* HR_sparse,
+                                const int& current_spin,
+                                const double& sparse_thr)
+{
+}
+void sparse_format::cal_HR_dftu_soc(const Parallel_Orbitals& pv,
+                                    std::set<Abfs::Vector3_Order<int>>& all_R_coor,
+                                    hamilt::SparseCSR_R<std::complex<double>>& SR_soc_sparse,
+                                    hamilt::SparseCSR_R<std::complex<double>>& HR_soc_sparse,
+                                    const int& current_spin,
+                                    const double& sparse_thr)
+{
+}
+bool TD_Velocity::tddft_velocity = false;
+TD_Velocity* TD_Velocity::td_vel_op = nullptr;
+
+/************************************************
+ *  unit test of sparse_format::cal_HSR
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - sparse_format::cal_HSR()
+ *     - for nspin=2 it is called once for each spin before S(R) is written,
+ *       the S(R) written must be the same as the one of nspin=1
+ */
+
+int test_size = 4;
+int test_nw = 3;
+class SparHSRTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        ucell.ntype = 1;
+        ucell.nat = test_size;
+        ucell.atoms = new Atom[ucell.ntype];
+        ucell.iat2it = new int[ucell.nat];
+        ucell.iat2ia = new int[ucell.nat];
+        ucell.atoms[0].tau.resize(ucell.nat);
+        ucell.itia2iat.create(ucell.ntype, ucell.nat);
+        for (int iat = 0; iat < ucell.nat; iat++)
+        {
+            ucell.iat2it[iat] = 0;
+            ucell.iat2ia[iat] = iat;
+            ucell.itia2iat(0, iat) = iat;
+        }
+        ucell.atoms[0].na = test_size;
+        ucell.atoms[0].nw = test_nw;
+        ucell.set_iat2iwt(1);
+
+        const int nlocal = test_size * test_nw;
+        PARAM.sys.nlocal = nlocal;
+        paraV = new Parallel_Orbitals();
+#ifdef __MPI
+        paraV->init(nlocal, nlocal, 2, MPI_COMM_WORLD);
+        paraV->set_atomic_trace(ucell.get_iat2iwt(), test_size, nlocal);
+#endif
+
+        hR = new hamilt::HContainer<double>(paraV);
+        sR = new hamilt::HContainer<double>(paraV);
+        for (int iat1 = 0; iat1 < test_size; ++iat1)
+        {
+            for (int iat2 = 0; iat2 < test_size; ++iat2)
+            {
+                for (int rx = 0; rx < 2; ++rx)
+                {
+                    hamilt::AtomPair<double> tmp(iat1, iat2, rx, 0, 0, paraV);
+                    hR->insert_pair(tmp);
+                    sR->insert_pair(tmp);
+                }
+            }
+        }
+        hR->allocate(nullptr, true);
+        sR->allocate(nullptr, true);
+        for (int iap = 0; iap < sR->size_atom_pairs(); ++iap)
+        {
+            hamilt::AtomPair<double>& sp = sR->get_atom_pair(iap);
+            hamilt::AtomPair<double>& hp = hR->get_atom_pair(iap);
+            for (int iR = 0; iR < sp.get_R_size(); ++iR)
+            {
+                const int rx = sp.get_R_index(iR).x;
+                const int size = sp.get_row_size() * sp.get_col_size();
+                for (int i = 0; i < size; ++i)
+                {
+                    sp.get_pointer(iR)[i] = 0.1 * (sp.get_atom_i() + 1) + 0.01 * (sp.get_atom_j() + 1) + 0.5 * rx;
+                    hp.get_pointer(iR)[i] = -sp.get_pointer(iR)[i];
+                }
+            }
+        }
+    }
+
+    void TearDown() override
+    {
+        delete hR;
+        delete sR;
+        delete paraV;
+        delete[] ucell.atoms;
+    }
+
+    // call cal_HSR() as ModuleIO::output_HSR() does, then write S(R) as save_HSR_sparse() does
+    std::string write_SR(const int nspin)
+    {
+        PARAM.input.nspin = nspin;
+        hamilt::HamiltLCAO<std::complex<double>, double> ham(ucell, gd, paraV, kv, intor, {});
+        ham.getHR() = new hamilt::HContainer<double>(*hR);
+        ham.getHR()->add(*hR);
+        ham.getSR() = new hamilt::HContainer<double>(*sR);
+        ham.getSR()->add(*sR);
+
+        LCAO_HS_Arrays HS_Arrays;
+        const int nmp[3] = {1, 1, 1};
+        if (nspin == 1)
+        {
+            sparse_format::cal_HSR(ucell, *paraV, HS_Arrays, gd, 0, sparse_thr, nmp, &ham);
+        }
+        else
+        {
+            sparse_format::cal_HSR(ucell, *paraV, HS_Arrays, gd, 1, sparse_thr, nmp, &ham);
+            sparse_format::cal_HSR(ucell, *paraV, HS_Arrays, gd, 0, sparse_thr, nmp, &ham);
+        }
+
+        const std::string filename = "SR_nspin" + std::to_string(nspin) + ".csr";
+        std::ofstream ofs;
+        if (GlobalV::MY_RANK == 0)
+        {
+            ofs.open(filename);
+        }
+        for (auto& R_block: HS_Arrays.SR_sparse)
+        {
+            ofs << R_block.first.x << " " << R_block.first.y << " " << R_block.first.z << std::endl;
+            ModuleIO::output_single_R(ofs, R_block.second, sparse_thr, false, *paraV);
+        }
+        ofs.close();
+        sparse_format::destroy_HS_R_sparse(HS_Arrays);
+
+        std::stringstream ss;
+        if (GlobalV::MY_RANK == 0)
+        {
+            std::ifstream ifs(filename);
+            ss << ifs.rdbuf();
+            ifs.close();
+            std::remove(filename.c_str());
+        }
+        return ss.str();
+    }
+
+    UnitCell ucell;
+    Parallel_Orbitals* paraV = nullptr;
+    hamilt::HContainer<double>* hR = nullptr;
+    hamilt::HContainer<double>* sR = nullptr;
+    Grid_Driver gd{0, 0};
+    K_Vectors kv;
+    TwoCenterIntegrator intor;
+    const double sparse_thr = 1e-10;
+};
+
+TEST_F(SparHSRTest, SRNspin2)
+{
+    const std::string sr_nspin1 = this->write_SR(1);
+    const std::string sr_nspin2 = this->write_SR(2);
+    if (GlobalV::MY_RANK == 0)
+    {
+        EXPECT_FALSE(sr_nspin1.empty());
+        EXPECT_EQ(sr_nspin1, sr_nspin2);
+        // the diagonal element of atom 0 in the center cell is 0.11, not 0.22
+        EXPECT_NE(sr_nspin2.find("1.10000000e-01"), std::string::npos);
+    }
+    PARAM.input.nspin = 1;
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &GlobalV::MY_RANK);
+    GlobalV::DRANK = GlobalV::MY_RANK;
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
@@ -114,7 +114,8 @@ void TwoCenterIntegrator::tabulate(const RadialCollection& bra,
                                    const RadialCollection& ket,
                                    const char op,
                                    const int nr,
-                                   const double cutoff) {}
+                                   const double cutoff,
+                                   const std::string& cache_dir) {}
 
 void TwoCenterIntegrator::calculate(
     const int itype1,
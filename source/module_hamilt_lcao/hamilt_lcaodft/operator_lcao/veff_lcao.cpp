@@ -11,13 +11,15 @@ namespace hamilt
 
 // initialize_HR()
 template <typename TK, typename TR>
-void Veff<OperatorLCAO<TK, TR>>::initialize_HR(const UnitCell* ucell_in, const Grid_Driver* GridD)
+void Veff<OperatorLCAO<TK, TR>>::initialize_HR(const UnitCell* ucell_in,
+                                               const Grid_Driver* GridD,
+                                               HContainer<TR>* hR_in)
 {
     ModuleBase::TITLE("Veff", "initialize_HR");
     ModuleBase::timer::tick("Veff", "initialize_HR");
 
     this->nspin = PARAM.inp.nspin;
-    auto* paraV = this->hR->get_paraV();// get parallel orbitals from HR
+    auto* paraV = hR_in->get_paraV();// get parallel orbitals from HR
     // TODO: if paraV is nullptr, AtomPair can not use paraV for constructor, I will repair it in the future.
 
     for (int iat1 = 0; iat1 < ucell_in->nat; iat1++)
@@ -46,16 +48,31 @@ void Veff<OperatorLCAO<TK, TR>>::initialize_HR(const UnitCell* ucell_in, const G
                 < orb_cutoff_[T1] + orb_cutoff_[T2])
             {
                 hamilt::AtomPair<TR> tmp(iat1, iat2, R_index2, paraV);
-                this->hR->insert_pair(tmp);
+                hR_in->insert_pair(tmp);
             }
         }
     }
-    // allocate the memory of BaseMatrix in HR, and set the new values to zero
-    this->hR->allocate(nullptr, true);
 
     ModuleBase::timer::tick("Veff", "initialize_HR");
 }
 
+// update_neighbors()
+template <typename TK, typename TR>
+bool Veff<OperatorLCAO<TK, TR>>::update_neighbors(const Grid_Driver* GridD_in, HContainer<TR>* hR_new)
+{
+    this->initialize_HR(this->ucell, GridD_in, hR_new);
+    // the atom-pairs of grid integration are taken from Grid_Technique, which is prepared for the new positions
+    if (this->GK != nullptr)
+    {
+        this->GK->initialize_pvpR(*this->ucell, GridD_in, this->nspin);
+    }
+    if (this->GG != nullptr)
+    {
+        this->GG->initialize_pvpR(*this->ucell, GridD_in, this->nspin);
+    }
+    return true;
+}
+
 template<>
 void Veff<OperatorLCAO<double, double>>::contributeHR()
 {
@@ -49,7 +49,9 @@ class Veff<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
     {
         this->cal_type = calculation_type::lcao_gint;
 
-        this->initialize_HR(ucell_in, GridD_in);
+        this->initialize_HR(ucell_in, GridD_in, this->hR);
+        // allocate the memory of BaseMatrix in HR, and set the new values to zero
+        this->hR->allocate(nullptr, true);
         GK_in->initialize_pvpR(*ucell_in, GridD_in, nspin);
     }
     /**
@@ -65,10 +67,13 @@ class Veff<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
                                const std::vector<double>& orb_cutoff,
                                const Grid_Driver* GridD_in,
                                const int& nspin)
-        : GG(GG_in), orb_cutoff_(orb_cutoff), pot(pot_in), OperatorLCAO<TK, TR>(hsk_in, kvec_d_in, hR_in)
+        : GG(GG_in), orb_cutoff_(orb_cutoff), pot(pot_in), ucell(ucell_in),
+          gd(GridD_in), OperatorLCAO<TK, TR>(hsk_in, kvec_d_in, hR_in)
     {
         this->cal_type = calculation_type::lcao_gint;
-        this->initialize_HR(ucell_in, GridD_in);
+        this->initialize_HR(ucell_in, GridD_in, this->hR);
+        // allocate the memory of BaseMatrix in HR, and set the new values to zero
+        this->hR->allocate(nullptr, true);
 
         GG_in->initialize_pvpR(*ucell_in, GridD_in, nspin);
     }
@@ -82,6 +87,11 @@ class Veff<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
      * grid integration is used to calculate the contribution Hamiltonian of effective potential
      */
     virtual void contributeHR() override;
+
+    /**
+     * @brief search the new atom-pairs for the moved atoms, the grid integration should be prepared before
+     */
+    virtual bool update_neighbors(const Grid_Driver* GridD_in, HContainer<TR>* hR_new) override;
   
   const UnitCell* ucell;
   const Grid_Driver* gd;
@@ -104,9 +114,9 @@ private:
   /**
    * @brief initialize HR, search the nearest neighbor atoms
    * HContainer is used to store the electronic kinetic matrix with specific <I,J,R> atom-pairs
-   * the size of HR will be fixed after initialization
+   * the atom-pairs are inserted into hR_in, which should be allocated after initialization
    */
-  void initialize_HR(const UnitCell* ucell_in, const Grid_Driver* GridD_in);
+  void initialize_HR(const UnitCell* ucell_in, const Grid_Driver* GridD_in, HContainer<TR>* hR_in);
 };
 
 } // namespace hamilt
@@ -190,17 +190,17 @@ void sparse_format::cal_dSTN_R(const UnitCell& ucell,
                                 temp_value_double = fsr.DHloc_fixedR_x[index];
                                 if (std::abs(temp_value_double) > sparse_thr)
                                 {
-                                    HS_Arrays.dHRx_sparse[current_spin][dR][iw1_all][iw2_all] = temp_value_double;
+                                    HS_Arrays.dHRx_sparse[current_spin][dR].add(iw1_all, iw2_all, temp_value_double);
                                 }
                                 temp_value_double = fsr.DHloc_fixedR_y[index];
                                 if (std::abs(temp_value_double) > sparse_thr)
                                 {
-                                    HS_Arrays.dHRy_sparse[current_spin][dR][iw1_all][iw2_all] = temp_value_double;
+                                    HS_Arrays.dHRy_sparse[current_spin][dR].add(iw1_all, iw2_all, temp_value_double);
                                 }
                                 temp_value_double = fsr.DHloc_fixedR_z[index];
                                 if (std::abs(temp_value_double) > sparse_thr)
                                 {
-                                    HS_Arrays.dHRz_sparse[current_spin][dR][iw1_all][iw2_all] = temp_value_double;
+                                    HS_Arrays.dHRz_sparse[current_spin][dR].add(iw1_all, iw2_all, temp_value_double);
                                 }
                             }
                             else
@@ -215,6 +215,10 @@ void sparse_format::cal_dSTN_R(const UnitCell& ucell,
         }
     }
 
+    hamilt::finalize_sparse_R(HS_Arrays.dHRx_sparse[current_spin], sparse_thr);
+    hamilt::finalize_sparse_R(HS_Arrays.dHRy_sparse[current_spin], sparse_thr);
+    hamilt::finalize_sparse_R(HS_Arrays.dHRz_sparse[current_spin], sparse_thr);
+
     return;
 }
 
@@ -224,32 +228,18 @@ void sparse_format::destroy_dH_R_sparse(LCAO_HS_Arrays& HS_Arrays)
 
     if (PARAM.inp.nspin != 4)
     {
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, double>>> empty_dHRx_sparse_up;
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, double>>> empty_dHRx_sparse_down;
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, double>>> empty_dHRy_sparse_up;
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, double>>> empty_dHRy_sparse_down;
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, double>>> empty_dHRz_sparse_up;
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, double>>> empty_dHRz_sparse_down;
-
-        HS_Arrays.dHRx_sparse[0].swap(empty_dHRx_sparse_up);
-        HS_Arrays.dHRx_sparse[1].swap(empty_dHRx_sparse_down);
-        HS_Arrays.dHRy_sparse[0].swap(empty_dHRy_sparse_up);
-        HS_Arrays.dHRy_sparse[1].swap(empty_dHRy_sparse_down);
-        HS_Arrays.dHRz_sparse[0].swap(empty_dHRz_sparse_up);
-        HS_Arrays.dHRz_sparse[1].swap(empty_dHRz_sparse_down);
+        for (int ispin = 0; ispin < 2; ++ispin)
+        {
+            hamilt::SparseCSR_R<double>().swap(HS_Arrays.dHRx_sparse[ispin]);
+            hamilt::SparseCSR_R<double>().swap(HS_Arrays.dHRy_sparse[ispin]);
+            hamilt::SparseCSR_R<double>().swap(HS_Arrays.dHRz_sparse[ispin]);
+        }
     }
     else
     {
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, std::complex<double>>>>
-            empty_dHRx_soc_sparse;
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, std::complex<double>>>>
-            empty_dHRy_soc_sparse;
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, std::complex<double>>>>
-            empty_dHRz_soc_sparse;
-
-        HS_Arrays.dHRx_soc_sparse.swap(empty_dHRx_soc_sparse);
-        HS_Arrays.dHRy_soc_sparse.swap(empty_dHRy_soc_sparse);
-        HS_Arrays.dHRz_soc_sparse.swap(empty_dHRz_soc_sparse);
+        hamilt::SparseCSR_R<std::complex<double>>().swap(HS_Arrays.dHRx_soc_sparse);
+        hamilt::SparseCSR_R<std::complex<double>>().swap(HS_Arrays.dHRy_soc_sparse);
+        hamilt::SparseCSR_R<std::complex<double>>().swap(HS_Arrays.dHRz_soc_sparse);
     }
 
     return;
@@ -48,6 +48,9 @@ void sparse_format::cal_HSR(const UnitCell& ucell,
                                             HS_Arrays.HR_sparse[current_spin]);
         }
 
+        // S(R) does not depend on spin, it is rebuilt for each spin because
+        // cal_HContainer_d() adds to the elements already in the target
+        HS_Arrays.SR_sparse.clear();
         sparse_format::cal_HContainer_d(pv,
                                         current_spin,
                                         sparse_thr,
@@ -65,6 +68,7 @@ void sparse_format::cal_HSR(const UnitCell& ucell,
                                          *(p_ham_lcao->getHR()),
                                          HS_Arrays.HR_soc_sparse);
 
+        HS_Arrays.SR_soc_sparse.clear();
         sparse_format::cal_HContainer_cd(pv,
                                          current_spin,
                                          sparse_thr,
@@ -128,41 +132,57 @@ void sparse_format::cal_HSR(const UnitCell& ucell,
     return;
 }
 
-void sparse_format::cal_HContainer_d(
-    const Parallel_Orbitals& pv,
-    const int& current_spin,
-    const double& sparse_thr,
-    const hamilt::HContainer<double>& hR,
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, double>>>& target) {
-    ModuleBase::TITLE("sparse_format", "cal_HContainer_d");
-
+namespace
+{
+// bulk fill of one sparse O(R) from HContainer, the R-block of target is looked up
+// once for each atom-pair and R, and elements are staged contiguously into it
+template <typename TR, typename TS>
+void fill_HContainer(const Parallel_Orbitals& pv,
+                     const double& sparse_thr,
+                     const hamilt::HContainer<TR>& hR,
+                     hamilt::SparseCSR_R<TS>& target)
+{
     auto row_indexes = pv.get_indexes_row();
     auto col_indexes = pv.get_indexes_col();
     for (int iap = 0; iap < hR.size_atom_pairs(); ++iap) {
-        int atom_i = hR.get_atom_pair(iap).get_atom_i();
-        int atom_j = hR.get_atom_pair(iap).get_atom_j();
+        const hamilt::AtomPair<TR>& atom_pair = hR.get_atom_pair(iap);
+        int atom_i = atom_pair.get_atom_i();
+        int atom_j = atom_pair.get_atom_j();
         int start_i = pv.atom_begin_row[atom_i];
         int start_j = pv.atom_begin_col[atom_j];
         int row_size = pv.get_row_size(atom_i);
         int col_size = pv.get_col_size(atom_j);
-        for (int iR = 0; iR < hR.get_atom_pair(iap).get_R_size(); ++iR) {
-            auto& matrix = hR.get_atom_pair(iap).get_HR_values(iR);
-            const ModuleBase::Vector3<int> r_index
-                = hR.get_atom_pair(iap).get_R_index(iR);
+        for (int iR = 0; iR < atom_pair.get_R_size(); ++iR) {
+            auto& matrix = atom_pair.get_HR_values(iR);
+            const ModuleBase::Vector3<int> r_index = atom_pair.get_R_index(iR);
             Abfs::Vector3_Order<int> dR(r_index.x, r_index.y, r_index.z);
+            hamilt::SparseCSR<TS>& target_R = target[dR];
+            target_R.reserve(row_size * col_size);
             for (int i = 0; i < row_size; ++i) {
                 int mu = row_indexes[start_i + i];
                 for (int j = 0; j < col_size; ++j) {
                     int nu = col_indexes[start_j + j];
-                    const auto& value_tmp = matrix.get_value(i, j);
+                    const TS value_tmp = static_cast<TS>(matrix.get_value(i, j));
                     if (std::abs(value_tmp) > sparse_thr) {
-                        target[dR][mu][nu] = value_tmp;
+                        target_R.add(mu, nu, value_tmp);
                     }
                 }
             }
         }
     }
+    hamilt::finalize_sparse_R(target, sparse_thr);
+}
+} // namespace
+
+void sparse_format::cal_HContainer_d(
+    const Parallel_Orbitals& pv,
+    const int& current_spin,
+    const double& sparse_thr,
+    const hamilt::HContainer<double>& hR,
+    hamilt::SparseCSR_R<double>& target) {
+    ModuleBase::TITLE("sparse_format", "cal_HContainer_d");
+
+    fill_HContainer(pv, sparse_thr, hR, target);
 
     return;
 }
@@ -172,37 +192,10 @@ void sparse_format::cal_HContainer_cd(
     const int& current_spin,
     const double& sparse_thr,
     const hamilt::HContainer<std::complex<double>>& hR,
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, std::complex<double>>>>&
-        target) {
+    hamilt::SparseCSR_R<std::complex<double>>& target) {
     ModuleBase::TITLE("sparse_format", "cal_HContainer_cd");
 
-    auto row_indexes = pv.get_indexes_row();
-    auto col_indexes = pv.get_indexes_col();
-    for (int iap = 0; iap < hR.size_atom_pairs(); ++iap) {
-        int atom_i = hR.get_atom_pair(iap).get_atom_i();
-        int atom_j = hR.get_atom_pair(iap).get_atom_j();
-        int start_i = pv.atom_begin_row[atom_i];
-        int start_j = pv.atom_begin_col[atom_j];
-        int row_size = pv.get_row_size(atom_i);
-        int col_size = pv.get_col_size(atom_j);
-        for (int iR = 0; iR < hR.get_atom_pair(iap).get_R_size(); ++iR) {
-            auto& matrix = hR.get_atom_pair(iap).get_HR_values(iR);
-            const ModuleBase::Vector3<int> r_index
-                = hR.get_atom_pair(iap).get_R_index(iR);
-            Abfs::Vector3_Order<int> dR(r_index.x, r_index.y, r_index.z);
-            for (int i = 0; i < row_size; ++i) {
-                int mu = row_indexes[start_i + i];
-                for (int j = 0; j < col_size; ++j) {
-                    int nu = col_indexes[start_j + j];
-                    const auto& value_tmp = matrix.get_value(i, j);
-                    if (std::abs(value_tmp) > sparse_thr) {
-                        target[dR][mu][nu] = value_tmp;
-                    }
-                }
-            }
-        }
-    }
+    fill_HContainer(pv, sparse_thr, hR, target);
 
     return;
 }
@@ -212,38 +205,11 @@ void sparse_format::cal_HContainer_td(
     const int& current_spin,
     const double& sparse_thr,
     const hamilt::HContainer<double>& hR,
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, std::complex<double>>>>&
-        target) {
+    hamilt::SparseCSR_R<std::complex<double>>& target) {
     ModuleBase::TITLE("sparse_format", "cal_HContainer_td");
 
-    auto row_indexes = pv.get_indexes_row();
-    auto col_indexes = pv.get_indexes_col();
-    for (int iap = 0; iap < hR.size_atom_pairs(); ++iap) {
-        int atom_i = hR.get_atom_pair(iap).get_atom_i();
-        int atom_j = hR.get_atom_pair(iap).get_atom_j();
-        int start_i = pv.atom_begin_row[atom_i];
-        int start_j = pv.atom_begin_col[atom_j];
-        int row_size = pv.get_row_size(atom_i);
-        int col_size = pv.get_col_size(atom_j);
-        for (int iR = 0; iR < hR.get_atom_pair(iap).get_R_size(); ++iR) {
-            auto& matrix = hR.get_atom_pair(iap).get_HR_values(iR);
-            const ModuleBase::Vector3<int> r_index
-                = hR.get_atom_pair(iap).get_R_index(iR);
-            Abfs::Vector3_Order<int> dR(r_index.x, r_index.y, r_index.z);
-            for (int i = 0; i < row_size; ++i) {
-                int mu = row_indexes[start_i + i];
-                for (int j = 0; j < col_size; ++j) {
-                    int nu = col_indexes[start_j + j];
-                    const auto& value_tmp
-                        = std::complex<double>(matrix.get_value(i, j), 0.0);
-                    if (std::abs(value_tmp) > sparse_thr) {
-                        target[dR][mu][nu] += value_tmp;
-                    }
-                }
-            }
-        }
-    }
+    // the elements are added to the ones already in target
+    fill_HContainer(pv, sparse_thr, hR, target);
 
     return;
 }
@@ -254,78 +220,19 @@ void sparse_format::clear_zero_elements(LCAO_HS_Arrays& HS_Arrays,
                                         const double& sparse_thr) {
     ModuleBase::TITLE("sparse_format", "clear_zero_elements");
 
+    // finalize() merges the staged elements and drops the ones
+    // not larger than sparse_thr
     if (PARAM.inp.nspin != 4) {
-        for (auto& R_loop: HS_Arrays.HR_sparse[current_spin]) {
-            for (auto& row_loop: R_loop.second) {
-                auto& col_map = row_loop.second;
-                auto iter = col_map.begin();
-                while (iter != col_map.end()) {
-                    if (std::abs(iter->second) <= sparse_thr) {
-                        col_map.erase(iter++);
-                    } else {
-                        iter++;
-                    }
-                }
-            }
-        }
+        hamilt::finalize_sparse_R(HS_Arrays.HR_sparse[current_spin], sparse_thr);
         if (TD_Velocity::tddft_velocity) {
-            for (auto& R_loop:
-                 TD_Velocity::td_vel_op->HR_sparse_td_vel[current_spin]) {
-                for (auto& row_loop: R_loop.second) {
-                    auto& col_map = row_loop.second;
-                    auto iter = col_map.begin();
-                    while (iter != col_map.end()) {
-                        if (std::abs(iter->second) <= sparse_thr) {
-                            col_map.erase(iter++);
-                        } else {
-                            iter++;
-                        }
-                    }
-                }
-            }
-        }
-
-        for (auto& R_loop: HS_Arrays.SR_sparse) {
-            for (auto& row_loop: R_loop.second) {
-                auto& col_map = row_loop.second;
-                auto iter = col_map.begin();
-                while (iter != col_map.end()) {
-                    if (std::abs(iter->second) <= sparse_thr) {
-                        col_map.erase(iter++);
-                    } else {
-                        iter++;
-                    }
-                }
-            }
+            hamilt::finalize_sparse_R(
+                TD_Velocity::td_vel_op->HR_sparse_td_vel[current_spin],
+                sparse_thr);
         }
+        hamilt::finalize_sparse_R(HS_Arrays.SR_sparse, sparse_thr);
     } else {
-        for (auto& R_loop: HS_Arrays.HR_soc_sparse) {
-            for (auto& row_loop: R_loop.second) {
-                auto& col_map = row_loop.second;
-                auto iter = col_map.begin();
-                while (iter != col_map.end()) {
-                    if (std::abs(iter->second) <= sparse_thr) {
-                        col_map.erase(iter++);
-                    } else {
-                        iter++;
-                    }
-                } // end while iter
-            }     // end row loop
-        }         // end R loop
-
-        for (auto& R_loop: HS_Arrays.SR_soc_sparse) {
-            for (auto& row_loop: R_loop.second) {
-                auto& col_map = row_loop.second;
-                auto iter = col_map.begin();
-                while (iter != col_map.end()) {
-                    if (std::abs(iter->second) <= sparse_thr) {
-                        col_map.erase(iter++);
-                    } else {
-                        iter++;
-                    }
-                } // end while iter
-            }     // end row_loop
-        }         // end R_loop
+        hamilt::finalize_sparse_R(HS_Arrays.HR_soc_sparse, sparse_thr);
+        hamilt::finalize_sparse_R(HS_Arrays.SR_soc_sparse, sparse_thr);
     }
 
     return;
@@ -335,27 +242,12 @@ void sparse_format::destroy_HS_R_sparse(LCAO_HS_Arrays& HS_Arrays) {
     ModuleBase::TITLE("sparse_format", "destroy_HS_R_sparse");
 
     if (PARAM.inp.nspin != 4) {
-        std::map<Abfs::Vector3_Order<int>,
-                 std::map<size_t, std::map<size_t, double>>>
-            empty_HR_sparse_up;
-        std::map<Abfs::Vector3_Order<int>,
-                 std::map<size_t, std::map<size_t, double>>>
-            empty_HR_sparse_down;
-        std::map<Abfs::Vector3_Order<int>,
-                 std::map<size_t, std::map<size_t, double>>>
-            empty_SR_sparse;
-        HS_Arrays.HR_sparse[0].swap(empty_HR_sparse_up);
-        HS_Arrays.HR_sparse[1].swap(empty_HR_sparse_down);
-        HS_Arrays.SR_sparse.swap(empty_SR_sparse);
+        hamilt::SparseCSR_R<double>().swap(HS_Arrays.HR_sparse[0]);
+        hamilt::SparseCSR_R<double>().swap(HS_Arrays.HR_sparse[1]);
+        hamilt::SparseCSR_R<double>().swap(HS_Arrays.SR_sparse);
     } else {
-        std::map<Abfs::Vector3_Order<int>,
-                 std::map<size_t, std::map<size_t, std::complex<double>>>>
-            empty_HR_soc_sparse;
-        std::map<Abfs::Vector3_Order<int>,
-                 std::map<size_t, std::map<size_t, std::complex<double>>>>
-            empty_SR_soc_sparse;
-        HS_Arrays.HR_soc_sparse.swap(empty_HR_soc_sparse);
-        HS_Arrays.SR_soc_sparse.swap(empty_SR_soc_sparse);
+        hamilt::SparseCSR_R<std::complex<double>>().swap(HS_Arrays.HR_soc_sparse);
+        hamilt::SparseCSR_R<std::complex<double>>().swap(HS_Arrays.SR_soc_sparse);
     }
 
     // 'all_R_coor' has a small memory requirement and does not need to be
@@ -363,4 +255,4 @@ void sparse_format::destroy_HS_R_sparse(LCAO_HS_Arrays& HS_Arrays) {
     // all_R_coor.swap(empty_all_R_coor);
 
     return;
-}
\ No newline at end of file
+}
@@ -25,24 +25,21 @@ void cal_HContainer_d(
     const int& current_spin,
     const double& sparse_threshold,
     const hamilt::HContainer<double>& hR,
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, double>>>& target);
+    hamilt::SparseCSR_R<double>& target);
 
 void cal_HContainer_cd(
     const Parallel_Orbitals& pv,
     const int& current_spin,
     const double& sparse_threshold,
     const hamilt::HContainer<std::complex<double>>& hR,
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, std::complex<double>>>>& target);
+    hamilt::SparseCSR_R<std::complex<double>>& target);
 
 void cal_HContainer_td(
     const Parallel_Orbitals& pv,
     const int& current_spin,
     const double& sparse_threshold,
     const hamilt::HContainer<double>& hR,
-    std::map<Abfs::Vector3_Order<int>,
-             std::map<size_t, std::map<size_t, std::complex<double>>>>& target);
+    hamilt::SparseCSR_R<std::complex<double>>& target);
 
 void clear_zero_elements(LCAO_HS_Arrays& HS_Arrays,
                          const int& current_spin,
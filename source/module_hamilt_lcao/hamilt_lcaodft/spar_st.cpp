@@ -12,8 +12,8 @@
 void sparse_format::cal_SR(
     const Parallel_Orbitals& pv,
     std::set<Abfs::Vector3_Order<int>>& all_R_coor,
-    std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, double>>>& SR_sparse,
-    std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, std::complex<double>>>>& SR_soc_sparse,
+    hamilt::SparseCSR_R<double>& SR_sparse,
+    hamilt::SparseCSR_R<std::complex<double>>& SR_soc_sparse,
     const Grid_Driver& grid,
     const double& sparse_thr,
     hamilt::Hamilt<std::complex<double>>* p_ham)
@@ -179,8 +179,9 @@ void sparse_format::cal_STN_R_for_T(const UnitCell& ucell,
                             if (nspin == 1 || nspin == 2) {
                                 tmp = HS_arrays.Hloc_fixedR[index];
                                 if (std::abs(tmp) > sparse_thr) {
-                                    HS_arrays.TR_sparse[dR][iw1_all][iw2_all]
-                                        = tmp;
+                                    HS_arrays.TR_sparse[dR].add(iw1_all,
+                                                                iw2_all,
+                                                                tmp);
                                 }
                             }
 
@@ -192,6 +193,8 @@ void sparse_format::cal_STN_R_for_T(const UnitCell& ucell,
         }
     }
 
+    hamilt::finalize_sparse_R(HS_arrays.TR_sparse, sparse_thr);
+
     return;
 }
 
@@ -199,10 +202,7 @@ void sparse_format::destroy_T_R_sparse(LCAO_HS_Arrays& HS_Arrays) {
     ModuleBase::TITLE("sparse_format", "destroy_T_R_sparse");
 
     if (PARAM.inp.nspin != 4) {
-        std::map<Abfs::Vector3_Order<int>,
-                 std::map<size_t, std::map<size_t, double>>>
-            empty_TR_sparse;
-        HS_Arrays.TR_sparse.swap(empty_TR_sparse);
+        hamilt::SparseCSR_R<double>().swap(HS_Arrays.TR_sparse);
     }
     return;
 }
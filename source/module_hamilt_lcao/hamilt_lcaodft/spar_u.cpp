@@ -8,8 +8,8 @@
 void sparse_format::cal_HR_dftu(
 	    const Parallel_Orbitals &pv,
         std::set<Abfs::Vector3_Order<int>> &all_R_coor,
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, double>>> &SR_sparse,
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, double>>> *HR_sparse,
+        hamilt::SparseCSR_R<double> &SR_sparse,
+        hamilt::SparseCSR_R<double> *HR_sparse,
 		const int &current_spin, 
 		const double &sparse_thr)
 {
@@ -26,10 +26,7 @@ void sparse_format::cal_HR_dftu(
         auto iter = SR_sparse.find(R_coor);
         if (iter != SR_sparse.end())
         {
-            for (auto &row_loop : iter->second)
-            {
-                nonzero_num[count] += row_loop.second.size();
-            }
+            nonzero_num[count] += iter->second.nnz();
         }
         count++;
     }
@@ -55,12 +52,13 @@ void sparse_format::cal_HR_dftu(
             auto iter = SR_sparse.find(R_coor);
             if (iter != SR_sparse.end())
             {
-                for (auto &row_loop : iter->second)
+                const auto& S_R = iter->second;
+                for (int irow = 0; irow < S_R.nrows(); ++irow)
                 {
-                    ir = pv.global2local_row(row_loop.first);
-                    for (auto &col_loop : row_loop.second)
+                    ir = pv.global2local_row(S_R.rows()[irow]);
+                    for (int k = S_R.row_ptr()[irow]; k < S_R.row_ptr()[irow + 1]; ++k)
                     {
-                        ic = pv.global2local_col(col_loop.first);
+                        ic = pv.global2local_col(S_R.col_ind()[k]);
                         if (ModuleBase::GlobalFunc::IS_COLUMN_MAJOR_KS_SOLVER(PARAM.inp.ks_solver))
                         {
                             iic = ir + ic * pv.nrow;
@@ -69,7 +67,7 @@ void sparse_format::cal_HR_dftu(
                         {
                             iic = ir * pv.ncol + ic;
                         }
-                        SR_tmp[iic] = col_loop.second;
+                        SR_tmp[iic] = S_R.values()[k];
                     }
                 }
             }
@@ -97,12 +95,7 @@ void sparse_format::cal_HR_dftu(
 
                             if (std::abs(HR_tmp[iic]) > sparse_thr)
                             {
-                                double &value = temp_HR_sparse[R_coor][i][j];
-                                value += HR_tmp[iic];
-                                if (std::abs(value) <= sparse_thr)
-                                {
-                                    temp_HR_sparse[R_coor][i].erase(j);
-                                }
+                                temp_HR_sparse[R_coor].add(i, j, HR_tmp[iic]);
                             }
                         }
                     }
@@ -114,6 +107,8 @@ void sparse_format::cal_HR_dftu(
         count++;
     }
 
+    hamilt::finalize_sparse_R(temp_HR_sparse, sparse_thr);
+
     delete[] nonzero_num;
     delete[] HR_tmp;
     delete[] SR_tmp;
@@ -130,8 +125,8 @@ void sparse_format::cal_HR_dftu(
 void sparse_format::cal_HR_dftu_soc(
 	    const Parallel_Orbitals &pv,
         std::set<Abfs::Vector3_Order<int>> &all_R_coor,
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, std::complex<double>>>> &SR_soc_sparse,
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, std::complex<double>>>> &HR_soc_sparse,
+        hamilt::SparseCSR_R<std::complex<double>> &SR_soc_sparse,
+        hamilt::SparseCSR_R<std::complex<double>> &HR_soc_sparse,
 		const int &current_spin, 
 		const double &sparse_thr)
 {
@@ -147,10 +142,7 @@ void sparse_format::cal_HR_dftu_soc(
         auto iter = SR_soc_sparse.find(R_coor);
         if (iter != SR_soc_sparse.end())
         {
-            for (auto &row_loop : iter->second)
-            {
-                nonzero_num[count] += row_loop.second.size();
-            }
+            nonzero_num[count] += iter->second.nnz();
         }
         count++;
     }
@@ -175,12 +167,13 @@ void sparse_format::cal_HR_dftu_soc(
             auto iter = SR_soc_sparse.find(R_coor);
             if (iter != SR_soc_sparse.end())
             {
-                for (auto &row_loop : iter->second)
+                const auto& S_R = iter->second;
+                for (int irow = 0; irow < S_R.nrows(); ++irow)
                 {
-                    ir = pv.global2local_row(row_loop.first);
-                    for (auto &col_loop : row_loop.second)
+                    ir = pv.global2local_row(S_R.rows()[irow]);
+                    for (int k = S_R.row_ptr()[irow]; k < S_R.row_ptr()[irow + 1]; ++k)
                     {
-                        ic = pv.global2local_col(col_loop.first);
+                        ic = pv.global2local_col(S_R.col_ind()[k]);
                         if (ModuleBase::GlobalFunc::IS_COLUMN_MAJOR_KS_SOLVER(PARAM.inp.ks_solver))
                         {
                             iic = ir + ic * pv.nrow;
@@ -189,7 +182,7 @@ void sparse_format::cal_HR_dftu_soc(
                         {
                             iic = ir * pv.ncol + ic;
                         }
-                        SR_soc_tmp[iic] = col_loop.second;
+                        SR_soc_tmp[iic] = S_R.values()[k];
                     }
                 }
             }
@@ -217,12 +210,7 @@ void sparse_format::cal_HR_dftu_soc(
 
                             if (std::abs(HR_soc_tmp[iic]) > sparse_thr)
                             {
-                                std::complex<double> &value = HR_soc_sparse[R_coor][i][j];
-                                value += HR_soc_tmp[iic];
-                                if (std::abs(value) <= sparse_thr)
-                                {
-                                    HR_soc_sparse[R_coor][i].erase(j);
-                                }
+                                HR_soc_sparse[R_coor].add(i, j, HR_soc_tmp[iic]);
                             }
                         }
                     }
@@ -234,6 +222,8 @@ void sparse_format::cal_HR_dftu_soc(
         count++;
     }
 
+    hamilt::finalize_sparse_R(HR_soc_sparse, sparse_thr);
+
     delete[] nonzero_num;
     delete[] HR_soc_tmp;
     delete[] SR_soc_tmp;
@@ -13,16 +13,16 @@ namespace sparse_format
 	void cal_HR_dftu(
 		const Parallel_Orbitals &pv,
 		std::set<Abfs::Vector3_Order<int>> &all_R_coor,
-		std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, double>>> &SR_sparse,
-		std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, double>>> *HR_sparse,
+		hamilt::SparseCSR_R<double> &SR_sparse,
+		hamilt::SparseCSR_R<double> *HR_sparse,
 		const int &current_spin, 
 		const double &sparse_thr);
 
 	void cal_HR_dftu_soc(
 		const Parallel_Orbitals &pv,
 		std::set<Abfs::Vector3_Order<int>> &all_R_coor,
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, std::complex<double>>>> &SR_soc_sparse,
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, std::complex<double>>>> &HR_soc_sparse,
+        hamilt::SparseCSR_R<std::complex<double>> &SR_soc_sparse,
+        hamilt::SparseCSR_R<std::complex<double>> &HR_soc_sparse,
 		const int &current_spin, 
 		const double &sparse_thr);
 
@@ -60,6 +60,11 @@ void Gint_k::distribute_pvdpR_sparseMatrix(
     double* tmp = nullptr;
     tmp = new double[PARAM.globalv.nlocal];
 
+    // the gint part is added to the two-center part of dH(R)
+    hamilt::SparseCSR_R<double>& target = (dim == 0)   ? HS_Arrays.dHRx_sparse[current_spin]
+                                         : (dim == 1) ? HS_Arrays.dHRy_sparse[current_spin]
+                                                      : HS_Arrays.dHRz_sparse[current_spin];
+
     count = 0;
     for (auto& R_coor: HS_Arrays.all_R_coor)
     {
@@ -118,33 +123,7 @@ void Gint_k::distribute_pvdpR_sparseMatrix(
                         {
                             if (std::abs(tmp[col]) > sparse_threshold)
                             {
-                                if (dim == 0)
-                                {
-                                    double& value = HS_Arrays.dHRx_sparse[current_spin][R_coor][row][col];
-                                    value += tmp[col];
-                                    if (std::abs(value) <= sparse_threshold)
-                                    {
-                                        HS_Arrays.dHRx_sparse[current_spin][R_coor][row].erase(col);
-                                    }
-                                }
-                                if (dim == 1)
-                                {
-                                    double& value = HS_Arrays.dHRy_sparse[current_spin][R_coor][row][col];
-                                    value += tmp[col];
-                                    if (std::abs(value) <= sparse_threshold)
-                                    {
-                                        HS_Arrays.dHRy_sparse[current_spin][R_coor][row].erase(col);
-                                    }
-                                }
-                                if (dim == 2)
-                                {
-                                    double& value = HS_Arrays.dHRz_sparse[current_spin][R_coor][row][col];
-                                    value += tmp[col];
-                                    if (std::abs(value) <= sparse_threshold)
-                                    {
-                                        HS_Arrays.dHRz_sparse[current_spin][R_coor][row].erase(col);
-                                    }
-                                }
+                                target[R_coor].add(row, col, tmp[col]);
                             }
                         }
                     }
@@ -155,6 +134,8 @@ void Gint_k::distribute_pvdpR_sparseMatrix(
         count++;
     }
 
+    hamilt::finalize_sparse_R(target, sparse_threshold);
+
     delete[] nonzero_num;
     delete[] minus_nonzero_num;
     delete[] tmp;
@@ -214,6 +195,11 @@ void Gint_k::distribute_pvdpR_soc_sparseMatrix(
     std::complex<double>* tmp_soc = nullptr;
     tmp_soc = new std::complex<double>[PARAM.globalv.nlocal];
 
+    // the gint part is added to the two-center part of dH(R)
+    hamilt::SparseCSR_R<std::complex<double>>& target = (dim == 0)   ? HS_Arrays.dHRx_soc_sparse
+                                         : (dim == 1) ? HS_Arrays.dHRy_soc_sparse
+                                                      : HS_Arrays.dHRz_soc_sparse;
+
     count = 0;
     for (auto& R_coor: HS_Arrays.all_R_coor)
     {
@@ -271,33 +257,7 @@ void Gint_k::distribute_pvdpR_soc_sparseMatrix(
                         {
                             if (std::abs(tmp_soc[col]) > sparse_threshold)
                             {
-                                if (dim == 0)
-                                {
-                                    std::complex<double>& value = HS_Arrays.dHRx_soc_sparse[R_coor][row][col];
-                                    value += tmp_soc[col];
-                                    if (std::abs(value) <= sparse_threshold)
-                                    {
-                                        HS_Arrays.dHRx_soc_sparse[R_coor][row].erase(col);
-                                    }
-                                }
-                                if (dim == 1)
-                                {
-                                    std::complex<double>& value = HS_Arrays.dHRy_soc_sparse[R_coor][row][col];
-                                    value += tmp_soc[col];
-                                    if (std::abs(value) <= sparse_threshold)
-                                    {
-                                        HS_Arrays.dHRy_soc_sparse[R_coor][row].erase(col);
-                                    }
-                                }
-                                if (dim == 2)
-                                {
-                                    std::complex<double>& value = HS_Arrays.dHRz_soc_sparse[R_coor][row][col];
-                                    value += tmp_soc[col];
-                                    if (std::abs(value) <= sparse_threshold)
-                                    {
-                                        HS_Arrays.dHRz_soc_sparse[R_coor][row].erase(col);
-                                    }
-                                }
+                                target[R_coor].add(row, col, tmp_soc[col]);
                             }
                         }
                     }
@@ -308,6 +268,8 @@ void Gint_k::distribute_pvdpR_soc_sparseMatrix(
         count++;
     }
 
+    hamilt::finalize_sparse_R(target, sparse_threshold);
+
     delete[] nonzero_num;
     delete[] minus_nonzero_num;
     delete[] tmp_soc;
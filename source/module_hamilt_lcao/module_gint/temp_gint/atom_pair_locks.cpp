@@ -0,0 +1,50 @@
+#include "atom_pair_locks.h"
+#include "module_base/blas_connector.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace ModuleGint
+{
+
+AtomPairLocks::AtomPairLocks(int nlocks) : nlocks_(nlocks)
+{
+#ifdef _OPENMP
+    stride_ = std::max(1, static_cast<int>(64 / sizeof(omp_lock_t)));
+    locks_.resize(static_cast<size_t>(nlocks_) * stride_);
+    for(int i = 0; i < nlocks_; ++i)
+    {
+        omp_init_lock(&locks_[i * stride_]);
+    }
+#endif
+}
+
+AtomPairLocks::~AtomPairLocks()
+{
+#ifdef _OPENMP
+    for(int i = 0; i < nlocks_; ++i)
+    {
+        omp_destroy_lock(&locks_[i * stride_]);
+    }
+#endif
+}
+
+int AtomPairLocks::get_lock_idx_(const void* dst) const
+{
+    // the matrices of different atom pairs are at least one cache line apart in most cases
+    return static_cast<int>((reinterpret_cast<std::uintptr_t>(dst) >> 6) % nlocks_);
+}
+
+void AtomPairLocks::add(double* dst, const double* src, const int size)
+{
+#ifdef _OPENMP
+    omp_lock_t* lock = &locks_[get_lock_idx_(dst) * stride_];
+    omp_set_lock(lock);
+    BlasConnector::axpy(size, 1.0, src, 1, dst, 1);
+    omp_unset_lock(lock);
+#else
+    BlasConnector::axpy(size, 1.0, src, 1, dst, 1);
+#endif
+}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace ModuleGint
+{
+
+/**
+ * @brief Striped locks guarding the matrices of atom pairs in an HContainer shared by all threads.
+ *
+ * Gint kernels accumulate <phi_i|V|phi_j> of each big grid into the matrices of atom pairs.
+ * Instead of giving every thread a private copy of the whole HContainer and merging them afterwards,
+ * the threads add their contribution of one atom pair directly to the shared HContainer,
+ * guarded by the lock that the address of the destination matrix is hashed to.
+ * The memory does not grow with the number of threads, and two threads only wait for each other
+ * when they update atom pairs hashed to the same lock at the same time.
+ */
+class AtomPairLocks
+{
+    public:
+    // nlocks should be much larger than the number of threads to make collisions rare
+    explicit AtomPairLocks(int nlocks = 4096);
+    ~AtomPairLocks();
+
+    AtomPairLocks(const AtomPairLocks&) = delete;
+    AtomPairLocks& operator=(const AtomPairLocks&) = delete;
+
+    // dst[i] += src[i] for i in [0, size), dst is guarded by the lock of its address
+    void add(double* dst, const double* src, const int size);
+
+    int get_nlocks() const { return nlocks_; };
+
+    private:
+    int get_lock_idx_(const void* dst) const;
+
+    int nlocks_;
+#ifdef _OPENMP
+    // only locks_[i * stride_] are used, so that two locks do not share one cache line
+    int stride_;
+    std::vector<omp_lock_t> locks_;
+#endif
+};
+
+}
@@ -1,11 +1,43 @@
 #include "module_base/ylm.h"
-#include "module_base/array_pool.h"
 #include "gint_atom.h"
 #include "gint_helper.h"
+#include "radial_interp.h"
+
+#include <algorithm>
 
 namespace ModuleGint
 {
 
+namespace
+{
+// phi = R(r) / r^l * (r^l Ylm) and its gradient of n points,
+// the arrays never overlap, so the pointers are declared __restrict to let the compiler vectorize the loop
+void orbital_kernel(const int n, const int l,
+                    const double* __restrict x, const double* __restrict y, const double* __restrict z,
+                    const double* __restrict inv_r, const double* __restrict inv_rl,
+                    const double* __restrict tmp, const double* __restrict dtmp,
+                    const double* __restrict rly, const double* __restrict grly_x,
+                    const double* __restrict grly_y, const double* __restrict grly_z,
+                    double* __restrict phi, double* __restrict dphi_x,
+                    double* __restrict dphi_y, double* __restrict dphi_z)
+{
+    for(int i = 0; i < n; i++)
+    {
+        const double tmprl = tmp[i] * inv_rl[i];
+
+        // 3D wave functions
+        phi[i] = tmprl * rly[i];
+
+        // derivative of wave functions with respect to atom positions.
+        const double tmpdphi_rly = (dtmp[i] - tmp[i] * l * inv_r[i]) * inv_rl[i] * rly[i] * inv_r[i];
+
+        dphi_x[i] = tmpdphi_rly * x[i] + tmprl * grly_x[i];
+        dphi_y[i] = tmpdphi_rly * y[i] + tmprl * grly_y[i];
+        dphi_z[i] = tmpdphi_rly * z[i] + tmprl * grly_z[i];
+    }
+}
+} // namespace
+
 template <typename T>
 void GintAtom::set_phi(const std::vector<Vec3d>& coords, const int stride, T* phi) const
 {
@@ -14,73 +46,80 @@ void GintAtom::set_phi(const std::vector<Vec3d>& coords, const int stride, T* ph
     // orb_ does not have the member variable dr_uniform
     const double dr_uniform = orb_->PhiLN(0, 0).dr_uniform;
 
-    // store the pointer to reduce repeated address fetching
-    std::vector<const double*> p_psi_uniform(atom_->nw);
-    std::vector<const double*> p_dpsi_uniform(atom_->nw);
-    for(int iw = 0; iw < atom_->nw; iw++)
-    {
-        if(atom_->iw2_new[iw])
-        {
-            int l = atom_->iw2l[iw];
-            int n = atom_->iw2n[iw];
-            p_psi_uniform[iw] = orb_->PhiLN(l, n).psi_uniform.data();
-            p_dpsi_uniform[iw] = orb_->PhiLN(l, n).dpsi_uniform.data();
-        }
-    }
-
-    // store the spherical harmonics
-    // it's outside the loop to reduce the vector allocation overhead
-    std::vector<double> ylma;
+    const int nlm = (atom_->nwl + 1) * (atom_->nwl + 1);
+    const double rcut = orb_->getRcut();
 
+    // the meshgrids within the cutoff radius, in structure-of-arrays layout.
+    // one buffer holds xdr, ydr, zdr, dist, the spherical harmonics ylma[lm * n + i],
+    // the radial function psi and the orbitals phi_n to reduce the allocations
+    std::vector<int> mgrid_idx(num_mgrids);
+    std::vector<double> buf((5 + nlm + atom_->nw) * num_mgrids);
+    double* xdr = buf.data();
+    double* ydr = xdr + num_mgrids;
+    double* zdr = ydr + num_mgrids;
+    double* dist = zdr + num_mgrids;
+    double* ylma = dist + num_mgrids;
+    double* psi = ylma + nlm * num_mgrids;
+    double* phi_n = psi + num_mgrids;
+    int n = 0;
     for(int im = 0; im < num_mgrids; im++)
     {
         const Vec3d& coord = coords[im];
-
         // 1e-9 is to avoid division by zero
-        const double dist = coord.norm() < 1e-9 ? 1e-9 : coord.norm();
-        if(dist > orb_->getRcut())
-        {   
+        const double norm = coord.norm();
+        const double d = norm < 1e-9 ? 1e-9 : norm;
+        if(d > rcut)
+        {
             // if the distance is larger than the cutoff radius,
             // the wave function values are all zeros
             ModuleBase::GlobalFunc::ZEROS(phi + im * stride, atom_->nw);
         }
         else
         {
-            // spherical harmonics
-            // TODO: vectorize the sph_harm function, 
-            // the vectorized function can be called once for all meshgrids in a biggrid
-            ModuleBase::Ylm::sph_harm(atom_->nwl, coord.x/dist, coord.y/dist, coord.z/dist, ylma);
-            // interpolation
-
-            // these parameters are related to interpolation
-            // because once the distance from atom to grid point is known,
-            // we can obtain the parameters for interpolation and
-            // store them first! these operations can save lots of efforts.
-            const double position = dist / dr_uniform;
-            const int ip = static_cast<int>(position);
-            const double dx = position - ip;
-            const double dx2 = dx * dx;
-            const double dx3 = dx2 * dx;
-
-            const double c3 = 3.0 * dx2 - 2.0 * dx3;
-            const double c1 = 1.0 - c3;
-            const double c2 = (dx - 2.0 * dx2 + dx3) * dr_uniform;
-            const double c4 = (dx3 - dx2) * dr_uniform;
-
-            // I'm not sure if the variable name 'psi' is appropriate
-            double psi = 0;
-            
-            for(int iw = 0; iw < atom_->nw; iw++)
-            {
-                if(atom_->iw2_new[iw])
-                {
-                    auto psi_uniform = p_psi_uniform[iw];
-                    auto dpsi_uniform = p_dpsi_uniform[iw];
-                    psi = c1 * psi_uniform[ip] + c2 * dpsi_uniform[ip]
-                        + c3 * psi_uniform[ip + 1] + c4 * dpsi_uniform[ip + 1];
-                }
-                phi[im * stride + iw] = psi * ylma[atom_->iw2_ylm[iw]];
-            }
+            mgrid_idx[n] = im;
+            const double inv_d = 1.0 / d;
+            xdr[n] = coord.x * inv_d;
+            ydr[n] = coord.y * inv_d;
+            zdr[n] = coord.z * inv_d;
+            dist[n] = d;
+            n++;
+        }
+    }
+    if(n == 0)
+    {
+        return;
+    }
+
+    // spherical harmonics of all meshgrids
+    ModuleBase::Ylm::sph_harm_batch(atom_->nwl, n, xdr, ydr, zdr, ylma);
+
+    // values of all orbitals at all meshgrids, phi_n[iw * n + i]
+    RadialInterp interp;
+    interp.set_hermite(n, dist, dr_uniform);
+    for(int iw = 0; iw < atom_->nw; iw++)
+    {
+        // this is a new 'l', we need 1D orbital wave
+        // function from interpolation method.
+        if(atom_->iw2_new[iw])
+        {
+            const Numerical_Orbital_Lm& philn = orb_->PhiLN(atom_->iw2l[iw], atom_->iw2n[iw]);
+            interp.hermite(philn.psi_uniform.data(), philn.dpsi_uniform.data(), psi);
+        }
+        const double* ylm_iw = ylma + atom_->iw2_ylm[iw] * n;
+        double* phi_iw = phi_n + iw * n;
+        for(int i = 0; i < n; i++)
+        {
+            phi_iw[i] = psi[i] * ylm_iw[i];
+        }
+    }
+
+    // the orbitals of one meshgrid are contiguous in phi
+    for(int i = 0; i < n; i++)
+    {
+        T* phi_i = phi + mgrid_idx[i] * stride;
+        for(int iw = 0; iw < atom_->nw; iw++)
+        {
+            phi_i[iw] = phi_n[iw * n + i];
         }
     }
 }
@@ -95,33 +134,22 @@ void GintAtom::set_phi_dphi(
     // orb_ does not have the member variable dr_uniform
     const double dr_uniform = orb_->PhiLN(0, 0).dr_uniform;
 
-    // store the pointer to reduce repeated address fetching
-    std::vector<const double*> p_psi_uniform(atom_->nw);
-    std::vector<const double*> p_dpsi_uniform(atom_->nw);
-    std::vector<int> phi_nr_uniform(atom_->nw);
-    for (int iw=0; iw< atom_->nw; ++iw)
-    {
-        if ( atom_->iw2_new[iw] )
-        {
-            int l = atom_->iw2l[iw];
-            int n = atom_->iw2n[iw];
-            p_psi_uniform[iw] = orb_->PhiLN(l, n).psi_uniform.data();
-            p_dpsi_uniform[iw] = orb_->PhiLN(l, n).dpsi_uniform.data();
-            phi_nr_uniform[iw] = orb_->PhiLN(l, n).nr_uniform;
-        }
-    }
-    
-    std::vector<double> rly(std::pow(atom_->nwl + 1, 2));
-    // TODO: replace array_pool with std::vector
-    ModuleBase::Array_Pool<double> grly(std::pow(atom_->nwl + 1, 2), 3);
-    
+    // the meshgrids within the cutoff radius, in structure-of-arrays layout.
+    // one buffer holds x, y, z, dist and phi, dphi of all meshgrids to reduce the allocations
+    std::vector<int> mgrid_idx(num_mgrids);
+    std::vector<double> buf((4 + 4 * atom_->nw) * num_mgrids);
+    double* x = buf.data();
+    double* y = x + num_mgrids;
+    double* z = y + num_mgrids;
+    double* dist = z + num_mgrids;
+    int n = 0;
     for(int im = 0; im < num_mgrids; im++)
     {
         const Vec3d& coord = coords[im];
         // 1e-9 is to avoid division by zero
-        const double dist = coord.norm() < 1e-9 ? 1e-9 : coord.norm();
-
-        if(dist > orb_->getRcut())
+        const double norm = coord.norm();
+        const double d = norm < 1e-9 ? 1e-9 : norm;
+        if(d > orb_->getRcut())
         {
             // if the distance is larger than the cutoff radius,
             // the wave function values are all zeros
@@ -135,73 +163,103 @@ void GintAtom::set_phi_dphi(
         }
         else
         {
-            // spherical harmonics
-            // TODO: vectorize the sph_harm function, 
-            // the vectorized function can be called once for all meshgrids in a biggrid
-            ModuleBase::Ylm::grad_rl_sph_harm(atom_->nwl, coord.x, coord.y, coord.z, rly.data(), grly.get_ptr_2D());
-
-            // interpolation
-            const double position = dist / dr_uniform;
-            const int ip = static_cast<int>(position);
-            const double x0 = position - ip;
-            const double x1 = 1.0 - x0;
-            const double x2 = 2.0 - x0;
-            const double x3 = 3.0 - x0;
-            const double x12 = x1 * x2 / 6;
-            const double x03 = x0 * x3 / 2;
-
-            double tmp, dtmp;
-            for(int iw = 0; iw < atom_->nw; ++iw)
+            mgrid_idx[n] = im;
+            x[n] = coord.x;
+            y[n] = coord.y;
+            z[n] = coord.z;
+            dist[n] = d;
+            n++;
+        }
+    }
+    if(n == 0)
+    {
+        return;
+    }
+
+    // phi and dphi of all meshgrids, phi_n[iw * n + i]
+    double* phi_n = dist + num_mgrids;
+    double* dphi_x_n = phi_n + atom_->nw * n;
+    double* dphi_y_n = dphi_x_n + atom_->nw * n;
+    double* dphi_z_n = dphi_y_n + atom_->nw * n;
+    set_phi_dphi_batch_(n, x, y, z, dist, phi_n, dphi_x_n, dphi_y_n, dphi_z_n);
+
+    // the orbitals of one meshgrid are contiguous in phi and dphi
+    for(int i = 0; i < n; i++)
+    {
+        const int idx = mgrid_idx[i] * stride;
+        for(int iw = 0; iw < atom_->nw; iw++)
+        {
+            if(phi != nullptr)
             {
-                // this is a new 'l', we need 1D orbital wave
-                // function from interpolation method.
-                if(atom_->iw2_new[iw])
-                {
-                    auto psi_uniform = p_psi_uniform[iw];
-                    auto dpsi_uniform = p_dpsi_uniform[iw];
-
-                    if(ip >= phi_nr_uniform[iw] - 4)
-                    {
-                        tmp = dtmp = 0.0;
-                    }
-                    else
-                    {
-                        // use Polynomia Interpolation method to get the
-                        // wave functions
-
-                        tmp = x12 * (psi_uniform[ip] * x3 + psi_uniform[ip + 3] * x0)
-                            + x03 * (psi_uniform[ip + 1] * x2 - psi_uniform[ip + 2] * x1);
-
-                        dtmp = x12 * (dpsi_uniform[ip] * x3 + dpsi_uniform[ip + 3] * x0)
-                            + x03 * (dpsi_uniform[ip + 1] * x2 - dpsi_uniform[ip + 2] * x1);
-                    }
-                } // new l is used.
-
-                // get the 'l' of this localized wave function
-                const int ll = atom_->iw2l[iw];
-                const int idx_lm = atom_->iw2_ylm[iw];
-
-                const double rl = pow_int(dist, ll);
-                const double tmprl = tmp / rl;
-
-                // 3D wave functions
-                if(phi != nullptr)
-                {
-                    phi[im * stride + iw] = tmprl * rly[idx_lm];
-                }
-                
-                // derivative of wave functions with respect to atom positions.
-                const double tmpdphi_rly = (dtmp - tmp * ll / dist) / rl * rly[idx_lm] / dist;
-
-                dphi_x[im * stride + iw] =  tmpdphi_rly * coord.x + tmprl * grly[idx_lm][0];
-                dphi_y[im * stride + iw] =  tmpdphi_rly * coord.y + tmprl * grly[idx_lm][1];
-                dphi_z[im * stride + iw] =  tmpdphi_rly * coord.z + tmprl * grly[idx_lm][2];
+                phi[idx + iw] = phi_n[iw * n + i];
             }
+            dphi_x[idx + iw] = dphi_x_n[iw * n + i];
+            dphi_y[idx + iw] = dphi_y_n[iw * n + i];
+            dphi_z[idx + iw] = dphi_z_n[iw * n + i];
         }
     }
 }
 
+void GintAtom::set_phi_dphi_batch_(
+    const int n, const double* x, const double* y, const double* z, const double* dist,
+    double* phi, double* dphi_x, double* dphi_y, double* dphi_z) const
+{
+    // orb_ does not have the member variable dr_uniform
+    const double dr_uniform = orb_->PhiLN(0, 0).dr_uniform;
+
+    // r^l Ylm and its gradient of all points, rly[lm * n + i],
+    // 1/r^l of all points, inv_rl[l * n + i],
+    // and the radial function and its derivative of all points
+    const int nlm = (atom_->nwl + 1) * (atom_->nwl + 1);
+    // 1/r is always stored in inv_rl[n + i], even if nwl is 0
+    const int nl_inv = std::max(atom_->nwl + 1, 2);
+    std::vector<double> buf((4 * nlm + nl_inv + 2) * n);
+    double* rly = buf.data();
+    double* grly_x = rly + nlm * n;
+    double* grly_y = grly_x + nlm * n;
+    double* grly_z = grly_y + nlm * n;
+    double* inv_rl = grly_z + nlm * n;
+    double* tmp = inv_rl + nl_inv * n;
+    double* dtmp = tmp + n;
+    ModuleBase::Ylm::grad_rl_sph_harm_batch(atom_->nwl, n, x, y, z, rly, grly_x, grly_y, grly_z);
+
+    for(int i = 0; i < n; i++)
+    {
+        inv_rl[i] = 1.0;
+        inv_rl[n + i] = 1.0 / dist[i];
+    }
+    // inv_rl + n is 1/r
+    for(int l = 2; l <= atom_->nwl; l++)
+    {
+        for(int i = 0; i < n; i++)
+        {
+            inv_rl[l * n + i] = inv_rl[(l - 1) * n + i] * inv_rl[n + i];
+        }
+    }
+
+    RadialInterp interp;
+    interp.set_poly(n, dist, dr_uniform);
+    for(int iw = 0; iw < atom_->nw; ++iw)
+    {
+        // this is a new 'l', we need 1D orbital wave
+        // function from interpolation method.
+        if(atom_->iw2_new[iw])
+        {
+            const Numerical_Orbital_Lm& philn = orb_->PhiLN(atom_->iw2l[iw], atom_->iw2n[iw]);
+            interp.poly(philn.psi_uniform.data(), philn.dpsi_uniform.data(), philn.nr_uniform,
+                        tmp, dtmp);
+        }
+
+        // get the 'l' of this localized wave function
+        const int ll = atom_->iw2l[iw];
+        const int idx_lm = atom_->iw2_ylm[iw];
+        orbital_kernel(n, ll, x, y, z, inv_rl + n, inv_rl + ll * n, tmp, dtmp,
+                       rly + idx_lm * n, grly_x + idx_lm * n, grly_y + idx_lm * n, grly_z + idx_lm * n,
+                       phi + iw * n, dphi_x + iw * n, dphi_y + iw * n, dphi_z + iw * n);
+    }
+}
+
 // explicit instantiation
 template void GintAtom::set_phi(const std::vector<Vec3d>& coords, const int stride, double* phi) const;
 template void GintAtom::set_phi_dphi(const std::vector<Vec3d>& coords, const int stride, double* phi, double* dphi_x, double* dphi_y, double* dphi_z) const;
-}
\ No newline at end of file
+}
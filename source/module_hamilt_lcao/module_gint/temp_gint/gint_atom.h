@@ -89,6 +89,22 @@ class GintAtom
             T* ddphi_yy, T* ddphi_yz, T* ddphi_zz) const;
 
     private:
+        /**
+         * @brief Get the wave function values and derivatives of n points at once
+         *
+         * The points are given in structure-of-arrays layout, and all of them should be within the cutoff radius.
+         * phi[iw * n + i] stores the value of the iw-th orbital at the i-th point, the same for dphi_x, dphi_y and dphi_z.
+         *
+         * @param n number of points
+         * @param x x coordinates of the points relative to the atom
+         * @param y y coordinates of the points relative to the atom
+         * @param z z coordinates of the points relative to the atom
+         * @param dist distances of the points to the atom
+         */
+        void set_phi_dphi_batch_(
+            const int n, const double* x, const double* y, const double* z, const double* dist,
+            double* phi, double* dphi_x, double* dphi_y, double* dphi_z) const;
+
         // the atom object
         const Atom* atom_;
 
@@ -1,4 +1,3 @@
-#include "module_base/blas_connector.h"
 #include "gint_common.h"
 #include "gint_vl_metagga.h"
 #include "phi_operator.h"
@@ -26,8 +25,8 @@ void Gint_vl_metagga::init_hr_gint_()
 
 void Gint_vl_metagga::cal_hr_gint_()
 {
-// be careful!!
-// each thread will have a copy of hr_gint_, this may cause a lot of memory usage
+    // all threads add their results to hr_gint_ directly, guarded by the locks of atom pairs
+    AtomPairLocks locks;
 #pragma omp parallel
     {
         PhiOperator phi_op;
@@ -39,7 +38,6 @@ void Gint_vl_metagga::cal_hr_gint_()
         std::vector<double> dphi_x_vldr3;
         std::vector<double> dphi_y_vldr3;
         std::vector<double> dphi_z_vldr3;
-        HContainer<double> hr_gint_local(*hr_gint_);
 #pragma omp for schedule(dynamic)
         for(const auto& biggrid: gint_info_->get_biggrids())
         {
@@ -62,15 +60,10 @@ void Gint_vl_metagga::cal_hr_gint_()
             phi_op.phi_mul_vldr3(vofk_, dr3_, dphi_x.data(), dphi_x_vldr3.data());
             phi_op.phi_mul_vldr3(vofk_, dr3_, dphi_y.data(), dphi_y_vldr3.data());
             phi_op.phi_mul_vldr3(vofk_, dr3_, dphi_z.data(), dphi_z_vldr3.data());
-            phi_op.phi_mul_phi_vldr3(phi.data(), phi_vldr3.data(), &hr_gint_local);
-            phi_op.phi_mul_phi_vldr3(dphi_x.data(), dphi_x_vldr3.data(), &hr_gint_local);
-            phi_op.phi_mul_phi_vldr3(dphi_y.data(), dphi_y_vldr3.data(), &hr_gint_local);
-            phi_op.phi_mul_phi_vldr3(dphi_z.data(), dphi_z_vldr3.data(), &hr_gint_local);
-        }
-#pragma omp critical
-        {
-            BlasConnector::axpy(hr_gint_local.get_nnr(), 1.0, hr_gint_local.get_wrapper(),
-                                1, hr_gint_->get_wrapper(), 1);
+            phi_op.phi_mul_phi_vldr3(
+                {phi.data(), dphi_x.data(), dphi_y.data(), dphi_z.data()},
+                {phi_vldr3.data(), dphi_x_vldr3.data(), dphi_y_vldr3.data(), dphi_z_vldr3.data()},
+                hr_gint_.get(), locks);
         }
     }
 }
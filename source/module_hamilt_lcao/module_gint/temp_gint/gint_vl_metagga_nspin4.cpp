@@ -1,6 +1,5 @@
 #include "module_base/global_function.h"
 #include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
-#include "module_base/blas_connector.h"
 #include "gint_common.h"
 #include "gint_vl_metagga_nspin4.h"
 #include "phi_operator.h"
@@ -30,6 +29,8 @@ void Gint_vl_metagga_nspin4::init_hr_gint_()
 
 void Gint_vl_metagga_nspin4::cal_hr_gint_()
 {
+    // all threads add their results to hr_gint_part_ directly, guarded by the locks of atom pairs
+    AtomPairLocks locks;
 #pragma omp parallel
     {
         PhiOperator phi_op;
@@ -41,7 +42,6 @@ void Gint_vl_metagga_nspin4::cal_hr_gint_()
         std::vector<double> dphi_x_vldr3;
         std::vector<double> dphi_y_vldr3;
         std::vector<double> dphi_z_vldr3;
-        std::vector<HContainer<double>> hr_gint_part_thread(nspin_, *hr_gint_part_[0]);
 #pragma omp for schedule(dynamic)
         for(const auto& biggrid: gint_info_->get_biggrids())
         {
@@ -66,20 +66,10 @@ void Gint_vl_metagga_nspin4::cal_hr_gint_()
                 phi_op.phi_mul_vldr3(vofk_[is], dr3_, dphi_x.data(), dphi_x_vldr3.data());
                 phi_op.phi_mul_vldr3(vofk_[is], dr3_, dphi_y.data(), dphi_y_vldr3.data());
                 phi_op.phi_mul_vldr3(vofk_[is], dr3_, dphi_z.data(), dphi_z_vldr3.data());
-                phi_op.phi_mul_phi_vldr3(phi.data(), phi_vldr3.data(), &hr_gint_part_thread[is]);
-                phi_op.phi_mul_phi_vldr3(dphi_x.data(), dphi_x_vldr3.data(), &hr_gint_part_thread[is]);
-                phi_op.phi_mul_phi_vldr3(dphi_y.data(), dphi_y_vldr3.data(), &hr_gint_part_thread[is]);
-                phi_op.phi_mul_phi_vldr3(dphi_z.data(), dphi_z_vldr3.data(), &hr_gint_part_thread[is]);
-            }
-        }
-#pragma omp critical
-        {
-            for(int is = 0; is < nspin_; is++)
-            {
-                {
-                    BlasConnector::axpy(hr_gint_part_thread[is].get_nnr(), 1.0, hr_gint_part_thread[is].get_wrapper(),
-                                        1, hr_gint_part_[is]->get_wrapper(), 1);
-                }
+                phi_op.phi_mul_phi_vldr3(
+                    {phi.data(), dphi_x.data(), dphi_y.data(), dphi_z.data()},
+                    {phi_vldr3.data(), dphi_x_vldr3.data(), dphi_y_vldr3.data(), dphi_z_vldr3.data()},
+                    hr_gint_part_[is].get(), locks);
             }
         }
     }
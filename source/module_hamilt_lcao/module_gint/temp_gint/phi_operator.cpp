@@ -197,6 +197,64 @@ void PhiOperator::phi_mul_phi_vldr3(
     }
 }
 
+void PhiOperator::phi_mul_phi_vldr3(
+    const std::vector<const double*>& phi,
+    const std::vector<const double*>& phi_vldr3,
+    HContainer<double>* hr,
+    AtomPairLocks& locks) const
+{
+    const char transa='N', transb='T';
+    const double alpha=1;
+    const int nterms = phi.size();
+
+    for(int i = 0; i < biggrid_->get_atoms_num(); ++i)
+    {
+        const auto atom_i = biggrid_->get_atom(i);
+        const auto& r_i = atom_i->get_R();
+        const int iat_i = atom_i->get_iat();
+
+        for(int j = 0; j < biggrid_->get_atoms_num(); ++j)
+        {
+            const auto atom_j = biggrid_->get_atom(j);
+            const auto& r_j = atom_j->get_R();
+            const int iat_j = atom_j->get_iat();
+
+            // only calculate the upper triangle matrix
+            if(iat_i > iat_j)
+            {
+                continue;
+            }
+
+            const auto result = hr->find_matrix(iat_i, iat_j, r_i-r_j);
+
+            if(result == nullptr)
+            {
+                continue;
+            }
+
+            int start_idx = get_atom_pair_start_end_idx_(i, j).first;
+            int end_idx = get_atom_pair_start_end_idx_(i, j).second;
+            const int len = end_idx - start_idx + 1;
+
+            if(len <= 0)
+            {
+                continue;
+            }
+
+            const int size = atoms_phi_len_[i] * atoms_phi_len_[j];
+            hr_buffer_.resize(size);
+            for(int k = 0; k < nterms; ++k)
+            {
+                const double beta = (k == 0) ? 0.0 : 1.0;
+                dgemm_(&transa, &transb, &atoms_phi_len_[j], &atoms_phi_len_[i], &len, &alpha,
+                    &phi_vldr3[k][start_idx * cols_ + atoms_startidx_[j]], &cols_,
+                    &phi[k][start_idx * cols_ + atoms_startidx_[i]], &cols_, &beta, hr_buffer_.data(), &atoms_phi_len_[j]);
+            }
+            locks.add(result->get_pointer(), hr_buffer_.data(), size);
+        }
+    }
+}
+
 void PhiOperator::phi_dot_phi_dm(
     const double* phi,
     const double* phi_dm,
@@ -5,6 +5,7 @@
 #include <utility>
 #include <module_hamilt_lcao/module_hcontainer/hcontainer.h>
 #include "big_grid.h"
+#include "atom_pair_locks.h"
 
 namespace ModuleGint
 {
@@ -59,6 +60,15 @@ class PhiOperator
         const double* phi,
         const double* phi_vldr3,
         HContainer<double>* hr) const;
+
+    // the same as above, but hr is shared by all threads.
+    // \sum_k phi[k]^T * phi_vldr3[k] of each atom pair is calculated in a buffer,
+    // then added to hr under the lock of the atom pair.
+    void phi_mul_phi_vldr3(
+        const std::vector<const double*>& phi,
+        const std::vector<const double*>& phi_vldr3,
+        HContainer<double>* hr,
+        AtomPairLocks& locks) const;
     
     void phi_dot_phi_dm(
         const double* phi,
@@ -124,6 +134,9 @@ class PhiOperator
 
     // This data structure is used to store the index of the first and last meshgrid affected by each atom pair
     std::vector<std::pair<int, int>> atom_pair_start_end_idx_; 
+
+    // buffer of the matrix of one atom pair used in phi_mul_phi_vldr3 with locks
+    mutable std::vector<double> hr_buffer_;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "radial_interp.h"
+
+namespace ModuleGint
+{
+
+namespace
+{
+// The kernels below work on arrays which never overlap,
+// so the pointers are declared __restrict to let the compiler vectorize the loops.
+
+void hermite_weights(const int n, const double* __restrict dist, const double dr_uniform,
+                     int* __restrict ip, double* __restrict c1, double* __restrict c2,
+                     double* __restrict c3, double* __restrict c4)
+{
+    for(int i = 0; i < n; i++)
+    {
+        const double position = dist[i] / dr_uniform;
+        const int ip_i = static_cast<int>(position);
+        const double dx = position - ip_i;
+        const double dx2 = dx * dx;
+        const double dx3 = dx2 * dx;
+
+        ip[i] = ip_i;
+        c3[i] = 3.0 * dx2 - 2.0 * dx3;
+        c1[i] = 1.0 - c3[i];
+        c2[i] = (dx - 2.0 * dx2 + dx3) * dr_uniform;
+        c4[i] = (dx3 - dx2) * dr_uniform;
+    }
+}
+
+void hermite_kernel(const int n, const int* __restrict ip,
+                    const double* __restrict c1, const double* __restrict c2,
+                    const double* __restrict c3, const double* __restrict c4,
+                    const double* __restrict psi_uniform, const double* __restrict dpsi_uniform,
+                    double* __restrict psi)
+{
+    for(int i = 0; i < n; i++)
+    {
+        const int j = ip[i];
+        psi[i] = c1[i] * psi_uniform[j] + c2[i] * dpsi_uniform[j]
+               + c3[i] * psi_uniform[j + 1] + c4[i] * dpsi_uniform[j + 1];
+    }
+}
+
+void poly_weights(const int n, const double* __restrict dist, const double dr_uniform,
+                  int* __restrict ip, double* __restrict w0, double* __restrict w1,
+                  double* __restrict w2, double* __restrict w3)
+{
+    for(int i = 0; i < n; i++)
+    {
+        const double position = dist[i] / dr_uniform;
+        const int ip_i = static_cast<int>(position);
+        const double x0 = position - ip_i;
+        const double x1 = 1.0 - x0;
+        const double x2 = 2.0 - x0;
+        const double x3 = 3.0 - x0;
+        const double x12 = x1 * x2 / 6;
+        const double x03 = x0 * x3 / 2;
+
+        ip[i] = ip_i;
+        w0[i] = x12 * x3;
+        w1[i] = x03 * x2;
+        w2[i] = -x03 * x1;
+        w3[i] = x12 * x0;
+    }
+}
+
+void poly_kernel(const int n, const int* __restrict ip,
+                 const double* __restrict w0, const double* __restrict w1,
+                 const double* __restrict w2, const double* __restrict w3,
+                 const double* __restrict psi_uniform, const double* __restrict dpsi_uniform,
+                 const int nr_uniform, double* __restrict psi, double* __restrict dpsi)
+{
+    for(int i = 0; i < n; i++)
+    {
+        // the points out of the last 4 grid points read the first 4 ones, and their values are set to zero
+        const bool inside = ip[i] < nr_uniform - 4;
+        const int j = inside ? ip[i] : 0;
+        const double mask = inside ? 1.0 : 0.0;
+        const double p = w0[i] * psi_uniform[j] + w1[i] * psi_uniform[j + 1]
+                       + w2[i] * psi_uniform[j + 2] + w3[i] * psi_uniform[j + 3];
+        const double dp = w0[i] * dpsi_uniform[j] + w1[i] * dpsi_uniform[j + 1]
+                        + w2[i] * dpsi_uniform[j + 2] + w3[i] * dpsi_uniform[j + 3];
+        psi[i] = mask * p;
+        dpsi[i] = mask * dp;
+    }
+}
+} // namespace
+
+void RadialInterp::set_hermite(const int n, const double* dist, const double dr_uniform)
+{
+    n_ = n;
+    ip_.resize(n);
+    w_.resize(4 * n);
+    hermite_weights(n, dist, dr_uniform, ip_.data(), w_.data(), w_.data() + n, w_.data() + 2 * n, w_.data() + 3 * n);
+}
+
+void RadialInterp::hermite(const double* psi_uniform, const double* dpsi_uniform, double* psi) const
+{
+    const int n = n_;
+    hermite_kernel(n, ip_.data(), w_.data(), w_.data() + n, w_.data() + 2 * n, w_.data() + 3 * n,
+                   psi_uniform, dpsi_uniform, psi);
+}
+
+void RadialInterp::set_poly(const int n, const double* dist, const double dr_uniform)
+{
+    n_ = n;
+    ip_.resize(n);
+    w_.resize(4 * n);
+    poly_weights(n, dist, dr_uniform, ip_.data(), w_.data(), w_.data() + n, w_.data() + 2 * n, w_.data() + 3 * n);
+}
+
+void RadialInterp::poly(const double* psi_uniform, const double* dpsi_uniform, const int nr_uniform,
+                        double* psi, double* dpsi) const
+{
+    const int n = n_;
+    poly_kernel(n, ip_.data(), w_.data(), w_.data() + n, w_.data() + 2 * n, w_.data() + 3 * n,
+                psi_uniform, dpsi_uniform, nr_uniform, psi, dpsi);
+}
+
+}
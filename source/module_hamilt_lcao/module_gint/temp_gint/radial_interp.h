@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+namespace ModuleGint
+{
+
+/**
+ * @brief Batched interpolation of the radial functions of an atom on the uniform radial grid.
+ *
+ * The interpolation weights only depend on the distances between the meshgrids and the atom,
+ * so they are computed once by set_hermite() or set_poly() for all meshgrids of a big grid,
+ * and then reused by every radial function of the atom.
+ * All arrays are in structure-of-arrays layout, so that the loops over meshgrids can be vectorized.
+ */
+class RadialInterp
+{
+    public:
+    /**
+     * @brief set the weights of the cubic Hermite interpolation (using psi and dpsi), used by set_phi
+     *
+     * @param n number of points
+     * @param dist distances of the points to the atom, all of them should be within the cutoff radius
+     * @param dr_uniform interval of the uniform radial grid
+     */
+    void set_hermite(const int n, const double* dist, const double dr_uniform);
+
+    /**
+     * @brief psi[i] = psi(dist[i]) by the cubic Hermite interpolation, set_hermite() should be called first
+     */
+    void hermite(const double* psi_uniform, const double* dpsi_uniform, double* psi) const;
+
+    /**
+     * @brief set the weights of the 4-point Lagrange interpolation, used by set_phi_dphi and set_ddphi
+     */
+    void set_poly(const int n, const double* dist, const double dr_uniform);
+
+    /**
+     * @brief psi[i] = psi(dist[i]) and dpsi[i] = dpsi(dist[i]) by the 4-point Lagrange interpolation,
+     * set_poly() should be called first. The values are zero if the point is out of the last 4 grid points.
+     */
+    void poly(const double* psi_uniform, const double* dpsi_uniform, const int nr_uniform,
+              double* psi, double* dpsi) const;
+
+    int get_n() const { return n_; };
+
+    private:
+    int n_ = 0;
+
+    // index of the left grid point of each point
+    std::vector<int> ip_;
+
+    // weights of the 4 terms of each point, w_[k * n_ + i] is the k-th weight of the i-th point
+    std::vector<double> w_;
+};
+
+}
@@ -0,0 +1,189 @@
+#include "gtest/gtest.h"
+#include "module_base/blas_connector.h"
+#include "module_hamilt_lcao/module_gint/temp_gint/atom_pair_locks.h"
+#include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * Unit test of AtomPairLocks
+ * the atom-pair matrices of all big grids are accumulated into one HContainer shared by all threads,
+ * tested functions:
+ * 1. add() gives the same result as the serial accumulation
+ * 2. cost compared with the former scheme, in which each thread holds a copy of the HContainer
+ *    and the copies are merged with a critical section, for different number of threads
+ */
+
+namespace
+{
+// atoms on a chain, big grid ib covers atoms [ib, ib + natom_bgrid),
+// only the upper triangle atom pairs are stored like hr_gint of Gint_vl
+const int natom = 200;
+const int natom_bgrid = 8;
+const int nw = 13;
+const int nbgrid = natom - natom_bgrid + 1;
+const int nrepeat = 4;
+
+hamilt::HContainer<double> build_hr()
+{
+    hamilt::HContainer<double> hr(natom);
+    for (int iat = 0; iat < natom; ++iat)
+    {
+        for (int jat = iat; jat < std::min(natom, iat + natom_bgrid); ++jat)
+        {
+            hamilt::AtomPair<double> ap(iat, jat);
+            ap.set_size(nw, nw);
+            ap.get_HR_values(0, 0, 0);
+            hr.insert_pair(ap);
+        }
+    }
+    hr.allocate(nullptr, true);
+    return hr;
+}
+
+// the matrix of atom pair (iat, jat) contributed by one big grid
+void set_block(const int ibgrid, const int iat, const int jat, std::vector<double>& block)
+{
+    block.resize(nw * nw);
+    for (int i = 0; i < nw * nw; ++i)
+    {
+        block[i] = 1.0 / (1.0 + ibgrid + iat) + 0.01 * (jat - iat) + 1e-4 * i;
+    }
+}
+
+// the former scheme: a private copy of hr for each thread, merged in a critical section
+void accumulate_copy(hamilt::HContainer<double>& hr)
+{
+#pragma omp parallel
+    {
+        hamilt::HContainer<double> hr_local(hr);
+        std::vector<double> block;
+#pragma omp for schedule(dynamic)
+        for (int itask = 0; itask < nbgrid * nrepeat; ++itask)
+        {
+            const int ib = itask % nbgrid;
+            for (int iat = ib; iat < ib + natom_bgrid; ++iat)
+            {
+                for (int jat = iat; jat < ib + natom_bgrid; ++jat)
+                {
+                    set_block(ib, iat, jat, block);
+                    double* p = hr_local.find_matrix(iat, jat, 0, 0, 0)->get_pointer();
+                    BlasConnector::axpy(nw * nw, 1.0, block.data(), 1, p, 1);
+                }
+            }
+        }
+#pragma omp critical
+        {
+            BlasConnector::axpy(hr_local.get_nnr(), 1.0, hr_local.get_wrapper(), 1, hr.get_wrapper(), 1);
+        }
+    }
+}
+
+void accumulate_locks(hamilt::HContainer<double>& hr)
+{
+    ModuleGint::AtomPairLocks locks;
+#pragma omp parallel
+    {
+        std::vector<double> block;
+#pragma omp for schedule(dynamic)
+        for (int itask = 0; itask < nbgrid * nrepeat; ++itask)
+        {
+            const int ib = itask % nbgrid;
+            for (int iat = ib; iat < ib + natom_bgrid; ++iat)
+            {
+                for (int jat = iat; jat < ib + natom_bgrid; ++jat)
+                {
+                    set_block(ib, iat, jat, block);
+                    locks.add(hr.find_matrix(iat, jat, 0, 0, 0)->get_pointer(), block.data(), nw * nw);
+                }
+            }
+        }
+    }
+}
+} // namespace
+
+TEST(AtomPairLocksTest, Add)
+{
+    ModuleGint::AtomPairLocks locks(16);
+    EXPECT_EQ(locks.get_nlocks(), 16);
+    std::vector<double> dst(5, 1.0);
+    const std::vector<double> src = {1.0, 2.0, 3.0, 4.0, 5.0};
+#pragma omp parallel for
+    for (int i = 0; i < 100; ++i)
+    {
+        locks.add(dst.data(), src.data(), 5);
+    }
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_DOUBLE_EQ(dst[i], 1.0 + 100 * src[i]);
+    }
+}
+
+TEST(AtomPairLocksTest, CostCompareWithCopy)
+{
+    hamilt::HContainer<double> hr_ref = build_hr();
+    {
+        // serial reference
+        std::vector<double> block;
+        for (int itask = 0; itask < nbgrid * nrepeat; ++itask)
+        {
+            const int ib = itask % nbgrid;
+            for (int iat = ib; iat < ib + natom_bgrid; ++iat)
+            {
+                for (int jat = iat; jat < ib + natom_bgrid; ++jat)
+                {
+                    set_block(ib, iat, jat, block);
+                    double* p = hr_ref.find_matrix(iat, jat, 0, 0, 0)->get_pointer();
+                    BlasConnector::axpy(nw * nw, 1.0, block.data(), 1, p, 1);
+                }
+            }
+        }
+    }
+    const size_t memory_hr = hr_ref.get_nnr() * sizeof(double);
+
+    int max_threads = 1;
+#ifdef _OPENMP
+    max_threads = omp_get_max_threads();
+#endif
+    std::cout << "nnr of hr: " << hr_ref.get_nnr() << ", " << memory_hr / 1024.0 / 1024.0 << " MB" << std::endl;
+    for (int nthreads = 1; nthreads <= std::max(4, max_threads); nthreads *= 2)
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(nthreads);
+#endif
+        hamilt::HContainer<double> hr_copy = build_hr();
+        hamilt::HContainer<double> hr_locks = build_hr();
+        auto t0 = std::chrono::high_resolution_clock::now();
+        accumulate_copy(hr_copy);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        accumulate_locks(hr_locks);
+        auto t2 = std::chrono::high_resolution_clock::now();
+
+        double max_diff_copy = 0.0;
+        double max_diff_locks = 0.0;
+        for (int i = 0; i < hr_ref.get_nnr(); ++i)
+        {
+            max_diff_copy = std::max(max_diff_copy, std::abs(hr_copy.get_wrapper()[i] - hr_ref.get_wrapper()[i]));
+            max_diff_locks = std::max(max_diff_locks, std::abs(hr_locks.get_wrapper()[i] - hr_ref.get_wrapper()[i]));
+        }
+        EXPECT_LT(max_diff_copy, 1e-10);
+        EXPECT_LT(max_diff_locks, 1e-10);
+        // extra memory: the copies of hr for the former scheme, one block buffer per thread with locks
+        std::cout << "threads: " << nthreads
+                  << ", per-thread copy: "
+                  << std::chrono::duration_cast<std::chrono::duration<double>>(t1 - t0).count() << " s, "
+                  << nthreads * memory_hr / 1024.0 / 1024.0 << " MB"
+                  << ", atom-pair locks: "
+                  << std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count() << " s, "
+                  << nthreads * nw * nw * sizeof(double) / 1024.0 / 1024.0 << " MB" << std::endl;
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(max_threads);
+#endif
+}
@@ -0,0 +1,247 @@
+#include "gtest/gtest.h"
+
+#define private public
+#include "module_basis/module_ao/ORB_atomic.h"
+#undef private
+#include "module_base/array_pool.h"
+#include "module_base/ylm.h"
+#include "module_hamilt_lcao/module_gint/temp_gint/gint_atom.h"
+
+#include <cmath>
+#include <vector>
+
+/**
+ * Unit test of GintAtom
+ * tested functions:
+ * 1. set_phi_dphi() gives the same values as the point-by-point evaluation,
+ *    for nwl = 0 (where 1/r is not one of the 1/r^l of the orbitals) and nwl = 2
+ * 2. set_phi() gives the same values as set_phi_dphi()
+ */
+
+// mock of Atom
+Atom::Atom()
+{
+}
+Atom::~Atom()
+{
+}
+Atom_pseudo::Atom_pseudo()
+{
+}
+Atom_pseudo::~Atom_pseudo()
+{
+}
+pseudo::pseudo()
+{
+}
+pseudo::~pseudo()
+{
+}
+
+namespace
+{
+const double dr_uniform = 0.01;
+const int nr_uniform = 601;
+
+// the former point-by-point evaluation of set_phi_dphi
+void set_phi_dphi_ref(const Atom& atom,
+                      const Numerical_Orbital& orb,
+                      const Vec3d& coord,
+                      double* phi,
+                      double* dphi_x,
+                      double* dphi_y,
+                      double* dphi_z)
+{
+    const double dist = coord.norm() < 1e-9 ? 1e-9 : coord.norm();
+    if (dist > orb.getRcut())
+    {
+        for (int iw = 0; iw < atom.nw; ++iw)
+        {
+            phi[iw] = dphi_x[iw] = dphi_y[iw] = dphi_z[iw] = 0.0;
+        }
+        return;
+    }
+
+    std::vector<double> rly((atom.nwl + 1) * (atom.nwl + 1));
+    ModuleBase::Array_Pool<double> grly((atom.nwl + 1) * (atom.nwl + 1), 3);
+    ModuleBase::Ylm::grad_rl_sph_harm(atom.nwl, coord.x, coord.y, coord.z, rly.data(), grly.get_ptr_2D());
+
+    const double position = dist / dr_uniform;
+    const int ip = static_cast<int>(position);
+    const double x0 = position - ip;
+    const double x1 = 1.0 - x0;
+    const double x2 = 2.0 - x0;
+    const double x3 = 3.0 - x0;
+    const double x12 = x1 * x2 / 6;
+    const double x03 = x0 * x3 / 2;
+
+    double tmp = 0.0;
+    double dtmp = 0.0;
+    for (int iw = 0; iw < atom.nw; ++iw)
+    {
+        if (atom.iw2_new[iw])
+        {
+            const Numerical_Orbital_Lm& philn = orb.PhiLN(atom.iw2l[iw], atom.iw2n[iw]);
+            const double* psi_uniform = philn.psi_uniform.data();
+            const double* dpsi_uniform = philn.dpsi_uniform.data();
+            if (ip >= philn.nr_uniform - 4)
+            {
+                tmp = dtmp = 0.0;
+            }
+            else
+            {
+                tmp = x12 * (psi_uniform[ip] * x3 + psi_uniform[ip + 3] * x0)
+                      + x03 * (psi_uniform[ip + 1] * x2 - psi_uniform[ip + 2] * x1);
+                dtmp = x12 * (dpsi_uniform[ip] * x3 + dpsi_uniform[ip + 3] * x0)
+                       + x03 * (dpsi_uniform[ip + 1] * x2 - dpsi_uniform[ip + 2] * x1);
+            }
+        }
+
+        const int ll = atom.iw2l[iw];
+        const int idx_lm = atom.iw2_ylm[iw];
+        const double rl = std::pow(dist, ll);
+        const double tmprl = tmp / rl;
+        phi[iw] = tmprl * rly[idx_lm];
+
+        const double tmpdphi_rly = (dtmp - tmp * ll / dist) / rl * rly[idx_lm] / dist;
+        dphi_x[iw] = tmpdphi_rly * coord.x + tmprl * grly[idx_lm][0];
+        dphi_y[iw] = tmpdphi_rly * coord.y + tmprl * grly[idx_lm][1];
+        dphi_z[iw] = tmpdphi_rly * coord.z + tmprl * grly[idx_lm][2];
+    }
+}
+} // namespace
+
+class GintAtomTest : public ::testing::TestWithParam<int>
+{
+  protected:
+    void SetUp() override
+    {
+        ModuleBase::Ylm::set_coefficients();
+
+        // two radial functions for L = 0, one for each L > 0
+        const int nwl = GetParam();
+        std::vector<int> nchi(nwl + 1, 1);
+        nchi[0] = 2;
+        int total_nchi = 0;
+        for (int L = 0; L <= nwl; ++L)
+        {
+            total_nchi += nchi[L];
+        }
+
+        delete[] orb.chi();
+        orb.chi() = new Numerical_Orbital_Lm[total_nchi];
+        for (int ichi = 0; ichi < total_nchi; ++ichi)
+        {
+            Numerical_Orbital_Lm& philn = orb.chi()[ichi];
+            const double alpha = 0.6 + 0.3 * ichi;
+            philn.rcut = (nr_uniform - 1) * dr_uniform;
+            philn.dr_uniform = dr_uniform;
+            philn.nr_uniform = nr_uniform;
+            philn.psi_uniform.resize(nr_uniform);
+            philn.dpsi_uniform.resize(nr_uniform);
+            for (int ir = 0; ir < nr_uniform; ++ir)
+            {
+                const double r = ir * dr_uniform;
+                philn.psi_uniform[ir] = (1.0 + r) * std::exp(-alpha * r * r);
+                philn.dpsi_uniform[ir] = (1.0 - 2.0 * alpha * r * (1.0 + r)) * std::exp(-alpha * r * r);
+            }
+        }
+        orb.set_orbital_info(0, "X", nwl, nchi.data(), total_nchi);
+
+        atom.nwl = nwl;
+        atom.nw = 0;
+        for (int L = 0; L <= nwl; ++L)
+        {
+            atom.nw += nchi[L] * (2 * L + 1);
+        }
+        atom.iw2l.resize(atom.nw);
+        atom.iw2n.resize(atom.nw);
+        atom.iw2m.resize(atom.nw);
+        atom.iw2_ylm.resize(atom.nw);
+        atom.iw2_new.resize(atom.nw);
+        int iw = 0;
+        for (int L = 0; L <= nwl; ++L)
+        {
+            for (int N = 0; N < nchi[L]; ++N)
+            {
+                for (int m = 0; m < 2 * L + 1; ++m)
+                {
+                    atom.iw2l[iw] = L;
+                    atom.iw2n[iw] = N;
+                    atom.iw2m[iw] = m;
+                    atom.iw2_ylm[iw] = L * L + m;
+                    atom.iw2_new[iw] = (m == 0);
+                    ++iw;
+                }
+            }
+        }
+
+        // meshgrids of a big grid, some of them are out of the cutoff radius
+        for (int i = 0; i < 64; ++i)
+        {
+            coords.push_back(Vec3d(6.5 * std::sin(0.37 * i + 0.2),
+                                   3.0 * std::cos(0.51 * i + 0.1),
+                                   0.1 + 2.0 * std::sin(0.23 * i)));
+        }
+    }
+
+    Atom atom;
+    Numerical_Orbital orb;
+    std::vector<Vec3d> coords;
+};
+
+TEST_P(GintAtomTest, SetPhiDphi)
+{
+    ModuleGint::GintAtom gint_atom(&atom, 0, 0, {0, 0, 0}, {0, 0, 0}, {0.0, 0.0, 0.0}, &orb);
+    const int nw = atom.nw;
+    const int num_mgrids = coords.size();
+    std::vector<double> phi(num_mgrids * nw);
+    std::vector<double> dphi_x(num_mgrids * nw);
+    std::vector<double> dphi_y(num_mgrids * nw);
+    std::vector<double> dphi_z(num_mgrids * nw);
+    gint_atom.set_phi_dphi(coords, nw, phi.data(), dphi_x.data(), dphi_y.data(), dphi_z.data());
+
+    std::vector<double> phi_ref(nw);
+    std::vector<double> dphi_x_ref(nw);
+    std::vector<double> dphi_y_ref(nw);
+    std::vector<double> dphi_z_ref(nw);
+    int n_inside = 0;
+    for (int im = 0; im < num_mgrids; ++im)
+    {
+        n_inside += (coords[im].norm() <= orb.getRcut());
+        set_phi_dphi_ref(atom, orb, coords[im], phi_ref.data(), dphi_x_ref.data(), dphi_y_ref.data(), dphi_z_ref.data());
+        for (int iw = 0; iw < nw; ++iw)
+        {
+            EXPECT_NEAR(phi[im * nw + iw], phi_ref[iw], 1e-12);
+            EXPECT_NEAR(dphi_x[im * nw + iw], dphi_x_ref[iw], 1e-12);
+            EXPECT_NEAR(dphi_y[im * nw + iw], dphi_y_ref[iw], 1e-12);
+            EXPECT_NEAR(dphi_z[im * nw + iw], dphi_z_ref[iw], 1e-12);
+        }
+    }
+    EXPECT_GT(n_inside, 0);
+    EXPECT_LT(n_inside, num_mgrids);
+}
+
+TEST_P(GintAtomTest, SetPhi)
+{
+    ModuleGint::GintAtom gint_atom(&atom, 0, 0, {0, 0, 0}, {0, 0, 0}, {0.0, 0.0, 0.0}, &orb);
+    const int nw = atom.nw;
+    const int num_mgrids = coords.size();
+    std::vector<double> phi(num_mgrids * nw);
+    std::vector<double> phi_ref(num_mgrids * nw);
+    std::vector<double> dphi(3 * num_mgrids * nw);
+    gint_atom.set_phi(coords, nw, phi.data());
+    gint_atom.set_phi_dphi(coords,
+                           nw,
+                           phi_ref.data(),
+                           dphi.data(),
+                           dphi.data() + num_mgrids * nw,
+                           dphi.data() + 2 * num_mgrids * nw);
+    for (int i = 0; i < num_mgrids * nw; ++i)
+    {
+        // set_phi uses the cubic Hermite interpolation, set_phi_dphi the 4-point Lagrange one
+        EXPECT_NEAR(phi[i], phi_ref[i], 1e-6);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Nwl, GintAtomTest, ::testing::Values(0, 2));
@@ -0,0 +1,185 @@
+#include "gtest/gtest.h"
+#include "module_hamilt_lcao/module_gint/temp_gint/radial_interp.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+/**
+ * Unit test of RadialInterp
+ * the radial functions of all meshgrids of a big grid are interpolated at once,
+ * tested functions:
+ * 1. hermite() gives the same values as the point-by-point cubic Hermite interpolation of set_phi
+ * 2. poly() gives the same values as the point-by-point 4-point Lagrange interpolation of set_phi_dphi,
+ *    and zeros for the points out of the last 4 grid points
+ * 3. cost compared with the point-by-point interpolation
+ */
+
+namespace
+{
+const double dr_uniform = 0.01;
+const int nr_uniform = 801;
+
+void set_table(std::vector<double>& psi_uniform, std::vector<double>& dpsi_uniform)
+{
+    psi_uniform.resize(nr_uniform);
+    dpsi_uniform.resize(nr_uniform);
+    for (int ir = 0; ir < nr_uniform; ++ir)
+    {
+        const double r = ir * dr_uniform;
+        psi_uniform[ir] = r * std::exp(-0.7 * r * r);
+        dpsi_uniform[ir] = (1.0 - 1.4 * r * r) * std::exp(-0.7 * r * r);
+    }
+}
+
+// distances of the meshgrids, the last ones are out of the last 4 grid points
+std::vector<double> set_dist(const int n)
+{
+    std::vector<double> dist(n);
+    for (int i = 0; i < n; ++i)
+    {
+        dist[i] = 1e-9 + (nr_uniform - 1) * dr_uniform * std::abs(std::sin(0.37 * i + 0.2));
+    }
+    dist[n - 1] = (nr_uniform - 2.5) * dr_uniform;
+    return dist;
+}
+
+// the former point-by-point interpolation of set_phi
+double hermite_ref(const double* psi_uniform, const double* dpsi_uniform, const double dist)
+{
+    const double position = dist / dr_uniform;
+    const int ip = static_cast<int>(position);
+    const double dx = position - ip;
+    const double dx2 = dx * dx;
+    const double dx3 = dx2 * dx;
+
+    const double c3 = 3.0 * dx2 - 2.0 * dx3;
+    const double c1 = 1.0 - c3;
+    const double c2 = (dx - 2.0 * dx2 + dx3) * dr_uniform;
+    const double c4 = (dx3 - dx2) * dr_uniform;
+    return c1 * psi_uniform[ip] + c2 * dpsi_uniform[ip] + c3 * psi_uniform[ip + 1] + c4 * dpsi_uniform[ip + 1];
+}
+
+// the former point-by-point interpolation of set_phi_dphi
+void poly_ref(const double* psi_uniform, const double* dpsi_uniform, const double dist, double& tmp, double& dtmp)
+{
+    const double position = dist / dr_uniform;
+    const int ip = static_cast<int>(position);
+    const double x0 = position - ip;
+    const double x1 = 1.0 - x0;
+    const double x2 = 2.0 - x0;
+    const double x3 = 3.0 - x0;
+    const double x12 = x1 * x2 / 6;
+    const double x03 = x0 * x3 / 2;
+    if (ip >= nr_uniform - 4)
+    {
+        tmp = dtmp = 0.0;
+    }
+    else
+    {
+        tmp = x12 * (psi_uniform[ip] * x3 + psi_uniform[ip + 3] * x0)
+              + x03 * (psi_uniform[ip + 1] * x2 - psi_uniform[ip + 2] * x1);
+        dtmp = x12 * (dpsi_uniform[ip] * x3 + dpsi_uniform[ip + 3] * x0)
+               + x03 * (dpsi_uniform[ip + 1] * x2 - dpsi_uniform[ip + 2] * x1);
+    }
+}
+} // namespace
+
+TEST(RadialInterpTest, Hermite)
+{
+    std::vector<double> psi_uniform, dpsi_uniform;
+    set_table(psi_uniform, dpsi_uniform);
+    const int n = 100;
+    // the cubic Hermite interpolation reads ip + 1, so the last point is kept inside the table
+    std::vector<double> dist = set_dist(n);
+
+    ModuleGint::RadialInterp interp;
+    interp.set_hermite(n, dist.data(), dr_uniform);
+    EXPECT_EQ(interp.get_n(), n);
+    std::vector<double> psi(n);
+    interp.hermite(psi_uniform.data(), dpsi_uniform.data(), psi.data());
+    for (int i = 0; i < n; ++i)
+    {
+        EXPECT_NEAR(psi[i], hermite_ref(psi_uniform.data(), dpsi_uniform.data(), dist[i]), 1e-14);
+    }
+}
+
+TEST(RadialInterpTest, Poly)
+{
+    std::vector<double> psi_uniform, dpsi_uniform;
+    set_table(psi_uniform, dpsi_uniform);
+    const int n = 100;
+    std::vector<double> dist = set_dist(n);
+
+    ModuleGint::RadialInterp interp;
+    interp.set_poly(n, dist.data(), dr_uniform);
+    std::vector<double> psi(n), dpsi(n);
+    interp.poly(psi_uniform.data(), dpsi_uniform.data(), nr_uniform, psi.data(), dpsi.data());
+    for (int i = 0; i < n; ++i)
+    {
+        double tmp = 0.0, dtmp = 0.0;
+        poly_ref(psi_uniform.data(), dpsi_uniform.data(), dist[i], tmp, dtmp);
+        EXPECT_NEAR(psi[i], tmp, 1e-14);
+        EXPECT_NEAR(dpsi[i], dtmp, 1e-14);
+    }
+    EXPECT_EQ(psi[n - 1], 0.0);
+    EXPECT_EQ(dpsi[n - 1], 0.0);
+}
+
+// 5 radial functions of an atom for the meshgrids of a big grid, compare the cost with the point-by-point calls
+TEST(RadialInterpTest, BatchCost)
+{
+    const int n = 64;
+    const int nchi = 5;
+    const int nrepeat = 4000;
+    std::vector<std::vector<double>> psi_uniform(nchi), dpsi_uniform(nchi);
+    for (int ichi = 0; ichi < nchi; ++ichi)
+    {
+        set_table(psi_uniform[ichi], dpsi_uniform[ichi]);
+        for (int ir = 0; ir < nr_uniform; ++ir)
+        {
+            psi_uniform[ichi][ir] *= ichi + 1;
+            dpsi_uniform[ichi][ir] *= ichi + 1;
+        }
+    }
+    std::vector<double> dist = set_dist(n);
+    std::vector<double> psi_ref(nchi * n), dpsi_ref(nchi * n);
+    std::vector<double> psi(nchi * n), dpsi(nchi * n);
+
+    double time_ref = 0.0;
+    double time_batch = 0.0;
+    ModuleGint::RadialInterp interp;
+    for (int irep = 0; irep < nrepeat; ++irep)
+    {
+        // the distances change from one atom to another
+        dist[irep % (n - 1)] *= 0.999;
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < n; ++i)
+        {
+            for (int ichi = 0; ichi < nchi; ++ichi)
+            {
+                poly_ref(psi_uniform[ichi].data(), dpsi_uniform[ichi].data(), dist[i],
+                         psi_ref[ichi * n + i], dpsi_ref[ichi * n + i]);
+            }
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        interp.set_poly(n, dist.data(), dr_uniform);
+        for (int ichi = 0; ichi < nchi; ++ichi)
+        {
+            interp.poly(psi_uniform[ichi].data(), dpsi_uniform[ichi].data(), nr_uniform,
+                        psi.data() + ichi * n, dpsi.data() + ichi * n);
+        }
+        auto t2 = std::chrono::high_resolution_clock::now();
+        time_ref += std::chrono::duration_cast<std::chrono::duration<double>>(t1 - t0).count();
+        time_batch += std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+    }
+    for (int i = 0; i < nchi * n; ++i)
+    {
+        EXPECT_NEAR(psi[i], psi_ref[i], 1e-14);
+        EXPECT_NEAR(dpsi[i], dpsi_ref[i], 1e-14);
+    }
+    std::cout << n << " points, " << nchi << " radial functions, " << nrepeat << " times" << std::endl;
+    std::cout << "point-by-point: " << time_ref << " s, batched: " << time_batch << " s" << std::endl;
+}
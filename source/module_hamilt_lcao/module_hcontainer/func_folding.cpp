@@ -1,5 +1,7 @@
 #include "hcontainer_funcs.h"
+#include "module_base/blas_connector.h"
 #include "module_base/libm/libm.h"
+#include "module_base/tool_quit.h"
 
 namespace hamilt
 {
@@ -101,4 +103,417 @@ void folding_HR(const hamilt::HContainer<double>& hR,
     }
 }
 
+template <typename TR>
+KRPhase::KRPhase(const std::vector<ModuleBase::Vector3<double>>& kvec_d_in, const hamilt::HContainer<TR>& hR)
+    : kvec_d(kvec_d_in)
+{
+    // the box of all the R vectors
+    ModuleBase::Vector3<int> r_max(0, 0, 0);
+    bool first = true;
+    for (int i = 0; i < hR.size_atom_pairs(); ++i)
+    {
+        const hamilt::AtomPair<TR>& tmp = hR.get_atom_pair(i);
+        for (int ir = 0; ir < tmp.get_R_size(); ++ir)
+        {
+            const ModuleBase::Vector3<int> r_index_ = tmp.get_R_index(ir);
+            for (int d = 0; d < 3; ++d)
+            {
+                this->r_min[d] = first ? r_index_[d] : std::min(this->r_min[d], r_index_[d]);
+                r_max[d] = first ? r_index_[d] : std::max(r_max[d], r_index_[d]);
+            }
+            first = false;
+        }
+    }
+    if (first)
+    {
+        this->r_min.set(0, 0, 0);
+        this->r_dim.set(0, 0, 0);
+        return;
+    }
+    this->r_dim = r_max - this->r_min + ModuleBase::Vector3<int>(1, 1, 1);
+    this->r_index.assign(this->r_dim.x * this->r_dim.y * this->r_dim.z, -1);
+
+    // number the R vectors of hR
+    std::vector<ModuleBase::Vector3<int>> r_list;
+    for (int i = 0; i < hR.size_atom_pairs(); ++i)
+    {
+        const hamilt::AtomPair<TR>& tmp = hR.get_atom_pair(i);
+        for (int ir = 0; ir < tmp.get_R_size(); ++ir)
+        {
+            const ModuleBase::Vector3<int> r_index_ = tmp.get_R_index(ir);
+            int& index = this->r_index[this->box_index(r_index_)];
+            if (index < 0)
+            {
+                index = r_list.size();
+                r_list.push_back(r_index_);
+            }
+        }
+    }
+
+    const int nk = this->kvec_d.size();
+    this->phase.resize(r_list.size() * nk);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int iR = 0; iR < r_list.size(); ++iR)
+    {
+        const ModuleBase::Vector3<double> dR(r_list[iR].x, r_list[iR].y, r_list[iR].z);
+        for (int ik = 0; ik < nk; ++ik)
+        {
+            const double arg = (this->kvec_d[ik] * dR) * ModuleBase::TWO_PI;
+            double sinp, cosp;
+            ModuleBase::libm::sincos(arg, &sinp, &cosp);
+            this->phase[iR * nk + ik] = std::complex<double>(cosp, sinp);
+        }
+    }
+}
+
+template <typename TR>
+bool KRPhase::match(const std::vector<ModuleBase::Vector3<double>>& kvec_d_in, const hamilt::HContainer<TR>& hR) const
+{
+    if (kvec_d_in.size() != this->kvec_d.size())
+    {
+        return false;
+    }
+    for (int ik = 0; ik < kvec_d_in.size(); ++ik)
+    {
+        if (kvec_d_in[ik] != this->kvec_d[ik])
+        {
+            return false;
+        }
+    }
+    for (int i = 0; i < hR.size_atom_pairs(); ++i)
+    {
+        const hamilt::AtomPair<TR>& tmp = hR.get_atom_pair(i);
+        for (int ir = 0; ir < tmp.get_R_size(); ++ir)
+        {
+            if (this->get_phase(tmp.get_R_index(ir)) == nullptr)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int KRPhase::box_index(const ModuleBase::Vector3<int>& R) const
+{
+    const ModuleBase::Vector3<int> shift = R - this->r_min;
+    if (shift.x < 0 || shift.y < 0 || shift.z < 0 || shift.x >= this->r_dim.x || shift.y >= this->r_dim.y
+        || shift.z >= this->r_dim.z)
+    {
+        return -1;
+    }
+    return (shift.x * this->r_dim.y + shift.y) * this->r_dim.z + shift.z;
+}
+
+const std::complex<double>* KRPhase::get_phase(const ModuleBase::Vector3<int>& R) const
+{
+    const int index = this->box_index(R);
+    if (index < 0 || this->r_index[index] < 0)
+    {
+        return nullptr;
+    }
+    return this->phase.data() + this->r_index[index] * this->kvec_d.size();
+}
+
+template KRPhase::KRPhase(const std::vector<ModuleBase::Vector3<double>>& kvec_d_in,
+                          const hamilt::HContainer<double>& hR);
+template KRPhase::KRPhase(const std::vector<ModuleBase::Vector3<double>>& kvec_d_in,
+                          const hamilt::HContainer<std::complex<double>>& hR);
+template bool KRPhase::match(const std::vector<ModuleBase::Vector3<double>>& kvec_d_in,
+                             const hamilt::HContainer<double>& hR) const;
+template bool KRPhase::match(const std::vector<ModuleBase::Vector3<double>>& kvec_d_in,
+                             const hamilt::HContainer<std::complex<double>>& hR) const;
+
+namespace
+{
+
+// the matrices of all the R of the atom pair one after another, copied to buffer if they are not contiguous
+template <typename TR>
+const TR* get_R_blocks(const hamilt::AtomPair<TR>& ap, std::vector<TR>& buffer)
+{
+    const int size = ap.get_size();
+    const TR* first = ap.get_pointer(0);
+    bool contiguous = true;
+    for (int ir = 1; ir < ap.get_R_size(); ++ir)
+    {
+        contiguous = contiguous && (ap.get_pointer(ir) == first + ir * size);
+    }
+    if (contiguous)
+    {
+        return first;
+    }
+    buffer.resize(ap.get_R_size() * size);
+    for (int ir = 0; ir < ap.get_R_size(); ++ir)
+    {
+        std::copy(ap.get_pointer(ir), ap.get_pointer(ir) + size, buffer.data() + ir * size);
+    }
+    return buffer.data();
+}
+
+template <typename TR>
+const std::complex<double>* get_phase_of(const hamilt::AtomPair<TR>& ap, const int ir, const KRPhase& kr_phase)
+{
+    const std::complex<double>* phase = kr_phase.get_phase(ap.get_R_index(ir));
+    if (phase == nullptr)
+    {
+        ModuleBase::WARNING_QUIT("folding_HR", "the R vectors of the HContainer are not in the phase table");
+    }
+    return phase;
+}
+
+// hk[ik] += (re + i * im) for the block of the atom pair, re and im are row-major blocks
+void add_block_to_matrix(const hamilt::AtomPair<double>& ap,
+                         const int row_ap,
+                         const int col_ap,
+                         const double* re,
+                         const double* im,
+                         std::complex<double>* hk,
+                         const int ld_hk,
+                         const int hk_type)
+{
+    const int row_size = ap.get_row_size();
+    const int col_size = ap.get_col_size();
+    for (int mu = 0; mu < row_size; ++mu)
+    {
+        std::complex<double>* hk_tmp = (hk_type == 0) ? hk + (row_ap + mu) * ld_hk + col_ap : hk + col_ap * ld_hk + row_ap + mu;
+        const int step = (hk_type == 0) ? 1 : ld_hk;
+        for (int nu = 0; nu < col_size; ++nu)
+        {
+            hk_tmp[nu * step] += std::complex<double>(re[mu * col_size + nu], im[mu * col_size + nu]);
+        }
+    }
+}
+
+template <typename TR>
+void add_block_to_matrix(const hamilt::AtomPair<TR>& ap,
+                         const int row_ap,
+                         const int col_ap,
+                         const std::complex<double>* block,
+                         std::complex<double>* hk,
+                         const int ld_hk,
+                         const int hk_type)
+{
+    const int row_size = ap.get_row_size();
+    const int col_size = ap.get_col_size();
+    for (int mu = 0; mu < row_size; ++mu)
+    {
+        std::complex<double>* hk_tmp = (hk_type == 0) ? hk + (row_ap + mu) * ld_hk + col_ap : hk + col_ap * ld_hk + row_ap + mu;
+        const int step = (hk_type == 0) ? 1 : ld_hk;
+        for (int nu = 0; nu < col_size; ++nu)
+        {
+            hk_tmp[nu * step] += block[mu * col_size + nu];
+        }
+    }
+}
+
+// C(2nk x size) = [cos; sin](2nk x nR) * H(R)(nR x size), the real and imaginary parts of Hk
+void folding_atom_pair(const hamilt::AtomPair<double>& ap,
+                       const std::vector<std::complex<double>*>& hk,
+                       const KRPhase& kr_phase,
+                       const int ik_begin,
+                       const int ncol,
+                       const int hk_type)
+{
+    const int nR = ap.get_R_size();
+    const int size = ap.get_size();
+    const int nk = hk.size();
+    std::vector<double> a(2 * nk * nR);
+    for (int ir = 0; ir < nR; ++ir)
+    {
+        const std::complex<double>* phase = get_phase_of(ap, ir, kr_phase) + ik_begin;
+        for (int ik = 0; ik < nk; ++ik)
+        {
+            a[ik * nR + ir] = phase[ik].real();
+            a[(nk + ik) * nR + ir] = phase[ik].imag();
+        }
+    }
+    std::vector<double> buffer;
+    const double* b = get_R_blocks(ap, buffer);
+    std::vector<double> c(2 * nk * size);
+    BlasConnector::gemm('N', 'N', 2 * nk, size, nR, 1.0, a.data(), nR, b, size, 0.0, c.data(), size);
+
+    const std::vector<int> position = std::get<0>(ap.get_matrix_values(0));
+    for (int ik = 0; ik < nk; ++ik)
+    {
+        add_block_to_matrix(ap, position[0], position[2], &c[ik * size], &c[(nk + ik) * size], hk[ik], ncol, hk_type);
+    }
+}
+
+// C(nk x size) = e^{ikR}(nk x nR) * H(R)(nR x size)
+void folding_atom_pair(const hamilt::AtomPair<std::complex<double>>& ap,
+                       const std::vector<std::complex<double>*>& hk,
+                       const KRPhase& kr_phase,
+                       const int ik_begin,
+                       const int ncol,
+                       const int hk_type)
+{
+    const int nR = ap.get_R_size();
+    const int size = ap.get_size();
+    const int nk = hk.size();
+    std::vector<std::complex<double>> a(nk * nR);
+    for (int ir = 0; ir < nR; ++ir)
+    {
+        const std::complex<double>* phase = get_phase_of(ap, ir, kr_phase) + ik_begin;
+        for (int ik = 0; ik < nk; ++ik)
+        {
+            a[ik * nR + ir] = phase[ik];
+        }
+    }
+    std::vector<std::complex<double>> buffer;
+    const std::complex<double>* b = get_R_blocks(ap, buffer);
+    std::vector<std::complex<double>> c(nk * size);
+    const std::complex<double> one(1.0, 0.0);
+    const std::complex<double> zero(0.0, 0.0);
+    BlasConnector::gemm('N', 'N', nk, size, nR, one, a.data(), nR, b, size, zero, c.data(), size);
+
+    const std::vector<int> position = std::get<0>(ap.get_matrix_values(0));
+    for (int ik = 0; ik < nk; ++ik)
+    {
+        add_block_to_matrix(ap, position[0], position[2], &c[ik * size], hk[ik], ncol, hk_type);
+    }
+}
+
+} // namespace
+
+template <typename TR>
+void folding_HR(const hamilt::HContainer<TR>& hR,
+                const std::vector<std::complex<double>*>& hk,
+                const KRPhase& kr_phase,
+                const int ik_begin,
+                const int ncol,
+                const int hk_type)
+{
+    if (hk.empty())
+    {
+        return;
+    }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < hR.size_atom_pairs(); ++i)
+    {
+        const hamilt::AtomPair<TR>& tmp = hR.get_atom_pair(i);
+        if (tmp.get_R_size() > 0)
+        {
+            folding_atom_pair(tmp, hk, kr_phase, ik_begin, ncol, hk_type);
+        }
+    }
+}
+
+template void folding_HR<std::complex<double>>(const hamilt::HContainer<std::complex<double>>& hR,
+                                               const std::vector<std::complex<double>*>& hk,
+                                               const KRPhase& kr_phase,
+                                               const int ik_begin,
+                                               const int ncol,
+                                               const int hk_type);
+template void folding_HR<double>(const hamilt::HContainer<double>& hR,
+                                 const std::vector<std::complex<double>*>& hk,
+                                 const KRPhase& kr_phase,
+                                 const int ik_begin,
+                                 const int ncol,
+                                 const int hk_type);
+
+void folding_HR(const hamilt::HContainer<double>& hR,
+                const std::vector<double*>& hk,
+                const KRPhase& kr_phase,
+                const int ik_begin,
+                const int ncol,
+                const int hk_type)
+{
+    for (double* hk_tmp: hk)
+    {
+        folding_HR(hR, hk_tmp, ModuleBase::Vector3<double>(0, 0, 0), ncol, hk_type);
+    }
+}
+
+// B(2nk x size) = [Re; Im] of the blocks of hk, A(nR x 2nk) = [cos, -sin], hr = A * B
+void unfolding_HK(const hamilt::AtomPair<double>& ap,
+                  const std::vector<const std::complex<double>*>& hk,
+                  const int ld_hk,
+                  const KRPhase& kr_phase,
+                  double* hr)
+{
+    const int nR = ap.get_R_size();
+    const int nk = kr_phase.get_nk();
+    const int row_size = ap.get_row_size();
+    const int col_size = ap.get_col_size();
+    const int size = ap.get_size();
+    if (nR == 0)
+    {
+        return;
+    }
+    const std::vector<int> position = std::get<0>(ap.get_matrix_values(0));
+    std::vector<double> b(2 * nk * size);
+    for (int ik = 0; ik < nk; ++ik)
+    {
+        const std::complex<double>* hk_tmp = hk[ik] + position[2] * ld_hk + position[0];
+        double* re = &b[ik * size];
+        double* im = &b[(nk + ik) * size];
+        for (int nu = 0; nu < col_size; ++nu)
+        {
+            for (int mu = 0; mu < row_size; ++mu)
+            {
+                re[mu * col_size + nu] = hk_tmp[mu].real();
+                im[mu * col_size + nu] = hk_tmp[mu].imag();
+            }
+            hk_tmp += ld_hk;
+        }
+    }
+    std::vector<double> a(nR * 2 * nk);
+    for (int ir = 0; ir < nR; ++ir)
+    {
+        const std::complex<double>* phase = get_phase_of(ap, ir, kr_phase);
+        for (int ik = 0; ik < nk; ++ik)
+        {
+            a[ir * 2 * nk + ik] = phase[ik].real();
+            // "-" since i^2 = -1
+            a[ir * 2 * nk + nk + ik] = -phase[ik].imag();
+        }
+    }
+    BlasConnector::gemm('N', 'N', nR, size, 2 * nk, 1.0, a.data(), 2 * nk, b.data(), size, 0.0, hr, size);
+}
+
+void unfolding_HK(const hamilt::AtomPair<double>& ap,
+                  const std::vector<const std::complex<double>*>& hk,
+                  const int ld_hk,
+                  const KRPhase& kr_phase,
+                  std::complex<double>* hr)
+{
+    const int nR = ap.get_R_size();
+    const int nk = kr_phase.get_nk();
+    const int row_size = ap.get_row_size();
+    const int col_size = ap.get_col_size();
+    const int size = ap.get_size();
+    if (nR == 0)
+    {
+        return;
+    }
+    const std::vector<int> position = std::get<0>(ap.get_matrix_values(0));
+    std::vector<std::complex<double>> b(nk * size);
+    for (int ik = 0; ik < nk; ++ik)
+    {
+        const std::complex<double>* hk_tmp = hk[ik] + position[2] * ld_hk + position[0];
+        std::complex<double>* b_tmp = &b[ik * size];
+        for (int nu = 0; nu < col_size; ++nu)
+        {
+            for (int mu = 0; mu < row_size; ++mu)
+            {
+                b_tmp[mu * col_size + nu] = hk_tmp[mu];
+            }
+            hk_tmp += ld_hk;
+        }
+    }
+    std::vector<std::complex<double>> a(nR * nk);
+    for (int ir = 0; ir < nR; ++ir)
+    {
+        const std::complex<double>* phase = get_phase_of(ap, ir, kr_phase);
+        std::copy(phase, phase + nk, &a[ir * nk]);
+    }
+    const std::complex<double> one(1.0, 0.0);
+    const std::complex<double> zero(0.0, 0.0);
+    BlasConnector::gemm('N', 'N', nR, size, nk, one, a.data(), nk, b.data(), size, zero, hr, size);
+}
+
 } // namespace hamilt
\ No newline at end of file
@@ -731,6 +731,84 @@ void HContainer<T>::shape_synchron( const HContainer<T>& other)
     }
 }
 
+// update the shape to other
+template <typename T>
+int HContainer<T>::shape_update(const HContainer<T>& other)
+{
+    // check paraV pointer
+    if (this->paraV != other.paraV)
+    {
+        ModuleBase::WARNING_QUIT("HContainer::shape_update", "paraV pointer not match");
+    }
+    // a HContainer fixed to gamma case can be expanded to R-indexes again
+    this->gamma_only = other.gamma_only;
+    int nchange = 0;
+    std::vector<AtomPair<T>> new_pairs;
+    new_pairs.reserve(other.atom_pairs.size());
+    // 1. keep the atom_pairs of this which are in other with the same R-indexes
+    for (auto& atom_ij : this->atom_pairs)
+    {
+        const AtomPair<T>* tmp_pointer = other.find_pair(atom_ij.get_atom_i(), atom_ij.get_atom_j());
+        if (tmp_pointer == nullptr)
+        {
+            ++nchange;
+            continue;
+        }
+        bool same_R = atom_ij.get_R_size() == tmp_pointer->get_R_size();
+        for (int ir = 0; same_R && ir < atom_ij.get_R_size(); ++ir)
+        {
+            same_R = tmp_pointer->find_R(atom_ij.get_R_index(ir)) != -1;
+        }
+        if (same_R)
+        {
+            new_pairs.push_back(std::move(atom_ij));
+        }
+        else
+        {
+            new_pairs.push_back(*tmp_pointer);
+            ++nchange;
+        }
+    }
+    // 2. insert the new atom_pairs of other, sparse_ap of this is not changed yet
+    for (const auto& atom_ij : other.atom_pairs)
+    {
+        if (this->find_pair(atom_ij.get_atom_i(), atom_ij.get_atom_j()) == nullptr)
+        {
+            new_pairs.push_back(atom_ij);
+            ++nchange;
+        }
+    }
+    // the order of atom_pairs is kept if nothing changed, so sparse_ap is still valid
+    this->atom_pairs.swap(new_pairs);
+    if (nchange == 0)
+    {
+        return 0;
+    }
+    // 3. rebuild sparse_ap and sparse_ap_index
+    for (int iat = 0; iat < this->sparse_ap.size(); ++iat)
+    {
+        this->sparse_ap[iat].clear();
+        this->sparse_ap_index[iat].clear();
+    }
+    std::vector<std::vector<std::pair<int, int>>> ap_list(this->sparse_ap.size());
+    for (int iap = 0; iap < this->atom_pairs.size(); ++iap)
+    {
+        ap_list[this->atom_pairs[iap].get_atom_i()].push_back({this->atom_pairs[iap].get_atom_j(), iap});
+    }
+    for (int iat = 0; iat < ap_list.size(); ++iat)
+    {
+        std::sort(ap_list[iat].begin(), ap_list[iat].end());
+        for (const auto& ap: ap_list[iat])
+        {
+            this->sparse_ap[iat].push_back(ap.first);
+            this->sparse_ap_index[iat].push_back(ap.second);
+        }
+    }
+    // the R-indexes of tmp_atom_pairs may be changed
+    this->unfix_R();
+    return nchange;
+}
+
 // get_IJR_info
 template <typename T>
 std::vector<int> HContainer<T>::get_ijr_info() const
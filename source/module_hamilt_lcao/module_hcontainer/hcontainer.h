@@ -434,6 +434,17 @@ class HContainer
      */
     void shape_synchron(const HContainer<T>& other);
 
+    /**
+     * @brief update the atom-pairs and R-indexes to those of other, used when the atoms are moved
+     * the <IJR> pairs not in other are removed, the new ones of other are inserted,
+     * and the AtomPairs with the same R-indexes are kept, gamma_only is also set to that of other.
+     * if nothing changed, the data is not touched,
+     * otherwise HContainer has not been allocated after this function,
+     * user should call allocate(...) to allocate memory.
+     * @return the number of atom-pairs removed, inserted or changed
+     */
+    int shape_update(const HContainer<T>& other);
+
     /**
      * @brief get sparse_ap
      * @return std::vector<std::vector<int>>&
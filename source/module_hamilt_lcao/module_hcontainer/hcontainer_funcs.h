@@ -25,6 +25,100 @@ void folding_HR(const hamilt::HContainer<double>& hR,
                 const int ncol,
                 const int hk_type);
 
+/**
+ * @brief the phases e^{ikR} of a set of k points and of the R vectors of a HContainer
+ * they are calculated once for the geometry and the k points, then the foldings between
+ * R and k are done with GEMM over the R vectors and the k points of each atom pair.
+*/
+class KRPhase
+{
+  public:
+    /**
+     * @param kvec_d the k vectors in Direct coordinate
+     * @param hR the HContainer giving the R vectors
+    */
+    template <typename TR>
+    KRPhase(const std::vector<ModuleBase::Vector3<double>>& kvec_d, const hamilt::HContainer<TR>& hR);
+
+    /// whether the table is made of the k points kvec_d and has all the R vectors of hR
+    template <typename TR>
+    bool match(const std::vector<ModuleBase::Vector3<double>>& kvec_d, const hamilt::HContainer<TR>& hR) const;
+
+    int get_nk() const
+    {
+        return this->kvec_d.size();
+    }
+
+    /// e^{ikR} of all the k points, nullptr if R is not in the table
+    const std::complex<double>* get_phase(const ModuleBase::Vector3<int>& R) const;
+
+    size_t get_memory_size() const
+    {
+        return this->phase.size() * sizeof(std::complex<double>) + this->r_index.size() * sizeof(int);
+    }
+
+  private:
+    // index of R in r_index, -1 if R is out of the box
+    int box_index(const ModuleBase::Vector3<int>& R) const;
+
+    std::vector<ModuleBase::Vector3<double>> kvec_d;
+    // the box of R vectors
+    ModuleBase::Vector3<int> r_min;
+    ModuleBase::Vector3<int> r_dim;
+    // index of each R of the box in phase, -1 if R is not in the HContainer
+    std::vector<int> r_index;
+    // phase[iR * nk + ik] = e^{i k R}
+    std::vector<std::complex<double>> phase;
+};
+
+/**
+ * @brief calculate the Hk matrices of several k points at once
+ * hk[i] += sum_R e^{ikR} hR(R) for the k point ik_begin + i of kr_phase, with one GEMM for each atom pair
+ * @param hR the HContainer of <I,J,R> atom pairs
+ * @param hk the data pointers of Hk matrices
+ * @param kr_phase the phases of the k points and of the R vectors of hR
+ * @param ik_begin the index in kr_phase of the k point of hk[0]
+ * @param ncol the leading dimension number of hk, ncol for row-major, nrow for column-major
+ * @param hk_type the data-type of hk, 0 is row-major, 1 is column-major
+*/
+template<typename TR>
+void folding_HR(const hamilt::HContainer<TR>& hR,
+                const std::vector<std::complex<double>*>& hk,
+                const KRPhase& kr_phase,
+                const int ik_begin,
+                const int ncol,
+                const int hk_type);
+
+// gamma_only case, the phases are 1
+void folding_HR(const hamilt::HContainer<double>& hR,
+                const std::vector<double*>& hk,
+                const KRPhase& kr_phase,
+                const int ik_begin,
+                const int ncol,
+                const int hk_type);
+
+/**
+ * @brief calculate the matrices of one atom pair in R space from all the k points of kr_phase
+ * hr(R) = sum_k Re(e^{ikR} hk[ik]) for all the R of ap, with one GEMM
+ * @param ap the atom pair giving the R vectors and the position of the block in hk
+ * @param hk the data pointers of Hk matrices of all the k points, column-major
+ * @param ld_hk the leading dimension of hk
+ * @param kr_phase the phases of the k points and of the R vectors of ap
+ * @param hr the output, ap.get_R_size() row-major blocks of ap.get_size() one after another
+*/
+void unfolding_HK(const hamilt::AtomPair<double>& ap,
+                  const std::vector<const std::complex<double>*>& hk,
+                  const int ld_hk,
+                  const KRPhase& kr_phase,
+                  double* hr);
+
+// same as above without taking the real part, hr(R) = sum_k e^{ikR} hk[ik]
+void unfolding_HK(const hamilt::AtomPair<double>& ap,
+                  const std::vector<const std::complex<double>*>& hk,
+                  const int ld_hk,
+                  const KRPhase& kr_phase,
+                  std::complex<double>* hr);
+
 #ifdef __MPI
 /**
  * @brief transfer the HContainer from serial object to parallel object
@@ -0,0 +1,169 @@
+#include "sparse_csr.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+namespace hamilt
+{
+
+template <typename T>
+void SparseCSR<T>::finalize(const double& sparse_threshold)
+{
+    if (this->staged_.empty())
+    {
+        this->drop_small(sparse_threshold);
+        return;
+    }
+    // the already compressed elements are put in front of the staged ones,
+    // so that the summation order of duplicated elements is kept as the order of add()
+    std::vector<Triplet> all;
+    all.reserve(this->values_.size() + this->staged_.size());
+    for (int ir = 0; ir < this->nrows(); ++ir)
+    {
+        for (int k = this->row_ptr_[ir]; k < this->row_ptr_[ir + 1]; ++k)
+        {
+            all.push_back(Triplet{this->rows_[ir], this->col_ind_[k], this->values_[k]});
+        }
+    }
+    all.insert(all.end(), this->staged_.begin(), this->staged_.end());
+    std::vector<Triplet>().swap(this->staged_);
+
+    std::stable_sort(all.begin(), all.end(), [](const Triplet& a, const Triplet& b) {
+        return a.row < b.row || (a.row == b.row && a.col < b.col);
+    });
+
+    this->rows_.clear();
+    this->row_ptr_.clear();
+    this->col_ind_.clear();
+    this->values_.clear();
+    this->col_ind_.reserve(all.size());
+    this->values_.reserve(all.size());
+
+    size_t i = 0;
+    while (i < all.size())
+    {
+        // sum all elements at the same (row, col)
+        T value = all[i].value;
+        size_t j = i + 1;
+        while (j < all.size() && all[j].row == all[i].row && all[j].col == all[i].col)
+        {
+            value += all[j].value;
+            ++j;
+        }
+        if (std::abs(value) > sparse_threshold)
+        {
+            if (this->rows_.empty() || this->rows_.back() != all[i].row)
+            {
+                this->rows_.push_back(all[i].row);
+                this->row_ptr_.push_back(this->col_ind_.size());
+            }
+            this->col_ind_.push_back(all[i].col);
+            this->values_.push_back(value);
+        }
+        i = j;
+    }
+    this->row_ptr_.push_back(this->col_ind_.size());
+
+    this->col_ind_.shrink_to_fit();
+    this->values_.shrink_to_fit();
+    this->rows_.shrink_to_fit();
+    this->row_ptr_.shrink_to_fit();
+}
+
+template <typename T>
+void SparseCSR<T>::drop_small(const double& sparse_threshold)
+{
+    std::vector<int> rows_new;
+    std::vector<int> row_ptr_new(1, 0);
+    size_t inew = 0;
+    for (int ir = 0; ir < this->nrows(); ++ir)
+    {
+        for (int k = this->row_ptr_[ir]; k < this->row_ptr_[ir + 1]; ++k)
+        {
+            if (std::abs(this->values_[k]) > sparse_threshold)
+            {
+                this->col_ind_[inew] = this->col_ind_[k];
+                this->values_[inew] = this->values_[k];
+                ++inew;
+            }
+        }
+        if (inew > static_cast<size_t>(row_ptr_new.back()))
+        {
+            rows_new.push_back(this->rows_[ir]);
+            row_ptr_new.push_back(inew);
+        }
+    }
+    if (inew == this->values_.size())
+    {
+        return;
+    }
+    this->col_ind_.resize(inew);
+    this->values_.resize(inew);
+    this->rows_.swap(rows_new);
+    this->row_ptr_.swap(row_ptr_new);
+}
+
+template <typename T>
+void SparseCSR<T>::clear()
+{
+    std::vector<Triplet>().swap(this->staged_);
+    std::vector<int>().swap(this->rows_);
+    std::vector<int>().swap(this->row_ptr_);
+    std::vector<int>().swap(this->col_ind_);
+    std::vector<T>().swap(this->values_);
+}
+
+template <typename T>
+int SparseCSR<T>::find_row(const int row) const
+{
+    auto it = std::lower_bound(this->rows_.begin(), this->rows_.end(), row);
+    if (it == this->rows_.end() || *it != row)
+    {
+        return -1;
+    }
+    return static_cast<int>(it - this->rows_.begin());
+}
+
+template <typename T>
+T SparseCSR<T>::get_value(const int row, const int col) const
+{
+    const int ir = this->find_row(row);
+    if (ir < 0)
+    {
+        return static_cast<T>(0);
+    }
+    auto begin = this->col_ind_.begin() + this->row_ptr_[ir];
+    auto end = this->col_ind_.begin() + this->row_ptr_[ir + 1];
+    auto it = std::lower_bound(begin, end, col);
+    if (it == end || *it != col)
+    {
+        return static_cast<T>(0);
+    }
+    return this->values_[it - this->col_ind_.begin()];
+}
+
+template <typename T>
+size_t SparseCSR<T>::get_memory_size() const
+{
+    return this->staged_.capacity() * sizeof(Triplet)
+           + (this->rows_.capacity() + this->row_ptr_.capacity() + this->col_ind_.capacity()) * sizeof(int)
+           + this->values_.capacity() * sizeof(T);
+}
+
+template <typename T>
+void finalize_sparse_R(SparseCSR_R<T>& sR, const double& sparse_threshold)
+{
+    for (auto& R_loop: sR)
+    {
+        R_loop.second.finalize(sparse_threshold);
+    }
+}
+
+// T of SparseCSR can be double or complex<double>
+template class SparseCSR<double>;
+template class SparseCSR<std::complex<double>>;
+template void finalize_sparse_R<double>(SparseCSR_R<double>&, const double&);
+template void finalize_sparse_R<std::complex<double>>(SparseCSR_R<std::complex<double>>&, const double&);
+
+} // namespace hamilt
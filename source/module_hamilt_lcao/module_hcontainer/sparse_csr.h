@@ -0,0 +1,167 @@
+#ifndef W_ABACUS_DEVELOP_ABACUS_DEVELOP_SOURCE_MODULE_HAMILT_LCAO_MODULE_HCONTAINER_SPARSE_CSR_H
+#define W_ABACUS_DEVELOP_ABACUS_DEVELOP_SOURCE_MODULE_HAMILT_LCAO_MODULE_HCONTAINER_SPARSE_CSR_H
+
+#include "module_base/abfs-vector3_order.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace hamilt
+{
+
+/**
+ * class SparseCSR
+ * used to store one R-block of a sparse matrix <Psi_{mu,0}|O|Psi_{nu,R}> with global orbital indexes,
+ * it replaces the old nested std::map<size_t, std::map<size_t, T>> storage
+ * ----------------------------------------
+ * the data is filled in two phases:
+ * 1. stage elements with add() in any order, duplicated (row, col) elements are summed in finalize()
+ * 2. call finalize() to sort and compress the staged elements into CSR arrays
+ *    elements with absolute value not larger than the threshold are dropped in finalize()
+ * read interfaces (nnz(), row_ptr(), col_ind(), values(), get_value()) are only valid after finalize()
+ * add() can be called again after finalize(), the next finalize() will merge the new elements
+ * ----------------------------------------
+ * only non-empty rows are stored:
+ *   rows()[i] is the global row index of i-th stored row,
+ *   its elements are col_ind()[k], values()[k] with row_ptr()[i] <= k < row_ptr()[i+1]
+ * template T can be double or complex<double>
+ *
+ * example:
+ *     ```
+ *       SparseCSR<double> sR;
+ *       sR.add(0, 3, 0.5);
+ *       sR.add(0, 3, 0.1); // will be summed with the former one
+ *       sR.add(2, 1, 1e-12);
+ *       sR.finalize(1e-10); // (2, 1) is dropped
+ *       for (int ir = 0; ir < sR.nrows(); ++ir)
+ *       {
+ *           for (int k = sR.row_ptr()[ir]; k < sR.row_ptr()[ir + 1]; ++k)
+ *           {
+ *               // row: sR.rows()[ir], col: sR.col_ind()[k], value: sR.values()[k]
+ *           }
+ *       }
+ *     ```
+ */
+template <typename T>
+class SparseCSR
+{
+  public:
+    SparseCSR() = default;
+    ~SparseCSR() = default;
+
+    /**
+     * @brief stage one element, it will be summed with other elements at the same (row, col) in finalize()
+     */
+    void add(const int row, const int col, const T& value)
+    {
+        this->staged_.push_back(Triplet{row, col, value});
+    }
+
+    /**
+     * @brief reserve space for n more elements to be staged, the capacity grows geometrically
+     */
+    void reserve(const size_t n)
+    {
+        const size_t required = this->staged_.size() + n;
+        if (this->staged_.capacity() < required)
+        {
+            this->staged_.reserve(std::max(required, 2 * this->staged_.capacity()));
+        }
+    }
+
+    /**
+     * @brief merge staged elements into CSR arrays, drop elements with |value| <= sparse_threshold
+     * the summation order of duplicated elements is the order of add() calls
+     */
+    void finalize(const double& sparse_threshold);
+
+    /// @brief clear all data and release memory
+    void clear();
+
+    /// @brief number of stored elements, valid after finalize()
+    size_t nnz() const
+    {
+        return this->values_.size();
+    }
+    /// @brief number of stored (non-empty) rows, valid after finalize()
+    int nrows() const
+    {
+        return static_cast<int>(this->rows_.size());
+    }
+    bool empty() const
+    {
+        return this->values_.empty() && this->staged_.empty();
+    }
+    /// @brief true if there are elements waiting for finalize()
+    bool has_staged() const
+    {
+        return !this->staged_.empty();
+    }
+
+    const std::vector<int>& rows() const
+    {
+        return this->rows_;
+    }
+    const std::vector<int>& row_ptr() const
+    {
+        return this->row_ptr_;
+    }
+    const std::vector<int>& col_ind() const
+    {
+        return this->col_ind_;
+    }
+    const std::vector<T>& values() const
+    {
+        return this->values_;
+    }
+
+    /**
+     * @brief get the value of (row, col), return 0 if it is not stored
+     * binary search on rows and columns, valid after finalize()
+     */
+    T get_value(const int row, const int col) const;
+
+    /**
+     * @brief find the position of row in rows(), return -1 if it is not stored
+     */
+    int find_row(const int row) const;
+
+    /// @brief memory used by this object in bytes
+    size_t get_memory_size() const;
+
+  private:
+    /// @brief drop elements with |value| <= sparse_threshold from the CSR arrays in place
+    void drop_small(const double& sparse_threshold);
+
+    struct Triplet
+    {
+        int row;
+        int col;
+        T value;
+    };
+    std::vector<Triplet> staged_;
+
+    std::vector<int> rows_;
+    std::vector<int> row_ptr_;
+    std::vector<int> col_ind_;
+    std::vector<T> values_;
+};
+
+/**
+ * sparse matrix O(R) for all R, one SparseCSR for each R-index
+ * std::map is kept for the R level because the number of R is small and R-indexes should be ordered in output
+ */
+template <typename T>
+using SparseCSR_R = std::map<Abfs::Vector3_Order<int>, SparseCSR<T>>;
+
+/**
+ * @brief finalize all R-blocks of sR, R-blocks with no element left are kept as empty blocks
+ */
+template <typename T>
+void finalize_sparse_R(SparseCSR_R<T>& sR, const double& sparse_threshold);
+
+} // namespace hamilt
+
+#endif
@@ -210,4 +210,159 @@ TEST_F(FoldingTest, folding_HR_d2d)
     std::cout << "HR init time: " << elapsed_time0.count()<<" fix_gamma time: "<<fix_gamma_time.count()<<" folding time: "<< elapsed_time.count()<<" and "<<elapsed_time1.count() << " seconds." << std::endl;
 
     delete HR;
-}
\ No newline at end of file
+}
+// using TEST_F to test folding_HR of several k points with the phases of KRPhase, compared with folding_HR of each k point
+TEST_F(FoldingTest, folding_HR_batch)
+{
+    const int nlocal = test_size * test_nw;
+    hamilt::HContainer<std::complex<double>> HR_cd(ucell);
+    hamilt::HContainer<double> HR_d(ucell);
+    // 27 cells around the center cell
+    for (int i = 0; i < HR_cd.size_atom_pairs(); i++)
+    {
+        for (int rx = -1; rx <= 1; rx++)
+        {
+            for (int ry = -1; ry <= 1; ry++)
+            {
+                for (int rz = -1; rz <= 1; rz++)
+                {
+                    std::complex<double>* ptr_cd = HR_cd.get_atom_pair(i).get_HR_values(rx, ry, rz).get_pointer();
+                    double* ptr_d = HR_d.get_atom_pair(i).get_HR_values(rx, ry, rz).get_pointer();
+                    for (int j = 0; j < HR_cd.get_atom_pair(i).get_size(); j++)
+                    {
+                        const double value = std::sin(0.1 * i + 0.3 * j + rx + 2.0 * ry + 3.0 * rz);
+                        ptr_cd[j] = std::complex<double>(value, 0.5 * value);
+                        ptr_d[j] = value;
+                    }
+                }
+            }
+        }
+    }
+    const int nk = 8;
+    std::vector<ModuleBase::Vector3<double>> kvec_d(nk);
+    for (int ik = 0; ik < nk; ik++)
+    {
+        kvec_d[ik] = ModuleBase::Vector3<double>(0.1 * ik, 0.05 * ik, -0.125 * ik);
+    }
+    hamilt::KRPhase kr_phase(kvec_d, HR_cd);
+    EXPECT_TRUE(kr_phase.match(kvec_d, HR_d));
+    EXPECT_FALSE(kr_phase.match(std::vector<ModuleBase::Vector3<double>>(kvec_d.begin(), kvec_d.begin() + 2), HR_d));
+
+    for (int hk_type = 0; hk_type < 2; hk_type++)
+    {
+        std::vector<std::vector<std::complex<double>>> hk_ref(nk, std::vector<std::complex<double>>(nlocal * nlocal));
+        std::vector<std::vector<std::complex<double>>> hk(nk, std::vector<std::complex<double>>(nlocal * nlocal));
+        std::vector<std::complex<double>*> hk_pointers(nk);
+        for (int ik = 0; ik < nk; ik++)
+        {
+            hk_pointers[ik] = hk[ik].data();
+        }
+        std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+        for (int ik = 0; ik < nk; ik++)
+        {
+            hamilt::folding_HR(HR_cd, hk_ref[ik].data(), kvec_d[ik], nlocal, hk_type);
+            hamilt::folding_HR(HR_d, hk_ref[ik].data(), kvec_d[ik], nlocal, hk_type);
+        }
+        std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsed_time0 = std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time);
+        start_time = std::chrono::high_resolution_clock::now();
+        hamilt::folding_HR(HR_cd, hk_pointers, kr_phase, 0, nlocal, hk_type);
+        hamilt::folding_HR(HR_d, hk_pointers, kr_phase, 0, nlocal, hk_type);
+        end_time = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsed_time = std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time);
+        for (int ik = 0; ik < nk; ik++)
+        {
+            for (int i = 0; i < nlocal * nlocal; i++)
+            {
+                EXPECT_NEAR(hk[ik][i].real(), hk_ref[ik][i].real(), 1e-10);
+                EXPECT_NEAR(hk[ik][i].imag(), hk_ref[ik][i].imag(), 1e-10);
+            }
+        }
+        // a part of the k points
+        std::vector<std::complex<double>> hk_one(nlocal * nlocal);
+        hamilt::folding_HR(HR_cd, {hk_one.data()}, kr_phase, 5, nlocal, hk_type);
+        hamilt::folding_HR(HR_d, {hk_one.data()}, kr_phase, 5, nlocal, hk_type);
+        for (int i = 0; i < nlocal * nlocal; i++)
+        {
+            EXPECT_NEAR(hk_one[i].real(), hk_ref[5][i].real(), 1e-10);
+            EXPECT_NEAR(hk_one[i].imag(), hk_ref[5][i].imag(), 1e-10);
+        }
+        std::cout << "folding of " << nk << " k points, each k point: " << elapsed_time0.count()
+                  << " GEMM: " << elapsed_time.count() << " seconds." << std::endl;
+    }
+}
+
+// using TEST_F to test unfolding_HK, DM(R) = sum_k Re(e^{ikR} DM(k)) with one GEMM for each atom pair
+TEST_F(FoldingTest, unfolding_HK)
+{
+    const int nlocal = test_size * test_nw;
+    hamilt::HContainer<double> DMR(ucell);
+    for (int i = 0; i < DMR.size_atom_pairs(); i++)
+    {
+        for (int rx = -1; rx <= 1; rx++)
+        {
+            for (int rz = -2; rz <= 2; rz++)
+            {
+                DMR.get_atom_pair(i).get_HR_values(rx, 0, rz);
+            }
+        }
+    }
+    const int nk = 6;
+    std::vector<ModuleBase::Vector3<double>> kvec_d(nk);
+    std::vector<std::vector<std::complex<double>>> dmk(nk, std::vector<std::complex<double>>(nlocal * nlocal));
+    std::vector<const std::complex<double>*> dmk_pointers(nk);
+    for (int ik = 0; ik < nk; ik++)
+    {
+        kvec_d[ik] = ModuleBase::Vector3<double>(0.2 * ik, 0.1, 0.15 * ik);
+        for (int i = 0; i < nlocal * nlocal; i++)
+        {
+            dmk[ik][i] = std::complex<double>(std::cos(0.7 * i + ik), std::sin(0.3 * i - ik));
+        }
+        dmk_pointers[ik] = dmk[ik].data();
+    }
+    hamilt::KRPhase kr_phase(kvec_d, DMR);
+
+    std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < DMR.size_atom_pairs(); i++)
+    {
+        hamilt::AtomPair<double>& tmp = DMR.get_atom_pair(i);
+        for (int ir = 0; ir < tmp.get_R_size(); ir++)
+        {
+            const ModuleBase::Vector3<int> r_index = tmp.get_R_index(ir);
+            tmp.find_R(r_index);
+            for (int ik = 0; ik < nk; ik++)
+            {
+                const double arg = (kvec_d[ik] * ModuleBase::Vector3<double>(r_index.x, r_index.y, r_index.z))
+                                   * ModuleBase::TWO_PI;
+                // Re(e^{ikR} DM(k)) = Re(e^{ikR}) Re(DM(k)) + Im(e^{-ikR}) Im(DM(k))
+                tmp.add_from_matrix(dmk[ik].data(), nlocal, std::complex<double>(std::cos(arg), -std::sin(arg)), 1);
+            }
+        }
+    }
+    std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed_time0 = std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time);
+
+    double gemm_time = 0.0;
+    for (int i = 0; i < DMR.size_atom_pairs(); i++)
+    {
+        const hamilt::AtomPair<double>& tmp = DMR.get_atom_pair(i);
+        std::vector<double> dmr(tmp.get_R_size() * tmp.get_size());
+        std::vector<std::complex<double>> dmr_nc(tmp.get_R_size() * tmp.get_size());
+        start_time = std::chrono::high_resolution_clock::now();
+        hamilt::unfolding_HK(tmp, dmk_pointers, nlocal, kr_phase, dmr.data());
+        end_time = std::chrono::high_resolution_clock::now();
+        gemm_time += std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count();
+        hamilt::unfolding_HK(tmp, dmk_pointers, nlocal, kr_phase, dmr_nc.data());
+        for (int ir = 0; ir < tmp.get_R_size(); ir++)
+        {
+            const double* ref = tmp.get_pointer(ir);
+            for (int j = 0; j < tmp.get_size(); j++)
+            {
+                EXPECT_NEAR(dmr[ir * tmp.get_size() + j], ref[j], 1e-10);
+                EXPECT_NEAR(dmr_nc[ir * tmp.get_size() + j].real(), ref[j], 1e-10);
+            }
+        }
+    }
+    std::cout << "unfolding of " << nk << " k points, each k point: " << elapsed_time0.count() << " GEMM: " << gemm_time
+              << " seconds." << std::endl;
+}
@@ -12,6 +12,7 @@
  * 6. loop_R
  * 7. size_atom_pairs
  * 8. data
+ * 9. shape_update
  *
  */
 
@@ -605,6 +606,71 @@ TEST_F(HContainerTest, atompair_funcs)
     EXPECT_EQ(HR_no_wrapper.size_R_loop(), 1);
 }
 
+// using TEST_F to test HContainer::shape_update
+TEST_F(HContainerTest, shape_update)
+{
+    EXPECT_EQ(HR->size_atom_pairs(), 9);
+    // the diagonal pairs are kept, (0, 1) has a new R-index, the other pairs are removed
+    hamilt::HContainer<double> HR_new(ucell.nat);
+    for (int iat = 0; iat < ucell.nat; iat++)
+    {
+        hamilt::AtomPair<double> atom_ii(iat, iat);
+        atom_ii.set_size(2, 2);
+        atom_ii.get_HR_values(0, 0, 0);
+        HR_new.insert_pair(atom_ii);
+    }
+    hamilt::AtomPair<double> atom_ij(0, 1);
+    atom_ij.set_size(2, 2);
+    atom_ij.get_HR_values(0, 0, 0);
+    atom_ij.get_HR_values(1, 0, 0);
+    HR_new.insert_pair(atom_ij);
+    // HR fixed to gamma case is expanded to R-indexes of HR_new
+    HR->fix_gamma();
+    EXPECT_EQ(HR->shape_update(HR_new), 6);
+    EXPECT_EQ(HR->is_gamma_only(), false);
+    HR->allocate(nullptr, true);
+    EXPECT_EQ(HR->size_atom_pairs(), 4);
+    EXPECT_EQ(HR->get_nnr(), 20);
+    EXPECT_EQ(HR->get_atom_pair(0, 1).get_R_size(), 2);
+    EXPECT_EQ(HR->find_pair(0, 2), nullptr);
+    EXPECT_EQ(HR->find_pair(1, 0), nullptr);
+    for (int iat = 0; iat < ucell.nat; iat++)
+    {
+        EXPECT_EQ(HR->get_atom_pair(iat, iat).get_atom_i(), iat);
+        EXPECT_EQ(HR->get_atom_pair(iat, iat).get_atom_j(), iat);
+    }
+    // nothing changed, the data is kept
+    HR->get_atom_pair(1, 1).get_HR_values(0, 0, 0).get_pointer()[3] = 5.0;
+    EXPECT_EQ(HR->shape_update(HR_new), 0);
+    EXPECT_EQ(HR->get_atom_pair(1, 1).get_value(1, 1), 5.0);
+
+    // (0, 1) leaves, (1, 2) enters
+    hamilt::HContainer<double> HR_next(ucell.nat);
+    for (int iat = 0; iat < ucell.nat; iat++)
+    {
+        hamilt::AtomPair<double> atom_ii(iat, iat);
+        atom_ii.set_size(2, 2);
+        atom_ii.get_HR_values(0, 0, 0);
+        HR_next.insert_pair(atom_ii);
+    }
+    hamilt::AtomPair<double> atom_jk(1, 2);
+    atom_jk.set_size(2, 2);
+    atom_jk.get_HR_values(0, 0, 0);
+    HR_next.insert_pair(atom_jk);
+    EXPECT_EQ(HR->shape_update(HR_next), 2);
+    HR->allocate(nullptr, true);
+    EXPECT_EQ(HR->size_atom_pairs(), 4);
+    EXPECT_EQ(HR->get_nnr(), 16);
+    EXPECT_EQ(HR->find_pair(0, 1), nullptr);
+    EXPECT_EQ(HR->get_atom_pair(1, 2).get_atom_j(), 2);
+    // the AtomPairs are continuous in the memory pool
+    EXPECT_EQ(HR->get_atom_pair(0).get_pointer(), HR->get_wrapper());
+    for (int iap = 1; iap < HR->size_atom_pairs(); iap++)
+    {
+        EXPECT_EQ(HR->get_atom_pair(iap).get_pointer(), HR->get_atom_pair(iap - 1).get_pointer() + 4);
+    }
+}
+
 // Test for Wrapper mode in HContainer
 // 1. test constructor of wrapper mode BaseMatrix
 // 2. test constructor of wrapper mode AtomPair
@@ -0,0 +1,190 @@
+#include "gtest/gtest.h"
+#include "module_hamilt_lcao/module_hcontainer/sparse_csr.h"
+
+#include <chrono>
+#include <complex>
+#include <cstdlib>
+
+/**
+ * Unit test of SparseCSR
+ * SparseCSR is the CSR storage of one R-block of sparse matrices in LCAO_HS_Arrays, tested functions:
+ * 1. add() and finalize(), including summation of duplicated elements and threshold
+ * 2. add() after finalize()
+ * 3. get_value() and find_row()
+ * 4. finalize_sparse_R()
+ * 5. cost of building SparseCSR_R compared with the former nested std::map storage
+ */
+
+TEST(SparseCSRTest, AddFinalize)
+{
+    hamilt::SparseCSR<double> sR;
+    sR.add(3, 1, 0.1);
+    sR.add(0, 4, 0.5);
+    sR.add(0, 2, 0.2);
+    sR.add(3, 1, 0.3);
+    sR.add(5, 0, 1e-12);
+    EXPECT_TRUE(sR.has_staged());
+    sR.finalize(1e-10);
+    EXPECT_FALSE(sR.has_staged());
+
+    EXPECT_EQ(sR.nnz(), 3);
+    EXPECT_EQ(sR.nrows(), 2);
+    EXPECT_EQ(sR.rows()[0], 0);
+    EXPECT_EQ(sR.rows()[1], 3);
+    EXPECT_EQ(sR.row_ptr()[0], 0);
+    EXPECT_EQ(sR.row_ptr()[1], 2);
+    EXPECT_EQ(sR.row_ptr()[2], 3);
+    EXPECT_EQ(sR.col_ind()[0], 2);
+    EXPECT_EQ(sR.col_ind()[1], 4);
+    EXPECT_EQ(sR.col_ind()[2], 1);
+    EXPECT_DOUBLE_EQ(sR.values()[0], 0.2);
+    EXPECT_DOUBLE_EQ(sR.values()[1], 0.5);
+    EXPECT_DOUBLE_EQ(sR.values()[2], 0.4);
+}
+
+TEST(SparseCSRTest, AddAfterFinalize)
+{
+    hamilt::SparseCSR<std::complex<double>> sR;
+    sR.add(1, 1, std::complex<double>(1.0, 1.0));
+    sR.add(2, 0, std::complex<double>(0.5, 0.0));
+    sR.finalize(1e-10);
+    EXPECT_EQ(sR.nnz(), 2);
+
+    // cancel one element and add a new one
+    sR.add(2, 0, std::complex<double>(-0.5, 0.0));
+    sR.add(0, 3, std::complex<double>(0.0, 2.0));
+    sR.finalize(1e-10);
+    EXPECT_EQ(sR.nnz(), 2);
+    EXPECT_EQ(sR.nrows(), 2);
+    EXPECT_EQ(sR.get_value(0, 3), std::complex<double>(0.0, 2.0));
+    EXPECT_EQ(sR.get_value(1, 1), std::complex<double>(1.0, 1.0));
+    EXPECT_EQ(sR.get_value(2, 0), std::complex<double>(0.0, 0.0));
+    EXPECT_EQ(sR.find_row(2), -1);
+    EXPECT_EQ(sR.find_row(1), 1);
+
+    // a larger threshold drops elements without staged ones
+    sR.finalize(1.5);
+    EXPECT_EQ(sR.nnz(), 1);
+    EXPECT_EQ(sR.nrows(), 1);
+    EXPECT_EQ(sR.rows()[0], 0);
+
+    sR.clear();
+    EXPECT_TRUE(sR.empty());
+    EXPECT_EQ(sR.nrows(), 0);
+}
+
+TEST(SparseCSRTest, FinalizeSparseR)
+{
+    hamilt::SparseCSR_R<double> sR;
+    sR[Abfs::Vector3_Order<int>(0, 0, 0)].add(0, 0, 1.0);
+    sR[Abfs::Vector3_Order<int>(1, 0, 0)].add(0, 1, 1e-12);
+    sR[Abfs::Vector3_Order<int>(-1, 0, 0)].add(1, 0, 2.0);
+    hamilt::finalize_sparse_R(sR, 1e-10);
+    EXPECT_EQ(sR.size(), 3);
+    EXPECT_EQ(sR[Abfs::Vector3_Order<int>(0, 0, 0)].nnz(), 1);
+    EXPECT_EQ(sR[Abfs::Vector3_Order<int>(1, 0, 0)].nnz(), 0);
+    EXPECT_DOUBLE_EQ(sR[Abfs::Vector3_Order<int>(-1, 0, 0)].get_value(1, 0), 2.0);
+}
+
+// build a block-sparse matrix like H(R) of LCAO with both storages and compare the cost
+TEST(SparseCSRTest, CostCompareWithMap)
+{
+    const int natom = 100;
+    const int nw = 13;
+    const int nadj = 20;
+    const int nR = 5;
+    srand(0);
+
+    std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, double>>> HR_map;
+    hamilt::SparseCSR_R<double> HR_csr;
+
+    auto value = [](int i, int j, int r) { return 1.0 / (1.0 + i + j + r); };
+    std::vector<int> adj(natom * nadj);
+    for (auto& a: adj)
+    {
+        a = rand() % natom;
+    }
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int iR = 0; iR < nR; ++iR)
+    {
+        Abfs::Vector3_Order<int> dR(iR - nR / 2, 0, 0);
+        for (int iat = 0; iat < natom; ++iat)
+        {
+            for (int ad = 0; ad < nadj; ++ad)
+            {
+                const int jat = adj[iat * nadj + ad];
+                for (int i = 0; i < nw; ++i)
+                {
+                    for (int j = 0; j < nw; ++j)
+                    {
+                        HR_map[dR][iat * nw + i][jat * nw + j] += value(i, j, iR);
+                    }
+                }
+            }
+        }
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int iR = 0; iR < nR; ++iR)
+    {
+        Abfs::Vector3_Order<int> dR(iR - nR / 2, 0, 0);
+        auto& HR_csr_R = HR_csr[dR];
+        for (int iat = 0; iat < natom; ++iat)
+        {
+            for (int ad = 0; ad < nadj; ++ad)
+            {
+                const int jat = adj[iat * nadj + ad];
+                HR_csr_R.reserve(nw * nw);
+                for (int i = 0; i < nw; ++i)
+                {
+                    for (int j = 0; j < nw; ++j)
+                    {
+                        HR_csr_R.add(iat * nw + i, jat * nw + j, value(i, j, iR));
+                    }
+                }
+            }
+        }
+    }
+    hamilt::finalize_sparse_R(HR_csr, 0.0);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    size_t nnz_map = 0;
+    size_t nnz_csr = 0;
+    size_t memory_csr = 0;
+    for (auto& R_loop: HR_map)
+    {
+        for (auto& row_loop: R_loop.second)
+        {
+            nnz_map += row_loop.second.size();
+        }
+    }
+    for (auto& R_loop: HR_csr)
+    {
+        nnz_csr += R_loop.second.nnz();
+        memory_csr += R_loop.second.get_memory_size();
+        // check values
+        const auto& map_R = HR_map.at(R_loop.first);
+        const auto& csr_R = R_loop.second;
+        for (int ir = 0; ir < csr_R.nrows(); ++ir)
+        {
+            const auto& map_row = map_R.at(csr_R.rows()[ir]);
+            EXPECT_EQ(map_row.size(), csr_R.row_ptr()[ir + 1] - csr_R.row_ptr()[ir]);
+            for (int k = csr_R.row_ptr()[ir]; k < csr_R.row_ptr()[ir + 1]; ++k)
+            {
+                EXPECT_NEAR(map_row.at(csr_R.col_ind()[k]), csr_R.values()[k], 1e-12);
+            }
+        }
+    }
+    EXPECT_EQ(nnz_map, nnz_csr);
+
+    // a red-black tree node holds 3 pointers, a color flag and the key-value pair
+    const size_t memory_map = nnz_map * (4 * sizeof(void*) + sizeof(size_t) + sizeof(double));
+    std::cout << "nonzero elements: " << nnz_csr << std::endl;
+    std::cout << "build time of nested std::map: "
+              << std::chrono::duration_cast<std::chrono::duration<double>>(t1 - t0).count() << " s" << std::endl;
+    std::cout << "build time of SparseCSR: "
+              << std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count() << " s" << std::endl;
+    std::cout << "estimated memory of nested std::map: " << memory_map / 1024.0 / 1024.0 << " MB" << std::endl;
+    std::cout << "memory of SparseCSR: " << memory_csr / 1024.0 / 1024.0 << " MB" << std::endl;
+    EXPECT_LT(memory_csr, memory_map);
+}
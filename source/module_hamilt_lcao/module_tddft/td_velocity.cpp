@@ -177,10 +177,6 @@ void TD_Velocity::initialize_current_term(const hamilt::HContainer<std::complex<
 
 void TD_Velocity::destroy_HS_R_td_sparse(void)
 {
-    std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, std::complex<double>>>>
-        empty_HR_sparse_td_vel_up;
-    std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, std::complex<double>>>>
-        empty_HR_sparse_td_vel_down;
-    HR_sparse_td_vel[0].swap(empty_HR_sparse_td_vel_up);
-    HR_sparse_td_vel[1].swap(empty_HR_sparse_td_vel_down);
+    hamilt::SparseCSR_R<std::complex<double>>().swap(HR_sparse_td_vel[0]);
+    hamilt::SparseCSR_R<std::complex<double>>().swap(HR_sparse_td_vel[1]);
 }
@@ -3,6 +3,7 @@
 #include "module_base/abfs-vector3_order.h"
 #include "module_base/timer.h"
 #include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
+#include "module_hamilt_lcao/module_hcontainer/sparse_csr.h"
 
 #include <map>
 // Class to store TDDFT velocity gague infos.
@@ -50,7 +51,7 @@ class TD_Velocity
     }
 
     // For TDDFT velocity gague, to fix the output of HR
-    std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, std::complex<double>>>> HR_sparse_td_vel[2];
+    hamilt::SparseCSR_R<std::complex<double>> HR_sparse_td_vel[2];
 
   private:
     /// @brief read At from output file
@@ -2,6 +2,8 @@
 #include "module_base/timer.h"
 #include "module_base/tool_title.h"
 #include "module_hamilt_pw/hamilt_pwdft/fs_nonlocal_tools.h"
+#include "module_hamilt_pw/hamilt_pwdft/nonlocal_rs.h"
+#include "module_parameter/parameter.h"
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -25,6 +27,28 @@ void Forces<FPTYPE, Device>::cal_force_nl(ModuleBase::matrix& forcenl,
     }
     ModuleBase::timer::tick("Forces", "cal_force_nl");
 
+    // the energy comes from the real-space projectors applied in Veff, so do the forces
+    if (PARAM.inp.nl_realspace && PARAM.inp.vl_in_h && std::is_same<Device, base_device::DEVICE_CPU>::value)
+    {
+        hamilt::Nonlocal_RS nl_rs(&ucell_in,
+                                  &nlpp,
+                                  wfc_basis,
+                                  PARAM.inp.ecutwfc,
+                                  PARAM.inp.nl_realspace_radius,
+                                  PARAM.inp.nl_realspace_qratio,
+                                  true);
+        nl_rs.cal_force_stress(&psi_in[0](0, 0, 0),
+                               psi_in->get_nbands(),
+                               psi_in->get_nbasis(),
+                               wg,
+                               p_kv->isk,
+                               &forcenl,
+                               nullptr);
+        Parallel_Reduce::reduce_all(forcenl.c, forcenl.nr * forcenl.nc);
+        ModuleBase::timer::tick("Forces", "cal_force_nl");
+        return;
+    }
+
     // allocate memory for the force
     FPTYPE* force = nullptr;
     resmem_var_op()(force, ucell_in.nat * 3);
@@ -16,6 +16,8 @@
 #include "module_cell/module_paw/paw_cell.h"
 #endif
 
+#include <type_traits>
+
 namespace hamilt
 {
 
@@ -35,6 +37,8 @@ HamiltPW<T, Device>::HamiltPW(elecstate::Potential* pot_in,
     const auto tpiba = static_cast<Real>(ucell->tpiba);
     const int* isk = pkv->isk.data();
     const Real* gk2 = wfc_basis->get_gk2_data<Real>();
+    // kept to give it the real-space nonlocal projectors
+    Veff<OperatorPW<T, Device>>* veff_pw = nullptr;
 
     if (PARAM.inp.t_in_h)
     {
@@ -80,11 +84,12 @@ HamiltPW<T, Device>::HamiltPW(elecstate::Potential* pot_in,
         {
             //register Potential by gathered operator
             pot_in->pot_register(pot_register_in);
-            Operator<T, Device>* veff = new Veff<OperatorPW<T, Device>>(isk,
-                                                                        pot_in->get_veff_smooth_data<Real>(),
-                                                                        pot_in->get_veff_smooth().nr,
-                                                                        pot_in->get_veff_smooth().nc,
-                                                                        wfc_basis);
+            veff_pw = new Veff<OperatorPW<T, Device>>(isk,
+                                                      pot_in->get_veff_smooth_data<Real>(),
+                                                      pot_in->get_veff_smooth().nr,
+                                                      pot_in->get_veff_smooth().nc,
+                                                      wfc_basis);
+            Operator<T, Device>* veff = veff_pw;
             if(this->ops == nullptr)
             {
                 this->ops = veff;
@@ -104,8 +109,22 @@ HamiltPW<T, Device>::HamiltPW(elecstate::Potential* pot_in,
     }
     if (PARAM.inp.vnl_in_h)
     {
-        Operator<T, Device>* nonlocal
+        Nonlocal<OperatorPW<T, Device>>* nonlocal_pw
             = new Nonlocal<OperatorPW<T, Device>>(isk, this->ppcell, ucell, wfc_basis);
+        // the projectors are applied by Veff between its FFTs, only on CPU
+        if (PARAM.inp.nl_realspace && veff_pw != nullptr && this->ppcell->nkb > 0
+            && std::is_same<Device, base_device::DEVICE_CPU>::value)
+        {
+            Nonlocal_RS* nl_rs = new Nonlocal_RS(ucell,
+                                                 this->ppcell,
+                                                 wfc_basis,
+                                                 PARAM.inp.ecutwfc,
+                                                 PARAM.inp.nl_realspace_radius,
+                                                 PARAM.inp.nl_realspace_qratio);
+            nonlocal_pw->set_nonlocal_rs(nl_rs);
+            veff_pw->set_nonlocal_rs(nl_rs);
+        }
+        Operator<T, Device>* nonlocal = nonlocal_pw;
         if(this->ops == nullptr)
         {
             this->ops = nonlocal;
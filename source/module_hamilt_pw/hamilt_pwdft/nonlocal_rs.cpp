@@ -0,0 +1,617 @@
+#include "nonlocal_rs.h"
+
+#include "module_base/constants.h"
+#include "module_base/math_integral.h"
+#include "module_base/math_polyint.h"
+#include "module_base/math_sphbes.h"
+#include "module_base/math_ylmreal.h"
+#include "module_base/memory.h"
+#include "module_base/parallel_reduce.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace hamilt
+{
+
+namespace
+{
+// spacing of the q mesh and of the uniform r mesh of the filtered radial functions
+const double dq_filter = 0.01;
+const double dr_filter = 0.01;
+// number of bands on the real-space grid at a time in cal_force_stress()
+const int nbands_block = 16;
+} // namespace
+
+void Nonlocal_RS::filter_radial(const int l,
+                                const int mesh,
+                                const double* r,
+                                const double* rab,
+                                const double* betar,
+                                const double qc,
+                                const double qratio,
+                                const int nr,
+                                const double dr,
+                                double* f,
+                                double* df)
+{
+    // Simpson's rule needs an odd number of points
+    const int msh = (mesh % 2 == 0) ? mesh - 1 : mesh;
+    int nq = static_cast<int>(qratio * qc / dq_filter) + 1;
+    if (nq % 2 == 0)
+    {
+        ++nq;
+    }
+    const double dq = qratio * qc / (nq - 1);
+
+    // beta(q) times the mask
+    std::vector<double> bq(nq), qgrid(nq);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<double> jl(msh), aux(msh);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (int iq = 0; iq < nq; iq++)
+        {
+            const double q = iq * dq;
+            qgrid[iq] = q;
+            ModuleBase::Sphbes::Spherical_Bessel(msh, r, q, l, jl.data());
+            for (int ir = 0; ir < msh; ir++)
+            {
+                aux[ir] = betar[ir] * jl[ir] * r[ir];
+            }
+            double vqint = 0.0;
+            ModuleBase::Integral::Simpson_Integral(msh, aux.data(), rab, vqint);
+            double mask = 1.0;
+            if (q > qc)
+            {
+                const double c = std::cos(0.5 * ModuleBase::PI * (q - qc) / (qratio * qc - qc));
+                mask = c * c;
+            }
+            bq[iq] = vqint * mask;
+        }
+    }
+
+    // back to real space, df(r) = 2/pi * int q^3 beta(q) m(q) j_l'(qr) dq
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<double> jl(nq), aux(nq);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (int ir = 0; ir < nr; ir++)
+        {
+            ModuleBase::Sphbes::Spherical_Bessel(nq, qgrid.data(), ir * dr, l, jl.data());
+            for (int iq = 0; iq < nq; iq++)
+            {
+                aux[iq] = qgrid[iq] * qgrid[iq] * bq[iq] * jl[iq];
+            }
+            double fint = 0.0;
+            ModuleBase::Integral::Simpson_Integral(nq, aux.data(), dq, fint);
+            f[ir] = 2.0 / ModuleBase::PI * fint;
+            if (df == nullptr)
+            {
+                continue;
+            }
+            ModuleBase::Sphbes::dSpherical_Bessel_dx(nq, qgrid.data(), ir * dr, l, jl.data());
+            for (int iq = 0; iq < nq; iq++)
+            {
+                aux[iq] = qgrid[iq] * qgrid[iq] * qgrid[iq] * bq[iq] * jl[iq];
+            }
+            ModuleBase::Integral::Simpson_Integral(nq, aux.data(), dq, fint);
+            df[ir] = 2.0 / ModuleBase::PI * fint;
+        }
+    }
+}
+
+Nonlocal_RS::Nonlocal_RS(const UnitCell* ucell_in,
+                         const pseudopot_cell_vnl* ppcell_in,
+                         const ModulePW::PW_Basis_K* wfcpw_in,
+                         const double ecutwfc,
+                         const double radius,
+                         const double qratio,
+                         const bool cal_deri)
+{
+    ModuleBase::TITLE("Nonlocal_RS", "Nonlocal_RS");
+    ModuleBase::timer::tick("Nonlocal_RS", "Nonlocal_RS");
+    this->ucell = ucell_in;
+    this->ppcell = ppcell_in;
+    this->wfcpw = wfcpw_in;
+    this->nkb = this->ppcell->nkb;
+    this->omega = this->ucell->omega;
+    this->with_deri = cal_deri;
+
+    // filtered radial functions of each type on a uniform mesh up to rcut[it]
+    const double qc = std::sqrt(ecutwfc);
+    std::vector<double> rcut(ucell->ntype, 0.0);
+    std::vector<int> nr(ucell->ntype, 0);
+    std::vector<std::vector<std::vector<double>>> radial(ucell->ntype);
+    std::vector<std::vector<std::vector<double>>> dradial(ucell->ntype);
+    for (int it = 0; it < ucell->ntype; it++)
+    {
+        const Atom_pseudo& upf = ucell->atoms[it].ncpp;
+        if (upf.tvanp)
+        {
+            ModuleBase::WARNING_QUIT("Nonlocal_RS", "nl_realspace is only available for norm-conserving pseudopotentials");
+        }
+        const int kkbeta = upf.kkbeta;
+        if (upf.nbeta == 0 || kkbeta < 2)
+        {
+            continue;
+        }
+        rcut[it] = radius * upf.r[kkbeta - 1];
+        nr[it] = static_cast<int>(rcut[it] / dr_filter) + 4;
+        radial[it].resize(upf.nbeta);
+        dradial[it].resize(upf.nbeta);
+        for (int ib = 0; ib < upf.nbeta; ib++)
+        {
+            radial[it][ib].resize(nr[it]);
+            if (cal_deri)
+            {
+                dradial[it][ib].resize(nr[it]);
+            }
+            filter_radial(upf.lll[ib],
+                          kkbeta,
+                          upf.r.data(),
+                          upf.rab.data(),
+                          &upf.betar(ib, 0),
+                          qc,
+                          qratio,
+                          nr[it],
+                          dr_filter,
+                          radial[it][ib].data(),
+                          cal_deri ? dradial[it][ib].data() : nullptr);
+        }
+    }
+
+    // the grid points in the spheres, all the images of the atoms are searched
+    const ModuleBase::Vector3<double> a[3] = {ucell->a1, ucell->a2, ucell->a3};
+    const double volume = std::abs(a[0] * (a[1] ^ a[2]));
+    // number of lattice planes of the cell per Bohr along each lattice vector
+    const double inv_dist[3] = {(a[1] ^ a[2]).norm() / volume / ucell->lat0,
+                                (a[2] ^ a[0]).norm() / volume / ucell->lat0,
+                                (a[0] ^ a[1]).norm() / volume / ucell->lat0};
+    const int ngrid[3] = {wfcpw->nx, wfcpw->ny, wfcpw->nz};
+    const int nplane = wfcpw->nplane;
+    const int startz = wfcpw->startz_current;
+    const int lmax2 = (ppcell->lmaxkb + 1) * (ppcell->lmaxkb + 1);
+    // Ylm of the axes, r * Y_1m(r) is linear and its gradient at r = 0 is Y_1m(e_x, e_y, e_z)
+    const ModuleBase::Vector3<double> axes[3]
+        = {ModuleBase::Vector3<double>(1, 0, 0), ModuleBase::Vector3<double>(0, 1, 0), ModuleBase::Vector3<double>(0, 0, 1)};
+    ModuleBase::matrix ylm_axes(lmax2, 3);
+    ModuleBase::YlmReal::Ylm_Real(lmax2, 3, axes, ylm_axes);
+
+    this->spheres.resize(ucell->nat);
+    size_t nbytes = 0;
+    int iat = 0;
+    int ikb = 0;
+    for (int it = 0; it < ucell->ntype; it++)
+    {
+        const int nh = ucell->atoms[it].ncpp.nh;
+        for (int ia = 0; ia < ucell->atoms[it].na; ia++)
+        {
+            AtomSphere& sphere = this->spheres[iat];
+            sphere.it = it;
+            sphere.nh = nh;
+            sphere.ikb0 = ikb;
+            ikb += nh;
+            ++iat;
+            if (nh == 0 || nplane == 0)
+            {
+                continue;
+            }
+            const ModuleBase::Vector3<double> tau = ucell->atoms[it].tau[ia] * ucell->lat0;
+            sphere.tau = tau;
+            const ModuleBase::Vector3<double> taud = ucell->atoms[it].taud[ia];
+            int nmin[3], nmax[3];
+            for (int i = 0; i < 3; i++)
+            {
+                nmin[i] = static_cast<int>(std::floor((taud[i] - rcut[it] * inv_dist[i]) * ngrid[i]));
+                nmax[i] = static_cast<int>(std::ceil((taud[i] + rcut[it] * inv_dist[i]) * ngrid[i]));
+            }
+            const double rcut2 = rcut[it] * rcut[it];
+            for (int n0 = nmin[0]; n0 <= nmax[0]; n0++)
+            {
+                const int i0 = ((n0 % ngrid[0]) + ngrid[0]) % ngrid[0];
+                for (int n1 = nmin[1]; n1 <= nmax[1]; n1++)
+                {
+                    const int i1 = ((n1 % ngrid[1]) + ngrid[1]) % ngrid[1];
+                    for (int n2 = nmin[2]; n2 <= nmax[2]; n2++)
+                    {
+                        const int i2 = ((n2 % ngrid[2]) + ngrid[2]) % ngrid[2];
+                        if (i2 < startz || i2 >= startz + nplane)
+                        {
+                            continue;
+                        }
+                        const ModuleBase::Vector3<double> pos
+                            = (static_cast<double>(n0) / ngrid[0] * a[0] + static_cast<double>(n1) / ngrid[1] * a[1]
+                               + static_cast<double>(n2) / ngrid[2] * a[2])
+                              * ucell->lat0;
+                        if ((pos - tau).norm2() >= rcut2)
+                        {
+                            continue;
+                        }
+                        sphere.ir.push_back((i0 * ngrid[1] + i1) * nplane + i2 - startz);
+                        sphere.pos.push_back(pos);
+                    }
+                }
+            }
+
+            // beta_ih(r - tau - R) = f_l(|d|) * Ylm(d)
+            const int npoints = sphere.ir.size();
+            sphere.beta.assign(nh * npoints, 0.0);
+            if (npoints == 0)
+            {
+                continue;
+            }
+            std::vector<ModuleBase::Vector3<double>> d(npoints);
+            for (int ip = 0; ip < npoints; ip++)
+            {
+                d[ip] = sphere.pos[ip] - tau;
+            }
+            ModuleBase::matrix ylm(lmax2, npoints);
+            ModuleBase::YlmReal::Ylm_Real(lmax2, npoints, d.data(), ylm);
+            ModuleBase::matrix dylm[3];
+            if (cal_deri)
+            {
+                // grad beta = f'(|d|) Ylm(d) d/|d| + f(|d|) grad Ylm(d)
+                ModuleBase::matrix ylm_tmp(lmax2, npoints);
+                for (int i = 0; i < 3; i++)
+                {
+                    dylm[i].create(lmax2, npoints);
+                }
+                ModuleBase::YlmReal::grad_Ylm_Real(lmax2, npoints, d.data(), ylm_tmp, dylm[0], dylm[1], dylm[2]);
+                sphere.dbeta.assign(3 * nh * npoints, 0.0);
+            }
+            for (int ih = 0; ih < nh; ih++)
+            {
+                const int ib = static_cast<int>(ppcell->indv(it, ih));
+                const int lm = static_cast<int>(ppcell->nhtolm(it, ih));
+                const double* table = radial[it][ib].data();
+                for (int ip = 0; ip < npoints; ip++)
+                {
+                    const double fr = ModuleBase::PolyInt::Polynomial_Interpolation(table,
+                                                                                    nr[it],
+                                                                                    dr_filter,
+                                                                                    d[ip].norm());
+                    sphere.beta[ih * npoints + ip] = fr * ylm(lm, ip);
+                    if (!cal_deri)
+                    {
+                        continue;
+                    }
+                    const double dnorm = d[ip].norm();
+                    const double dfr = ModuleBase::PolyInt::Polynomial_Interpolation(dradial[it][ib].data(),
+                                                                                     nr[it],
+                                                                                     dr_filter,
+                                                                                     dnorm);
+                    for (int i = 0; i < 3; i++)
+                    {
+                        double grad = 0.0;
+                        if (dnorm > 1e-9)
+                        {
+                            grad = dfr * ylm(lm, ip) * d[ip][i] / dnorm + fr * dylm[i](lm, ip);
+                        }
+                        else if (ppcell->nhtol(it, ih) == 1)
+                        {
+                            grad = dfr * ylm_axes(lm, i);
+                        }
+                        sphere.dbeta[(i * nh + ih) * npoints + ip] = grad;
+                    }
+                }
+            }
+            sphere.phase.resize(npoints);
+            nbytes += npoints * (sizeof(int) + sizeof(ModuleBase::Vector3<double>) + sizeof(std::complex<double>)
+                                 + (cal_deri ? 4 : 1) * nh * sizeof(double));
+        }
+    }
+    ModuleBase::Memory::record("Nonlocal_RS::spheres", nbytes);
+    ModuleBase::timer::tick("Nonlocal_RS", "Nonlocal_RS");
+}
+
+size_t Nonlocal_RS::get_npoints() const
+{
+    size_t npoints = 0;
+    for (const AtomSphere& sphere: this->spheres)
+    {
+        npoints += sphere.ir.size();
+    }
+    return npoints;
+}
+
+void Nonlocal_RS::init(const int ik)
+{
+    if (ik == this->ik_now)
+    {
+        return;
+    }
+    this->ik_now = ik;
+    const ModuleBase::Vector3<double> kcar = this->wfcpw->kvec_c[ik] * this->ucell->tpiba;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int iat = 0; iat < static_cast<int>(this->spheres.size()); iat++)
+    {
+        AtomSphere& sphere = this->spheres[iat];
+        for (size_t ip = 0; ip < sphere.pos.size(); ip++)
+        {
+            const double arg = kcar * sphere.pos[ip];
+            sphere.phase[ip] = std::complex<double>(std::cos(arg), std::sin(arg));
+        }
+    }
+}
+
+template <typename FPTYPE>
+void Nonlocal_RS::cal_ps(const int nb, const int spin, const std::complex<FPTYPE>* psir, const int ldr) const
+{
+    ModuleBase::timer::tick("Nonlocal_RS", "cal_ps");
+    std::vector<std::complex<double>> becp(nb * this->nkb, std::complex<double>(0.0, 0.0));
+    const double fac = std::sqrt(this->omega) / this->wfcpw->nxyz;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<std::complex<double>> w;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int iat = 0; iat < static_cast<int>(this->spheres.size()); iat++)
+        {
+            const AtomSphere& sphere = this->spheres[iat];
+            const int npoints = sphere.ir.size();
+            w.resize(npoints);
+            for (int ib = 0; ib < nb; ib++)
+            {
+                const std::complex<FPTYPE>* psi_b = psir + ib * ldr;
+                for (int ip = 0; ip < npoints; ip++)
+                {
+                    const std::complex<FPTYPE> p = psi_b[sphere.ir[ip]];
+                    w[ip] = sphere.phase[ip] * std::complex<double>(p.real(), p.imag());
+                }
+                for (int ih = 0; ih < sphere.nh; ih++)
+                {
+                    const double* beta = &sphere.beta[ih * npoints];
+                    double re = 0.0;
+                    double im = 0.0;
+                    for (int ip = 0; ip < npoints; ip++)
+                    {
+                        re += beta[ip] * w[ip].real();
+                        im += beta[ip] * w[ip].imag();
+                    }
+                    becp[ib * this->nkb + sphere.ikb0 + ih] = fac * std::complex<double>(re, im);
+                }
+            }
+        }
+    }
+    // every process of the pool has a part of the grid
+    Parallel_Reduce::reduce_pool(becp.data(), nb * this->nkb);
+
+    this->ps.assign(nb * this->nkb, std::complex<double>(0.0, 0.0));
+    for (int iat = 0; iat < static_cast<int>(this->spheres.size()); iat++)
+    {
+        const AtomSphere& sphere = this->spheres[iat];
+        for (int ib = 0; ib < nb; ib++)
+        {
+            const std::complex<double>* becp_b = &becp[ib * this->nkb + sphere.ikb0];
+            std::complex<double>* ps_b = &this->ps[ib * this->nkb + sphere.ikb0];
+            for (int ih2 = 0; ih2 < sphere.nh; ih2++)
+            {
+                for (int ih = 0; ih < sphere.nh; ih++)
+                {
+                    ps_b[ih2] += this->ppcell->deeq(spin, iat, ih, ih2) * becp_b[ih];
+                }
+            }
+        }
+    }
+    ModuleBase::timer::tick("Nonlocal_RS", "cal_ps");
+}
+
+template <typename FPTYPE>
+void Nonlocal_RS::add_ps(const int nb, std::complex<FPTYPE>* hpsir, const int ldr) const
+{
+    ModuleBase::timer::tick("Nonlocal_RS", "add_ps");
+    const double fac = std::sqrt(this->omega);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int iat = 0; iat < static_cast<int>(this->spheres.size()); iat++)
+    {
+        const AtomSphere& sphere = this->spheres[iat];
+        const int npoints = sphere.ir.size();
+        for (int ib = 0; ib < nb; ib++)
+        {
+            const std::complex<double>* ps_b = &this->ps[ib * this->nkb + sphere.ikb0];
+            FPTYPE* h = reinterpret_cast<FPTYPE*>(hpsir + ib * ldr);
+            for (int ip = 0; ip < npoints; ip++)
+            {
+                std::complex<double> sum(0.0, 0.0);
+                for (int ih = 0; ih < sphere.nh; ih++)
+                {
+                    sum += sphere.beta[ih * npoints + ip] * ps_b[ih];
+                }
+                sum = fac * std::conj(sphere.phase[ip]) * sum;
+                // the spheres of different atoms may overlap
+                const int ir = sphere.ir[ip];
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+                h[2 * ir] += static_cast<FPTYPE>(sum.real());
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+                h[2 * ir + 1] += static_cast<FPTYPE>(sum.imag());
+            }
+        }
+    }
+    ModuleBase::timer::tick("Nonlocal_RS", "add_ps");
+}
+
+template <typename FPTYPE>
+void Nonlocal_RS::cal_force_stress(const std::complex<FPTYPE>* psi,
+                                   const int nbands,
+                                   const int ldpsi,
+                                   const ModuleBase::matrix& wg,
+                                   const std::vector<int>& isk,
+                                   ModuleBase::matrix* force,
+                                   ModuleBase::matrix* stress)
+{
+    ModuleBase::TITLE("Nonlocal_RS", "cal_force_stress");
+    if (force == nullptr && stress == nullptr)
+    {
+        return;
+    }
+    if (!this->with_deri)
+    {
+        ModuleBase::WARNING_QUIT("Nonlocal_RS", "the gradients of beta are not calculated, set cal_deri");
+    }
+    ModuleBase::timer::tick("Nonlocal_RS", "cal_force_stress");
+    const int nrxx = this->wfcpw->nrxx;
+    const double fac = std::sqrt(this->omega) / this->wfcpw->nxyz;
+    std::vector<std::complex<FPTYPE>> psir(std::min(nbands, nbands_block) * nrxx);
+    // dE/d(epsilon_ij)
+    std::vector<double> dedeps(9, 0.0);
+    for (int ik = 0; ik < this->wfcpw->nks; ik++)
+    {
+        // skip zero weights
+        int nbands_occ = std::min(nbands, wg.nc);
+        while (nbands_occ > 0 && wg(ik, nbands_occ - 1) == 0.0)
+        {
+            --nbands_occ;
+        }
+        this->init(ik);
+        for (int ib0 = 0; ib0 < nbands_occ; ib0 += nbands_block)
+        {
+            const int nb = std::min(nbands_block, nbands_occ - ib0);
+            for (int ib = 0; ib < nb; ib++)
+            {
+                this->wfcpw->recip2real(psi + (static_cast<size_t>(ik) * nbands + ib0 + ib) * ldpsi,
+                                        &psir[ib * nrxx],
+                                        ik);
+            }
+            this->cal_ps(nb, isk[ik], psir.data(), nrxx);
+            const double* wg_k = &wg(ik, ib0);
+
+            // with ps = D <beta|psi>, dE = sum_n wg_n 2 Re(ps^* d<beta|psi>), where
+            // d<beta|psi>/dtau_i = -fac * sum_r d_i beta(r - tau) psi(r) and
+            // d<beta|psi>/d(epsilon_ij) = <beta|psi>/2 delta_ij + fac * sum_r d_i beta(r - tau) (r - tau)_j psi(r)
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            {
+                std::vector<std::complex<double>> w;
+                std::vector<double> dedeps_thread(9, 0.0);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+                for (int iat = 0; iat < static_cast<int>(this->spheres.size()); iat++)
+                {
+                    const AtomSphere& sphere = this->spheres[iat];
+                    const int npoints = sphere.ir.size();
+                    if (npoints == 0)
+                    {
+                        continue;
+                    }
+                    w.resize(npoints);
+                    for (int ib = 0; ib < nb; ib++)
+                    {
+                        const std::complex<FPTYPE>* psi_b = &psir[ib * nrxx];
+                        for (int ip = 0; ip < npoints; ip++)
+                        {
+                            const std::complex<FPTYPE> p = psi_b[sphere.ir[ip]];
+                            w[ip] = sphere.phase[ip] * std::complex<double>(p.real(), p.imag());
+                        }
+                        for (int ih = 0; ih < sphere.nh; ih++)
+                        {
+                            const std::complex<double> c
+                                = wg_k[ib] * fac * std::conj(this->ps[ib * this->nkb + sphere.ikb0 + ih]);
+                            for (int i = 0; i < 3; i++)
+                            {
+                                const double* dbeta = &sphere.dbeta[(i * sphere.nh + ih) * npoints];
+                                std::complex<double> g(0.0, 0.0);
+                                std::complex<double> gd[3] = {g, g, g};
+                                for (int ip = 0; ip < npoints; ip++)
+                                {
+                                    const std::complex<double> dw = dbeta[ip] * w[ip];
+                                    g += dw;
+                                    if (stress != nullptr)
+                                    {
+                                        const ModuleBase::Vector3<double> d = sphere.pos[ip] - sphere.tau;
+                                        gd[0] += d.x * dw;
+                                        gd[1] += d.y * dw;
+                                        gd[2] += d.z * dw;
+                                    }
+                                }
+                                if (force != nullptr)
+                                {
+                                    (*force)(iat, i) += 2.0 * (c * g).real();
+                                }
+                                for (int j = 0; j < 3 && stress != nullptr; j++)
+                                {
+                                    dedeps_thread[i * 3 + j] += 2.0 * (c * gd[j]).real();
+                                }
+                            }
+                            if (stress != nullptr)
+                            {
+                                const double* beta = &sphere.beta[ih * npoints];
+                                std::complex<double> b(0.0, 0.0);
+                                for (int ip = 0; ip < npoints; ip++)
+                                {
+                                    b += beta[ip] * w[ip];
+                                }
+                                for (int i = 0; i < 3; i++)
+                                {
+                                    dedeps_thread[i * 4] += (c * b).real();
+                                }
+                            }
+                        }
+                    }
+                }
+#ifdef _OPENMP
+#pragma omp critical(nonlocal_rs_stress)
+#endif
+                for (int i = 0; i < 9; i++)
+                {
+                    dedeps[i] += dedeps_thread[i];
+                }
+            }
+        }
+    }
+    if (stress != nullptr)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            for (int j = 0; j < 3; j++)
+            {
+                (*stress)(i, j) -= dedeps[i * 3 + j] / this->omega;
+            }
+        }
+    }
+    ModuleBase::timer::tick("Nonlocal_RS", "cal_force_stress");
+}
+
+template void Nonlocal_RS::cal_ps<float>(const int, const int, const std::complex<float>*, const int) const;
+template void Nonlocal_RS::cal_ps<double>(const int, const int, const std::complex<double>*, const int) const;
+template void Nonlocal_RS::add_ps<float>(const int, std::complex<float>*, const int) const;
+template void Nonlocal_RS::add_ps<double>(const int, std::complex<double>*, const int) const;
+template void Nonlocal_RS::cal_force_stress<float>(const std::complex<float>*,
+                                                   const int,
+                                                   const int,
+                                                   const ModuleBase::matrix&,
+                                                   const std::vector<int>&,
+                                                   ModuleBase::matrix*,
+                                                   ModuleBase::matrix*);
+template void Nonlocal_RS::cal_force_stress<double>(const std::complex<double>*,
+                                                    const int,
+                                                    const int,
+                                                    const ModuleBase::matrix&,
+                                                    const std::vector<int>&,
+                                                    ModuleBase::matrix*,
+                                                    ModuleBase::matrix*);
+
+} // namespace hamilt
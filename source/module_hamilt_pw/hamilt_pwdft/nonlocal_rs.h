@@ -0,0 +1,158 @@
+#ifndef NONLOCAL_RS_H
+#define NONLOCAL_RS_H
+
+#include "module_base/vector3.h"
+#include "module_basis/module_pw/pw_basis_k.h"
+#include "module_cell/unitcell.h"
+#include "module_hamilt_pw/hamilt_pwdft/VNL_in_pw.h"
+
+#include <complex>
+#include <vector>
+
+namespace hamilt
+{
+
+/**
+ * @brief Nonlocal pseudopotential applied on the real-space FFT grid.
+ *
+ * Each beta function is kept only on the grid points within a sphere around its atom, so applying
+ * the projectors costs O(N_atoms * points_per_sphere * nbands) instead of O(N_atoms * npw * nbands)
+ * for the dense vkb. The wave functions are taken on the real-space grid inside Veff, between the
+ * FFTs that are done anyway for the local potential.
+ *
+ * With psi(r) = sum_G c(G) exp(iGr) on the grid of N points (the output of recip2real),
+ *      <beta|psi> = sqrt(omega)/N * sum_r beta(r-tau-R) exp(ik(r-R)) psi(r)
+ * where R is the lattice vector of the image of the atom near r, and
+ *      sum_ij |beta_i> D_ij <beta_j|psi>
+ * is added to the real-space data as sqrt(omega) * sum_r beta(r-tau-R) exp(-ik(r-R)) ps, the 1/N
+ * being done by real2recip.
+ *
+ * The sums over the grid are exact for beta functions band-limited well below the grid, so the radial
+ * functions are filtered first: they are kept up to q = sqrt(ecutwfc), cut smoothly to zero at
+ * q = qratio * sqrt(ecutwfc), and truncated in real space at radius * (cutoff radius of the beta).
+ * Larger radius and qratio are more accurate; qratio must stay below (grid period)/sqrt(ecutwfc) - 1
+ * to avoid aliasing, which is about 3 for ecutrho = 4 * ecutwfc.
+ *
+ * Forces and stress are the derivatives of the same energy, with the gradients of the filtered beta on the
+ * grid: moving an atom moves its sphere, and a strain moves the grid points with the cell while psi(r)
+ * on the grid and the fractional k point stay the same.
+ *
+ * Only norm-conserving pseudopotentials, nspin = 1/2 and CPU are supported.
+ */
+class Nonlocal_RS
+{
+  public:
+    Nonlocal_RS(const UnitCell* ucell_in,
+                const pseudopot_cell_vnl* ppcell_in,
+                const ModulePW::PW_Basis_K* wfcpw_in,
+                const double ecutwfc,
+                const double radius,
+                const double qratio,
+                const bool cal_deri = false);
+
+    /// set the phases exp(ik(r-R)) of the grid points for k point ik
+    void init(const int ik);
+
+    /**
+     * @brief calculate ps = D * <beta|psi> of nb bands, summed over the processes of the pool
+     *
+     * @param nb number of bands
+     * @param spin current spin, for deeq
+     * @param psir psi of the bands on the real-space grid of this process, band ib starts at psir + ib * ldr
+     * @param ldr leading dimension of psir
+     */
+    template <typename FPTYPE>
+    void cal_ps(const int nb, const int spin, const std::complex<FPTYPE>* psir, const int ldr) const;
+
+    /// add sum_i |beta_i> ps_i of the nb bands of the last cal_ps() to hpsir
+    template <typename FPTYPE>
+    void add_ps(const int nb, std::complex<FPTYPE>* hpsir, const int ldr) const;
+
+    /**
+     * @brief forces and stress of E = sum_nk wg_nk <psi_nk|V_NL|psi_nk> with the real-space projectors
+     *
+     * Only the grid points of this process are summed, the caller sums force and stress over all the processes.
+     * The object must be constructed with cal_deri = true.
+     *
+     * @param psi wave functions in G space, band ib of k point ik starts at psi + (ik * nbands + ib) * ldpsi
+     * @param nbands number of bands of psi
+     * @param ldpsi leading dimension of psi
+     * @param wg weights of the bands, nks x nbands
+     * @param isk spin of each k point
+     * @param force [out] force(iat, i) += -dE/dtau_i, not calculated if nullptr
+     * @param stress [out] stress(i, j) += -1/omega dE/d(epsilon_ij), not calculated if nullptr
+     */
+    template <typename FPTYPE>
+    void cal_force_stress(const std::complex<FPTYPE>* psi,
+                          const int nbands,
+                          const int ldpsi,
+                          const ModuleBase::matrix& wg,
+                          const std::vector<int>& isk,
+                          ModuleBase::matrix* force,
+                          ModuleBase::matrix* stress);
+
+    /// total number of grid points in the spheres of this process
+    size_t get_npoints() const;
+
+    /**
+     * @brief filter a radial beta function in reciprocal space
+     *
+     * f(r) = 2/pi * int q^2 beta(q) m(q) j_l(qr) dq, with beta(q) = int r^2 beta(r) j_l(qr) dr
+     * and the mask m(q) = 1 for q < qc, cos^2 from qc to qratio * qc, and 0 beyond.
+     *
+     * @param l angular momentum
+     * @param mesh number of points of the radial mesh
+     * @param r radial mesh
+     * @param rab derivative of the radial mesh
+     * @param betar r * beta(r)
+     * @param qc q below which beta(q) is kept
+     * @param qratio the mask goes to zero at qratio * qc
+     * @param nr number of points of the output
+     * @param dr spacing of the uniform output mesh
+     * @param f [out] the filtered beta(r) at ir * dr
+     * @param df [out] the derivative of f, not calculated if nullptr
+     */
+    static void filter_radial(const int l,
+                              const int mesh,
+                              const double* r,
+                              const double* rab,
+                              const double* betar,
+                              const double qc,
+                              const double qratio,
+                              const int nr,
+                              const double dr,
+                              double* f,
+                              double* df = nullptr);
+
+  private:
+    /// the grid points of this process in the sphere of one atom
+    struct AtomSphere
+    {
+        int it = 0;
+        int nh = 0;
+        int ikb0 = 0;                                 ///< index of the first beta of the atom
+        ModuleBase::Vector3<double> tau;              ///< position of the atom, in Bohr
+        std::vector<int> ir;                          ///< local index of the grid point
+        std::vector<ModuleBase::Vector3<double>> pos; ///< r - R, in Bohr
+        std::vector<double> beta;                     ///< beta_ih(r - tau - R), nh x npoints
+        std::vector<double> dbeta;                    ///< gradient of beta, 3 x nh x npoints, only with cal_deri
+        std::vector<std::complex<double>> phase;      ///< exp(ik(r-R))
+    };
+
+    std::vector<AtomSphere> spheres;
+
+    const UnitCell* ucell = nullptr;
+    const pseudopot_cell_vnl* ppcell = nullptr;
+    const ModulePW::PW_Basis_K* wfcpw = nullptr;
+
+    int nkb = 0;
+    int ik_now = -1;
+    bool with_deri = false; ///< whether dbeta is calculated
+    double omega = 0.0;
+
+    mutable std::vector<std::complex<double>> ps;
+};
+
+} // namespace hamilt
+
+#endif
@@ -5,6 +5,8 @@
 #include "module_hamilt_general/module_xc/xc_functional.h"
 #include "module_base/tool_quit.h"
 
+#include <algorithm>
+
 namespace hamilt {
 
 template<typename T, typename Device>
@@ -27,7 +29,8 @@ Meta<OperatorPW<T, Device>>::Meta(Real tpiba_in,
     this->vk_row = vk_row;
     this->vk_col = vk_col;
     this->wfcpw = wfcpw_in;
-    resmem_complex_op()(this->porter, this->wfcpw->nmaxgr, "Meta<PW>::porter");
+    this->fft_batch = std::max(1, this->wfcpw->fft_bundle.get_fft_batch<Real>());
+    resmem_complex_op()(this->porter, this->wfcpw->nmaxgr * this->fft_batch, "Meta<PW>::porter");
 
 }
 
@@ -62,23 +65,35 @@ void Meta<OperatorPW<T, Device>>::act(
     int max_npw = nbasis / npol;
     //npol == 2 case has not been considered
 
-    for (int ib = 0; ib < nbands; ++ib)
+    // bands are transformed in groups of fft_batch with the batched fft
+    const int nmaxgr = this->wfcpw->nmaxgr;
+    for (int ib0 = 0; ib0 < nbands; ib0 += this->fft_batch)
     {
+        const int nb = std::min(this->fft_batch, nbands - ib0);
         for (int j = 0; j < 3; j++)
         {
-            meta_op()(this->ctx, this->ik, j, ngk_ik, this->wfcpw->npwk_max, this->tpiba, wfcpw->get_gcar_data<Real>(), wfcpw->get_kvec_c_data<Real>(), tmpsi_in, this->porter);
-            wfcpw->recip_to_real(this->ctx, this->porter, this->porter, this->ik);
+            for (int ib = 0; ib < nb; ++ib)
+            {
+                meta_op()(this->ctx, this->ik, j, ngk_ik, this->wfcpw->npwk_max, this->tpiba, wfcpw->get_gcar_data<Real>(), wfcpw->get_kvec_c_data<Real>(), tmpsi_in + ib * max_npw, this->porter + ib * nmaxgr);
+            }
+            wfcpw->recip_to_real_batch(this->ctx, this->porter, this->porter, nb, nmaxgr, nmaxgr, this->ik);
 
             if(this->vk_col != 0) {
-                vector_mul_vector_op()(this->vk_col, this->porter, this->porter, this->vk + current_spin * this->vk_col);
+                for (int ib = 0; ib < nb; ++ib)
+                {
+                    vector_mul_vector_op()(this->vk_col, this->porter + ib * nmaxgr, this->porter + ib * nmaxgr, this->vk + current_spin * this->vk_col);
+                }
             }
 
-            wfcpw->real_to_recip(this->ctx, this->porter, this->porter, this->ik);
-            meta_op()(this->ctx, this->ik, j, ngk_ik, this->wfcpw->npwk_max, this->tpiba, wfcpw->get_gcar_data<Real>(), wfcpw->get_kvec_c_data<Real>(), this->porter, tmhpsi, true);
+            wfcpw->real_to_recip_batch(this->ctx, this->porter, this->porter, nb, nmaxgr, nmaxgr, this->ik);
+            for (int ib = 0; ib < nb; ++ib)
+            {
+                meta_op()(this->ctx, this->ik, j, ngk_ik, this->wfcpw->npwk_max, this->tpiba, wfcpw->get_gcar_data<Real>(), wfcpw->get_kvec_c_data<Real>(), this->porter + ib * nmaxgr, tmhpsi + ib * max_npw, true);
+            }
 
         } // x,y,z directions
-        tmhpsi += max_npw;
-        tmpsi_in += max_npw;
+        tmhpsi += max_npw * nb;
+        tmpsi_in += max_npw * nb;
     }
     ModuleBase::timer::tick("Operator", "MetaPW");
 }
@@ -79,6 +79,8 @@ class Meta<OperatorPW<T, Device>> : public OperatorPW<T, Device>
 
     Device* ctx = {};
     base_device::DEVICE_CPU* cpu_ctx = {};
+    // number of bands transformed together, porter holds fft_batch bands
+    int fft_batch = 1;
     T *porter = nullptr;
     using meta_op = meta_pw_op<Real, Device>;
     using vector_mul_vector_op = ModuleBase::vector_mul_vector_op<T, Device>;
@@ -37,6 +37,7 @@ template<typename T, typename Device>
 Nonlocal<OperatorPW<T, Device>>::~Nonlocal() {
     delmem_complex_op()(this->ps);
     delmem_complex_op()(this->becp);
+    delete this->nl_rs;
 }
 
 template<typename T, typename Device>
@@ -45,7 +46,11 @@ void Nonlocal<OperatorPW<T, Device>>::init(const int ik_in)
     ModuleBase::timer::tick("Nonlocal", "getvnl");
     this->ik = ik_in;
     // Calculate nonlocal pseudopotential vkb
-	if(this->ppcell->nkb > 0) //xiaohui add 2013-09-02. Attention...
+	if (this->nl_rs != nullptr)
+	{
+		this->nl_rs->init(this->ik);
+	}
+	else if(this->ppcell->nkb > 0) //xiaohui add 2013-09-02. Attention...
 	{
 		this->ppcell->getvnl(this->ctx, *this->ucell, this->ik, this->vkb);
 	}
@@ -221,7 +226,11 @@ void Nonlocal<OperatorPW<T, Device>>::act(
     {
         setmem_complex_op()(tmhpsi, 0, nbasis*nbands/npol);
     }
-    if(!PARAM.inp.use_paw)
+    if (this->nl_rs != nullptr)
+    {
+        // already done by Veff on the real-space grid
+    }
+    else if(!PARAM.inp.use_paw)
     {
         this->npw = ngk_ik;
         this->max_npw = nbasis / npol;
@@ -8,6 +8,7 @@
 #include "module_base/kernels/math_kernel_op.h"
 
 #include "module_hamilt_pw/hamilt_pwdft/VNL_in_pw.h"
+#include "module_hamilt_pw/hamilt_pwdft/nonlocal_rs.h"
 
 namespace hamilt {
 
@@ -58,6 +59,17 @@ class Nonlocal<OperatorPW<T, Device>> : public OperatorPW<T, Device>
         return this->becp;
     }
 
+    /// apply the projectors in real space inside Veff instead of here, the Nonlocal_RS is deleted with this operator
+    void set_nonlocal_rs(Nonlocal_RS* nl_rs_in)
+    {
+        delete this->nl_rs;
+        this->nl_rs = nl_rs_in;
+    }
+    const Nonlocal_RS* get_nonlocal_rs() const
+    {
+        return this->nl_rs;
+    }
+
   private:
     void add_nonlocal_pp(T *hpsi_in, const T *becp, const int m) const;
 
@@ -77,6 +89,8 @@ class Nonlocal<OperatorPW<T, Device>> : public OperatorPW<T, Device>
 
     const ModulePW::PW_Basis_K* wfcpw = nullptr;
 
+    Nonlocal_RS* nl_rs = nullptr;
+
     mutable T *ps = nullptr;
     mutable T *vkb = nullptr;
     mutable T *becp = nullptr;
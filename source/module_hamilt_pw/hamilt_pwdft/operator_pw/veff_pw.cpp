@@ -3,6 +3,8 @@
 #include "module_base/timer.h"
 #include "module_base/tool_quit.h"
 
+#include <algorithm>
+
 namespace hamilt {
 
 template<typename T, typename Device>
@@ -23,8 +25,9 @@ Veff<OperatorPW<T, Device>>::Veff(const int* isk_in,
     this->veff_row = veff_row;
     this->veff_col = veff_col;
     this->wfcpw = wfcpw_in;
-    resmem_complex_op()(this->porter, this->wfcpw->nmaxgr, "Veff<PW>::porter");
-    resmem_complex_op()(this->porter1, this->wfcpw->nmaxgr, "Veff<PW>::porter1");
+    this->fft_batch = std::max(1, this->wfcpw->fft_bundle.get_fft_batch<Real>());
+    resmem_complex_op()(this->porter, this->wfcpw->nmaxgr * this->fft_batch, "Veff<PW>::porter");
+    resmem_complex_op()(this->porter1, this->wfcpw->nmaxgr * this->fft_batch, "Veff<PW>::porter1");
 
 }
 
@@ -56,41 +59,45 @@ void Veff<OperatorPW<T, Device>>::act(
 #ifdef __DSP
     wfcpw->fft_bundle.resource_handler(1);
 #endif
-    // T *porter = new T[wfcpw->nmaxgr];
-    for (int ib = 0; ib < nbands; ib += npol)
+    // bands are transformed in groups of fft_batch with the batched fft,
+    // porter (and porter1 for the spin-down part) hold the real space data of one group
+    const int nmaxgr = wfcpw->nmaxgr;
+    const int nwfc = (nbands + npol - 1) / npol;
+    for (int iw = 0; iw < nwfc; iw += this->fft_batch)
     {
+        const int nb = std::min(this->fft_batch, nwfc - iw);
         if (npol == 1)
         {
-            // wfcpw->recip2real(tmpsi_in, porter, this->ik);
-            wfcpw->recip_to_real(this->ctx, tmpsi_in, this->porter, this->ik);
+            wfcpw->recip_to_real_batch(this->ctx, tmpsi_in, this->porter, nb, nbasis, nmaxgr, this->ik);
+            // <beta|psi> are summed over the pool, so every process takes part even without grid points
+            if (this->nl_rs != nullptr)
+            {
+                this->nl_rs->cal_ps(nb, current_spin, this->porter, nmaxgr);
+            }
             // NOTICE: when MPI threads are larger than number of Z grids
             // veff would contain nothing, and nothing should be done in real space
             // but the 3DFFT can not be skipped, it will cause hanging
             if(this->veff_col != 0)
             {
-                veff_op()(this->ctx, this->veff_col, this->porter, this->veff + current_spin * this->veff_col);
-                // const Real* current_veff = &(this->veff[0](current_spin, 0));
-                // for (int ir = 0; ir < this->veff->nc; ++ir)
-                // {
-                //     porter[ir] *= current_veff[ir];
-                // }
+                for (int ib = 0; ib < nb; ++ib)
+                {
+                    veff_op()(this->ctx,
+                              this->veff_col,
+                              this->porter + ib * nmaxgr,
+                              this->veff + current_spin * this->veff_col);
+                }
             }
-            // wfcpw->real2recip(porter, tmhpsi, this->ik, true);
-            wfcpw->real_to_recip(this->ctx, this->porter, tmhpsi, this->ik, true);
-            // wfcpw->convolution(this->ctx,
-            // this->ik,
-            // this->veff_col,
-            // tmpsi_in,
-            // this->veff+current_spin,
-            // tmhpsi,
-            // true);
+            if (this->nl_rs != nullptr)
+            {
+                this->nl_rs->add_ps(nb, this->porter, nmaxgr);
+            }
+            wfcpw->real_to_recip_batch(this->ctx, this->porter, tmhpsi, nb, nmaxgr, nbasis, this->ik, true);
         }
         else
         {
-            // T *porter1 = new T[wfcpw->nmaxgr];
             // fft to real space and doing things.
-            wfcpw->recip_to_real(this->ctx, tmpsi_in, this->porter, this->ik);
-            wfcpw->recip_to_real(this->ctx, tmpsi_in + max_npw, this->porter1, this->ik);
+            wfcpw->recip_to_real_batch(this->ctx, tmpsi_in, this->porter, nb, nbasis, nmaxgr, this->ik);
+            wfcpw->recip_to_real_batch(this->ctx, tmpsi_in + max_npw, this->porter1, nb, nbasis, nmaxgr, this->ik);
             if(this->veff_col != 0)
             {
                 /// denghui added at 20221109
@@ -98,27 +105,21 @@ void Veff<OperatorPW<T, Device>>::act(
                 for(int is = 0; is < 4; is++) {
                     current_veff[is] = this->veff + is * this->veff_col ; // for CPU device
                 }
-                veff_op()(this->ctx, this->veff_col, this->porter, this->porter1, current_veff);
-                // T sup, sdown;
-                // for (int ir = 0; ir < this->veff_col; ir++) {
-                //     sup = this->porter[ir] * (current_veff[0][ir] + current_veff[3][ir])
-                //         + this->porter1[ir]
-                //                 * (current_veff[1][ir]
-                //                 - T(0.0, 1.0) * current_veff[2][ir]);
-                //     sdown = this->porter1[ir] * (current_veff[0][ir] - current_veff[3][ir])
-                //             + this->porter[ir]
-                //                 * (current_veff[1][ir]
-                //                     + T(0.0, 1.0) * current_veff[2][ir]);
-                //     this->porter[ir] = sup;
-                //     this->porter1[ir] = sdown;
-                // }
+                for (int ib = 0; ib < nb; ++ib)
+                {
+                    veff_op()(this->ctx,
+                              this->veff_col,
+                              this->porter + ib * nmaxgr,
+                              this->porter1 + ib * nmaxgr,
+                              current_veff);
+                }
             }
             // (3) fft back to G space.
-            wfcpw->real_to_recip(this->ctx, this->porter, tmhpsi, this->ik, true);
-            wfcpw->real_to_recip(this->ctx, this->porter1, tmhpsi + max_npw, this->ik, true);
+            wfcpw->real_to_recip_batch(this->ctx, this->porter, tmhpsi, nb, nmaxgr, nbasis, this->ik, true);
+            wfcpw->real_to_recip_batch(this->ctx, this->porter1, tmhpsi + max_npw, nb, nmaxgr, nbasis, this->ik, true);
         }
-        tmhpsi += max_npw * npol;
-        tmpsi_in += max_npw * npol;
+        tmhpsi += nbasis * nb;
+        tmpsi_in += nbasis * nb;
     }
 #ifdef __DSP
     wfcpw->fft_bundle.resource_handler(0);
@@ -136,8 +137,9 @@ hamilt::Veff<OperatorPW<T, Device>>::Veff(const Veff<OperatorPW<T_in, Device_in>
     this->veff_col = veff->get_veff_col();
     this->veff_row = veff->get_veff_row();
     this->wfcpw = veff->get_wfcpw();
-    resmem_complex_op()(this->porter, this->wfcpw->nmaxgr);
-    resmem_complex_op()(this->porter1, this->wfcpw->nmaxgr);
+    this->fft_batch = std::max(1, this->wfcpw->fft_bundle.get_fft_batch<Real>());
+    resmem_complex_op()(this->porter, this->wfcpw->nmaxgr * this->fft_batch);
+    resmem_complex_op()(this->porter1, this->wfcpw->nmaxgr * this->fft_batch);
     this->veff = veff->get_veff();
     if (this->isk == nullptr || this->veff == nullptr || this->wfcpw == nullptr) {
         ModuleBase::WARNING_QUIT("VeffPW", "Constuctor of Operator::VeffPW is failed, please check your code!");
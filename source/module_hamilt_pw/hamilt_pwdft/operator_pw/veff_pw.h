@@ -5,6 +5,7 @@
 #include "module_base/matrix.h"
 #include "module_basis/module_pw/pw_basis_k.h"
 #include "module_hamilt_pw/hamilt_pwdft/kernels/veff_op.h"
+#include "module_hamilt_pw/hamilt_pwdft/nonlocal_rs.h"
 
 #include <module_base/macros.h>
 
@@ -54,18 +55,29 @@ class Veff<OperatorPW<T, Device>> : public OperatorPW<T, Device>
         return this->wfcpw;
     }
 
+    /// apply also the real-space nonlocal projectors of nl_rs_in to the bands in real space, npol = 1 only
+    void set_nonlocal_rs(const Nonlocal_RS* nl_rs_in)
+    {
+        this->nl_rs = nl_rs_in;
+    }
+
   private:
 
     const int* isk = nullptr;
 
     const ModulePW::PW_Basis_K* wfcpw = nullptr;
 
+    // owned by the Nonlocal operator
+    const Nonlocal_RS* nl_rs = nullptr;
+
     Device* ctx = {};
     base_device::DEVICE_CPU* cpu_ctx = {};
 
     int veff_col = 0;
     int veff_row = 0;
     const Real *veff = nullptr, *h_veff = nullptr, *d_veff = nullptr;
+    // number of bands transformed together, porter and porter1 hold fft_batch bands
+    int fft_batch = 1;
     T *porter = nullptr;
     T *porter1 = nullptr;
     base_device::AbacusDevice_t device = {};
@@ -7,6 +7,7 @@
 #include "module_hamilt_pw/hamilt_pwdft/fs_nonlocal_tools.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 #include "module_hamilt_pw/hamilt_pwdft/nonlocal_maths.hpp"
+#include "module_hamilt_pw/hamilt_pwdft/nonlocal_rs.h"
 #include "stress_func.h"
 // calculate the nonlocal pseudopotential stress in PW
 template <typename FPTYPE, typename Device>
@@ -29,6 +30,33 @@ void Stress_Func<FPTYPE, Device>::stress_nl(ModuleBase::matrix& sigma,
     }
     ModuleBase::timer::tick("Stress", "stress_nl");
 
+    // the energy comes from the real-space projectors applied in Veff, so does the stress
+    if (PARAM.inp.nl_realspace && PARAM.inp.vl_in_h && std::is_same<Device, base_device::DEVICE_CPU>::value)
+    {
+        hamilt::Nonlocal_RS nl_rs(&ucell_in,
+                                  &nlpp_in,
+                                  wfc_basis,
+                                  PARAM.inp.ecutwfc,
+                                  PARAM.inp.nl_realspace_radius,
+                                  PARAM.inp.nl_realspace_qratio,
+                                  true);
+        sigma.zero_out();
+        nl_rs.cal_force_stress(&psi_in[0](0, 0, 0),
+                               psi_in->get_nbands(),
+                               psi_in->get_nbasis(),
+                               wg,
+                               p_kv->isk,
+                               nullptr,
+                               &sigma);
+        Parallel_Reduce::reduce_all(sigma.c, 9);
+        if (ModuleSymmetry::Symmetry::symm_flag == 1)
+        {
+            p_symm->symmetrize_mat3(sigma, ucell_in.lat);
+        }
+        ModuleBase::timer::tick("Stress", "stress_nl");
+        return;
+    }
+
     FPTYPE* stress_device = nullptr;
     resmem_var_op()(stress_device, 9);
     setmem_var_op()(stress_device, 0, 9);
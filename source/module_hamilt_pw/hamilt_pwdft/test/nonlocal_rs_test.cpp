@@ -0,0 +1,539 @@
+#include <gtest/gtest.h>
+
+#define private public
+#include "module_hamilt_pw/hamilt_pwdft/nonlocal_rs.h"
+#undef private
+
+#include "module_base/constants.h"
+#include "module_base/math_integral.h"
+#include "module_base/math_sphbes.h"
+#include "module_base/math_ylmreal.h"
+#include "module_base/parallel_comm.h"
+#include "module_elecstate/magnetism.h"
+
+#include <cmath>
+#include <vector>
+
+#ifdef __MPI
+#include <mpi.h>
+#endif
+
+/**
+ * Tests of the real-space projectors, with beta(r) = r^l exp(-r^2/2), whose transform is
+ * beta(q) = int r^2 beta(r) j_l(qr) dr = sqrt(pi/2) q^l exp(-q^2/2).
+ * - filter_radial() keeps the components of beta below qc and cuts the others
+ * - cal_ps() and add_ps() on the real-space grid give the same D<beta|psi> and
+ *   sum |beta> D <beta|psi> as the G-space projectors of pseudopot_cell_vnl::getvnl(),
+ *   vkb(k+G) = (-i)^l 4pi/sqrt(omega) beta_l(|k+G|) Ylm(k+G) exp(-i(k+G)tau),
+ *   within 1e-6 of the largest value
+ * - cal_force_stress() gives the derivatives of E = sum_n wg_n <psi_n|V_NL|psi_n> of cal_ps() against the
+ *   finite differences of E when an atom is moved or the cell is strained with psi(r) on the grid kept
+ */
+
+// mock of the constructors of the unitcell and the pseudopotentials
+pseudo::pseudo()
+{
+}
+pseudo::~pseudo()
+{
+}
+Atom_pseudo::Atom_pseudo()
+{
+}
+Atom_pseudo::~Atom_pseudo()
+{
+}
+Atom::Atom()
+{
+}
+Atom::~Atom()
+{
+}
+Magnetism::Magnetism()
+{
+}
+Magnetism::~Magnetism()
+{
+}
+UnitCell::UnitCell()
+{
+}
+UnitCell::~UnitCell()
+{
+}
+pseudopot_cell_vnl::pseudopot_cell_vnl()
+{
+}
+pseudopot_cell_vnl::~pseudopot_cell_vnl()
+{
+}
+Soc::~Soc()
+{
+}
+Fcoef::~Fcoef()
+{
+}
+class NonlocalRSTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // logarithmic mesh as in the pseudopotential files
+        mesh = 1201;
+        r.resize(mesh);
+        rab.resize(mesh);
+        const double xmin = -7.0;
+        const double dx = 0.0125;
+        for (int ir = 0; ir < mesh; ir++)
+        {
+            r[ir] = std::exp(xmin + ir * dx);
+            rab[ir] = r[ir] * dx;
+        }
+    }
+
+    void set_beta(const int l)
+    {
+        betar.resize(mesh);
+        for (int ir = 0; ir < mesh; ir++)
+        {
+            betar[ir] = std::pow(r[ir], l + 1) * std::exp(-0.5 * r[ir] * r[ir]);
+        }
+    }
+
+    // transform of f on the uniform mesh
+    double transform(const int l, const std::vector<double>& f, const double dr, const double q) const
+    {
+        const int nr = f.size();
+        std::vector<double> rr(nr), jl(nr), aux(nr);
+        for (int ir = 0; ir < nr; ir++)
+        {
+            rr[ir] = ir * dr;
+        }
+        ModuleBase::Sphbes::Spherical_Bessel(nr, rr.data(), q, l, jl.data());
+        for (int ir = 0; ir < nr; ir++)
+        {
+            aux[ir] = rr[ir] * rr[ir] * f[ir] * jl[ir];
+        }
+        double sum = 0.0;
+        ModuleBase::Integral::Simpson_Integral(nr, aux.data(), dr, sum);
+        return sum;
+    }
+
+    int mesh = 0;
+    std::vector<double> r;
+    std::vector<double> rab;
+    std::vector<double> betar;
+};
+
+TEST_F(NonlocalRSTest, KeepsBandLimitedBeta)
+{
+    // beta(q) vanishes long before qc, so the filtered function is beta itself
+    const double dr = 0.01;
+    const int nr = 601;
+    std::vector<double> f(nr);
+    for (int l = 0; l <= 2; l++)
+    {
+        set_beta(l);
+        hamilt::Nonlocal_RS::filter_radial(l, mesh, r.data(), rab.data(), betar.data(), 12.0, 2.0, nr, dr, f.data());
+        for (int ir = 0; ir < nr; ir += 20)
+        {
+            const double x = ir * dr;
+            EXPECT_NEAR(f[ir], std::pow(x, l) * std::exp(-0.5 * x * x), 1e-6) << "l = " << l << " r = " << x;
+        }
+    }
+}
+
+TEST_F(NonlocalRSTest, KeepsBetaBelowQc)
+{
+    // a cut in the middle of beta(q): the components below qc are kept and the tail is smooth
+    const double qc = 2.5;
+    const double qratio = 2.0;
+    const double dr = 0.01;
+    const int nr = 2001;
+    std::vector<double> f(nr);
+    for (int l = 0; l <= 2; l++)
+    {
+        set_beta(l);
+        hamilt::Nonlocal_RS::filter_radial(l, mesh, r.data(), rab.data(), betar.data(), qc, qratio, nr, dr, f.data());
+        for (double q = 0.25; q < qc; q += 0.25)
+        {
+            const double ref = std::sqrt(0.5 * M_PI) * std::pow(q, l) * std::exp(-0.5 * q * q);
+            EXPECT_NEAR(transform(l, f, dr, q), ref, 1e-4) << "l = " << l << " q = " << q;
+        }
+        // nothing beyond qratio * qc
+        EXPECT_NEAR(transform(l, f, dr, 1.2 * qratio * qc), 0.0, 1e-4) << "l = " << l;
+        // the tail decays, most of beta is within 3 Bohr
+        double tail = 0.0;
+        for (int ir = 600; ir < nr; ir++)
+        {
+            tail = std::max(tail, std::abs(f[ir]));
+        }
+        EXPECT_LT(tail, 1e-2) << "l = " << l;
+    }
+}
+
+class NonlocalRSVkbTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // a cubic cell of 10 Bohr with two atoms, each with one s and one p projector
+        const double lat0 = 10.0;
+        const ModuleBase::Matrix3 latvec(1, 0, 0, 0, 1, 0, 0, 0, 1);
+        ucell.lat0 = lat0;
+        ucell.tpiba = ModuleBase::TWO_PI / lat0;
+        ucell.omega = lat0 * lat0 * lat0;
+        ucell.a1 = ModuleBase::Vector3<double>(1, 0, 0);
+        ucell.a2 = ModuleBase::Vector3<double>(0, 1, 0);
+        ucell.a3 = ModuleBase::Vector3<double>(0, 0, 1);
+        ucell.ntype = 1;
+        ucell.nat = 2;
+        ucell.atoms = new Atom[1];
+        Atom& atom = ucell.atoms[0];
+        atom.na = 2;
+        atom.taud = {ModuleBase::Vector3<double>(0.1, 0.2, 0.3), ModuleBase::Vector3<double>(0.63, 0.55, 0.91)};
+        atom.tau = atom.taud;
+
+        Atom_pseudo& upf = atom.ncpp;
+        const int mesh = 1201;
+        upf.tvanp = false;
+        upf.nbeta = 2;
+        upf.lll = {0, 1};
+        upf.r.resize(mesh);
+        upf.rab.resize(mesh);
+        for (int ir = 0; ir < mesh; ir++)
+        {
+            upf.r[ir] = std::exp(-7.0 + ir * 0.0125);
+            upf.rab[ir] = upf.r[ir] * 0.0125;
+        }
+        // beta is below 1e-7 beyond 6 Bohr
+        upf.kkbeta = 1;
+        while (upf.r[upf.kkbeta - 1] < 6.0)
+        {
+            ++upf.kkbeta;
+        }
+        upf.betar.create(2, mesh);
+        for (int ib = 0; ib < 2; ib++)
+        {
+            for (int ir = 0; ir < mesh; ir++)
+            {
+                upf.betar(ib, ir) = std::pow(upf.r[ir], upf.lll[ib] + 1) * std::exp(-0.5 * upf.r[ir] * upf.r[ir]);
+            }
+        }
+        upf.nh = 4;
+
+        ppcell.nkb = 8;
+        ppcell.lmaxkb = 1;
+        ppcell.indv.create(1, 4);
+        ppcell.nhtol.create(1, 4);
+        ppcell.nhtolm.create(1, 4);
+        for (int ih = 0; ih < 4; ih++)
+        {
+            ppcell.indv(0, ih) = (ih == 0) ? 0 : 1;
+            ppcell.nhtol(0, ih) = (ih == 0) ? 0 : 1;
+            ppcell.nhtolm(0, ih) = ih;
+        }
+        ppcell.deeq.create(1, 2, 4, 4);
+        for (int iat = 0; iat < 2; iat++)
+        {
+            ppcell.deeq(0, iat, 0, 0) = 1.5 + iat;
+            for (int ih = 1; ih < 4; ih++)
+            {
+                ppcell.deeq(0, iat, ih, ih) = -0.7;
+            }
+        }
+
+        // beta(q) is below 1e-6 at q = sqrt(ecutwfc), so the filter does not change it
+        const ModuleBase::Vector3<double> kvec_d(0.1, -0.2, 0.3);
+#ifdef __MPI
+        wfcpw.initmpi(1, 0, MPI_COMM_SELF);
+#endif
+        wfcpw.initgrids(lat0, latvec, 4 * ecutwfc);
+        wfcpw.initparameters(false, ecutwfc, 1, &kvec_d);
+        wfcpw.setuptransform();
+        wfcpw.collect_local_pw();
+    }
+
+    void TearDown() override
+    {
+        delete[] ucell.atoms;
+    }
+
+    // the G-space projectors as in pseudopot_cell_vnl::getvnl(), with the analytic beta(q)
+    std::vector<std::complex<double>> get_vkb() const
+    {
+        const int npw = wfcpw.npwk[0];
+        std::vector<ModuleBase::Vector3<double>> gk(npw);
+        for (int ig = 0; ig < npw; ig++)
+        {
+            gk[ig] = wfcpw.getgpluskcar(0, ig);
+        }
+        ModuleBase::matrix ylm(4, npw);
+        ModuleBase::YlmReal::Ylm_Real(4, npw, gk.data(), ylm);
+        std::vector<std::complex<double>> vkb(ppcell.nkb * npw);
+        for (int iat = 0; iat < 2; iat++)
+        {
+            const ModuleBase::Vector3<double>& tau = ucell.atoms[0].tau[iat];
+            for (int ih = 0; ih < 4; ih++)
+            {
+                const int l = ppcell.nhtol(0, ih);
+                const std::complex<double> pref = std::pow(ModuleBase::NEG_IMAG_UNIT, l) * ModuleBase::FOUR_PI
+                                                  / std::sqrt(ucell.omega);
+                for (int ig = 0; ig < npw; ig++)
+                {
+                    const double q = gk[ig].norm() * ucell.tpiba;
+                    const double betaq = std::sqrt(0.5 * ModuleBase::PI) * std::pow(q, l) * std::exp(-0.5 * q * q);
+                    const double arg = -ModuleBase::TWO_PI * (gk[ig] * tau);
+                    vkb[(iat * 4 + ih) * npw + ig]
+                        = pref * betaq * ylm(ih, ig) * std::complex<double>(std::cos(arg), std::sin(arg));
+                }
+            }
+        }
+        return vkb;
+    }
+
+    // E = sum_n wg_n sum_ij <psi_n|beta_i> D_ij <beta_j|psi_n>, with the diagonal D of SetUp
+    double energy(const ModulePW::PW_Basis_K& pw, const std::vector<double>& wg,
+                  const std::vector<std::complex<double>>& psir) const
+    {
+        const int nb = wg.size();
+        hamilt::Nonlocal_RS nl_rs(&ucell, &ppcell, &pw, ecutwfc, 1.0, 2.0);
+        nl_rs.init(0);
+        nl_rs.cal_ps(nb, 0, psir.data(), pw.nrxx);
+        double e = 0.0;
+        for (int ib = 0; ib < nb; ib++)
+        {
+            for (int iat = 0; iat < 2; iat++)
+            {
+                for (int ih = 0; ih < 4; ih++)
+                {
+                    e += wg[ib] * std::norm(nl_rs.ps[ib * ppcell.nkb + iat * 4 + ih]) / ppcell.deeq(0, iat, ih, ih);
+                }
+            }
+        }
+        return e;
+    }
+
+    const double ecutwfc = 30.0;
+    UnitCell ucell;
+    pseudopot_cell_vnl ppcell;
+    ModulePW::PW_Basis_K wfcpw;
+};
+
+TEST_F(NonlocalRSVkbTest, CalPsAddPs)
+{
+    const int nb = 2;
+    const int npw = wfcpw.npwk[0];
+    const int nrxx = wfcpw.nrxx;
+    const int nkb = ppcell.nkb;
+    const std::vector<std::complex<double>> vkb = this->get_vkb();
+
+    // smooth wave functions
+    std::vector<std::complex<double>> psi(nb * npw);
+    for (int ib = 0; ib < nb; ib++)
+    {
+        for (int ig = 0; ig < npw; ig++)
+        {
+            const double g2 = wfcpw.getgpluskcar(0, ig).norm2() * ucell.tpiba * ucell.tpiba;
+            psi[ib * npw + ig] = std::complex<double>(std::cos(0.3 * ig + ib), std::sin(0.7 * ig - ib)) / (1.0 + g2);
+        }
+    }
+
+    // G space: ps = D <beta|psi> and hpsi = sum |beta> ps
+    std::vector<std::complex<double>> ps_ref(nb * nkb, 0.0);
+    std::vector<std::complex<double>> hpsi_ref(nb * npw, 0.0);
+    for (int ib = 0; ib < nb; ib++)
+    {
+        std::vector<std::complex<double>> becp(nkb, 0.0);
+        for (int ikb = 0; ikb < nkb; ikb++)
+        {
+            for (int ig = 0; ig < npw; ig++)
+            {
+                becp[ikb] += std::conj(vkb[ikb * npw + ig]) * psi[ib * npw + ig];
+            }
+        }
+        for (int iat = 0; iat < 2; iat++)
+        {
+            for (int ih2 = 0; ih2 < 4; ih2++)
+            {
+                for (int ih = 0; ih < 4; ih++)
+                {
+                    ps_ref[ib * nkb + iat * 4 + ih2] += ppcell.deeq(0, iat, ih, ih2) * becp[iat * 4 + ih];
+                }
+            }
+        }
+        for (int ikb = 0; ikb < nkb; ikb++)
+        {
+            for (int ig = 0; ig < npw; ig++)
+            {
+                hpsi_ref[ib * npw + ig] += vkb[ikb * npw + ig] * ps_ref[ib * nkb + ikb];
+            }
+        }
+    }
+
+    // real space
+    hamilt::Nonlocal_RS nl_rs(&ucell, &ppcell, &wfcpw, ecutwfc, 1.0, 2.0);
+    nl_rs.init(0);
+    EXPECT_GT(nl_rs.get_npoints(), 0);
+    std::vector<std::complex<double>> psir(nb * nrxx);
+    for (int ib = 0; ib < nb; ib++)
+    {
+        wfcpw.recip2real(&psi[ib * npw], &psir[ib * nrxx], 0);
+    }
+    nl_rs.cal_ps(nb, 0, psir.data(), nrxx);
+    std::vector<std::complex<double>> hpsir(nb * nrxx, 0.0);
+    nl_rs.add_ps(nb, hpsir.data(), nrxx);
+    std::vector<std::complex<double>> hpsi(nb * npw);
+    for (int ib = 0; ib < nb; ib++)
+    {
+        wfcpw.real2recip(&hpsir[ib * nrxx], &hpsi[ib * npw], 0);
+    }
+
+    double ps_max = 0.0;
+    double hpsi_max = 0.0;
+    for (const std::complex<double>& v: ps_ref)
+    {
+        ps_max = std::max(ps_max, std::abs(v));
+    }
+    for (const std::complex<double>& v: hpsi_ref)
+    {
+        hpsi_max = std::max(hpsi_max, std::abs(v));
+    }
+    ASSERT_GT(ps_max, 1e-3);
+    ASSERT_GT(hpsi_max, 1e-3);
+    for (int i = 0; i < nb * nkb; i++)
+    {
+        EXPECT_NEAR(std::abs(nl_rs.ps[i] - ps_ref[i]), 0.0, 1e-6 * ps_max) << "ps " << i;
+    }
+    for (int i = 0; i < nb * npw; i++)
+    {
+        EXPECT_NEAR(std::abs(hpsi[i] - hpsi_ref[i]), 0.0, 1e-6 * hpsi_max) << "hpsi " << i;
+    }
+}
+
+TEST_F(NonlocalRSVkbTest, ForceStressFiniteDifference)
+{
+    const int nb = 2;
+    const int npw = wfcpw.npwk[0];
+    const int nrxx = wfcpw.nrxx;
+    std::vector<std::complex<double>> psi(nb * npw);
+    for (int ib = 0; ib < nb; ib++)
+    {
+        for (int ig = 0; ig < npw; ig++)
+        {
+            const double g2 = wfcpw.getgpluskcar(0, ig).norm2() * ucell.tpiba * ucell.tpiba;
+            psi[ib * npw + ig] = std::complex<double>(std::cos(0.3 * ig + ib), std::sin(0.7 * ig - ib)) / (1.0 + g2);
+        }
+    }
+    std::vector<std::complex<double>> psir(nb * nrxx);
+    for (int ib = 0; ib < nb; ib++)
+    {
+        wfcpw.recip2real(&psi[ib * npw], &psir[ib * nrxx], 0);
+    }
+    const std::vector<double> wg = {0.7, 0.3};
+    ModuleBase::matrix wg_mat(1, nb);
+    for (int ib = 0; ib < nb; ib++)
+    {
+        wg_mat(0, ib) = wg[ib];
+    }
+
+    ModuleBase::matrix force(2, 3);
+    ModuleBase::matrix stress(3, 3);
+    hamilt::Nonlocal_RS nl_rs(&ucell, &ppcell, &wfcpw, ecutwfc, 1.0, 2.0, true);
+    nl_rs.cal_force_stress(psi.data(), nb, npw, wg_mat, std::vector<int>(1, 0), &force, &stress);
+
+    // move the atoms, tau is in lat0 for a cubic cell of lat0
+    const double h = 1e-4;
+    double force_max = 0.0;
+    for (int iat = 0; iat < 2; iat++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            force_max = std::max(force_max, std::abs(force(iat, i)));
+        }
+    }
+    ASSERT_GT(force_max, 1e-3);
+    for (int iat = 0; iat < 2; iat++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            ModuleBase::Vector3<double>& tau = ucell.atoms[0].tau[iat];
+            ModuleBase::Vector3<double>& taud = ucell.atoms[0].taud[iat];
+            const double tau0 = tau[i];
+            tau[i] = taud[i] = tau0 + h;
+            const double ep = this->energy(wfcpw, wg, psir);
+            tau[i] = taud[i] = tau0 - h;
+            const double em = this->energy(wfcpw, wg, psir);
+            tau[i] = taud[i] = tau0;
+            const double fd = -(ep - em) / (2.0 * h * ucell.lat0);
+            EXPECT_NEAR(force(iat, i), fd, 1e-5 * force_max) << "atom " << iat << " direction " << i;
+        }
+    }
+
+    // strain the cell, a' = (1 + epsilon) a, with psi(r) on the same grid and the same fractional k point
+    const ModuleBase::Vector3<double> kvec_d(0.1, -0.2, 0.3);
+    const std::vector<ModuleBase::Vector3<double>> tau0 = ucell.atoms[0].tau;
+    double stress_max = 0.0;
+    for (int i = 0; i < 9; i++)
+    {
+        stress_max = std::max(stress_max, std::abs(stress.c[i]));
+    }
+    ASSERT_GT(stress_max, 1e-6);
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            double e[2] = {0.0, 0.0};
+            for (int is = 0; is < 2; is++)
+            {
+                const double eps = (is == 0) ? h : -h;
+                ModuleBase::Matrix3 latvec(1, 0, 0, 0, 1, 0, 0, 0, 1);
+                // the rows are the lattice vectors
+                double* row[3] = {&latvec.e11, &latvec.e21, &latvec.e31};
+                row[0][i] += eps * row[0][j];
+                row[1][i] += eps * row[1][j];
+                row[2][i] += eps * row[2][j];
+                ucell.a1 = ModuleBase::Vector3<double>(latvec.e11, latvec.e12, latvec.e13);
+                ucell.a2 = ModuleBase::Vector3<double>(latvec.e21, latvec.e22, latvec.e23);
+                ucell.a3 = ModuleBase::Vector3<double>(latvec.e31, latvec.e32, latvec.e33);
+                ucell.omega = latvec.Det() * std::pow(ucell.lat0, 3);
+                for (int iat = 0; iat < 2; iat++)
+                {
+                    ModuleBase::Vector3<double>& tau = ucell.atoms[0].tau[iat];
+                    tau = tau0[iat];
+                    tau[i] += eps * tau0[iat][j];
+                }
+                ModulePW::PW_Basis_K pw;
+#ifdef __MPI
+                pw.initmpi(1, 0, MPI_COMM_SELF);
+#endif
+                pw.initgrids(ucell.lat0, latvec, wfcpw.nx, wfcpw.ny, wfcpw.nz);
+                pw.initparameters(false, ecutwfc, 1, &kvec_d);
+                pw.setuptransform();
+                pw.collect_local_pw();
+                e[is] = this->energy(pw, wg, psir);
+            }
+            const double fd = -(e[0] - e[1]) / (2.0 * h) / std::pow(ucell.lat0, 3);
+            EXPECT_NEAR(stress(i, j), fd, 1e-5 * stress_max) << "component " << i << " " << j;
+        }
+    }
+    ucell.a1 = ModuleBase::Vector3<double>(1, 0, 0);
+    ucell.a2 = ModuleBase::Vector3<double>(0, 1, 0);
+    ucell.a3 = ModuleBase::Vector3<double>(0, 0, 1);
+    ucell.omega = std::pow(ucell.lat0, 3);
+    ucell.atoms[0].tau = tau0;
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    POOL_WORLD = MPI_COMM_WORLD;
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
@@ -0,0 +1,115 @@
+#include "diago_arena.h"
+
+#include "module_base/memory.h"
+#include "module_base/module_device/memory_op.h"
+#include "module_base/tool_quit.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+#include <type_traits>
+
+namespace hsolver
+{
+
+template <typename Device>
+DiagoArena<Device>::~DiagoArena()
+{
+    this->release();
+    for (auto& block: this->in_use)
+    {
+        this->free_block(block.first);
+    }
+}
+
+template <typename Device>
+void* DiagoArena<Device>::allocate_bytes(const size_t bytes)
+{
+    ++this->requests;
+    // a few bytes at least, so that every block has its own address
+    const size_t size = std::max(bytes, sizeof(double));
+    auto it = this->cached.lower_bound(size);
+    if (it != this->cached.end() && it->first <= 2 * size)
+    {
+        void* ptr = it->second;
+        this->in_use[ptr] = it->first;
+        this->cached.erase(it);
+        return ptr;
+    }
+
+    // a new block, the cached block just below replaced by it
+    if (it != this->cached.begin())
+    {
+        auto small = std::prev(it);
+        this->current_bytes -= small->first;
+        this->free_block(small->second);
+        this->cached.erase(small);
+    }
+    double* ptr = nullptr;
+    base_device::memory::resize_memory_op<double, Device>()(ptr, (size + sizeof(double) - 1) / sizeof(double));
+    if (ptr == nullptr)
+    {
+        ModuleBase::WARNING_QUIT("DiagoArena", "failed to allocate the workspace of the eigensolver");
+    }
+    ++this->allocations;
+    this->current_bytes += size;
+    this->peak_bytes = std::max(this->peak_bytes, this->current_bytes);
+    this->in_use[ptr] = size;
+    return ptr;
+}
+
+template <typename Device>
+void DiagoArena<Device>::free(void* ptr)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    auto it = this->in_use.find(ptr);
+    if (it == this->in_use.end())
+    {
+        ModuleBase::WARNING_QUIT("DiagoArena", "the block is not from this arena");
+    }
+    this->cached.insert(std::make_pair(it->second, ptr));
+    this->in_use.erase(it);
+}
+
+template <typename Device>
+void DiagoArena<Device>::release()
+{
+    for (auto& block: this->cached)
+    {
+        this->current_bytes -= block.first;
+        this->free_block(block.second);
+    }
+    this->cached.clear();
+}
+
+template <typename Device>
+void DiagoArena<Device>::free_block(void* ptr)
+{
+    base_device::memory::delete_memory_op<double, Device>()(static_cast<double*>(ptr));
+}
+
+template <typename Device>
+void DiagoArena<Device>::print_stats(std::ofstream& ofs, const std::string& name) const
+{
+    const double peak_mb = static_cast<double>(this->peak_bytes) / 1024.0 / 1024.0;
+    ofs << " " << name << ": " << this->requests << " requests, " << this->allocations
+        << " allocations, peak memory " << std::setprecision(4) << peak_mb << " MB" << std::endl;
+#if defined(__CUDA) || defined(__ROCM)
+    if (!std::is_same<Device, base_device::DEVICE_CPU>::value)
+    {
+        ModuleBase::Memory::record_gpu(name, this->peak_bytes);
+        return;
+    }
+#endif
+    ModuleBase::Memory::record(name, this->peak_bytes);
+}
+
+template class DiagoArena<base_device::DEVICE_CPU>;
+#if ((defined __CUDA) || (defined __ROCM))
+template class DiagoArena<base_device::DEVICE_GPU>;
+#endif
+
+} // namespace hsolver
@@ -0,0 +1,125 @@
+#ifndef DIAGO_ARENA_H
+#define DIAGO_ARENA_H
+
+#include "module_base/module_device/types.h"
+
+#include <ATen/core/tensor_types.h>
+#include <base/core/allocator.h>
+
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace hsolver
+{
+
+/**
+ * @class DiagoArena
+ * @brief Workspace of the iterative eigensolvers, kept across k points and SCF iterations.
+ *
+ * The blocks freed by a solver are cached and given again to the next request that fits, so the solvers
+ * constructed for every k point in every SCF iteration do not allocate device memory after the first
+ * iteration. A request takes the smallest cached block at least as large, if it is not more than twice
+ * the request. Otherwise a new block is allocated, and the largest cached block too small for the request
+ * is freed first, so that the cache stays close to the size needed by the largest k point.
+ *
+ * @tparam Device The device of the memory (base_device::DEVICE_CPU or DEVICE_GPU).
+ */
+template <typename Device = base_device::DEVICE_CPU>
+class DiagoArena
+{
+  public:
+    DiagoArena() = default;
+    DiagoArena(const DiagoArena&) = delete;
+    DiagoArena& operator=(const DiagoArena&) = delete;
+    ~DiagoArena();
+
+    /// a block of at least n elements of type T, uninitialized
+    template <typename T>
+    T* allocate(const size_t n)
+    {
+        return static_cast<T*>(this->allocate_bytes(n * sizeof(T)));
+    }
+
+    void* allocate_bytes(const size_t bytes);
+
+    /// give back a block of allocate(), nullptr is ignored
+    void free(void* ptr);
+
+    /// free all the cached blocks, the blocks in use are kept
+    void release();
+
+    size_t get_requests() const
+    {
+        return this->requests;
+    }
+    size_t get_allocations() const
+    {
+        return this->allocations;
+    }
+    size_t get_peak_bytes() const
+    {
+        return this->peak_bytes;
+    }
+
+    /// print the number of requests and allocations and the peak memory, and record the peak in ModuleBase::Memory
+    void print_stats(std::ofstream& ofs, const std::string& name) const;
+
+  private:
+    void free_block(void* ptr);
+
+    std::multimap<size_t, void*> cached;          ///< free blocks by size
+    std::unordered_map<void*, size_t> in_use;     ///< blocks given out and their size
+
+    size_t requests = 0;
+    size_t allocations = 0;
+    size_t current_bytes = 0; ///< bytes allocated on the device, cached or in use
+    size_t peak_bytes = 0;
+};
+
+/**
+ * @brief The base::core::Allocator of a ct::Tensor taking its memory from a DiagoArena.
+ *
+ * Each tensor deletes its allocator, so a new one is made for each tensor:
+ *      ct::Tensor(new DiagoArenaAllocator<Device>(arena), type, device, shape)
+ */
+template <typename Device = base_device::DEVICE_CPU>
+class DiagoArenaAllocator : public base::core::Allocator
+{
+  public:
+    explicit DiagoArenaAllocator(DiagoArena<Device>* arena_in) : arena(arena_in)
+    {
+    }
+
+    void* allocate(size_t size) override
+    {
+        this->allocated_size_ = size;
+        return this->arena->allocate_bytes(size);
+    }
+
+    void* allocate(size_t size, size_t alignment) override
+    {
+        // the blocks are aligned as the device allocation
+        return this->allocate(size);
+    }
+
+    void free(void* ptr) override
+    {
+        this->allocated_size_ = 0;
+        this->arena->free(ptr);
+    }
+
+    container::DeviceType GetDeviceType() override
+    {
+        return container::DeviceTypeToEnum<Device>::value;
+    }
+
+  private:
+    DiagoArena<Device>* arena = nullptr;
+};
+
+} // namespace hsolver
+
+#endif
@@ -16,8 +16,9 @@
 namespace hsolver {
 
 template<typename T, typename Device>
-DiagoBPCG<T, Device>::DiagoBPCG(const Real* precondition_in)
+DiagoBPCG<T, Device>::DiagoBPCG(const Real* precondition_in, DiagoArena<Device>* arena_in)
 {
+    this->arena = (arena_in != nullptr) ? arena_in : &this->own_arena;
     this->r_type   = ct::DataTypeToEnum<Real>::value;
     this->t_type   = ct::DataTypeToEnum<T>::value;
     this->device_type    = ct::DeviceTypeToEnum<Device>::value;
@@ -42,22 +43,25 @@ void DiagoBPCG<T, Device>::init_iter(const int nband, const int nband_l, const i
     this->n_basis       = nbasis;
     this->n_dim         = ndim;
 
-    // All column major tensors
+    // All column major tensors, taking their memory from the arena
+    auto arena_tensor = [this](const ct::DataType type, const ct::TensorShape& shape) {
+        return ct::Tensor(new DiagoArenaAllocator<Device>(this->arena), type, this->device_type, shape);
+    };
 
-    this->beta          = std::move(ct::Tensor(r_type, device_type, {this->n_band_l}));
-    this->eigen         = std::move(ct::Tensor(r_type, device_type, {this->n_band}));
-    this->err_st        = std::move(ct::Tensor(r_type, device_type, {this->n_band_l}));
+    this->beta          = std::move(arena_tensor(r_type, {this->n_band_l}));
+    this->eigen         = std::move(arena_tensor(r_type, {this->n_band}));
+    this->err_st        = std::move(arena_tensor(r_type, {this->n_band_l}));
 
-    this->hsub          = std::move(ct::Tensor(t_type, device_type, {this->n_band, this->n_band}));
+    this->hsub          = std::move(arena_tensor(t_type, {this->n_band, this->n_band}));
 
-    this->hpsi          = std::move(ct::Tensor(t_type, device_type, {this->n_band_l, this->n_basis}));
-    this->work          = std::move(ct::Tensor(t_type, device_type, {this->n_band_l, this->n_basis}));
-    this->hgrad         = std::move(ct::Tensor(t_type, device_type, {this->n_band_l, this->n_basis}));
-    this->grad_old      = std::move(ct::Tensor(t_type, device_type, {this->n_band_l, this->n_basis}));
+    this->hpsi          = std::move(arena_tensor(t_type, {this->n_band_l, this->n_basis}));
+    this->work          = std::move(arena_tensor(t_type, {this->n_band_l, this->n_basis}));
+    this->hgrad         = std::move(arena_tensor(t_type, {this->n_band_l, this->n_basis}));
+    this->grad_old      = std::move(arena_tensor(t_type, {this->n_band_l, this->n_basis}));
 
-    this->prec          = std::move(ct::Tensor(r_type, device_type, {this->n_basis}));
+    this->prec          = std::move(arena_tensor(r_type, {this->n_basis}));
 
-    this->grad          = std::move(ct::Tensor(t_type, device_type, {this->n_band_l, this->n_basis}));
+    this->grad          = std::move(arena_tensor(t_type, {this->n_band_l, this->n_basis}));
 #ifdef __MPI
     this->pmmcn.set_dimension(BP_WORLD, POOL_WORLD, n_band_l, n_basis, n_band_l, n_basis, n_dim, n_band);
     this->plintrans.set_dimension(n_dim, nband_l, n_band_l, n_basis, BP_WORLD, false);
@@ -7,6 +7,7 @@
 #include "module_base/para_gemm.h"
 #include "module_hamilt_general/hamilt.h"
 #include "module_hamilt_pw/hamilt_pwdft/structure_factor.h"
+#include "module_hsolver/diago_arena.h"
 #include "module_hsolver/kernels/dngvd_op.h"
 #include "module_hsolver/para_linear_transform.h"
 
@@ -36,8 +37,10 @@ class DiagoBPCG
      * @brief Constructor for DiagoBPCG class.
      *
      * @param precondition precondition data passed by the "Hamilt_PW" class.
+     * @param arena_in workspace of the tensors, kept by the caller across k points and SCF iterations.
+     *                 If nullptr, the solver has its own.
      */
-    explicit DiagoBPCG(const Real* precondition);
+    explicit DiagoBPCG(const Real* precondition, DiagoArena<Device>* arena_in = nullptr);
 
     /**
      * @brief Destructor for DiagoBPCG class.
@@ -94,6 +97,10 @@ class DiagoBPCG
     ct::DataType t_type  = ct::DataType::DT_INVALID;
     ct::DeviceType device_type = ct::DeviceType::UnKnown;
 
+    /// workspace of the tensors below, declared before them so that they give back their memory first
+    DiagoArena<Device> own_arena;
+    DiagoArena<Device>* arena = nullptr;
+
     ct::Tensor prec = {}, h_prec = {};
 
     /// The coefficient for mixing the current and previous step gradients, used in iterative methods.
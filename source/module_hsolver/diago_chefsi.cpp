@@ -0,0 +1,410 @@
+#include "diago_chefsi.h"
+
+#include <ATen/kernels/lapack.h>
+
+#include "module_base/kernels/math_kernel_op.h"
+#include "module_base/lapack_connector.h"
+#include "module_base/parallel_reduce.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#ifdef __MPI
+#include <mpi.h>
+#endif
+
+using namespace hsolver;
+
+template <typename T, typename Device>
+DiagoChebFSI<T, Device>::DiagoChebFSI(const int& nband_in,
+                                      const int& dim_in,
+                                      const int& degree_in,
+                                      const double& diag_thr_in,
+                                      const int& diag_nmax_in,
+                                      const diag_comm_info& diag_comm_in,
+                                      const int block_size_in,
+                                      const int nlanczos_in)
+    : diag_comm(diag_comm_in), diag_thr(diag_thr_in), iter_nmax(diag_nmax_in), n_band(nband_in), dim(dim_in),
+      degree(degree_in), n_buffer(std::max(0, std::min(std::max(nband_in / 10, 4), dim_in * diag_comm_in.nproc - nband_in))),
+      block_size(std::max(1, std::min(block_size_in, nband_in))), nlanczos(nlanczos_in)
+{
+    this->device = base_device::get_device_type<Device>(this->ctx);
+
+    this->one = &one_;
+    this->zero = &zero_;
+
+    assert(this->degree > 0);
+    assert(this->nlanczos > 0);
+
+    const int nband_x = this->n_band + this->n_buffer;
+    resmem_complex_op()(this->psi_work, nband_x * this->dim, "ChebFSI::psi_work");
+    resmem_complex_op()(this->hpsi_work, nband_x * this->dim, "ChebFSI::hpsi_work");
+    resmem_complex_op()(this->filter_y, this->block_size * this->dim, "ChebFSI::filter_y");
+    resmem_complex_op()(this->filter_hy, this->block_size * this->dim, "ChebFSI::filter_hy");
+    resmem_complex_op()(this->mat, nband_x * nband_x, "ChebFSI::mat");
+
+    this->hcc.resize(nband_x * nband_x, *this->zero);
+    this->scc.resize(nband_x * nband_x, *this->zero);
+}
+
+template <typename T, typename Device>
+DiagoChebFSI<T, Device>::~DiagoChebFSI()
+{
+    delmem_complex_op()(this->psi_work);
+    delmem_complex_op()(this->hpsi_work);
+    delmem_complex_op()(this->filter_y);
+    delmem_complex_op()(this->filter_hy);
+    delmem_complex_op()(this->mat);
+}
+
+template <typename T, typename Device>
+auto DiagoChebFSI<T, Device>::estimate_upper_bound(const HPsiFunc& hpsi_func) -> Real
+{
+    ModuleBase::timer::tick("DiagoChebFSI", "lanczos");
+
+    // v_prev, v and w = H * v
+    T* lanczos = nullptr;
+    resmem_complex_op()(lanczos, 3 * this->dim);
+    T* v_prev = lanczos;
+    T* v = lanczos + this->dim;
+    T* w = lanczos + 2 * this->dim;
+    setmem_complex_op()(v_prev, 0, this->dim);
+
+    // a fixed starting vector, which is hardly orthogonal to any eigenvector
+    std::vector<T> v_h(this->dim);
+    for (int ig = 0; ig < this->dim; ++ig)
+    {
+        v_h[ig] = static_cast<T>(1.0 + 0.5 * std::sin(0.7 * (ig + this->diag_comm.rank * this->dim)));
+    }
+    syncmem_h2d_op()(v, v_h.data(), this->dim);
+    const Real norm = std::sqrt(ModuleBase::dot_real_op<T, Device>()(this->dim, v, v, true));
+    ModuleBase::vector_div_constant_op<T, Device>()(this->dim, v, v, norm);
+
+    std::vector<double> alpha;
+    std::vector<double> beta;
+    Real beta_last = 0.0;
+    for (int j = 0; j < this->nlanczos; ++j)
+    {
+        hpsi_func(v, w, this->dim, 1);
+        const Real a = ModuleBase::dot_real_op<T, Device>()(this->dim, v, w, true);
+        // w = w - a * v - beta_last * v_prev
+        ModuleBase::constantvector_addORsub_constantVector_op<T, Device>()(this->dim, w, w, 1.0, v, -a);
+        ModuleBase::constantvector_addORsub_constantVector_op<T, Device>()(this->dim, w, w, 1.0, v_prev, -beta_last);
+        beta_last = std::sqrt(ModuleBase::dot_real_op<T, Device>()(this->dim, w, w, true));
+        alpha.push_back(a);
+        if (beta_last < 1e-10 * std::max(static_cast<Real>(1.0), std::abs(a)))
+        {
+            // an invariant subspace is found, the Ritz values are exact
+            break;
+        }
+        beta.push_back(beta_last);
+        ModuleBase::vector_div_constant_op<T, Device>()(this->dim, v_prev, w, beta_last);
+        std::swap(v_prev, v);
+    }
+    delmem_complex_op()(lanczos);
+
+    // the largest eigenvalue of the tridiagonal matrix, plus the last beta to bound the spectrum of H
+    int n = alpha.size();
+    beta.resize(std::max(n - 1, 1));
+    int info = 0;
+    dsterf_(&n, alpha.data(), beta.data(), &info);
+    if (info != 0)
+    {
+        ModuleBase::WARNING_QUIT("DiagoChebFSI::estimate_upper_bound", "dsterf failed");
+    }
+
+    ModuleBase::timer::tick("DiagoChebFSI", "lanczos");
+    return static_cast<Real>(alpha[n - 1]) + beta_last;
+}
+
+template <typename T, typename Device>
+void DiagoChebFSI<T, Device>::filter(const HPsiFunc& hpsi_func, const Real a0, const Real a, const Real b)
+{
+    ModuleBase::timer::tick("DiagoChebFSI", "filter");
+
+    const Real e = (b - a) / 2;
+    const Real c = (b + a) / 2;
+    const Real sigma1 = e / (a0 - c);
+    const Real tau = 2 / sigma1;
+
+    const int nband_x = this->n_band + this->n_buffer;
+    for (int ib = 0; ib < nband_x; ib += this->block_size)
+    {
+        const int nb = std::min(this->block_size, nband_x - ib);
+        const int size = nb * this->dim;
+        T* block = this->psi_work + ib * this->dim;
+        T* x = block;
+        T* y = this->filter_y;
+
+        // y = (H - c) x * sigma1 / e
+        hpsi_func(x, this->filter_hy, this->dim, nb);
+        ModuleBase::constantvector_addORsub_constantVector_op<T, Device>()(size,
+                                                                            y,
+                                                                            this->filter_hy,
+                                                                            sigma1 / e,
+                                                                            x,
+                                                                            -c * sigma1 / e);
+
+        // three-term recurrence of the scaled Chebyshev polynomials,
+        // x_new = 2 sigma2 / e (H - c) y - sigma sigma2 x, written into x
+        Real sigma = sigma1;
+        for (int i = 1; i < this->degree; ++i)
+        {
+            const Real sigma2 = 1 / (tau - sigma);
+            hpsi_func(y, this->filter_hy, this->dim, nb);
+            ModuleBase::constantvector_addORsub_constantVector_op<T, Device>()(size,
+                                                                                x,
+                                                                                x,
+                                                                                -sigma * sigma2,
+                                                                                this->filter_hy,
+                                                                                2 * sigma2 / e);
+            ModuleBase::constantvector_addORsub_constantVector_op<T, Device>()(size,
+                                                                                x,
+                                                                                x,
+                                                                                1.0,
+                                                                                y,
+                                                                                -2 * sigma2 * c / e);
+            std::swap(x, y);
+            sigma = sigma2;
+        }
+        if (y != block)
+        {
+            syncmem_complex_op()(block, y, size);
+        }
+    }
+
+    ModuleBase::timer::tick("DiagoChebFSI", "filter");
+}
+
+template <typename T, typename Device>
+void DiagoChebFSI<T, Device>::orth_cholesky()
+{
+    ModuleBase::timer::tick("DiagoChebFSI", "orth_cholesky");
+
+    const int nband = this->n_band + this->n_buffer;
+    ModuleBase::gemm_op<T, Device>()('C',
+                                     'N',
+                                     nband,
+                                     nband,
+                                     this->dim,
+                                     this->one,
+                                     this->psi_work,
+                                     this->dim,
+                                     this->psi_work,
+                                     this->dim,
+                                     this->zero,
+                                     this->mat,
+                                     nband);
+    syncmem_d2h_op()(this->scc.data(), this->mat, nband * nband);
+#ifdef __MPI
+    if (this->diag_comm.nproc > 1)
+    {
+        Parallel_Reduce::reduce_pool(this->scc.data(), nband * nband);
+    }
+#endif
+
+    // the factorization is small, do it on the host of rank 0
+    if (this->diag_comm.rank == 0)
+    {
+        // potrf and trtri only use the upper triangle, the lower one is set to zero for the rotation
+        for (int j = 0; j < nband; ++j)
+        {
+            std::fill(this->scc.begin() + j * nband + j + 1, this->scc.begin() + (j + 1) * nband, *this->zero);
+        }
+        ct::kernels::lapack_potrf<T, ct::DEVICE_CPU>()('U', nband, this->scc.data(), nband);
+        ct::kernels::lapack_trtri<T, ct::DEVICE_CPU>()('U', 'N', nband, this->scc.data(), nband);
+    }
+#ifdef __MPI
+    if (this->diag_comm.nproc > 1)
+    {
+        MPI_Bcast(this->scc.data(), nband * nband * sizeof(T), MPI_BYTE, 0, this->diag_comm.comm);
+    }
+#endif
+
+    syncmem_h2d_op()(this->mat, this->scc.data(), nband * nband);
+    this->rotate_psi();
+
+    ModuleBase::timer::tick("DiagoChebFSI", "orth_cholesky");
+}
+
+template <typename T, typename Device>
+void DiagoChebFSI<T, Device>::rayleigh_ritz(const HPsiFunc& hpsi_func, Real* eigenvalue)
+{
+    ModuleBase::timer::tick("DiagoChebFSI", "rayleigh_ritz");
+
+    const int nband = this->n_band + this->n_buffer;
+    this->orth_cholesky();
+    hpsi_func(this->psi_work, this->hpsi_work, this->dim, nband);
+
+    // hcc = psi^H H psi
+    ModuleBase::gemm_op<T, Device>()('C',
+                                     'N',
+                                     nband,
+                                     nband,
+                                     this->dim,
+                                     this->one,
+                                     this->psi_work,
+                                     this->dim,
+                                     this->hpsi_work,
+                                     this->dim,
+                                     this->zero,
+                                     this->mat,
+                                     nband);
+    syncmem_d2h_op()(this->hcc.data(), this->mat, nband * nband);
+#ifdef __MPI
+    if (this->diag_comm.nproc > 1)
+    {
+        Parallel_Reduce::reduce_pool(this->hcc.data(), nband * nband);
+    }
+#endif
+
+    // the eigenproblem is small, solve it on the host of rank 0, hcc is overwritten by the eigenvectors
+    if (this->diag_comm.rank == 0)
+    {
+        ct::kernels::lapack_dnevd<T, ct::DEVICE_CPU>()('V', 'U', this->hcc.data(), nband, eigenvalue);
+    }
+#ifdef __MPI
+    if (this->diag_comm.nproc > 1)
+    {
+        MPI_Bcast(this->hcc.data(), nband * nband * sizeof(T), MPI_BYTE, 0, this->diag_comm.comm);
+        MPI_Bcast(eigenvalue, nband * sizeof(Real), MPI_BYTE, 0, this->diag_comm.comm);
+    }
+#endif
+
+    syncmem_h2d_op()(this->mat, this->hcc.data(), nband * nband);
+    this->rotate_psi();
+
+    ModuleBase::timer::tick("DiagoChebFSI", "rayleigh_ritz");
+}
+
+template <typename T, typename Device>
+void DiagoChebFSI<T, Device>::rotate_psi()
+{
+    // the rotated bands are written into hpsi_work and swapped
+    const int nband = this->n_band + this->n_buffer;
+    ModuleBase::gemm_op<T, Device>()('N',
+                                     'N',
+                                     this->dim,
+                                     nband,
+                                     nband,
+                                     this->one,
+                                     this->psi_work,
+                                     this->dim,
+                                     this->mat,
+                                     nband,
+                                     this->zero,
+                                     this->hpsi_work,
+                                     this->dim);
+    std::swap(this->psi_work, this->hpsi_work);
+}
+
+template <typename T, typename Device>
+int DiagoChebFSI<T, Device>::diag(const HPsiFunc& hpsi_func,
+                                  T* psi_in,
+                                  const int ld_psi,
+                                  Real* eigenvalue_in,
+                                  const std::vector<double>& ethr_band,
+                                  const bool& scf_type)
+{
+    ModuleBase::timer::tick("DiagoChebFSI", "diag");
+
+    const int nband_x = this->n_band + this->n_buffer;
+    for (int ib = 0; ib < this->n_band; ++ib)
+    {
+        syncmem_complex_op()(this->psi_work + ib * this->dim, psi_in + ib * ld_psi, this->dim);
+    }
+    // the buffer bands start from fixed vectors, which are made smooth by the filter
+    std::vector<T> buffer_h(this->n_buffer * this->dim);
+    for (int ib = 0; ib < this->n_buffer; ++ib)
+    {
+        for (int ig = 0; ig < this->dim; ++ig)
+        {
+            buffer_h[ib * this->dim + ig]
+                = static_cast<T>(std::sin(1.3 * (ib + 1) * (ig + this->diag_comm.rank * this->dim + 1)));
+        }
+    }
+    syncmem_h2d_op()(this->psi_work + this->n_band * this->dim, buffer_h.data(), this->n_buffer * this->dim);
+
+    // the eigenvalues of the last step give the lower bounds of the filter
+    std::vector<Real> eigenvalue_x(nband_x);
+    const bool has_eigenvalue = eigenvalue_in[this->n_band - 1] > eigenvalue_in[0];
+    if (has_eigenvalue)
+    {
+        std::copy(eigenvalue_in, eigenvalue_in + this->n_band, eigenvalue_x.begin());
+        std::fill(eigenvalue_x.begin() + this->n_band, eigenvalue_x.end(), eigenvalue_in[this->n_band - 1]);
+    }
+    else
+    {
+        this->rayleigh_ritz(hpsi_func, eigenvalue_x.data());
+    }
+    Real b = this->estimate_upper_bound(hpsi_func);
+
+    // in scf, one filter and Rayleigh-Ritz step is enough as H changes in the next SCF step,
+    // except for the first step, where psi is far from the eigenvectors
+    const bool once = scf_type && has_eigenvalue;
+    std::vector<Real> eigenvalue_old(nband_x);
+    int iter = 0;
+    do
+    {
+        eigenvalue_old = eigenvalue_x;
+        const Real a0 = eigenvalue_x[0];
+        const Real a = eigenvalue_x[nband_x - 1];
+        if (b <= a)
+        {
+            // the Lanczos estimate is not an upper bound, which happens only for a very small basis
+            b = a + std::max(a - a0, static_cast<Real>(1.0));
+        }
+        this->filter(hpsi_func, a0, a, b);
+        this->rayleigh_ritz(hpsi_func, eigenvalue_x.data());
+        ++iter;
+
+        this->notconv = 0;
+        for (int ib = 0; ib < this->n_band; ++ib)
+        {
+            if (std::abs(eigenvalue_x[ib] - eigenvalue_old[ib]) > ethr_band[ib])
+            {
+                ++this->notconv;
+            }
+        }
+    } while (!once && this->notconv > 0 && iter < this->iter_nmax);
+
+    std::copy(eigenvalue_x.begin(), eigenvalue_x.begin() + this->n_band, eigenvalue_in);
+    for (int ib = 0; ib < this->n_band; ++ib)
+    {
+        syncmem_complex_op()(psi_in + ib * ld_psi, this->psi_work + ib * this->dim, this->dim);
+    }
+
+    if (!scf_type && this->notconv > 0)
+    {
+        std::cout << "\n notconv = " << this->notconv;
+        std::cout << "\n DiagoChebFSI::diag', some bands are not converged! \n";
+    }
+
+    ModuleBase::timer::tick("DiagoChebFSI", "diag");
+    return iter;
+}
+
+namespace hsolver
+{
+
+template class DiagoChebFSI<std::complex<float>, base_device::DEVICE_CPU>;
+template class DiagoChebFSI<std::complex<double>, base_device::DEVICE_CPU>;
+
+#if ((defined __CUDA) || (defined __ROCM))
+template class DiagoChebFSI<std::complex<float>, base_device::DEVICE_GPU>;
+template class DiagoChebFSI<std::complex<double>, base_device::DEVICE_GPU>;
+#endif
+
+#ifdef __LCAO
+template class DiagoChebFSI<double, base_device::DEVICE_CPU>;
+
+#if ((defined __CUDA) || (defined __ROCM))
+template class DiagoChebFSI<double, base_device::DEVICE_GPU>;
+#endif
+
+#endif
+} // namespace hsolver
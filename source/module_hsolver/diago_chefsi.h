@@ -0,0 +1,154 @@
+#ifndef DIAGO_CHEFSI_H
+#define DIAGO_CHEFSI_H
+
+#include "module_base/macros.h"                  // GetRealType
+#include "module_base/module_device/device.h"    // base_device
+#include "module_base/module_device/memory_op.h" // base_device::memory
+
+#include "module_hsolver/diag_comm_info.h"
+
+#include <functional>
+#include <vector>
+
+namespace hsolver
+{
+
+/**
+ * @brief Chebyshev-filtered subspace iteration (ChFSI) for the lowest nband eigenpairs of H.
+ *
+ * Each iteration applies a Chebyshev polynomial filter of degree m to the bands, which amplifies
+ * the components below the filter lower bound a and damps those in [a, b], followed by one
+ * Rayleigh-Ritz step in the filtered subspace.
+ * The upper bound b of the spectrum is estimated by a few Lanczos steps, a is the largest
+ * eigenvalue of the previous Rayleigh-Ritz step, so the eigenvalues given to diag() should be
+ * those of the last SCF step. If they are not available (all zero), a Rayleigh-Ritz step on the
+ * input psi is done first.
+ * The filter is applied to blocks of block_size bands, so only three blocks of work space are needed.
+ * The filtered bands are nearly linearly dependent, they are orthonormalized by Cholesky-QR before
+ * the Rayleigh-Ritz step, which then only needs a standard eigensolver.
+ * A few buffer bands are iterated together with the bands and dropped at the end, otherwise the highest
+ * bands, which lie at the lower bound a of the filter, converge very slowly.
+ * See Y. Zhou, Y. Saad, M. L. Tiago, J. R. Chelikowsky, J. Comput. Phys. 219, 172 (2006).
+ */
+template <typename T = std::complex<double>, typename Device = base_device::DEVICE_CPU>
+class DiagoChebFSI
+{
+  private:
+    // Note GetTypeReal<T>::type will
+    // return T if T is real type(float, double),
+    // otherwise return the real type of T(complex<float>, complex<double>)
+    using Real = typename GetTypeReal<T>::type;
+
+  public:
+    DiagoChebFSI(const int& nband_in,
+                 const int& dim_in,
+                 const int& degree_in,
+                 const double& diag_thr_in,
+                 const int& diag_nmax_in,
+                 const diag_comm_info& diag_comm_in,
+                 const int block_size_in = 64,
+                 const int nlanczos_in = 10);
+
+    ~DiagoChebFSI();
+
+    // See diago_david.h for information on the HPsiFunc function type
+    using HPsiFunc = std::function<void(T*, T*, const int, const int)>;
+
+    /**
+     * @brief Diagonalize H in the space of psi_in.
+     *
+     * @param hpsi_func function to apply H to a block of vectors
+     * @param psi_in [in/out] the bands, psi_in[ib * ld_psi + ig]
+     * @param ld_psi leading dimension of psi_in
+     * @param eigenvalue_in [in/out] the eigenvalues of the last step in, the new eigenvalues out
+     * @param ethr_band the convergence threshold of each band
+     * @param scf_type true for scf, only one iteration is done; false for nscf, iterate until converged
+     * @return the number of filter and Rayleigh-Ritz steps
+     */
+    int diag(const HPsiFunc& hpsi_func,
+             T* psi_in,
+             const int ld_psi,
+             Real* eigenvalue_in,
+             const std::vector<double>& ethr_band,
+             const bool& scf_type);
+
+  private:
+    /// for MPI communication
+    const diag_comm_info diag_comm;
+
+    /// the threshold for this electronic iteration
+    const double diag_thr;
+
+    /// maximal iteration number
+    const int iter_nmax;
+
+    /// the number of bands
+    const int n_band = 0;
+
+    /// the dimension of psi in this process
+    const int dim = 0;
+
+    /// the degree of the Chebyshev filter
+    const int degree = 0;
+
+    /// the number of buffer bands, n_band + n_buffer bands are iterated
+    const int n_buffer = 0;
+
+    /// the number of bands filtered at once
+    const int block_size = 0;
+
+    /// the number of Lanczos steps to estimate the upper bound of the spectrum
+    const int nlanczos = 0;
+
+    /// record for how many bands not have convergence eigenvalues
+    int notconv = 0;
+
+    /// the bands and H * bands, dim * (n_band + n_buffer)
+    T* psi_work = nullptr;
+    T* hpsi_work = nullptr;
+
+    /// work space of the filter, dim * block_size
+    T* filter_y = nullptr;
+    T* filter_hy = nullptr;
+
+    /// subspace matrix on device, (n_band + n_buffer)^2
+    T* mat = nullptr;
+
+    /// Hamiltonian and overlap in the subspace, (n_band + n_buffer)^2, on host,
+    /// hcc is overwritten by the eigenvectors, scc by the inverse of its Cholesky factor
+    std::vector<T> hcc;
+    std::vector<T> scc;
+
+    /// device type of psi
+    Device* ctx = {};
+    base_device::AbacusDevice_t device = {};
+
+    /// upper bound of the spectrum of H by nlanczos Lanczos steps
+    Real estimate_upper_bound(const HPsiFunc& hpsi_func);
+
+    /// psi_work = p_m(H) psi_work, p_m is the Chebyshev polynomial scaled to [a, b] with p_m(a0) ~ 1
+    void filter(const HPsiFunc& hpsi_func, const Real a0, const Real a, const Real b);
+
+    /// psi_work = psi_work * U^{-1}, U^H U = psi_work^H psi_work is the Cholesky factorization
+    void orth_cholesky();
+
+    /// Rayleigh-Ritz in the space of psi_work, psi_work is orthonormalized and rotated to the Ritz vectors
+    void rayleigh_ritz(const HPsiFunc& hpsi_func, Real* eigenvalue);
+
+    /// psi_work = psi_work * mat, through hpsi_work
+    void rotate_psi();
+
+    using resmem_complex_op = base_device::memory::resize_memory_op<T, Device>;
+    using delmem_complex_op = base_device::memory::delete_memory_op<T, Device>;
+    using setmem_complex_op = base_device::memory::set_memory_op<T, Device>;
+    using syncmem_complex_op = base_device::memory::synchronize_memory_op<T, Device, Device>;
+    using syncmem_h2d_op = base_device::memory::synchronize_memory_op<T, Device, base_device::DEVICE_CPU>;
+    using syncmem_d2h_op = base_device::memory::synchronize_memory_op<T, base_device::DEVICE_CPU, Device>;
+
+    const T *one = nullptr, *zero = nullptr;
+    const T one_ = static_cast<T>(1.0), zero_ = static_cast<T>(0.0);
+};
+
+} // namespace hsolver
+
+#endif
@@ -28,12 +28,14 @@ Diago_DavSubspace<T, Device>::Diago_DavSubspace(const std::vector<Real>& precond
                                                 const bool& need_subspace_in,
                                                 const diag_comm_info& diag_comm_in,
                                                 const int diag_subspace_in,
-                                                const int diago_subspace_bs_in)
+                                                const int diago_subspace_bs_in,
+                                                DiagoArena<Device>* arena_in)
     : precondition(precondition_in), n_band(nband_in), dim(nbasis_in), nbase_x(nband_in * david_ndim_in),
       diag_thr(diag_thr_in), iter_nmax(diag_nmax_in), is_subspace(need_subspace_in), diag_comm(diag_comm_in),
         diag_subspace(diag_subspace_in), diago_subspace_bs(diago_subspace_bs_in)
 {
     this->device = base_device::get_device_type<Device>(this->ctx);
+    this->arena = (arena_in != nullptr) ? arena_in : &this->own_arena;
 
     this->one = &one_;
     this->zero = &zero_;
@@ -43,26 +45,24 @@ Diago_DavSubspace<T, Device>::Diago_DavSubspace(const std::vector<Real>& precond
     assert(david_ndim_in * nband_in < nbasis_in * this->diag_comm.nproc);
     assert(diag_subspace >= 0 && diag_subspace < 3);
 
-    // TODO: Added memory usage statistics
-
     //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-    resmem_complex_op()(this->psi_in_iter, this->nbase_x * this->dim, "DAV::psi_in_iter");
+    this->psi_in_iter = this->arena->template allocate<T>(this->nbase_x * this->dim);
     setmem_complex_op()(this->psi_in_iter, 0, this->nbase_x * this->dim);
 
     // the product of H and psi in the reduced psi set
-    resmem_complex_op()(this->hphi, this->nbase_x * this->dim, "DAV::hphi");
+    this->hphi = this->arena->template allocate<T>(this->nbase_x * this->dim);
     setmem_complex_op()(this->hphi, 0, this->nbase_x * this->dim);
 
     // Hamiltonian on the reduced psi set
-    resmem_complex_op()(this->hcc, this->nbase_x * this->nbase_x, "DAV::hcc");
+    this->hcc = this->arena->template allocate<T>(this->nbase_x * this->nbase_x);
     setmem_complex_op()(this->hcc, 0, this->nbase_x * this->nbase_x);
 
     // Overlap on the reduced psi set
-    resmem_complex_op()(this->scc, this->nbase_x * this->nbase_x, "DAV::scc");
+    this->scc = this->arena->template allocate<T>(this->nbase_x * this->nbase_x);
     setmem_complex_op()(this->scc, 0, this->nbase_x * this->nbase_x);
 
     // Eigenvectors
-    resmem_complex_op()(this->vcc, this->nbase_x * this->nbase_x, "DAV::vcc");
+    this->vcc = this->arena->template allocate<T>(this->nbase_x * this->nbase_x);
     setmem_complex_op()(this->vcc, 0, this->nbase_x * this->nbase_x);
     //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -78,12 +78,11 @@ Diago_DavSubspace<T, Device>::Diago_DavSubspace(const std::vector<Real>& precond
 template <typename T, typename Device>
 Diago_DavSubspace<T, Device>::~Diago_DavSubspace()
 {
-    delmem_complex_op()(this->psi_in_iter);
-
-    delmem_complex_op()(this->hphi);
-    delmem_complex_op()(this->hcc);
-    delmem_complex_op()(this->scc);
-    delmem_complex_op()(this->vcc);
+    this->arena->free(this->psi_in_iter);
+    this->arena->free(this->hphi);
+    this->arena->free(this->hcc);
+    this->arena->free(this->scc);
+    this->arena->free(this->vcc);
 
 #if defined(__CUDA) || defined(__ROCM)
     if (this->device == base_device::GpuDevice)
@@ -297,8 +296,7 @@ void Diago_DavSubspace<T, Device>::cal_grad(const HPsiFunc& hpsi_func,
     Real* e_temp_hd = e_temp_cpu.data();
     if(this->device == base_device::GpuDevice)
     {
-        e_temp_hd = nullptr;
-        resmem_real_op()(e_temp_hd, nbase);
+        e_temp_hd = this->arena->template allocate<Real>(nbase);
     }
     for (int m = 0; m < notconv; m++)
     {
@@ -314,7 +312,7 @@ void Diago_DavSubspace<T, Device>::cal_grad(const HPsiFunc& hpsi_func,
     }
     if(this->device == base_device::GpuDevice)
     {
-        delmem_real_op()(e_temp_hd);
+        this->arena->free(e_temp_hd);
     }
 
 #ifdef __DSP
@@ -530,17 +528,13 @@ void Diago_DavSubspace<T, Device>::diag_zhegvx(const int& nbase,
 #if defined(__CUDA) || defined(__ROCM)
         if (this->diag_comm.rank == 0)
         {
-            Real* eigenvalue_gpu = nullptr;
-            resmem_real_op()(eigenvalue_gpu, this->nbase_x);
+            Real* eigenvalue_gpu = this->arena->template allocate<Real>(this->nbase_x);
 
             syncmem_var_h2d_op()(eigenvalue_gpu, (*eigenvalue_iter).data(), this->nbase_x);
 
-            T* hcc_gpu = nullptr;
-            T* scc_gpu = nullptr;
-            T* vcc_gpu = nullptr;
-            base_device::memory::resize_memory_op<T, Device>()(hcc_gpu, nbase * nbase);
-            base_device::memory::resize_memory_op<T, Device>()(scc_gpu, nbase * nbase);
-            base_device::memory::resize_memory_op<T, Device>()(vcc_gpu, nbase * nbase);
+            T* hcc_gpu = this->arena->template allocate<T>(nbase * nbase);
+            T* scc_gpu = this->arena->template allocate<T>(nbase * nbase);
+            T* vcc_gpu = this->arena->template allocate<T>(nbase * nbase);
             for(int i=0;i<nbase;i++)
             {
                 base_device::memory::synchronize_memory_op<T, Device, Device>()(hcc_gpu + i * nbase, hcc + i * nbase_x, nbase);
@@ -551,13 +545,13 @@ void Diago_DavSubspace<T, Device>::diag_zhegvx(const int& nbase,
             {
                 base_device::memory::synchronize_memory_op<T, Device, Device>()(vcc + i * nbase_x, vcc_gpu + i * nbase, nbase);
             }
-            delmem_complex_op()(hcc_gpu);
-            delmem_complex_op()(scc_gpu);
-            delmem_complex_op()(vcc_gpu);
+            this->arena->free(hcc_gpu);
+            this->arena->free(scc_gpu);
+            this->arena->free(vcc_gpu);
 
             syncmem_var_d2h_op()((*eigenvalue_iter).data(), eigenvalue_gpu, this->nbase_x);
 
-            delmem_real_op()(eigenvalue_gpu);
+            this->arena->free(eigenvalue_gpu);
         }
 #endif
     }
@@ -7,6 +7,7 @@
 
 #include "module_hsolver/diag_comm_info.h"
 #include "module_hsolver/diag_const_nums.h"
+#include "module_hsolver/diago_arena.h"
 
 #include <vector>
 #include <functional>
@@ -33,7 +34,8 @@ class Diago_DavSubspace
                       const bool& need_subspace_in,
                       const diag_comm_info& diag_comm_in,
                       const int diago_dav_method_in,
-                      const int block_size_in);
+                      const int block_size_in,
+                      DiagoArena<Device>* arena_in = nullptr);
 
     ~Diago_DavSubspace();
 
@@ -90,6 +92,10 @@ class Diago_DavSubspace
     /// Eigenvectors on the reduced basis
     T* vcc = nullptr;
 
+    /// workspace of the arrays above and the temporary arrays, the own one if no arena is given
+    DiagoArena<Device> own_arena;
+    DiagoArena<Device>* arena = nullptr;
+
     /// device type of psi
     Device* ctx = {};
     base_device::DEVICE_CPU* cpu_ctx = {};
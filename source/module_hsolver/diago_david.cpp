@@ -20,9 +20,11 @@ DiagoDavid<T, Device>::DiagoDavid(const Real* precondition_in,
                                   const int dim_in,
                                   const int david_ndim_in,
                                   const bool use_paw_in,
-                                  const diag_comm_info& diag_comm_in)
+                                  const diag_comm_info& diag_comm_in,
+                                  DiagoArena<Device>* arena_in)
     : nband(nband_in), dim(dim_in), nbase_x(david_ndim_in * nband_in), david_ndim(david_ndim_in), use_paw(use_paw_in), diag_comm(diag_comm_in)
 {
+    this->arena = (arena_in != nullptr) ? arena_in : &this->own_arena;
     this->device = base_device::get_device_type<Device>(this->ctx);
     this->precondition = precondition_in;
 
@@ -63,20 +65,20 @@ DiagoDavid<T, Device>::DiagoDavid(const Real* precondition_in,
     base_device::memory::set_memory_op<Real, base_device::DEVICE_CPU>()(this->eigenvalue, 0, nbase_x);
 
     // basis(dim, nbase_x), leading dimension = dim
-    resmem_complex_op()(basis, nbase_x * dim, "DAV::basis");
+    basis = this->arena->template allocate<T>(nbase_x * dim);
     setmem_complex_op()(basis, 0, nbase_x * dim);
 
     //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
     // hpsi(nbase_x, dim); // the product of H and psi in the reduced basis set
-    resmem_complex_op()(this->hpsi, nbase_x * dim, "DAV::hpsi");
+    this->hpsi = this->arena->template allocate<T>(nbase_x * dim);
     setmem_complex_op()(this->hpsi, 0, nbase_x * dim);
 
     // spsi(nbase_x, dim); // the Product of S and psi in the reduced basis set
-    resmem_complex_op()(this->spsi, nbase_x * dim, "DAV::spsi");
+    this->spsi = this->arena->template allocate<T>(nbase_x * dim);
     setmem_complex_op()(this->spsi, 0, nbase_x * dim);
 
     // hcc(nbase_x, nbase_x); // Hamiltonian on the reduced basis
-    resmem_complex_op()(this->hcc, nbase_x * nbase_x, "DAV::hcc");
+    this->hcc = this->arena->template allocate<T>(nbase_x * nbase_x);
     setmem_complex_op()(this->hcc, 0, nbase_x * nbase_x);
 
     // scc(nbase_x, nbase_x); // Overlap on the reduced basis
@@ -84,12 +86,12 @@ DiagoDavid<T, Device>::DiagoDavid(const Real* precondition_in,
     // setmem_complex_op()(this->ctx, this->scc, 0, nbase_x * nbase_x);
 
     // vcc(nbase_x, nbase_x); // Eigenvectors of hcc
-    resmem_complex_op()(this->vcc, nbase_x * nbase_x, "DAV::vcc");
+    this->vcc = this->arena->template allocate<T>(nbase_x * nbase_x);
     setmem_complex_op()(this->vcc, 0, nbase_x * nbase_x);
     //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
     
     // lagrange_matrix(nband, nband); // for orthogonalization
-    resmem_complex_op()(this->lagrange_matrix, nband * nband);
+    this->lagrange_matrix = this->arena->template allocate<T>(nband * nband);
     setmem_complex_op()(this->lagrange_matrix, 0, nband * nband);
 
 #if defined(__CUDA) || defined(__ROCM)
@@ -105,13 +107,12 @@ DiagoDavid<T, Device>::DiagoDavid(const Real* precondition_in,
 template <typename T, typename Device>
 DiagoDavid<T, Device>::~DiagoDavid()
 {
-    delmem_complex_op()(this->basis);
-    delmem_complex_op()(this->hpsi);
-    delmem_complex_op()(this->spsi);
-    delmem_complex_op()(this->hcc);
-    // delmem_complex_op()(this->ctx, this->scc);
-    delmem_complex_op()(this->vcc);
-    delmem_complex_op()(this->lagrange_matrix);
+    this->arena->free(this->basis);
+    this->arena->free(this->hpsi);
+    this->arena->free(this->spsi);
+    this->arena->free(this->hcc);
+    this->arena->free(this->vcc);
+    this->arena->free(this->lagrange_matrix);
     base_device::memory::delete_memory_op<Real, base_device::DEVICE_CPU>()(this->eigenvalue);
     // If the device is a GPU device, free the d_precondition array.
 #if defined(__CUDA) || defined(__ROCM)
@@ -348,8 +349,7 @@ void DiagoDavid<T, Device>::cal_grad(const HPsiFunc& hpsi_func,
 
     // vc_ev_vector(notconv, nbase);
     // eigenvectors of unconverged index extracted from vcc
-    T* vc_ev_vector = nullptr;
-    resmem_complex_op()(vc_ev_vector, notconv * nbase);
+    T* vc_ev_vector = this->arena->template allocate<T>(notconv * nbase);
     setmem_complex_op()(vc_ev_vector, 0, notconv * nbase);
 
     //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
@@ -411,14 +411,13 @@ void DiagoDavid<T, Device>::cal_grad(const HPsiFunc& hpsi_func,
         if (this->device == base_device::GpuDevice)
         {
 #if defined(__CUDA) || defined(__ROCM)
-            Real* e_temp_gpu = nullptr;
-            resmem_var_op()(e_temp_gpu, nbase);
+            Real* e_temp_gpu = this->arena->template allocate<Real>(nbase);
             syncmem_var_h2d_op()(e_temp_gpu, e_temp_cpu.data(), nbase);
             ModuleBase::vector_mul_vector_op<T, Device>()(nbase,
                                                           vc_ev_vector + m * nbase,
                                                           vc_ev_vector + m * nbase,
                                                           e_temp_gpu);
-            delmem_var_op()(e_temp_gpu);
+            this->arena->free(e_temp_gpu);
 #endif
         }
         else
@@ -486,8 +485,7 @@ void DiagoDavid<T, Device>::cal_grad(const HPsiFunc& hpsi_func,
 
     // there is a nbase to nbase + notconv band orthogonalise
     // plan for SchmidtOrth
-    T* lagrange = nullptr;
-    resmem_complex_op()(lagrange, notconv * (nbase + notconv));
+    T* lagrange = this->arena->template allocate<T>(notconv * (nbase + notconv));
     setmem_complex_op()(lagrange, 0, notconv * (nbase + notconv));
 
     std::vector<int> pre_matrix_mm_m(notconv, 0);
@@ -556,8 +554,8 @@ void DiagoDavid<T, Device>::cal_grad(const HPsiFunc& hpsi_func,
     // hpsi[:, nbase:nbase+notcnv] = H basis[:, nbase:nbase+notcnv]
     hpsi_func(basis + nbase * dim, hpsi + nbase * dim, dim, notconv);
 
-    delmem_complex_op()(lagrange);
-    delmem_complex_op()(vc_ev_vector);
+    this->arena->free(lagrange);
+    this->arena->free(vc_ev_vector);
 
     ModuleBase::timer::tick("DiagoDavid", "cal_grad");
     return;
@@ -685,14 +683,13 @@ void DiagoDavid<T, Device>::diag_zhegvx(const int& nbase,
         if (this->device == base_device::GpuDevice)
         {
 #if defined(__CUDA) || defined(__ROCM)
-            Real* eigenvalue_gpu = nullptr;
-            resmem_var_op()(eigenvalue_gpu, nbase_x);
+            Real* eigenvalue_gpu = this->arena->template allocate<Real>(nbase_x);
             syncmem_var_h2d_op()(eigenvalue_gpu, this->eigenvalue, nbase_x);
 
             dnevx_op<T, Device>()(this->ctx, nbase, nbase_x, hcc, nband, eigenvalue_gpu, vcc);
 
             syncmem_var_d2h_op()(this->eigenvalue, eigenvalue_gpu, nbase_x);
-            delmem_var_op()(eigenvalue_gpu);
+            this->arena->free(eigenvalue_gpu);
 #endif
         }
         else
@@ -6,6 +6,7 @@
 #include "module_base/module_device/memory_op.h"// base_device::memory
 
 #include "module_hsolver/diag_comm_info.h"
+#include "module_hsolver/diago_arena.h"
 
 #include <vector>
 #include <functional>
@@ -44,18 +45,21 @@ class DiagoDavid
      *                      the reduced basis set before \b restart of Davidson.
      * @param[in] use_paw_in Flag indicating whether to use PAW.
      * @param[in] diag_comm_in Communication information for diagonalization.
+     * @param[in] arena_in Workspace the auxiliary memory is taken from, kept by the caller across
+     *                     k points and SCF iterations. If nullptr, the solver has its own.
      * 
      * @tparam T The data type of the matrices and arrays.
      * @tparam Device The device type (base_device::DEVICE_CPU or DEVICE_GPU).
      * 
-     * @note Auxiliary memory is allocated in the constructor and deallocated in the destructor.
+     * @note Auxiliary memory is taken from the arena in the constructor and given back in the destructor.
      */
     DiagoDavid(const Real* precondition_in,
                const int nband_in,
                const int dim_in,
                const int david_ndim_in,
                const bool use_paw_in,
-               const diag_comm_info& diag_comm_in);
+               const diag_comm_info& diag_comm_in,
+               DiagoArena<Device>* arena_in = nullptr);
 
     /**
      * @brief Destructor for the DiagoDavid class.
@@ -176,6 +180,10 @@ class DiagoDavid
 
     T* lagrange_matrix = nullptr;
 
+    /// workspace of basis, hpsi, spsi, hcc, vcc, lagrange_matrix and the temporary arrays
+    DiagoArena<Device> own_arena;
+    DiagoArena<Device>* arena = nullptr;
+
     /// device type of psi
     Device* ctx = {};
     base_device::DEVICE_CPU* cpu_ctx = {};
@@ -8,6 +8,7 @@
 #include "module_hsolver/diag_comm_info.h"
 #include "module_hsolver/diago_bpcg.h"
 #include "module_hsolver/diago_cg.h"
+#include "module_hsolver/diago_chefsi.h"
 #include "module_hsolver/diago_dav_subspace.h"
 #include "module_hsolver/diago_david.h"
 #include "module_hsolver/diago_iter_assist.h"
@@ -28,6 +29,19 @@
 namespace hsolver
 {
 
+template <typename T, typename Device>
+DiagoArena<Device> HSolverPW<T, Device>::arena;
+
+template <typename T, typename Device>
+void HSolverPW<T, Device>::release_arena(std::ofstream& ofs)
+{
+    if (arena.get_requests() > 0)
+    {
+        arena.print_stats(ofs, "HSolverPW::arena");
+    }
+    arena.release();
+}
+
 #ifdef USE_PAW
 template <typename T, typename Device>
 void HSolverPW<T, Device>::paw_func_in_kloop(const int ik, const double tpiba)
@@ -271,7 +285,7 @@ void HSolverPW<T, Device>::solve(hamilt::Hamilt<T, Device>* pHamilt,
     this->nproc_in_pool = nproc_in_pool_in;
 
     // report if the specified diagonalization method is not supported
-    const std::initializer_list<std::string> _methods = {"cg", "dav", "dav_subspace", "bpcg"};
+    const std::initializer_list<std::string> _methods = {"cg", "dav", "dav_subspace", "bpcg", "chefsi"};
     if (std::find(std::begin(_methods), std::end(_methods), this->method) == std::end(_methods))
     {
         ModuleBase::WARNING_QUIT("HSolverPW::solve", "This type of eigensolver is not supported!");
@@ -281,6 +295,14 @@ void HSolverPW<T, Device>::solve(hamilt::Hamilt<T, Device>* pHamilt,
     std::vector<Real> precondition(psi.get_nbasis(), 0.0);
     std::vector<Real> eigenvalues(this->wfc_basis->nks * psi.get_nbands(), 0.0);
     ethr_band.resize(psi.get_nbands(), this->diag_thr);
+    if (this->method == "chefsi")
+    {
+        // the eigenvalues of the last SCF step are the lower bounds of the Chebyshev filter
+        base_device::memory::cast_memory_op<Real, double, base_device::DEVICE_CPU, base_device::DEVICE_CPU>()(
+            eigenvalues.data(),
+            out_eigenvalues,
+            this->wfc_basis->nks * psi.get_nbands());
+    }
 
     /// Loop over k points for solve Hamiltonian to charge density
     for (int ik = 0; ik < this->wfc_basis->nks; ++ik)
@@ -504,7 +526,7 @@ void HSolverPW<T, Device>::hamiltSolvePsiK(hamilt::Hamilt<T, Device>* hm,
 
             ModuleBase::timer::tick("diago_bpcg", "hpsi_func");
         };
-        DiagoBPCG<T, Device> bpcg(pre_condition.data());
+        DiagoBPCG<T, Device> bpcg(pre_condition.data(), &arena);
         bpcg.init_iter(PARAM.inp.nbands, nband_l, nbasis, ndim);
         bpcg.diag(hpsi_func, psi.get_pointer(), eigenvalue, this->ethr_band);
     }
@@ -537,11 +559,41 @@ void HSolverPW<T, Device>::hamiltSolvePsiK(hamilt::Hamilt<T, Device>* hm,
                                                   this->need_subspace,
                                                   comm_info,
                                                   PARAM.inp.diag_subspace,
-                                                  PARAM.inp.nb2d);
+                                                  PARAM.inp.nb2d,
+                                                  &arena);
 
         DiagoIterAssist<T, Device>::avg_iter += static_cast<double>(
             dav_subspace.diag(hpsi_func, psi.get_pointer(), psi.get_nbasis(), eigenvalue, this->ethr_band, scf));
     }
+    else if (this->method == "chefsi")
+    {
+        // hpsi_func (X, HX, ld, nvec) -> HX = H(X), X and HX blockvectors of size ld x nvec
+        auto hpsi_func = [hm, cur_nbasis](T* psi_in, T* hpsi_out, const int ld_psi, const int nvec) {
+            ModuleBase::timer::tick("DiagoChebFSI", "hpsi_func");
+
+            // Convert "pointer data stucture" to a psi::Psi object
+            auto psi_iter_wrapper = psi::Psi<T, Device>(psi_in, 1, nvec, ld_psi, cur_nbasis);
+
+            psi::Range bands_range(true, 0, 0, nvec - 1);
+
+            using hpsi_info = typename hamilt::Operator<T, Device>::hpsi_info;
+            hpsi_info info(&psi_iter_wrapper, bands_range, hpsi_out);
+            hm->ops->hPsi(info);
+
+            ModuleBase::timer::tick("DiagoChebFSI", "hpsi_func");
+        };
+        bool scf = this->calculation_type == "nscf" ? false : true;
+
+        DiagoChebFSI<T, Device> chefsi(psi.get_nbands(),
+                                       psi.get_k_first() ? psi.get_current_ngk() : psi.get_nk() * psi.get_nbasis(),
+                                       PARAM.inp.pw_diag_cheb_degree,
+                                       this->diag_thr,
+                                       this->diag_iter_max,
+                                       comm_info);
+
+        DiagoIterAssist<T, Device>::avg_iter += static_cast<double>(
+            chefsi.diag(hpsi_func, psi.get_pointer(), psi.get_nbasis(), eigenvalue, this->ethr_band, scf));
+    }
     else if (this->method == "dav")
     {
         // Davidson iter parameters
@@ -594,7 +646,13 @@ void HSolverPW<T, Device>::hamiltSolvePsiK(hamilt::Hamilt<T, Device>* hm,
             ModuleBase::timer::tick("David", "spsi_func");
         };
 
-        DiagoDavid<T, Device> david(pre_condition.data(), nband, dim, PARAM.inp.pw_diag_ndim, this->use_paw, comm_info);
+        DiagoDavid<T, Device> david(pre_condition.data(),
+                                    nband,
+                                    dim,
+                                    PARAM.inp.pw_diag_ndim,
+                                    this->use_paw,
+                                    comm_info,
+                                    &arena);
         // do diag and add davidson iteration counts up to avg_iter
         DiagoIterAssist<T, Device>::avg_iter += static_cast<double>(david.diag(hpsi_func,
                                                                                spsi_func,
@@ -5,6 +5,7 @@
 #include "module_hamilt_general/hamilt.h"
 #include "module_base/macros.h"
 #include "module_basis/module_pw/pw_basis_k.h"
+#include "module_hsolver/diago_arena.h"
 
 namespace hsolver
 {
@@ -50,6 +51,9 @@ class HSolverPW
                const double tpiba,
                const int nat);
 
+    /// print the statistics of the workspace of the eigensolvers and free it, at the end of the calculation
+    static void release_arena(std::ofstream& ofs);
+
   protected:
     // diago caller
     void hamiltSolvePsiK(hamilt::Hamilt<T, Device>* hm,
@@ -86,6 +90,10 @@ class HSolverPW
 
     std::vector<double> ethr_band;
 
+    /// workspace of dav, dav_subspace and bpcg, kept across k points and SCF iterations since
+    /// HSolverPW and the solvers are constructed again for each of them
+    static DiagoArena<Device> arena;
+
   private:
     /// @brief calculate the threshold for iterative-diagonalization for each band
     void cal_smooth_ethr(const double& wk, const double* wg, const double& ethr, std::vector<double>& ethrs);
@@ -0,0 +1,76 @@
+#include "module_hsolver/diago_arena.h"
+
+#include <ATen/core/tensor.h>
+#include <gtest/gtest.h>
+
+#include <complex>
+
+/**
+ * Tests of the workspace arena of the eigensolvers:
+ *  - the blocks freed are given again to the requests that fit
+ *  - a block much larger than the request is not taken
+ *  - the tensors of DiagoArenaAllocator take their memory from the arena
+ */
+
+TEST(DiagoArenaTest, ReuseBlocks)
+{
+    hsolver::DiagoArena<base_device::DEVICE_CPU> arena;
+    // the workspace of two k points with the same number of plane waves, as a solver per k point does
+    for (int ik = 0; ik < 2; ik++)
+    {
+        std::complex<double>* basis = arena.allocate<std::complex<double>>(1000);
+        std::complex<double>* hpsi = arena.allocate<std::complex<double>>(1000);
+        double* eigenvalue = arena.allocate<double>(10);
+        basis[999] = hpsi[999] = 1.0;
+        eigenvalue[9] = 1.0;
+        arena.free(basis);
+        arena.free(hpsi);
+        arena.free(eigenvalue);
+    }
+    EXPECT_EQ(arena.get_requests(), 6);
+    EXPECT_EQ(arena.get_allocations(), 3);
+    EXPECT_EQ(arena.get_peak_bytes(), 2000 * sizeof(std::complex<double>) + 10 * sizeof(double));
+
+    // a smaller k point takes the blocks of the larger one
+    std::complex<double>* basis = arena.allocate<std::complex<double>>(900);
+    EXPECT_EQ(arena.get_allocations(), 3);
+    arena.free(basis);
+
+    // a larger k point replaces the cached blocks too small for it
+    basis = arena.allocate<std::complex<double>>(1200);
+    EXPECT_EQ(arena.get_allocations(), 4);
+    EXPECT_EQ(arena.get_peak_bytes(), 2200 * sizeof(std::complex<double>) + 10 * sizeof(double));
+    arena.free(basis);
+
+    arena.free(nullptr);
+    arena.release();
+    EXPECT_EQ(arena.get_requests(), 8);
+}
+
+TEST(DiagoArenaTest, NoLargeBlockForSmallRequest)
+{
+    hsolver::DiagoArena<base_device::DEVICE_CPU> arena;
+    double* large = arena.allocate<double>(1000);
+    arena.free(large);
+    double* small = arena.allocate<double>(10);
+    EXPECT_NE(small, large);
+    EXPECT_EQ(arena.get_allocations(), 2);
+    arena.free(small);
+}
+
+TEST(DiagoArenaTest, TensorAllocator)
+{
+    hsolver::DiagoArena<base_device::DEVICE_CPU> arena;
+    for (int iter = 0; iter < 3; iter++)
+    {
+        ct::Tensor hsub(new hsolver::DiagoArenaAllocator<base_device::DEVICE_CPU>(&arena),
+                        ct::DataType::DT_COMPLEX_DOUBLE,
+                        ct::DeviceType::CpuDevice,
+                        ct::TensorShape({8, 8}));
+        EXPECT_EQ(hsub.NumElements(), 64);
+        hsub.zero();
+        EXPECT_EQ(hsub.data<std::complex<double>>()[63], std::complex<double>(0.0, 0.0));
+    }
+    EXPECT_EQ(arena.get_requests(), 3);
+    EXPECT_EQ(arena.get_allocations(), 1);
+}
@@ -0,0 +1,271 @@
+#include "module_base/blas_connector.h"
+#include "module_base/lapack_connector.h"
+#include "module_base/parallel_comm.h"
+#include "module_hsolver/diago_chefsi.h"
+#include "module_hsolver/diago_david.h"
+
+#include "gtest/gtest.h"
+#include "mpi.h"
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/************************************************
+ *  unit test of class DiagoChebFSI
+ ***********************************************/
+
+/**
+ * The Hamiltonian is a model of plane waves, H = T + V, T is diagonal and increases quadratically
+ * like the kinetic energy, V is a dense random Hermitian matrix.
+ * - nscf: the eigenvalues from random psi are compared with those calculated by LAPACK
+ * - scf: only one filter and Rayleigh-Ritz step is done if the eigenvalues of the last step are given,
+ *   and the eigenvalues get closer to the exact ones step by step
+ * - cost of one SCF step compared with DiagoDavid for different number of bands
+ */
+
+namespace
+{
+using T = std::complex<double>;
+
+class ModelHamilt
+{
+  public:
+    // the random numbers of V are the same for different v_in
+    ModelHamilt(const int npw_in, const double v_in = 0.3) : npw(npw_in), h(npw_in * npw_in)
+    {
+        std::mt19937 gen(1);
+        std::uniform_real_distribution<double> dis(-1.0, 1.0);
+        for (int i = 0; i < npw; ++i)
+        {
+            const double g = std::cbrt(static_cast<double>(i));
+            h[i * npw + i] = g * g + v_in * dis(gen);
+            for (int j = 0; j < i; ++j)
+            {
+                const T v = v_in / std::sqrt(static_cast<double>(npw)) * T(dis(gen), dis(gen));
+                h[i * npw + j] = v;
+                h[j * npw + i] = std::conj(v);
+            }
+        }
+    }
+
+    // hpsi = H * psi, psi[ib * ld + ig]
+    void hpsi(const T* psi, T* hpsi, const int ld, const int nvec)
+    {
+        const T one = 1.0, zero = 0.0;
+        zgemm_("N", "N", &npw, &nvec, &npw, &one, h.data(), &npw, psi, &ld, &zero, hpsi, &ld);
+        ++ncall;
+        nvec_total += nvec;
+    }
+
+    // the eigenvalues, and the eigenvectors in vec if given
+    std::vector<double> eigenvalues(std::vector<T>* vec = nullptr) const
+    {
+        std::vector<T> a = h;
+        std::vector<double> e(npw);
+        int lwork = 2 * npw;
+        std::vector<T> work(lwork);
+        std::vector<double> rwork(3 * npw - 2);
+        int info = 0;
+        int n = npw;
+        zheev_(vec ? "V" : "N", "U", &n, a.data(), &n, e.data(), work.data(), &lwork, rwork.data(), &info);
+        if (vec)
+        {
+            *vec = a;
+        }
+        return e;
+    }
+
+    std::vector<T> random_psi(const int nband) const
+    {
+        std::mt19937 gen(2);
+        std::uniform_real_distribution<double> dis(-1.0, 1.0);
+        std::vector<T> psi(nband * npw);
+        for (int ib = 0; ib < nband; ++ib)
+        {
+            for (int ig = 0; ig < npw; ++ig)
+            {
+                psi[ib * npw + ig] = T(dis(gen), dis(gen)) / (1.0 + ig);
+            }
+        }
+        return psi;
+    }
+
+    int npw;
+    std::vector<T> h;
+    int ncall = 0;
+    long long nvec_total = 0;
+};
+
+const hsolver::diag_comm_info comm_info = {MPI_COMM_SELF, 0, 1};
+} // namespace
+
+TEST(DiagoChebFSITest, NSCF)
+{
+    const int npw = 300;
+    const int nband = 20;
+    ModelHamilt hm(npw);
+    const std::vector<double> e_lapack = hm.eigenvalues();
+
+    std::vector<T> psi = hm.random_psi(nband);
+    std::vector<double> e(nband, 0.0);
+    const std::vector<double> ethr_band(nband, 1e-10);
+    auto hpsi_func = [&hm](T* psi_in, T* hpsi_out, const int ld_psi, const int nvec) {
+        hm.hpsi(psi_in, hpsi_out, ld_psi, nvec);
+    };
+    // block size smaller than nband
+    hsolver::DiagoChebFSI<T> chefsi(nband, npw, 10, 1e-10, 100, comm_info, 8);
+    const int niter = chefsi.diag(hpsi_func, psi.data(), npw, e.data(), ethr_band, false);
+    EXPECT_LT(niter, 100);
+    for (int ib = 0; ib < nband; ++ib)
+    {
+        EXPECT_NEAR(e[ib], e_lapack[ib], 1e-8);
+    }
+
+    // the eigenvectors are orthonormal and H psi = e psi
+    std::vector<T> hpsi(nband * npw);
+    hm.hpsi(psi.data(), hpsi.data(), npw, nband);
+    for (int ib = 0; ib < nband; ++ib)
+    {
+        double res = 0.0;
+        for (int ig = 0; ig < npw; ++ig)
+        {
+            res += std::norm(hpsi[ib * npw + ig] - e[ib] * psi[ib * npw + ig]);
+        }
+        EXPECT_LT(std::sqrt(res), 1e-3);
+        for (int jb = 0; jb <= ib; ++jb)
+        {
+            T s = 0.0;
+            for (int ig = 0; ig < npw; ++ig)
+            {
+                s += std::conj(psi[jb * npw + ig]) * psi[ib * npw + ig];
+            }
+            EXPECT_NEAR(std::abs(s), ib == jb ? 1.0 : 0.0, 1e-8);
+        }
+    }
+}
+
+TEST(DiagoChebFSITest, SCF)
+{
+    const int npw = 300;
+    const int nband = 20;
+    ModelHamilt hm(npw);
+    const std::vector<double> e_lapack = hm.eigenvalues();
+
+    std::vector<T> psi = hm.random_psi(nband);
+    std::vector<double> e(nband, 0.0);
+    const std::vector<double> ethr_band(nband, 1e-2);
+    auto hpsi_func = [&hm](T* psi_in, T* hpsi_out, const int ld_psi, const int nvec) {
+        hm.hpsi(psi_in, hpsi_out, ld_psi, nvec);
+    };
+
+    // the first SCF step iterates until converged to the loose threshold
+    {
+        hsolver::DiagoChebFSI<T> chefsi(nband, npw, 8, 1e-2, 50, comm_info);
+        chefsi.diag(hpsi_func, psi.data(), npw, e.data(), ethr_band, true);
+    }
+    double err_last = 0.0;
+    for (int ib = 0; ib < nband; ++ib)
+    {
+        err_last += e[ib] - e_lapack[ib];
+    }
+    for (int istep = 0; istep < 8; ++istep)
+    {
+        hsolver::DiagoChebFSI<T> chefsi(nband, npw, 8, 1e-2, 50, comm_info);
+        EXPECT_EQ(chefsi.diag(hpsi_func, psi.data(), npw, e.data(), ethr_band, true), 1);
+        double err = 0.0;
+        for (int ib = 0; ib < nband; ++ib)
+        {
+            // Ritz values are upper bounds of the eigenvalues
+            EXPECT_GT(e[ib], e_lapack[ib] - 1e-8);
+            err += e[ib] - e_lapack[ib];
+        }
+        EXPECT_LE(err, err_last + 1e-10);
+        err_last = err;
+    }
+    EXPECT_LT(err_last, 1e-5);
+}
+
+// one SCF step: H changes a little, the bands and eigenvalues of the last H are given,
+// compare one ChFSI step with Davidson converged to the threshold of a late SCF step
+TEST(DiagoChebFSITest, CostCompareWithDavid)
+{
+    const int npw = 1000;
+    const double ethr = 1e-6;
+    ModelHamilt hm_last(npw, 0.3);
+    ModelHamilt hm(npw, 0.31);
+    std::vector<T> vec_last;
+    const std::vector<double> e_last = hm_last.eigenvalues(&vec_last);
+    const std::vector<double> e_exact = hm.eigenvalues();
+    std::vector<double> precondition(npw);
+    for (int ig = 0; ig < npw; ++ig)
+    {
+        precondition[ig] = std::max(1.0, std::real(hm.h[ig * npw + ig]));
+    }
+    auto hpsi_func = [&hm](T* psi_in, T* hpsi_out, const int ld_psi, const int nvec) {
+        hm.hpsi(psi_in, hpsi_out, ld_psi, nvec);
+    };
+    auto spsi_func = [npw](const T* psi_in, T* spsi_out, const int ld_psi, const int nvec) {
+        for (int ib = 0; ib < nvec; ++ib)
+        {
+            std::copy(psi_in + ib * ld_psi, psi_in + ib * ld_psi + npw, spsi_out + ib * ld_psi);
+        }
+    };
+
+    // real systems have 1k-10k bands, which is too expensive for a unit test,
+    // nband/npw of the same order is used here
+    for (const int nband: {25, 50, 100})
+    {
+        const std::vector<double> ethr_band(nband, ethr);
+
+        std::vector<T> psi_dav(vec_last.begin(), vec_last.begin() + nband * npw);
+        std::vector<double> e_dav(e_last.begin(), e_last.begin() + nband);
+        hm.nvec_total = 0;
+        auto t0 = std::chrono::high_resolution_clock::now();
+        hsolver::DiagoDavid<T> dav(precondition.data(), nband, npw, 4, false, comm_info);
+        dav.diag(hpsi_func, spsi_func, npw, psi_dav.data(), e_dav.data(), ethr_band, 50);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        const long long nhpsi_dav = hm.nvec_total;
+
+        std::vector<T> psi_chefsi(vec_last.begin(), vec_last.begin() + nband * npw);
+        std::vector<double> e_chefsi(e_last.begin(), e_last.begin() + nband);
+        hm.nvec_total = 0;
+        auto t2 = std::chrono::high_resolution_clock::now();
+        hsolver::DiagoChebFSI<T> chefsi(nband, npw, 10, ethr, 50, comm_info);
+        EXPECT_EQ(chefsi.diag(hpsi_func, psi_chefsi.data(), npw, e_chefsi.data(), ethr_band, true), 1);
+        auto t3 = std::chrono::high_resolution_clock::now();
+        const long long nhpsi_chefsi = hm.nvec_total;
+
+        double err_dav = 0.0;
+        double err_chefsi = 0.0;
+        for (int ib = 0; ib < nband; ++ib)
+        {
+            err_dav = std::max(err_dav, std::abs(e_dav[ib] - e_exact[ib]));
+            err_chefsi = std::max(err_chefsi, std::abs(e_chefsi[ib] - e_exact[ib]));
+        }
+        EXPECT_LT(err_dav, 1e-4);
+        EXPECT_LT(err_chefsi, 1e-4);
+        std::cout << "nband: " << nband << ", npw: " << npw
+                  << ", david: " << std::chrono::duration_cast<std::chrono::duration<double>>(t1 - t0).count()
+                  << " s, " << nhpsi_dav << " H*psi, error " << err_dav
+                  << ", chefsi: " << std::chrono::duration_cast<std::chrono::duration<double>>(t3 - t2).count()
+                  << " s, " << nhpsi_chefsi << " H*psi, error " << err_chefsi << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    // each process solves the whole problem
+    MPI_Comm_dup(MPI_COMM_SELF, &POOL_WORLD);
+
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+
+    MPI_Comm_free(&POOL_WORLD);
+    MPI_Finalize();
+    return result;
+}
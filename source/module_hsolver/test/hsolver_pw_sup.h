@@ -125,7 +125,8 @@ DiagoDavid<T, Device>::DiagoDavid(const Real* precondition_in,
                                   const int dim_in,
                                   const int david_ndim_in,
                                   const bool use_paw_in,
-                                  const diag_comm_info& diag_comm_in)
+                                  const diag_comm_info& diag_comm_in,
+                                  DiagoArena<Device>* arena_in)
     : nband(nband_in), dim(dim_in), nbase_x(david_ndim_in * nband_in), david_ndim(david_ndim_in), use_paw(use_paw_in), diag_comm(diag_comm_in) {
     this->device = base_device::get_device_type<Device>(this->ctx);
     this->precondition = precondition_in;
@@ -127,10 +127,21 @@ void ReadInput::read_parameters(Parameter& param, const std::string& filename_in
 
     // 3. broadcast input parameters
     // It must be after the check_ntype, because some parameters need to be filled due to ntype
+#ifdef __MPI
+    // rank 0 packs all the parameters in one buffer, which is broadcast at once
+    Parallel_Common::Bcast_Buffer buffer;
+    buffer.bcast_with([&](Parallel_Common::Bcast_Buffer& b) {
+        for (auto& bcastfunc: this->bcastfuncs)
+        {
+            bcastfunc(param, b);
+        }
+    });
+#else
     for (auto& bcastfunc: this->bcastfuncs)
     {
         bcastfunc(param);
     }
+#endif
 
     // 4. set the globalv parameters, some parameters in different processes are different. e.g. rank, log_file
     this->set_globalv(param.inp, param.sys);
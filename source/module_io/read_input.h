@@ -3,6 +3,9 @@
 
 #include "input_item.h"
 #include "module_parameter/parameter.h"
+#ifdef __MPI
+#include "module_base/parallel_common.h"
+#endif
 
 #include <string>
 
@@ -138,7 +141,12 @@ class ReadInput
     // bcast all values function
     // if no MPI, this function will resize the vector
     // This function must be done, no matter INPUT file has them or not.
+#ifdef __MPI
+    // they sync the values with one buffer, which is broadcast once for all of them
+    std::vector<std::function<void(Parameter&, Parallel_Common::Bcast_Buffer&)>> bcastfuncs;
+#else
     std::vector<std::function<void(Parameter&)>> bcastfuncs;
+#endif
 };
 
 // convert string vector to a long string
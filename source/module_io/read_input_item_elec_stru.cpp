@@ -62,7 +62,7 @@ void ReadInput::item_elec_stru()
         };
         item.check_value = [](const Input_Item& item, const Parameter& para) {
             const std::string& ks_solver = para.input.ks_solver;
-            const std::vector<std::string> pw_solvers = {"cg", "dav", "bpcg", "dav_subspace"};
+            const std::vector<std::string> pw_solvers = {"cg", "dav", "bpcg", "dav_subspace", "chefsi"};
             const std::vector<std::string> lcao_solvers = {
                 "genelpa",
                 "elpa",
@@ -327,6 +327,18 @@ void ReadInput::item_elec_stru()
         read_sync_int(input.pw_diag_ndim);
         this->add_item(item);
     }
+    {
+        Input_Item item("pw_diag_cheb_degree");
+        item.annotation = "degree of the Chebyshev filter in chefsi";
+        read_sync_int(input.pw_diag_cheb_degree);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.pw_diag_cheb_degree <= 0)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "pw_diag_cheb_degree should be greater than 0");
+            }
+        };
+        this->add_item(item);
+    }
     {
         Input_Item item("diago_cg_prec");
         item.annotation = "diago_cg_prec";
@@ -692,6 +704,18 @@ void ReadInput::item_elec_stru()
         read_sync_double(input.lcao_rmax);
         this->add_item(item);
     }
+    {
+        Input_Item item("lcao_table_cache_dir");
+        item.annotation = "directory to cache the two-center integral tables, none for no cache";
+        read_sync_string(input.lcao_table_cache_dir);
+        item.reset_value = [](const Input_Item& item, Parameter& para) {
+            if (para.input.lcao_table_cache_dir != "none")
+            {
+                para.input.lcao_table_cache_dir = to_dir(para.input.lcao_table_cache_dir);
+            }
+        };
+        this->add_item(item);
+    }
     {
         Input_Item item("search_radius");
         item.annotation = "input search radius (Bohr)";
@@ -704,6 +728,18 @@ void ReadInput::item_elec_stru()
         read_sync_bool(input.search_pbc);
         this->add_item(item);
     }
+    {
+        Input_Item item("search_skin");
+        item.annotation = "Verlet skin to reuse the adjacent atoms between ionic steps (Bohr)";
+        read_sync_double(input.search_skin);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.search_skin < 0.0)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "search_skin must >= 0");
+            }
+        };
+        this->add_item(item);
+    }
     {
         Input_Item item("bx");
         item.annotation = "division of an element grid in FFT grid along x";
@@ -308,6 +308,30 @@ void ReadInput::item_exx()
         read_sync_bool(input.out_ri_cv);
         this->add_item(item);
     }
+    {
+        Input_Item item("exx_cv_cache_memory");
+        item.annotation = "maximal memory (MB) of each cache of V, C, dV, dC in exx, 0 for no limit";
+        read_sync_double(input.exx_cv_cache_memory);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.exx_cv_cache_memory < 0)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "exx_cv_cache_memory must >= 0");
+            }
+        };
+        this->add_item(item);
+    }
+    {
+        Input_Item item("exx_cv_reuse_tol");
+        item.annotation = "reuse V, C, dV, dC of the atom pairs moved less than it (Bohr) in exx, 0 for no reuse";
+        read_sync_double(input.exx_cv_reuse_tol);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.exx_cv_reuse_tol < 0)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "exx_cv_reuse_tol must >= 0");
+            }
+        };
+        this->add_item(item);
+    }
 }
 void ReadInput::item_dftu()
 {
@@ -366,8 +366,9 @@ void ReadInput::item_model()
                              << para.input.vdw_cutoff_period[2];
         };
 #ifdef __MPI
-        bcastfuncs.push_back(
-            [](Parameter& para) { Parallel_Common::bcast_int((int*)&para.input.vdw_cutoff_period, 3); });
+        bcastfuncs.push_back([](Parameter& para, Parallel_Common::Bcast_Buffer& buffer) {
+            buffer.sync((int*)&para.input.vdw_cutoff_period, 3);
+        });
 #endif
         this->add_item(item);
     }
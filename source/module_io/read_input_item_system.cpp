@@ -489,8 +489,79 @@ void ReadInput::item_system()
     }
     {
         Input_Item item("fft_mode");
-        item.annotation = "mode of FFTW";
+        item.annotation = "mode of FFTW, +4 to overlap the transposes with the z-FFT";
         read_sync_int(input.fft_mode);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.fft_mode < 0 || para.input.fft_mode > 7)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "fft_mode should be in [0, 7]");
+            }
+        };
+        this->add_item(item);
+    }
+    {
+        Input_Item item("fft_batch");
+        item.annotation = "number of bands transformed together by the batched FFT of wave functions";
+        read_sync_int(input.fft_batch);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.fft_batch < 1)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "fft_batch should be a positive integer");
+            }
+        };
+        this->add_item(item);
+    }
+    {
+        Input_Item item("nl_realspace");
+        item.annotation = "apply the nonlocal pseudopotential on the real-space grid";
+        read_sync_bool(input.nl_realspace);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (!para.input.nl_realspace)
+            {
+                return;
+            }
+            if (para.input.basis_type != "pw")
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "nl_realspace is only available for the pw basis");
+            }
+            if (para.input.device == "gpu")
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "nl_realspace is not available on GPU");
+            }
+            if (para.input.noncolin || para.input.lspinorb || para.input.use_paw)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "nl_realspace is not available for noncolin, lspinorb or PAW");
+            }
+            // the stochastic forces and stress use the G-space projectors, not consistent with the energy
+            if (para.input.esolver_type == "sdft" && (para.input.cal_force || para.input.cal_stress))
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "nl_realspace is not available for the forces and stress of sdft");
+            }
+        };
+        this->add_item(item);
+    }
+    {
+        Input_Item item("nl_realspace_radius");
+        item.annotation = "radius of the real-space projectors, in units of the cutoff radius of beta";
+        read_sync_double(input.nl_realspace_radius);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.nl_realspace_radius < 1.0)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "nl_realspace_radius should be no less than 1");
+            }
+        };
+        this->add_item(item);
+    }
+    {
+        Input_Item item("nl_realspace_qratio");
+        item.annotation = "the real-space projectors go to zero at nl_realspace_qratio * sqrt(ecutwfc) in q";
+        read_sync_double(input.nl_realspace_qratio);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.nl_realspace_qratio <= 1.0)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "nl_realspace_qratio should be larger than 1");
+            }
+        };
         this->add_item(item);
     }
     {
@@ -11,50 +11,55 @@
 #define boolvalue assume_as_boolean(item.str_values[0])
 
 #ifdef __MPI
+// the values are packed in one buffer and broadcast at once, see Parallel_Common::Bcast_Buffer
 #define add_double_bcast(PARAMETER)                                                                                    \
     {                                                                                                                  \
-        bcastfuncs.push_back([](Parameter& para) { Parallel_Common::bcast_double(para.PARAMETER); });                  \
+        bcastfuncs.push_back(                                                                                          \
+            [](Parameter& para, Parallel_Common::Bcast_Buffer& buffer) { buffer.sync(para.PARAMETER); });              \
     }
 #define add_int_bcast(PARAMETER)                                                                                       \
     {                                                                                                                  \
-        bcastfuncs.push_back([](Parameter& para) { Parallel_Common::bcast_int(para.PARAMETER); });                     \
+        bcastfuncs.push_back(                                                                                          \
+            [](Parameter& para, Parallel_Common::Bcast_Buffer& buffer) { buffer.sync(para.PARAMETER); });              \
     }
 #define add_bool_bcast(PARAMETER)                                                                                      \
     {                                                                                                                  \
-        bcastfuncs.push_back([](Parameter& para) { Parallel_Common::bcast_bool(para.PARAMETER); });                    \
+        bcastfuncs.push_back(                                                                                          \
+            [](Parameter& para, Parallel_Common::Bcast_Buffer& buffer) { buffer.sync(para.PARAMETER); });              \
     }
 #define add_string_bcast(PARAMETER)                                                                                    \
     {                                                                                                                  \
-        bcastfuncs.push_back([](Parameter& para) { Parallel_Common::bcast_string(para.PARAMETER); });                  \
+        bcastfuncs.push_back(                                                                                          \
+            [](Parameter& para, Parallel_Common::Bcast_Buffer& buffer) { buffer.sync(para.PARAMETER); });              \
     }
 #define add_doublevec_bcast(PARAMETER, N, FILL)                                                                        \
     {                                                                                                                  \
-        bcastfuncs.push_back([](Parameter& para) {                                                                     \
+        bcastfuncs.push_back([](Parameter& para, Parallel_Common::Bcast_Buffer& buffer) {                              \
             int _vec_size = N;                                                                                         \
-            Parallel_Common::bcast_int(_vec_size);                                                                     \
+            buffer.sync(_vec_size);                                                                                    \
             if (para.PARAMETER.size() != _vec_size)                                                                    \
                 para.PARAMETER.resize(_vec_size, FILL);                                                                \
-            Parallel_Common::bcast_double(para.PARAMETER.data(), _vec_size);                                           \
+            buffer.sync(para.PARAMETER.data(), _vec_size);                                                             \
         });                                                                                                            \
     }
 #define add_intvec_bcast(PARAMETER, N, FILL)                                                                           \
     {                                                                                                                  \
-        bcastfuncs.push_back([](Parameter& para) {                                                                     \
+        bcastfuncs.push_back([](Parameter& para, Parallel_Common::Bcast_Buffer& buffer) {                              \
             int _vec_size = N;                                                                                         \
-            Parallel_Common::bcast_int(_vec_size);                                                                     \
+            buffer.sync(_vec_size);                                                                                    \
             if (para.PARAMETER.size() != _vec_size)                                                                    \
                 para.PARAMETER.resize(_vec_size, FILL);                                                                \
-            Parallel_Common::bcast_int(para.PARAMETER.data(), _vec_size);                                              \
+            buffer.sync(para.PARAMETER.data(), _vec_size);                                                             \
         });                                                                                                            \
     }
 #define add_stringvec_bcast(PARAMETER, N, FILL)                                                                        \
     {                                                                                                                  \
-        bcastfuncs.push_back([](Parameter& para) {                                                                     \
+        bcastfuncs.push_back([](Parameter& para, Parallel_Common::Bcast_Buffer& buffer) {                              \
             int _vec_size = N;                                                                                         \
-            Parallel_Common::bcast_int(_vec_size);                                                                     \
+            buffer.sync(_vec_size);                                                                                    \
             if (para.PARAMETER.size() != _vec_size)                                                                    \
                 para.PARAMETER.resize(_vec_size, FILL);                                                                \
-            Parallel_Common::bcast_string(para.PARAMETER.data(), _vec_size);                                           \
+            buffer.sync(para.PARAMETER.data(), _vec_size);                                                             \
         });                                                                                                            \
     }
 
@@ -9,6 +9,129 @@
 #include "module_base/timer.h"
 #include "module_base/vector3.h"
 
+#include <algorithm>
+#include <vector>
+
+#ifdef __MPI
+namespace
+{
+/**
+ * @brief read the bands of k point ik from a binary file written by write_wfc_pw, by MPI-IO
+ *
+ * All the processes read at the same time, each one reads only its own plane waves, which are found
+ * in the file by the miller indices. So the file can be read by any number of processes, no matter
+ * how many processes wrote it. The file view picks the local plane waves out of the band records and
+ * the memory type puts them at their places in wfc, so nothing is copied. The bands are read one by
+ * one, each call reads npol * npwk complex numbers, which keeps the count far below INT_MAX.
+ */
+void read_wfc_pw_mpiio(const std::string& filename,
+                       const ModulePW::PW_Basis_K* pw_wfc,
+                       const int ik,
+                       const ModuleBase::Vector3<int>* miller,
+                       const int npwtot,
+                       const int nbands,
+                       ModuleBase::ComplexMatrix& wfc)
+{
+    const int ny = pw_wfc->ny;
+    const int nz = pw_wfc->nz;
+    const int npwk_max = pw_wfc->npwk_max;
+    const int npol = PARAM.globalv.npol;
+    const int npwk = pw_wfc->npwk[ik];
+
+    // global index and local index of the local plane waves, sorted by the global index
+    std::vector<std::pair<int, int>> g2l_pw(npwk);
+    for (int i = 0; i < npwk; ++i)
+    {
+        int isz = pw_wfc->igl2isz_k[ik * npwk_max + i];
+        int iz = isz % nz;
+        int is = isz / nz;
+        int ixy = pw_wfc->is2fftixy[is];
+        g2l_pw[i] = std::make_pair(ixy * nz + iz, i);
+    }
+    std::sort(g2l_pw.begin(), g2l_pw.end());
+
+    // the position of the local plane waves in the file
+    std::vector<int> ig_file(npwk, -1);
+    for (int i = 0; i < npwtot; ++i)
+    {
+        const int index = (miller[i].x * ny + miller[i].y) * nz + miller[i].z;
+        const auto it = std::lower_bound(g2l_pw.begin(), g2l_pw.end(), std::make_pair(index, 0));
+        if (it != g2l_pw.end() && it->first == index)
+        {
+            ig_file[it->second] = i;
+        }
+    }
+    if (std::count(ig_file.begin(), ig_file.end(), -1) > 0)
+    {
+        ModuleBase::WARNING_QUIT("ModuleIO::read_wfc_pw", "plane waves are not found in file " + filename);
+    }
+
+    // the local plane waves in the order of the file
+    std::vector<int> order(npwk);
+    for (int i = 0; i < npwk; ++i)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&ig_file](const int a, const int b) { return ig_file[a] < ig_file[b]; });
+
+    // records of the header and the reciprocal lattice vectors are 72B, see write_wfc_pw
+    const MPI_Offset isize = sizeof(int);
+    const MPI_Offset csize = sizeof(std::complex<double>);
+    const MPI_Offset band_offset = 2 * (72 + 2 * isize) + 2 * isize + 3 * isize * npwtot;
+    const MPI_Offset band_size = 2 * isize + csize * npwtot * npol;
+
+    // the view of the file: local plane waves of one component, npol components of one band, all the bands;
+    // the memory type of one band: the same plane waves at their local places, npol components
+    MPI_Datatype file_view = MPI_BYTE;
+    MPI_Datatype band_mem = MPI_BYTE;
+    int count = 0;
+    if (npwk > 0)
+    {
+        std::vector<MPI_Aint> displs(npwk);
+        MPI_Datatype pw_type, band_type;
+        for (int i = 0; i < npwk; ++i)
+        {
+            displs[i] = ig_file[order[i]] * csize;
+        }
+        MPI_Type_create_hindexed_block(npwk, 2, displs.data(), MPI_DOUBLE, &pw_type);
+        MPI_Type_create_hvector(npol, 1, csize * npwtot, pw_type, &band_type);
+        MPI_Type_create_hvector(nbands, 1, band_size, band_type, &file_view);
+        MPI_Type_commit(&file_view);
+        MPI_Type_free(&pw_type);
+        MPI_Type_free(&band_type);
+
+        for (int i = 0; i < npwk; ++i)
+        {
+            displs[i] = order[i] * csize;
+        }
+        MPI_Type_create_hindexed_block(npwk, 2, displs.data(), MPI_DOUBLE, &pw_type);
+        MPI_Type_create_hvector(npol, 1, csize * npwk_max, pw_type, &band_mem);
+        MPI_Type_commit(&band_mem);
+        MPI_Type_free(&pw_type);
+        count = 1;
+    }
+
+    MPI_File fh;
+    if (MPI_File_open(POOL_WORLD, filename.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+    {
+        ModuleBase::WARNING_QUIT("ModuleIO::read_wfc_pw", "Can't open file " + filename);
+    }
+    MPI_File_set_view(fh, band_offset + isize, MPI_BYTE, file_view, "native", MPI_INFO_NULL);
+    for (int ib = 0; ib < nbands; ib++)
+    {
+        MPI_File_read_all(fh, &wfc(ib, 0), count, band_mem, MPI_STATUS_IGNORE);
+    }
+    MPI_File_close(&fh);
+
+    if (npwk > 0)
+    {
+        MPI_Type_free(&file_view);
+        MPI_Type_free(&band_mem);
+    }
+}
+} // namespace
+#endif
+
 void ModuleIO::read_wfc_pw(const std::string& filename,
                            const ModulePW::PW_Basis_K* pw_wfc,
                            const int& ik,
@@ -184,7 +307,25 @@ void ModuleIO::read_wfc_pw(const std::string& filename,
             }
             rfs >> size;
         }
+    }
 
+#ifdef __MPI
+    if (filetype == "dat")
+    {
+        if (GlobalV::RANK_IN_POOL == 0)
+        {
+            rfs.close();
+        }
+        MPI_Bcast(miller, 3 * npwtot, MPI_INT, 0, POOL_WORLD);
+        read_wfc_pw_mpiio(filename, pw_wfc, ik, miller, npwtot, nbands_in, wfc);
+        delete[] miller;
+        ModuleBase::timer::tick("ModuleIO", "read_wfc_pw");
+        return;
+    }
+#endif
+
+    if (GlobalV::RANK_IN_POOL == 0)
+    {
         // map global index to read ordering for plane waves
         glo_order = new int[nx * ny * nz];
         for (int i = 0; i < nx * ny * nz; i++)
@@ -1,6 +1,7 @@
 #pragma once
 #include "module_base/abfs-vector3_order.h"
 #include "module_cell/unitcell.h"
+#include "module_hamilt_lcao/module_hcontainer/sparse_csr.h"
 #include "module_ri/serialization_cereal.h"
 #include <RI/global/Tensor.h>
 #include <map>
@@ -21,6 +22,14 @@ namespace ModuleIO
     void read_Hexxs_cereal(const std::string& file_name,
         std::vector<std::map<int, std::map<TAC, RI::Tensor<Tdata>>>>& Hexxs);
 
+    /// write the tensors (e.g. Cs, Vs) of atom pairs in cereal format
+    template<typename T>
+    void write_CVs_cereal(const std::string& file_name, const T& CVs);
+
+    /// read the tensors (e.g. Cs, Vs) of atom pairs in cereal format, return false if the file does not exist
+    template<typename T>
+    bool read_CVs_cereal(const std::string& file_name, T& CVs);
+
     /// write Hexxs in CSR format
     template<typename Tdata>
     void write_Hexxs_csr(const std::string& file_name, const UnitCell& ucell,
@@ -29,7 +38,7 @@ namespace ModuleIO
     /// calculate CSR sparse matrix from the global matrix stored with RI::Tensor
     /// the return type is same as SR_sparse,  HR_sparse, etc.
     template<typename Tdata>
-    std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, Tdata>>>
+    hamilt::SparseCSR_R<Tdata>
         calculate_RI_Tensor_sparse(const double& sparse_threshold,
             const std::vector<std::map<int, std::map<TAC, RI::Tensor<Tdata>>>>& Hexxs,
             const UnitCell& ucell);
@@ -5,6 +5,9 @@
 #include "module_io/write_HS_sparse.h"
 #include "module_ri/serialization_cereal.h"
 #include <RI/global/Tensor.h>
+#include <cereal/types/array.hpp>
+#include <cereal/types/utility.hpp>
+#include <fstream>
 #include <map>
 
 namespace ModuleIO
@@ -62,14 +65,38 @@ namespace ModuleIO
         ModuleBase::timer::tick("Exx_LRI", "read_Hexxs_cereal");
     }
 
+    template<typename T>
+    void write_CVs_cereal(const std::string& file_name, const T& CVs)
+    {
+        ModuleBase::TITLE("Exx_LRI", "write_CVs_cereal");
+        ModuleBase::timer::tick("Exx_LRI", "write_CVs_cereal");
+        std::ofstream ofs(file_name, std::ios::binary);
+        cereal::BinaryOutputArchive oar(ofs);
+        oar(CVs);
+        ModuleBase::timer::tick("Exx_LRI", "write_CVs_cereal");
+    }
+
+    template<typename T>
+    bool read_CVs_cereal(const std::string& file_name, T& CVs)
+    {
+        ModuleBase::TITLE("Exx_LRI", "read_CVs_cereal");
+        std::ifstream ifs(file_name, std::ios::binary);
+        if (!ifs) { return false; }
+        ModuleBase::timer::tick("Exx_LRI", "read_CVs_cereal");
+        cereal::BinaryInputArchive iar(ifs);
+        iar(CVs);
+        ModuleBase::timer::tick("Exx_LRI", "read_CVs_cereal");
+        return true;
+    }
+
     template<typename Tdata>
-    std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, Tdata>>>
+    hamilt::SparseCSR_R<Tdata>
         calculate_RI_Tensor_sparse(const double& sparse_threshold,
             const std::map<int, std::map<TAC, RI::Tensor<Tdata>>>& Hexxs,
             const UnitCell& ucell)
     {
         ModuleBase::TITLE("Exx_LRI_Interface", "calculate_HContainer_sparse_d");
-        std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, Tdata>>> target;
+        hamilt::SparseCSR_R<Tdata> target;
         for (auto& a1_a2R_data : Hexxs)
         {
             int iat1 = a1_a2R_data.first;
@@ -84,13 +111,17 @@ namespace ModuleIO
                 const TC& R = a2R_data.first.second;
                 auto& matrix = a2R_data.second;
                 Abfs::Vector3_Order<int> dR(R[0], R[1], R[2]);
+                hamilt::SparseCSR<Tdata>& target_R = target[dR];
                 for (int i = 0;i < nw1;++i) {
                     for (int j = 0;j < nw2;++j) {
-                        target[dR][start1 + i][start2 + j] = ((std::abs(matrix(i, j)) > sparse_threshold) ? matrix(i, j) : static_cast<Tdata>(0));
+                        if (std::abs(matrix(i, j)) > sparse_threshold) {
+                            target_R.add(start1 + i, start2 + j, matrix(i, j));
+                        }
                     }
                 }
             }
         }
+        hamilt::finalize_sparse_R(target, sparse_threshold);
         return target;
     }
     template<typename Tdata>
@@ -1,9 +1,15 @@
 #include "single_R_io.h"
-#include "module_base/parallel_reduce.h"
 #include "module_parameter/parameter.h"
 #include "module_base/global_function.h"
 #include "module_base/global_variable.h"
 
+#ifdef __MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <numeric>
+
 inline void write_data(std::ofstream& ofs, const double& data)
 {
     ofs << " " << std::fixed << std::scientific << std::setprecision(8) << data;
@@ -14,25 +20,99 @@ inline void write_data(std::ofstream& ofs, const std::complex<double>& data)
         << std::fixed << std::scientific << std::setprecision(8) << data.imag() << ")";
 }
 
-template<typename T>
-void ModuleIO::output_single_R(std::ofstream& ofs,
-    const std::map<size_t, std::map<size_t, T>>& XR,
+// number of global rows gathered to the writer in one collective step,
+// it bounds the memory of the writer to the nonzero elements of these rows
+static const int nrow_batch = 512;
+
+// elements of a batch of global rows, stored as coordinate list
+template <typename T>
+struct RowBatch
+{
+    std::vector<int> rows;
+    std::vector<int> cols;
+    std::vector<T> values;
+
+    void clear()
+    {
+        rows.clear();
+        cols.clear();
+        values.clear();
+    }
+};
+
+#ifdef __MPI
+// gather the elements of all processes to rank 0 of comm, the order of processes is kept
+template <typename T>
+static void gather_batch(const RowBatch<T>& local, RowBatch<T>& global, MPI_Comm comm)
+{
+    int nproc = 1;
+    int rank = 0;
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &rank);
+
+    int nlocal = static_cast<int>(local.values.size());
+    std::vector<int> counts(nproc, 0);
+    MPI_Gather(&nlocal, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, comm);
+
+    std::vector<int> displs(nproc, 0);
+    std::vector<int> counts_byte(nproc, 0);
+    std::vector<int> displs_byte(nproc, 0);
+    int ntot = 0;
+    if (rank == 0)
+    {
+        std::partial_sum(counts.begin(), counts.end() - 1, displs.begin() + 1);
+        ntot = displs.back() + counts.back();
+        for (int ip = 0; ip < nproc; ++ip)
+        {
+            counts_byte[ip] = counts[ip] * sizeof(T);
+            displs_byte[ip] = displs[ip] * sizeof(T);
+        }
+    }
+    global.rows.resize(ntot);
+    global.cols.resize(ntot);
+    global.values.resize(ntot);
+
+    MPI_Gatherv(local.rows.data(), nlocal, MPI_INT,
+                global.rows.data(), counts.data(), displs.data(), MPI_INT, 0, comm);
+    MPI_Gatherv(local.cols.data(), nlocal, MPI_INT,
+                global.cols.data(), counts.data(), displs.data(), MPI_INT, 0, comm);
+    MPI_Gatherv(local.values.data(), nlocal * static_cast<int>(sizeof(T)), MPI_BYTE,
+                global.values.data(), counts_byte.data(), displs_byte.data(), MPI_BYTE, 0, comm);
+}
+#endif
+
+// collect_row(row, cols, values) should append the local elements of the given global row to cols and values
+// each process only sends the elements of its own rows of the 2D block-cyclic distribution to the writer,
+// the dense row buffer and the per-row Parallel_Reduce::reduce_all of all processes are not needed
+template <typename T, typename CollectRow>
+static void output_single_R_rows(std::ofstream& ofs,
+    const CollectRow& collect_row,
     const double& sparse_threshold,
     const bool& binary,
     const Parallel_Orbitals& pv,
     const bool& reduce)
 {
-    T* line = nullptr;
+    const int nlocal = PARAM.globalv.nlocal;
     std::vector<int> indptr;
-    indptr.reserve(PARAM.globalv.nlocal + 1);
+    indptr.reserve(nlocal + 1);
     indptr.push_back(0);
 
+    int nproc = 1;
+#ifdef __MPI
+    if (reduce)
+    {
+        MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    }
+#endif
+    // the process writing the data, rank 0 of MPI_COMM_WORLD which is also DRANK 0
+    const bool writer = !reduce || GlobalV::MY_RANK == 0;
+
     std::stringstream tem1;
     tem1 << PARAM.globalv.global_out_dir << std::to_string(GlobalV::DRANK) + "temp_sparse_indices.dat";
     std::ofstream ofs_tem1;
     std::ifstream ifs_tem1;
 
-    if (!reduce || GlobalV::DRANK == 0)
+    if (writer)
     {
         if (binary)
         {
@@ -44,62 +124,105 @@ void ModuleIO::output_single_R(std::ofstream& ofs,
         }
     }
 
-    line = new T[PARAM.globalv.nlocal];
-    for(int row = 0; row < PARAM.globalv.nlocal; ++row)
+    RowBatch<T> local;
+    RowBatch<T> global;
+    std::vector<int> row_count(nrow_batch + 1);
+    std::vector<int> order;
+    std::vector<int> cols;
+    std::vector<T> values;
+    for (int row_begin = 0; row_begin < nlocal; row_begin += nrow_batch)
     {
-        ModuleBase::GlobalFunc::ZEROS(line, PARAM.globalv.nlocal);
+        const int row_end = std::min(row_begin + nrow_batch, nlocal);
 
-        if (!reduce || pv.global2local_row(row) >= 0)
+        local.clear();
+        for (int row = row_begin; row < row_end; ++row)
         {
-            auto iter = XR.find(row);
-            if (iter != XR.end())
+            if (!reduce || pv.global2local_row(row) >= 0)
             {
-                for (auto &value : iter->second)
-                {
-                    line[value.first] = value.second;
-                }
+                collect_row(row, local.cols, local.values);
+                local.rows.resize(local.cols.size(), row);
             }
         }
 
-        if (reduce) {Parallel_Reduce::reduce_all(line, PARAM.globalv.nlocal);
-}
+        const RowBatch<T>* batch = &local;
+#ifdef __MPI
+        if (nproc > 1)
+        {
+            gather_batch(local, global, MPI_COMM_WORLD);
+            batch = &global;
+        }
+#endif
+        if (!writer)
+        {
+            continue;
+        }
 
-        if (!reduce || GlobalV::DRANK == 0)
+        // counting sort of the elements by row, the order of processes is kept inside one row
+        std::fill(row_count.begin(), row_count.end(), 0);
+        for (const int& row: batch->rows)
+        {
+            ++row_count[row - row_begin + 1];
+        }
+        std::partial_sum(row_count.begin(), row_count.end(), row_count.begin());
+        order.resize(batch->rows.size());
         {
+            std::vector<int> pos(row_count.begin(), row_count.end() - 1);
+            for (int i = 0; i < static_cast<int>(batch->rows.size()); ++i)
+            {
+                order[pos[batch->rows[i] - row_begin]++] = i;
+            }
+        }
+
+        for (int row = row_begin; row < row_end; ++row)
+        {
+            const int ibegin = row_count[row - row_begin];
+            const int iend = row_count[row - row_begin + 1];
+            std::stable_sort(order.begin() + ibegin, order.begin() + iend, [batch](const int a, const int b) {
+                return batch->cols[a] < batch->cols[b];
+            });
+
+            // elements at the same (row, col) from different processes are summed as in reduce_all
+            cols.clear();
+            values.clear();
+            for (int i = ibegin; i < iend; ++i)
+            {
+                const int col = batch->cols[order[i]];
+                if (!cols.empty() && cols.back() == col)
+                {
+                    values.back() += batch->values[order[i]];
+                }
+                else
+                {
+                    cols.push_back(col);
+                    values.push_back(batch->values[order[i]]);
+                }
+            }
+
             int nonzeros_count = 0;
-            for (int col = 0; col < PARAM.globalv.nlocal; ++col)
+            for (int i = 0; i < static_cast<int>(cols.size()); ++i)
             {
-                if (std::abs(line[col]) > sparse_threshold)
+                if (std::abs(values[i]) > sparse_threshold)
                 {
                     if (binary)
                     {
-                        ofs.write(reinterpret_cast<char*>(&line[col]), sizeof(T));
-                        ofs_tem1.write(reinterpret_cast<char *>(&col), sizeof(int));
+                        ofs.write(reinterpret_cast<char*>(&values[i]), sizeof(T));
+                        ofs_tem1.write(reinterpret_cast<char*>(&cols[i]), sizeof(int));
                     }
                     else
                     {
-                        write_data(ofs, line[col]);
-                        ofs_tem1 << " " << col;
+                        write_data(ofs, values[i]);
+                        ofs_tem1 << " " << cols[i];
                     }
 
                     nonzeros_count++;
-
                 }
-
             }
             nonzeros_count += indptr.back();
             indptr.push_back(nonzeros_count);
         }
-
-        // delete[] line;
-        // line = nullptr;
-
     }
 
-    delete[] line;
-    line = nullptr;
-
-    if (!reduce || GlobalV::DRANK == 0)
+    if (writer)
     {
         if (binary)
         {
@@ -131,6 +254,47 @@ void ModuleIO::output_single_R(std::ofstream& ofs,
     }
 }
 
+template<typename T>
+void ModuleIO::output_single_R(std::ofstream& ofs,
+    const std::map<size_t, std::map<size_t, T>>& XR,
+    const double& sparse_threshold,
+    const bool& binary,
+    const Parallel_Orbitals& pv,
+    const bool& reduce)
+{
+    auto collect_row = [&XR](const int row, std::vector<int>& cols, std::vector<T>& values) {
+        auto iter = XR.find(row);
+        if (iter != XR.end())
+        {
+            for (auto &value : iter->second)
+            {
+                cols.push_back(value.first);
+                values.push_back(value.second);
+            }
+        }
+    };
+    output_single_R_rows<T>(ofs, collect_row, sparse_threshold, binary, pv, reduce);
+}
+
+template<typename T>
+void ModuleIO::output_single_R(std::ofstream& ofs,
+    const hamilt::SparseCSR<T>& XR,
+    const double& sparse_threshold,
+    const bool& binary,
+    const Parallel_Orbitals& pv,
+    const bool& reduce)
+{
+    auto collect_row = [&XR](const int row, std::vector<int>& cols, std::vector<T>& values) {
+        const int ir = XR.find_row(row);
+        if (ir >= 0)
+        {
+            cols.insert(cols.end(), XR.col_ind().begin() + XR.row_ptr()[ir], XR.col_ind().begin() + XR.row_ptr()[ir + 1]);
+            values.insert(values.end(), XR.values().begin() + XR.row_ptr()[ir], XR.values().begin() + XR.row_ptr()[ir + 1]);
+        }
+    };
+    output_single_R_rows<T>(ofs, collect_row, sparse_threshold, binary, pv, reduce);
+}
+
 template void ModuleIO::output_single_R<double>(std::ofstream& ofs,
     const std::map<size_t, std::map<size_t, double>>& XR,
     const double& sparse_threshold,
@@ -142,4 +306,16 @@ template void ModuleIO::output_single_R<std::complex<double>>(std::ofstream& ofs
     const double& sparse_threshold,
     const bool& binary,
     const Parallel_Orbitals& pv,
+    const bool& reduce);
+template void ModuleIO::output_single_R<double>(std::ofstream& ofs,
+    const hamilt::SparseCSR<double>& XR,
+    const double& sparse_threshold,
+    const bool& binary,
+    const Parallel_Orbitals& pv,
+    const bool& reduce);
+template void ModuleIO::output_single_R<std::complex<double>>(std::ofstream& ofs,
+    const hamilt::SparseCSR<std::complex<double>>& XR,
+    const double& sparse_threshold,
+    const bool& binary,
+    const Parallel_Orbitals& pv,
     const bool& reduce);
\ No newline at end of file
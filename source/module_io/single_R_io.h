@@ -2,6 +2,7 @@
 #define SINGLE_R_IO_H
 
 #include "module_basis/module_ao/parallel_orbitals.h"
+#include "module_hamilt_lcao/module_hcontainer/sparse_csr.h"
 #include <map>
 
 namespace ModuleIO
@@ -13,6 +14,14 @@ namespace ModuleIO
         const bool& binary,
         const Parallel_Orbitals& pv,
         const bool& reduce = true);
+
+    template <typename T>
+    void output_single_R(std::ofstream& ofs,
+        const hamilt::SparseCSR<T>& XR,
+        const double& sparse_threshold,
+        const bool& binary,
+        const Parallel_Orbitals& pv,
+        const bool& reduce = true);
 }
 
 #endif
@@ -102,6 +102,7 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_EQ(param.inp.ks_solver, "genelpa");
     EXPECT_DOUBLE_EQ(param.inp.search_radius, -1.0);
     EXPECT_TRUE(param.inp.search_pbc);
+    EXPECT_DOUBLE_EQ(param.inp.search_skin, 0.0);
     EXPECT_EQ(param.inp.symmetry, "1");
     EXPECT_FALSE(param.inp.init_vel);
     EXPECT_DOUBLE_EQ(param.inp.symmetry_prec, 1.0e-6);
@@ -137,6 +138,10 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_DOUBLE_EQ(param.inp.erf_sigma, 4.0);
     EXPECT_DOUBLE_EQ(param.inp.ecutrho, 80);
     EXPECT_EQ(param.inp.fft_mode, 0);
+    EXPECT_EQ(param.inp.fft_batch, 1);
+    EXPECT_FALSE(param.inp.nl_realspace);
+    EXPECT_DOUBLE_EQ(param.inp.nl_realspace_radius, 1.5);
+    EXPECT_DOUBLE_EQ(param.inp.nl_realspace_qratio, 2.0);
     EXPECT_EQ(param.globalv.ncx, 0);
     EXPECT_EQ(param.globalv.ncy, 0);
     EXPECT_EQ(param.globalv.ncz, 0);
@@ -153,6 +158,7 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_EQ(param.inp.pw_diag_nmax, 50);
     EXPECT_EQ(param.inp.diago_cg_prec, 1);
     EXPECT_EQ(param.inp.pw_diag_ndim, 4);
+    EXPECT_EQ(param.inp.pw_diag_cheb_degree, 10);
     EXPECT_DOUBLE_EQ(param.inp.pw_diag_thr, 1.0e-2);
     EXPECT_FALSE(param.inp.diago_smooth_ethr);
     EXPECT_EQ(param.inp.nb2d, 0);
@@ -224,6 +230,7 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_DOUBLE_EQ(param.inp.lcao_dk, 0.01);
     EXPECT_DOUBLE_EQ(param.inp.lcao_dr, 0.01);
     EXPECT_DOUBLE_EQ(param.inp.lcao_rmax, 30);
+    EXPECT_EQ(param.inp.lcao_table_cache_dir, "none");
     EXPECT_TRUE(param.inp.bessel_nao_smooth);
     EXPECT_DOUBLE_EQ(param.inp.bessel_nao_sigma, 0.1);
     EXPECT_EQ(std::stod(param.inp.bessel_nao_ecut), 20);
@@ -290,6 +297,8 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_EQ(param.inp.exx_opt_orb_lmax, 0);
     EXPECT_DOUBLE_EQ(param.inp.exx_opt_orb_ecut, 0.0);
     EXPECT_DOUBLE_EQ(param.inp.exx_opt_orb_tolerence, 0.0);
+    EXPECT_DOUBLE_EQ(param.inp.exx_cv_cache_memory, 0.0);
+    EXPECT_DOUBLE_EQ(param.inp.exx_cv_reuse_tol, 0.0);
     EXPECT_FALSE(param.inp.noncolin);
     EXPECT_FALSE(param.inp.lspinorb);
     EXPECT_DOUBLE_EQ(param.inp.soc_lambda, 1.0);
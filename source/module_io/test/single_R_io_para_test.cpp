@@ -0,0 +1,236 @@
+#include "gtest/gtest.h"
+#define private public
+#include "module_parameter/parameter.h"
+#undef private
+#include "module_io/single_R_io.h"
+#include "module_base/global_variable.h"
+#include "module_base/parallel_reduce.h"
+#include "module_basis/module_ao/parallel_orbitals.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+/************************************************
+ *  parallel unit test and benchmark of output_single_R
+ ***********************************************/
+/**
+ * - Tested Functions:
+ *   - ModuleIO::output_single_R
+ *     - rows are distributed block-cyclically over all processes,
+ *       the output of rank 0 should be byte-identical to the former
+ *       dense-row + reduce_all writer in both text and binary format
+ *     - the time of both writers is printed, run with different numbers
+ *       of processes (see single_R_io_para.sh) to get the scaling
+ */
+Parallel_Orbitals::Parallel_Orbitals()
+{
+}
+
+Parallel_Orbitals::~Parallel_Orbitals()
+{
+}
+
+// rows are distributed in blocks of nb over all processes
+static const int nb = 8;
+void Parallel_2D::set_serial(const int M_A, const int N_A)
+{
+    this->global2local_row_.assign(M_A, -1);
+    int irow = 0;
+    for (int row = 0; row < M_A; ++row)
+    {
+        if ((row / nb) % GlobalV::NPROC == GlobalV::MY_RANK)
+        {
+            this->global2local_row_[row] = irow++;
+        }
+    }
+}
+
+// the former writer: one dense row and one reduce_all for each global row
+template <typename T>
+void output_single_R_legacy(std::ofstream& ofs,
+                            const hamilt::SparseCSR<T>& XR,
+                            const double& sparse_threshold,
+                            const bool& binary,
+                            const Parallel_Orbitals& pv)
+{
+    const int nlocal = PARAM.globalv.nlocal;
+    std::vector<int> indptr(1, 0);
+    std::vector<int> cols;
+    std::vector<T> line(nlocal);
+    std::stringstream ss_value;
+    std::stringstream ss_col;
+    for (int row = 0; row < nlocal; ++row)
+    {
+        std::fill(line.begin(), line.end(), static_cast<T>(0));
+        const int ir = XR.find_row(row);
+        if (pv.global2local_row(row) >= 0 && ir >= 0)
+        {
+            for (int k = XR.row_ptr()[ir]; k < XR.row_ptr()[ir + 1]; ++k)
+            {
+                line[XR.col_ind()[k]] = XR.values()[k];
+            }
+        }
+        Parallel_Reduce::reduce_all(line.data(), nlocal);
+        int nonzeros_count = 0;
+        for (int col = 0; col < nlocal; ++col)
+        {
+            if (std::abs(line[col]) > sparse_threshold)
+            {
+                if (binary)
+                {
+                    ss_value.write(reinterpret_cast<char*>(&line[col]), sizeof(T));
+                    ss_col.write(reinterpret_cast<char*>(&col), sizeof(int));
+                }
+                else
+                {
+                    ss_value << " " << std::fixed << std::scientific << std::setprecision(8) << line[col];
+                    ss_col << " " << col;
+                }
+                nonzeros_count++;
+            }
+        }
+        indptr.push_back(indptr.back() + nonzeros_count);
+    }
+    if (GlobalV::MY_RANK == 0)
+    {
+        ofs << ss_value.str();
+        if (!binary)
+        {
+            ofs << std::endl;
+        }
+        ofs << ss_col.str();
+        if (!binary)
+        {
+            ofs << std::endl;
+        }
+        for (auto& i: indptr)
+        {
+            if (binary)
+            {
+                ofs.write(reinterpret_cast<char*>(&i), sizeof(int));
+            }
+            else
+            {
+                ofs << " " << i;
+            }
+        }
+        if (!binary)
+        {
+            ofs << std::endl;
+        }
+    }
+}
+
+std::string read_file(const std::string& filename)
+{
+    std::ifstream ifs(filename, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+}
+
+class SingleRIOParaTest : public testing::TestWithParam<bool>
+{
+  protected:
+    void SetUp() override
+    {
+        PARAM.sys.nlocal = 3000;
+        pv.set_serial(PARAM.sys.nlocal, PARAM.sys.nlocal);
+        // the same random matrix on all processes, each process only keeps its own rows
+        srand(1);
+        for (int row = 0; row < PARAM.sys.nlocal; ++row)
+        {
+            for (int col = 0; col < PARAM.sys.nlocal; ++col)
+            {
+                if (rand() % 50 == 0)
+                {
+                    const double value = static_cast<double>(rand()) / RAND_MAX - 0.5;
+                    if (pv.global2local_row(row) >= 0)
+                    {
+                        XR.add(row, col, value);
+                    }
+                }
+            }
+        }
+        XR.finalize(0.0);
+    }
+
+    Parallel_Orbitals pv;
+    hamilt::SparseCSR<double> XR;
+    const double sparse_threshold = 1e-3;
+};
+
+TEST_P(SingleRIOParaTest, CompareWithLegacy)
+{
+    const bool binary = GetParam();
+    GlobalV::DRANK = GlobalV::MY_RANK;
+    const std::string file_legacy = "test_output_single_R_legacy.dat";
+    const std::string file_new = "test_output_single_R_gather.dat";
+
+    std::ofstream ofs;
+    if (GlobalV::MY_RANK == 0)
+    {
+        ofs.open(file_legacy, binary ? std::ios::binary : std::ios::out);
+    }
+#ifdef __MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+    auto t0 = std::chrono::high_resolution_clock::now();
+    output_single_R_legacy(ofs, XR, sparse_threshold, binary, pv);
+    ofs.close();
+#ifdef __MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    if (GlobalV::MY_RANK == 0)
+    {
+        ofs.open(file_new, binary ? std::ios::binary : std::ios::out);
+    }
+#ifdef __MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+    auto t2 = std::chrono::high_resolution_clock::now();
+    ModuleIO::output_single_R(ofs, XR, sparse_threshold, binary, pv);
+    ofs.close();
+#ifdef __MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    if (GlobalV::MY_RANK == 0)
+    {
+        const std::string str_legacy = read_file(file_legacy);
+        const std::string str_new = read_file(file_new);
+        EXPECT_FALSE(str_new.empty());
+        EXPECT_TRUE(str_legacy == str_new);
+        std::remove(file_legacy.c_str());
+        std::remove(file_new.c_str());
+
+        std::cout << "nprocs: " << GlobalV::NPROC << ", binary: " << binary << std::endl;
+        std::cout << "time of dense row + reduce_all writer: "
+                  << std::chrono::duration_cast<std::chrono::duration<double>>(t1 - t0).count() << " s" << std::endl;
+        std::cout << "time of gathered sparse writer: "
+                  << std::chrono::duration_cast<std::chrono::duration<double>>(t3 - t2).count() << " s" << std::endl;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(SingleRIOPara, SingleRIOParaTest, testing::Values(false, true));
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &GlobalV::NPROC);
+    MPI_Comm_rank(MPI_COMM_WORLD, &GlobalV::MY_RANK);
+#endif
+
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+
+    return result;
+}
@@ -13,6 +13,7 @@
  * - Tested Functions:
  *   - ModuleIO::output_single_R
  *     - output single R data
+ *     - output single R data stored in hamilt::SparseCSR
  */
 Parallel_Orbitals::Parallel_Orbitals()
 {
@@ -66,6 +67,39 @@ TEST(ModuleIOTest, OutputSingleR)
     std::remove("test_output_single_R_0.dat");
 }
 
+TEST(ModuleIOTest, OutputSingleRCSR)
+{
+    std::stringstream ofs_filename;
+    GlobalV::DRANK=0;
+    ofs_filename << "test_output_single_R_csr_" << GlobalV::DRANK << ".dat";
+    std::ofstream ofs(ofs_filename.str());
+
+    const double sparse_threshold = 1e-8;
+    const bool binary = false;
+    Parallel_Orbitals pv;
+    PARAM.sys.nlocal = 5;
+    pv.set_serial(PARAM.sys.nlocal, PARAM.sys.nlocal);
+    hamilt::SparseCSR<double> XR;
+    XR.add(3, 4, 0.7);
+    XR.add(0, 3, 0.3);
+    XR.add(1, 0, 0.2);
+    XR.add(0, 1, 0.5);
+    XR.add(1, 2, 0.4);
+    XR.add(3, 1, 0.1);
+    XR.finalize(sparse_threshold);
+
+    ModuleIO::output_single_R(ofs, XR, sparse_threshold, binary, pv);
+
+    ofs.close();
+    std::ifstream ifs;
+    ifs.open("test_output_single_R_csr_0.dat");
+    std::string str((std::istreambuf_iterator<char>(ifs)),std::istreambuf_iterator<char>());
+    EXPECT_THAT(str, testing::HasSubstr("5.00000000e-01 3.00000000e-01 2.00000000e-01 4.00000000e-01 1.00000000e-01 7.00000000e-01"));
+    EXPECT_THAT(str, testing::HasSubstr("1 3 0 2 1 4"));
+    EXPECT_THAT(str, testing::HasSubstr("0 2 4 4 6 6"));
+    std::remove("test_output_single_R_csr_0.dat");
+}
+
 int main(int argc, char **argv)
 {
 
@@ -0,0 +1,225 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#define private public
+#include "module_parameter/parameter.h"
+#undef private
+#include "module_io/binstream.h"
+#include "module_io/read_wfc_pw.h"
+#include "module_io/write_wfc_pw.h"
+
+#include <fstream>
+
+#ifdef __MPI
+#include "module_base/parallel_global.h"
+#include "module_basis/module_pw/test/test_tool.h"
+#include "mpi.h"
+#endif
+
+/**
+ * - Tested Functions:
+ *  - write_wfc_pw()
+ *    - the binary file has the records of Binstream, the plane waves of all the processes are in
+ *      the file in the order of the miller indices written with them
+ *  - read_wfc_pw()
+ *    - reads back the wave functions written by write_wfc_pw(), for npol = 1 and npol = 2
+ */
+
+namespace
+{
+// the value of a plane wave of band ib, component ipol at k point ikstot, from its miller index
+std::complex<double> wfc_value(const int ikstot, const int ib, const int ipol, const int x, const int y, const int z)
+{
+    return std::complex<double>(ikstot + 0.1 * ib + 0.01 * ipol + 1e-3 * x, 1e-4 * y + 1e-5 * z - 0.5 * ib);
+}
+} // namespace
+
+class WriteWfcPwTest : public ::testing::TestWithParam<int>
+{
+  protected:
+    ModulePW::PW_Basis_K* wfcpw = nullptr;
+    K_Vectors* kv = nullptr;
+    const int nks = 2;
+    const int nbands = 3;
+
+    void SetUp() override
+    {
+        PARAM.input.nbands = nbands;
+        PARAM.input.out_wfc_pw = 2;
+        PARAM.sys.npol = GetParam();
+
+        kv = new K_Vectors;
+        kv->set_nkstot(nks);
+        kv->set_nks(nks);
+        kv->kvec_d = {ModuleBase::Vector3<double>(0.0, 0.0, 0.0), ModuleBase::Vector3<double>(0.1, 0.2, 0.3)};
+        kv->ik2iktot = {0, 1};
+        kv->wk = {1.0, 1.0};
+
+        wfcpw = new ModulePW::PW_Basis_K;
+#ifdef __MPI
+        wfcpw->initmpi(GlobalV::NPROC_IN_POOL, GlobalV::RANK_IN_POOL, POOL_WORLD);
+#endif
+        wfcpw->initgrids(5.3233, ModuleBase::Matrix3(-0.5, 0.0, 0.5, 0.0, 0.5, 0.5, -0.5, 0.5, 0.0), 80);
+        wfcpw->initparameters(false, 20, nks, kv->kvec_d.data());
+        wfcpw->setuptransform();
+        wfcpw->collect_local_pw();
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            kv->kvec_c.push_back(wfcpw->kvec_c[ik]);
+            kv->ngk.push_back(wfcpw->npwk[ik]);
+        }
+    }
+
+    void TearDown() override
+    {
+        delete wfcpw;
+        delete kv;
+        PARAM.sys.npol = 1;
+    }
+
+    // the miller index of the local plane wave igl of k point ik
+    void get_miller(const int ik, const int igl, int& x, int& y, int& z) const
+    {
+        const int isz = wfcpw->igl2isz_k[ik * wfcpw->npwk_max + igl];
+        const int ixy = wfcpw->is2fftixy[isz / wfcpw->nz];
+        x = ixy / wfcpw->fftny;
+        y = ixy % wfcpw->fftny;
+        z = isz % wfcpw->nz;
+    }
+};
+
+TEST_P(WriteWfcPwTest, WriteRead)
+{
+    const int npol = GetParam();
+    const int npwk_max = wfcpw->npwk_max;
+    psi::Psi<std::complex<double>> psi(nks, nbands, npol * npwk_max, kv->ngk, true);
+    for (int ik = 0; ik < nks; ++ik)
+    {
+        psi.fix_k(ik);
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            for (int ipol = 0; ipol < npol; ++ipol)
+            {
+                for (int igl = 0; igl < wfcpw->npwk[ik]; ++igl)
+                {
+                    int x = 0, y = 0, z = 0;
+                    get_miller(ik, igl, x, y, z);
+                    psi(ib, ipol * npwk_max + igl) = wfc_value(ik, ib, ipol, x, y, z);
+                }
+            }
+        }
+    }
+
+    ModuleIO::write_wfc_pw("WAVEFUNC", psi, *kv, wfcpw);
+
+    for (int ik = 0; ik < nks; ++ik)
+    {
+        const std::string filename = "WAVEFUNC" + std::to_string(ik + 1) + ".dat";
+        int npwtot = wfcpw->npwk[ik];
+#ifdef __MPI
+        MPI_Allreduce(MPI_IN_PLACE, &npwtot, 1, MPI_INT, MPI_SUM, POOL_WORLD);
+#endif
+
+        // the file read serially
+        if (GlobalV::MY_RANK == 0)
+        {
+            Binstream rfs(filename, "r");
+            int size = 0, ikstot_in = 0, nkstot_in = 0, npwtot_in = 0, nbands_in = 0;
+            double kvec[3], weight, ecut, lat0, tpiba, g[9];
+            rfs >> size >> ikstot_in >> nkstot_in >> kvec[0] >> kvec[1] >> kvec[2] >> weight >> npwtot_in >> nbands_in
+                >> ecut >> lat0 >> tpiba >> size;
+            EXPECT_EQ(size, 72);
+            EXPECT_EQ(ikstot_in, ik + 1);
+            EXPECT_EQ(nkstot_in, nks);
+            EXPECT_EQ(npwtot_in, npwtot);
+            EXPECT_EQ(nbands_in, nbands);
+            rfs >> size;
+            for (int i = 0; i < 9; ++i)
+            {
+                rfs >> g[i];
+            }
+            rfs >> size;
+            EXPECT_EQ(size, 72);
+
+            std::vector<int> miller(3 * npwtot);
+            rfs >> size;
+            EXPECT_EQ(size, 12 * npwtot);
+            for (int i = 0; i < 3 * npwtot; ++i)
+            {
+                rfs >> miller[i];
+            }
+            rfs >> size;
+            EXPECT_EQ(size, 12 * npwtot);
+
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                rfs >> size;
+                EXPECT_EQ(size, 16 * npol * npwtot);
+                for (int ipol = 0; ipol < npol; ++ipol)
+                {
+                    for (int ig = 0; ig < npwtot; ++ig)
+                    {
+                        std::complex<double> value;
+                        rfs >> value;
+                        EXPECT_EQ(value, wfc_value(ik, ib, ipol, miller[3 * ig], miller[3 * ig + 1], miller[3 * ig + 2]));
+                    }
+                }
+                rfs >> size;
+                EXPECT_EQ(size, 16 * npol * npwtot);
+            }
+            rfs.close();
+
+            // nothing is left after the last band
+            std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+            const long file_size = 2 * (72 + 8) + 8 + 12 * npwtot + nbands * (8 + 16 * npol * npwtot);
+            EXPECT_EQ(static_cast<long>(ifs.tellg()), file_size);
+        }
+
+        // the file read back by all the processes
+        ModuleBase::ComplexMatrix wfc(nbands, npol * npwk_max);
+        ModuleIO::read_wfc_pw(filename, wfcpw, ik, ik, nks, wfc);
+        psi.fix_k(ik);
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            for (int ipol = 0; ipol < npol; ++ipol)
+            {
+                for (int igl = 0; igl < wfcpw->npwk[ik]; ++igl)
+                {
+                    EXPECT_EQ(wfc(ib, ipol * npwk_max + igl), psi(ib, ipol * npwk_max + igl));
+                }
+            }
+        }
+    }
+
+#ifdef __MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+    if (GlobalV::MY_RANK == 0)
+    {
+        remove("WAVEFUNC1.dat");
+        remove("WAVEFUNC2.dat");
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Npol, WriteWfcPwTest, ::testing::Values(1, 2));
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    setupmpi(argc, argv, GlobalV::NPROC, GlobalV::MY_RANK);
+    divide_pools(GlobalV::NPROC,
+                 GlobalV::MY_RANK,
+                 GlobalV::NPROC_IN_POOL,
+                 GlobalV::KPAR,
+                 GlobalV::MY_POOL,
+                 GlobalV::RANK_IN_POOL);
+#endif
+
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+
+#ifdef __MPI
+    finishmpi();
+#endif
+    return result;
+}
@@ -257,6 +257,45 @@ TEST_F(InputTest, Item_test)
         output = testing::internal::GetCapturedStdout();
         EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
     }
+    { // nl_realspace
+        auto it = find_label("nl_realspace", readinput.input_lists);
+        param.input.nl_realspace = true;
+        param.input.basis_type = "pw";
+        param.input.device = "cpu";
+        const bool noncolin = param.input.noncolin;
+        const bool lspinorb = param.input.lspinorb;
+        const bool use_paw = param.input.use_paw;
+        param.input.noncolin = false;
+        param.input.lspinorb = false;
+        param.input.use_paw = false;
+        const std::string esolver_type = param.input.esolver_type;
+        param.input.esolver_type = "ksdft";
+        param.input.cal_force = true;
+        param.input.cal_stress = true;
+        it->second.check_value(it->second, param);
+
+        param.input.esolver_type = "sdft";
+        param.input.cal_stress = false;
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+
+        param.input.cal_force = false;
+        param.input.cal_stress = true;
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+
+        param.input.cal_stress = false;
+        it->second.check_value(it->second, param);
+        param.input.esolver_type = esolver_type;
+        param.input.nl_realspace = false;
+        param.input.noncolin = noncolin;
+        param.input.lspinorb = lspinorb;
+        param.input.use_paw = use_paw;
+    }
     { // pw_diag_thr
         auto it = find_label("pw_diag_thr", readinput.input_lists);
         param.input.pw_diag_thr = 1.0e-2;
@@ -265,6 +304,22 @@ TEST_F(InputTest, Item_test)
         it->second.reset_value(it->second, param);
         EXPECT_EQ(param.input.pw_diag_thr, 1.0e-5);
     }
+    { // pw_diag_cheb_degree
+        auto it = find_label("pw_diag_cheb_degree", readinput.input_lists);
+        param.input.pw_diag_cheb_degree = 0;
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+    }
+    { // fft_mode
+        auto it = find_label("fft_mode", readinput.input_lists);
+        param.input.fft_mode = 8;
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+    }
     { // nb2d
         auto it = find_label("nb2d", readinput.input_lists);
         param.input.nb2d = -1;
@@ -980,6 +1035,14 @@ TEST_F(InputTest, Item_test2)
         output = testing::internal::GetCapturedStdout();
         EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
     }
+    { // search_skin
+        auto it = find_label("search_skin", readinput.input_lists);
+        param.input.search_skin = -1.0;
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+    }
     { // bx
         auto it = find_label("bx", readinput.input_lists);
         param.input.bx = 11;
@@ -1343,6 +1406,22 @@ TEST_F(InputTest, Item_test2)
         it->second.reset_value(it->second, param);
         EXPECT_EQ(param.input.exx_symmetry_realspace, false);
     }
+    { // exx_cv_cache_memory
+        auto it = find_label("exx_cv_cache_memory", readinput.input_lists);
+        param.input.exx_cv_cache_memory = -1;
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+    }
+    { // exx_cv_reuse_tol
+        auto it = find_label("exx_cv_reuse_tol", readinput.input_lists);
+        param.input.exx_cv_reuse_tol = -1;
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+    }
     { // rpa_ccp_rmesh_times
         auto it = find_label("rpa_ccp_rmesh_times", readinput.input_lists);
         param.input.rpa_ccp_rmesh_times = 0;
@@ -55,41 +55,29 @@ void ModuleIO::save_HSR_sparse(const int& istep,
                     if (iter
                         != TD_Velocity::td_vel_op->HR_sparse_td_vel[ispin]
                                .end()) {
-                        for (auto& row_loop: iter->second) {
-                            H_nonzero_num[ispin][count]
-                                += row_loop.second.size();
-                        }
+                        H_nonzero_num[ispin][count] += iter->second.nnz();
                     }
                 } else {
                     auto iter = HR_sparse_ptr[ispin].find(R_coor);
                     if (iter != HR_sparse_ptr[ispin].end()) {
-                        for (auto& row_loop: iter->second) {
-                            H_nonzero_num[ispin][count]
-                                += row_loop.second.size();
-                        }
+                        H_nonzero_num[ispin][count] += iter->second.nnz();
                     }
                 }
             }
 
             auto iter = SR_sparse_ptr.find(R_coor);
             if (iter != SR_sparse_ptr.end()) {
-                for (auto& row_loop: iter->second) {
-                    S_nonzero_num[count] += row_loop.second.size();
-                }
+                S_nonzero_num[count] += iter->second.nnz();
             }
         } else {
             auto iter = HR_soc_sparse_ptr.find(R_coor);
             if (iter != HR_soc_sparse_ptr.end()) {
-                for (auto& row_loop: iter->second) {
-                    H_nonzero_num[0][count] += row_loop.second.size();
-                }
+                H_nonzero_num[0][count] += iter->second.nnz();
             }
 
             iter = SR_soc_sparse_ptr.find(R_coor);
             if (iter != SR_soc_sparse_ptr.end()) {
-                for (auto& row_loop: iter->second) {
-                    S_nonzero_num[count] += row_loop.second.size();
-                }
+                S_nonzero_num[count] += iter->second.nnz();
             }
         }
 
@@ -368,31 +356,23 @@ void ModuleIO::save_dH_sparse(const int& istep,
             for (int ispin = 0; ispin < spin_loop; ++ispin) {
                 auto iter1 = dHRx_sparse_ptr[ispin].find(R_coor);
                 if (iter1 != dHRx_sparse_ptr[ispin].end()) {
-                    for (auto& row_loop: iter1->second) {
-                        dHx_nonzero_num[ispin][count] += row_loop.second.size();
-                    }
+                    dHx_nonzero_num[ispin][count] += iter1->second.nnz();
                 }
 
                 auto iter2 = dHRy_sparse_ptr[ispin].find(R_coor);
                 if (iter2 != dHRy_sparse_ptr[ispin].end()) {
-                    for (auto& row_loop: iter2->second) {
-                        dHy_nonzero_num[ispin][count] += row_loop.second.size();
-                    }
+                    dHy_nonzero_num[ispin][count] += iter2->second.nnz();
                 }
 
                 auto iter3 = dHRz_sparse_ptr[ispin].find(R_coor);
                 if (iter3 != dHRz_sparse_ptr[ispin].end()) {
-                    for (auto& row_loop: iter3->second) {
-                        dHz_nonzero_num[ispin][count] += row_loop.second.size();
-                    }
+                    dHz_nonzero_num[ispin][count] += iter3->second.nnz();
                 }
             }
         } else {
             auto iter = dHRx_soc_sparse_ptr.find(R_coor);
             if (iter != dHRx_soc_sparse_ptr.end()) {
-                for (auto& row_loop: iter->second) {
-                    dHx_nonzero_num[0][count] += row_loop.second.size();
-                }
+                dHx_nonzero_num[0][count] += iter->second.nnz();
             }
         }
 
@@ -675,8 +655,7 @@ void ModuleIO::save_dH_sparse(const int& istep,
 
 template <typename Tdata>
 void ModuleIO::save_sparse(
-    const std::map<Abfs::Vector3_Order<int>,
-                   std::map<size_t, std::map<size_t, Tdata>>>& smat,
+    const hamilt::SparseCSR_R<Tdata>& smat,
     const std::set<Abfs::Vector3_Order<int>>& all_R_coor,
     const double& sparse_thr,
     const bool& binary,
@@ -694,9 +673,7 @@ void ModuleIO::save_sparse(
     for (auto& R_coor: all_R_coor) {
         auto iter = smat.find(R_coor);
         if (iter != smat.end()) {
-            for (auto& row_loop: iter->second) {
-                nonzero_num[count] += row_loop.second.size();
-            }
+            nonzero_num[count] += iter->second.nnz();
         }
         ++count;
     }
@@ -776,8 +753,7 @@ void ModuleIO::save_sparse(
 }
 
 template void ModuleIO::save_sparse<double>(
-    const std::map<Abfs::Vector3_Order<int>,
-                   std::map<size_t, std::map<size_t, double>>>&,
+    const hamilt::SparseCSR_R<double>&,
     const std::set<Abfs::Vector3_Order<int>>&,
     const double&,
     const bool&,
@@ -788,8 +764,7 @@ template void ModuleIO::save_sparse<double>(
     const bool&);
 
 template void ModuleIO::save_sparse<std::complex<double>>(
-    const std::map<Abfs::Vector3_Order<int>,
-                   std::map<size_t, std::map<size_t, std::complex<double>>>>&,
+    const hamilt::SparseCSR_R<std::complex<double>>&,
     const std::set<Abfs::Vector3_Order<int>>&,
     const double&,
     const bool&,
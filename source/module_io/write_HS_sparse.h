@@ -28,7 +28,7 @@ void save_dH_sparse(const int& istep,
                     const bool& binary);
 
 template <typename Tdata>
-void save_sparse(const std::map<Abfs::Vector3_Order<int>, std::map<size_t, std::map<size_t, Tdata>>>& smat,
+void save_sparse(const hamilt::SparseCSR_R<Tdata>& smat,
                  const std::set<Abfs::Vector3_Order<int>>& all_R_coor,
                  const double& sparse_thr,
                  const bool& binary,
@@ -5,11 +5,237 @@
 #endif
 
 #include "binstream.h"
+#include "module_base/global_function.h"
 #include "module_base/global_variable.h"
 #include "module_base/parallel_global.h"
 #include "module_base/tool_title.h"
 #include "module_parameter/parameter.h"
 
+#include <vector>
+
+#ifdef __MPI
+namespace
+{
+/**
+ * @brief small blocks of bytes written into a file by one process, in one collective MPI-IO call
+ *
+ * The blocks are copied into a buffer, so only the headers, the sizes of the records and the miller
+ * indices are put here. The bands are written from psi directly, see write_bands.
+ */
+class File_Blocks
+{
+  public:
+    /// put size bytes at the position offset of the file, offset must not be smaller than the last one
+    void put(const MPI_Offset offset, const void* data, const int size)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+        if (!displs.empty() && displs.back() + lengths.back() == offset)
+        {
+            lengths.back() += size;
+        }
+        else
+        {
+            displs.push_back(offset);
+            lengths.push_back(size);
+        }
+        const char* p = static_cast<const char*>(data);
+        buffer.insert(buffer.end(), p, p + size);
+    }
+
+    /// put one value at offset, return the position after it
+    template <typename T>
+    MPI_Offset put(const MPI_Offset offset, const T& data)
+    {
+        put(offset, &data, sizeof(T));
+        return offset + sizeof(T);
+    }
+
+    void write_all(MPI_File fh)
+    {
+        MPI_Datatype filetype = MPI_BYTE;
+        if (!displs.empty())
+        {
+            MPI_Type_create_hindexed(displs.size(), lengths.data(), displs.data(), MPI_BYTE, &filetype);
+            MPI_Type_commit(&filetype);
+        }
+        MPI_File_set_view(fh, 0, MPI_BYTE, filetype, "native", MPI_INFO_NULL);
+        MPI_File_write_all(fh, buffer.data(), static_cast<int>(buffer.size()), MPI_BYTE, MPI_STATUS_IGNORE);
+        if (!displs.empty())
+        {
+            MPI_Type_free(&filetype);
+        }
+    }
+
+  private:
+    std::vector<MPI_Aint> displs;
+    std::vector<int> lengths;
+    std::vector<char> buffer;
+};
+
+/**
+ * @brief write the local plane waves of all the bands from psi into the band records of the file
+ *
+ * The file view of a process is made of its ng plane waves of each component of each band, and the
+ * memory type picks them out of psi, so psi is not copied. The bands are written one by one, each
+ * call writes npol * ng complex numbers, which keeps the count far below INT_MAX even if the whole
+ * file is larger than 2GB.
+ */
+void write_bands(MPI_File fh,
+                 const psi::Psi<std::complex<double>>& psi,
+                 const int nbands,
+                 const int npol,
+                 const int ng,
+                 const int ng_max,
+                 const int ikngtot,
+                 const int ig_start,
+                 const MPI_Offset band_offset,
+                 const MPI_Offset band_size)
+{
+    const MPI_Offset isize = sizeof(int);
+    const MPI_Offset csize = sizeof(std::complex<double>);
+
+    MPI_Datatype file_view = MPI_BYTE;
+    MPI_Datatype band_mem = MPI_BYTE;
+    int count = 0;
+    if (ng > 0)
+    {
+        MPI_Datatype band_file;
+        MPI_Type_create_hvector(npol, 2 * ng, csize * ikngtot, MPI_DOUBLE, &band_file);
+        MPI_Type_create_hvector(nbands, 1, band_size, band_file, &file_view);
+        MPI_Type_commit(&file_view);
+        MPI_Type_free(&band_file);
+
+        MPI_Type_create_hvector(npol, 2 * ng, csize * ng_max, MPI_DOUBLE, &band_mem);
+        MPI_Type_commit(&band_mem);
+        count = 1;
+    }
+
+    MPI_File_set_view(fh, band_offset + isize + csize * ig_start, MPI_BYTE, file_view, "native", MPI_INFO_NULL);
+    for (int ib = 0; ib < nbands; ib++)
+    {
+        MPI_File_write_all(fh, &psi(ib, 0), count, band_mem, MPI_STATUS_IGNORE);
+    }
+
+    if (ng > 0)
+    {
+        MPI_Type_free(&file_view);
+        MPI_Type_free(&band_mem);
+    }
+}
+
+/**
+ * @brief write the wave functions of k point ik into a binary file by MPI-IO
+ *
+ * The file is the same as the one written by Binstream: the records of the header, the reciprocal
+ * lattice vectors, the miller indices of the plane waves and the bands, each record begins and ends
+ * with its size in bytes. The plane waves of the processes are in the order of RANK_IN_POOL, so each
+ * process knows where its part is from the numbers of plane waves before it, and all the processes
+ * write at the same time.
+ */
+void write_wfc_pw_mpiio(const std::string& filename,
+                        const psi::Psi<std::complex<double>>& psi,
+                        const K_Vectors& kv,
+                        const ModulePW::PW_Basis_K* wfcpw,
+                        const int ik)
+{
+    const int npol = PARAM.globalv.npol;
+    const int nbands = PARAM.inp.nbands;
+    const int ikstot = kv.ik2iktot[ik];
+    const int ng = kv.ngk[ik];
+    const int ng_max = wfcpw->npwk_max;
+
+    // the plane waves of this process begin at ig_start of all the plane waves
+    int ikngtot = 0;
+    int ig_start = 0;
+    MPI_Allreduce(&ng, &ikngtot, 1, MPI_INT, MPI_SUM, POOL_WORLD);
+    MPI_Exscan(&ng, &ig_start, 1, MPI_INT, MPI_SUM, POOL_WORLD);
+    if (GlobalV::RANK_IN_POOL == 0)
+    {
+        ig_start = 0;
+    }
+    const int ikngtot_npol = ikngtot * npol;
+
+    const MPI_Offset isize = sizeof(int);
+    const MPI_Offset csize = sizeof(std::complex<double>);
+    // two records of 72B
+    const MPI_Offset miller_offset = 2 * (72 + 2 * isize);
+    const MPI_Offset band_offset = miller_offset + 2 * isize + 3 * isize * ikngtot;
+    const MPI_Offset band_size = 2 * isize + csize * ikngtot_npol;
+    const bool is_first = GlobalV::RANK_IN_POOL == 0;
+    const bool is_last = GlobalV::RANK_IN_POOL == GlobalV::NPROC_IN_POOL - 1;
+
+    File_Blocks blocks;
+    if (is_first)
+    {
+        MPI_Offset pos = 0;
+        pos = blocks.put(pos, int(72));
+        pos = blocks.put(pos, ikstot + 1);
+        pos = blocks.put(pos, kv.get_nkstot());
+        pos = blocks.put(pos, kv.kvec_c[ik].x);
+        pos = blocks.put(pos, kv.kvec_c[ik].y);
+        pos = blocks.put(pos, kv.kvec_c[ik].z);
+        pos = blocks.put(pos, kv.wk[ik]);
+        pos = blocks.put(pos, ikngtot);
+        pos = blocks.put(pos, nbands);
+        pos = blocks.put(pos, PARAM.inp.ecutwfc);
+        pos = blocks.put(pos, wfcpw->lat0);
+        pos = blocks.put(pos, wfcpw->tpiba);
+        pos = blocks.put(pos, int(72)); // 4 int + 7 double is 72B
+        pos = blocks.put(pos, int(72));
+        const ModuleBase::Matrix3& G = wfcpw->G;
+        const double g[9] = {G.e11, G.e12, G.e13, G.e21, G.e22, G.e23, G.e31, G.e32, G.e33};
+        blocks.put(pos, g, sizeof(g));
+        pos += sizeof(g);
+        pos = blocks.put(pos, int(72)); // 9 double is 72B
+        blocks.put(pos, ikngtot * 4 * 3);
+    }
+
+    std::vector<int> miller(3 * ng);
+    for (int igl = 0; igl < ng; ++igl)
+    {
+        int isz = wfcpw->igl2isz_k[ik * wfcpw->npwk_max + igl];
+        int iz = isz % wfcpw->nz;
+        int is = isz / wfcpw->nz;
+        int ixy = wfcpw->is2fftixy[is];
+        miller[3 * igl] = ixy / wfcpw->fftny;
+        miller[3 * igl + 1] = ixy % wfcpw->fftny;
+        miller[3 * igl + 2] = iz;
+    }
+    blocks.put(miller_offset + isize + 3 * isize * ig_start, miller.data(), 3 * isize * ng);
+    if (is_last)
+    {
+        blocks.put(band_offset - isize, ikngtot * 4 * 3);
+    }
+
+    for (int ib = 0; ib < nbands; ib++)
+    {
+        const MPI_Offset offset = band_offset + ib * band_size;
+        if (is_first)
+        {
+            blocks.put(offset, ikngtot_npol * 16);
+        }
+        if (is_last)
+        {
+            blocks.put(offset + band_size - isize, ikngtot_npol * 16);
+        }
+    }
+
+    MPI_File fh;
+    if (MPI_File_open(POOL_WORLD, filename.c_str(), MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL, &fh)
+        != MPI_SUCCESS)
+    {
+        ModuleBase::WARNING_QUIT("ModuleIO::write_wfc_pw", "Can't open file " + filename);
+    }
+    blocks.write_all(fh);
+    write_bands(fh, psi, nbands, npol, ng, ng_max, ikngtot, ig_start, band_offset, band_size);
+    MPI_File_close(&fh);
+}
+} // namespace
+#endif
+
 void ModuleIO::write_wfc_pw(const std::string& fn,
                             const psi::Psi<std::complex<double>>& psi,
                             const K_Vectors& kv,
@@ -53,6 +279,19 @@ void ModuleIO::write_wfc_pw(const std::string& fn,
 #ifdef __MPI
     MPI_Barrier(MPI_COMM_WORLD);
 
+    // the binary files are written collectively by the processes of each pool,
+    // and the pools write their own k points at the same time
+    if (PARAM.inp.out_wfc_pw == 2)
+    {
+        for (int ik = 0; ik < psi.get_nk(); ik++)
+        {
+            psi.fix_k(ik);
+            write_wfc_pw_mpiio(wfilename[kv.ik2iktot[ik]], psi, kv, wfcpw, ik);
+        }
+        delete[] wfilename;
+        return;
+    }
+
     // out put the wave functions in plane wave basis.
     for (int ip = 0; ip < GlobalV::KPAR; ip++)
     {
@@ -44,6 +44,10 @@ struct Input_para
     double erf_height = 0;              ///< the height of the energy step for reciprocal vectors
     double erf_sigma = 0.1;             ///< the width of the energy step for reciprocal vectors
     int fft_mode = 0;                   ///< fftw mode 0: estimate, 1: measure, 2: patient, 3: exhaustive
+    int fft_batch = 1;                  ///< number of bands transformed together by the batched fft of wave functions
+    bool nl_realspace = false;          ///< apply the nonlocal pseudopotential on the real-space grid
+    double nl_realspace_radius = 1.5;   ///< radius of the real-space projectors, in units of the cutoff of beta
+    double nl_realspace_qratio = 2.0;   ///< the real-space projectors are cut smoothly in q from sqrt(ecutwfc) to qratio*sqrt(ecutwfc)
     std::string init_wfc = "atomic";    ///< "file","atomic","random"
     int pw_seed = 0;                    ///< random seed for initializing wave functions
     std::string init_chg = "atomic";    ///< "file","atomic"
@@ -87,6 +91,7 @@ struct Input_para
     double pw_diag_thr = 0.01; ///< used in cg method
     bool diago_smooth_ethr = false; ///< smooth ethr for iter methods
     int pw_diag_ndim = 4;      ///< dimension of workspace for Davidson diagonalization
+    int pw_diag_cheb_degree = 10; ///< degree of the Chebyshev filter in chefsi
     int diago_cg_prec = 1;     ///< mohan add 2012-03-31
     int diag_subspace = 0; // 0: Lapack, 1: elpa, 2: scalapack
 
@@ -133,8 +138,10 @@ struct Input_para
     double lcao_dk = 0.01;                     ///< delta k used in two center integral
     double lcao_dr = 0.01;                     ///< dr used in two center integral
     double lcao_rmax = 30.0;                   ///< rmax(a.u.) to make table.
+    std::string lcao_table_cache_dir = "none"; ///< directory to cache the two-center integral tables, none for no cache
     double search_radius = -1.0;               ///< 11.1
     bool search_pbc = true;                    ///< 11.2
+    double search_skin = 0.0;                  ///< Verlet skin to reuse the adjacent atoms between ionic steps (Bohr)
     int bx = 0, by = 0, bz = 0;                ///< big mesh ball. 0: auto set bx/by/bz
     int elpa_num_thread = -1;                  ///< Number of threads need to use in elpa
     int nstream = 4;                           ///< Number of streams in CUDA as per input data
@@ -540,6 +547,8 @@ struct Input_para
     double rpa_ccp_rmesh_times = 10.0;          ///< how many times larger the radial mesh required for
                                                 ///< calculating Columb potential is to that of atomic orbitals
     bool out_ri_cv = false;   ///<Whether to output the coefficient tensor C and ABFs-representation Coulomb matrix V
+    double exx_cv_cache_memory = 0.0;           ///< maximal memory (MB) of each cache of V, C, dV, dC in exx, 0 for no limit
+    double exx_cv_reuse_tol = 0.0;              ///< reuse V, C, dV, dC of the atom pairs moved less than it (Bohr) in exx, 0 for no reuse
     // ==============   #Parameters (16.dft+u) ======================
     //    DFT+U       Xin Qu added on 2020-10-29
     int dft_plus_u = 0;                    ///< 0: standard DFT calculation (default)
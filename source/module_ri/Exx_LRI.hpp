@@ -99,6 +99,8 @@ void Exx_LRI<Tdata>::init(const MPI_Comm &mpi_comm_in,
 		orb,
 		this->lcaos, this->abfs, this->abfs_ccp,
 		this->info.kmesh_times, this->info.ccp_rmesh_times );
+	this->cv.set_cache_memory_max(static_cast<std::size_t>(this->info.cv_cache_memory * 1024 * 1024));
+	this->cv.set_reuse_tol(this->info.cv_reuse_tol);
 
 	ModuleBase::timer::tick("Exx_LRI", "init");
 }
@@ -138,7 +140,7 @@ void Exx_LRI<Tdata>::cal_exx_ions(const UnitCell& ucell,
 		Vs = this->cv.cal_Vs(ucell,
 			list_As_Vs.first, list_As_Vs.second[0],
 			{{"writable_Vws",true}});
-	this->cv.Vws = LRI_CV_Tools::get_CVws(ucell,Vs);
+	this->cv.Vws.set(LRI_CV_Tools::get_CVws(ucell,Vs));
 	if (write_cv && GlobalV::MY_RANK == 0)
 		{ LRI_CV_Tools::write_Vs_abf(Vs, PARAM.globalv.global_out_dir + "Vs"); }
 	this->exx_lri.set_Vs(std::move(Vs), this->info.V_threshold);
@@ -149,7 +151,7 @@ void Exx_LRI<Tdata>::cal_exx_ions(const UnitCell& ucell,
 			dVs = this->cv.cal_dVs(ucell,
 				list_As_Vs.first, list_As_Vs.second[0],
 				{{"writable_dVws",true}});
-		this->cv.dVws = LRI_CV_Tools::get_dCVws(ucell,dVs);
+		this->cv.dVws.set(LRI_CV_Tools::get_dCVws(ucell,dVs));
 		this->exx_lri.set_dVs(std::move(dVs), this->info.V_grad_threshold);
 		if(PARAM.inp.cal_stress)
 		{
@@ -169,7 +171,7 @@ void Exx_LRI<Tdata>::cal_exx_ions(const UnitCell& ucell,
 			{{"cal_dC",PARAM.inp.cal_force||PARAM.inp.cal_stress},
 			 {"writable_Cws",true}, {"writable_dCws",true}, {"writable_Vws",false}, {"writable_dVws",false}});
 	std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> &Cs = std::get<0>(Cs_dCs);
-	this->cv.Cws = LRI_CV_Tools::get_CVws(ucell,Cs);
+	this->cv.Cws.set(LRI_CV_Tools::get_CVws(ucell,Cs));
 	if (write_cv && GlobalV::MY_RANK == 0)
 		{ LRI_CV_Tools::write_Cs_ao(Cs, PARAM.globalv.global_out_dir + "Cs"); }
 	this->exx_lri.set_Cs(std::move(Cs), this->info.C_threshold);
@@ -177,7 +179,7 @@ void Exx_LRI<Tdata>::cal_exx_ions(const UnitCell& ucell,
 	if(PARAM.inp.cal_force || PARAM.inp.cal_stress)
 	{
 		std::array<std::map<TA,std::map<TAC,RI::Tensor<Tdata>>>,3> &dCs = std::get<1>(Cs_dCs);
-		this->cv.dCws = LRI_CV_Tools::get_dCVws(ucell,dCs);
+		this->cv.dCws.set(LRI_CV_Tools::get_dCVws(ucell,dCs));
 		this->exx_lri.set_dCs(std::move(dCs), this->info.C_grad_threshold);
 		if(PARAM.inp.cal_stress)
 		{
@@ -185,6 +187,7 @@ void Exx_LRI<Tdata>::cal_exx_ions(const UnitCell& ucell,
 			this->exx_lri.set_dCRs(std::move(dCRs), this->info.C_grad_R_threshold);
 		}
 	}
+	this->cv.print_cache_info(GlobalV::ofs_running);
 	ModuleBase::timer::tick("Exx_LRI", "cal_exx_ions");
 }
 
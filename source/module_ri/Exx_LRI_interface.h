@@ -43,6 +43,9 @@ public:
     void write_Hexxs_cereal(const std::string& file_name) const;
     void read_Hexxs_cereal(const std::string& file_name);
 
+    /// write the Cs, Vs of the last ionic step to GlobalC::restart.folder, to be reused by cv_reuse_tol after restart
+    void write_CVs_restart() const;
+
     std::vector<std::map<int, std::map<TAC, RI::Tensor<Tdata>>>>& get_Hexxs() const { return this->exx_ptr->Hexxs; }
     
     double& get_Eexx() const { return this->exx_ptr->Eexx; }
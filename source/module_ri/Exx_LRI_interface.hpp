@@ -12,6 +12,7 @@
 
 #include <sys/time.h>
 #include "module_io/csr_reader.h"
+#include "module_io/restart_exx_csr.h"
 #include "module_io/write_HS_sparse.h"
 #include "module_elecstate/elecstate_lcao.h"
 
@@ -26,6 +27,16 @@ void Exx_LRI_Interface<T, Tdata>::write_Hexxs_cereal(const std::string& file_nam
     ModuleBase::timer::tick("Exx_LRI", "write_Hexxs_cereal");
 }
 
+template<typename T, typename Tdata>
+void Exx_LRI_Interface<T, Tdata>::write_CVs_restart() const
+{
+    if (GlobalC::exx_info.info_ri.cv_reuse_tol > 0 && GlobalC::restart.info_save.save_H)
+    {
+        const std::string restart_CVs_path = GlobalC::restart.folder + "CVs" + std::to_string(GlobalV::MY_RANK);
+        ModuleIO::write_CVs_cereal(restart_CVs_path, this->exx_ptr->cv.datas_last);
+    }
+}
+
 template<typename T, typename Tdata>
 void Exx_LRI_Interface<T, Tdata>::read_Hexxs_cereal(const std::string& file_name)
 {
@@ -83,6 +94,14 @@ void Exx_LRI_Interface<T, Tdata>::exx_beforescf(const int istep,
                 XC_Functional::set_xc_type("pbe");
             }
         }
+        // the Cs, Vs of the last ionic step to be reused, see LRI_CV::cal_datas()
+        const bool flag_reuse_cv = (GlobalC::exx_info.info_ri.cv_reuse_tol > 0);
+        const std::string restart_CVs_path = GlobalC::restart.folder + "CVs" + std::to_string(GlobalV::MY_RANK);
+        if (flag_reuse_cv && GlobalC::restart.info_load.load_H && istep == 0)
+        {
+            if (ModuleIO::read_CVs_cereal(restart_CVs_path, this->exx_ptr->cv.datas_last))
+                { GlobalV::ofs_running << " read Cs, Vs to reuse from " << restart_CVs_path << std::endl; }
+        }
         this->exx_ptr->cal_exx_ions(ucell,PARAM.inp.out_ri_cv);
     }
 
@@ -8,6 +8,7 @@
 
 #include "Matrix_Orbs11.h"
 #include "Matrix_Orbs21.h"
+#include "LRI_CV_Cache.h"
 #include "module_basis/module_ao/ORB_atomic_lm.h"
 #include "module_base/abfs-vector3_order.h"
 #include "module_base/element_basis_index.h"
@@ -18,7 +19,8 @@
 #include <vector>
 #include <map>
 #include <functional>
-#include <pthread.h>
+#include <ostream>
+#include <string>
 
 template<typename Tdata>
 class LRI_CV
@@ -63,6 +65,28 @@ public:
 	
 	size_t get_index_abfs_size(const size_t &iat){return this->index_abfs[iat].count_size; }
 
+	// maximal memory (bytes) of each of Vws, Cws, dVws, dCws, 0 for no limit
+	void set_cache_memory_max(const std::size_t memory_max);
+	// hits, misses, waits, evictions and memory of Vws, Cws, dVws, dCws
+	void print_cache_info(std::ostream &os) const;
+
+	// reuse the tensors of the atom pairs moved less than reuse_tol (Bohr) since they were calculated, 0 for no reuse
+	void set_reuse_tol(const double reuse_tol_in){ this->reuse_tol = reuse_tol_in; }
+
+	// Datas_last[iat0][{iat1,cell1}] = {R_delta (Bohr) when Data was calculated, Data}
+	template<typename Tresult>
+	using T_Datas_last = std::map<TA,std::map<TAC,std::pair<Abfs::Vector3_Order<double>,Tresult>>>;
+	// the tensors of the last ionic step reused by cal_Vs(), cal_dVs() and cal_Cs_dCs(), saved for restart
+	struct Datas_Last
+	{
+		T_Datas_last<RI::Tensor<Tdata>> Vs;
+		T_Datas_last<std::array<RI::Tensor<Tdata>,3>> dVs;
+		T_Datas_last<std::pair<RI::Tensor<Tdata>, std::array<RI::Tensor<Tdata>,3>>> Cs_dCs;
+		bool with_dC = false;		// whether dC is in Cs_dCs
+		template<class Archive> void serialize(Archive &ar){ ar(Vs, dVs, Cs_dCs, with_dC); }
+	};
+	Datas_Last datas_last;
+
 private:
     std::vector<double> orb_cutoff_;
 	std::vector<std::vector<std::vector<Numerical_Orbital_Lm>>> lcaos;
@@ -71,18 +95,15 @@ private:
 	ModuleBase::Element_Basis_Index::IndexLNM index_lcaos;
 	ModuleBase::Element_Basis_Index::IndexLNM index_abfs;
 	double ccp_rmesh_times;
+	double reuse_tol = 0.0;
 
 public:
-	std::map<int,std::map<int,std::map<Abfs::Vector3_Order<double>,RI::Tensor<Tdata>>>> Vws;
-	std::map<int,std::map<int,std::map<Abfs::Vector3_Order<double>,RI::Tensor<Tdata>>>> Cws;
-	std::map<int,std::map<int,std::map<Abfs::Vector3_Order<double>,std::array<RI::Tensor<Tdata>,3>>>> dVws;
-	std::map<int,std::map<int,std::map<Abfs::Vector3_Order<double>,std::array<RI::Tensor<Tdata>,3>>>> dCws;
+	// Vws[it0][it1][R], shared by all threads in cal_Vs(), cal_dVs() and cal_Cs_dCs()
+	LRI_CV_Cache<RI::Tensor<Tdata>> Vws;
+	LRI_CV_Cache<RI::Tensor<Tdata>> Cws;
+	LRI_CV_Cache<std::array<RI::Tensor<Tdata>,3>> dVws;
+	LRI_CV_Cache<std::array<RI::Tensor<Tdata>,3>> dCws;
 private:
-	pthread_rwlock_t rwlock_Vw;
-	pthread_rwlock_t rwlock_Cw;
-	pthread_rwlock_t rwlock_dVw;
-	pthread_rwlock_t rwlock_dCw;
-
 	Matrix_Orbs11 m_abfs_abfs;
 	Matrix_Orbs21 m_abfslcaos_lcaos;
 
@@ -100,7 +121,9 @@ private:
 		const std::vector<TAC> &list_A1,
 		const std::map<std::string,bool> &flags,
 		const double &rmesh_times,
-		const T_func_DPcal_data<Tresult> &func_DPcal_data);
+		const T_func_DPcal_data<Tresult> &func_DPcal_data,
+		const std::string &label,
+		T_Datas_last<Tresult> &Datas_last);
 
 	inline RI::Tensor<Tdata>
 	DPcal_V(
@@ -120,6 +143,12 @@ private:
 		const int it1,
 		const Abfs::Vector3_Order<double> &R,
 		const std::map<std::string,bool> &flags);						// "cal_dC", "writable_Cws", "writable_dCws", "writable_Vws", "writable_dVws"
+	std::pair<RI::Tensor<Tdata>, std::array<RI::Tensor<Tdata>,3>>
+	cal_C_dC(
+		const int it0,
+		const int it1,
+		const Abfs::Vector3_Order<double> &R,
+		const std::map<std::string,bool> &flags);						// "cal_dC", "writable_Cws", "writable_dCws", "writable_Vws", "writable_dVws"
 
 	template<typename To11, typename Tfunc>
 	To11 DPcal_o11(
@@ -127,8 +156,7 @@ private:
 		const int it1,
 		const Abfs::Vector3_Order<double> &R,
 		const bool &flag_writable_o11ws,
-		pthread_rwlock_t &rwlock_o11,
-		std::map<int,std::map<int,std::map<Abfs::Vector3_Order<double>,To11>>> &o11ws,
+		LRI_CV_Cache<To11> &o11ws,
 		const Tfunc &func_cal_o11);
 };
 
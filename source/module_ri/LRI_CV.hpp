@@ -12,26 +12,46 @@
 #include "RI_Util.h"
 #include "../module_base/tool_title.h"
 #include "../module_base/timer.h"
+#include "../module_base/global_variable.h"
 #include "../module_hamilt_pw/hamilt_pwdft/global.h"
 #include <RI/global/Global_Func-1.h>
 #include <omp.h>
 
 template<typename Tdata>
 LRI_CV<Tdata>::LRI_CV()
+	:Vws([](const RI::Tensor<Tdata> &V){ return LRI_CV_Tools::get_memory(V); }),
+	 Cws([](const RI::Tensor<Tdata> &C){ return LRI_CV_Tools::get_memory(C); }),
+	 dVws([](const std::array<RI::Tensor<Tdata>,3> &dV){ return LRI_CV_Tools::get_memory(dV); }),
+	 dCws([](const std::array<RI::Tensor<Tdata>,3> &dC){ return LRI_CV_Tools::get_memory(dC); })
+{}
+
+template<typename Tdata>
+LRI_CV<Tdata>::~LRI_CV()
+{}
+
+template<typename Tdata>
+void LRI_CV<Tdata>::set_cache_memory_max(const std::size_t memory_max)
 {
-	pthread_rwlock_init(&rwlock_Vw,NULL);
-	pthread_rwlock_init(&rwlock_Cw,NULL);
-	pthread_rwlock_init(&rwlock_dVw,NULL);
-	pthread_rwlock_init(&rwlock_dCw,NULL);
+	this->Vws.set_memory_max(memory_max);
+	this->Cws.set_memory_max(memory_max);
+	this->dVws.set_memory_max(memory_max);
+	this->dCws.set_memory_max(memory_max);
 }
 
 template<typename Tdata>
-LRI_CV<Tdata>::~LRI_CV()
+void LRI_CV<Tdata>::print_cache_info(std::ostream &os) const
 {
-	pthread_rwlock_destroy(&rwlock_Vw);
-	pthread_rwlock_destroy(&rwlock_Cw);
-	pthread_rwlock_destroy(&rwlock_dVw);
-	pthread_rwlock_destroy(&rwlock_dCw);
+	auto print = [&os](const std::string &name, const LRI_CV_Cache_Info &info)
+	{
+		os << " LRI_CV cache " << name
+		   << ": hits " << info.hits << ", misses " << info.misses << ", waits " << info.waits
+		   << ", evictions " << info.evictions << ", entries " << info.entries
+		   << ", memory " << info.memory / 1024.0 / 1024.0 << " MB" << std::endl;
+	};
+	print("Vws", this->Vws.get_info());
+	print("Cws", this->Cws.get_info());
+	print("dVws", this->dVws.get_info());
+	print("dCws", this->dCws.get_info());
 }
 
 
@@ -82,13 +102,19 @@ auto LRI_CV<Tdata>::cal_datas(
 	const std::vector<TAC> &list_A1,
 	const std::map<std::string,bool> &flags,
 	const double &rmesh_times,
-	const T_func_DPcal_data<Tresult> &func_DPcal_data)
+	const T_func_DPcal_data<Tresult> &func_DPcal_data,
+	const std::string &label,
+	T_Datas_last<Tresult> &Datas_last)
 -> std::map<TA,std::map<TAC,Tresult>>
 {
 	ModuleBase::TITLE("LRI_CV","cal_datas");
 	ModuleBase::timer::tick("LRI_CV", "cal_datas");
 
+	const bool flag_reuse = (this->reuse_tol > 0);
 	std::map<TA,std::map<TAC,Tresult>> Datas;
+	T_Datas_last<Tresult> Datas_new;
+	std::size_t num_reuse = 0, num_cal = 0;
+	double time_cal = 0;			// seconds of func_DPcal_data(), summed over threads
 	#pragma omp parallel
 	for(size_t i0=0; i0<list_A0.size(); ++i0)
 	{
@@ -110,15 +136,58 @@ auto LRI_CV<Tdata>::cal_datas(
 			const Abfs::Vector3_Order<double> R_delta = -tau0+tau1+(RI_Util::array3_to_Vector3(cell1)*ucell.latvec);
 			if( R_delta.norm()*ucell.lat0 < Rcut )
 			{
-				const Tresult Data = func_DPcal_data(it0, it1, R_delta, flags);
-				// if(Data.norm(std::numeric_limits<double>::max()) > threshold)
-				// {
+				const Abfs::Vector3_Order<double> R_bohr = R_delta * ucell.lat0;
+				// the R when Data_last was calculated is kept,
+				// so that the displacement accumulated over the ionic steps is compared with reuse_tol
+				const std::pair<Abfs::Vector3_Order<double>,Tresult>* Data_last = nullptr;
+				if(flag_reuse)
+				{
+					const auto ptr0 = Datas_last.find(iat0);
+					if(ptr0 != Datas_last.end())
+					{
+						const auto ptr1 = ptr0->second.find(list_A1[i1]);
+						if(ptr1 != ptr0->second.end() && (ptr1->second.first - R_bohr).norm() < this->reuse_tol)
+							{ Data_last = &ptr1->second; }
+					}
+				}
+				if(Data_last)
+				{
 					#pragma omp critical(LRI_CV_cal_datas)
-					Datas[list_A0[i0]][list_A1[i1]] = Data;
-				// }
+					{
+						Datas[list_A0[i0]][list_A1[i1]] = Data_last->second;
+						Datas_new[list_A0[i0]][list_A1[i1]] = *Data_last;
+						++num_reuse;
+					}
+				}
+				else
+				{
+					const double time_begin = omp_get_wtime();
+					const Tresult Data = func_DPcal_data(it0, it1, R_delta, flags);
+					const double time_Data = omp_get_wtime() - time_begin;
+					// if(Data.norm(std::numeric_limits<double>::max()) > threshold)
+					// {
+						#pragma omp critical(LRI_CV_cal_datas)
+						{
+							Datas[list_A0[i0]][list_A1[i1]] = Data;
+							if(flag_reuse)
+								{ Datas_new[list_A0[i0]][list_A1[i1]] = std::make_pair(R_bohr, Data); }
+							++num_cal;
+							time_cal += time_Data;
+						}
+					// }
+				}
 			}
 		}
 	}
+
+	if(flag_reuse)
+	{
+		Datas_last = std::move(Datas_new);
+		const std::size_t num_all = num_reuse + num_cal;
+		const double time_saved = num_cal ? time_cal / num_cal * num_reuse / omp_get_max_threads() : 0.0;
+		GlobalV::ofs_running << " LRI_CV " << label << ": reused " << num_reuse << " / " << num_all << " atom pairs ("
+			<< (num_all ? 100.0 * num_reuse / num_all : 0.0) << "%), estimated time saved " << time_saved << " s" << std::endl;
+	}
 	ModuleBase::timer::tick("LRI_CV", "cal_datas");
 	return Datas;
 }
@@ -137,7 +206,7 @@ auto LRI_CV<Tdata>::cal_Vs(
 		func_DPcal_V = std::bind(
 			&LRI_CV<Tdata>::DPcal_V, this,
 			std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
-	return this->cal_datas(ucell,list_A0, list_A1, flags, this->ccp_rmesh_times, func_DPcal_V);
+	return this->cal_datas(ucell,list_A0, list_A1, flags, this->ccp_rmesh_times, func_DPcal_V, "Vs", this->datas_last.Vs);
 }
 
 template<typename Tdata>
@@ -154,7 +223,7 @@ auto LRI_CV<Tdata>::cal_dVs(
 			&LRI_CV<Tdata>::DPcal_dV, this,
 			std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
 	return LRI_CV_Tools::change_order(
-		this->cal_datas(ucell,list_A0, list_A1, flags, this->ccp_rmesh_times, func_DPcal_dV));
+		this->cal_datas(ucell,list_A0, list_A1, flags, this->ccp_rmesh_times, func_DPcal_dV, "dVs", this->datas_last.dVs));
 }
 
 template<typename Tdata>
@@ -170,8 +239,12 @@ auto LRI_CV<Tdata>::cal_Cs_dCs(
 		func_DPcal_C_dC = std::bind(
 			&LRI_CV<Tdata>::DPcal_C_dC, this,
 			std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
+	// the Cs_dCs stored without dC can not be reused when dC is needed
+	if(flags.at("cal_dC") && !this->datas_last.with_dC)
+		{ this->datas_last.Cs_dCs.clear(); }
+	this->datas_last.with_dC = flags.at("cal_dC");
 	std::map<TA,std::map<TAC, std::pair<RI::Tensor<Tdata>, std::array<RI::Tensor<Tdata>,3>>>>
-		Cs_dCs_tmp = this->cal_datas(ucell,list_A0, list_A1, flags, std::min(1.0,this->ccp_rmesh_times), func_DPcal_C_dC);
+		Cs_dCs_tmp = this->cal_datas(ucell,list_A0, list_A1, flags, std::min(1.0,this->ccp_rmesh_times), func_DPcal_C_dC, "Cs_dCs", this->datas_last.Cs_dCs);
 
 	std::map<TA,std::map<TAC,RI::Tensor<Tdata>>> Cs;
 	std::array<std::map<TA,std::map<TAC,RI::Tensor<Tdata>>>,3> dCs;
@@ -193,51 +266,36 @@ To11 LRI_CV<Tdata>::DPcal_o11(
 	const int it1,
 	const Abfs::Vector3_Order<double> &R,
 	const bool &flag_writable_o11ws,
-	pthread_rwlock_t &rwlock_o11,
-	std::map<int,std::map<int,std::map<Abfs::Vector3_Order<double>,To11>>> &o11ws,
+	LRI_CV_Cache<To11> &o11ws,
 	const Tfunc &func_cal_o11)
 {
 	const Abfs::Vector3_Order<double> Rm = -R;
-	pthread_rwlock_rdlock(&rwlock_o11);
-	const To11 o11_read = RI::Global_Func::find(o11ws, it0, it1, R);
-	pthread_rwlock_unlock(&rwlock_o11);
+	const auto cal_o11 = [&]() -> To11
+	{
+		To11 o11_transform_read;
+		if(o11ws.find(it1, it0, Rm, o11_transform_read))
+		{
+			// such write may be deleted for memory saving with transform_Rm() every time
+			return LRI_CV_Tools::transform_Rm(o11_transform_read);
+		}
+		return func_cal_o11(
+			it0, it1, ModuleBase::Vector3<double>{0,0,0}, R,
+			this->index_abfs, this->index_abfs,
+			Matrix_Orbs11::Matrix_Order::AB);
+	};
 
-	if(LRI_CV_Tools::exist(o11_read))
+	if(flag_writable_o11ws)
 	{
-		return o11_read;
+		// the other threads asking for the same (it0,it1,R) wait for the result instead of computing it again
+		return o11ws.get_or_compute(it0, it1, R, cal_o11);
 	}
 	else
 	{
-		pthread_rwlock_rdlock(&rwlock_o11);
-		const To11 o11_transform_read = RI::Global_Func::find(o11ws, it1, it0, Rm);
-		pthread_rwlock_unlock(&rwlock_o11);
-
-		if(LRI_CV_Tools::exist(o11_transform_read))
-		{
-			const To11 o11 = LRI_CV_Tools::transform_Rm(o11_transform_read);
-			if(flag_writable_o11ws)							// such write may be deleted for memory saving with transform_Rm() every time
-			{
-				pthread_rwlock_wrlock(&rwlock_o11);
-				o11ws[it0][it1][R] = o11;
-				pthread_rwlock_unlock(&rwlock_o11);
-			}
-			return o11;
-		}
-		else
-		{
-			const To11 o11 = func_cal_o11(
-				it0, it1, ModuleBase::Vector3<double>{0,0,0}, R,
-				this->index_abfs, this->index_abfs,
-				Matrix_Orbs11::Matrix_Order::AB);
-			if(flag_writable_o11ws)
-			{
-				pthread_rwlock_wrlock(&rwlock_o11);
-				o11ws[it0][it1][R] = o11;
-				pthread_rwlock_unlock(&rwlock_o11);
-			}
-			return o11;
-		} // end else (!exist(o11_transform_read))
-	} // end else (!exist(o11_read))
+		To11 o11_read;
+		if(o11ws.find(it0, it1, R, o11_read))
+			{ return o11_read; }
+		return cal_o11();
+	}
 }
 
 template<typename Tdata>
@@ -252,7 +310,7 @@ LRI_CV<Tdata>::DPcal_V(
 		&Matrix_Orbs11::cal_overlap_matrix<Tdata>,
 		&this->m_abfs_abfs,
 		std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5, std::placeholders::_6, std::placeholders::_7);
-	return this->DPcal_o11(it0, it1, R, flags.at("writable_Vws"), this->rwlock_Vw, this->Vws, cal_overlap_matrix);
+	return this->DPcal_o11(it0, it1, R, flags.at("writable_Vws"), this->Vws, cal_overlap_matrix);
 }
 
 template<typename Tdata>
@@ -269,11 +327,7 @@ LRI_CV<Tdata>::DPcal_dV(
 		const size_t size = this->index_abfs[it0].count_size;
 		const std::array<RI::Tensor<Tdata>, 3> dV = { RI::Tensor<Tdata>({size,size}), RI::Tensor<Tdata>({size,size}), RI::Tensor<Tdata>({size,size}) };
 		if(flags.at("writable_dVws"))
-		{
-			pthread_rwlock_wrlock(&this->rwlock_dVw);
-			this->dVws[it0][it1][R] = dV;
-			pthread_rwlock_unlock(&this->rwlock_dVw);
-		}
+			{ this->dVws.insert(it0, it1, R, dV); }
 		return dV;
 	}
 
@@ -281,7 +335,7 @@ LRI_CV<Tdata>::DPcal_dV(
 		&Matrix_Orbs11::cal_grad_overlap_matrix<Tdata>,
 		&this->m_abfs_abfs,
 		std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5, std::placeholders::_6, std::placeholders::_7);
-	return this->DPcal_o11(it0, it1, R, flags.at("writable_dVws"), this->rwlock_dVw, this->dVws, cal_grad_overlap_matrix);
+	return this->DPcal_o11(it0, it1, R, flags.at("writable_dVws"), this->dVws, cal_grad_overlap_matrix);
 }
 
 
@@ -292,133 +346,141 @@ LRI_CV<Tdata>::DPcal_C_dC(
 	const int it1,
 	const Abfs::Vector3_Order<double> &R,
 	const std::map<std::string,bool> &flags)					// "cal_dC", "writable_Cws", "writable_dCws" + "writable_Vws", "writable_dVws"
+{
+	std::pair<RI::Tensor<Tdata>, std::array<RI::Tensor<Tdata>,3>> C_dC;
+	bool flag_computed = false;
+	const auto cal_C = [&]() -> RI::Tensor<Tdata>
+	{
+		C_dC = this->cal_C_dC(it0, it1, R, flags);
+		flag_computed = true;
+		return C_dC.first;
+	};
+
+	RI::Tensor<Tdata> C_read;
+	if(flags.at("writable_Cws"))
+		{ C_read = this->Cws.get_or_compute(it0, it1, R, cal_C); }		// the other threads asking for the same (it0,it1,R) wait here
+	else
+		{ this->Cws.find(it0, it1, R, C_read); }
+	if(flag_computed)
+		{ return C_dC; }
+
+	std::array<RI::Tensor<Tdata>,3> dC_read;
+	if(LRI_CV_Tools::exist(C_read) && (!flags.at("cal_dC") || this->dCws.find(it0, it1, R, dC_read)))
+		{ return std::make_pair(C_read, dC_read); }
+	// C is cached without dC
+	return this->cal_C_dC(it0, it1, R, flags);
+}
+
+template<typename Tdata>
+std::pair<RI::Tensor<Tdata>, std::array<RI::Tensor<Tdata>,3>>
+LRI_CV<Tdata>::cal_C_dC(
+	const int it0,
+	const int it1,
+	const Abfs::Vector3_Order<double> &R,
+	const std::map<std::string,bool> &flags)					// "cal_dC", "writable_Cws", "writable_dCws" + "writable_Vws", "writable_dVws"
 {
 	using namespace LRI_CV_Tools;
 
 	const Abfs::Vector3_Order<double> Rm = -R;
-	pthread_rwlock_rdlock(&this->rwlock_Cw);
-	const RI::Tensor<Tdata> C_read = RI::Global_Func::find(this->Cws, it0, it1, R);
-	pthread_rwlock_unlock(&this->rwlock_Cw);
-	pthread_rwlock_rdlock(&this->rwlock_dCw);
-	const std::array<RI::Tensor<Tdata>,3> dC_read = RI::Global_Func::find(this->dCws, it0, it1, R);
-	pthread_rwlock_unlock(&this->rwlock_dCw);
-	const bool flag_finish_dC = (!flags.at("cal_dC")) || LRI_CV_Tools::exist(dC_read);
-
-	if(!C_read.empty() && flag_finish_dC)
+	std::array<RI::Tensor<Tdata>,3> dC_read;
+	const bool flag_finish_dC = (!flags.at("cal_dC")) || this->dCws.find(it0, it1, R, dC_read);
+
+	if( (ModuleBase::Vector3<double>(0,0,0)==R) && (it0==it1) )
 	{
-		return std::make_pair(C_read, dC_read);
-	}
+		const RI::Tensor<Tdata>
+			A = this->m_abfslcaos_lcaos.template cal_overlap_matrix<Tdata>(
+					it0, it1, {0,0,0}, {0,0,0},
+					this->index_abfs, this->index_lcaos, this->index_lcaos,
+					Matrix_Orbs21::Matrix_Order::A1A2B);
+		const RI::Tensor<Tdata> V = this->DPcal_V( it0, it0, {0,0,0}, {{"writable_Vws",true}});
+		const RI::Tensor<Tdata> L = LRI_CV_Tools::cal_I(V);
+
+		const RI::Tensor<Tdata> C = RI::Global_Func::convert<Tdata>(0.5) * LRI_CV_Tools::mul1(L,A);					// Attention 0.5!
+		if(flags.at("writable_Cws"))
+			{ this->Cws.insert(it0, it1, {0,0,0}, C); }
+
+		if(flag_finish_dC)
+		{
+			return std::make_pair(C, dC_read);
+		}
+		else
+		{
+			const RI::Shape_Vector sizes = {this->index_abfs[it0].count_size,
+			                                this->index_lcaos[it0].count_size,
+			                                this->index_lcaos[it0].count_size};
+			const std::array<RI::Tensor<Tdata>,3>
+				dC({RI::Tensor<Tdata>({sizes}), RI::Tensor<Tdata>({sizes}), RI::Tensor<Tdata>({sizes})});
+			if(flags.at("writable_dCws"))
+				{ this->dCws.insert(it0, it1, {0,0,0}, dC); }
+			return std::make_pair(C, dC);
+		}
+	} // end if( (ModuleBase::Vector3<double>(0,0,0)==R) && (it0==it1) )
 	else
 	{
-		if( (ModuleBase::Vector3<double>(0,0,0)==R) && (it0==it1) )
+		const std::vector<RI::Tensor<Tdata>>
+			A = {this->m_abfslcaos_lcaos.template cal_overlap_matrix<Tdata>(
+					it0, it1, {0,0,0}, R,
+					this->index_abfs, this->index_lcaos, this->index_lcaos,
+					Matrix_Orbs21::Matrix_Order::A1A2B),
+			     this->m_abfslcaos_lcaos.template cal_overlap_matrix<Tdata>(
+					it1, it0, {0,0,0}, Rm,
+					this->index_abfs, this->index_lcaos, this->index_lcaos,
+					Matrix_Orbs21::Matrix_Order::A1BA2)};
+
+		const std::vector<std::vector<RI::Tensor<Tdata>>>
+			V = {{DPcal_V(it0, it0, {0,0,0}, {{"writable_Vws",true}}),
+			      DPcal_V(it0, it1, R,       flags)},
+			     {DPcal_V(it1, it0, Rm,      flags),
+			      DPcal_V(it1, it1, {0,0,0}, {{"writable_Vws",true}})}};
+
+		const std::vector<std::vector<RI::Tensor<Tdata>>>
+			L = LRI_CV_Tools::cal_I(V);
+
+		const std::vector<RI::Tensor<Tdata>> C = LRI_CV_Tools::mul2(L,A);
+		if(flags.at("writable_Cws"))
 		{
-			const RI::Tensor<Tdata>
-				A = this->m_abfslcaos_lcaos.template cal_overlap_matrix<Tdata>(
-						it0, it1, {0,0,0}, {0,0,0},
-						this->index_abfs, this->index_lcaos, this->index_lcaos,
-						Matrix_Orbs21::Matrix_Order::A1A2B);
-			const RI::Tensor<Tdata> V = this->DPcal_V( it0, it0, {0,0,0}, {{"writable_Vws",true}});
-			const RI::Tensor<Tdata> L = LRI_CV_Tools::cal_I(V);
-
-			const RI::Tensor<Tdata> C = RI::Global_Func::convert<Tdata>(0.5) * LRI_CV_Tools::mul1(L,A);					// Attention 0.5!
-			if(flags.at("writable_Cws"))
-			{
-				pthread_rwlock_wrlock(&this->rwlock_Cw);
-				this->Cws[it0][it1][{0,0,0}] = C;
-				pthread_rwlock_unlock(&this->rwlock_Cw);
-			}
+			this->Cws.insert(it0, it1, R, C[0]);
+			this->Cws.insert(it1, it0, Rm, LRI_CV_Tools::transpose12(C[1]));
+		}
 
-			if(flag_finish_dC)
-			{
-				return std::make_pair(C, dC_read);
-			}
-			else
-			{
-				const RI::Shape_Vector sizes = {this->index_abfs[it0].count_size,
-				                                this->index_lcaos[it0].count_size,
-				                                this->index_lcaos[it0].count_size};
-				const std::array<RI::Tensor<Tdata>,3>
-					dC({RI::Tensor<Tdata>({sizes}), RI::Tensor<Tdata>({sizes}), RI::Tensor<Tdata>({sizes})});
-				if(flags.at("writable_dCws"))
-				{
-					pthread_rwlock_wrlock(&this->rwlock_dCw);
-					this->dCws[it0][it1][{0,0,0}] = dC;
-					pthread_rwlock_unlock(&this->rwlock_dCw);
-				}
-				return std::make_pair(C, dC);
-			}
-		} // end if( (ModuleBase::Vector3<double>(0,0,0)==R) && (it0==it1) )
+		if(flag_finish_dC)
+		{
+			return std::make_pair(C[0], dC_read);
+		}
 		else
 		{
-			const std::vector<RI::Tensor<Tdata>>
-				A = {this->m_abfslcaos_lcaos.template cal_overlap_matrix<Tdata>(
-						it0, it1, {0,0,0}, R,
-						this->index_abfs, this->index_lcaos, this->index_lcaos,
-						Matrix_Orbs21::Matrix_Order::A1A2B),
-				     this->m_abfslcaos_lcaos.template cal_overlap_matrix<Tdata>(
-						it1, it0, {0,0,0}, Rm,
-						this->index_abfs, this->index_lcaos, this->index_lcaos,
-						Matrix_Orbs21::Matrix_Order::A1BA2)};
-
-			const std::vector<std::vector<RI::Tensor<Tdata>>>
-				V = {{DPcal_V(it0, it0, {0,0,0}, {{"writable_Vws",true}}),
-				      DPcal_V(it0, it1, R,       flags)},
-				     {DPcal_V(it1, it0, Rm,      flags),
-				      DPcal_V(it1, it1, {0,0,0}, {{"writable_Vws",true}})}};
-
-			const std::vector<std::vector<RI::Tensor<Tdata>>>
-				L = LRI_CV_Tools::cal_I(V);
-
-			const std::vector<RI::Tensor<Tdata>> C = LRI_CV_Tools::mul2(L,A);
-			if(flags.at("writable_Cws"))
-			{
-				pthread_rwlock_wrlock(&this->rwlock_Cw);
-				this->Cws[it0][it1][R] = C[0];
-				this->Cws[it1][it0][Rm] = LRI_CV_Tools::transpose12(C[1]);
-				pthread_rwlock_unlock(&this->rwlock_Cw);
-			}
-
-			if(flag_finish_dC)
+			const std::vector<std::array<RI::Tensor<Tdata>,3>>
+				dA = {this->m_abfslcaos_lcaos.template cal_grad_overlap_matrix<Tdata>(
+							it0, it1, {0,0,0}, R,
+							this->index_abfs, this->index_lcaos, this->index_lcaos,
+							Matrix_Orbs21::Matrix_Order::A1A2B),
+				      LRI_CV_Tools::negative(
+				       this->m_abfslcaos_lcaos.template cal_grad_overlap_matrix<Tdata>(
+							it1, it0, {0,0,0}, Rm,
+							this->index_abfs, this->index_lcaos, this->index_lcaos,
+							Matrix_Orbs21::Matrix_Order::A1BA2))};
+
+			const std::array<RI::Tensor<Tdata>,3> dV_01 = DPcal_dV(it0, it1, R, flags);
+			const std::array<RI::Tensor<Tdata>,3> dV_10 = LRI_CV_Tools::negative(DPcal_dV(it1, it0, Rm, flags));
+
+			std::array<std::vector<RI::Tensor<Tdata>>,3>		// dC = L*(dA-dV*C)
+				dC_tmp = LRI_CV_Tools::mul2(
+						L,
+						LRI_CV_Tools::change_order( LRI_CV_Tools::minus(
+							dA,
+							std::vector<std::array<RI::Tensor<Tdata>,3>>{
+								LRI_CV_Tools::mul1(dV_01, C[1]),
+								LRI_CV_Tools::mul1(dV_10, C[0])})));
+			const std::vector<std::array<RI::Tensor<Tdata>,3>>
+				dC = LRI_CV_Tools::change_order(std::move(dC_tmp));
+			if(flags.at("writable_dCws"))
 			{
-				return std::make_pair(C[0], dC_read);
+				this->dCws.insert(it0, it1, R, dC[0]);
+				this->dCws.insert(it1, it0, Rm, LRI_CV_Tools::negative(LRI_CV_Tools::transpose12(dC[1])));
 			}
-			else
-			{
-				const std::vector<std::array<RI::Tensor<Tdata>,3>>
-					dA = {this->m_abfslcaos_lcaos.template cal_grad_overlap_matrix<Tdata>(
-								it0, it1, {0,0,0}, R,
-								this->index_abfs, this->index_lcaos, this->index_lcaos,
-								Matrix_Orbs21::Matrix_Order::A1A2B),
-					      LRI_CV_Tools::negative(
-					       this->m_abfslcaos_lcaos.template cal_grad_overlap_matrix<Tdata>(
-								it1, it0, {0,0,0}, Rm,
-								this->index_abfs, this->index_lcaos, this->index_lcaos,
-								Matrix_Orbs21::Matrix_Order::A1BA2))};
-
-				const std::array<RI::Tensor<Tdata>,3> dV_01 = DPcal_dV(it0, it1, R, flags);
-				const std::array<RI::Tensor<Tdata>,3> dV_10 = LRI_CV_Tools::negative(DPcal_dV(it1, it0, Rm, flags));
-
-				std::array<std::vector<RI::Tensor<Tdata>>,3>		// dC = L*(dA-dV*C)
-					dC_tmp = LRI_CV_Tools::mul2(
-							L,
-							LRI_CV_Tools::change_order( LRI_CV_Tools::minus(
-								dA,
-								std::vector<std::array<RI::Tensor<Tdata>,3>>{
-									LRI_CV_Tools::mul1(dV_01, C[1]),
-									LRI_CV_Tools::mul1(dV_10, C[0])})));
-				const std::vector<std::array<RI::Tensor<Tdata>,3>>
-					dC = LRI_CV_Tools::change_order(std::move(dC_tmp));
-				if(flags.at("writable_dCws"))
-				{
-					pthread_rwlock_wrlock(&this->rwlock_dCw);
-					this->dCws[it0][it1][R] = dC[0];
-					this->dCws[it1][it0][Rm] = LRI_CV_Tools::negative(LRI_CV_Tools::transpose12(dC[1]));
-					pthread_rwlock_unlock(&this->rwlock_dCw);
-				}
-				return std::make_pair(C[0], dC[0]);
-			} // end else (!flag_finish_dC)
-		} // end else ( (ModuleBase::Vector3<double>(0,0,0)!=R) || (it0!=it1) )
-	} // end else (!(C_read && flag_finish_dC))
+			return std::make_pair(C[0], dC[0]);
+		} // end else (!flag_finish_dC)
+	} // end else ( (ModuleBase::Vector3<double>(0,0,0)!=R) || (it0!=it1) )
 }
 
 
@@ -0,0 +1,135 @@
+#ifndef LRI_CV_CACHE_H
+#define LRI_CV_CACHE_H
+
+#include "module_base/abfs-vector3_order.h"
+#include "module_base/vector3.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+struct LRI_CV_Cache_Info
+{
+    std::size_t hits = 0;      // found in cache
+    std::size_t misses = 0;    // computed by get_or_compute()
+    std::size_t waits = 0;     // waited for the value computed by another thread
+    std::size_t evictions = 0; // evicted because of memory_max
+    std::size_t entries = 0;
+    std::size_t memory = 0;    // bytes
+};
+
+/**
+ * @brief Concurrent cache of the V/C tensors of LRI_CV, keyed by (it0, it1, R).
+ *
+ * The entries are distributed to nshards shards by the hash of the key, and each shard has its own mutex,
+ * so threads working on different keys hardly ever wait for each other.
+ * get_or_compute() has compute-once semantics: if another thread is computing the same key,
+ * the caller waits for the result instead of computing it again. If that computation throws,
+ * the key is released and one of the waiting threads computes it.
+ * R is quantized with resolution 1e-8 (in unit of lat0), so that the same R obtained from
+ * different atom positions and cells is mapped to the same key.
+ * If memory_max is set, the least recently used entries of a shard are evicted
+ * when the memory of the shard exceeds memory_max / nshards, in O(1) each with the LRU list of the shard.
+ */
+template <typename Tvalue>
+class LRI_CV_Cache
+{
+  public:
+    using T_func_memory = std::function<std::size_t(const Tvalue&)>;
+
+    // get_memory returns the bytes of a value, sizeof(Tvalue) if not given
+    explicit LRI_CV_Cache(const T_func_memory& get_memory = T_func_memory(), const std::size_t nshards = 64);
+
+    LRI_CV_Cache(const LRI_CV_Cache&) = delete;
+    LRI_CV_Cache& operator=(const LRI_CV_Cache&) = delete;
+
+    // bytes, 0 for no limit
+    void set_memory_max(const std::size_t memory_max);
+
+    // return true and set value if the key is cached and ready
+    bool find(const int it0, const int it1, const ModuleBase::Vector3<double>& R, Tvalue& value);
+
+    // cache the value, the value being computed by other threads is not overwritten
+    void insert(const int it0, const int it1, const ModuleBase::Vector3<double>& R, const Tvalue& value);
+
+    // return the cached value, or call func() to compute, cache and return it,
+    // func() is called only once for a key even if several threads ask for it at the same time,
+    // unless it throws, then the exception is passed to the caller and the key is not cached
+    template <typename Tfunc>
+    Tvalue get_or_compute(const int it0, const int it1, const ModuleBase::Vector3<double>& R, const Tfunc& func);
+
+    // replace all the entries with values[it0][it1][R]
+    void set(const std::map<int, std::map<int, std::map<Abfs::Vector3_Order<double>, Tvalue>>>& values);
+
+    void clear();
+
+    using Info = LRI_CV_Cache_Info;
+    Info get_info() const;
+
+    // resolution to quantize R, in unit of lat0
+    static constexpr double R_resolution = 1e-8;
+
+  private:
+    struct Key
+    {
+        int it0;
+        int it1;
+        std::array<long long, 3> R;
+        bool operator==(const Key& k) const
+        {
+            return it0 == k.it0 && it1 == k.it1 && R == k.R;
+        }
+    };
+    struct Key_Hash
+    {
+        std::size_t operator()(const Key& k) const;
+    };
+    // an entry which is not ready is being computed by get_or_compute()
+    struct Entry
+    {
+        Tvalue value;
+        bool ready = false;
+        std::size_t memory = 0;
+        typename std::list<Key>::iterator lru_pos; // position in Shard::lru, only if ready
+    };
+    struct Shard
+    {
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::unordered_map<Key, Entry, Key_Hash> entries;
+        std::list<Key> lru; // keys of the ready entries, the least recently used first
+        std::size_t memory = 0;
+    };
+
+    static Key get_key(const int it0, const int it1, const ModuleBase::Vector3<double>& R);
+    Shard& get_shard(const Key& key);
+    std::size_t get_memory(const Tvalue& value) const;
+
+    // the functions below need shard.mtx locked
+    // move the ready entry to the end of the LRU list
+    static void touch(Shard& shard, Entry& entry);
+    // set the entry ready and evict the least recently used entries of the shard if needed
+    void set_ready(Shard& shard, const Key& key, Entry& entry, const Tvalue& value);
+    void evict(Shard& shard, const Entry& entry_keep);
+
+    T_func_memory func_memory;
+    std::size_t nshards;
+    std::unique_ptr<Shard[]> shards;
+    std::size_t memory_max = 0;
+
+    std::atomic<std::size_t> hits{0};
+    std::atomic<std::size_t> misses{0};
+    std::atomic<std::size_t> waits{0};
+    std::atomic<std::size_t> evictions{0};
+};
+
+#include "LRI_CV_Cache.hpp"
+
+#endif
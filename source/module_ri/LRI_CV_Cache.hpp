@@ -0,0 +1,257 @@
+#ifndef LRI_CV_CACHE_HPP
+#define LRI_CV_CACHE_HPP
+
+#include "LRI_CV_Cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+template <typename Tvalue>
+constexpr double LRI_CV_Cache<Tvalue>::R_resolution;
+
+template <typename Tvalue>
+LRI_CV_Cache<Tvalue>::LRI_CV_Cache(const T_func_memory& get_memory, const std::size_t nshards_in)
+    : func_memory(get_memory), nshards(std::max(nshards_in, static_cast<std::size_t>(1))),
+      shards(new Shard[std::max(nshards_in, static_cast<std::size_t>(1))])
+{
+}
+
+template <typename Tvalue>
+void LRI_CV_Cache<Tvalue>::set_memory_max(const std::size_t memory_max_in)
+{
+    this->memory_max = memory_max_in;
+}
+
+template <typename Tvalue>
+std::size_t LRI_CV_Cache<Tvalue>::Key_Hash::operator()(const Key& k) const
+{
+    std::size_t h = std::hash<int>()(k.it0);
+    auto combine = [&h](const std::size_t v) { h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2); };
+    combine(std::hash<int>()(k.it1));
+    for (const long long x: k.R)
+    {
+        combine(std::hash<long long>()(x));
+    }
+    return h;
+}
+
+template <typename Tvalue>
+auto LRI_CV_Cache<Tvalue>::get_key(const int it0, const int it1, const ModuleBase::Vector3<double>& R) -> Key
+{
+    return Key{it0, it1, {std::llround(R.x / R_resolution), std::llround(R.y / R_resolution), std::llround(R.z / R_resolution)}};
+}
+
+template <typename Tvalue>
+auto LRI_CV_Cache<Tvalue>::get_shard(const Key& key) -> Shard&
+{
+    // the low bits are used by the buckets of unordered_map in the shard
+    return this->shards[(Key_Hash()(key) >> 16) % this->nshards];
+}
+
+template <typename Tvalue>
+std::size_t LRI_CV_Cache<Tvalue>::get_memory(const Tvalue& value) const
+{
+    return this->func_memory ? this->func_memory(value) : sizeof(Tvalue);
+}
+
+template <typename Tvalue>
+bool LRI_CV_Cache<Tvalue>::find(const int it0, const int it1, const ModuleBase::Vector3<double>& R, Tvalue& value)
+{
+    const Key key = get_key(it0, it1, R);
+    Shard& shard = this->get_shard(key);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    const auto ptr = shard.entries.find(key);
+    if (ptr == shard.entries.end() || !ptr->second.ready)
+    {
+        return false;
+    }
+    touch(shard, ptr->second);
+    ++this->hits;
+    value = ptr->second.value;
+    return true;
+}
+
+template <typename Tvalue>
+void LRI_CV_Cache<Tvalue>::insert(const int it0, const int it1, const ModuleBase::Vector3<double>& R, const Tvalue& value)
+{
+    const Key key = get_key(it0, it1, R);
+    Shard& shard = this->get_shard(key);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    const auto ptr = shard.entries.find(key);
+    if (ptr != shard.entries.end() && !ptr->second.ready)
+    {
+        // being computed by another thread, which will set the value
+        return;
+    }
+    this->set_ready(shard, key, shard.entries[key], value);
+}
+
+template <typename Tvalue>
+template <typename Tfunc>
+Tvalue LRI_CV_Cache<Tvalue>::get_or_compute(const int it0,
+                                            const int it1,
+                                            const ModuleBase::Vector3<double>& R,
+                                            const Tfunc& func)
+{
+    const Key key = get_key(it0, it1, R);
+    Shard& shard = this->get_shard(key);
+    std::unique_lock<std::mutex> lock(shard.mtx);
+    bool waited = false;
+    while (true)
+    {
+        const auto ptr = shard.entries.find(key);
+        if (ptr == shard.entries.end())
+        {
+            break;
+        }
+        if (ptr->second.ready)
+        {
+            touch(shard, ptr->second);
+            ++(waited ? this->waits : this->hits);
+            return ptr->second.value;
+        }
+        waited = true;
+        shard.cv.wait(lock);
+    }
+
+    // mark the key in flight, present and !ready
+    Entry& entry = shard.entries[key];
+    lock.unlock();
+
+    // if func() throws, release the key, so that the waiting threads do not wait forever
+    struct In_Flight_Guard
+    {
+        Shard& shard;
+        const Key& key;
+        bool done;
+        ~In_Flight_Guard()
+        {
+            if (this->done)
+            {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(this->shard.mtx);
+                this->shard.entries.erase(this->key);
+            }
+            this->shard.cv.notify_all();
+        }
+    } guard{shard, key, false};
+    const Tvalue value = func();
+
+    lock.lock();
+    // the entries in flight are never evicted, and the references of unordered_map are stable
+    this->set_ready(shard, key, entry, value);
+    guard.done = true;
+    ++this->misses;
+    lock.unlock();
+    shard.cv.notify_all();
+    return value;
+}
+
+template <typename Tvalue>
+void LRI_CV_Cache<Tvalue>::touch(Shard& shard, Entry& entry)
+{
+    shard.lru.splice(shard.lru.end(), shard.lru, entry.lru_pos);
+}
+
+template <typename Tvalue>
+void LRI_CV_Cache<Tvalue>::set_ready(Shard& shard, const Key& key, Entry& entry, const Tvalue& value)
+{
+    if (entry.ready)
+    {
+        shard.memory -= entry.memory;
+        touch(shard, entry);
+    }
+    else
+    {
+        entry.lru_pos = shard.lru.insert(shard.lru.end(), key);
+    }
+    entry.value = value;
+    entry.ready = true;
+    entry.memory = this->get_memory(value);
+    shard.memory += entry.memory;
+    if (this->memory_max)
+    {
+        this->evict(shard, entry);
+    }
+}
+
+template <typename Tvalue>
+void LRI_CV_Cache<Tvalue>::evict(Shard& shard, const Entry& entry_keep)
+{
+    const std::size_t memory_max_shard = this->memory_max / this->nshards;
+    // entry_keep is the most recently used, at the end of the list
+    while (shard.memory > memory_max_shard && !shard.lru.empty())
+    {
+        const auto ptr_lru = shard.entries.find(shard.lru.front());
+        if (&ptr_lru->second == &entry_keep)
+        {
+            break;
+        }
+        shard.memory -= ptr_lru->second.memory;
+        shard.lru.pop_front();
+        shard.entries.erase(ptr_lru);
+        ++this->evictions;
+    }
+}
+
+template <typename Tvalue>
+void LRI_CV_Cache<Tvalue>::set(const std::map<int, std::map<int, std::map<Abfs::Vector3_Order<double>, Tvalue>>>& values)
+{
+    this->clear();
+    for (const auto& values_A: values)
+    {
+        for (const auto& values_B: values_A.second)
+        {
+            for (const auto& values_R: values_B.second)
+            {
+                this->insert(values_A.first, values_B.first, values_R.first, values_R.second);
+            }
+        }
+    }
+}
+
+template <typename Tvalue>
+void LRI_CV_Cache<Tvalue>::clear()
+{
+    for (std::size_t is = 0; is < this->nshards; ++is)
+    {
+        Shard& shard = this->shards[is];
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        for (auto ptr = shard.entries.begin(); ptr != shard.entries.end();)
+        {
+            // the entries in flight are kept for the threads computing them
+            if (ptr->second.ready)
+            {
+                shard.memory -= ptr->second.memory;
+                ptr = shard.entries.erase(ptr);
+            }
+            else
+            {
+                ++ptr;
+            }
+        }
+        shard.lru.clear();
+    }
+}
+
+template <typename Tvalue>
+auto LRI_CV_Cache<Tvalue>::get_info() const -> Info
+{
+    Info info;
+    info.hits = this->hits;
+    info.misses = this->misses;
+    info.waits = this->waits;
+    info.evictions = this->evictions;
+    for (std::size_t is = 0; is < this->nshards; ++is)
+    {
+        Shard& shard = this->shards[is];
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        info.entries += shard.entries.size();
+        info.memory += shard.memory;
+    }
+    return info;
+}
+
+#endif
@@ -35,6 +35,10 @@ namespace LRI_CV_Tools
     template<typename Tdata> inline bool exist(const RI::Tensor<Tdata> &V);
     template<typename T, std::size_t N> inline bool exist(const std::array<T,N> &dV);
 
+    // bytes of the data
+    template<typename Tdata> inline std::size_t get_memory(const RI::Tensor<Tdata> &V);
+    template<typename T, std::size_t N> inline std::size_t get_memory(const std::array<T,N> &dV);
+
     template<typename Tdata>
     extern RI::Tensor<Tdata> mul1(const RI::Tensor<Tdata> &t1, const RI::Tensor<Tdata> &t2);
     template<typename T>
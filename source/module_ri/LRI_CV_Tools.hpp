@@ -62,6 +62,21 @@ bool LRI_CV_Tools::exist(const std::array<T,N> &dV)
 	return false;
 }
 
+template<typename Tdata>
+std::size_t LRI_CV_Tools::get_memory(const RI::Tensor<Tdata> &V)
+{
+	return V.empty() ? 0 : V.get_shape_all() * sizeof(Tdata);
+}
+
+template<typename T, std::size_t N>
+std::size_t LRI_CV_Tools::get_memory(const std::array<T,N> &dV)
+{
+	std::size_t memory = 0;
+	for(size_t i=0; i<N; ++i)
+		memory += LRI_CV_Tools::get_memory(dV[i]);
+	return memory;
+}
+
 
 template<typename Tdata>
 RI::Tensor<Tdata> LRI_CV_Tools::mul1(
@@ -0,0 +1,301 @@
+#include "gtest/gtest.h"
+#include "module_ri/LRI_CV_Cache.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <pthread.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * Unit test of LRI_CV_Cache
+ * tested functions:
+ * 1. find() and insert(), R differing by less than R_resolution is the same key
+ * 2. get_or_compute() computes each key only once when all threads ask for the same keys
+ * 3. get_or_compute() releases the key if the computation throws, the waiting threads compute it again
+ * 4. the least recently used entries are evicted when memory_max is exceeded
+ * 5. set() replaces all the entries
+ * 6. cost compared with the former scheme, nested std::map guarded by one pthread_rwlock_t
+ */
+
+namespace
+{
+using Tvalue = std::vector<double>;
+using Tmap = std::map<int, std::map<int, std::map<Abfs::Vector3_Order<double>, Tvalue>>>;
+
+std::size_t get_memory(const Tvalue& v)
+{
+    return v.size() * sizeof(double);
+}
+
+// some work to imitate the calculation of V or C
+Tvalue cal_value(const int it0, const int it1, const ModuleBase::Vector3<double>& R, const int size)
+{
+    Tvalue v(size);
+    for (int i = 0; i < size; ++i)
+    {
+        v[i] = std::exp(-R.norm2() - i * 1e-3) * (it0 + 1) + std::sin(it1 + i);
+    }
+    return v;
+}
+
+// the R of the keys, which are on the lattice of 0.5
+ModuleBase::Vector3<double> get_R(const int iR)
+{
+    return ModuleBase::Vector3<double>(0.5 * (iR % 5) - 1.0, 0.5 * (iR / 5 % 5) - 1.0, 0.5 * (iR / 25) - 1.0);
+}
+} // namespace
+
+TEST(LRI_CV_CacheTest, FindInsert)
+{
+    LRI_CV_Cache<Tvalue> cache(get_memory);
+    const ModuleBase::Vector3<double> R(0.1, -0.2, 0.3);
+    Tvalue v;
+    EXPECT_FALSE(cache.find(0, 1, R, v));
+    cache.insert(0, 1, R, {1.0, 2.0});
+    EXPECT_TRUE(cache.find(0, 1, R + ModuleBase::Vector3<double>(1e-10, -1e-10, 0), v));
+    EXPECT_EQ(v, Tvalue({1.0, 2.0}));
+    EXPECT_FALSE(cache.find(1, 0, R, v));
+    EXPECT_FALSE(cache.find(0, 1, R + ModuleBase::Vector3<double>(1e-6, 0, 0), v));
+
+    // overwrite
+    cache.insert(0, 1, R, {3.0});
+    EXPECT_TRUE(cache.find(0, 1, R, v));
+    EXPECT_EQ(v, Tvalue({3.0}));
+
+    const LRI_CV_Cache_Info info = cache.get_info();
+    EXPECT_EQ(info.entries, 1);
+    EXPECT_EQ(info.memory, sizeof(double));
+    EXPECT_EQ(info.hits, 2);
+
+    cache.clear();
+    EXPECT_FALSE(cache.find(0, 1, R, v));
+    EXPECT_EQ(cache.get_info().memory, 0);
+}
+
+TEST(LRI_CV_CacheTest, ComputeOnce)
+{
+    LRI_CV_Cache<Tvalue> cache(get_memory, 8);
+    const int nkeys = 125;
+    const int nrepeat = 20;
+    std::vector<std::atomic<int>> ncal(nkeys);
+    for (auto& n: ncal)
+    {
+        n = 0;
+    }
+#pragma omp parallel for schedule(dynamic)
+    for (int itask = 0; itask < nkeys * nrepeat; ++itask)
+    {
+        const int iR = itask % nkeys;
+        const Tvalue v = cache.get_or_compute(1, 2, get_R(iR), [&]() {
+            ++ncal[iR];
+            return cal_value(1, 2, get_R(iR), 1000);
+        });
+        EXPECT_EQ(v, cal_value(1, 2, get_R(iR), 1000));
+    }
+    for (int iR = 0; iR < nkeys; ++iR)
+    {
+        EXPECT_EQ(ncal[iR], 1);
+    }
+    const LRI_CV_Cache_Info info = cache.get_info();
+    EXPECT_EQ(info.misses, nkeys);
+    EXPECT_EQ(info.hits + info.waits, nkeys * (nrepeat - 1));
+    EXPECT_EQ(info.entries, nkeys);
+    EXPECT_EQ(info.memory, nkeys * 1000 * sizeof(double));
+    EXPECT_EQ(info.evictions, 0);
+}
+
+TEST(LRI_CV_CacheTest, ComputeThrows)
+{
+    LRI_CV_Cache<Tvalue> cache(get_memory);
+    const ModuleBase::Vector3<double> R = get_R(7);
+    EXPECT_THROW(cache.get_or_compute(0, 1, R, []() -> Tvalue { throw std::runtime_error("failed"); }),
+                 std::runtime_error);
+    Tvalue v;
+    EXPECT_FALSE(cache.find(0, 1, R, v));
+    EXPECT_EQ(cache.get_info().entries, 0);
+
+    // the first computation throws after the other threads start waiting for it
+    std::atomic<int> ncal{0};
+    std::atomic<int> nthrow{0};
+    int nthreads = 1;
+#pragma omp parallel num_threads(4)
+    {
+#ifdef _OPENMP
+#pragma omp single
+        nthreads = omp_get_num_threads();
+#endif
+        try
+        {
+            const Tvalue v_thread = cache.get_or_compute(0, 1, R, [&]() {
+                if (ncal++ == 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                    throw std::runtime_error("failed");
+                }
+                return cal_value(0, 1, R, 10);
+            });
+            EXPECT_EQ(v_thread, cal_value(0, 1, R, 10));
+        }
+        catch (const std::runtime_error&)
+        {
+            ++nthrow;
+        }
+    }
+    EXPECT_EQ(nthrow, 1);
+    EXPECT_EQ(ncal, std::min(nthreads, 2));
+    EXPECT_EQ(cache.find(0, 1, R, v), nthreads > 1);
+}
+
+TEST(LRI_CV_CacheTest, Evict)
+{
+    // one shard to make the order of eviction deterministic
+    LRI_CV_Cache<Tvalue> cache(get_memory, 1);
+    const int size = 100;
+    const std::size_t memory_value = size * sizeof(double);
+    cache.set_memory_max(3 * memory_value);
+    for (int iR = 0; iR < 3; ++iR)
+    {
+        cache.get_or_compute(0, 0, get_R(iR), [&]() { return cal_value(0, 0, get_R(iR), size); });
+    }
+    Tvalue v;
+    // use key 0, so key 1 is the least recently used
+    EXPECT_TRUE(cache.find(0, 0, get_R(0), v));
+    cache.get_or_compute(0, 0, get_R(3), [&]() { return cal_value(0, 0, get_R(3), size); });
+
+    const LRI_CV_Cache_Info info = cache.get_info();
+    EXPECT_EQ(info.evictions, 1);
+    EXPECT_EQ(info.entries, 3);
+    EXPECT_LE(info.memory, 3 * memory_value);
+    EXPECT_TRUE(cache.find(0, 0, get_R(0), v));
+    EXPECT_FALSE(cache.find(0, 0, get_R(1), v));
+    EXPECT_TRUE(cache.find(0, 0, get_R(2), v));
+    EXPECT_TRUE(cache.find(0, 0, get_R(3), v));
+
+    // overwriting a key makes it the most recently used, key 2 is evicted next
+    cache.insert(0, 0, get_R(0), cal_value(0, 0, get_R(0), size));
+    cache.insert(0, 0, get_R(4), cal_value(0, 0, get_R(4), size));
+    EXPECT_EQ(cache.get_info().evictions, 2);
+    EXPECT_TRUE(cache.find(0, 0, get_R(0), v));
+    EXPECT_FALSE(cache.find(0, 0, get_R(2), v));
+    EXPECT_TRUE(cache.find(0, 0, get_R(3), v));
+    EXPECT_TRUE(cache.find(0, 0, get_R(4), v));
+}
+
+TEST(LRI_CV_CacheTest, Set)
+{
+    LRI_CV_Cache<Tvalue> cache(get_memory);
+    cache.insert(0, 0, get_R(0), {1.0});
+    Tmap values;
+    values[1][2][get_R(5)] = {2.0};
+    values[2][1][-get_R(5)] = {3.0, 4.0};
+    cache.set(values);
+    Tvalue v;
+    EXPECT_FALSE(cache.find(0, 0, get_R(0), v));
+    EXPECT_TRUE(cache.find(1, 2, get_R(5), v));
+    EXPECT_EQ(v, Tvalue({2.0}));
+    EXPECT_TRUE(cache.find(2, 1, -get_R(5), v));
+    EXPECT_EQ(v, Tvalue({3.0, 4.0}));
+    EXPECT_EQ(cache.get_info().entries, 2);
+}
+
+// each thread asks for (it0, it1, R) of many atom pairs, most of which are the same,
+// like LRI_CV::cal_Vs() with writable_Vws
+TEST(LRI_CV_CacheTest, CostCompareWithRwlock)
+{
+    const int ntype = 2;
+    const int nR = 125;
+    const int size = 100;
+    const int ntask = 100000;
+    auto get_key = [&](const int itask, int& it0, int& it1, int& iR) {
+        const int ikey = static_cast<int>((itask * 7919LL) % (ntype * ntype * nR));
+        it0 = ikey / (ntype * nR);
+        it1 = ikey / nR % ntype;
+        iR = ikey % nR;
+    };
+
+    int max_threads = 1;
+#ifdef _OPENMP
+    max_threads = omp_get_max_threads();
+#endif
+    for (int nthreads = 1; nthreads <= std::max(4, max_threads); nthreads *= 2)
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(nthreads);
+#endif
+        // the former scheme
+        Tmap values_map;
+        pthread_rwlock_t rwlock;
+        pthread_rwlock_init(&rwlock, nullptr);
+        std::atomic<int> ncal_map(0);
+        double sum_map = 0.0;
+        auto t0 = std::chrono::high_resolution_clock::now();
+#pragma omp parallel for schedule(dynamic) reduction(+ : sum_map)
+        for (int itask = 0; itask < ntask; ++itask)
+        {
+            int it0 = 0, it1 = 0, iR = 0;
+            get_key(itask, it0, it1, iR);
+            const Abfs::Vector3_Order<double> R = get_R(iR);
+            Tvalue v;
+            pthread_rwlock_rdlock(&rwlock);
+            const auto ptr0 = values_map.find(it0);
+            if (ptr0 != values_map.end())
+            {
+                const auto ptr1 = ptr0->second.find(it1);
+                if (ptr1 != ptr0->second.end())
+                {
+                    const auto ptr2 = ptr1->second.find(R);
+                    if (ptr2 != ptr1->second.end())
+                    {
+                        v = ptr2->second;
+                    }
+                }
+            }
+            pthread_rwlock_unlock(&rwlock);
+            if (v.empty())
+            {
+                ++ncal_map;
+                v = cal_value(it0, it1, R, size);
+                pthread_rwlock_wrlock(&rwlock);
+                values_map[it0][it1][R] = v;
+                pthread_rwlock_unlock(&rwlock);
+            }
+            sum_map += v[0];
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        pthread_rwlock_destroy(&rwlock);
+
+        LRI_CV_Cache<Tvalue> cache(get_memory);
+        double sum_cache = 0.0;
+#pragma omp parallel for schedule(dynamic) reduction(+ : sum_cache)
+        for (int itask = 0; itask < ntask; ++itask)
+        {
+            int it0 = 0, it1 = 0, iR = 0;
+            get_key(itask, it0, it1, iR);
+            const ModuleBase::Vector3<double> R = get_R(iR);
+            const Tvalue v = cache.get_or_compute(it0, it1, R, [&]() { return cal_value(it0, it1, R, size); });
+            sum_cache += v[0];
+        }
+        auto t2 = std::chrono::high_resolution_clock::now();
+
+        EXPECT_NEAR(sum_map, sum_cache, 1e-8 * std::abs(sum_map));
+        const LRI_CV_Cache_Info info = cache.get_info();
+        EXPECT_EQ(info.misses, ntype * ntype * nR);
+        std::cout << "threads: " << nthreads
+                  << ", map with rwlock: "
+                  << std::chrono::duration_cast<std::chrono::duration<double>>(t1 - t0).count() << " s, "
+                  << ncal_map << " calculations"
+                  << ", sharded cache: "
+                  << std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count() << " s, "
+                  << info.misses << " calculations, " << info.waits << " waits" << std::endl;
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(max_threads);
+#endif
+}
@@ -0,0 +1,261 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#define private public
+#include "module_ri/LRI_CV.hpp"
+#undef private
+#include "module_io/restart_exx_csr.hpp"
+
+/**
+ * Unit test of the reuse of Cs, Vs over the ionic steps
+ * tested functions:
+ * 1. LRI_CV::cal_datas() with reuse_tol, the reused tensors are the same as a fresh calculation,
+ *    only the atom pairs moved more than reuse_tol are calculated again
+ * 2. ModuleIO::write_CVs_cereal() and ModuleIO::read_CVs_cereal() of LRI_CV::Datas_Last,
+ *    read_CVs_cereal() returns false if the file does not exist
+ */
+
+// mock the constructors of the members of UnitCell and LRI_CV, they are not needed in cal_datas()
+pseudo::pseudo() {}
+pseudo::~pseudo() {}
+Atom_pseudo::Atom_pseudo() {}
+Atom_pseudo::~Atom_pseudo() {}
+InfoNonlocal::InfoNonlocal() {}
+InfoNonlocal::~InfoNonlocal() {}
+Magnetism::Magnetism() {}
+Magnetism::~Magnetism() {}
+Atom::Atom() {}
+Atom::~Atom() {}
+UnitCell::UnitCell() {}
+UnitCell::~UnitCell() {}
+ORB_gaunt_table::ORB_gaunt_table() {}
+ORB_gaunt_table::~ORB_gaunt_table() {}
+Numerical_Orbital_Lm::Numerical_Orbital_Lm() {}
+Numerical_Orbital_Lm::~Numerical_Orbital_Lm() {}
+
+namespace
+{
+using TA = int;
+using TC = std::array<int, 3>;
+using TAC = std::pair<TA, TC>;
+template <typename Tresult>
+using T_Datas_last = LRI_CV<double>::T_Datas_last<Tresult>;
+
+void expect_same_tensor(const RI::Tensor<double>& t1, const RI::Tensor<double>& t2)
+{
+    ASSERT_EQ(t1.shape.size(), t2.shape.size());
+    for (std::size_t i = 0; i < t1.shape.size(); ++i)
+    {
+        ASSERT_EQ(t1.shape[i], t2.shape[i]);
+    }
+    for (std::size_t i = 0; i < t1.get_shape_all(); ++i)
+    {
+        EXPECT_EQ(t1.ptr()[i], t2.ptr()[i]);
+    }
+}
+
+template <typename Tresult>
+void expect_same_datas(const std::map<TA, std::map<TAC, Tresult>>& Datas1,
+                       const std::map<TA, std::map<TAC, Tresult>>& Datas2,
+                       void (*expect_same_data)(const Tresult&, const Tresult&))
+{
+    ASSERT_EQ(Datas1.size(), Datas2.size());
+    for (const auto& Datas1_A : Datas1)
+    {
+        const auto& Datas2_A = Datas2.at(Datas1_A.first);
+        ASSERT_EQ(Datas1_A.second.size(), Datas2_A.size());
+        for (const auto& Data1 : Datas1_A.second)
+        {
+            expect_same_data(Data1.second, Datas2_A.at(Data1.first));
+        }
+    }
+}
+
+template <typename Tresult>
+void expect_same_datas_last(const T_Datas_last<Tresult>& Datas1,
+                            const T_Datas_last<Tresult>& Datas2,
+                            void (*expect_same_data)(const Tresult&, const Tresult&))
+{
+    ASSERT_EQ(Datas1.size(), Datas2.size());
+    for (const auto& Datas1_A : Datas1)
+    {
+        const auto& Datas2_A = Datas2.at(Datas1_A.first);
+        ASSERT_EQ(Datas1_A.second.size(), Datas2_A.size());
+        for (const auto& Data1 : Datas1_A.second)
+        {
+            const auto& Data2 = Datas2_A.at(Data1.first);
+            EXPECT_EQ(Data1.second.first.x, Data2.first.x);
+            EXPECT_EQ(Data1.second.first.y, Data2.first.y);
+            EXPECT_EQ(Data1.second.first.z, Data2.first.z);
+            expect_same_data(Data1.second.second, Data2.second);
+        }
+    }
+}
+
+void expect_same_dC(const std::array<RI::Tensor<double>, 3>& t1, const std::array<RI::Tensor<double>, 3>& t2)
+{
+    for (int ix = 0; ix < 3; ++ix)
+    {
+        expect_same_tensor(t1[ix], t2[ix]);
+    }
+}
+
+void expect_same_C_dC(const std::pair<RI::Tensor<double>, std::array<RI::Tensor<double>, 3>>& t1,
+                      const std::pair<RI::Tensor<double>, std::array<RI::Tensor<double>, 3>>& t2)
+{
+    expect_same_tensor(t1.first, t2.first);
+    expect_same_dC(t1.second, t2.second);
+}
+
+// the tensor of an atom pair depends on R only, as Vs and Cs
+RI::Tensor<double> make_tensor(const ModuleBase::Vector3<double>& R)
+{
+    RI::Tensor<double> t({2, 3});
+    for (std::size_t i = 0; i < t.get_shape_all(); ++i)
+    {
+        t.ptr()[i] = std::exp(-R.norm()) * (i + 1) + R.x * i;
+    }
+    return t;
+}
+} // namespace
+
+class LRICVReuseTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // two atoms of one element in a large cell, the atom pairs in the home cell are all within Rcut
+        ucell.ntype = 1;
+        ucell.nat = 2;
+        ucell.lat0 = 1.0;
+        ucell.latvec = ModuleBase::Matrix3(20, 0, 0, 0, 20, 0, 0, 0, 20);
+        ucell.atoms = new Atom[ucell.ntype];
+        ucell.atoms[0].na = ucell.nat;
+        ucell.atoms[0].tau.resize(ucell.nat);
+        ucell.atoms[0].tau[0] = ModuleBase::Vector3<double>(0.0, 0.0, 0.0);
+        ucell.atoms[0].tau[1] = ModuleBase::Vector3<double>(2.0, 0.5, 0.0);
+        ucell.iat2it = new int[ucell.nat];
+        ucell.iat2ia = new int[ucell.nat];
+        for (int iat = 0; iat < ucell.nat; ++iat)
+        {
+            ucell.iat2it[iat] = 0;
+            ucell.iat2ia[iat] = iat;
+        }
+        list_A0 = {0, 1};
+        list_A1 = {{0, {0, 0, 0}}, {1, {0, 0, 0}}};
+    }
+    void TearDown() override
+    {
+        // iat2it and iat2ia are deleted in ~Statistics()
+        delete[] ucell.atoms;
+    }
+
+    // cal_datas() with func counting its calls
+    std::map<TA, std::map<TAC, RI::Tensor<double>>> cal_datas(const double reuse_tol,
+                                                             T_Datas_last<RI::Tensor<double>>& Datas_last)
+    {
+        LRI_CV<double> cv;
+        cv.orb_cutoff_ = {3.0};
+        cv.set_reuse_tol(reuse_tol);
+        const LRI_CV<double>::T_func_DPcal_data<RI::Tensor<double>> func
+            = [this](const int it0,
+                     const int it1,
+                     const Abfs::Vector3_Order<double>& R,
+                     const std::map<std::string, bool>& flags) -> RI::Tensor<double> {
+            ++this->num_cal;
+            return make_tensor(R);
+        };
+        return cv.cal_datas(ucell, list_A0, list_A1, {}, 1.0, func, "Vs", Datas_last);
+    }
+
+    UnitCell ucell;
+    std::vector<TA> list_A0;
+    std::vector<TAC> list_A1;
+    std::atomic<int> num_cal{0};
+};
+
+TEST_F(LRICVReuseTest, CalDatasReuse)
+{
+    T_Datas_last<RI::Tensor<double>> Datas_last;
+    const auto Datas_step0 = this->cal_datas(0.01, Datas_last);
+    EXPECT_EQ(this->num_cal, 4);
+    EXPECT_EQ(Datas_last.size(), 2);
+    EXPECT_EQ(Datas_last.at(0).size(), 2);
+    EXPECT_EQ(Datas_last.at(1).size(), 2);
+
+    // same positions, all the atom pairs are reused
+    T_Datas_last<RI::Tensor<double>> Datas_last_fresh;
+    const auto Datas_fresh0 = this->cal_datas(0.0, Datas_last_fresh);
+    EXPECT_TRUE(Datas_last_fresh.empty());
+    this->num_cal = 0;
+    const auto Datas_step1 = this->cal_datas(0.01, Datas_last);
+    EXPECT_EQ(this->num_cal, 0);
+    expect_same_datas(Datas_step1, Datas_fresh0, expect_same_tensor);
+    expect_same_datas(Datas_step1, Datas_step0, expect_same_tensor);
+
+    // atom 1 moves more than reuse_tol, the pairs 0-1 and 1-0 are calculated again
+    ucell.atoms[0].tau[1].x += 0.1;
+    const auto Datas_fresh2 = this->cal_datas(0.0, Datas_last_fresh);
+    this->num_cal = 0;
+    const auto Datas_step2 = this->cal_datas(0.01, Datas_last);
+    EXPECT_EQ(this->num_cal, 2);
+    expect_same_datas(Datas_step2, Datas_fresh2, expect_same_tensor);
+    expect_same_tensor(Datas_step2.at(0).at({0, {0, 0, 0}}), Datas_step0.at(0).at({0, {0, 0, 0}}));
+    expect_same_tensor(Datas_step2.at(1).at({1, {0, 0, 0}}), Datas_step0.at(1).at({1, {0, 0, 0}}));
+
+    // atom 1 moves less than reuse_tol, the tensors of the last calculation are reused
+    ucell.atoms[0].tau[1].x += 0.006;
+    this->num_cal = 0;
+    const auto Datas_step3 = this->cal_datas(0.01, Datas_last);
+    EXPECT_EQ(this->num_cal, 0);
+    expect_same_datas(Datas_step3, Datas_step2, expect_same_tensor);
+
+    // the displacement is accumulated from the R of the last calculation, not from the last ionic step
+    ucell.atoms[0].tau[1].x += 0.006;
+    const auto Datas_fresh4 = this->cal_datas(0.0, Datas_last_fresh);
+    this->num_cal = 0;
+    const auto Datas_step4 = this->cal_datas(0.01, Datas_last);
+    EXPECT_EQ(this->num_cal, 2);
+    expect_same_datas(Datas_step4, Datas_fresh4, expect_same_tensor);
+}
+
+TEST_F(LRICVReuseTest, WriteReadCVsCereal)
+{
+    LRI_CV<double>::Datas_Last datas_last;
+    T_Datas_last<RI::Tensor<double>> Vs_last;
+    this->cal_datas(0.01, Vs_last);
+    datas_last.Vs = Vs_last;
+    for (const auto& Vs_A : Vs_last)
+    {
+        for (const auto& V : Vs_A.second)
+        {
+            const Abfs::Vector3_Order<double>& R = V.second.first;
+            const std::array<RI::Tensor<double>, 3> dV
+                = {make_tensor(R * 1.1), make_tensor(R * 1.2), make_tensor(R * 1.3)};
+            datas_last.dVs[Vs_A.first][V.first] = std::make_pair(R, dV);
+            datas_last.Cs_dCs[Vs_A.first][V.first] = std::make_pair(R, std::make_pair(make_tensor(R * 0.9), dV));
+        }
+    }
+    datas_last.with_dC = true;
+
+    const std::string file_name = "./support/CVs_out";
+    ModuleIO::write_CVs_cereal(file_name, datas_last);
+    LRI_CV<double>::Datas_Last datas_read;
+    EXPECT_TRUE(ModuleIO::read_CVs_cereal(file_name, datas_read));
+    std::remove(file_name.c_str());
+
+    EXPECT_TRUE(datas_read.with_dC);
+    expect_same_datas_last(datas_read.Vs, datas_last.Vs, expect_same_tensor);
+    expect_same_datas_last(datas_read.dVs, datas_last.dVs, expect_same_dC);
+    expect_same_datas_last(datas_read.Cs_dCs, datas_last.Cs_dCs, expect_same_C_dC);
+
+    LRI_CV<double>::Datas_Last datas_none;
+    EXPECT_FALSE(ModuleIO::read_CVs_cereal("./support/CVs_none", datas_none));
+    EXPECT_TRUE(datas_none.Vs.empty());
+}